@@ -226,6 +226,174 @@ cog_virt_frame_render (CogFrame * frame, CogFrame * dest)
   }
 }
 
+/* Copies the chain of virtual frames ending at @frame, giving each copy a
+ * line cache of its own, so that the copy can be rendered while other
+ * copies are.  The render functions, their parameters and tables are
+ * shared, as are the real frames at the start of the chain. */
+static CogFrame *
+cog_virt_frame_clone (CogFrame * frame)
+{
+  CogFrame *clone;
+  int i, j;
+
+  if (!frame->is_virtual) {
+    return cog_frame_ref (frame);
+  }
+
+  clone = cog_frame_new ();
+  memcpy (clone, frame, sizeof (*clone));
+  clone->refcount = 1;
+  clone->free = NULL;
+  clone->priv = NULL;
+  /* owned by @frame, which outlives the clone */
+  clone->virt_priv = NULL;
+
+  for (i = 0; i < 3; i++) {
+    clone->regions[i] = NULL;
+    if (frame->regions[i]) {
+      clone->regions[i] = g_malloc (frame->components[i].stride *
+          COG_FRAME_CACHE_SIZE);
+    }
+    for (j = 0; j < COG_FRAME_CACHE_SIZE; j++) {
+      clone->cached_lines[i][j] = 0;
+    }
+    clone->cache_offset[i] = 0;
+  }
+  if (frame->virt_frame1) {
+    clone->virt_frame1 = cog_virt_frame_clone (frame->virt_frame1);
+  }
+  if (frame->virt_frame2) {
+    clone->virt_frame2 = cog_virt_frame_clone (frame->virt_frame2);
+  }
+
+  return clone;
+}
+
+typedef struct _CogVirtFrameBand CogVirtFrameBand;
+typedef struct _CogVirtFrameTask CogVirtFrameTask;
+
+struct _CogVirtFrameTask
+{
+  GMutex *lock;
+  GCond *cond;
+  int pending;
+};
+
+struct _CogVirtFrameBand
+{
+  CogFrame *frame;
+  CogFrame *dest;
+  int band;
+  int n_bands;
+  CogVirtFrameTask *task;
+};
+
+static GStaticMutex band_pool_lock = G_STATIC_MUTEX_INIT;
+static GThreadPool *band_pool;
+
+/* renders the lines of band @band out of @n_bands of every component; each
+ * component is cut in bands separately, the components being independent */
+static void
+cog_virt_frame_render_band (CogFrame * frame, CogFrame * dest, int band,
+    int n_bands)
+{
+  int i, k;
+
+  for (k = 0; k < 3; k++) {
+    CogFrameData *comp = dest->components + k;
+    int first = band * comp->height / n_bands;
+    int last = (band + 1) * comp->height / n_bands;
+
+    for (i = first; i < last; i++) {
+      cog_virt_frame_render_line (frame, COG_FRAME_DATA_GET_LINE (comp, i),
+          k, i);
+    }
+  }
+}
+
+static void
+cog_virt_frame_band_func (gpointer data, gpointer user_data)
+{
+  CogVirtFrameBand *band = data;
+  CogVirtFrameTask *task = band->task;
+
+  cog_virt_frame_render_band (band->frame, band->dest, band->band,
+      band->n_bands);
+
+  g_mutex_lock (task->lock);
+  task->pending--;
+  if (task->pending == 0)
+    g_cond_signal (task->cond);
+  g_mutex_unlock (task->lock);
+}
+
+/* Renders @frame into @dest like cog_virt_frame_render(), cutting the frame
+ * in @n_threads bands of lines.  The calling thread renders the first band
+ * and a worker pool shared by all callers the others.  Every band renders
+ * through its own copy of the chain of virtual frames, so that each line
+ * cache is still read in order. */
+void
+cog_virt_frame_render_threaded (CogFrame * frame, CogFrame * dest,
+    int n_threads)
+{
+  CogVirtFrameBand *bands;
+  CogVirtFrameTask task;
+  int n_bands;
+  int i;
+
+  g_return_if_fail (frame->width == dest->width);
+  g_return_if_fail (frame->height >= dest->height);
+
+  /* a band of a few lines costs more to set up than it saves */
+  n_bands = MIN (n_threads, dest->height / COG_FRAME_CACHE_SIZE);
+  if (!frame->is_virtual || n_bands < 2) {
+    cog_virt_frame_render (frame, dest);
+    return;
+  }
+
+  g_static_mutex_lock (&band_pool_lock);
+  if (band_pool == NULL) {
+    band_pool = g_thread_pool_new (cog_virt_frame_band_func, NULL,
+        n_bands - 1, FALSE, NULL);
+  } else if (g_thread_pool_get_max_threads (band_pool) < n_bands - 1) {
+    g_thread_pool_set_max_threads (band_pool, n_bands - 1, NULL);
+  }
+  g_static_mutex_unlock (&band_pool_lock);
+
+  task.lock = g_mutex_new ();
+  task.cond = g_cond_new ();
+  task.pending = n_bands - 1;
+
+  /* the copies are made and freed here, as the reference counts of the
+   * frames they share are not atomic */
+  bands = g_new (CogVirtFrameBand, n_bands);
+  for (i = 0; i < n_bands; i++) {
+    bands[i].frame = (i == 0) ? cog_frame_ref (frame) :
+        cog_virt_frame_clone (frame);
+    bands[i].dest = dest;
+    bands[i].band = i;
+    bands[i].n_bands = n_bands;
+    bands[i].task = &task;
+  }
+  for (i = 1; i < n_bands; i++) {
+    g_thread_pool_push (band_pool, &bands[i], NULL);
+  }
+
+  cog_virt_frame_render_band (frame, dest, 0, n_bands);
+
+  g_mutex_lock (task.lock);
+  while (task.pending > 0)
+    g_cond_wait (task.cond, task.lock);
+  g_mutex_unlock (task.lock);
+
+  for (i = 0; i < n_bands; i++) {
+    cog_frame_unref (bands[i].frame);
+  }
+  g_free (bands);
+  g_cond_free (task.cond);
+  g_mutex_free (task.lock);
+}
+
 static void
 cog_virt_frame_render_downsample_horiz_cosite_3tap (CogFrame * frame,
     void *_dest, int component, int i)
@@ -15,6 +15,8 @@ void cog_virt_frame_render_line (CogFrame *frame, void *dest,
     int component, int i);
 
 void cog_virt_frame_render (CogFrame *frame, CogFrame *dest);
+void cog_virt_frame_render_threaded (CogFrame *frame, CogFrame *dest,
+    int n_threads);
 
 CogFrame *cog_virt_frame_new_horiz_downsample (CogFrame *vf, int n_taps);
 CogFrame *cog_virt_frame_new_vert_downsample (CogFrame *vf, int n_taps);
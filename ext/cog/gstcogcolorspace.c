@@ -58,6 +58,7 @@ struct _GstCogcolorspace
   GstBaseTransform base_transform;
 
   int quality;
+  guint n_threads;
 };
 
 struct _GstCogcolorspaceClass
@@ -76,11 +77,14 @@ enum
 };
 
 #define DEFAULT_QUALITY 5
+#define DEFAULT_N_THREADS 1
+#define MAX_THREADS 64
 
 enum
 {
   PROP_0,
-  PROP_QUALITY
+  PROP_QUALITY,
+  PROP_N_THREADS
 };
 
 static void gst_cogcolorspace_set_property (GObject * object, guint prop_id,
@@ -151,6 +155,10 @@ gst_cogcolorspace_class_init (GstCogcolorspaceClass * colorspace_class)
   g_object_class_install_property (gobject_class, PROP_QUALITY,
       g_param_spec_int ("quality", "Quality", "Quality",
           0, 10, DEFAULT_QUALITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads converting bands of each frame", 1, MAX_THREADS,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   base_transform_class->transform = gst_cogcolorspace_transform;
   base_transform_class->transform_caps = gst_cogcolorspace_transform_caps;
@@ -166,6 +174,7 @@ gst_cogcolorspace_init (GstCogcolorspace * colorspace,
   GST_DEBUG ("gst_cogcolorspace_init");
 
   colorspace->quality = DEFAULT_QUALITY;
+  colorspace->n_threads = DEFAULT_N_THREADS;
 }
 
 static void
@@ -184,6 +193,11 @@ gst_cogcolorspace_set_property (GObject * object, guint prop_id,
       colorspace->quality = g_value_get_int (value);
       GST_OBJECT_UNLOCK (colorspace);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (colorspace);
+      colorspace->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (colorspace);
+      break;
     default:
       break;
   }
@@ -204,6 +218,11 @@ gst_cogcolorspace_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_int (value, colorspace->quality);
       GST_OBJECT_UNLOCK (colorspace);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (colorspace);
+      g_value_set_uint (value, colorspace->n_threads);
+      GST_OBJECT_UNLOCK (colorspace);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -895,10 +914,15 @@ gst_cogcolorspace_transform (GstBaseTransform * base_transform,
   CogColorMatrix out_color_matrix;
   CogChromaSite in_chroma_site;
   CogChromaSite out_chroma_site;
+  guint n_threads;
 
   g_return_val_if_fail (GST_IS_COGCOLORSPACE (base_transform), GST_FLOW_ERROR);
   compress = GST_COGCOLORSPACE (base_transform);
 
+  GST_OBJECT_LOCK (compress);
+  n_threads = compress->n_threads;
+  GST_OBJECT_UNLOCK (compress);
+
   ret = gst_video_format_parse_caps (inbuf->caps, &in_format, &width, &height);
   ret &=
       gst_video_format_parse_caps (outbuf->caps, &out_format, &width, &height);
@@ -1041,7 +1065,7 @@ gst_cogcolorspace_transform (GstBaseTransform * base_transform,
       break;
   }
 
-  cog_virt_frame_render (frame, out_frame);
+  cog_virt_frame_render_threaded (frame, out_frame, n_threads);
   cog_frame_unref (frame);
   cog_frame_unref (out_frame);
 
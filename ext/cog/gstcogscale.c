@@ -96,6 +96,7 @@ struct _GstCogScale
   GstBaseTransform element;
 
   int quality;
+  guint n_threads;
 
   /* negotiated stuff */
   GstVideoFormat format;
@@ -117,11 +118,14 @@ struct _GstCogScaleClass
 GType gst_cog_scale_get_type (void);
 
 #define DEFAULT_QUALITY 5
+#define DEFAULT_N_THREADS 1
+#define MAX_THREADS 64
 
 enum
 {
   PROP_0,
-  PROP_QUALITY
+  PROP_QUALITY,
+  PROP_N_THREADS
 };
 
 /* can't handle width/height of 1 yet, since we divide a lot by (n-1) */
@@ -229,6 +233,10 @@ gst_cog_scale_class_init (GstCogScaleClass * klass)
   g_object_class_install_property (gobject_class, PROP_QUALITY,
       g_param_spec_int ("quality", "quality", "Scaling Quality",
           0, 10, DEFAULT_QUALITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads scaling bands of each frame", 1, MAX_THREADS,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   trans_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_cog_scale_transform_caps);
@@ -248,6 +256,7 @@ gst_cog_scale_init (GstCogScale * videoscale)
 {
   gst_base_transform_set_qos_enabled (GST_BASE_TRANSFORM (videoscale), TRUE);
   videoscale->quality = DEFAULT_QUALITY;
+  videoscale->n_threads = DEFAULT_N_THREADS;
 }
 
 static void
@@ -268,6 +277,11 @@ gst_cog_scale_set_property (GObject * object, guint prop_id,
       vscale->quality = g_value_get_int (value);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      vscale->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -286,6 +300,11 @@ gst_cog_scale_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_int (value, vscale->quality);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      g_value_set_uint (value, vscale->n_threads);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -538,6 +557,7 @@ gst_cog_scale_transform (GstBaseTransform * trans, GstBuffer * in,
   CogFrame *frame;
   int w, h;
   int quality;
+  guint n_threads;
   static const int n_vert_taps[11] = { 1, 1, 2, 2, 2, 2, 4, 4, 4, 4, 4 };
   static const int n_horiz_taps[11] = { 1, 1, 1, 1, 2, 2, 2, 2, 4, 4, 4 };
 
@@ -545,6 +565,7 @@ gst_cog_scale_transform (GstBaseTransform * trans, GstBuffer * in,
 
   GST_OBJECT_LOCK (videoscale);
   quality = videoscale->quality;
+  n_threads = videoscale->n_threads;
   GST_OBJECT_UNLOCK (videoscale);
 
   frame = gst_cog_buffer_wrap (gst_buffer_ref (in), videoscale->format,
@@ -586,7 +607,7 @@ gst_cog_scale_transform (GstBaseTransform * trans, GstBuffer * in,
       break;
   }
 
-  cog_virt_frame_render (frame, outframe);
+  cog_virt_frame_render_threaded (frame, outframe, n_threads);
   cog_frame_unref (frame);
   cog_frame_unref (outframe);
 
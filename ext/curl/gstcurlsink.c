@@ -25,6 +25,12 @@
  * This is a network sink that uses libcurl as a client to upload data to
  * a server (e.g. a HTTP/FTP server).
  *
+ * Buffers are queued and sent by a separate transfer thread, so rendering
+ * only blocks when more than #GstCurlSink:max-queue-bytes or
+ * #GstCurlSink:max-queue-time worth of data is waiting to be sent. The
+ * connection is kept open and reused for the following files when the server
+ * allows it.
+ *
  * <refsect2>
  * <title>Example launch line (upload a JPEG file to an HTTP server)</title>
  * |[
@@ -65,6 +71,8 @@
 #define DEFAULT_QOS_DSCP               0
 #define DEFAULT_ACCEPT_SELF_SIGNED     FALSE
 #define DEFAULT_USE_CONTENT_LENGTH     FALSE
+#define DEFAULT_MAX_QUEUE_BYTES        (2 * 1024 * 1024)
+#define DEFAULT_MAX_QUEUE_TIME         0
 
 #define DSCP_MIN                       0
 #define DSCP_MAX                       63
@@ -94,7 +102,9 @@ enum
   PROP_QOS_DSCP,
   PROP_ACCEPT_SELF_SIGNED,
   PROP_USE_CONTENT_LENGTH,
-  PROP_CONTENT_TYPE
+  PROP_CONTENT_TYPE,
+  PROP_MAX_QUEUE_BYTES,
+  PROP_MAX_QUEUE_TIME
 };
 static gboolean proxy_auth = FALSE;
 static gboolean proxy_conn_established = FALSE;
@@ -136,8 +146,10 @@ static gboolean gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_transfer_thread_notify_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_transfer_thread_close_unlocked (GstCurlSink * sink);
-static void gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (GstCurlSink
-    * sink);
+static gboolean gst_curl_sink_queue_is_full_unlocked (GstCurlSink * sink,
+    GstBuffer * buf);
+static void gst_curl_sink_wait_for_queue_drained_unlocked (GstCurlSink * sink);
+static void gst_curl_sink_flush_queue_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_data_sent_notify_unlocked (GstCurlSink * sink);
 
 static void
@@ -241,16 +253,25 @@ gst_curl_sink_class_init (GstCurlSinkClass * klass)
       g_param_spec_string ("content-type", "Content type",
           "The mime type of the body of the request", NULL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_QUEUE_BYTES,
+      g_param_spec_uint ("max-queue-bytes", "Max queue bytes",
+          "Max. amount of data waiting to be sent before rendering blocks "
+          "(0 = no limit)", 0, G_MAXUINT, DEFAULT_MAX_QUEUE_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_QUEUE_TIME,
+      g_param_spec_uint64 ("max-queue-time", "Max queue time",
+          "Max. amount of data in ns waiting to be sent before rendering "
+          "blocks (0 = no limit)", 0, G_MAXUINT64, DEFAULT_MAX_QUEUE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
 gst_curl_sink_init (GstCurlSink * sink, GstCurlSinkClass * klass)
 {
-  sink->transfer_buf = g_malloc (sizeof (TransferBuffer));
-  sink->transfer_cond = g_malloc (sizeof (TransferCondition));
-  sink->transfer_cond->cond = g_cond_new ();
-  sink->transfer_cond->data_sent = FALSE;
-  sink->transfer_cond->data_available = FALSE;
+  sink->transfer_cond = g_cond_new ();
+  sink->queue = g_queue_new ();
+  sink->max_queue_bytes = DEFAULT_MAX_QUEUE_BYTES;
+  sink->max_queue_time = DEFAULT_MAX_QUEUE_TIME;
   sink->timeout = DEFAULT_TIMEOUT;
   sink->proxy_port = DEFAULT_PROXY_PORT;
   sink->qos_dscp = DEFAULT_QOS_DSCP;
@@ -275,10 +296,10 @@ gst_curl_sink_finalize (GObject * gobject)
   }
 
   gst_curl_sink_transfer_cleanup (this);
-  g_cond_free (this->transfer_cond->cond);
-  g_free (this->transfer_cond);
+  g_cond_free (this->transfer_cond);
 
-  g_free (this->transfer_buf);
+  gst_curl_sink_flush_queue_unlocked (this);
+  g_queue_free (this->queue);
 
   g_free (this->url);
   g_free (this->user);
@@ -305,15 +326,11 @@ static GstFlowReturn
 gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 {
   GstCurlSink *sink = GST_CURL_SINK (bsink);
-  guint8 *data;
-  size_t size;
   GstFlowReturn ret;
 
   GST_LOG ("enter render");
 
   sink = GST_CURL_SINK (bsink);
-  data = GST_BUFFER_DATA (buf);
-  size = GST_BUFFER_SIZE (buf);
 
   if (sink->content_type == NULL) {
     GstCaps *caps;
@@ -326,6 +343,10 @@ gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     sink->content_type = g_strdup (mime_type);
   }
 
+  /* an empty read would end the current transfer */
+  if (GST_BUFFER_SIZE (buf) == 0)
+    return GST_FLOW_OK;
+
   GST_OBJECT_LOCK (sink);
 
   /* check if the transfer thread has encountered problems while the
@@ -334,8 +355,6 @@ gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     goto done;
   }
 
-  g_assert (sink->transfer_cond->data_available == FALSE);
-
   /* if there is no transfer thread created, lets create one */
   if (sink->transfer_thread == NULL) {
     if (!gst_curl_sink_transfer_start_unlocked (sink)) {
@@ -344,17 +363,29 @@ gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     }
   }
 
+  /* wait until there is room in the queue. This will be notified either
+   * when the curl read callback has sent data, or by the thread function if
+   * an error has occured. */
+  while (gst_curl_sink_queue_is_full_unlocked (sink, buf) &&
+      sink->flow_ret == GST_FLOW_OK && !sink->flushing) {
+    GST_LOG ("queue full, waiting");
+    g_cond_wait (sink->transfer_cond, GST_OBJECT_GET_LOCK (sink));
+  }
+
+  if (sink->flushing) {
+    GST_OBJECT_UNLOCK (sink);
+    return GST_FLOW_WRONG_STATE;
+  }
+
+  if (sink->flow_ret != GST_FLOW_OK) {
+    goto done;
+  }
+
   /* make data available for the transfer thread and notify */
-  sink->transfer_buf->ptr = data;
-  sink->transfer_buf->len = size;
-  sink->transfer_buf->offset = 0;
+  g_queue_push_tail (sink->queue, gst_buffer_ref (buf));
+  sink->queued_bytes += GST_BUFFER_SIZE (buf);
   gst_curl_sink_transfer_thread_notify_unlocked (sink);
 
-  /* wait for the transfer thread to send the data. This will be notified
-   * either when transfer is completed by the curl read callback or by
-   * the thread function if an error has occured. */
-  gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (sink);
-
 done:
   ret = sink->flow_ret;
   GST_OBJECT_UNLOCK (sink);
@@ -399,6 +430,11 @@ gst_curl_sink_start (GstBaseSink * bsink)
     return FALSE;
   }
 
+  GST_OBJECT_LOCK (sink);
+  sink->flow_ret = GST_FLOW_OK;
+  sink->flushing = FALSE;
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -407,9 +443,16 @@ gst_curl_sink_stop (GstBaseSink * bsink)
 {
   GstCurlSink *sink = GST_CURL_SINK (bsink);
 
+  /* whatever is still queued is dropped, the easy and multi handles are
+   * kept so the next start can reuse the connection */
   GST_OBJECT_LOCK (sink);
+  gst_curl_sink_flush_queue_unlocked (sink);
   gst_curl_sink_transfer_thread_close_unlocked (sink);
   GST_OBJECT_UNLOCK (sink);
+  if (sink->transfer_thread != NULL) {
+    g_thread_join (sink->transfer_thread);
+    sink->transfer_thread = NULL;
+  }
   if (sink->fdset != NULL) {
     gst_poll_free (sink->fdset);
     sink->fdset = NULL;
@@ -428,6 +471,11 @@ gst_curl_sink_unlock (GstBaseSink * bsink)
   GST_LOG_OBJECT (sink, "Flushing");
   gst_poll_set_flushing (sink->fdset, TRUE);
 
+  GST_OBJECT_LOCK (sink);
+  sink->flushing = TRUE;
+  g_cond_broadcast (sink->transfer_cond);
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -441,6 +489,13 @@ gst_curl_sink_unlock_stop (GstBaseSink * bsink)
   GST_LOG_OBJECT (sink, "No longer flushing");
   gst_poll_set_flushing (sink->fdset, FALSE);
 
+  /* data queued before the flush must not be sent after it */
+  GST_OBJECT_LOCK (sink);
+  gst_curl_sink_flush_queue_unlocked (sink);
+  sink->flushing = FALSE;
+  g_cond_broadcast (sink->transfer_cond);
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -522,6 +577,16 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
         sink->content_type = g_value_dup_string (value);
         GST_DEBUG_OBJECT (sink, "content type set to %s", sink->content_type);
         break;
+      case PROP_MAX_QUEUE_BYTES:
+        sink->max_queue_bytes = g_value_get_uint (value);
+        GST_DEBUG_OBJECT (sink, "max queue bytes set to %u",
+            sink->max_queue_bytes);
+        break;
+      case PROP_MAX_QUEUE_TIME:
+        sink->max_queue_time = g_value_get_uint64 (value);
+        GST_DEBUG_OBJECT (sink, "max queue time set to %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (sink->max_queue_time));
+        break;
       default:
         GST_DEBUG_OBJECT (sink, "invalid property id %d", prop_id);
         break;
@@ -537,6 +602,8 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case PROP_FILE_NAME:
+      /* the current file ends after everything queued so far */
+      gst_curl_sink_wait_for_queue_drained_unlocked (sink);
       g_free (sink->file_name);
       sink->file_name = g_value_dup_string (value);
       GST_DEBUG_OBJECT (sink, "file_name set to %s", sink->file_name);
@@ -556,6 +623,18 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
       sink->content_type = g_value_dup_string (value);
       GST_DEBUG_OBJECT (sink, "content type set to %s", sink->content_type);
       break;
+    case PROP_MAX_QUEUE_BYTES:
+      sink->max_queue_bytes = g_value_get_uint (value);
+      GST_DEBUG_OBJECT (sink, "max queue bytes set to %u",
+          sink->max_queue_bytes);
+      g_cond_broadcast (sink->transfer_cond);
+      break;
+    case PROP_MAX_QUEUE_TIME:
+      sink->max_queue_time = g_value_get_uint64 (value);
+      GST_DEBUG_OBJECT (sink, "max queue time set to %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (sink->max_queue_time));
+      g_cond_broadcast (sink->transfer_cond);
+      break;
     default:
       GST_WARNING_OBJECT (sink, "cannot set property when PLAYING");
       break;
@@ -613,6 +692,12 @@ gst_curl_sink_get_property (GObject * object, guint prop_id,
     case PROP_CONTENT_TYPE:
       g_value_set_string (value, sink->content_type);
       break;
+    case PROP_MAX_QUEUE_BYTES:
+      g_value_set_uint (value, sink->max_queue_bytes);
+      break;
+    case PROP_MAX_QUEUE_TIME:
+      g_value_set_uint64 (value, sink->max_queue_time);
+      break;
     default:
       GST_DEBUG_OBJECT (sink, "invalid property id");
       break;
@@ -636,9 +721,12 @@ gst_curl_sink_set_http_header_unlocked (GstCurlSink * sink)
     goto set_headers;
   }
   if (sink->use_content_length) {
+    GstBuffer *head = g_queue_peek_head (sink->queue);
+
     /* if content length is used we assume that every buffer is one
      * entire file, which is the case when uploading several jpegs */
-    tmp = g_strdup_printf ("Content-Length: %d", (int) sink->transfer_buf->len);
+    tmp = g_strdup_printf ("Content-Length: %d",
+        head ? (int) GST_BUFFER_SIZE (head) : 0);
     sink->header_list = curl_slist_append (sink->header_list, tmp);
     g_free (tmp);
   } else {
@@ -731,9 +819,8 @@ gst_curl_sink_transfer_read_cb (void *curl_ptr, size_t size, size_t nmemb,
     void *stream)
 {
   GstCurlSink *sink;
-  TransferBuffer *buffer;
   size_t max_bytes_to_send;
-  guint buf_len;
+  size_t bytes_sent = 0;
 
   sink = (GstCurlSink *) stream;
 
@@ -745,42 +832,44 @@ gst_curl_sink_transfer_read_cb (void *curl_ptr, size_t size, size_t nmemb,
     GST_OBJECT_UNLOCK (sink);
     return 0;
   }
-  GST_OBJECT_UNLOCK (sink);
-
 
   max_bytes_to_send = size * nmemb;
-  buffer = sink->transfer_buf;
-
-  buf_len = buffer->len;
-  GST_LOG ("write buf len=%" G_GSIZE_FORMAT ", offset=%" G_GSIZE_FORMAT,
-      buffer->len, buffer->offset);
 
-  /* more data in buffer */
-  if (buffer->len > 0) {
-    size_t bytes_to_send = MIN (max_bytes_to_send, buf_len);
+  /* fill the curl buffer from as many queued buffers as it takes */
+  while (bytes_sent < max_bytes_to_send && !g_queue_is_empty (sink->queue)) {
+    GstBuffer *buf = g_queue_peek_head (sink->queue);
+    size_t buf_len = GST_BUFFER_SIZE (buf) - sink->queue_offset;
+    size_t bytes_to_send = MIN (max_bytes_to_send - bytes_sent, buf_len);
 
-    memcpy ((guint8 *) curl_ptr, buffer->ptr + buffer->offset, bytes_to_send);
+    GST_LOG ("write buf len=%" G_GSIZE_FORMAT ", offset=%" G_GSIZE_FORMAT,
+        buf_len, sink->queue_offset);
 
-    buffer->offset = buffer->offset + bytes_to_send;
-    buffer->len = buffer->len - bytes_to_send;
+    memcpy ((guint8 *) curl_ptr + bytes_sent,
+        GST_BUFFER_DATA (buf) + sink->queue_offset, bytes_to_send);
+    bytes_sent += bytes_to_send;
 
-    /* the last data chunk */
-    if (bytes_to_send == buf_len) {
-      buffer->ptr = NULL;
-      buffer->offset = 0;
-      buffer->len = 0;
-      GST_OBJECT_LOCK (sink);
-      gst_curl_sink_data_sent_notify_unlocked (sink);
-      GST_OBJECT_UNLOCK (sink);
+    if (bytes_to_send < buf_len) {
+      sink->queue_offset += bytes_to_send;
+      break;
     }
 
-    GST_LOG ("sent : %" G_GSIZE_FORMAT, bytes_to_send);
+    /* the last data chunk of this buffer */
+    g_queue_pop_head (sink->queue);
+    sink->queued_bytes -= GST_BUFFER_SIZE (buf);
+    sink->queue_offset = 0;
+    gst_buffer_unref (buf);
 
-    return bytes_to_send;
-  } else {
-    GST_WARNING ("got zero-length buffer");
-    return 0;
+    /* the content length only covers one buffer */
+    if (sink->use_content_length)
+      break;
   }
+
+  gst_curl_sink_data_sent_notify_unlocked (sink);
+  GST_OBJECT_UNLOCK (sink);
+
+  GST_LOG ("sent : %" G_GSIZE_FORMAT, bytes_sent);
+
+  return bytes_sent;
 }
 
 static size_t
@@ -1046,46 +1135,49 @@ gst_curl_sink_transfer_thread_func (gpointer data)
     goto done;
   }
 
-  while (!sink->transfer_thread_close && sink->flow_ret == GST_FLOW_OK) {
+  while (sink->flow_ret == GST_FLOW_OK) {
     /* we are working on a new file, clearing flag and setting file
      * name in http header */
     sink->new_file = FALSE;
 
     /* wait for data to arrive for this new file, if we get a new file name
      * again before getting data we will simply skip transfering anything
-     * for this file and go directly to the new file */
+     * for this file and go directly to the new file. Data queued before
+     * the thread is closed is still sent. */
     data_available = gst_curl_sink_wait_for_data_unlocked (sink);
-    if (data_available) {
-      gst_curl_sink_set_http_header_unlocked (sink);
+    if (!data_available) {
+      if (sink->transfer_thread_close)
+        break;
+      continue;
     }
 
+    gst_curl_sink_set_http_header_unlocked (sink);
+
     /* stay unlocked while handling the actual transfer */
     GST_OBJECT_UNLOCK (sink);
 
-    if (data_available) {
-      curl_multi_add_handle (sink->multi_handle, sink->curl);
+    /* the multi handle keeps the connection open, so the next file is sent
+     * over the same connection if the server allows it */
+    curl_multi_add_handle (sink->multi_handle, sink->curl);
 
-      /* Start driving the transfer. */
-      ret = gst_curl_sink_handle_transfer (sink);
+    /* Start driving the transfer. */
+    ret = gst_curl_sink_handle_transfer (sink);
 
-      /* easy handle will be possibly re-used for next transfer, thus it needs to
-       * be removed from the multi stack and re-added again */
-      curl_multi_remove_handle (sink->multi_handle, sink->curl);
-    }
+    /* easy handle will be possibly re-used for next transfer, thus it needs to
+     * be removed from the multi stack and re-added again */
+    curl_multi_remove_handle (sink->multi_handle, sink->curl);
 
     /* lock again before looping to check the thread closed flag */
     GST_OBJECT_LOCK (sink);
 
-    /* if we have transfered data, then set the return code */
-    if (data_available) {
-      sink->flow_ret = ret;
-    }
+    sink->flow_ret = ret;
   }
 
 done:
   /* if there is a flow error, always notify the render function so it
    * can return the flow error up along the pipeline */
   if (sink->flow_ret != GST_FLOW_OK) {
+    gst_curl_sink_flush_queue_unlocked (sink);
     gst_curl_sink_data_sent_notify_unlocked (sink);
   }
 
@@ -1111,7 +1203,6 @@ gst_curl_sink_transfer_setup_unlocked (GstCurlSink * sink)
 
   if (!gst_curl_sink_transfer_set_options_unlocked (sink)) {
     g_warning ("Failed to setup easy handle");
-    GST_OBJECT_UNLOCK (sink);
     return FALSE;
   }
 
@@ -1148,15 +1239,15 @@ gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink)
   gboolean data_available = FALSE;
 
   GST_LOG ("waiting for data");
-  while (!sink->transfer_cond->data_available &&
+  while (g_queue_is_empty (sink->queue) &&
       !sink->transfer_thread_close && !sink->new_file) {
-    g_cond_wait (sink->transfer_cond->cond, GST_OBJECT_GET_LOCK (sink));
+    g_cond_wait (sink->transfer_cond, GST_OBJECT_GET_LOCK (sink));
   }
 
-  if (sink->transfer_thread_close) {
-    GST_LOG ("wait for data aborted due to thread close");
-  } else if (sink->new_file) {
+  if (sink->new_file) {
     GST_LOG ("wait for data aborted due to new file name");
+  } else if (g_queue_is_empty (sink->queue)) {
+    GST_LOG ("wait for data aborted due to thread close");
   } else {
     GST_LOG ("wait for data completed");
     data_available = TRUE;
@@ -1169,9 +1260,7 @@ static void
 gst_curl_sink_transfer_thread_notify_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("more data to send");
-  sink->transfer_cond->data_available = TRUE;
-  sink->transfer_cond->data_sent = FALSE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond);
 }
 
 static void
@@ -1179,7 +1268,7 @@ gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("new file name");
   sink->new_file = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond);
 }
 
 static void
@@ -1187,31 +1276,60 @@ gst_curl_sink_transfer_thread_close_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("setting transfer thread close flag");
   sink->transfer_thread_close = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond);
+}
+
+static gboolean
+gst_curl_sink_queue_is_full_unlocked (GstCurlSink * sink, GstBuffer * buf)
+{
+  GstBuffer *head;
+
+  /* a buffer larger than the queue is still accepted when the queue is
+   * empty */
+  if ((head = g_queue_peek_head (sink->queue)) == NULL)
+    return FALSE;
+
+  if (sink->max_queue_bytes > 0 &&
+      sink->queued_bytes + GST_BUFFER_SIZE (buf) > sink->max_queue_bytes)
+    return TRUE;
+
+  if (sink->max_queue_time > 0 && GST_BUFFER_TIMESTAMP_IS_VALID (head) &&
+      GST_BUFFER_TIMESTAMP_IS_VALID (buf) &&
+      GST_BUFFER_TIMESTAMP (buf) >
+      GST_BUFFER_TIMESTAMP (head) + sink->max_queue_time)
+    return TRUE;
+
+  return FALSE;
 }
 
 static void
-gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (GstCurlSink * sink)
+gst_curl_sink_wait_for_queue_drained_unlocked (GstCurlSink * sink)
 {
-  GST_LOG ("waiting for buffer send to complete");
-
-  /* this function should not check if the transfer thread is set to be closed
-   * since that flag only can be set by the EoS event (by the pipeline thread).
-   * This can therefore never happen while this function is running since this
-   * function also is called by the pipeline thread (in the render function) */
-  while (!sink->transfer_cond->data_sent) {
-    g_cond_wait (sink->transfer_cond->cond, GST_OBJECT_GET_LOCK (sink));
+  GST_LOG ("waiting for queued data to be sent");
+
+  while (!g_queue_is_empty (sink->queue) && sink->transfer_thread != NULL &&
+      sink->flow_ret == GST_FLOW_OK && !sink->flushing) {
+    g_cond_wait (sink->transfer_cond, GST_OBJECT_GET_LOCK (sink));
   }
-  GST_LOG ("buffer send completed");
+  GST_LOG ("queue drained");
+}
+
+static void
+gst_curl_sink_flush_queue_unlocked (GstCurlSink * sink)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (sink->queue)))
+    gst_buffer_unref (buf);
+  sink->queued_bytes = 0;
+  sink->queue_offset = 0;
 }
 
 static void
 gst_curl_sink_data_sent_notify_unlocked (GstCurlSink * sink)
 {
-  GST_LOG ("transfer completed");
-  sink->transfer_cond->data_available = FALSE;
-  sink->transfer_cond->data_sent = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  GST_LOG ("data sent");
+  g_cond_broadcast (sink->transfer_cond);
 }
 
 static gint
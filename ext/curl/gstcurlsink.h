@@ -40,21 +40,6 @@ G_BEGIN_DECLS
 typedef struct _GstCurlSink GstCurlSink;
 typedef struct _GstCurlSinkClass GstCurlSinkClass;
 
-typedef struct _TransferBuffer TransferBuffer;
-typedef struct _TransferCondition TransferCondition;
-
-struct _TransferBuffer {
-  guint8 *ptr;
-  size_t len;
-  size_t offset;
-};
-
-struct _TransferCondition {
-  GCond *cond;
-  gboolean data_sent;
-  gboolean data_available;
-};
-
 struct _GstCurlSink
 {
   GstBaseSink parent;
@@ -67,8 +52,16 @@ struct _GstCurlSink
   GstPoll *fdset;
   GThread *transfer_thread;
   GstFlowReturn flow_ret;
-  TransferBuffer *transfer_buf;
-  TransferCondition *transfer_cond;
+  /* signalled when data is queued or sent and on state changes */
+  GCond *transfer_cond;
+  /* references to the buffers still to be sent */
+  GQueue *queue;
+  guint64 queued_bytes;
+  /* bytes of the head buffer already sent */
+  gsize queue_offset;
+  guint max_queue_bytes;
+  guint64 max_queue_time;
+  gboolean flushing;
   gint num_buffers_per_packet;
   gint timeout;
   gchar *url;
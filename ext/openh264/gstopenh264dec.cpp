@@ -33,6 +33,7 @@
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <gst/video/gstbasevideodecoder.h>
+#include <gst/video/gstbasevideoutils.h>
 #include <string.h>             /* for memcpy */
 //#include "gst-compat.h"
 
@@ -189,74 +190,41 @@ static GstFlowReturn
 gst_openh264dec_handle_frame (GstBaseVideoDecoder * decoder,
     GstVideoFrame * frame)
 {
-#if 0                           /* Not ported to 0.1 yet */
-
   GstOpenh264Dec *openh264dec = GST_OPENH264DEC (decoder);
-  GstMapInfo map_info;
   GstVideoState *state;
   SBufferInfo dst_buf_info;
   DECODING_STATE ret;
   guint8 *yuvdata[3];
   GstFlowReturn flow_status;
   guint actual_width, actual_height;
-  guint i;
-  guint8 *p;
-  guint row_stride, component_width, component_height, src_width, row;
-
-
-  state = &decoder->base_video_codec.state;
-
-  state->format = GST_VIDEO_FORMAT_I420;
-  gst_base_video_decoder_set_src_caps (decoder);
-
-  frame->src_buffer = gst_buffer_new_and_alloc (state->bytes_per_picture);
-  frame->presentation_timestamp = frame->decode_timestamp;
+  gint i;
 
+  memset (&dst_buf_info, 0, sizeof (SBufferInfo));
 
   if (frame) {
-    if (!gst_buffer_map (frame->sink_buffer, &map_info, GST_MAP_READ)) {
-      GST_ERROR_OBJECT (openh264dec, "Cannot map input buffer!");
-      //gst_video_codec_frame_unref (frame);
-      return GST_FLOW_ERROR;
-    }
+    guint8 *data = GST_BUFFER_DATA (frame->sink_buffer);
+    guint size = GST_BUFFER_SIZE (frame->sink_buffer);
 
     GST_LOG_OBJECT (openh264dec, "handle frame, %d",
-        map_info.size > 4 ? map_info.data[4] & 0x1f : -1);
-
-    memset (&dst_buf_info, 0, sizeof (SBufferInfo));
-    ret =
-        openh264dec->decoder->DecodeFrame2 (map_info.data, map_info.size,
-        yuvdata, &dst_buf_info);
-/*
-    if (ret == dsNoParamSets) {
-      GST_DEBUG_OBJECT (openh264dec, "Requesting a key unit");
-      gst_pad_push_event (GST_BASE_VIDEO_DECODER_SINK_PAD (decoder),
-          gst_video_event_new_upstream_force_key_unit (GST_CLOCK_TIME_NONE,
-              FALSE, 0));
-    }
+        size > 4 ? data[4] & 0x1f : -1);
 
-    if (ret != dsErrorFree && ret != dsNoParamSets) {
-      GST_DEBUG_OBJECT (openh264dec, "Requesting a key unit");
-      gst_pad_push_event (GST_VIDEO_DECODER_SINK_PAD (decoder),
-          gst_video_event_new_upstream_force_key_unit (GST_CLOCK_TIME_NONE,
-              FALSE, 0));
-      GST_LOG_OBJECT (openh264dec, "error decoding nal, return code: %d", ret);
-    }
-*/
-    gst_buffer_unmap (frame->input_buffer, &map_info);
-    if (ret != dsErrorFree)
+    ret = openh264dec->decoder->DecodeFrame2 (data, size, yuvdata,
+        &dst_buf_info);
+    if (ret != dsErrorFree) {
+      GST_LOG_OBJECT (openh264dec, "error decoding nal, return code: %d",
+          ret);
       return gst_base_video_decoder_drop_frame (decoder, frame);
-
-    // gst_video_codec_frame_unref (frame);
-    frame = NULL;
+    }
   } else {
-    memset (&dst_buf_info, 0, sizeof (SBufferInfo));
     ret = openh264dec->decoder->DecodeFrame2 (NULL, 0, yuvdata, &dst_buf_info);
-    if (ret != dsErrorFree) {
-      return GST_FLOW_EOS;
-    }
+    if (ret != dsErrorFree)
+      return GST_FLOW_UNEXPECTED;
   }
 
+  /* No output available yet */
+  if (dst_buf_info.iBufferStatus != 1)
+    return (frame ? GST_FLOW_OK : GST_FLOW_UNEXPECTED);
+
   /* FIXME: openh264 has no way for us to get a connection
    * between the input and output frames, we just have to
    * guess based on the input. Fortunately openh264 can
@@ -264,70 +232,51 @@ gst_openh264dec_handle_frame (GstBaseVideoDecoder * decoder,
   frame = gst_base_video_decoder_get_oldest_frame (decoder);
   if (!frame) {
     /* Can only happen in finish() */
-    return GST_FLOW_EOS;
-  }
-
-  /* No output available yet */
-  if (dst_buf_info.iBufferStatus != 1) {
-    //gst_video_codec_frame_unref (frame);
-    return (frame ? GST_FLOW_OK : GST_FLOW_EOS);
+    return GST_FLOW_UNEXPECTED;
   }
 
   actual_width = dst_buf_info.UsrData.sSystemBuffer.iWidth;
   actual_height = dst_buf_info.UsrData.sSystemBuffer.iHeight;
 
-
-
-  if ((gst_pad_get_caps (GST_BASE_VIDEO_CODEC_SRC_PAD (openh264dec)) == NULL)
-      || actual_width != openh264dec->width
+  state = gst_base_video_decoder_get_state (decoder);
+  if (actual_width != openh264dec->width
       || actual_height != openh264dec->height) {
+    state->format = GST_VIDEO_FORMAT_I420;
+    state->width = actual_width;
+    state->height = actual_height;
+
+    if (!gst_base_video_decoder_set_src_caps (decoder)) {
+      GST_ELEMENT_ERROR (openh264dec, CORE, NEGOTIATION, (NULL),
+          ("Could not set caps for %ux%u output", actual_width,
+              actual_height));
+      return GST_FLOW_NOT_NEGOTIATED;
+    }
 
     openh264dec->width = actual_width;
     openh264dec->height = actual_height;
-    state = gst_base_video_decoder_get_state (decoder);
-    state->width = actual_width;
-    state->height = actual_height;
-    state->bytes_per_picture = actual_width * actual_height * 3;
   }
 
+  /* downstream's buffers, through pad_alloc, when it provides them */
   flow_status = gst_base_video_decoder_alloc_src_frame (decoder, frame);
   if (flow_status != GST_FLOW_OK) {
-
+    gst_base_video_decoder_drop_frame (decoder, frame);
     return flow_status;
   }
 
-  /*
+  for (i = 0; i < 3; i++) {
+    guint8 *p = GST_BUFFER_DATA (frame->src_buffer) +
+        gst_video_format_get_component_offset (state->format, i,
+        state->width, state->height);
+
+    gst_base_video_copy_plane (p,
+        gst_video_format_get_row_stride (state->format, i, state->width),
+        yuvdata[i], dst_buf_info.UsrData.sSystemBuffer.iStride[i == 0 ? 0 : 1],
+        gst_video_format_get_component_width (state->format, i, state->width),
+        gst_video_format_get_component_height (state->format, i,
+            state->height));
+  }
 
-     if (!gst_video_frame_map (&video_frame, &state->info, frame->output_buffer,
-     GST_MAP_WRITE)) {
-     GST_ERROR_OBJECT (openh264dec, "Cannot map output buffer!");
-     gst_video_codec_state_unref (state);
-     gst_video_codec_frame_unref (frame);
-     return GST_FLOW_ERROR;
-     }
-
-     for (i = 0; i < 3; i++) {
-     p = GST_VIDEO_FRAME_COMP_DATA (&video_frame, i);
-     row_stride = GST_VIDEO_FRAME_COMP_STRIDE (&video_frame, i);
-     component_width = GST_VIDEO_FRAME_COMP_WIDTH (&video_frame, i);
-     component_height = GST_VIDEO_FRAME_COMP_HEIGHT (&video_frame, i);
-     src_width =
-     i <
-     1 ? dst_buf_info.UsrData.sSystemBuffer.
-     iStride[0] : dst_buf_info.UsrData.sSystemBuffer.iStride[1];
-     for (row = 0; row < component_height; row++) {
-     memcpy (p, yuvdata[i], component_width);
-     p += row_stride;
-     yuvdata[i] += src_width;
-     }
-     }
-     gst_video_codec_state_unref (state);
-     gst_video_frame_unmap (&video_frame);
-   */
   return gst_base_video_decoder_finish_frame (decoder, frame);
-#else
-  return GST_FLOW_OK;
-#endif
 }
 
 static GstFlowReturn
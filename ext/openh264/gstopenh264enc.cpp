@@ -286,7 +286,8 @@ gst_openh264enc_class_init (GstOpenh264EncClass * klass)
 
   g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_MULTI_THREAD,
       g_param_spec_uint ("multi-thread", "Number of threads",
-          "The number of threads.",
+          "The number of threads (0 = automatic), only used with more than "
+          "one slice",
           0, G_MAXUINT, DEFAULT_MULTI_THREAD,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
@@ -677,7 +678,7 @@ gst_openh264enc_set_format (GstBaseVideoEncoder * encoder,
   SEncParamExt enc_params;
   SliceModeEnum slice_mode = SM_SINGLE_SLICE;
   guint n_slices = 1;
-  gint ret;
+  gint ret, i;
   GstCaps *outcaps;
 // GstVideoState *output_state;
 
@@ -755,8 +756,9 @@ gst_openh264enc_set_format (GstBaseVideoEncoder * encoder,
 #if OPENH264_MAJOR == 1 && OPENH264_MINOR < 6
     slice_mode = SM_AUTO_SLICE;
 #else
+    /* one slice per thread, 0 lets openh264 use one per CPU core */
     slice_mode = SM_FIXEDSLCNUM_SLICE;
-    n_slices = 0;
+    n_slices = openh264enc->multi_thread;
 #endif
   } else {
     GST_ERROR_OBJECT (openh264enc, "unexpected slice mode %d",
@@ -764,6 +766,16 @@ gst_openh264enc_set_format (GstBaseVideoEncoder * encoder,
     slice_mode = SM_SINGLE_SLICE;
   }
 
+  /* openh264 encodes the slices of a picture in parallel, with a single
+   * slice the additional threads have nothing to do */
+  if (openh264enc->multi_thread > 1 && slice_mode == SM_SINGLE_SLICE) {
+    GST_WARNING_OBJECT (openh264enc, "multi-thread=%u has no effect with a "
+        "single slice, use slice-mode=auto or num-slices",
+        openh264enc->multi_thread);
+  }
+  GST_DEBUG_OBJECT (openh264enc, "threads %u, slice mode %d, %u slices",
+      openh264enc->multi_thread, slice_mode, n_slices);
+
 #if OPENH264_MAJOR == 1 && OPENH264_MINOR < 6
   enc_params.sSpatialLayers[0].sSliceCfg.uiSliceMode = slice_mode;
   enc_params.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceNum = n_slices;
@@ -788,6 +800,18 @@ gst_openh264enc_set_format (GstBaseVideoEncoder * encoder,
 
   openh264enc->encoder->SetOption (ENCODER_OPTION_DATAFORMAT, &video_format);
 
+  memset (&openh264enc->src_pic, 0, sizeof (SSourcePicture));
+  openh264enc->src_pic.iColorFormat = videoFormatI420;
+  openh264enc->src_pic.iPicWidth = width;
+  openh264enc->src_pic.iPicHeight = height;
+  for (i = 0; i < 3; i++) {
+    openh264enc->src_pic.iStride[i] =
+        gst_video_format_get_row_stride (state->format, i, width);
+    openh264enc->plane_offset[i] =
+        gst_video_format_get_component_offset (state->format, i, width,
+        height);
+  }
+
   outcaps =
       gst_caps_copy (gst_static_pad_template_get_caps
       (&gst_openh264enc_src_template));
@@ -844,15 +868,8 @@ gst_openh264enc_handle_frame (GstBaseVideoEncoder * encoder,
   GST_OBJECT_UNLOCK (openh264enc);
 
   if (frame) {
-    src_pic = new SSourcePicture;
-
-    if (src_pic == NULL) {
-      if (frame)
-        gst_video_frame_unref (frame);
-      return GST_FLOW_ERROR;
-    }
-    //fill default src_pic
-    src_pic->iColorFormat = videoFormatI420;
+    /* the picture only points into the input buffer, nothing is copied */
+    src_pic = &openh264enc->src_pic;
     src_pic->uiTimeStamp = frame->presentation_timestamp / GST_MSECOND;
   }
 
@@ -874,29 +891,12 @@ gst_openh264enc_handle_frame (GstBaseVideoEncoder * encoder,
   }
 
   if (frame) {
-
-    const GstVideoState *state = gst_base_video_encoder_get_state (encoder);
-
-    src_pic->iPicWidth = state->width;
-    src_pic->iPicHeight = state->height;
-    src_pic->iStride[0] =
-        gst_video_format_get_row_stride (state->format, 0, state->width);
-    src_pic->iStride[1] =
-        gst_video_format_get_row_stride (state->format, 1, state->width);
-    src_pic->iStride[2] =
-        gst_video_format_get_row_stride (state->format, 2, state->width);
-
     guint8 *data = GST_BUFFER_DATA (frame->sink_buffer);
 
-    src_pic->pData[0] =
-        data + gst_video_format_get_component_offset (state->format, 0,
-        state->width, state->height);
-    src_pic->pData[1] =
-        data + gst_video_format_get_component_offset (state->format, 1,
-        state->width, state->height);
-    src_pic->pData[2] =
-        data + gst_video_format_get_component_offset (state->format, 2,
-        state->width, state->height);
+    /* geometry is set up in set_format, only the planes change */
+    src_pic->pData[0] = data + openh264enc->plane_offset[0];
+    src_pic->pData[1] = data + openh264enc->plane_offset[1];
+    src_pic->pData[2] = data + openh264enc->plane_offset[2];
 
     if (frame->force_keyframe) {
       openh264enc->encoder->ForceIntraFrame (true);
@@ -909,7 +909,6 @@ gst_openh264enc_handle_frame (GstBaseVideoEncoder * encoder,
   ret = openh264enc->encoder->EncodeFrame (src_pic, &frame_info);
   if (ret != cmResultSuccess) {
     if (frame) {
-      delete src_pic;
       GST_ELEMENT_ERROR (openh264enc, STREAM, ENCODE,
           ("Could not encode frame"), ("Openh264 returned %d", ret));
       return GST_FLOW_ERROR;
@@ -919,11 +918,8 @@ gst_openh264enc_handle_frame (GstBaseVideoEncoder * encoder,
   }
 
   if (videoFrameTypeSkip == frame_info.eFrameType) {
-    if (frame) {
-
+    if (frame)
       gst_base_video_encoder_finish_frame (encoder, frame);
-      delete src_pic;
-    }
 
     return GST_FLOW_OK;
   }
@@ -967,9 +963,6 @@ gst_openh264enc_handle_frame (GstBaseVideoEncoder * encoder,
   GST_LOG_OBJECT (openh264enc, "openh264 picture %scoded OK!",
       (ret != cmResultSuccess) ? "NOT " : "");
 
-
-  delete src_pic;
-
   return gst_base_video_encoder_finish_frame (encoder, frame);
 }
 
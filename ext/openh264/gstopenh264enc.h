@@ -92,6 +92,10 @@ struct _GstOpenh264Enc
   ECOMPLEXITY_MODE complexity;
   gboolean bitrate_changed;
   gboolean max_bitrate_changed;
+
+  /* input picture, set up for the negotiated caps */
+  SSourcePicture src_pic;
+  guint plane_offset[3];
 };
 
 struct _GstOpenh264EncClass
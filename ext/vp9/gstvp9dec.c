@@ -51,6 +51,8 @@
 
 #include <string.h>
 
+#include <gst/video/gstbasevideoutils.h>
+
 #include "gstvp9dec.h"
 #include "gstvp9utils.h"
 
@@ -271,6 +273,7 @@ gst_vp9_dec_start (GstBaseVideoDecoder * decoder)
 
   GST_DEBUG_OBJECT (gst_vp9_dec, "start");
   gst_vp9_dec->decoder_inited = FALSE;
+  gst_vp9_dec->copied_frames = 0;
 
   return TRUE;
 }
@@ -280,7 +283,8 @@ gst_vp9_dec_stop (GstBaseVideoDecoder * base_video_decoder)
 {
   GstVP9Dec *gst_vp9_dec = GST_VP9_DEC (base_video_decoder);
 
-  GST_DEBUG_OBJECT (gst_vp9_dec, "stop");
+  GST_DEBUG_OBJECT (gst_vp9_dec, "stop, copied %" G_GUINT64_FORMAT
+      " frames", gst_vp9_dec->copied_frames);
   if (gst_vp9_dec->decoder_inited)
     vpx_codec_destroy (&gst_vp9_dec->decoder);
   gst_vp9_dec->decoder_inited = FALSE;
@@ -337,42 +341,34 @@ static void
 gst_vp9_dec_image_to_buffer (GstVP9Dec * dec, const vpx_image_t * img,
     GstBuffer * buffer)
 {
-  int stride, w, h, i;
-  guint8 *d;
   GstVideoState *state = &GST_BASE_VIDEO_CODEC (dec)->state;
+  static const gint planes[3] = { VPX_PLANE_Y, VPX_PLANE_U, VPX_PLANE_V };
+  gint c;
+
+  for (c = 0; c < 3; c++) {
+    guint8 *d;
+    gint stride, w, h;
+
+    d = GST_BUFFER_DATA (buffer) +
+        gst_video_format_get_component_offset (state->format, c,
+        state->width, state->height);
+    stride = gst_video_format_get_row_stride (state->format, c, state->width);
+    w = gst_video_format_get_component_width (state->format, c, state->width);
+    h = gst_video_format_get_component_height (state->format, c,
+        state->height);
+    if (c == 0) {
+      w = MIN (w, img->w);
+      h = MIN (h, img->h);
+    } else {
+      w = MIN (w, img->w >> img->x_chroma_shift);
+      h = MIN (h, img->h >> img->y_chroma_shift);
+    }
+
+    gst_base_video_copy_plane (d, stride, img->planes[planes[c]],
+        img->stride[planes[c]], w, h);
+  }
 
-  d = GST_BUFFER_DATA (buffer) +
-      gst_video_format_get_component_offset (state->format, 0,
-      state->width, state->height);
-  stride = gst_video_format_get_row_stride (state->format, 0, state->width);
-  h = gst_video_format_get_component_height (state->format, 0, state->height);
-  h = MIN (h, img->h);
-  w = gst_video_format_get_component_width (state->format, 0, state->width);
-  w = MIN (w, img->w);
-
-  for (i = 0; i < h; i++)
-    memcpy (d + i * stride,
-        img->planes[VPX_PLANE_Y] + i * img->stride[VPX_PLANE_Y], w);
-
-  d = GST_BUFFER_DATA (buffer) +
-      gst_video_format_get_component_offset (state->format, 1,
-      state->width, state->height);
-  stride = gst_video_format_get_row_stride (state->format, 1, state->width);
-  h = gst_video_format_get_component_height (state->format, 1, state->height);
-  h = MIN (h, img->h >> img->y_chroma_shift);
-  w = gst_video_format_get_component_width (state->format, 1, state->width);
-  w = MIN (w, img->w >> img->x_chroma_shift);
-  for (i = 0; i < h; i++)
-    memcpy (d + i * stride,
-        img->planes[VPX_PLANE_U] + i * img->stride[VPX_PLANE_U], w);
-
-  d = GST_BUFFER_DATA (buffer) +
-      gst_video_format_get_component_offset (state->format, 2,
-      state->width, state->height);
-  /* Same stride, height, width as above */
-  for (i = 0; i < h; i++)
-    memcpy (d + i * stride,
-        img->planes[VPX_PLANE_V] + i * img->stride[VPX_PLANE_V], w);
+  dec->copied_frames++;
 }
 
 static GstFlowReturn
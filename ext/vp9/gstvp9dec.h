@@ -61,6 +61,9 @@ struct _GstVP9Dec
   /* state */
   gboolean decoder_inited;
 
+  /* statistics */
+  guint64 copied_frames;
+
   /* properties */
   gboolean post_processing;
   enum vp8_postproc_level post_processing_flags;
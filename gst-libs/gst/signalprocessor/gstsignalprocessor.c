@@ -47,11 +47,20 @@
 #include <gst/controller/gstcontroller.h>
 #include <gst/audio/audio.h>
 #include "gstsignalprocessor.h"
+#include "gstsignalprocessororc.h"
 
 
 GST_DEBUG_CATEGORY_STATIC (gst_signal_processor_debug);
 #define GST_CAT_DEFAULT gst_signal_processor_debug
 
+#define DEFAULT_BLOCK_SIZE 0
+
+enum
+{
+  PROP_0,
+  PROP_BLOCK_SIZE
+};
+
 #define GST_TYPE_SIGNAL_PROCESSOR_PAD_TEMPLATE \
     (gst_signal_processor_pad_template_get_type ())
 #define GST_SIGNAL_PROCESSOR_PAD_TEMPLATE(obj) \
@@ -178,6 +187,10 @@ GST_BOILERPLATE_FULL (GstSignalProcessor, gst_signal_processor, GstElement,
 
 
 static void gst_signal_processor_finalize (GObject * object);
+static void gst_signal_processor_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_signal_processor_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
 static gboolean gst_signal_processor_src_activate_pull (GstPad * pad,
     gboolean active);
 static gboolean gst_signal_processor_sink_activate_push (GstPad * pad,
@@ -209,6 +222,18 @@ gst_signal_processor_class_init (GstSignalProcessorClass * klass)
   gstelement_class = GST_ELEMENT_CLASS (klass);
 
   gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_signal_processor_finalize);
+  gobject_class->set_property = gst_signal_processor_set_property;
+  gobject_class->get_property = gst_signal_processor_get_property;
+
+  /* processing a large buffer in one go makes the de-interleaved group data
+   * and the plugin's working set fall out of the cache between the passes;
+   * with a block size the buffers are processed in chunks of that many
+   * frames instead */
+  g_object_class_install_property (gobject_class, PROP_BLOCK_SIZE,
+      g_param_spec_uint ("block-size", "Block size",
+          "Number of sample frames to process at once (0 = whole buffers)",
+          0, G_MAXUINT, DEFAULT_BLOCK_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_signal_processor_change_state);
@@ -282,6 +307,8 @@ gst_signal_processor_init (GstSignalProcessor * self,
   /* init */
   self->pending_in = klass->num_group_in + klass->num_audio_in;
   self->pending_out = 0;
+
+  self->block_size = DEFAULT_BLOCK_SIZE;
 }
 
 static void
@@ -305,6 +332,42 @@ gst_signal_processor_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_signal_processor_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstSignalProcessor *self = GST_SIGNAL_PROCESSOR (object);
+
+  switch (prop_id) {
+    case PROP_BLOCK_SIZE:
+      GST_OBJECT_LOCK (self);
+      self->block_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_signal_processor_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstSignalProcessor *self = GST_SIGNAL_PROCESSOR (object);
+
+  switch (prop_id) {
+    case PROP_BLOCK_SIZE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->block_size);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static gboolean
 gst_signal_processor_setup (GstSignalProcessor * self, GstCaps * caps)
 {
@@ -412,7 +475,7 @@ gst_signal_processor_cleanup (GstSignalProcessor * self)
 
   for (i = 0; i < klass->num_group_out; ++i) {
     g_free (self->group_out[i].buffer);
-    memset (&self->group_in[i], '\0', sizeof (GstSignalProcessorGroup));
+    memset (&self->group_out[i], '\0', sizeof (GstSignalProcessorGroup));
   }
 
   self->state = GST_SIGNAL_PROCESSOR_STATE_NULL;
@@ -535,34 +598,101 @@ setcaps_pull_failed:
   }
 }
 
-/* De-interleave a pad (gstreamer => plugin) */
+/* Make room for @nframes frames of @channels channels in the de-interleaved
+ * buffer of a group */
+static void
+gst_signal_processor_group_alloc (GstSignalProcessorGroup * group,
+    guint channels, guint nframes)
+{
+  if (!group->buffer || group->allocated < channels * nframes) {
+    group->buffer = (gfloat *) g_realloc (group->buffer,
+        channels * nframes * sizeof (gfloat));
+    memset (group->buffer, '\0', channels * nframes * sizeof (gfloat));
+    group->allocated = channels * nframes;
+  }
+  group->channels = channels;
+  group->nframes = nframes;
+}
+
+/* the channel count is a constant for these, so the compiler can unroll the
+ * inner loop and keep one read and n write streams going */
+#define DEINTERLEAVE_N(in,out,nframes,n) G_STMT_START {   \
+  guint i, j;                                             \
+  for (i = 0; i < nframes; ++i, in += n)                  \
+    for (j = 0; j < n; ++j)                               \
+      out[(j * nframes) + i] = in[j];                     \
+} G_STMT_END
+
+#define INTERLEAVE_N(in,out,nframes,n) G_STMT_START {     \
+  guint i, j;                                             \
+  for (i = 0; i < nframes; ++i, out += n)                 \
+    for (j = 0; j < n; ++j)                               \
+      out[j] = in[(j * nframes) + i];                     \
+} G_STMT_END
+
+/* De-interleave @nframes frames of a pad, starting at frame @offset
+ * (gstreamer => plugin) */
 static void
 gst_signal_processor_deinterleave_group (GstSignalProcessorGroup * group,
-    guint nframes)
+    guint offset, guint nframes)
 {
-  guint i, j;
+  const gfloat *in;
+  gfloat *out;
+
   g_assert (group->nframes == nframes);
   g_assert (group->interleaved_buffer);
   g_assert (group->buffer);
-  for (i = 0; i < nframes; ++i)
-    for (j = 0; j < group->channels; ++j)
-      group->buffer[(j * nframes) + i]
-          = group->interleaved_buffer[(i * group->channels) + j];
+
+  in = group->interleaved_buffer + (offset * group->channels);
+  out = group->buffer;
+
+  switch (group->channels) {
+    case 2:
+      gst_signal_processor_orc_deinterleave_2 (out, out + nframes, in,
+          nframes);
+      break;
+    case 6:
+      DEINTERLEAVE_N (in, out, nframes, 6);
+      break;
+    case 8:
+      DEINTERLEAVE_N (in, out, nframes, 8);
+      break;
+    default:
+      DEINTERLEAVE_N (in, out, nframes, group->channels);
+      break;
+  }
 }
 
-/* Interleave a pad (plugin => gstreamer) */
+/* Interleave @nframes frames of a pad, starting at frame @offset
+ * (plugin => gstreamer) */
 static void
 gst_signal_processor_interleave_group (GstSignalProcessorGroup * group,
-    guint nframes)
+    guint offset, guint nframes)
 {
-  guint i, j;
+  const gfloat *in;
+  gfloat *out;
+
   g_assert (group->nframes == nframes);
   g_assert (group->interleaved_buffer);
   g_assert (group->buffer);
-  for (i = 0; i < nframes; ++i)
-    for (j = 0; j < group->channels; ++j)
-      group->interleaved_buffer[(i * group->channels) + j]
-          = group->buffer[(j * nframes) + i];
+
+  in = group->buffer;
+  out = group->interleaved_buffer + (offset * group->channels);
+
+  switch (group->channels) {
+    case 2:
+      gst_signal_processor_orc_interleave_2 (out, in, in + nframes, nframes);
+      break;
+    case 6:
+      INTERLEAVE_N (in, out, nframes, 6);
+      break;
+    case 8:
+      INTERLEAVE_N (in, out, nframes, 8);
+      break;
+    default:
+      INTERLEAVE_N (in, out, nframes, group->channels);
+      break;
+  }
 }
 
 static gboolean
@@ -633,20 +763,8 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
     samples_avail = MIN (samples_avail, sinkpad->samples_avail);
     if (sinkpad->channels > 1) {
       GstSignalProcessorGroup *group = &self->group_in[in_group_index++];
+      /* de-interleaved block by block in process() */
       group->interleaved_buffer = sinkpad->data;
-      /* allocate buffer for de-interleaving */
-      if (!group->buffer || group->channels < sinkpad->channels
-          || group->nframes < samples_avail) {
-        group->buffer =
-            (gfloat *) g_realloc (group->buffer,
-            samples_avail * sinkpad->channels * sizeof (gfloat));
-        memset (group->buffer, '\0',
-            samples_avail * sinkpad->channels * sizeof (gfloat));
-      }
-      g_assert (group->buffer);
-      group->channels = sinkpad->channels;
-      group->nframes = samples_avail;
-      gst_signal_processor_deinterleave_group (group, samples_avail);
     } else {
       self->audio_in[sinkpad->index] = sinkpad->data;
     }
@@ -733,13 +851,6 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
     } else if (srcpad->channels > 1) {
       GstSignalProcessorGroup *group = &self->group_out[out_group_index++];
       group->interleaved_buffer = (gfloat *) GST_BUFFER_DATA (srcpad->pen);
-      if (!group->buffer || group->channels < srcpad->channels
-          || group->nframes < samples_avail)
-        group->buffer =
-            (gfloat *) g_realloc (group->buffer,
-            samples_avail * srcpad->channels * sizeof (gfloat));
-      group->channels = srcpad->channels;
-      group->nframes = samples_avail;
       self->pending_out++;
     } else {
       self->audio_out[srcpad->index] = (gfloat *) GST_BUFFER_DATA (srcpad->pen);
@@ -793,20 +904,61 @@ gst_signal_processor_update_inputs (GstSignalProcessor * self, guint nprocessed)
   }
 }
 
+/* points the single channel ports at frame @offset of the penned buffers and
+ * de-interleaves the next @nframes frames of the multi-channel inputs */
+static void
+gst_signal_processor_prepare_block (GstSignalProcessor * self, guint offset,
+    guint nframes)
+{
+  GstElement *elem = (GstElement *) self;
+  GList *l;
+  guint in_group_index = 0, out_group_index = 0;
+
+  for (l = elem->sinkpads; l; l = l->next) {
+    GstSignalProcessorPad *sinkpad = (GstSignalProcessorPad *) l->data;
+
+    if (sinkpad->channels > 1) {
+      GstSignalProcessorGroup *group = &self->group_in[in_group_index++];
+
+      gst_signal_processor_group_alloc (group, sinkpad->channels, nframes);
+      gst_signal_processor_deinterleave_group (group, offset, nframes);
+    } else {
+      self->audio_in[sinkpad->index] = sinkpad->data + offset;
+    }
+  }
+
+  for (l = elem->srcpads; l; l = l->next) {
+    GstSignalProcessorPad *srcpad = (GstSignalProcessorPad *) l->data;
+
+    if (srcpad->channels > 1) {
+      GstSignalProcessorGroup *group = &self->group_out[out_group_index++];
+
+      gst_signal_processor_group_alloc (group, srcpad->channels, nframes);
+    } else {
+      self->audio_out[srcpad->index] =
+          (gfloat *) GST_BUFFER_DATA (srcpad->pen) + offset;
+    }
+  }
+}
+
+/* interleaves the block processed last into the output buffers */
 static void
-gst_signal_processor_update_outputs (GstSignalProcessor * self,
-    guint nprocessed)
+gst_signal_processor_finish_block (GstSignalProcessor * self, guint offset,
+    guint nframes)
 {
   GstSignalProcessorClass *klass = GST_SIGNAL_PROCESSOR_GET_CLASS (self);
   guint i;
+
   for (i = 0; i < klass->num_group_out; ++i)
-    gst_signal_processor_interleave_group (&self->group_out[i], nprocessed);
+    gst_signal_processor_interleave_group (&self->group_out[i], offset,
+        nframes);
 }
 
 static gboolean
 gst_signal_processor_process (GstSignalProcessor * self, guint nframes)
 {
   GstSignalProcessorClass *klass;
+  guint block_size, offset, n;
 
   /* check if we have buffers enqueued */
   g_return_val_if_fail (self->pending_in == 0, FALSE);
@@ -819,12 +971,25 @@ gst_signal_processor_process (GstSignalProcessor * self, guint nframes)
 
   klass = GST_SIGNAL_PROCESSOR_GET_CLASS (self);
 
-  GST_LOG_OBJECT (self, "process(%u)", nframes);
+  GST_OBJECT_LOCK (self);
+  block_size = self->block_size;
+  GST_OBJECT_UNLOCK (self);
+  if (block_size == 0 || block_size > nframes)
+    block_size = nframes;
 
-  klass->process (self, nframes);
+  for (offset = 0; offset < nframes; offset += n) {
+    n = MIN (block_size, nframes - offset);
+
+    gst_signal_processor_prepare_block (self, offset, n);
+
+    GST_LOG_OBJECT (self, "process(%u) at frame %u", n, offset);
+
+    klass->process (self, n);
+
+    gst_signal_processor_finish_block (self, offset, n);
+  }
 
   gst_signal_processor_update_inputs (self, nframes);
-  gst_signal_processor_update_outputs (self, nframes);
 
   return TRUE;
 
@@ -73,6 +73,7 @@ struct _GstSignalProcessorGroup {
   guint nframes; /**< Number of frames currently allocated per channel */
   gfloat *interleaved_buffer; /**< Interleaved buffer (c1c2c1c2...)*/
   gfloat *buffer; /**< De-interleaved buffer (c1c1...c2c2...) */
+  guint allocated; /**< Number of samples allocated in buffer */
 };
 
 struct _GstSignalProcessor {
@@ -104,6 +105,10 @@ struct _GstSignalProcessor {
   /* sampling rate */
   gint sample_rate;
 
+  /* frames per process() call, 0 for whole buffers; protected by the
+   * object lock */
+  guint block_size;
+
 };
 
 struct _GstSignalProcessorClass {
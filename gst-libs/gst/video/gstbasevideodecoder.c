@@ -100,6 +100,12 @@
  * and should ensure the parsing stage properly marks keyframes or rely on
  * upstream to do so properly for incoming data.
  *
+ * Subclasses whose frames can be decoded independently of each other can
+ * enable frame-parallel decoding with gst_base_video_decoder_set_n_workers().
+ * @handle_frame is then called from a pool of decoding threads, without the
+ * stream lock held, and frames may be finished in any order; baseclass pushes
+ * them downstream in decoding order.
+ *
  * Things that subclass need to take care of:
  * <itemizedlist>
  *   <listitem><para>Provide pad templates</para></listitem>
@@ -171,6 +177,8 @@ static GstVideoFrame *gst_base_video_decoder_new_frame (GstBaseVideoDecoder *
     base_video_decoder);
 
 static void gst_base_video_decoder_clear_queues (GstBaseVideoDecoder * dec);
+static GstFlowReturn gst_base_video_decoder_drain_workers (GstBaseVideoDecoder *
+    dec, gboolean discard);
 
 GST_BOILERPLATE (GstBaseVideoDecoder, gst_base_video_decoder,
     GstBaseVideoCodec, GST_TYPE_BASE_VIDEO_CODEC);
@@ -230,6 +238,14 @@ gst_base_video_decoder_init (GstBaseVideoDecoder * base_video_decoder,
   base_video_decoder->input_adapter = gst_adapter_new ();
   base_video_decoder->output_adapter = gst_adapter_new ();
 
+  base_video_decoder->frames_by_number = g_hash_table_new (NULL, NULL);
+
+  base_video_decoder->worker_lock = g_mutex_new ();
+  base_video_decoder->worker_cond = g_cond_new ();
+  base_video_decoder->worker_frames = g_queue_new ();
+  base_video_decoder->worker_index = g_hash_table_new (NULL, NULL);
+  base_video_decoder->worker_flow_ret = GST_FLOW_OK;
+
   gst_base_video_decoder_reset (base_video_decoder, TRUE);
 
   base_video_decoder->sink_clipping = TRUE;
@@ -348,6 +364,18 @@ gst_base_video_decoder_finalize (GObject * object)
     base_video_decoder->output_adapter = NULL;
   }
 
+  if (base_video_decoder->worker_pool) {
+    g_thread_pool_free (base_video_decoder->worker_pool, FALSE, TRUE);
+    base_video_decoder->worker_pool = NULL;
+  }
+  g_hash_table_destroy (base_video_decoder->worker_index);
+  g_queue_free (base_video_decoder->worker_frames);
+  g_cond_free (base_video_decoder->worker_cond);
+  g_mutex_free (base_video_decoder->worker_lock);
+
+  g_hash_table_destroy (base_video_decoder->frames_by_number);
+  g_free (base_video_decoder->timestamps);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -362,6 +390,9 @@ gst_base_video_decoder_flush (GstBaseVideoDecoder * dec, gboolean hard)
 
   GST_LOG_OBJECT (dec, "flush hard %d", hard);
 
+  /* frames still being decoded are pushed, or dropped when flushing */
+  ret = gst_base_video_decoder_drain_workers (dec, hard);
+
   /* Inform subclass */
   /* FIXME ? only if hard, or tell it if hard ? */
   if (klass->reset)
@@ -416,14 +447,16 @@ gst_base_video_decoder_sink_event (GstPad * pad, GstEvent * event)
         } while (flow_ret == GST_FLOW_OK);
       }
 
-      if (base_video_decoder_class->finish) {
+      flow_ret =
+          gst_base_video_decoder_drain_workers (base_video_decoder, FALSE);
+
+      if (flow_ret == GST_FLOW_OK && base_video_decoder_class->finish)
         flow_ret = base_video_decoder_class->finish (base_video_decoder);
-      } else {
-        flow_ret = GST_FLOW_OK;
-      }
 
       if (flow_ret == GST_FLOW_OK)
         ret = gst_base_video_decoder_push_src_event (base_video_decoder, event);
+      else
+        gst_event_unref (event);
       GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (base_video_decoder);
       break;
     }
@@ -853,8 +886,8 @@ error:
   goto done;
 }
 
-typedef struct _Timestamp Timestamp;
-struct _Timestamp
+typedef GstBaseVideoDecoderTimestamp Timestamp;
+struct _GstBaseVideoDecoderTimestamp
 {
   guint64 offset;
   GstClockTime timestamp;
@@ -865,21 +898,39 @@ static void
 gst_base_video_decoder_add_timestamp (GstBaseVideoDecoder * base_video_decoder,
     GstBuffer * buffer)
 {
+  Timestamp *ring = base_video_decoder->timestamps;
   Timestamp *ts;
-
-  ts = g_malloc (sizeof (Timestamp));
+  guint size = base_video_decoder->timestamps_size;
+
+  if (base_video_decoder->timestamps_len == size) {
+    Timestamp *tmp;
+    guint i;
+
+    /* grow the ring, keeping the entries in order of offset */
+    size = MAX (16, size * 2);
+    tmp = g_new (Timestamp, size);
+    for (i = 0; i < base_video_decoder->timestamps_len; i++) {
+      tmp[i] = ring[(base_video_decoder->timestamps_head + i) %
+          base_video_decoder->timestamps_size];
+    }
+    g_free (ring);
+    ring = base_video_decoder->timestamps = tmp;
+    base_video_decoder->timestamps_size = size;
+    base_video_decoder->timestamps_head = 0;
+  }
 
   GST_LOG_OBJECT (base_video_decoder,
       "adding timestamp %" GST_TIME_FORMAT " %" GST_TIME_FORMAT,
       GST_TIME_ARGS (base_video_decoder->input_offset),
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)));
 
+  ts = &ring[(base_video_decoder->timestamps_head +
+          base_video_decoder->timestamps_len) % size];
   ts->offset = base_video_decoder->input_offset;
   ts->timestamp = GST_BUFFER_TIMESTAMP (buffer);
   ts->duration = GST_BUFFER_DURATION (buffer);
 
-  base_video_decoder->timestamps =
-      g_list_append (base_video_decoder->timestamps, ts);
+  base_video_decoder->timestamps_len++;
 }
 
 static void
@@ -887,25 +938,24 @@ gst_base_video_decoder_get_timestamp_at_offset (GstBaseVideoDecoder *
     base_video_decoder, guint64 offset, GstClockTime * timestamp,
     GstClockTime * duration)
 {
-  Timestamp *ts;
-  GList *g;
+  Timestamp *ring = base_video_decoder->timestamps;
 
   *timestamp = GST_CLOCK_TIME_NONE;
   *duration = GST_CLOCK_TIME_NONE;
 
-  g = base_video_decoder->timestamps;
-  while (g) {
-    ts = g->data;
-    if (ts->offset <= offset) {
-      *timestamp = ts->timestamp;
-      *duration = ts->duration;
-      g_free (ts);
-      g = g_list_next (g);
-      base_video_decoder->timestamps =
-          g_list_remove (base_video_decoder->timestamps, ts);
-    } else {
+  /* entries are consumed in order, so only the head needs checking */
+  while (base_video_decoder->timestamps_len > 0) {
+    Timestamp *ts = &ring[base_video_decoder->timestamps_head];
+
+    if (ts->offset > offset)
       break;
-    }
+
+    *timestamp = ts->timestamp;
+    *duration = ts->duration;
+    base_video_decoder->timestamps_head =
+        (base_video_decoder->timestamps_head + 1) %
+        base_video_decoder->timestamps_size;
+    base_video_decoder->timestamps_len--;
   }
 
   GST_LOG_OBJECT (base_video_decoder,
@@ -935,6 +985,7 @@ gst_base_video_decoder_clear_queues (GstBaseVideoDecoder * dec)
       (GFunc) gst_video_frame_unref, NULL);
   g_list_free (GST_BASE_VIDEO_CODEC (dec)->frames);
   GST_BASE_VIDEO_CODEC (dec)->frames = NULL;
+  g_hash_table_remove_all (dec->frames_by_number);
 }
 
 static void
@@ -946,6 +997,7 @@ gst_base_video_decoder_reset (GstBaseVideoDecoder * base_video_decoder,
   GST_BASE_VIDEO_CODEC_STREAM_LOCK (base_video_decoder);
 
   if (full) {
+    gst_base_video_decoder_drain_workers (base_video_decoder, TRUE);
     gst_segment_init (&GST_BASE_VIDEO_CODEC (base_video_decoder)->segment,
         GST_FORMAT_UNDEFINED);
     gst_base_video_decoder_clear_queues (base_video_decoder);
@@ -963,9 +1015,8 @@ gst_base_video_decoder_reset (GstBaseVideoDecoder * base_video_decoder,
   base_video_decoder->frame_offset = 0;
   gst_adapter_clear (base_video_decoder->input_adapter);
   gst_adapter_clear (base_video_decoder->output_adapter);
-  g_list_foreach (base_video_decoder->timestamps, (GFunc) g_free, NULL);
-  g_list_free (base_video_decoder->timestamps);
-  base_video_decoder->timestamps = NULL;
+  base_video_decoder->timestamps_head = 0;
+  base_video_decoder->timestamps_len = 0;
 
   if (base_video_decoder->current_frame) {
     gst_video_frame_unref (base_video_decoder->current_frame);
@@ -1107,6 +1158,12 @@ gst_base_video_decoder_flush_decode (GstBaseVideoDecoder * dec)
     walk = next;
   }
 
+  /* all frames need to be queued before sending them downstream */
+  if (res == GST_FLOW_OK)
+    res = gst_base_video_decoder_drain_workers (dec, FALSE);
+  else
+    gst_base_video_decoder_drain_workers (dec, TRUE);
+
   dec->process = FALSE;
 
   return res;
@@ -1480,10 +1537,265 @@ gst_base_video_decoder_do_finish_frame (GstBaseVideoDecoder * dec,
 {
   GST_BASE_VIDEO_CODEC (dec)->frames =
       g_list_remove (GST_BASE_VIDEO_CODEC (dec)->frames, frame);
+  g_hash_table_remove (dec->frames_by_number,
+      GINT_TO_POINTER (frame->system_frame_number));
 
   gst_video_frame_unref (frame);
 }
 
+/* frame-parallel decoding
+ *
+ * Frames are handed to the worker pool in decoding order and kept in
+ * worker_frames.  Workers only mark frames as finished or dropped, the actual
+ * output is done on the streaming thread, which pops completed frames from
+ * the head of worker_frames.  Lock order is stream lock, then worker lock. */
+typedef enum
+{
+  WORKER_FRAME_QUEUED,
+  WORKER_FRAME_FINISHED,
+  WORKER_FRAME_DROPPED
+} WorkerFrameState;
+
+typedef struct _WorkerFrame WorkerFrame;
+struct _WorkerFrame
+{
+  GstVideoFrame *frame;
+  WorkerFrameState state;
+  /* handle_frame returned for this frame */
+  gboolean returned;
+};
+
+static GstFlowReturn
+gst_base_video_decoder_finish_frame_unlocked (GstBaseVideoDecoder *
+    base_video_decoder, GstVideoFrame * frame);
+static GstFlowReturn gst_base_video_decoder_drop_frame_unlocked
+    (GstBaseVideoDecoder * dec, GstVideoFrame * frame);
+
+static void
+gst_base_video_decoder_worker_func (gpointer data, gpointer user_data)
+{
+  WorkerFrame *wf = data;
+  GstBaseVideoDecoder *dec = user_data;
+  GstBaseVideoDecoderClass *klass = GST_BASE_VIDEO_DECODER_GET_CLASS (dec);
+  GstFlowReturn ret;
+
+  ret = klass->handle_frame (dec, wf->frame);
+
+  g_mutex_lock (dec->worker_lock);
+  if (wf->state == WORKER_FRAME_QUEUED) {
+    GST_WARNING_OBJECT (dec, "frame %d not finished by handle_frame, dropping",
+        wf->frame->system_frame_number);
+    wf->state = WORKER_FRAME_DROPPED;
+  }
+  if (ret < GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (dec, "flow error %s", gst_flow_get_name (ret));
+    if (dec->worker_flow_ret == GST_FLOW_OK)
+      dec->worker_flow_ret = ret;
+  }
+  wf->returned = TRUE;
+  g_cond_broadcast (dec->worker_cond);
+  g_mutex_unlock (dec->worker_lock);
+}
+
+/* called with the stream lock and the worker lock, the stream lock is
+ * released while waiting so workers can use the base class */
+static void
+gst_base_video_decoder_wait_workers (GstBaseVideoDecoder * dec)
+{
+  guint depth;
+
+  depth =
+      g_static_rec_mutex_unlock_full (&GST_BASE_VIDEO_CODEC (dec)->stream_lock);
+  g_cond_wait (dec->worker_cond, dec->worker_lock);
+  g_mutex_unlock (dec->worker_lock);
+  g_static_rec_mutex_lock_full (&GST_BASE_VIDEO_CODEC (dec)->stream_lock,
+      depth);
+  g_mutex_lock (dec->worker_lock);
+}
+
+/* called with the stream lock, pushes the completed frames at the head of
+ * the worker queue or drops them if @discard */
+static GstFlowReturn
+gst_base_video_decoder_push_completed (GstBaseVideoDecoder * dec,
+    gboolean discard)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  WorkerFrame *wf;
+
+  g_mutex_lock (dec->worker_lock);
+  while ((wf = g_queue_peek_head (dec->worker_frames)) && wf->returned) {
+    g_queue_pop_head (dec->worker_frames);
+    g_hash_table_remove (dec->worker_index, wf->frame);
+    g_mutex_unlock (dec->worker_lock);
+
+    if (discard)
+      gst_base_video_decoder_do_finish_frame (dec, wf->frame);
+    else if (wf->state == WORKER_FRAME_FINISHED)
+      ret = gst_base_video_decoder_finish_frame_unlocked (dec, wf->frame);
+    else
+      ret = gst_base_video_decoder_drop_frame_unlocked (dec, wf->frame);
+    g_slice_free (WorkerFrame, wf);
+
+    g_mutex_lock (dec->worker_lock);
+    if (!discard && ret != GST_FLOW_OK && dec->worker_flow_ret == GST_FLOW_OK)
+      dec->worker_flow_ret = ret;
+  }
+  ret = dec->worker_flow_ret;
+  g_mutex_unlock (dec->worker_lock);
+
+  return ret;
+}
+
+/* called with the stream lock, waits for all frames handed to the workers */
+static GstFlowReturn
+gst_base_video_decoder_drain_workers (GstBaseVideoDecoder * dec,
+    gboolean discard)
+{
+  GstFlowReturn ret;
+
+  if (dec->worker_pool == NULL)
+    return GST_FLOW_OK;
+
+  GST_DEBUG_OBJECT (dec, "draining workers, discard %d", discard);
+
+  g_mutex_lock (dec->worker_lock);
+  while (!g_queue_is_empty (dec->worker_frames)) {
+    WorkerFrame *wf = g_queue_peek_head (dec->worker_frames);
+
+    if (wf->returned) {
+      g_mutex_unlock (dec->worker_lock);
+      gst_base_video_decoder_push_completed (dec, discard);
+      g_mutex_lock (dec->worker_lock);
+    } else {
+      gst_base_video_decoder_wait_workers (dec);
+    }
+  }
+  ret = dec->worker_flow_ret;
+  if (discard)
+    dec->worker_flow_ret = GST_FLOW_OK;
+  g_mutex_unlock (dec->worker_lock);
+
+  return ret;
+}
+
+/* called with the stream lock */
+static GstFlowReturn
+gst_base_video_decoder_submit_frame (GstBaseVideoDecoder * dec,
+    GstVideoFrame * frame)
+{
+  WorkerFrame *wf;
+  GstFlowReturn ret;
+
+  g_mutex_lock (dec->worker_lock);
+  /* keep at most two frames per worker in flight */
+  while (g_queue_get_length (dec->worker_frames) >= 2 * dec->n_workers &&
+      dec->worker_flow_ret == GST_FLOW_OK) {
+    wf = g_queue_peek_head (dec->worker_frames);
+    if (wf->returned) {
+      g_mutex_unlock (dec->worker_lock);
+      gst_base_video_decoder_push_completed (dec, FALSE);
+      g_mutex_lock (dec->worker_lock);
+    } else {
+      gst_base_video_decoder_wait_workers (dec);
+    }
+  }
+
+  ret = dec->worker_flow_ret;
+  if (ret != GST_FLOW_OK) {
+    g_mutex_unlock (dec->worker_lock);
+    return ret;
+  }
+
+  wf = g_slice_new0 (WorkerFrame);
+  wf->frame = frame;
+  wf->state = WORKER_FRAME_QUEUED;
+  g_queue_push_tail (dec->worker_frames, wf);
+  g_hash_table_insert (dec->worker_index, frame, wf);
+  g_mutex_unlock (dec->worker_lock);
+
+  g_thread_pool_push (dec->worker_pool, wf, NULL);
+
+  return gst_base_video_decoder_push_completed (dec, FALSE);
+}
+
+/* marks @frame as completed if it belongs to a worker,
+ * must not take the stream lock */
+static gboolean
+gst_base_video_decoder_complete_worker_frame (GstBaseVideoDecoder * dec,
+    GstVideoFrame * frame, WorkerFrameState state, GstFlowReturn * ret)
+{
+  WorkerFrame *wf;
+
+  g_mutex_lock (dec->worker_lock);
+  wf = g_hash_table_lookup (dec->worker_index, frame);
+  if (wf) {
+    wf->state = state;
+    *ret = dec->worker_flow_ret;
+    g_cond_broadcast (dec->worker_cond);
+  }
+  g_mutex_unlock (dec->worker_lock);
+
+  return wf != NULL;
+}
+
+/**
+ * gst_base_video_decoder_set_n_workers:
+ * @dec: a #GstBaseVideoDecoder
+ * @n_workers: number of decoding threads, or 0 to decode on the streaming
+ *     thread
+ *
+ * Enables frame-parallel decoding.  @handle_frame is then called from a pool
+ * of @n_workers threads without the stream lock held, for up to two frames
+ * per thread at a time.  Each frame has to be finished or dropped before
+ * @handle_frame returns for it; baseclass pushes the frames downstream in
+ * decoding order.
+ *
+ * Must not be called while data is flowing.  Frames still being decoded by
+ * the previous workers are pushed downstream first.
+ *
+ * Returns: a #GstFlowReturn, the result of pushing those frames.
+ *
+ * Since: 0.10.24
+ */
+GstFlowReturn
+gst_base_video_decoder_set_n_workers (GstBaseVideoDecoder * dec,
+    guint n_workers)
+{
+  GError *err = NULL;
+  GstFlowReturn ret;
+
+  g_return_val_if_fail (GST_IS_BASE_VIDEO_DECODER (dec), GST_FLOW_ERROR);
+
+  GST_DEBUG_OBJECT (dec, "using %u workers", n_workers);
+
+  GST_BASE_VIDEO_CODEC_STREAM_LOCK (dec);
+  ret = gst_base_video_decoder_drain_workers (dec, FALSE);
+  /* the new workers start afresh, the caller has the result */
+  g_mutex_lock (dec->worker_lock);
+  dec->worker_flow_ret = GST_FLOW_OK;
+  g_mutex_unlock (dec->worker_lock);
+  if (dec->worker_pool) {
+    g_thread_pool_free (dec->worker_pool, FALSE, TRUE);
+    dec->worker_pool = NULL;
+  }
+
+  dec->n_workers = n_workers;
+  if (n_workers > 0) {
+    dec->worker_pool =
+        g_thread_pool_new (gst_base_video_decoder_worker_func, dec, n_workers,
+        FALSE, &err);
+    if (dec->worker_pool == NULL) {
+      GST_WARNING_OBJECT (dec, "failed to create workers: %s",
+          err ? err->message : "unknown error");
+      g_clear_error (&err);
+      dec->n_workers = 0;
+    }
+  }
+  GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (dec);
+
+  return ret;
+}
+
 /**
  * gst_base_video_decoder_drop_frame:
  * @dec: a #GstBaseVideoDecoder
@@ -1501,14 +1813,30 @@ GstFlowReturn
 gst_base_video_decoder_drop_frame (GstBaseVideoDecoder * dec,
     GstVideoFrame * frame)
 {
-  GstClockTime stream_time, jitter, earliest_time, qostime, timestamp;
-  GstSegment *segment;
-  GstMessage *qos_msg;
-  gdouble proportion;
+  GstFlowReturn ret;
 
   GST_LOG_OBJECT (dec, "drop frame");
 
+  /* output is done in order by the streaming thread */
+  if (dec->worker_pool && gst_base_video_decoder_complete_worker_frame (dec,
+          frame, WORKER_FRAME_DROPPED, &ret))
+    return ret;
+
   GST_BASE_VIDEO_CODEC_STREAM_LOCK (dec);
+  ret = gst_base_video_decoder_drop_frame_unlocked (dec, frame);
+  GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (dec);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_base_video_decoder_drop_frame_unlocked (GstBaseVideoDecoder * dec,
+    GstVideoFrame * frame)
+{
+  GstClockTime stream_time, jitter, earliest_time, qostime, timestamp;
+  GstSegment *segment;
+  GstMessage *qos_msg;
+  gdouble proportion;
 
   gst_base_video_decoder_prepare_finish_frame (dec, frame);
 
@@ -1536,8 +1864,6 @@ gst_base_video_decoder_drop_frame (GstBaseVideoDecoder * dec,
   /* now free the frame */
   gst_base_video_decoder_do_finish_frame (dec, frame);
 
-  GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (dec);
-
   return GST_FLOW_OK;
 }
 
@@ -1551,18 +1877,39 @@ gst_base_video_decoder_drop_frame (GstBaseVideoDecoder * dec,
  * If no output data is provided, @frame is considered skipped.
  * In any case, the frame is considered finished and released.
  *
+ * With frame-parallel decoding the frame is only marked as finished and
+ * pushed later in decoding order, the result of the last push is returned.
+ *
  * Returns: a #GstFlowReturn resulting from sending data downstream
  */
 GstFlowReturn
 gst_base_video_decoder_finish_frame (GstBaseVideoDecoder * base_video_decoder,
     GstVideoFrame * frame)
 {
-  GstVideoState *state = &GST_BASE_VIDEO_CODEC (base_video_decoder)->state;
-  GstBuffer *src_buffer;
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstFlowReturn ret;
 
   GST_LOG_OBJECT (base_video_decoder, "finish frame");
+
+  if (base_video_decoder->worker_pool &&
+      gst_base_video_decoder_complete_worker_frame (base_video_decoder, frame,
+          WORKER_FRAME_FINISHED, &ret))
+    return ret;
+
   GST_BASE_VIDEO_CODEC_STREAM_LOCK (base_video_decoder);
+  ret = gst_base_video_decoder_finish_frame_unlocked (base_video_decoder,
+      frame);
+  GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (base_video_decoder);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_base_video_decoder_finish_frame_unlocked (GstBaseVideoDecoder *
+    base_video_decoder, GstVideoFrame * frame)
+{
+  GstVideoState *state = &GST_BASE_VIDEO_CODEC (base_video_decoder)->state;
+  GstBuffer *src_buffer;
+  GstFlowReturn ret = GST_FLOW_OK;
 
   gst_base_video_decoder_prepare_finish_frame (base_video_decoder, frame);
 
@@ -1680,8 +2027,6 @@ done:
 
   gst_base_video_decoder_do_finish_frame (base_video_decoder, frame);
 
-  GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (base_video_decoder);
-
   return ret;
 }
 
@@ -1854,6 +2199,8 @@ gst_base_video_decoder_have_frame_2 (GstBaseVideoDecoder * base_video_decoder)
 
   GST_BASE_VIDEO_CODEC (base_video_decoder)->frames =
       g_list_append (GST_BASE_VIDEO_CODEC (base_video_decoder)->frames, frame);
+  g_hash_table_insert (base_video_decoder->frames_by_number,
+      GINT_TO_POINTER (frame->system_frame_number), frame);
 
   frame->deadline =
       gst_segment_to_running_time (&GST_BASE_VIDEO_CODEC
@@ -1861,7 +2208,10 @@ gst_base_video_decoder_have_frame_2 (GstBaseVideoDecoder * base_video_decoder)
       frame->presentation_timestamp);
 
   /* do something with frame */
-  ret = base_video_decoder_class->handle_frame (base_video_decoder, frame);
+  if (base_video_decoder->worker_pool)
+    ret = gst_base_video_decoder_submit_frame (base_video_decoder, frame);
+  else
+    ret = base_video_decoder_class->handle_frame (base_video_decoder, frame);
   if (ret != GST_FLOW_OK) {
     GST_DEBUG_OBJECT (base_video_decoder, "flow error %s",
         gst_flow_get_name (ret));
@@ -1963,19 +2313,11 @@ GstVideoFrame *
 gst_base_video_decoder_get_frame (GstBaseVideoDecoder * base_video_decoder,
     int frame_number)
 {
-  GList *g;
-  GstVideoFrame *frame = NULL;
+  GstVideoFrame *frame;
 
   GST_BASE_VIDEO_CODEC_STREAM_LOCK (base_video_decoder);
-  for (g = g_list_first (GST_BASE_VIDEO_CODEC (base_video_decoder)->frames);
-      g; g = g_list_next (g)) {
-    GstVideoFrame *tmp = g->data;
-
-    if (frame->system_frame_number == frame_number) {
-      frame = tmp;
-      break;
-    }
-  }
+  frame = g_hash_table_lookup (base_video_decoder->frames_by_number,
+      GINT_TO_POINTER (frame_number));
   GST_BASE_VIDEO_CODEC_STREAM_UNLOCK (base_video_decoder);
 
   return frame;
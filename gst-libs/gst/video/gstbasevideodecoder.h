@@ -74,6 +74,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstBaseVideoDecoder GstBaseVideoDecoder;
 typedef struct _GstBaseVideoDecoderClass GstBaseVideoDecoderClass;
+typedef struct _GstBaseVideoDecoderTimestamp GstBaseVideoDecoderTimestamp;
 
 
 /* do not use this one, use macro below */
@@ -149,8 +150,11 @@ struct _GstBaseVideoDecoder
   guint64           input_offset;
   /* relative offset of frame */
   guint64           frame_offset;
-  /* tracking ts and offsets */
-  GList            *timestamps;
+  /* tracking ts and offsets, ring buffer ordered by offset */
+  GstBaseVideoDecoderTimestamp *timestamps;
+  guint             timestamps_size;
+  guint             timestamps_head;
+  guint             timestamps_len;
   /* whether parsing is in sync */
   gboolean          have_sync;
 
@@ -186,6 +190,19 @@ struct _GstBaseVideoDecoder
   guint             dropped;
   guint             processed;
 
+  /* pending frames by system_frame_number */
+  GHashTable       *frames_by_number;
+
+  /* frame-parallel decoding */
+  guint             n_workers;
+  GThreadPool      *worker_pool;
+  GMutex           *worker_lock;
+  GCond            *worker_cond;
+  /* frames handed to the workers, in decoding order */
+  GQueue           *worker_frames;
+  GHashTable       *worker_index;
+  GstFlowReturn     worker_flow_ret;
+
   /* FIXME before moving to base */
   void             *padding[GST_PADDING_LARGE];
 };
@@ -208,7 +225,9 @@ struct _GstBaseVideoDecoder
  *                  for subsequent decoding.
  * @reset:          Optional.
  *                  Allows subclass (codec) to perform post-seek semantics reset.
- * @handle_frame:   Provides input data frame to subclass.
+ * @handle_frame:   Provides input data frame to subclass. Called from a
+ *                  decoding thread when frame-parallel decoding was enabled
+ *                  with gst_base_video_decoder_set_n_workers().
  * @finish:         Optional.
  *                  Called to request subclass to dispatch any pending remaining
  *                  data (e.g. at EOS).
@@ -273,6 +292,8 @@ GstFlowReturn    gst_base_video_decoder_finish_frame (GstBaseVideoDecoder *base_
                                     GstVideoFrame *frame);
 GstFlowReturn    gst_base_video_decoder_drop_frame (GstBaseVideoDecoder *dec,
                                     GstVideoFrame *frame);
+GstFlowReturn    gst_base_video_decoder_set_n_workers (GstBaseVideoDecoder *dec,
+                                    guint n_workers);
 GType            gst_base_video_decoder_get_type (void);
 
 G_END_DECLS
@@ -157,3 +157,36 @@ gst_video_state_get_timestamp (const GstVideoState * state,
         state->fps_d * GST_SECOND, state->fps_n);
   }
 }
+
+/**
+ * gst_base_video_copy_plane:
+ * @dest: the first row of the destination plane
+ * @dest_stride: the row stride of @dest
+ * @src: the first row of the source plane
+ * @src_stride: the row stride of @src
+ * @width: the number of bytes to copy per row
+ * @height: the number of rows
+ *
+ * Copies the visible part of a plane, for decoders that have to copy their
+ * pictures out of the library's memory. The plane is copied at once when its
+ * rows are laid out the same way in @src and @dest.
+ *
+ * Since: 0.10.24
+ */
+void
+gst_base_video_copy_plane (guint8 * dest, gint dest_stride,
+    const guint8 * src, gint src_stride, gint width, gint height)
+{
+  gint i;
+
+  if (width <= 0 || height <= 0)
+    return;
+
+  if (dest_stride == src_stride) {
+    memcpy (dest, src, (height - 1) * src_stride + width);
+    return;
+  }
+
+  for (i = 0; i < height; i++)
+    memcpy (dest + i * dest_stride, src + i * src_stride, width);
+}
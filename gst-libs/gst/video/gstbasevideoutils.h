@@ -41,6 +41,9 @@ gboolean gst_base_video_encoded_video_convert (GstVideoState * state,
 GstClockTime gst_video_state_get_timestamp (const GstVideoState *state,
     GstSegment *segment, int frame_number);
 
+void gst_base_video_copy_plane (guint8 * dest, gint dest_stride,
+    const guint8 * src, gint src_stride, gint width, gint height);
+
 G_END_DECLS
 
 #endif
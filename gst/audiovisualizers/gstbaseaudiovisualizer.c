@@ -27,15 +27,22 @@
  * It also provides several background shading effects. These effects are
  * applied to a previous picture before the render() implementation can draw a
  * new frame.
+ *
+ * For analysis the base class keeps pre-allocated sample and spectrum buffers
+ * sized for the samples per frame the subclass asked for in setup(). The
+ * gst_base_audio_visualizer_get_*() helpers fill them on demand from within
+ * render() and compute each of them at most once per video frame.
  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 #include <string.h>
+#include <math.h>
 #include <gst/controller/gstcontroller.h>
 
 #include "gstbaseaudiovisualizer.h"
+#include "gstaudiovisualizersorc.h"
 
 GST_DEBUG_CATEGORY_STATIC (base_audio_visualizer_debug);
 #define GST_CAT_DEFAULT (base_audio_visualizer_debug)
@@ -71,6 +78,10 @@ static gboolean gst_base_audio_visualizer_sink_setcaps (GstPad * pad,
 
 static GstFlowReturn gst_base_audio_visualizer_chain (GstPad * pad,
     GstBuffer * buffer);
+static void gst_base_audio_visualizer_reset_analysis (GstBaseAudioVisualizer *
+    scope);
+static void gst_base_audio_visualizer_free_analysis (GstBaseAudioVisualizer *
+    scope);
 static GstStateChangeReturn gst_base_audio_visualizer_change_state (GstElement *
     element, GstStateChange transition);
 
@@ -111,119 +122,57 @@ gst_base_audio_visualizer_shader_get_type (void)
   return shader_type;
 }
 
-/* we're only supporting GST_VIDEO_FORMAT_xRGB right now) */
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-
-#define SHADE1(_d, _s, _i, _r, _g, _b)          \
-G_STMT_START {                                  \
-    _d[_i] = (_s[_i] > _b) ? _s[_i] - _b : 0;   \
-    _i++;                                       \
-    _d[_i] = (_s[_i] > _g) ? _s[_i] - _g : 0;   \
-    _i++;                                       \
-    _d[_i] = (_s[_i] > _r) ? _s[_i] - _r : 0;   \
-    _i++;                                       \
-    _d[_i++] = 0;                               \
-} G_STMT_END
-
-#define SHADE2(_d, _s, _j, _i, _r, _g, _b)      \
-G_STMT_START {                                  \
-    _d[_j++] = (_s[_i] > _b) ? _s[_i] - _b : 0; \
-    _i++;                                       \
-    _d[_j++] = (_s[_i] > _g) ? _s[_i] - _g : 0; \
-    _i++;                                       \
-    _d[_j++] = (_s[_i] > _r) ? _s[_i] - _r : 0; \
-    _i++;                                       \
-    _d[_j++] = 0;                               \
-    _i++;                                       \
-} G_STMT_END
-
-#else
-
-#define SHADE1(_d, _s, _i, _r, _g, _b)          \
-G_STMT_START {                                  \
-    _d[_i++] = 0;                               \
-    _d[_i] = (_s[_i] > _r) ? _s[_i] - _r : 0;   \
-    _i++;                                       \
-    _d[_i] = (_s[_i] > _g) ? _s[_i] - _g : 0;   \
-    _i++;                                       \
-    _d[_i] = (_s[_i] > _b) ? _s[_i] - _b : 0;   \
-    _i++;                                       \
-} G_STMT_END
-
-#define SHADE2(_d, _s, _j, _i, _r, _g, _b)      \
-G_STMT_START {                                  \
-    _d[_j++] = 0;                               \
-    _i++;                                       \
-    _d[_j++] = (_s[_i] > _r) ? _s[_i] - _r : 0; \
-    _i++;                                       \
-    _d[_j++] = (_s[_i] > _g) ? _s[_i] - _g : 0; \
-    _i++;                                       \
-    _d[_j++] = (_s[_i] > _b) ? _s[_i] - _b : 0; \
-    _i++;                                       \
-} G_STMT_END
-
-#endif
+/* we're only supporting GST_VIDEO_FORMAT_xRGB right now)
+ *
+ * All shaders are built from one orc kernel that fades a run of pixels while
+ * copying it from s to d. The moves are expressed as offsets between the
+ * source and destination runs. Masking the shade amount to 24 bits and the
+ * result to 24 bits in the kernel gives the right channel order on both
+ * little and big endian.
+ */
+#define SHADE(_scope, _d, _s, _n) \
+    audiovisualizers_orc_shade_xrgb (_d, _s, \
+        (_scope)->shade_amount & 0x00ffffff, _n)
 
 static void
 shader_fade (GstBaseAudioVisualizer * scope, const guint8 * s, guint8 * d)
 {
-  guint i, bpf = scope->bpf;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
-
-  for (i = 0; i < bpf;) {
-    SHADE1 (d, s, i, r, g, b);
-  }
+  SHADE (scope, d, s, scope->bpf / 4);
 }
 
 static void
 shader_fade_and_move_up (GstBaseAudioVisualizer * scope, const guint8 * s,
     guint8 * d)
 {
-  guint i, j, bpf = scope->bpf;
+  guint bpf = scope->bpf;
   guint bpl = 4 * scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
 
-  for (j = 0, i = bpl; i < bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d, s + bpl, (bpf - bpl) / 4);
 }
 
 static void
 shader_fade_and_move_down (GstBaseAudioVisualizer * scope, const guint8 * s,
     guint8 * d)
 {
-  guint i, j, bpf = scope->bpf;
+  guint bpf = scope->bpf;
   guint bpl = 4 * scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
 
-  for (j = bpl, i = 0; j < bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d + bpl, s, (bpf - bpl) / 4);
 }
 
 static void
 shader_fade_and_move_left (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, k, bpf = scope->bpf;
+  guint y, h = scope->height;
   guint w = scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
+  guint bpl = 4 * w;
 
   /* move to the left */
-  for (j = 0, i = 4; i < bpf;) {
-    for (k = 0; k < w - 1; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    i += 4;
-    j += 4;
+  for (y = 0; y < h; y++) {
+    SHADE (scope, d, s + 4, w - 1);
+    s += bpl;
+    d += bpl;
   }
 }
 
@@ -231,19 +180,15 @@ static void
 shader_fade_and_move_right (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, k, bpf = scope->bpf;
+  guint y, h = scope->height;
   guint w = scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
+  guint bpl = 4 * w;
 
-  /* move to the left */
-  for (j = 4, i = 0; i < bpf;) {
-    for (k = 0; k < w - 1; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    i += 4;
-    j += 4;
+  /* move to the right */
+  for (y = 0; y < h; y++) {
+    SHADE (scope, d + 4, s, w - 1);
+    s += bpl;
+    d += bpl;
   }
 }
 
@@ -251,67 +196,44 @@ static void
 shader_fade_and_move_horiz_out (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, bpf = scope->bpf / 2;
+  guint bpf = scope->bpf / 2;
   guint bpl = 4 * scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
 
   /* move upper half up */
-  for (j = 0, i = bpl; i < bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d, s + bpl, (bpf - bpl) / 4);
   /* move lower half down */
-  for (j = bpf + bpl, i = bpf; j < bpf + bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d + bpf + bpl, s + bpf, (bpf - bpl) / 4);
 }
 
 static void
 shader_fade_and_move_horiz_in (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, bpf = scope->bpf / 2;
+  guint bpf = scope->bpf / 2;
   guint bpl = 4 * scope->width;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
 
   /* move upper half down */
-  for (i = 0, j = bpl; i < bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d + bpl, s, bpf / 4);
   /* move lower half up */
-  for (i = bpf + bpl, j = bpf; i < bpf + bpf;) {
-    SHADE2 (d, s, j, i, r, g, b);
-  }
+  SHADE (scope, d + bpf, s + bpf + bpl, (bpf - bpl) / 4);
 }
 
 static void
 shader_fade_and_move_vert_out (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, k, bpf = scope->bpf;
-  guint m = scope->width / 2;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
-
-  /* move left half to the left */
-  for (j = 0, i = 4; i < bpf;) {
-    for (k = 0; k < m; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    j += 4 * m;
-    i += 4 * m;
-  }
-  /* move right half to the right */
-  for (j = 4 * (m + 1), i = 4 * m; j < bpf;) {
-    for (k = 0; k < m; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    j += 4 * m;
-    i += 4 * m;
+  guint y, h = scope->height;
+  guint w = scope->width;
+  guint m = w / 2;
+  guint bpl = 4 * w;
+
+  for (y = 0; y < h; y++) {
+    /* move left half to the left */
+    SHADE (scope, d, s + 4, m);
+    /* move right half to the right */
+    SHADE (scope, d + 4 * (m + 1), s + 4 * m, w - m - 1);
+    s += bpl;
+    d += bpl;
   }
 }
 
@@ -319,30 +241,23 @@ static void
 shader_fade_and_move_vert_in (GstBaseAudioVisualizer * scope,
     const guint8 * s, guint8 * d)
 {
-  guint i, j, k, bpf = scope->bpf;
-  guint m = scope->width / 2;
-  guint r = (scope->shade_amount >> 16) & 0xff;
-  guint g = (scope->shade_amount >> 8) & 0xff;
-  guint b = (scope->shade_amount >> 0) & 0xff;
-
-  /* move left half to the right */
-  for (j = 4, i = 0; j < bpf;) {
-    for (k = 0; k < m; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    j += 4 * m;
-    i += 4 * m;
-  }
-  /* move right half to the left */
-  for (j = 4 * m, i = 4 * (m + 1); i < bpf;) {
-    for (k = 0; k < m; k++) {
-      SHADE2 (d, s, j, i, r, g, b);
-    }
-    j += 4 * m;
-    i += 4 * m;
+  guint y, h = scope->height;
+  guint w = scope->width;
+  guint m = w / 2;
+  guint bpl = 4 * w;
+
+  for (y = 0; y < h; y++) {
+    /* move left half to the right */
+    SHADE (scope, d + 4, s, m);
+    /* move right half to the left */
+    SHADE (scope, d + 4 * m, s + 4 * (m + 1), w - m - 1);
+    s += bpl;
+    d += bpl;
   }
 }
 
+#undef SHADE
+
 static void
 gst_base_audio_visualizer_change_shader (GstBaseAudioVisualizer * scope)
 {
@@ -552,6 +467,7 @@ gst_base_audio_visualizer_dispose (GObject * object)
     g_mutex_free (scope->config_lock);
     scope->config_lock = NULL;
   }
+  gst_base_audio_visualizer_free_analysis (scope);
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -698,6 +614,8 @@ gst_base_audio_visualizer_src_setcaps (GstPad * pad, GstCaps * caps)
   if (klass->setup)
     res = klass->setup (scope);
 
+  gst_base_audio_visualizer_reset_analysis (scope);
+
   GST_DEBUG_OBJECT (scope, "video: dimension %dx%d, framerate %d/%d",
       scope->width, scope->height, scope->fps_n, scope->fps_d);
   GST_DEBUG_OBJECT (scope, "blocks: spf %u, req_spf %u",
@@ -800,6 +718,10 @@ gst_base_audio_visualizer_chain (GstPad * pad, GstBuffer * buffer)
     GST_BUFFER_DATA (inbuf) = adata;
     GST_BUFFER_SIZE (inbuf) = sbpf;
 
+    /* new audio data, invalidate the analysis of the previous frame */
+    scope->have_mono = scope->have_stereo = FALSE;
+    scope->have_spectrum = scope->have_stereo_spectrum = FALSE;
+
     /* call class->render() vmethod */
     if (render) {
       if (!render (scope, inbuf, outbuf)) {
@@ -844,6 +766,236 @@ gst_base_audio_visualizer_chain (GstPad * pad, GstBuffer * buffer)
   return ret;
 }
 
+/* analysis helpers */
+
+static void
+gst_base_audio_visualizer_free_analysis (GstBaseAudioVisualizer * scope)
+{
+  if (scope->fft_ctx) {
+    gst_fft_s16_free (scope->fft_ctx);
+    scope->fft_ctx = NULL;
+  }
+  g_free (scope->mono_data);
+  scope->mono_data = NULL;
+  g_free (scope->left_data);
+  scope->left_data = NULL;
+  g_free (scope->right_data);
+  scope->right_data = NULL;
+  g_free (scope->window);
+  scope->window = NULL;
+  g_free (scope->freq_data);
+  scope->freq_data = NULL;
+  g_free (scope->freq_data_l);
+  scope->freq_data_l = NULL;
+  g_free (scope->freq_data_r);
+  scope->freq_data_r = NULL;
+  scope->num_samples = 0;
+}
+
+/* called with the config_lock held after the subclass had a chance to change
+ * req_spf; the buffers themselves are only allocated by the helpers that use
+ * them, as most visualizers need only a few of them */
+static void
+gst_base_audio_visualizer_reset_analysis (GstBaseAudioVisualizer * scope)
+{
+  scope->have_mono = scope->have_stereo = FALSE;
+  scope->have_spectrum = scope->have_stereo_spectrum = FALSE;
+
+  if (scope->req_spf == scope->num_samples)
+    return;
+
+  gst_base_audio_visualizer_free_analysis (scope);
+  scope->num_samples = scope->req_spf;
+}
+
+static void
+gst_base_audio_visualizer_ensure_fft (GstBaseAudioVisualizer * scope)
+{
+  /* the real fft needs an even number of samples, we drop the last one */
+  if (G_UNLIKELY (scope->fft_ctx == NULL)) {
+    scope->fft_ctx = gst_fft_s16_new (scope->num_samples & ~1, FALSE);
+    GST_DEBUG_OBJECT (scope, "allocated fft for %u samples",
+        scope->num_samples);
+  }
+}
+
+static inline guint
+gst_base_audio_visualizer_frame_samples (GstBaseAudioVisualizer * scope,
+    GstBuffer * audio)
+{
+  guint n = GST_BUFFER_SIZE (audio) / (scope->channels * sizeof (gint16));
+
+  return MIN (n, scope->num_samples);
+}
+
+/**
+ * gst_base_audio_visualizer_get_mono_samples:
+ * @scope: the visualizer
+ * @audio: the audio buffer passed to render()
+ *
+ * Mixes down the channels of @audio and applies a hamming window in one pass.
+ * The result is stored in a buffer owned by @scope and is only computed once
+ * per frame.
+ *
+ * Returns: req_spf windowed mono samples, valid until the next frame
+ */
+const gint16 *
+gst_base_audio_visualizer_get_mono_samples (GstBaseAudioVisualizer * scope,
+    GstBuffer * audio)
+{
+  const gint16 *adata = (const gint16 *) GST_BUFFER_DATA (audio);
+  const gint16 *win = scope->window;
+  gint16 *mono = scope->mono_data;
+  guint i, c, ch = scope->channels;
+  guint num_samples;
+  gint v;
+
+  if (scope->have_mono)
+    return mono;
+
+  if (G_UNLIKELY (mono == NULL)) {
+    guint n = scope->num_samples;
+
+    mono = scope->mono_data = g_new0 (gint16, n);
+    /* same coefficients as gst_fft_s16_window (GST_FFT_WINDOW_HAMMING), but
+     * computed once instead of for every frame */
+    win = scope->window = g_new (gint16, n);
+    for (i = 0; i < n; i++)
+      scope->window[i] = (gint16) (32767.0 * (0.53836 - 0.46164 *
+              cos (2.0 * G_PI * i / n)));
+  }
+
+  num_samples = gst_base_audio_visualizer_frame_samples (scope, audio);
+
+  if (ch == 2) {
+    for (i = 0; i < num_samples; i++) {
+      v = ((gint) adata[2 * i] + (gint) adata[2 * i + 1]) >> 1;
+      mono[i] = (v * win[i]) >> 15;
+    }
+  } else if (ch == 1) {
+    for (i = 0; i < num_samples; i++)
+      mono[i] = ((gint) adata[i] * win[i]) >> 15;
+  } else {
+    for (i = 0; i < num_samples; i++) {
+      v = 0;
+      for (c = 0; c < ch; c++)
+        v += adata[i * ch + c];
+      mono[i] = ((v / (gint) ch) * win[i]) >> 15;
+    }
+  }
+  scope->have_mono = TRUE;
+
+  return mono;
+}
+
+/**
+ * gst_base_audio_visualizer_get_stereo_samples:
+ * @scope: the visualizer
+ * @audio: the audio buffer passed to render()
+ * @left: location for the left channel samples
+ * @right: location for the right channel samples
+ *
+ * Deinterleaves the first two channels of @audio into buffers owned by
+ * @scope. No window is applied. The samples are only computed once per frame
+ * and are valid until the next frame.
+ */
+void
+gst_base_audio_visualizer_get_stereo_samples (GstBaseAudioVisualizer * scope,
+    GstBuffer * audio, const gint16 ** left, const gint16 ** right)
+{
+  const gint16 *adata = (const gint16 *) GST_BUFFER_DATA (audio);
+  gint16 *l, *r;
+  guint i, ch = scope->channels;
+  guint num_samples;
+
+  if (G_UNLIKELY (scope->left_data == NULL)) {
+    scope->left_data = g_new0 (gint16, scope->num_samples);
+    scope->right_data = g_new0 (gint16, scope->num_samples);
+  }
+  l = scope->left_data;
+  r = scope->right_data;
+
+  if (!scope->have_stereo) {
+    num_samples = gst_base_audio_visualizer_frame_samples (scope, audio);
+
+    if (ch == 1) {
+      memcpy (l, adata, num_samples * sizeof (gint16));
+      memcpy (r, adata, num_samples * sizeof (gint16));
+    } else {
+      for (i = 0; i < num_samples; i++) {
+        l[i] = adata[i * ch];
+        r[i] = adata[i * ch + 1];
+      }
+    }
+    scope->have_stereo = TRUE;
+  }
+
+  *left = l;
+  *right = r;
+}
+
+/**
+ * gst_base_audio_visualizer_get_mono_spectrum:
+ * @scope: the visualizer
+ * @audio: the audio buffer passed to render()
+ *
+ * Runs the fft on the samples returned by
+ * gst_base_audio_visualizer_get_mono_samples().
+ *
+ * Returns: req_spf / 2 + 1 frequency bins, valid until the next frame
+ */
+const GstFFTS16Complex *
+gst_base_audio_visualizer_get_mono_spectrum (GstBaseAudioVisualizer * scope,
+    GstBuffer * audio)
+{
+  const gint16 *mono;
+
+  if (!scope->have_spectrum) {
+    mono = gst_base_audio_visualizer_get_mono_samples (scope, audio);
+    gst_base_audio_visualizer_ensure_fft (scope);
+    if (G_UNLIKELY (scope->freq_data == NULL))
+      scope->freq_data = g_new0 (GstFFTS16Complex, scope->num_samples / 2 + 1);
+    gst_fft_s16_fft (scope->fft_ctx, mono, scope->freq_data);
+    scope->have_spectrum = TRUE;
+  }
+  return scope->freq_data;
+}
+
+/**
+ * gst_base_audio_visualizer_get_stereo_spectrum:
+ * @scope: the visualizer
+ * @audio: the audio buffer passed to render()
+ * @left: location for the left channel spectrum
+ * @right: location for the right channel spectrum
+ *
+ * Runs the fft on the samples returned by
+ * gst_base_audio_visualizer_get_stereo_samples(). Both spectra have
+ * req_spf / 2 + 1 frequency bins and are valid until the next frame.
+ */
+void
+gst_base_audio_visualizer_get_stereo_spectrum (GstBaseAudioVisualizer * scope,
+    GstBuffer * audio, const GstFFTS16Complex ** left,
+    const GstFFTS16Complex ** right)
+{
+  const gint16 *l, *r;
+
+  if (!scope->have_stereo_spectrum) {
+    gst_base_audio_visualizer_get_stereo_samples (scope, audio, &l, &r);
+    gst_base_audio_visualizer_ensure_fft (scope);
+    if (G_UNLIKELY (scope->freq_data_l == NULL)) {
+      scope->freq_data_l =
+          g_new0 (GstFFTS16Complex, scope->num_samples / 2 + 1);
+      scope->freq_data_r =
+          g_new0 (GstFFTS16Complex, scope->num_samples / 2 + 1);
+    }
+    gst_fft_s16_fft (scope->fft_ctx, l, scope->freq_data_l);
+    gst_fft_s16_fft (scope->fft_ctx, r, scope->freq_data_r);
+    scope->have_stereo_spectrum = TRUE;
+  }
+  *left = scope->freq_data_l;
+  *right = scope->freq_data_r;
+}
+
 static GstStateChangeReturn
 gst_base_audio_visualizer_change_state (GstElement * element,
     GstStateChange transition)
@@ -27,6 +27,7 @@
 #include <gst/video/video.h>
 #include <gst/audio/audio.h>
 #include <gst/base/gstadapter.h>
+#include <gst/fft/gstffts16.h>
 
 G_BEGIN_DECLS
 #define GST_TYPE_BASE_AUDIO_VISUALIZER            (gst_base_audio_visualizer_get_type())
@@ -102,6 +103,18 @@ struct _GstBaseAudioVisualizer
   
   /* configuration mutex */
   GMutex *config_lock;
+
+  /* shared analysis data, sized for req_spf and reused across frames */
+  gint16 *mono_data;            /* mixed down and hamming windowed */
+  gint16 *left_data, *right_data;       /* deinterleaved */
+  gint16 *window;               /* hamming window in Q15 */
+  GstFFTS16 *fft_ctx;
+  GstFFTS16Complex *freq_data;
+  GstFFTS16Complex *freq_data_l, *freq_data_r;
+  guint num_samples;            /* allocated size of the sample buffers */
+  /* what has been computed for the current frame already */
+  gboolean have_mono, have_stereo;
+  gboolean have_spectrum, have_stereo_spectrum;
 };
 
 struct _GstBaseAudioVisualizerClass
@@ -117,5 +130,10 @@ struct _GstBaseAudioVisualizerClass
 
 GType gst_base_audio_visualizer_get_type (void);
 
+const gint16 *gst_base_audio_visualizer_get_mono_samples (GstBaseAudioVisualizer * scope, GstBuffer * audio);
+void gst_base_audio_visualizer_get_stereo_samples (GstBaseAudioVisualizer * scope, GstBuffer * audio, const gint16 ** left, const gint16 ** right);
+const GstFFTS16Complex *gst_base_audio_visualizer_get_mono_spectrum (GstBaseAudioVisualizer * scope, GstBuffer * audio);
+void gst_base_audio_visualizer_get_stereo_spectrum (GstBaseAudioVisualizer * scope, GstBuffer * audio, const GstFFTS16Complex ** left, const GstFFTS16Complex ** right);
+
 G_END_DECLS
 #endif /* __GST_BASE_AUDIO_VISUALIZER_H__ */
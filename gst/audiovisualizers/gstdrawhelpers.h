@@ -84,3 +84,16 @@
   }                                                                            \
 } G_STMT_END
 
+
+/* saturating add of all four channels of _c to *_p, done on the whole pixel
+ * at once instead of byte by byte */
+static inline void
+add_pixel (guint32 * _p, guint32 _c)
+{
+  guint32 _o = *_p;
+  guint32 _s = (_o & 0x7f7f7f7f) + (_c & 0x7f7f7f7f);
+  guint32 _v = ((_o & _c) | ((_o | _c) & _s)) & 0x80808080;
+
+  _s ^= (_o ^ _c) & 0x80808080;
+  *_p = _s | ((_v >> 7) * 0xff);
+}
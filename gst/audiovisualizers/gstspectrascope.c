@@ -37,6 +37,7 @@
 #include <stdlib.h>
 
 #include "gstspectrascope.h"
+#include "gstdrawhelpers.h"
 
 static GstStaticPadTemplate gst_spectra_scope_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
@@ -56,8 +57,6 @@ GST_STATIC_PAD_TEMPLATE ("sink",
 GST_DEBUG_CATEGORY_STATIC (spectra_scope_debug);
 #define GST_CAT_DEFAULT spectra_scope_debug
 
-static void gst_spectra_scope_finalize (GObject * object);
-
 static gboolean gst_spectra_scope_setup (GstBaseAudioVisualizer * scope);
 static gboolean gst_spectra_scope_render (GstBaseAudioVisualizer * scope,
     GstBuffer * audio, GstBuffer * video);
@@ -84,12 +83,9 @@ gst_spectra_scope_base_init (gpointer g_class)
 static void
 gst_spectra_scope_class_init (GstSpectraScopeClass * g_class)
 {
-  GObjectClass *gobject_class = (GObjectClass *) g_class;
   GstBaseAudioVisualizerClass *scope_class =
       (GstBaseAudioVisualizerClass *) g_class;
 
-  gobject_class->finalize = gst_spectra_scope_finalize;
-
   scope_class->setup = GST_DEBUG_FUNCPTR (gst_spectra_scope_setup);
   scope_class->render = GST_DEBUG_FUNCPTR (gst_spectra_scope_render);
 }
@@ -100,98 +96,31 @@ gst_spectra_scope_init (GstSpectraScope * scope, GstSpectraScopeClass * g_class)
   /* do nothing */
 }
 
-static void
-gst_spectra_scope_finalize (GObject * object)
-{
-  GstSpectraScope *scope = GST_SPECTRA_SCOPE (object);
-
-  if (scope->fft_ctx) {
-    gst_fft_s16_free (scope->fft_ctx);
-    scope->fft_ctx = NULL;
-  }
-  if (scope->freq_data) {
-    g_free (scope->freq_data);
-    scope->freq_data = NULL;
-  }
-
-  G_OBJECT_CLASS (parent_class)->finalize (object);
-}
-
 static gboolean
 gst_spectra_scope_setup (GstBaseAudioVisualizer * bscope)
 {
-  GstSpectraScope *scope = GST_SPECTRA_SCOPE (bscope);
   guint num_freq = bscope->width + 1;
 
-  if (scope->fft_ctx)
-    gst_fft_s16_free (scope->fft_ctx);
-  g_free (scope->freq_data);
-
-  /* we'd need this amount of samples per render() call */
+  /* we'd need this amount of samples per render() call, the base class
+   * sizes the fft for it */
   bscope->req_spf = num_freq * 2 - 2;
-  scope->fft_ctx = gst_fft_s16_new (bscope->req_spf, FALSE);
-  scope->freq_data = g_new (GstFFTS16Complex, num_freq);
 
   return TRUE;
 }
 
-static inline void
-add_pixel (guint32 * _p, guint32 _c)
-{
-  guint8 *p = (guint8 *) _p;
-  guint8 *c = (guint8 *) & _c;
-
-  if (p[0] < 255 - c[0])
-    p[0] += c[0];
-  else
-    p[0] = 255;
-  if (p[1] < 255 - c[1])
-    p[1] += c[1];
-  else
-    p[1] = 255;
-  if (p[2] < 255 - c[2])
-    p[2] += c[2];
-  else
-    p[2] = 255;
-  if (p[3] < 255 - c[3])
-    p[3] += c[3];
-  else
-    p[3] = 255;
-}
-
 static gboolean
 gst_spectra_scope_render (GstBaseAudioVisualizer * bscope, GstBuffer * audio,
     GstBuffer * video)
 {
-  GstSpectraScope *scope = GST_SPECTRA_SCOPE (bscope);
   guint32 *vdata = (guint32 *) GST_BUFFER_DATA (video);
-  gint16 *adata = (gint16 *) g_memdup (GST_BUFFER_DATA (audio),
-      GST_BUFFER_SIZE (audio));
-  GstFFTS16Complex *fdata = scope->freq_data;
+  const GstFFTS16Complex *fdata;
   guint x, y, off;
   guint l, h = bscope->height - 1;
   gfloat fr, fi;
   guint w = bscope->width;
 
-  if (bscope->channels > 1) {
-    guint ch = bscope->channels;
-    guint num_samples = GST_BUFFER_SIZE (audio) / (ch * sizeof (gint16));
-    guint i, c, v, s = 0;
-
-    /* deinterleave and mixdown adata */
-    for (i = 0; i < num_samples; i++) {
-      v = 0;
-      for (c = 0; c < ch; c++) {
-        v += adata[s++];
-      }
-      adata[i] = v / ch;
-    }
-  }
-
-  /* run fft */
-  gst_fft_s16_window (scope->fft_ctx, adata, GST_FFT_WINDOW_HAMMING);
-  gst_fft_s16_fft (scope->fft_ctx, adata, fdata);
-  g_free (adata);
+  /* mixdown, window and fft are done by the base class into reused buffers */
+  fdata = gst_base_audio_visualizer_get_mono_spectrum (bscope, audio);
 
   /* draw lines */
   for (x = 0; x < bscope->width; x++) {
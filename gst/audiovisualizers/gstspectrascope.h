@@ -23,7 +23,6 @@
 #define __GST_SPECTRA_SCOPE_H__
 
 #include "gstbaseaudiovisualizer.h"
-#include <gst/fft/gstffts16.h>
 
 G_BEGIN_DECLS
 #define GST_TYPE_SPECTRA_SCOPE            (gst_spectra_scope_get_type())
@@ -37,9 +36,6 @@ typedef struct _GstSpectraScopeClass GstSpectraScopeClass;
 struct _GstSpectraScope
 {
   GstBaseAudioVisualizer parent;
-
-  GstFFTS16 *fft_ctx;
-  GstFFTS16Complex *freq_data;
 };
 
 struct _GstSpectraScopeClass
@@ -36,6 +36,7 @@
 #endif
 
 #include "gstsynaescope.h"
+#include "gstdrawhelpers.h"
 
 static GstStaticPadTemplate gst_synae_scope_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
@@ -55,8 +56,6 @@ GST_STATIC_PAD_TEMPLATE ("sink",
 GST_DEBUG_CATEGORY_STATIC (synae_scope_debug);
 #define GST_CAT_DEFAULT synae_scope_debug
 
-static void gst_synae_scope_finalize (GObject * object);
-
 static gboolean gst_synae_scope_setup (GstBaseAudioVisualizer * scope);
 static gboolean gst_synae_scope_render (GstBaseAudioVisualizer * scope,
     GstBuffer * audio, GstBuffer * video);
@@ -84,12 +83,9 @@ gst_synae_scope_base_init (gpointer g_class)
 static void
 gst_synae_scope_class_init (GstSynaeScopeClass * g_class)
 {
-  GObjectClass *gobject_class = (GObjectClass *) g_class;
   GstBaseAudioVisualizerClass *scope_class =
       (GstBaseAudioVisualizerClass *) g_class;
 
-  gobject_class->finalize = gst_synae_scope_finalize;
-
   scope_class->setup = GST_DEBUG_FUNCPTR (gst_synae_scope_setup);
   scope_class->render = GST_DEBUG_FUNCPTR (gst_synae_scope_render);
 }
@@ -118,97 +114,27 @@ gst_synae_scope_init (GstSynaeScope * scope, GstSynaeScopeClass * g_class)
     shade[i] = i * 200 >> 8;
 }
 
-static void
-gst_synae_scope_finalize (GObject * object)
-{
-  GstSynaeScope *scope = GST_SYNAE_SCOPE (object);
-
-  if (scope->fft_ctx) {
-    gst_fft_s16_free (scope->fft_ctx);
-    scope->fft_ctx = NULL;
-  }
-  if (scope->freq_data_l) {
-    g_free (scope->freq_data_l);
-    scope->freq_data_l = NULL;
-  }
-  if (scope->freq_data_r) {
-    g_free (scope->freq_data_r);
-    scope->freq_data_r = NULL;
-  }
-  if (scope->adata_l) {
-    g_free (scope->adata_l);
-    scope->adata_l = NULL;
-  }
-  if (scope->adata_r) {
-    g_free (scope->adata_r);
-    scope->adata_r = NULL;
-  }
-
-  G_OBJECT_CLASS (parent_class)->finalize (object);
-}
-
 static gboolean
 gst_synae_scope_setup (GstBaseAudioVisualizer * bscope)
 {
-  GstSynaeScope *scope = GST_SYNAE_SCOPE (bscope);
   guint num_freq = bscope->height + 1;
 
-  if (scope->fft_ctx)
-    gst_fft_s16_free (scope->fft_ctx);
-  g_free (scope->freq_data_l);
-  g_free (scope->freq_data_r);
-  g_free (scope->adata_l);
-  g_free (scope->adata_r);
-
   /* FIXME: we could have horizontal or vertical layout */
 
-  /* we'd need this amount of samples per render() call */
+  /* we'd need this amount of samples per render() call, the base class
+   * sizes the fft for it */
   bscope->req_spf = num_freq * 2 - 2;
-  scope->fft_ctx = gst_fft_s16_new (bscope->req_spf, FALSE);
-  scope->freq_data_l = g_new (GstFFTS16Complex, num_freq);
-  scope->freq_data_r = g_new (GstFFTS16Complex, num_freq);
-
-  scope->adata_l = g_new (gint16, bscope->req_spf);
-  scope->adata_r = g_new (gint16, bscope->req_spf);
 
   return TRUE;
 }
 
-static inline void
-add_pixel (guint32 * _p, guint32 _c)
-{
-  guint8 *p = (guint8 *) _p;
-  guint8 *c = (guint8 *) & _c;
-
-  if (p[0] < 255 - c[0])
-    p[0] += c[0];
-  else
-    p[0] = 255;
-  if (p[1] < 255 - c[1])
-    p[1] += c[1];
-  else
-    p[1] = 255;
-  if (p[2] < 255 - c[2])
-    p[2] += c[2];
-  else
-    p[2] = 255;
-  if (p[3] < 255 - c[3])
-    p[3] += c[3];
-  else
-    p[3] = 255;
-}
-
 static gboolean
 gst_synae_scope_render (GstBaseAudioVisualizer * bscope, GstBuffer * audio,
     GstBuffer * video)
 {
   GstSynaeScope *scope = GST_SYNAE_SCOPE (bscope);
   guint32 *vdata = (guint32 *) GST_BUFFER_DATA (video);
-  gint16 *adata = (gint16 *) GST_BUFFER_DATA (audio);
-  gint16 *adata_l = scope->adata_l;
-  gint16 *adata_r = scope->adata_r;
-  GstFFTS16Complex *fdata_l = scope->freq_data_l;
-  GstFFTS16Complex *fdata_r = scope->freq_data_r;
+  const GstFFTS16Complex *fdata_l, *fdata_r;
   gint x, y;
   guint off;
   guint w = bscope->width;
@@ -216,26 +142,16 @@ gst_synae_scope_render (GstBaseAudioVisualizer * bscope, GstBuffer * audio,
   guint32 *colors = scope->colors, c;
   guint *shade = scope->shade;
   //guint w2 = w /2;
-  guint ch = bscope->channels;
-  guint num_samples = GST_BUFFER_SIZE (audio) / (ch * sizeof (gint16));
-  gint i, j, b;
+  gint i, b;
   gint br, br1, br2;
   gint clarity;
   gdouble fc, r, l, rr, ll;
   gdouble frl, fil, frr, fir;
   const guint sl = 30;
 
-  /* deinterleave */
-  for (i = 0, j = 0; i < num_samples; i++) {
-    adata_l[i] = adata[j++];
-    adata_r[i] = adata[j++];
-  }
-
-  /* run fft */
-  /*gst_fft_s16_window (scope->fft_ctx, adata_l, GST_FFT_WINDOW_HAMMING); */
-  gst_fft_s16_fft (scope->fft_ctx, adata_l, fdata_l);
-  /*gst_fft_s16_window (scope->fft_ctx, adata_r, GST_FFT_WINDOW_HAMMING); */
-  gst_fft_s16_fft (scope->fft_ctx, adata_r, fdata_r);
+  /* deinterleave and run fft, the base class reuses its buffers for this */
+  gst_base_audio_visualizer_get_stereo_spectrum (bscope, audio, &fdata_l,
+      &fdata_r);
 
   /* draw stars */
   for (y = 0; y < h; y++) {
@@ -23,7 +23,6 @@
 #define __GST_SYNAE_SCOPE_H__
 
 #include "gstbaseaudiovisualizer.h"
-#include <gst/fft/gstffts16.h>
 
 G_BEGIN_DECLS
 #define GST_TYPE_SYNAE_SCOPE            (gst_synae_scope_get_type())
@@ -38,10 +37,6 @@ struct _GstSynaeScope
 {
   GstBaseAudioVisualizer parent;
 
-  GstFFTS16 *fft_ctx;
-  GstFFTS16Complex *freq_data_l, *freq_data_r;
-  gint16 *adata_l, *adata_r;
-
   guint32 colors[256];
   guint shade[256];
 };
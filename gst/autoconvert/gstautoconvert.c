@@ -31,6 +31,12 @@
  * The list of element it will look into can be specified in the
  * #GstAutoConvert::factories property, otherwise it will look at all available
  * elements.
+ *
+ * The element picked for a given pair of input and downstream caps is
+ * remembered process-wide, so other autoconvert instances negotiating the
+ * same caps try that element first instead of probing every candidate. The
+ * #GstAutoConvert:cache-hits and #GstAutoConvert:cache-misses properties
+ * report how often that worked.
  */
 
 
@@ -81,9 +87,28 @@ enum
 enum
 {
   PROP_0,
-  PROP_FACTORIES
+  PROP_FACTORIES,
+  PROP_CACHE_HITS,
+  PROP_CACHE_MISSES
 };
 
+/* Process-wide cache mapping the sink caps and the downstream caps (as
+ * strings) to the name of the factory that was selected for them */
+#define CACHE_MAX_ENTRIES 256
+
+static GStaticMutex cache_lock = G_STATIC_MUTEX_INIT;
+static GHashTable *cache = NULL;
+static guint cache_hits = 0;
+static guint cache_misses = 0;
+
+/* The caps of the single static pad template of a factory in each
+ * direction, parsed once per factory and kept as qdata on it. NULL if the
+ * factory has no template or more than one in that direction. */
+typedef struct
+{
+  GstCaps *caps[2];             /* indexed by GstPadDirection - 1 */
+} GstAutoConvertFactoryCaps;
+
 static void gst_auto_convert_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_auto_convert_get_property (GObject * object,
@@ -148,6 +173,7 @@ static gboolean gst_auto_convert_activate_element (GstAutoConvert * autoconvert,
 static GQuark internal_srcpad_quark = 0;
 static GQuark internal_sinkpad_quark = 0;
 static GQuark parent_quark = 0;
+static GQuark factory_caps_quark = 0;
 
 static void
 gst_auto_convert_do_init (GType type)
@@ -158,6 +184,8 @@ gst_auto_convert_do_init (GType type)
   internal_srcpad_quark = g_quark_from_static_string ("internal_srcpad");
   internal_sinkpad_quark = g_quark_from_static_string ("internal_sinkpad");
   parent_quark = g_quark_from_static_string ("parent");
+  factory_caps_quark =
+      g_quark_from_static_string ("autoconvert-factory-caps");
 }
 
 GST_BOILERPLATE_FULL (GstAutoConvert, gst_auto_convert, GstBin,
@@ -196,6 +224,30 @@ gst_auto_convert_class_init (GstAutoConvertClass * klass)
           " elements), can only be set once",
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAutoConvert:cache-hits
+   *
+   * Number of times, in the whole process, that the element remembered for
+   * the negotiated caps could be used directly.
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_HITS,
+      g_param_spec_uint ("cache-hits", "Cache hits",
+          "Number of negotiations (in all autoconvert instances) that reused "
+          "a previously selected element", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAutoConvert:cache-misses
+   *
+   * Number of times, in the whole process, that all candidate elements had
+   * to be tried for the negotiated caps.
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_MISSES,
+      g_param_spec_uint ("cache-misses", "Cache misses",
+          "Number of negotiations (in all autoconvert instances) that had to "
+          "probe the candidate elements", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_auto_convert_change_state);
 }
@@ -308,6 +360,16 @@ gst_auto_convert_get_property (GObject * object,
       g_value_set_pointer (value, &autoconvert->factories);
       GST_AUTOCONVERT_UNLOCK (autoconvert);
       break;
+    case PROP_CACHE_HITS:
+      g_static_mutex_lock (&cache_lock);
+      g_value_set_uint (value, cache_hits);
+      g_static_mutex_unlock (&cache_lock);
+      break;
+    case PROP_CACHE_MISSES:
+      g_static_mutex_lock (&cache_lock);
+      g_value_set_uint (value, cache_misses);
+      g_static_mutex_unlock (&cache_lock);
+      break;
   }
 }
 
@@ -652,6 +714,74 @@ gst_auto_convert_get_or_make_element_from_factory (GstAutoConvert * autoconvert,
   return element;
 }
 
+static void
+gst_auto_convert_factory_caps_free (GstAutoConvertFactoryCaps * fcaps)
+{
+  if (fcaps->caps[0])
+    gst_caps_unref (fcaps->caps[0]);
+  if (fcaps->caps[1])
+    gst_caps_unref (fcaps->caps[1]);
+  g_slice_free (GstAutoConvertFactoryCaps, fcaps);
+}
+
+/*
+ * Returns the parsed caps of the static pad templates of the factory,
+ * computing them the first time
+ */
+
+static GstAutoConvertFactoryCaps *
+gst_auto_convert_get_factory_caps (GstAutoConvert * autoconvert,
+    GstElementFactory * factory)
+{
+  GstAutoConvertFactoryCaps *fcaps;
+  gboolean has_direction[2] = { FALSE, FALSE };
+  GList *templates;
+
+  g_static_mutex_lock (&cache_lock);
+  fcaps = g_object_get_qdata (G_OBJECT (factory), factory_caps_quark);
+  if (fcaps) {
+    g_static_mutex_unlock (&cache_lock);
+    return fcaps;
+  }
+
+  fcaps = g_slice_new0 (GstAutoConvertFactoryCaps);
+
+  for (templates = factory->staticpadtemplates; templates;
+      templates = g_list_next (templates)) {
+    GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
+    gint i;
+
+    if (template->direction != GST_PAD_SRC &&
+        template->direction != GST_PAD_SINK)
+      continue;
+    i = template->direction - 1;
+
+    /* If there is more than one pad in this direction, the factory can
+     * never match. Only transform elements (with one sink and one source
+     * pad) are accepted
+     */
+    if (has_direction[i]) {
+      GST_DEBUG_OBJECT (autoconvert, "Factory %" GST_PTR_FORMAT
+          " has more than one static template with dir %d",
+          factory, template->direction);
+      if (fcaps->caps[i]) {
+        gst_caps_unref (fcaps->caps[i]);
+        fcaps->caps[i] = NULL;
+      }
+      continue;
+    }
+    has_direction[i] = TRUE;
+
+    fcaps->caps[i] = gst_static_caps_get (&template->static_caps);
+  }
+
+  g_object_set_qdata_full (G_OBJECT (factory), factory_caps_quark, fcaps,
+      (GDestroyNotify) gst_auto_convert_factory_caps_free);
+  g_static_mutex_unlock (&cache_lock);
+
+  return fcaps;
+}
+
 /*
  * This function checks if there is one and only one pad template on the
  * factory that can accept the given caps. If there is one and only one,
@@ -662,48 +792,85 @@ static gboolean
 factory_can_intersect (GstAutoConvert * autoconvert,
     GstElementFactory * factory, GstPadDirection direction, GstCaps * caps)
 {
-  GList *templates;
-  gint has_direction = FALSE;
-  gboolean ret = FALSE;
+  GstAutoConvertFactoryCaps *fcaps;
+  GstCaps *tmpl_caps;
+  gboolean intersect;
 
   g_return_val_if_fail (factory != NULL, FALSE);
   g_return_val_if_fail (caps != NULL, FALSE);
+  g_return_val_if_fail (direction == GST_PAD_SRC ||
+      direction == GST_PAD_SINK, FALSE);
 
-  templates = factory->staticpadtemplates;
+  fcaps = gst_auto_convert_get_factory_caps (autoconvert, factory);
+  tmpl_caps = fcaps->caps[direction - 1];
+  if (tmpl_caps == NULL)
+    return FALSE;
 
-  while (templates) {
-    GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
+  intersect = gst_caps_can_intersect (tmpl_caps, caps);
+  GST_DEBUG_OBJECT (autoconvert, "Factories %" GST_PTR_FORMAT
+      " static caps %" GST_PTR_FORMAT " and caps %" GST_PTR_FORMAT
+      " can%s intersect", factory, tmpl_caps, caps, intersect ? "" : " not");
 
-    if (template->direction == direction) {
-      GstCaps *tmpl_caps = NULL;
-      gboolean intersect;
+  return intersect;
+}
 
-      /* If there is more than one pad in this direction, we return FALSE
-       * Only transform elements (with one sink and one source pad)
-       * are accepted
-       */
-      if (has_direction) {
-        GST_DEBUG_OBJECT (autoconvert, "Factory %" GST_PTR_FORMAT
-            " has more than one static template with dir %d",
-            template, direction);
-        return FALSE;
-      }
-      has_direction = TRUE;
+static gchar *
+gst_auto_convert_cache_key (GstCaps * caps, GstCaps * other_caps)
+{
+  gchar *caps_str, *other_caps_str, *key;
 
-      tmpl_caps = gst_static_caps_get (&template->static_caps);
-      intersect = gst_caps_can_intersect (tmpl_caps, caps);
-      GST_DEBUG_OBJECT (autoconvert, "Factories %" GST_PTR_FORMAT
-          " static caps %" GST_PTR_FORMAT " and caps %" GST_PTR_FORMAT
-          " can%s intersect", factory, tmpl_caps, caps,
-          intersect ? "" : " not");
-      gst_caps_unref (tmpl_caps);
+  caps_str = gst_caps_to_string (caps);
+  other_caps_str = other_caps ? gst_caps_to_string (other_caps) : NULL;
+  key = g_strconcat (caps_str, "|", other_caps_str, NULL);
+  g_free (caps_str);
+  g_free (other_caps_str);
+
+  return key;
+}
+
+/*
+ * Returns the factory remembered for the key if it is one of the
+ * candidate factories
+ */
+
+static GstElementFactory *
+gst_auto_convert_cache_lookup (const gchar * key, GList * factories)
+{
+  GstElementFactory *factory = NULL;
+  const gchar *name = NULL;
+  GList *elem;
 
-      ret |= intersect;
+  g_static_mutex_lock (&cache_lock);
+  if (cache)
+    name = g_hash_table_lookup (cache, key);
+  for (elem = factories; name && elem; elem = g_list_next (elem)) {
+    if (!strcmp (gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (elem->data)),
+            name)) {
+      factory = GST_ELEMENT_FACTORY (elem->data);
+      break;
     }
-    templates = g_list_next (templates);
   }
+  g_static_mutex_unlock (&cache_lock);
 
-  return ret;
+  return factory;
+}
+
+static void
+gst_auto_convert_cache_store (const gchar * key, GstElementFactory * factory)
+{
+  const gchar *name;
+
+  name = gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory));
+
+  g_static_mutex_lock (&cache_lock);
+  if (cache == NULL)
+    cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  /* caps with varying sizes or rates can make the set of keys grow without
+   * bounds, start over when it gets large */
+  if (g_hash_table_size (cache) >= CACHE_MAX_ENTRIES)
+    g_hash_table_remove_all (cache);
+  g_hash_table_replace (cache, g_strdup (key), g_strdup (name));
+  g_static_mutex_unlock (&cache_lock);
 }
 
 static gboolean
@@ -795,6 +962,8 @@ gst_auto_convert_sink_setcaps (GstPad * pad, GstCaps * caps)
   GstCaps *other_caps = NULL;
   GstPad *peer;
   GList *factories;
+  GstElementFactory *cached_factory;
+  gchar *key;
 
   g_return_val_if_fail (autoconvert != NULL, FALSE);
 
@@ -839,10 +1008,40 @@ gst_auto_convert_sink_setcaps (GstPad * pad, GstCaps * caps)
   if (!factories)
     factories = gst_auto_convert_load_factories (autoconvert);
 
+  /* Try the element that was selected for these caps before */
+  key = gst_auto_convert_cache_key (caps, other_caps);
+  cached_factory = gst_auto_convert_cache_lookup (key, factories);
+  if (cached_factory) {
+    GstElement *element;
+
+    element = gst_auto_convert_get_or_make_element_from_factory (autoconvert,
+        cached_factory);
+    if (element) {
+      if (gst_auto_convert_activate_element (autoconvert, element, caps)) {
+        GST_DEBUG_OBJECT (autoconvert, "Reused cached factory %s",
+            gst_plugin_feature_get_name (GST_PLUGIN_FEATURE
+                (cached_factory)));
+        g_static_mutex_lock (&cache_lock);
+        cache_hits++;
+        g_static_mutex_unlock (&cache_lock);
+        g_free (key);
+        goto get_out;
+      }
+      gst_object_unref (element);
+    }
+  }
+
+  g_static_mutex_lock (&cache_lock);
+  cache_misses++;
+  g_static_mutex_unlock (&cache_lock);
+
   for (elem = factories; elem; elem = g_list_next (elem)) {
     GstElementFactory *factory = GST_ELEMENT_FACTORY (elem->data);
     GstElement *element;
 
+    if (factory == cached_factory)
+      continue;
+
     /* Lets first check if according to the static pad templates on the factory
      * these caps have any chance of success
      */
@@ -871,11 +1070,14 @@ gst_auto_convert_sink_setcaps (GstPad * pad, GstCaps * caps)
       continue;
 
     /* And make it the current child */
-    if (gst_auto_convert_activate_element (autoconvert, element, caps))
+    if (gst_auto_convert_activate_element (autoconvert, element, caps)) {
+      gst_auto_convert_cache_store (key, factory);
       break;
-    else
+    } else {
       gst_object_unref (element);
+    }
   }
+  g_free (key);
 
 get_out:
   if (other_caps)
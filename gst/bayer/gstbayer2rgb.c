@@ -25,6 +25,23 @@
  * SECTION:element-bayer2rgb
  *
  * Decodes raw camera bayer (fourcc BA81) to RGB.
+ *
+ * The default bilinear interpolation is the fastest. The "malvar" method
+ * adds the gradient corrected linear interpolation of Malvar, He and
+ * Cutler, which uses a 5x5 neighbourhood and noticeably reduces the colour
+ * fringes along edges for a moderate extra cost.
+ *
+ * Bands of lines of a frame can be processed on several threads with the
+ * #GstBayer2RGB:n-threads property. Bayer input with more than 8 bits per
+ * sample (bpp=16 in the host endianness, the significant bits in the lower
+ * part given by depth) is accepted and converted to 8 bit RGB.
+ *
+ * <refsect2>
+ * <title>Example launch line</title>
+ * |[
+ * gst-launch -v v4l2src ! video/x-raw-bayer ! bayer2rgb method=malvar n-threads=4 ! ffmpegcolorspace ! xvimagesink
+ * ]|
+ * </refsect2>
  */
 
 /*
@@ -94,6 +111,18 @@ enum
   GST_BAYER_2_RGB_FORMAT_RGGB
 };
 
+typedef enum
+{
+  GST_BAYER_2_RGB_METHOD_BILINEAR = 0,
+  GST_BAYER_2_RGB_METHOD_MALVAR
+} GstBayer2RGBMethod;
+
+#define MAX_THREADS 64
+
+/* samples of padding on both sides of the lines fed to the malvar kernels,
+ * which read two samples beyond each end of a pair */
+#define LINE_PAD 4
+
 
 #define GST_TYPE_BAYER2RGB            (gst_bayer2rgb_get_type())
 #define GST_BAYER2RGB(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_BAYER2RGB,GstBayer2RGB))
@@ -106,6 +135,14 @@ typedef struct _GstBayer2RGBClass GstBayer2RGBClass;
 
 typedef void (*GstBayer2RGBProcessFunc) (GstBayer2RGB *, guint8 *, guint);
 
+typedef void (*process_func) (guint8 * d0, const guint8 * s0, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    int n);
+
+typedef void (*malvar_func) (guint8 * b, guint8 * g, guint8 * r,
+    const guint8 * s0, const guint8 * s1, const guint8 * s2, const guint8 * s3,
+    const guint8 * s4, int n);
+
 struct _GstBayer2RGB
 {
   GstBaseTransform basetransform;
@@ -119,6 +156,26 @@ struct _GstBayer2RGB
   int g_off;                    /* offset for green */
   int b_off;                    /* offset for blue */
   int format;
+  int bpp;                      /* bits per input sample, 8 or 16 */
+  int depth;                    /* significant bits per input sample */
+
+  /* line functions for even and odd lines, chosen in set_caps */
+  process_func merge[2];
+  malvar_func malvar[2];
+  /* plane (0 = blue, 1 = green, 2 = red, 3 = alpha) stored at each byte of
+   * an output pixel by the malvar method */
+  int plane[4];
+
+  GstBayer2RGBMethod method;
+  guint n_threads;
+
+  GThreadPool *pool;
+  GMutex *pool_lock;
+  GCond *pool_cond;
+
+  /* line scratch of each band, kept across frames */
+  guint8 *lines[MAX_THREADS];
+  gsize lines_size;
 };
 
 struct _GstBayer2RGBClass
@@ -136,14 +193,46 @@ struct _GstBayer2RGBClass
   GST_VIDEO_CAPS_BGRA ";"                        \
   GST_VIDEO_CAPS_ABGR
 
-#define SINK_CAPS "video/x-raw-bayer,format=(string){bggr,grbg,gbrg,rggb}," \
+#define BAYER_CAPS_8 "video/x-raw-bayer,format=(string){bggr,grbg,gbrg,rggb}"
+#define BAYER_CAPS_16 BAYER_CAPS_8 ",bpp=(int)16,depth=(int)[8,16]," \
+  "endianness=(int)BYTE_ORDER"
+
+#define SINK_CAPS BAYER_CAPS_8 "," \
+  "width=(int)[1,MAX],height=(int)[1,MAX],framerate=(fraction)[0/1,MAX];" \
+  BAYER_CAPS_16 "," \
   "width=(int)[1,MAX],height=(int)[1,MAX],framerate=(fraction)[0/1,MAX]"
 
+#define DEFAULT_METHOD GST_BAYER_2_RGB_METHOD_BILINEAR
+#define DEFAULT_N_THREADS 1
+
 enum
 {
-  PROP_0
+  PROP_0,
+  PROP_METHOD,
+  PROP_N_THREADS
 };
 
+#define GST_TYPE_BAYER2RGB_METHOD (gst_bayer2rgb_method_get_type ())
+static GType
+gst_bayer2rgb_method_get_type (void)
+{
+  static GType gtype = 0;
+
+  if (gtype == 0) {
+    static const GEnumValue values[] = {
+      {GST_BAYER_2_RGB_METHOD_BILINEAR, "Bilinear interpolation (default)",
+          "bilinear"},
+      {GST_BAYER_2_RGB_METHOD_MALVAR,
+          "Gradient corrected linear interpolation (Malvar-He-Cutler)",
+          "malvar"},
+      {0, NULL, NULL}
+    };
+
+    gtype = g_enum_register_static ("GstBayer2RGBMethod", values);
+  }
+  return gtype;
+}
+
 #define DEBUG_INIT(bla) \
   GST_DEBUG_CATEGORY_INIT (gst_bayer2rgb_debug, "bayer2rgb", 0, "bayer2rgb element");
 
@@ -155,12 +244,15 @@ static void gst_bayer2rgb_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_bayer2rgb_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
+static void gst_bayer2rgb_finalize (GObject * object);
 
 static gboolean gst_bayer2rgb_set_caps (GstBaseTransform * filter,
     GstCaps * incaps, GstCaps * outcaps);
+static gboolean gst_bayer2rgb_stop (GstBaseTransform * base);
 static GstFlowReturn gst_bayer2rgb_transform (GstBaseTransform * base,
     GstBuffer * inbuf, GstBuffer * outbuf);
 static void gst_bayer2rgb_reset (GstBayer2RGB * filter);
+static void gst_bayer2rgb_free_lines (GstBayer2RGB * filter);
 static GstCaps *gst_bayer2rgb_transform_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps);
 static gboolean gst_bayer2rgb_get_unit_size (GstBaseTransform * base,
@@ -198,6 +290,33 @@ gst_bayer2rgb_class_init (GstBayer2RGBClass * klass)
   gobject_class = (GObjectClass *) klass;
   gobject_class->set_property = gst_bayer2rgb_set_property;
   gobject_class->get_property = gst_bayer2rgb_get_property;
+  gobject_class->finalize = gst_bayer2rgb_finalize;
+
+  /**
+   * GstBayer2RGB:method
+   *
+   * Interpolation used to reconstruct the missing colour samples.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_METHOD,
+      g_param_spec_enum ("method", "Method",
+          "Interpolation of the missing colour samples",
+          GST_TYPE_BAYER2RGB_METHOD, DEFAULT_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBayer2RGB:n-threads
+   *
+   * Number of threads converting bands of lines of a frame in parallel.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads used to convert bands of lines of a frame in parallel (1 == no threads)",
+          1, MAX_THREADS, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   GST_BASE_TRANSFORM_CLASS (klass)->transform_caps =
       GST_DEBUG_FUNCPTR (gst_bayer2rgb_transform_caps);
@@ -205,6 +324,8 @@ gst_bayer2rgb_class_init (GstBayer2RGBClass * klass)
       GST_DEBUG_FUNCPTR (gst_bayer2rgb_get_unit_size);
   GST_BASE_TRANSFORM_CLASS (klass)->set_caps =
       GST_DEBUG_FUNCPTR (gst_bayer2rgb_set_caps);
+  GST_BASE_TRANSFORM_CLASS (klass)->stop =
+      GST_DEBUG_FUNCPTR (gst_bayer2rgb_stop);
   GST_BASE_TRANSFORM_CLASS (klass)->transform =
       GST_DEBUG_FUNCPTR (gst_bayer2rgb_transform);
 }
@@ -212,17 +333,51 @@ gst_bayer2rgb_class_init (GstBayer2RGBClass * klass)
 static void
 gst_bayer2rgb_init (GstBayer2RGB * filter, GstBayer2RGBClass * klass)
 {
+  filter->method = DEFAULT_METHOD;
+  filter->n_threads = DEFAULT_N_THREADS;
+  filter->pool_lock = g_mutex_new ();
+  filter->pool_cond = g_cond_new ();
+
   gst_bayer2rgb_reset (filter);
   gst_base_transform_set_in_place (GST_BASE_TRANSFORM (filter), TRUE);
 }
 
-/* No properties are implemented, so only a warning is produced */
+static void
+gst_bayer2rgb_finalize (GObject * object)
+{
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
+
+  gst_bayer2rgb_free_lines (filter);
+
+  if (filter->pool)
+    g_thread_pool_free (filter->pool, FALSE, TRUE);
+  g_cond_free (filter->pool_cond);
+  g_mutex_free (filter->pool_lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_bayer2rgb_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
 
   switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (filter);
+      filter->method = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (filter);
+      filter->n_threads = g_value_get_uint (value);
+      /* the streaming thread converts one of the bands itself */
+      if (filter->pool && filter->n_threads > 1)
+        g_thread_pool_set_max_threads (filter->pool, filter->n_threads - 1,
+            NULL);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -233,8 +388,15 @@ static void
 gst_bayer2rgb_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
 {
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
 
   switch (prop_id) {
+    case PROP_METHOD:
+      g_value_set_enum (value, filter->method);
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, filter->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -262,6 +424,62 @@ get_pix_offset (int mask, int bpp)
   }
 }
 
+/* We exploit some symmetry in the functions here.  The base functions
+ * are all named for the BGGR arrangement.  For RGGB, we swap the
+ * red offset and blue offset in the output.  For GRBG, we swap the
+ * order of the merge functions.  For GBRG, do both. */
+static void
+gst_bayer2rgb_setup_merge (GstBayer2RGB * bayer2rgb)
+{
+  int r_off, g_off, b_off;
+
+  r_off = bayer2rgb->r_off;
+  g_off = bayer2rgb->g_off;
+  b_off = bayer2rgb->b_off;
+  if (bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_RGGB ||
+      bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GBRG) {
+    r_off = bayer2rgb->b_off;
+    b_off = bayer2rgb->r_off;
+  }
+
+  bayer2rgb->merge[0] = NULL;
+  bayer2rgb->merge[1] = NULL;
+  if (r_off == 2 && g_off == 1 && b_off == 0) {
+    bayer2rgb->merge[0] = gst_bayer_merge_bg_bgra;
+    bayer2rgb->merge[1] = gst_bayer_merge_gr_bgra;
+  } else if (r_off == 3 && g_off == 2 && b_off == 1) {
+    bayer2rgb->merge[0] = gst_bayer_merge_bg_abgr;
+    bayer2rgb->merge[1] = gst_bayer_merge_gr_abgr;
+  } else if (r_off == 1 && g_off == 2 && b_off == 3) {
+    bayer2rgb->merge[0] = gst_bayer_merge_bg_argb;
+    bayer2rgb->merge[1] = gst_bayer_merge_gr_argb;
+  } else if (r_off == 0 && g_off == 1 && b_off == 2) {
+    bayer2rgb->merge[0] = gst_bayer_merge_bg_rgba;
+    bayer2rgb->merge[1] = gst_bayer_merge_gr_rgba;
+  }
+
+  /* the malvar kernels produce planes that are interleaved afterwards, the
+   * byte left over by the three colours is alpha */
+  bayer2rgb->malvar[0] = gst_bayer_malvar_bg;
+  bayer2rgb->malvar[1] = gst_bayer_malvar_gr;
+  bayer2rgb->plane[0] = bayer2rgb->plane[1] = bayer2rgb->plane[2] =
+      bayer2rgb->plane[3] = 3;
+  bayer2rgb->plane[b_off & 3] = 0;
+  bayer2rgb->plane[g_off & 3] = 1;
+  bayer2rgb->plane[r_off & 3] = 2;
+
+  if (bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GRBG ||
+      bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GBRG) {
+    process_func tmp = bayer2rgb->merge[0];
+    malvar_func mtmp = bayer2rgb->malvar[0];
+
+    bayer2rgb->merge[0] = bayer2rgb->merge[1];
+    bayer2rgb->merge[1] = tmp;
+    bayer2rgb->malvar[0] = bayer2rgb->malvar[1];
+    bayer2rgb->malvar[1] = mtmp;
+  }
+}
+
 static gboolean
 gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
     GstCaps * outcaps)
@@ -280,6 +498,14 @@ gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
   gst_structure_get_int (structure, "height", &bayer2rgb->height);
   bayer2rgb->stride = GST_ROUND_UP_4 (bayer2rgb->width);
 
+  /* bpp and depth are only given for more than 8 bits per sample */
+  if (!gst_structure_get_int (structure, "bpp", &bayer2rgb->bpp) ||
+      bayer2rgb->bpp != 16)
+    bayer2rgb->bpp = 8;
+  if (!gst_structure_get_int (structure, "depth", &bayer2rgb->depth) ||
+      bayer2rgb->bpp == 8)
+    bayer2rgb->depth = 8;
+
   format = gst_structure_get_string (structure, "format");
   if (g_str_equal (format, "bggr")) {
     bayer2rgb->format = GST_BAYER_2_RGB_FORMAT_BGGR;
@@ -304,6 +530,26 @@ gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
   gst_structure_get_int (structure, "blue_mask", &val);
   bayer2rgb->b_off = get_pix_offset (val, bpp);
 
+  gst_bayer2rgb_setup_merge (bayer2rgb);
+
+  /* the line scratch depends on the width */
+  GST_OBJECT_LOCK (bayer2rgb);
+  gst_bayer2rgb_free_lines (bayer2rgb);
+  GST_OBJECT_UNLOCK (bayer2rgb);
+
+  return TRUE;
+}
+
+static gboolean
+gst_bayer2rgb_stop (GstBaseTransform * base)
+{
+  GstBayer2RGB *bayer2rgb = GST_BAYER2RGB (base);
+
+  GST_OBJECT_LOCK (bayer2rgb);
+  gst_bayer2rgb_free_lines (bayer2rgb);
+  gst_bayer2rgb_reset (bayer2rgb);
+  GST_OBJECT_UNLOCK (bayer2rgb);
+
   return TRUE;
 }
 
@@ -317,6 +563,8 @@ gst_bayer2rgb_reset (GstBayer2RGB * filter)
   filter->r_off = 0;
   filter->g_off = 0;
   filter->b_off = 0;
+  filter->bpp = 8;
+  filter->depth = 8;
 }
 
 static GstCaps *
@@ -326,25 +574,28 @@ gst_bayer2rgb_transform_caps (GstBaseTransform * base,
   GstStructure *structure;
   GstCaps *newcaps;
   GstStructure *newstruct;
+  guint i;
 
   GST_DEBUG_OBJECT (caps, "transforming caps (from)");
 
   structure = gst_caps_get_structure (caps, 0);
 
   if (direction == GST_PAD_SRC) {
-    newcaps = gst_caps_from_string ("video/x-raw-bayer,"
-        "format=(string){bggr,grbg,gbrg,rggb}");
+    newcaps = gst_caps_from_string (BAYER_CAPS_8 ";" BAYER_CAPS_16);
   } else {
     newcaps = gst_caps_new_simple ("video/x-raw-rgb", NULL);
   }
-  newstruct = gst_caps_get_structure (newcaps, 0);
 
-  gst_structure_set_value (newstruct, "width",
-      gst_structure_get_value (structure, "width"));
-  gst_structure_set_value (newstruct, "height",
-      gst_structure_get_value (structure, "height"));
-  gst_structure_set_value (newstruct, "framerate",
-      gst_structure_get_value (structure, "framerate"));
+  for (i = 0; i < gst_caps_get_size (newcaps); i++) {
+    newstruct = gst_caps_get_structure (newcaps, i);
+
+    gst_structure_set_value (newstruct, "width",
+        gst_structure_get_value (structure, "width"));
+    gst_structure_set_value (newstruct, "height",
+        gst_structure_get_value (structure, "height"));
+    gst_structure_set_value (newstruct, "framerate",
+        gst_structure_get_value (structure, "framerate"));
+  }
 
   GST_DEBUG_OBJECT (newcaps, "transforming caps (into)");
 
@@ -368,7 +619,10 @@ gst_bayer2rgb_get_unit_size (GstBaseTransform * base, GstCaps * caps,
     name = gst_structure_get_name (structure);
     /* Our name must be either video/x-raw-bayer video/x-raw-rgb */
     if (strcmp (name, "video/x-raw-rgb")) {
-      *size = GST_ROUND_UP_4 (width) * height;
+      if (gst_structure_get_int (structure, "bpp", &pixsize) && pixsize == 16)
+        *size = width * 2 * height;
+      else
+        *size = GST_ROUND_UP_4 (width) * height;
       return TRUE;
     } else {
       /* For output, calculate according to format */
@@ -413,74 +667,268 @@ gst_bayer2rgb_split_and_upsample_horiz (guint8 * dest0, guint8 * dest1,
   }
 }
 
-typedef void (*process_func) (guint8 * d0, const guint8 * s0, const guint8 * s1,
-    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
-    int n);
+/* reflects an index outside of [0, n) back into it without changing its
+ * parity, so that mirrored lines and samples keep their bayer colour */
+static inline int
+gst_bayer2rgb_mirror (int i, int n)
+{
+  if (i < 0)
+    i = -i;
+  if (i >= n)
+    i = 2 * (n - 1) - i;
+  return CLAMP (i, 0, n - 1);
+}
 
+/* the line scratch of a band holds, in this order, the 8 lines of the
+ * horizontally upsampled ring of the bilinear method, the 8 padded input
+ * lines of the malvar method (the first one doubles as the 8 bit copy of a
+ * deep input line for the bilinear method) and the 4 planes the malvar
+ * kernels write to */
 static void
-gst_bayer2rgb_process (GstBayer2RGB * bayer2rgb, uint8_t * dest,
-    int dest_stride, uint8_t * src, int src_stride)
+gst_bayer2rgb_get_line_sizes (GstBayer2RGB * bayer2rgb, int *padded_stride,
+    int *plane_stride)
 {
-  int j;
-  guint8 *tmp;
-  process_func merge[2] = { NULL, NULL };
-  int r_off, g_off, b_off;
+  *plane_stride = GST_ROUND_UP_4 (bayer2rgb->width);
+  *padded_stride = GST_ROUND_UP_4 (bayer2rgb->width + 2 * LINE_PAD);
+}
 
-  /* We exploit some symmetry in the functions here.  The base functions
-   * are all named for the BGGR arrangement.  For RGGB, we swap the
-   * red offset and blue offset in the output.  For GRBG, we swap the
-   * order of the merge functions.  For GBRG, do both. */
-  r_off = bayer2rgb->r_off;
-  g_off = bayer2rgb->g_off;
-  b_off = bayer2rgb->b_off;
-  if (bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_RGGB ||
-      bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GBRG) {
-    r_off = bayer2rgb->b_off;
-    b_off = bayer2rgb->r_off;
+static void
+gst_bayer2rgb_free_lines (GstBayer2RGB * filter)
+{
+  int i;
+
+  for (i = 0; i < MAX_THREADS; i++) {
+    g_free (filter->lines[i]);
+    filter->lines[i] = NULL;
   }
+  filter->lines_size = 0;
+}
 
-  if (r_off == 2 && g_off == 1 && b_off == 0) {
-    merge[0] = gst_bayer_merge_bg_bgra;
-    merge[1] = gst_bayer_merge_gr_bgra;
-  } else if (r_off == 3 && g_off == 2 && b_off == 1) {
-    merge[0] = gst_bayer_merge_bg_abgr;
-    merge[1] = gst_bayer_merge_gr_abgr;
-  } else if (r_off == 1 && g_off == 2 && b_off == 3) {
-    merge[0] = gst_bayer_merge_bg_argb;
-    merge[1] = gst_bayer_merge_gr_argb;
-  } else if (r_off == 0 && g_off == 1 && b_off == 2) {
-    merge[0] = gst_bayer_merge_bg_rgba;
-    merge[1] = gst_bayer_merge_gr_rgba;
+static guint8 *
+gst_bayer2rgb_get_lines (GstBayer2RGB * bayer2rgb, guint band)
+{
+  int padded_stride, plane_stride;
+  gsize size;
+
+  gst_bayer2rgb_get_line_sizes (bayer2rgb, &padded_stride, &plane_stride);
+  size = 8 * bayer2rgb->width + 8 * padded_stride + 4 * plane_stride;
+
+  if (size != bayer2rgb->lines_size) {
+    gst_bayer2rgb_free_lines (bayer2rgb);
+    bayer2rgb->lines_size = size;
   }
-  if (bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GRBG ||
-      bayer2rgb->format == GST_BAYER_2_RGB_FORMAT_GBRG) {
-    process_func tmp = merge[0];
-    merge[0] = merge[1];
-    merge[1] = tmp;
+
+  if (!bayer2rgb->lines[band]) {
+    bayer2rgb->lines[band] = g_malloc (size);
+    /* the alpha plane */
+    memset (bayer2rgb->lines[band] + size - plane_stride, 0xff, plane_stride);
   }
 
-  tmp = g_malloc (2 * 4 * bayer2rgb->width);
-#define LINE(x) (tmp + ((x)&7) * bayer2rgb->width)
+  return bayer2rgb->lines[band];
+}
+
+/* returns input line j as 8 bit samples, converted into tmp if needed */
+static const guint8 *
+gst_bayer2rgb_get_line (GstBayer2RGB * bayer2rgb, const guint8 * src,
+    int src_stride, int j, guint8 * tmp)
+{
+  src += gst_bayer2rgb_mirror (j, bayer2rgb->height) * src_stride;
+
+  if (bayer2rgb->bpp == 8)
+    return src;
+
+  gst_bayer_downshift_16 (tmp, (const guint16 *) src, bayer2rgb->depth - 8,
+      bayer2rgb->width);
+  return tmp;
+}
+
+/* copies input line j to dest and mirrors it into the padding on both
+ * sides */
+static void
+gst_bayer2rgb_load_padded_line (GstBayer2RGB * bayer2rgb, guint8 * dest,
+    const guint8 * src, int src_stride, int j)
+{
+  int width = bayer2rgb->width;
+  int i;
+
+  src += gst_bayer2rgb_mirror (j, bayer2rgb->height) * src_stride;
+
+  if (bayer2rgb->bpp == 8)
+    memcpy (dest, src, width);
+  else
+    gst_bayer_downshift_16 (dest, (const guint16 *) src, bayer2rgb->depth - 8,
+        width);
+
+  for (i = 1; i <= LINE_PAD; i++) {
+    dest[-i] = dest[gst_bayer2rgb_mirror (-i, width)];
+    dest[width - 1 + i] = dest[gst_bayer2rgb_mirror (width - 1 + i, width)];
+  }
+}
+
+static void
+gst_bayer2rgb_process_bilinear (GstBayer2RGB * bayer2rgb, uint8_t * dest,
+    int dest_stride, const uint8_t * src, int src_stride, int first,
+    int last, guint8 * lines)
+{
+  guint8 *tmp = lines + 8 * bayer2rgb->width + LINE_PAD;
+  int j;
+
+#define LINE(x) (lines + ((x)&7) * bayer2rgb->width)
 
-  gst_bayer2rgb_split_and_upsample_horiz (LINE (3 * 2 + 0), LINE (3 * 2 + 1),
-      src + 1 * src_stride, bayer2rgb->width);
-  j = 0;
+  /* the line above the first one is mirrored at the top of the frame, and
+   * so is the one below the last line at the bottom */
+  j = first - 1;
   gst_bayer2rgb_split_and_upsample_horiz (LINE (j * 2 + 0), LINE (j * 2 + 1),
-      src + j * src_stride, bayer2rgb->width);
+      gst_bayer2rgb_get_line (bayer2rgb, src, src_stride, j, tmp),
+      bayer2rgb->width);
+  j = first;
+  gst_bayer2rgb_split_and_upsample_horiz (LINE (j * 2 + 0), LINE (j * 2 + 1),
+      gst_bayer2rgb_get_line (bayer2rgb, src, src_stride, j, tmp),
+      bayer2rgb->width);
 
-  for (j = 0; j < bayer2rgb->height; j++) {
-    if (j < bayer2rgb->height - 1) {
-      gst_bayer2rgb_split_and_upsample_horiz (LINE ((j + 1) * 2 + 0),
-          LINE ((j + 1) * 2 + 1), src + (j + 1) * src_stride, bayer2rgb->width);
-    }
+  for (j = first; j < last; j++) {
+    gst_bayer2rgb_split_and_upsample_horiz (LINE ((j + 1) * 2 + 0),
+        LINE ((j + 1) * 2 + 1),
+        gst_bayer2rgb_get_line (bayer2rgb, src, src_stride, j + 1, tmp),
+        bayer2rgb->width);
 
-    merge[j & 1] (dest + j * dest_stride,
+    bayer2rgb->merge[j & 1] (dest + j * dest_stride,
         LINE (j * 2 - 2), LINE (j * 2 - 1),
         LINE (j * 2 + 0), LINE (j * 2 + 1),
         LINE (j * 2 + 2), LINE (j * 2 + 3), bayer2rgb->width >> 1);
   }
 
-  g_free (tmp);
+#undef LINE
+}
+
+static void
+gst_bayer2rgb_process_malvar (GstBayer2RGB * bayer2rgb, uint8_t * dest,
+    int dest_stride, const uint8_t * src, int src_stride, int first,
+    int last, guint8 * lines)
+{
+  int padded_stride, plane_stride;
+  guint8 *padded, *planes[4];
+  int i, j;
+
+  gst_bayer2rgb_get_line_sizes (bayer2rgb, &padded_stride, &plane_stride);
+  padded = lines + 8 * bayer2rgb->width + LINE_PAD;
+  for (i = 0; i < 4; i++)
+    planes[i] = padded - LINE_PAD + 8 * padded_stride + i * plane_stride;
+
+#define LINE(x) (padded + ((x)&7) * padded_stride)
+
+  for (j = first - 2; j < first + 2; j++)
+    gst_bayer2rgb_load_padded_line (bayer2rgb, LINE (j), src, src_stride, j);
+
+  for (j = first; j < last; j++) {
+    gst_bayer2rgb_load_padded_line (bayer2rgb, LINE (j + 2), src, src_stride,
+        j + 2);
+
+    bayer2rgb->malvar[j & 1] (planes[0], planes[1], planes[2],
+        LINE (j - 2), LINE (j - 1), LINE (j), LINE (j + 1), LINE (j + 2),
+        (bayer2rgb->width + 1) >> 1);
+
+    gst_bayer_interleave_4 (dest + j * dest_stride,
+        planes[bayer2rgb->plane[0]], planes[bayer2rgb->plane[1]],
+        planes[bayer2rgb->plane[2]], planes[bayer2rgb->plane[3]],
+        bayer2rgb->width);
+  }
+
+#undef LINE
+}
+
+/* frames are converted in bands of consecutive lines, each band on a thread
+ * of its own if n-threads > 1 */
+typedef struct
+{
+  GstBayer2RGB *bayer2rgb;
+  uint8_t *dest;
+  int dest_stride;
+  const uint8_t *src;
+  int src_stride;
+  gint first, last;
+  guint8 *lines;
+  gint *pending;
+} GstBayer2RGBBand;
+
+static void
+gst_bayer2rgb_process_band (GstBayer2RGBBand * band)
+{
+  GstBayer2RGB *bayer2rgb = band->bayer2rgb;
+
+  if (bayer2rgb->method == GST_BAYER_2_RGB_METHOD_MALVAR)
+    gst_bayer2rgb_process_malvar (bayer2rgb, band->dest, band->dest_stride,
+        band->src, band->src_stride, band->first, band->last, band->lines);
+  else
+    gst_bayer2rgb_process_bilinear (bayer2rgb, band->dest, band->dest_stride,
+        band->src, band->src_stride, band->first, band->last, band->lines);
+}
+
+static void
+gst_bayer2rgb_band_func (GstBayer2RGBBand * band, gpointer user_data)
+{
+  GstBayer2RGB *bayer2rgb = band->bayer2rgb;
+
+  gst_bayer2rgb_process_band (band);
+
+  g_mutex_lock (bayer2rgb->pool_lock);
+  *band->pending -= 1;
+  if (*band->pending == 0)
+    g_cond_signal (bayer2rgb->pool_cond);
+  g_mutex_unlock (bayer2rgb->pool_lock);
+}
+
+static void
+gst_bayer2rgb_process (GstBayer2RGB * bayer2rgb, uint8_t * dest,
+    int dest_stride, uint8_t * src, int src_stride)
+{
+  GstBayer2RGBBand bands[MAX_THREADS];
+  guint i, n_bands;
+  gint pending;
+
+  n_bands = MAX (MIN ((gint) bayer2rgb->n_threads, bayer2rgb->height), 1);
+
+  if (n_bands > 1 && !bayer2rgb->pool) {
+    GError *err = NULL;
+
+    /* the streaming thread converts one of the bands itself */
+    bayer2rgb->pool =
+        g_thread_pool_new ((GFunc) gst_bayer2rgb_band_func, NULL,
+        bayer2rgb->n_threads - 1, FALSE, &err);
+    if (!bayer2rgb->pool) {
+      GST_WARNING_OBJECT (bayer2rgb, "Could not create threads: %s",
+          err ? err->message : "unknown error");
+      g_clear_error (&err);
+    }
+  }
+
+  if (!bayer2rgb->pool)
+    n_bands = 1;
+
+  pending = n_bands - 1;
+  for (i = 0; i < n_bands; i++) {
+    bands[i].bayer2rgb = bayer2rgb;
+    bands[i].dest = dest;
+    bands[i].dest_stride = dest_stride;
+    bands[i].src = src;
+    bands[i].src_stride = src_stride;
+    bands[i].first = (gint64) bayer2rgb->height * i / n_bands;
+    bands[i].last = (gint64) bayer2rgb->height * (i + 1) / n_bands;
+    bands[i].lines = gst_bayer2rgb_get_lines (bayer2rgb, i);
+    bands[i].pending = &pending;
+  }
+
+  for (i = 1; i < n_bands; i++)
+    g_thread_pool_push (bayer2rgb->pool, &bands[i], NULL);
+
+  gst_bayer2rgb_process_band (&bands[0]);
+
+  if (n_bands > 1) {
+    g_mutex_lock (bayer2rgb->pool_lock);
+    while (pending > 0)
+      g_cond_wait (bayer2rgb->pool_cond, bayer2rgb->pool_lock);
+    g_mutex_unlock (bayer2rgb->pool_lock);
+  }
 }
 
 
@@ -504,7 +952,7 @@ gst_bayer2rgb_transform (GstBaseTransform * base, GstBuffer * inbuf,
   input = (uint8_t *) GST_BUFFER_DATA (inbuf);
   output = (uint8_t *) GST_BUFFER_DATA (outbuf);
   gst_bayer2rgb_process (filter, output, filter->width * 4,
-      input, filter->width);
+      input, filter->width * (filter->bpp / 8));
 
   GST_OBJECT_UNLOCK (filter);
   return GST_FLOW_OK;
@@ -118,6 +118,19 @@ void gst_bayer_merge_gr_argb (guint8 * ORC_RESTRICT d1,
     const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2,
     const guint8 * ORC_RESTRICT s3, const guint8 * ORC_RESTRICT s4,
     const guint8 * ORC_RESTRICT s5, const guint8 * ORC_RESTRICT s6, int n);
+void gst_bayer_malvar_bg (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n);
+void gst_bayer_malvar_gr (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n);
+void gst_bayer_interleave_4 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2,
+    const guint8 * ORC_RESTRICT s3, const guint8 * ORC_RESTRICT s4, int n);
+void gst_bayer_downshift_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, int p1, int n);
 
 
 /* begin Orc C target preamble */
@@ -3210,3 +3223,2590 @@ gst_bayer_merge_gr_argb (guint8 * ORC_RESTRICT d1,
   func (ex);
 }
 #endif
+
+
+/* gst_bayer_malvar_bg */
+#ifdef DISABLE_ORC
+void
+gst_bayer_malvar_bg (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union32 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union32 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union32 var62;
+  orc_union32 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union16 var67;
+  orc_union32 var68;
+  orc_union16 var69;
+  orc_union32 var70;
+  orc_union32 var71;
+  orc_union16 var72;
+  orc_union32 var73;
+  orc_union16 var74;
+  orc_union32 var75;
+  orc_union32 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union32 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union32 var82;
+  orc_union32 var83;
+  orc_union32 var84;
+  orc_union32 var85;
+  orc_union32 var86;
+  orc_union32 var87;
+  orc_union32 var88;
+  orc_union32 var89;
+  orc_union32 var90;
+  orc_union32 var91;
+  orc_union32 var92;
+  orc_union32 var93;
+  orc_union32 var94;
+  orc_union32 var95;
+  orc_union32 var96;
+  orc_union16 var97;
+  orc_union16 var98;
+  orc_union32 var99;
+  orc_union32 var100;
+  orc_union32 var101;
+  orc_union32 var102;
+  orc_union32 var103;
+  orc_union32 var104;
+  orc_union32 var105;
+  orc_union32 var106;
+  orc_union32 var107;
+  orc_union32 var108;
+  orc_union32 var109;
+  orc_union32 var110;
+  orc_union32 var111;
+  orc_union32 var112;
+  orc_union32 var113;
+  orc_union16 var114;
+  orc_union16 var115;
+  orc_union32 var116;
+  orc_union32 var117;
+  orc_union32 var118;
+  orc_union32 var119;
+  orc_union32 var120;
+  orc_union32 var121;
+  orc_union32 var122;
+  orc_union32 var123;
+  orc_union16 var124;
+  orc_union16 var125;
+  orc_union32 var126;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union16 *) d2;
+  ptr2 = (orc_union16 *) d3;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+
+  /* 41: loadpw */
+  var41.x2[0] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  var41.x2[1] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  /* 43: loadpw */
+  var42.x2[0] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  var42.x2[1] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  /* 46: loadpw */
+  var43.x2[0] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  var43.x2[1] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  /* 48: loadpw */
+  var44.x2[0] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  var44.x2[1] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  /* 54: loadpw */
+  var45.x2[0] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  var45.x2[1] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  /* 69: loadpw */
+  var46.x2[0] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  var46.x2[1] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  /* 72: loadpw */
+  var47.x2[0] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+  var47.x2[1] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr6[i];
+    /* 1: convubw */
+    var51.x2[0] = (orc_uint8) var36.x2[0];
+    var51.x2[1] = (orc_uint8) var36.x2[1];
+    /* 2: loadoffw */
+    var52 = ptr6[i + -1];
+    /* 3: convubw */
+    var53.x2[0] = (orc_uint8) var52.x2[0];
+    var53.x2[1] = (orc_uint8) var52.x2[1];
+    /* 4: loadoffw */
+    var54 = ptr6[i + 1];
+    /* 5: convubw */
+    var55.x2[0] = (orc_uint8) var54.x2[0];
+    var55.x2[1] = (orc_uint8) var54.x2[1];
+    /* 6: addw */
+    var56.x2[0] = var53.x2[0] + var55.x2[0];
+    var56.x2[1] = var53.x2[1] + var55.x2[1];
+    /* 7: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var53.i;
+      var57.i = _src.x2[1];
+    }
+    /* 8: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var58.i = _src.x2[0];
+    }
+    /* 9: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var57.i;
+      _dest.x2[1] = var58.i;
+      var59.i = _dest.i;
+    }
+    /* 10: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var60.i = _src.x2[1];
+    }
+    /* 11: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var55.i;
+      var61.i = _src.x2[0];
+    }
+    /* 12: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var60.i;
+      _dest.x2[1] = var61.i;
+      var62.i = _dest.i;
+    }
+    /* 13: addw */
+    var63.x2[0] = var59.x2[0] + var62.x2[0];
+    var63.x2[1] = var59.x2[1] + var62.x2[1];
+    /* 14: loadw */
+    var37 = ptr5[i];
+    /* 15: convubw */
+    var64.x2[0] = (orc_uint8) var37.x2[0];
+    var64.x2[1] = (orc_uint8) var37.x2[1];
+    /* 16: loadw */
+    var38 = ptr7[i];
+    /* 17: convubw */
+    var65.x2[0] = (orc_uint8) var38.x2[0];
+    var65.x2[1] = (orc_uint8) var38.x2[1];
+    /* 18: addw */
+    var66.x2[0] = var64.x2[0] + var65.x2[0];
+    var66.x2[1] = var64.x2[1] + var65.x2[1];
+    /* 19: loadoffw */
+    var67 = ptr5[i + -1];
+    /* 20: convubw */
+    var68.x2[0] = (orc_uint8) var67.x2[0];
+    var68.x2[1] = (orc_uint8) var67.x2[1];
+    /* 21: loadoffw */
+    var69 = ptr7[i + -1];
+    /* 22: convubw */
+    var70.x2[0] = (orc_uint8) var69.x2[0];
+    var70.x2[1] = (orc_uint8) var69.x2[1];
+    /* 23: addw */
+    var71.x2[0] = var68.x2[0] + var70.x2[0];
+    var71.x2[1] = var68.x2[1] + var70.x2[1];
+    /* 24: loadoffw */
+    var72 = ptr5[i + 1];
+    /* 25: convubw */
+    var73.x2[0] = (orc_uint8) var72.x2[0];
+    var73.x2[1] = (orc_uint8) var72.x2[1];
+    /* 26: loadoffw */
+    var74 = ptr7[i + 1];
+    /* 27: convubw */
+    var75.x2[0] = (orc_uint8) var74.x2[0];
+    var75.x2[1] = (orc_uint8) var74.x2[1];
+    /* 28: addw */
+    var76.x2[0] = var73.x2[0] + var75.x2[0];
+    var76.x2[1] = var73.x2[1] + var75.x2[1];
+    /* 29: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var71.i;
+      var77.i = _src.x2[1];
+    }
+    /* 30: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var78.i = _src.x2[0];
+    }
+    /* 31: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var77.i;
+      _dest.x2[1] = var78.i;
+      var79.i = _dest.i;
+    }
+    /* 32: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var80.i = _src.x2[1];
+    }
+    /* 33: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var76.i;
+      var81.i = _src.x2[0];
+    }
+    /* 34: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var80.i;
+      _dest.x2[1] = var81.i;
+      var82.i = _dest.i;
+    }
+    /* 35: addw */
+    var83.x2[0] = var79.x2[0] + var82.x2[0];
+    var83.x2[1] = var79.x2[1] + var82.x2[1];
+    /* 36: loadw */
+    var39 = ptr4[i];
+    /* 37: convubw */
+    var84.x2[0] = (orc_uint8) var39.x2[0];
+    var84.x2[1] = (orc_uint8) var39.x2[1];
+    /* 38: loadw */
+    var40 = ptr8[i];
+    /* 39: convubw */
+    var85.x2[0] = (orc_uint8) var40.x2[0];
+    var85.x2[1] = (orc_uint8) var40.x2[1];
+    /* 40: addw */
+    var86.x2[0] = var84.x2[0] + var85.x2[0];
+    var86.x2[1] = var84.x2[1] + var85.x2[1];
+    /* 42: mullw */
+    var87.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var87.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 44: shlw */
+    var88.x2[0] = var83.x2[0] << var42.x2[0];
+    var88.x2[1] = var83.x2[1] << var42.x2[1];
+    /* 45: subw */
+    var89.x2[0] = var87.x2[0] - var88.x2[0];
+    var89.x2[1] = var87.x2[1] - var88.x2[1];
+    /* 47: addw */
+    var90.x2[0] = var89.x2[0] + var43.x2[0];
+    var90.x2[1] = var89.x2[1] + var43.x2[1];
+    /* 49: shlw */
+    var91.x2[0] = var63.x2[0] << var44.x2[0];
+    var91.x2[1] = var63.x2[1] << var44.x2[1];
+    /* 50: addw */
+    var92.x2[0] = var91.x2[0] + var90.x2[0];
+    var92.x2[1] = var91.x2[1] + var90.x2[1];
+    /* 51: shlw */
+    var93.x2[0] = var56.x2[0] << var42.x2[0];
+    var93.x2[1] = var56.x2[1] << var42.x2[1];
+    /* 52: subw */
+    var94.x2[0] = var92.x2[0] - var93.x2[0];
+    var94.x2[1] = var92.x2[1] - var93.x2[1];
+    /* 53: addw */
+    var95.x2[0] = var94.x2[0] + var86.x2[0];
+    var95.x2[1] = var94.x2[1] + var86.x2[1];
+    /* 55: shrsw */
+    var96.x2[0] = var95.x2[0] >> var45.x2[0];
+    var96.x2[1] = var95.x2[1] >> var45.x2[1];
+    /* 56: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var97.i = _src.x2[0];
+    }
+    /* 57: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var96.i;
+      var98.i = _src.x2[1];
+    }
+    /* 58: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var97.i;
+      _dest.x2[1] = var98.i;
+      var99.i = _dest.i;
+    }
+    /* 59: convsuswb */
+    var48.x2[0] = ORC_CLAMP_UB (var99.x2[0]);
+    var48.x2[1] = ORC_CLAMP_UB (var99.x2[1]);
+    /* 60: storew */
+    ptr0[i] = var48;
+    /* 61: shlw */
+    var100.x2[0] = var66.x2[0] << var44.x2[0];
+    var100.x2[1] = var66.x2[1] << var44.x2[1];
+    /* 62: addw */
+    var101.x2[0] = var100.x2[0] + var90.x2[0];
+    var101.x2[1] = var100.x2[1] + var90.x2[1];
+    /* 63: shlw */
+    var102.x2[0] = var86.x2[0] << var42.x2[0];
+    var102.x2[1] = var86.x2[1] << var42.x2[1];
+    /* 64: subw */
+    var103.x2[0] = var101.x2[0] - var102.x2[0];
+    var103.x2[1] = var101.x2[1] - var102.x2[1];
+    /* 65: addw */
+    var104.x2[0] = var103.x2[0] + var56.x2[0];
+    var104.x2[1] = var103.x2[1] + var56.x2[1];
+    /* 66: shrsw */
+    var105.x2[0] = var104.x2[0] >> var45.x2[0];
+    var105.x2[1] = var104.x2[1] >> var45.x2[1];
+    /* 67: addw */
+    var106.x2[0] = var86.x2[0] + var56.x2[0];
+    var106.x2[1] = var86.x2[1] + var56.x2[1];
+    /* 68: mullw */
+    var107.x2[0] = (var106.x2[0] * var44.x2[0]) & 0xffff;
+    var107.x2[1] = (var106.x2[1] * var44.x2[1]) & 0xffff;
+    /* 70: shlw */
+    var108.x2[0] = var83.x2[0] << var46.x2[0];
+    var108.x2[1] = var83.x2[1] << var46.x2[1];
+    /* 71: subw */
+    var109.x2[0] = var108.x2[0] - var107.x2[0];
+    var109.x2[1] = var108.x2[1] - var107.x2[1];
+    /* 73: mullw */
+    var110.x2[0] = (var51.x2[0] * var47.x2[0]) & 0xffff;
+    var110.x2[1] = (var51.x2[1] * var47.x2[1]) & 0xffff;
+    /* 74: addw */
+    var111.x2[0] = var109.x2[0] + var110.x2[0];
+    var111.x2[1] = var109.x2[1] + var110.x2[1];
+    /* 75: addw */
+    var112.x2[0] = var111.x2[0] + var43.x2[0];
+    var112.x2[1] = var111.x2[1] + var43.x2[1];
+    /* 76: shrsw */
+    var113.x2[0] = var112.x2[0] >> var45.x2[0];
+    var113.x2[1] = var112.x2[1] >> var45.x2[1];
+    /* 77: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var113.i;
+      var114.i = _src.x2[0];
+    }
+    /* 78: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var105.i;
+      var115.i = _src.x2[1];
+    }
+    /* 79: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var114.i;
+      _dest.x2[1] = var115.i;
+      var116.i = _dest.i;
+    }
+    /* 80: convsuswb */
+    var50.x2[0] = ORC_CLAMP_UB (var116.x2[0]);
+    var50.x2[1] = ORC_CLAMP_UB (var116.x2[1]);
+    /* 81: storew */
+    ptr2[i] = var50;
+    /* 82: addw */
+    var117.x2[0] = var66.x2[0] + var63.x2[0];
+    var117.x2[1] = var66.x2[1] + var63.x2[1];
+    /* 83: shlw */
+    var118.x2[0] = var117.x2[0] << var42.x2[0];
+    var118.x2[1] = var117.x2[1] << var42.x2[1];
+    /* 84: subw */
+    var119.x2[0] = var118.x2[0] - var106.x2[0];
+    var119.x2[1] = var118.x2[1] - var106.x2[1];
+    /* 85: shlw */
+    var120.x2[0] = var51.x2[0] << var46.x2[0];
+    var120.x2[1] = var51.x2[1] << var46.x2[1];
+    /* 86: addw */
+    var121.x2[0] = var119.x2[0] + var120.x2[0];
+    var121.x2[1] = var119.x2[1] + var120.x2[1];
+    /* 87: addw */
+    var122.x2[0] = var121.x2[0] + var45.x2[0];
+    var122.x2[1] = var121.x2[1] + var45.x2[1];
+    /* 88: shrsw */
+    var123.x2[0] = var122.x2[0] >> var44.x2[0];
+    var123.x2[1] = var122.x2[1] >> var44.x2[1];
+    /* 89: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var123.i;
+      var124.i = _src.x2[0];
+    }
+    /* 90: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var125.i = _src.x2[1];
+    }
+    /* 91: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var124.i;
+      _dest.x2[1] = var125.i;
+      var126.i = _dest.i;
+    }
+    /* 92: convsuswb */
+    var49.x2[0] = ORC_CLAMP_UB (var126.x2[0]);
+    var49.x2[1] = ORC_CLAMP_UB (var126.x2[1]);
+    /* 93: storew */
+    ptr1[i] = var49;
+  }
+
+}
+
+#else
+static void
+_backup_gst_bayer_malvar_bg (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union32 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union32 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union32 var62;
+  orc_union32 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union16 var67;
+  orc_union32 var68;
+  orc_union16 var69;
+  orc_union32 var70;
+  orc_union32 var71;
+  orc_union16 var72;
+  orc_union32 var73;
+  orc_union16 var74;
+  orc_union32 var75;
+  orc_union32 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union32 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union32 var82;
+  orc_union32 var83;
+  orc_union32 var84;
+  orc_union32 var85;
+  orc_union32 var86;
+  orc_union32 var87;
+  orc_union32 var88;
+  orc_union32 var89;
+  orc_union32 var90;
+  orc_union32 var91;
+  orc_union32 var92;
+  orc_union32 var93;
+  orc_union32 var94;
+  orc_union32 var95;
+  orc_union32 var96;
+  orc_union16 var97;
+  orc_union16 var98;
+  orc_union32 var99;
+  orc_union32 var100;
+  orc_union32 var101;
+  orc_union32 var102;
+  orc_union32 var103;
+  orc_union32 var104;
+  orc_union32 var105;
+  orc_union32 var106;
+  orc_union32 var107;
+  orc_union32 var108;
+  orc_union32 var109;
+  orc_union32 var110;
+  orc_union32 var111;
+  orc_union32 var112;
+  orc_union32 var113;
+  orc_union16 var114;
+  orc_union16 var115;
+  orc_union32 var116;
+  orc_union32 var117;
+  orc_union32 var118;
+  orc_union32 var119;
+  orc_union32 var120;
+  orc_union32 var121;
+  orc_union32 var122;
+  orc_union32 var123;
+  orc_union16 var124;
+  orc_union16 var125;
+  orc_union32 var126;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union16 *) ex->arrays[1];
+  ptr2 = (orc_union16 *) ex->arrays[2];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+
+  /* 41: loadpw */
+  var41.x2[0] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  var41.x2[1] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  /* 43: loadpw */
+  var42.x2[0] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  var42.x2[1] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  /* 46: loadpw */
+  var43.x2[0] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  var43.x2[1] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  /* 48: loadpw */
+  var44.x2[0] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  var44.x2[1] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  /* 54: loadpw */
+  var45.x2[0] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  var45.x2[1] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  /* 69: loadpw */
+  var46.x2[0] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  var46.x2[1] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  /* 72: loadpw */
+  var47.x2[0] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+  var47.x2[1] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr6[i];
+    /* 1: convubw */
+    var51.x2[0] = (orc_uint8) var36.x2[0];
+    var51.x2[1] = (orc_uint8) var36.x2[1];
+    /* 2: loadoffw */
+    var52 = ptr6[i + -1];
+    /* 3: convubw */
+    var53.x2[0] = (orc_uint8) var52.x2[0];
+    var53.x2[1] = (orc_uint8) var52.x2[1];
+    /* 4: loadoffw */
+    var54 = ptr6[i + 1];
+    /* 5: convubw */
+    var55.x2[0] = (orc_uint8) var54.x2[0];
+    var55.x2[1] = (orc_uint8) var54.x2[1];
+    /* 6: addw */
+    var56.x2[0] = var53.x2[0] + var55.x2[0];
+    var56.x2[1] = var53.x2[1] + var55.x2[1];
+    /* 7: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var53.i;
+      var57.i = _src.x2[1];
+    }
+    /* 8: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var58.i = _src.x2[0];
+    }
+    /* 9: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var57.i;
+      _dest.x2[1] = var58.i;
+      var59.i = _dest.i;
+    }
+    /* 10: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var60.i = _src.x2[1];
+    }
+    /* 11: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var55.i;
+      var61.i = _src.x2[0];
+    }
+    /* 12: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var60.i;
+      _dest.x2[1] = var61.i;
+      var62.i = _dest.i;
+    }
+    /* 13: addw */
+    var63.x2[0] = var59.x2[0] + var62.x2[0];
+    var63.x2[1] = var59.x2[1] + var62.x2[1];
+    /* 14: loadw */
+    var37 = ptr5[i];
+    /* 15: convubw */
+    var64.x2[0] = (orc_uint8) var37.x2[0];
+    var64.x2[1] = (orc_uint8) var37.x2[1];
+    /* 16: loadw */
+    var38 = ptr7[i];
+    /* 17: convubw */
+    var65.x2[0] = (orc_uint8) var38.x2[0];
+    var65.x2[1] = (orc_uint8) var38.x2[1];
+    /* 18: addw */
+    var66.x2[0] = var64.x2[0] + var65.x2[0];
+    var66.x2[1] = var64.x2[1] + var65.x2[1];
+    /* 19: loadoffw */
+    var67 = ptr5[i + -1];
+    /* 20: convubw */
+    var68.x2[0] = (orc_uint8) var67.x2[0];
+    var68.x2[1] = (orc_uint8) var67.x2[1];
+    /* 21: loadoffw */
+    var69 = ptr7[i + -1];
+    /* 22: convubw */
+    var70.x2[0] = (orc_uint8) var69.x2[0];
+    var70.x2[1] = (orc_uint8) var69.x2[1];
+    /* 23: addw */
+    var71.x2[0] = var68.x2[0] + var70.x2[0];
+    var71.x2[1] = var68.x2[1] + var70.x2[1];
+    /* 24: loadoffw */
+    var72 = ptr5[i + 1];
+    /* 25: convubw */
+    var73.x2[0] = (orc_uint8) var72.x2[0];
+    var73.x2[1] = (orc_uint8) var72.x2[1];
+    /* 26: loadoffw */
+    var74 = ptr7[i + 1];
+    /* 27: convubw */
+    var75.x2[0] = (orc_uint8) var74.x2[0];
+    var75.x2[1] = (orc_uint8) var74.x2[1];
+    /* 28: addw */
+    var76.x2[0] = var73.x2[0] + var75.x2[0];
+    var76.x2[1] = var73.x2[1] + var75.x2[1];
+    /* 29: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var71.i;
+      var77.i = _src.x2[1];
+    }
+    /* 30: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var78.i = _src.x2[0];
+    }
+    /* 31: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var77.i;
+      _dest.x2[1] = var78.i;
+      var79.i = _dest.i;
+    }
+    /* 32: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var80.i = _src.x2[1];
+    }
+    /* 33: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var76.i;
+      var81.i = _src.x2[0];
+    }
+    /* 34: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var80.i;
+      _dest.x2[1] = var81.i;
+      var82.i = _dest.i;
+    }
+    /* 35: addw */
+    var83.x2[0] = var79.x2[0] + var82.x2[0];
+    var83.x2[1] = var79.x2[1] + var82.x2[1];
+    /* 36: loadw */
+    var39 = ptr4[i];
+    /* 37: convubw */
+    var84.x2[0] = (orc_uint8) var39.x2[0];
+    var84.x2[1] = (orc_uint8) var39.x2[1];
+    /* 38: loadw */
+    var40 = ptr8[i];
+    /* 39: convubw */
+    var85.x2[0] = (orc_uint8) var40.x2[0];
+    var85.x2[1] = (orc_uint8) var40.x2[1];
+    /* 40: addw */
+    var86.x2[0] = var84.x2[0] + var85.x2[0];
+    var86.x2[1] = var84.x2[1] + var85.x2[1];
+    /* 42: mullw */
+    var87.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var87.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 44: shlw */
+    var88.x2[0] = var83.x2[0] << var42.x2[0];
+    var88.x2[1] = var83.x2[1] << var42.x2[1];
+    /* 45: subw */
+    var89.x2[0] = var87.x2[0] - var88.x2[0];
+    var89.x2[1] = var87.x2[1] - var88.x2[1];
+    /* 47: addw */
+    var90.x2[0] = var89.x2[0] + var43.x2[0];
+    var90.x2[1] = var89.x2[1] + var43.x2[1];
+    /* 49: shlw */
+    var91.x2[0] = var63.x2[0] << var44.x2[0];
+    var91.x2[1] = var63.x2[1] << var44.x2[1];
+    /* 50: addw */
+    var92.x2[0] = var91.x2[0] + var90.x2[0];
+    var92.x2[1] = var91.x2[1] + var90.x2[1];
+    /* 51: shlw */
+    var93.x2[0] = var56.x2[0] << var42.x2[0];
+    var93.x2[1] = var56.x2[1] << var42.x2[1];
+    /* 52: subw */
+    var94.x2[0] = var92.x2[0] - var93.x2[0];
+    var94.x2[1] = var92.x2[1] - var93.x2[1];
+    /* 53: addw */
+    var95.x2[0] = var94.x2[0] + var86.x2[0];
+    var95.x2[1] = var94.x2[1] + var86.x2[1];
+    /* 55: shrsw */
+    var96.x2[0] = var95.x2[0] >> var45.x2[0];
+    var96.x2[1] = var95.x2[1] >> var45.x2[1];
+    /* 56: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var97.i = _src.x2[0];
+    }
+    /* 57: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var96.i;
+      var98.i = _src.x2[1];
+    }
+    /* 58: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var97.i;
+      _dest.x2[1] = var98.i;
+      var99.i = _dest.i;
+    }
+    /* 59: convsuswb */
+    var48.x2[0] = ORC_CLAMP_UB (var99.x2[0]);
+    var48.x2[1] = ORC_CLAMP_UB (var99.x2[1]);
+    /* 60: storew */
+    ptr0[i] = var48;
+    /* 61: shlw */
+    var100.x2[0] = var66.x2[0] << var44.x2[0];
+    var100.x2[1] = var66.x2[1] << var44.x2[1];
+    /* 62: addw */
+    var101.x2[0] = var100.x2[0] + var90.x2[0];
+    var101.x2[1] = var100.x2[1] + var90.x2[1];
+    /* 63: shlw */
+    var102.x2[0] = var86.x2[0] << var42.x2[0];
+    var102.x2[1] = var86.x2[1] << var42.x2[1];
+    /* 64: subw */
+    var103.x2[0] = var101.x2[0] - var102.x2[0];
+    var103.x2[1] = var101.x2[1] - var102.x2[1];
+    /* 65: addw */
+    var104.x2[0] = var103.x2[0] + var56.x2[0];
+    var104.x2[1] = var103.x2[1] + var56.x2[1];
+    /* 66: shrsw */
+    var105.x2[0] = var104.x2[0] >> var45.x2[0];
+    var105.x2[1] = var104.x2[1] >> var45.x2[1];
+    /* 67: addw */
+    var106.x2[0] = var86.x2[0] + var56.x2[0];
+    var106.x2[1] = var86.x2[1] + var56.x2[1];
+    /* 68: mullw */
+    var107.x2[0] = (var106.x2[0] * var44.x2[0]) & 0xffff;
+    var107.x2[1] = (var106.x2[1] * var44.x2[1]) & 0xffff;
+    /* 70: shlw */
+    var108.x2[0] = var83.x2[0] << var46.x2[0];
+    var108.x2[1] = var83.x2[1] << var46.x2[1];
+    /* 71: subw */
+    var109.x2[0] = var108.x2[0] - var107.x2[0];
+    var109.x2[1] = var108.x2[1] - var107.x2[1];
+    /* 73: mullw */
+    var110.x2[0] = (var51.x2[0] * var47.x2[0]) & 0xffff;
+    var110.x2[1] = (var51.x2[1] * var47.x2[1]) & 0xffff;
+    /* 74: addw */
+    var111.x2[0] = var109.x2[0] + var110.x2[0];
+    var111.x2[1] = var109.x2[1] + var110.x2[1];
+    /* 75: addw */
+    var112.x2[0] = var111.x2[0] + var43.x2[0];
+    var112.x2[1] = var111.x2[1] + var43.x2[1];
+    /* 76: shrsw */
+    var113.x2[0] = var112.x2[0] >> var45.x2[0];
+    var113.x2[1] = var112.x2[1] >> var45.x2[1];
+    /* 77: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var113.i;
+      var114.i = _src.x2[0];
+    }
+    /* 78: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var105.i;
+      var115.i = _src.x2[1];
+    }
+    /* 79: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var114.i;
+      _dest.x2[1] = var115.i;
+      var116.i = _dest.i;
+    }
+    /* 80: convsuswb */
+    var50.x2[0] = ORC_CLAMP_UB (var116.x2[0]);
+    var50.x2[1] = ORC_CLAMP_UB (var116.x2[1]);
+    /* 81: storew */
+    ptr2[i] = var50;
+    /* 82: addw */
+    var117.x2[0] = var66.x2[0] + var63.x2[0];
+    var117.x2[1] = var66.x2[1] + var63.x2[1];
+    /* 83: shlw */
+    var118.x2[0] = var117.x2[0] << var42.x2[0];
+    var118.x2[1] = var117.x2[1] << var42.x2[1];
+    /* 84: subw */
+    var119.x2[0] = var118.x2[0] - var106.x2[0];
+    var119.x2[1] = var118.x2[1] - var106.x2[1];
+    /* 85: shlw */
+    var120.x2[0] = var51.x2[0] << var46.x2[0];
+    var120.x2[1] = var51.x2[1] << var46.x2[1];
+    /* 86: addw */
+    var121.x2[0] = var119.x2[0] + var120.x2[0];
+    var121.x2[1] = var119.x2[1] + var120.x2[1];
+    /* 87: addw */
+    var122.x2[0] = var121.x2[0] + var45.x2[0];
+    var122.x2[1] = var121.x2[1] + var45.x2[1];
+    /* 88: shrsw */
+    var123.x2[0] = var122.x2[0] >> var44.x2[0];
+    var123.x2[1] = var122.x2[1] >> var44.x2[1];
+    /* 89: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var123.i;
+      var124.i = _src.x2[0];
+    }
+    /* 90: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var125.i = _src.x2[1];
+    }
+    /* 91: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var124.i;
+      _dest.x2[1] = var125.i;
+      var126.i = _dest.i;
+    }
+    /* 92: convsuswb */
+    var49.x2[0] = ORC_CLAMP_UB (var126.x2[0]);
+    var49.x2[1] = ORC_CLAMP_UB (var126.x2[1]);
+    /* 93: storew */
+    ptr1[i] = var49;
+  }
+
+}
+
+void
+gst_bayer_malvar_bg (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcProgram *p = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "gst_bayer_malvar_bg");
+      orc_program_set_backup_function (p, _backup_gst_bayer_malvar_bg);
+      orc_program_add_destination (p, 2, "d1");
+      orc_program_add_destination (p, 2, "d2");
+      orc_program_add_destination (p, 2, "d3");
+      orc_program_add_source (p, 2, "s1");
+      orc_program_add_source (p, 2, "s2");
+      orc_program_add_source (p, 2, "s3");
+      orc_program_add_source (p, 2, "s4");
+      orc_program_add_source (p, 2, "s5");
+      orc_program_add_constant (p, 4, 0xffffffff, "c1");
+      orc_program_add_constant (p, 4, 0x00000001, "c2");
+      orc_program_add_constant (p, 4, 0x0000000a, "c3");
+      orc_program_add_constant (p, 4, 0x00000008, "c4");
+      orc_program_add_constant (p, 4, 0x00000003, "c5");
+      orc_program_add_constant (p, 4, 0x00000004, "c6");
+      orc_program_add_constant (p, 4, 0x00000002, "c7");
+      orc_program_add_constant (p, 4, 0x0000000c, "c8");
+      orc_program_add_temporary (p, 4, "t1");
+      orc_program_add_temporary (p, 4, "t2");
+      orc_program_add_temporary (p, 4, "t3");
+      orc_program_add_temporary (p, 4, "t4");
+      orc_program_add_temporary (p, 4, "t5");
+      orc_program_add_temporary (p, 4, "t6");
+      orc_program_add_temporary (p, 4, "t7");
+      orc_program_add_temporary (p, 4, "t8");
+      orc_program_add_temporary (p, 4, "t9");
+      orc_program_add_temporary (p, 2, "t10");
+      orc_program_add_temporary (p, 2, "t11");
+      orc_program_add_temporary (p, 2, "t12");
+
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T1, ORC_VAR_S3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S3,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S3,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T3, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T9, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T7, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T2, ORC_VAR_T9, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_S2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_S4, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T4, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S2,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S4,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S2,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S4,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T9, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T4,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T9, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T4,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T7, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T9, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_S5, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T5, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T9, ORC_VAR_T1, ORC_VAR_C3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T6, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T9, ORC_VAR_T9, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T9, ORC_VAR_T9, ORC_VAR_C4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T2, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T3, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D1, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T5, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T9, ORC_VAR_T5, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T8, ORC_VAR_T9, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T8, ORC_VAR_T1, ORC_VAR_C8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T6,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D3, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T1, ORC_VAR_C7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D2, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+
+      orc_program_compile (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_D3] = d3;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gst_bayer_malvar_gr */
+#ifdef DISABLE_ORC
+void
+gst_bayer_malvar_gr (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union32 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union32 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union32 var62;
+  orc_union32 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union16 var67;
+  orc_union32 var68;
+  orc_union16 var69;
+  orc_union32 var70;
+  orc_union32 var71;
+  orc_union16 var72;
+  orc_union32 var73;
+  orc_union16 var74;
+  orc_union32 var75;
+  orc_union32 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union32 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union32 var82;
+  orc_union32 var83;
+  orc_union32 var84;
+  orc_union32 var85;
+  orc_union32 var86;
+  orc_union32 var87;
+  orc_union32 var88;
+  orc_union32 var89;
+  orc_union32 var90;
+  orc_union32 var91;
+  orc_union32 var92;
+  orc_union32 var93;
+  orc_union32 var94;
+  orc_union32 var95;
+  orc_union32 var96;
+  orc_union16 var97;
+  orc_union16 var98;
+  orc_union32 var99;
+  orc_union32 var100;
+  orc_union32 var101;
+  orc_union32 var102;
+  orc_union32 var103;
+  orc_union32 var104;
+  orc_union32 var105;
+  orc_union32 var106;
+  orc_union32 var107;
+  orc_union32 var108;
+  orc_union32 var109;
+  orc_union32 var110;
+  orc_union32 var111;
+  orc_union32 var112;
+  orc_union32 var113;
+  orc_union16 var114;
+  orc_union16 var115;
+  orc_union32 var116;
+  orc_union32 var117;
+  orc_union32 var118;
+  orc_union32 var119;
+  orc_union32 var120;
+  orc_union32 var121;
+  orc_union32 var122;
+  orc_union32 var123;
+  orc_union16 var124;
+  orc_union16 var125;
+  orc_union32 var126;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union16 *) d2;
+  ptr2 = (orc_union16 *) d3;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+
+  /* 41: loadpw */
+  var41.x2[0] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  var41.x2[1] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  /* 43: loadpw */
+  var42.x2[0] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  var42.x2[1] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  /* 46: loadpw */
+  var43.x2[0] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  var43.x2[1] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  /* 48: loadpw */
+  var44.x2[0] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  var44.x2[1] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  /* 54: loadpw */
+  var45.x2[0] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  var45.x2[1] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  /* 69: loadpw */
+  var46.x2[0] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  var46.x2[1] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  /* 72: loadpw */
+  var47.x2[0] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+  var47.x2[1] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr6[i];
+    /* 1: convubw */
+    var51.x2[0] = (orc_uint8) var36.x2[0];
+    var51.x2[1] = (orc_uint8) var36.x2[1];
+    /* 2: loadoffw */
+    var52 = ptr6[i + -1];
+    /* 3: convubw */
+    var53.x2[0] = (orc_uint8) var52.x2[0];
+    var53.x2[1] = (orc_uint8) var52.x2[1];
+    /* 4: loadoffw */
+    var54 = ptr6[i + 1];
+    /* 5: convubw */
+    var55.x2[0] = (orc_uint8) var54.x2[0];
+    var55.x2[1] = (orc_uint8) var54.x2[1];
+    /* 6: addw */
+    var56.x2[0] = var53.x2[0] + var55.x2[0];
+    var56.x2[1] = var53.x2[1] + var55.x2[1];
+    /* 7: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var53.i;
+      var57.i = _src.x2[1];
+    }
+    /* 8: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var58.i = _src.x2[0];
+    }
+    /* 9: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var57.i;
+      _dest.x2[1] = var58.i;
+      var59.i = _dest.i;
+    }
+    /* 10: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var60.i = _src.x2[1];
+    }
+    /* 11: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var55.i;
+      var61.i = _src.x2[0];
+    }
+    /* 12: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var60.i;
+      _dest.x2[1] = var61.i;
+      var62.i = _dest.i;
+    }
+    /* 13: addw */
+    var63.x2[0] = var59.x2[0] + var62.x2[0];
+    var63.x2[1] = var59.x2[1] + var62.x2[1];
+    /* 14: loadw */
+    var37 = ptr5[i];
+    /* 15: convubw */
+    var64.x2[0] = (orc_uint8) var37.x2[0];
+    var64.x2[1] = (orc_uint8) var37.x2[1];
+    /* 16: loadw */
+    var38 = ptr7[i];
+    /* 17: convubw */
+    var65.x2[0] = (orc_uint8) var38.x2[0];
+    var65.x2[1] = (orc_uint8) var38.x2[1];
+    /* 18: addw */
+    var66.x2[0] = var64.x2[0] + var65.x2[0];
+    var66.x2[1] = var64.x2[1] + var65.x2[1];
+    /* 19: loadoffw */
+    var67 = ptr5[i + -1];
+    /* 20: convubw */
+    var68.x2[0] = (orc_uint8) var67.x2[0];
+    var68.x2[1] = (orc_uint8) var67.x2[1];
+    /* 21: loadoffw */
+    var69 = ptr7[i + -1];
+    /* 22: convubw */
+    var70.x2[0] = (orc_uint8) var69.x2[0];
+    var70.x2[1] = (orc_uint8) var69.x2[1];
+    /* 23: addw */
+    var71.x2[0] = var68.x2[0] + var70.x2[0];
+    var71.x2[1] = var68.x2[1] + var70.x2[1];
+    /* 24: loadoffw */
+    var72 = ptr5[i + 1];
+    /* 25: convubw */
+    var73.x2[0] = (orc_uint8) var72.x2[0];
+    var73.x2[1] = (orc_uint8) var72.x2[1];
+    /* 26: loadoffw */
+    var74 = ptr7[i + 1];
+    /* 27: convubw */
+    var75.x2[0] = (orc_uint8) var74.x2[0];
+    var75.x2[1] = (orc_uint8) var74.x2[1];
+    /* 28: addw */
+    var76.x2[0] = var73.x2[0] + var75.x2[0];
+    var76.x2[1] = var73.x2[1] + var75.x2[1];
+    /* 29: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var71.i;
+      var77.i = _src.x2[1];
+    }
+    /* 30: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var78.i = _src.x2[0];
+    }
+    /* 31: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var77.i;
+      _dest.x2[1] = var78.i;
+      var79.i = _dest.i;
+    }
+    /* 32: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var80.i = _src.x2[1];
+    }
+    /* 33: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var76.i;
+      var81.i = _src.x2[0];
+    }
+    /* 34: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var80.i;
+      _dest.x2[1] = var81.i;
+      var82.i = _dest.i;
+    }
+    /* 35: addw */
+    var83.x2[0] = var79.x2[0] + var82.x2[0];
+    var83.x2[1] = var79.x2[1] + var82.x2[1];
+    /* 36: loadw */
+    var39 = ptr4[i];
+    /* 37: convubw */
+    var84.x2[0] = (orc_uint8) var39.x2[0];
+    var84.x2[1] = (orc_uint8) var39.x2[1];
+    /* 38: loadw */
+    var40 = ptr8[i];
+    /* 39: convubw */
+    var85.x2[0] = (orc_uint8) var40.x2[0];
+    var85.x2[1] = (orc_uint8) var40.x2[1];
+    /* 40: addw */
+    var86.x2[0] = var84.x2[0] + var85.x2[0];
+    var86.x2[1] = var84.x2[1] + var85.x2[1];
+    /* 42: mullw */
+    var87.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var87.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 44: shlw */
+    var88.x2[0] = var83.x2[0] << var42.x2[0];
+    var88.x2[1] = var83.x2[1] << var42.x2[1];
+    /* 45: subw */
+    var89.x2[0] = var87.x2[0] - var88.x2[0];
+    var89.x2[1] = var87.x2[1] - var88.x2[1];
+    /* 47: addw */
+    var90.x2[0] = var89.x2[0] + var43.x2[0];
+    var90.x2[1] = var89.x2[1] + var43.x2[1];
+    /* 49: shlw */
+    var91.x2[0] = var63.x2[0] << var44.x2[0];
+    var91.x2[1] = var63.x2[1] << var44.x2[1];
+    /* 50: addw */
+    var92.x2[0] = var91.x2[0] + var90.x2[0];
+    var92.x2[1] = var91.x2[1] + var90.x2[1];
+    /* 51: shlw */
+    var93.x2[0] = var56.x2[0] << var42.x2[0];
+    var93.x2[1] = var56.x2[1] << var42.x2[1];
+    /* 52: subw */
+    var94.x2[0] = var92.x2[0] - var93.x2[0];
+    var94.x2[1] = var92.x2[1] - var93.x2[1];
+    /* 53: addw */
+    var95.x2[0] = var94.x2[0] + var86.x2[0];
+    var95.x2[1] = var94.x2[1] + var86.x2[1];
+    /* 55: shrsw */
+    var96.x2[0] = var95.x2[0] >> var45.x2[0];
+    var96.x2[1] = var95.x2[1] >> var45.x2[1];
+    /* 56: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var96.i;
+      var97.i = _src.x2[0];
+    }
+    /* 57: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var98.i = _src.x2[1];
+    }
+    /* 58: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var97.i;
+      _dest.x2[1] = var98.i;
+      var99.i = _dest.i;
+    }
+    /* 59: convsuswb */
+    var50.x2[0] = ORC_CLAMP_UB (var99.x2[0]);
+    var50.x2[1] = ORC_CLAMP_UB (var99.x2[1]);
+    /* 60: storew */
+    ptr2[i] = var50;
+    /* 61: shlw */
+    var100.x2[0] = var66.x2[0] << var44.x2[0];
+    var100.x2[1] = var66.x2[1] << var44.x2[1];
+    /* 62: addw */
+    var101.x2[0] = var100.x2[0] + var90.x2[0];
+    var101.x2[1] = var100.x2[1] + var90.x2[1];
+    /* 63: shlw */
+    var102.x2[0] = var86.x2[0] << var42.x2[0];
+    var102.x2[1] = var86.x2[1] << var42.x2[1];
+    /* 64: subw */
+    var103.x2[0] = var101.x2[0] - var102.x2[0];
+    var103.x2[1] = var101.x2[1] - var102.x2[1];
+    /* 65: addw */
+    var104.x2[0] = var103.x2[0] + var56.x2[0];
+    var104.x2[1] = var103.x2[1] + var56.x2[1];
+    /* 66: shrsw */
+    var105.x2[0] = var104.x2[0] >> var45.x2[0];
+    var105.x2[1] = var104.x2[1] >> var45.x2[1];
+    /* 67: addw */
+    var106.x2[0] = var86.x2[0] + var56.x2[0];
+    var106.x2[1] = var86.x2[1] + var56.x2[1];
+    /* 68: mullw */
+    var107.x2[0] = (var106.x2[0] * var44.x2[0]) & 0xffff;
+    var107.x2[1] = (var106.x2[1] * var44.x2[1]) & 0xffff;
+    /* 70: shlw */
+    var108.x2[0] = var83.x2[0] << var46.x2[0];
+    var108.x2[1] = var83.x2[1] << var46.x2[1];
+    /* 71: subw */
+    var109.x2[0] = var108.x2[0] - var107.x2[0];
+    var109.x2[1] = var108.x2[1] - var107.x2[1];
+    /* 73: mullw */
+    var110.x2[0] = (var51.x2[0] * var47.x2[0]) & 0xffff;
+    var110.x2[1] = (var51.x2[1] * var47.x2[1]) & 0xffff;
+    /* 74: addw */
+    var111.x2[0] = var109.x2[0] + var110.x2[0];
+    var111.x2[1] = var109.x2[1] + var110.x2[1];
+    /* 75: addw */
+    var112.x2[0] = var111.x2[0] + var43.x2[0];
+    var112.x2[1] = var111.x2[1] + var43.x2[1];
+    /* 76: shrsw */
+    var113.x2[0] = var112.x2[0] >> var45.x2[0];
+    var113.x2[1] = var112.x2[1] >> var45.x2[1];
+    /* 77: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var105.i;
+      var114.i = _src.x2[0];
+    }
+    /* 78: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var113.i;
+      var115.i = _src.x2[1];
+    }
+    /* 79: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var114.i;
+      _dest.x2[1] = var115.i;
+      var116.i = _dest.i;
+    }
+    /* 80: convsuswb */
+    var48.x2[0] = ORC_CLAMP_UB (var116.x2[0]);
+    var48.x2[1] = ORC_CLAMP_UB (var116.x2[1]);
+    /* 81: storew */
+    ptr0[i] = var48;
+    /* 82: addw */
+    var117.x2[0] = var66.x2[0] + var63.x2[0];
+    var117.x2[1] = var66.x2[1] + var63.x2[1];
+    /* 83: shlw */
+    var118.x2[0] = var117.x2[0] << var42.x2[0];
+    var118.x2[1] = var117.x2[1] << var42.x2[1];
+    /* 84: subw */
+    var119.x2[0] = var118.x2[0] - var106.x2[0];
+    var119.x2[1] = var118.x2[1] - var106.x2[1];
+    /* 85: shlw */
+    var120.x2[0] = var51.x2[0] << var46.x2[0];
+    var120.x2[1] = var51.x2[1] << var46.x2[1];
+    /* 86: addw */
+    var121.x2[0] = var119.x2[0] + var120.x2[0];
+    var121.x2[1] = var119.x2[1] + var120.x2[1];
+    /* 87: addw */
+    var122.x2[0] = var121.x2[0] + var45.x2[0];
+    var122.x2[1] = var121.x2[1] + var45.x2[1];
+    /* 88: shrsw */
+    var123.x2[0] = var122.x2[0] >> var44.x2[0];
+    var123.x2[1] = var122.x2[1] >> var44.x2[1];
+    /* 89: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var124.i = _src.x2[0];
+    }
+    /* 90: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var123.i;
+      var125.i = _src.x2[1];
+    }
+    /* 91: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var124.i;
+      _dest.x2[1] = var125.i;
+      var126.i = _dest.i;
+    }
+    /* 92: convsuswb */
+    var49.x2[0] = ORC_CLAMP_UB (var126.x2[0]);
+    var49.x2[1] = ORC_CLAMP_UB (var126.x2[1]);
+    /* 93: storew */
+    ptr1[i] = var49;
+  }
+
+}
+
+#else
+static void
+_backup_gst_bayer_malvar_gr (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union32 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union32 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union32 var62;
+  orc_union32 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union16 var67;
+  orc_union32 var68;
+  orc_union16 var69;
+  orc_union32 var70;
+  orc_union32 var71;
+  orc_union16 var72;
+  orc_union32 var73;
+  orc_union16 var74;
+  orc_union32 var75;
+  orc_union32 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union32 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union32 var82;
+  orc_union32 var83;
+  orc_union32 var84;
+  orc_union32 var85;
+  orc_union32 var86;
+  orc_union32 var87;
+  orc_union32 var88;
+  orc_union32 var89;
+  orc_union32 var90;
+  orc_union32 var91;
+  orc_union32 var92;
+  orc_union32 var93;
+  orc_union32 var94;
+  orc_union32 var95;
+  orc_union32 var96;
+  orc_union16 var97;
+  orc_union16 var98;
+  orc_union32 var99;
+  orc_union32 var100;
+  orc_union32 var101;
+  orc_union32 var102;
+  orc_union32 var103;
+  orc_union32 var104;
+  orc_union32 var105;
+  orc_union32 var106;
+  orc_union32 var107;
+  orc_union32 var108;
+  orc_union32 var109;
+  orc_union32 var110;
+  orc_union32 var111;
+  orc_union32 var112;
+  orc_union32 var113;
+  orc_union16 var114;
+  orc_union16 var115;
+  orc_union32 var116;
+  orc_union32 var117;
+  orc_union32 var118;
+  orc_union32 var119;
+  orc_union32 var120;
+  orc_union32 var121;
+  orc_union32 var122;
+  orc_union32 var123;
+  orc_union16 var124;
+  orc_union16 var125;
+  orc_union32 var126;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union16 *) ex->arrays[1];
+  ptr2 = (orc_union16 *) ex->arrays[2];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+
+  /* 41: loadpw */
+  var41.x2[0] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  var41.x2[1] = (int) 0x0000000a; /* 10 or 4.94066e-323f */
+  /* 43: loadpw */
+  var42.x2[0] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  var42.x2[1] = (int) 0x00000001; /* 1 or 4.94066e-324f */
+  /* 46: loadpw */
+  var43.x2[0] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  var43.x2[1] = (int) 0x00000008; /* 8 or 3.95253e-323f */
+  /* 48: loadpw */
+  var44.x2[0] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  var44.x2[1] = (int) 0x00000003; /* 3 or 1.4822e-323f */
+  /* 54: loadpw */
+  var45.x2[0] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  var45.x2[1] = (int) 0x00000004; /* 4 or 1.97626e-323f */
+  /* 69: loadpw */
+  var46.x2[0] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  var46.x2[1] = (int) 0x00000002; /* 2 or 9.88131e-324f */
+  /* 72: loadpw */
+  var47.x2[0] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+  var47.x2[1] = (int) 0x0000000c; /* 12 or 5.92879e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr6[i];
+    /* 1: convubw */
+    var51.x2[0] = (orc_uint8) var36.x2[0];
+    var51.x2[1] = (orc_uint8) var36.x2[1];
+    /* 2: loadoffw */
+    var52 = ptr6[i + -1];
+    /* 3: convubw */
+    var53.x2[0] = (orc_uint8) var52.x2[0];
+    var53.x2[1] = (orc_uint8) var52.x2[1];
+    /* 4: loadoffw */
+    var54 = ptr6[i + 1];
+    /* 5: convubw */
+    var55.x2[0] = (orc_uint8) var54.x2[0];
+    var55.x2[1] = (orc_uint8) var54.x2[1];
+    /* 6: addw */
+    var56.x2[0] = var53.x2[0] + var55.x2[0];
+    var56.x2[1] = var53.x2[1] + var55.x2[1];
+    /* 7: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var53.i;
+      var57.i = _src.x2[1];
+    }
+    /* 8: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var58.i = _src.x2[0];
+    }
+    /* 9: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var57.i;
+      _dest.x2[1] = var58.i;
+      var59.i = _dest.i;
+    }
+    /* 10: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var60.i = _src.x2[1];
+    }
+    /* 11: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var55.i;
+      var61.i = _src.x2[0];
+    }
+    /* 12: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var60.i;
+      _dest.x2[1] = var61.i;
+      var62.i = _dest.i;
+    }
+    /* 13: addw */
+    var63.x2[0] = var59.x2[0] + var62.x2[0];
+    var63.x2[1] = var59.x2[1] + var62.x2[1];
+    /* 14: loadw */
+    var37 = ptr5[i];
+    /* 15: convubw */
+    var64.x2[0] = (orc_uint8) var37.x2[0];
+    var64.x2[1] = (orc_uint8) var37.x2[1];
+    /* 16: loadw */
+    var38 = ptr7[i];
+    /* 17: convubw */
+    var65.x2[0] = (orc_uint8) var38.x2[0];
+    var65.x2[1] = (orc_uint8) var38.x2[1];
+    /* 18: addw */
+    var66.x2[0] = var64.x2[0] + var65.x2[0];
+    var66.x2[1] = var64.x2[1] + var65.x2[1];
+    /* 19: loadoffw */
+    var67 = ptr5[i + -1];
+    /* 20: convubw */
+    var68.x2[0] = (orc_uint8) var67.x2[0];
+    var68.x2[1] = (orc_uint8) var67.x2[1];
+    /* 21: loadoffw */
+    var69 = ptr7[i + -1];
+    /* 22: convubw */
+    var70.x2[0] = (orc_uint8) var69.x2[0];
+    var70.x2[1] = (orc_uint8) var69.x2[1];
+    /* 23: addw */
+    var71.x2[0] = var68.x2[0] + var70.x2[0];
+    var71.x2[1] = var68.x2[1] + var70.x2[1];
+    /* 24: loadoffw */
+    var72 = ptr5[i + 1];
+    /* 25: convubw */
+    var73.x2[0] = (orc_uint8) var72.x2[0];
+    var73.x2[1] = (orc_uint8) var72.x2[1];
+    /* 26: loadoffw */
+    var74 = ptr7[i + 1];
+    /* 27: convubw */
+    var75.x2[0] = (orc_uint8) var74.x2[0];
+    var75.x2[1] = (orc_uint8) var74.x2[1];
+    /* 28: addw */
+    var76.x2[0] = var73.x2[0] + var75.x2[0];
+    var76.x2[1] = var73.x2[1] + var75.x2[1];
+    /* 29: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var71.i;
+      var77.i = _src.x2[1];
+    }
+    /* 30: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var78.i = _src.x2[0];
+    }
+    /* 31: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var77.i;
+      _dest.x2[1] = var78.i;
+      var79.i = _dest.i;
+    }
+    /* 32: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var66.i;
+      var80.i = _src.x2[1];
+    }
+    /* 33: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var76.i;
+      var81.i = _src.x2[0];
+    }
+    /* 34: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var80.i;
+      _dest.x2[1] = var81.i;
+      var82.i = _dest.i;
+    }
+    /* 35: addw */
+    var83.x2[0] = var79.x2[0] + var82.x2[0];
+    var83.x2[1] = var79.x2[1] + var82.x2[1];
+    /* 36: loadw */
+    var39 = ptr4[i];
+    /* 37: convubw */
+    var84.x2[0] = (orc_uint8) var39.x2[0];
+    var84.x2[1] = (orc_uint8) var39.x2[1];
+    /* 38: loadw */
+    var40 = ptr8[i];
+    /* 39: convubw */
+    var85.x2[0] = (orc_uint8) var40.x2[0];
+    var85.x2[1] = (orc_uint8) var40.x2[1];
+    /* 40: addw */
+    var86.x2[0] = var84.x2[0] + var85.x2[0];
+    var86.x2[1] = var84.x2[1] + var85.x2[1];
+    /* 42: mullw */
+    var87.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var87.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 44: shlw */
+    var88.x2[0] = var83.x2[0] << var42.x2[0];
+    var88.x2[1] = var83.x2[1] << var42.x2[1];
+    /* 45: subw */
+    var89.x2[0] = var87.x2[0] - var88.x2[0];
+    var89.x2[1] = var87.x2[1] - var88.x2[1];
+    /* 47: addw */
+    var90.x2[0] = var89.x2[0] + var43.x2[0];
+    var90.x2[1] = var89.x2[1] + var43.x2[1];
+    /* 49: shlw */
+    var91.x2[0] = var63.x2[0] << var44.x2[0];
+    var91.x2[1] = var63.x2[1] << var44.x2[1];
+    /* 50: addw */
+    var92.x2[0] = var91.x2[0] + var90.x2[0];
+    var92.x2[1] = var91.x2[1] + var90.x2[1];
+    /* 51: shlw */
+    var93.x2[0] = var56.x2[0] << var42.x2[0];
+    var93.x2[1] = var56.x2[1] << var42.x2[1];
+    /* 52: subw */
+    var94.x2[0] = var92.x2[0] - var93.x2[0];
+    var94.x2[1] = var92.x2[1] - var93.x2[1];
+    /* 53: addw */
+    var95.x2[0] = var94.x2[0] + var86.x2[0];
+    var95.x2[1] = var94.x2[1] + var86.x2[1];
+    /* 55: shrsw */
+    var96.x2[0] = var95.x2[0] >> var45.x2[0];
+    var96.x2[1] = var95.x2[1] >> var45.x2[1];
+    /* 56: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var96.i;
+      var97.i = _src.x2[0];
+    }
+    /* 57: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var98.i = _src.x2[1];
+    }
+    /* 58: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var97.i;
+      _dest.x2[1] = var98.i;
+      var99.i = _dest.i;
+    }
+    /* 59: convsuswb */
+    var50.x2[0] = ORC_CLAMP_UB (var99.x2[0]);
+    var50.x2[1] = ORC_CLAMP_UB (var99.x2[1]);
+    /* 60: storew */
+    ptr2[i] = var50;
+    /* 61: shlw */
+    var100.x2[0] = var66.x2[0] << var44.x2[0];
+    var100.x2[1] = var66.x2[1] << var44.x2[1];
+    /* 62: addw */
+    var101.x2[0] = var100.x2[0] + var90.x2[0];
+    var101.x2[1] = var100.x2[1] + var90.x2[1];
+    /* 63: shlw */
+    var102.x2[0] = var86.x2[0] << var42.x2[0];
+    var102.x2[1] = var86.x2[1] << var42.x2[1];
+    /* 64: subw */
+    var103.x2[0] = var101.x2[0] - var102.x2[0];
+    var103.x2[1] = var101.x2[1] - var102.x2[1];
+    /* 65: addw */
+    var104.x2[0] = var103.x2[0] + var56.x2[0];
+    var104.x2[1] = var103.x2[1] + var56.x2[1];
+    /* 66: shrsw */
+    var105.x2[0] = var104.x2[0] >> var45.x2[0];
+    var105.x2[1] = var104.x2[1] >> var45.x2[1];
+    /* 67: addw */
+    var106.x2[0] = var86.x2[0] + var56.x2[0];
+    var106.x2[1] = var86.x2[1] + var56.x2[1];
+    /* 68: mullw */
+    var107.x2[0] = (var106.x2[0] * var44.x2[0]) & 0xffff;
+    var107.x2[1] = (var106.x2[1] * var44.x2[1]) & 0xffff;
+    /* 70: shlw */
+    var108.x2[0] = var83.x2[0] << var46.x2[0];
+    var108.x2[1] = var83.x2[1] << var46.x2[1];
+    /* 71: subw */
+    var109.x2[0] = var108.x2[0] - var107.x2[0];
+    var109.x2[1] = var108.x2[1] - var107.x2[1];
+    /* 73: mullw */
+    var110.x2[0] = (var51.x2[0] * var47.x2[0]) & 0xffff;
+    var110.x2[1] = (var51.x2[1] * var47.x2[1]) & 0xffff;
+    /* 74: addw */
+    var111.x2[0] = var109.x2[0] + var110.x2[0];
+    var111.x2[1] = var109.x2[1] + var110.x2[1];
+    /* 75: addw */
+    var112.x2[0] = var111.x2[0] + var43.x2[0];
+    var112.x2[1] = var111.x2[1] + var43.x2[1];
+    /* 76: shrsw */
+    var113.x2[0] = var112.x2[0] >> var45.x2[0];
+    var113.x2[1] = var112.x2[1] >> var45.x2[1];
+    /* 77: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var105.i;
+      var114.i = _src.x2[0];
+    }
+    /* 78: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var113.i;
+      var115.i = _src.x2[1];
+    }
+    /* 79: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var114.i;
+      _dest.x2[1] = var115.i;
+      var116.i = _dest.i;
+    }
+    /* 80: convsuswb */
+    var48.x2[0] = ORC_CLAMP_UB (var116.x2[0]);
+    var48.x2[1] = ORC_CLAMP_UB (var116.x2[1]);
+    /* 81: storew */
+    ptr0[i] = var48;
+    /* 82: addw */
+    var117.x2[0] = var66.x2[0] + var63.x2[0];
+    var117.x2[1] = var66.x2[1] + var63.x2[1];
+    /* 83: shlw */
+    var118.x2[0] = var117.x2[0] << var42.x2[0];
+    var118.x2[1] = var117.x2[1] << var42.x2[1];
+    /* 84: subw */
+    var119.x2[0] = var118.x2[0] - var106.x2[0];
+    var119.x2[1] = var118.x2[1] - var106.x2[1];
+    /* 85: shlw */
+    var120.x2[0] = var51.x2[0] << var46.x2[0];
+    var120.x2[1] = var51.x2[1] << var46.x2[1];
+    /* 86: addw */
+    var121.x2[0] = var119.x2[0] + var120.x2[0];
+    var121.x2[1] = var119.x2[1] + var120.x2[1];
+    /* 87: addw */
+    var122.x2[0] = var121.x2[0] + var45.x2[0];
+    var122.x2[1] = var121.x2[1] + var45.x2[1];
+    /* 88: shrsw */
+    var123.x2[0] = var122.x2[0] >> var44.x2[0];
+    var123.x2[1] = var122.x2[1] >> var44.x2[1];
+    /* 89: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var51.i;
+      var124.i = _src.x2[0];
+    }
+    /* 90: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var123.i;
+      var125.i = _src.x2[1];
+    }
+    /* 91: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var124.i;
+      _dest.x2[1] = var125.i;
+      var126.i = _dest.i;
+    }
+    /* 92: convsuswb */
+    var49.x2[0] = ORC_CLAMP_UB (var126.x2[0]);
+    var49.x2[1] = ORC_CLAMP_UB (var126.x2[1]);
+    /* 93: storew */
+    ptr1[i] = var49;
+  }
+
+}
+
+void
+gst_bayer_malvar_gr (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1,
+    const guint8 * ORC_RESTRICT s2, const guint8 * ORC_RESTRICT s3,
+    const guint8 * ORC_RESTRICT s4, const guint8 * ORC_RESTRICT s5, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcProgram *p = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "gst_bayer_malvar_gr");
+      orc_program_set_backup_function (p, _backup_gst_bayer_malvar_gr);
+      orc_program_add_destination (p, 2, "d1");
+      orc_program_add_destination (p, 2, "d2");
+      orc_program_add_destination (p, 2, "d3");
+      orc_program_add_source (p, 2, "s1");
+      orc_program_add_source (p, 2, "s2");
+      orc_program_add_source (p, 2, "s3");
+      orc_program_add_source (p, 2, "s4");
+      orc_program_add_source (p, 2, "s5");
+      orc_program_add_constant (p, 4, 0xffffffff, "c1");
+      orc_program_add_constant (p, 4, 0x00000001, "c2");
+      orc_program_add_constant (p, 4, 0x0000000a, "c3");
+      orc_program_add_constant (p, 4, 0x00000008, "c4");
+      orc_program_add_constant (p, 4, 0x00000003, "c5");
+      orc_program_add_constant (p, 4, 0x00000004, "c6");
+      orc_program_add_constant (p, 4, 0x00000002, "c7");
+      orc_program_add_constant (p, 4, 0x0000000c, "c8");
+      orc_program_add_temporary (p, 4, "t1");
+      orc_program_add_temporary (p, 4, "t2");
+      orc_program_add_temporary (p, 4, "t3");
+      orc_program_add_temporary (p, 4, "t4");
+      orc_program_add_temporary (p, 4, "t5");
+      orc_program_add_temporary (p, 4, "t6");
+      orc_program_add_temporary (p, 4, "t7");
+      orc_program_add_temporary (p, 4, "t8");
+      orc_program_add_temporary (p, 4, "t9");
+      orc_program_add_temporary (p, 2, "t10");
+      orc_program_add_temporary (p, 2, "t11");
+      orc_program_add_temporary (p, 2, "t12");
+
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T1, ORC_VAR_S3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S3,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S3,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T3, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T9, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T7, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T2, ORC_VAR_T9, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_S2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_S4, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T4, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S2,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S4,
+          ORC_VAR_C1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S2,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "loadoffw", 0, ORC_VAR_T10, ORC_VAR_S4,
+          ORC_VAR_C2, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T9, ORC_VAR_T10,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T4,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T9, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T11, ORC_VAR_T4,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T12, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T7, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T9, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T7, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_S5, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T5, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T9, ORC_VAR_T1, ORC_VAR_C3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T6, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T9, ORC_VAR_T9, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T9, ORC_VAR_T9, ORC_VAR_C4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T2, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T3, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D3, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T5, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T9, ORC_VAR_T5, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T8, ORC_VAR_T9, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T8, ORC_VAR_T1, ORC_VAR_C8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T6,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D1, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T9,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 1, ORC_VAR_T8, ORC_VAR_T1, ORC_VAR_C7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T11, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T12, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T8, ORC_VAR_T11,
+          ORC_VAR_T12, ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_D2, ORC_VAR_T8,
+          ORC_VAR_D1, ORC_VAR_D1);
+
+      orc_program_compile (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_D3] = d3;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gst_bayer_interleave_4 */
+#ifdef DISABLE_ORC
+void
+gst_bayer_interleave_4 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2,
+    const guint8 * ORC_RESTRICT s3, const guint8 * ORC_RESTRICT s4, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_int8 var39;
+  orc_union32 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var36 = ptr4[i];
+    /* 1: loadb */
+    var37 = ptr5[i];
+    /* 2: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var36;
+      _dest.x2[1] = var37;
+      var41.i = _dest.i;
+    }
+    /* 3: loadb */
+    var38 = ptr6[i];
+    /* 4: loadb */
+    var39 = ptr7[i];
+    /* 5: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var38;
+      _dest.x2[1] = var39;
+      var42.i = _dest.i;
+    }
+    /* 6: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var41.i;
+      _dest.x2[1] = var42.i;
+      var40.i = _dest.i;
+    }
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+#else
+static void
+_backup_gst_bayer_interleave_4 (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_int8 var39;
+  orc_union32 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var36 = ptr4[i];
+    /* 1: loadb */
+    var37 = ptr5[i];
+    /* 2: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var36;
+      _dest.x2[1] = var37;
+      var41.i = _dest.i;
+    }
+    /* 3: loadb */
+    var38 = ptr6[i];
+    /* 4: loadb */
+    var39 = ptr7[i];
+    /* 5: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var38;
+      _dest.x2[1] = var39;
+      var42.i = _dest.i;
+    }
+    /* 6: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var41.i;
+      _dest.x2[1] = var42.i;
+      var40.i = _dest.i;
+    }
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+void
+gst_bayer_interleave_4 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2,
+    const guint8 * ORC_RESTRICT s3, const guint8 * ORC_RESTRICT s4, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcProgram *p = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "gst_bayer_interleave_4");
+      orc_program_set_backup_function (p, _backup_gst_bayer_interleave_4);
+      orc_program_add_destination (p, 4, "d1");
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_source (p, 1, "s2");
+      orc_program_add_source (p, 1, "s3");
+      orc_program_add_source (p, 1, "s4");
+      orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+
+      orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T2, ORC_VAR_S3, ORC_VAR_S4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+
+      orc_program_compile (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gst_bayer_downshift_16 */
+#ifdef DISABLE_ORC
+void
+gst_bayer_downshift_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, int p1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  /* 1: loadpw */
+  var37.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 2: shruw */
+    var39.i = ((orc_uint16) var36.i) >> var37.i;
+    /* 3: convuuswb */
+    var38 = ORC_MIN ((orc_uint16) var39.i, ORC_UB_MAX);
+    /* 4: storeb */
+    ptr0[i] = var38;
+  }
+
+}
+
+#else
+static void
+_backup_gst_bayer_downshift_16 (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  /* 1: loadpw */
+  var37.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 2: shruw */
+    var39.i = ((orc_uint16) var36.i) >> var37.i;
+    /* 3: convuuswb */
+    var38 = ORC_MIN ((orc_uint16) var39.i, ORC_UB_MAX);
+    /* 4: storeb */
+    ptr0[i] = var38;
+  }
+
+}
+
+void
+gst_bayer_downshift_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcProgram *p = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "gst_bayer_downshift_16");
+      orc_program_set_backup_function (p, _backup_gst_bayer_downshift_16);
+      orc_program_add_destination (p, 1, "d1");
+      orc_program_add_source (p, 2, "s1");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_temporary (p, 2, "t1");
+
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convuuswb", 0, ORC_VAR_D1, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+
+      orc_program_compile (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
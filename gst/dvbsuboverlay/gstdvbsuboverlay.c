@@ -23,6 +23,10 @@
  *
  * Renders DVB subtitles on top of a video stream.
  *
+ * Each subtitle page is converted once into premultiplied I420 planes
+ * covering the bounding boxes of its regions, and only those boxes are
+ * blended into the video frames while the page is displayed.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[ FIXME
@@ -39,6 +43,7 @@
 #endif
 
 #include "gstdvbsuboverlay.h"
+#include "gstdvbsuboverlayorc.h"
 
 #include <string.h>
 
@@ -107,6 +112,9 @@ static gboolean gst_dvbsub_overlay_event_video (GstPad * pad, GstEvent * event);
 static gboolean gst_dvbsub_overlay_event_text (GstPad * pad, GstEvent * event);
 static gboolean gst_dvbsub_overlay_event_src (GstPad * pad, GstEvent * event);
 
+static void gst_dvbsub_overlay_set_current_subtitle (GstDVBSubOverlay *
+    overlay, DVBSubtitles * subs);
+
 static void new_dvb_subtitles_cb (DvbSub * dvb_sub, DVBSubtitles * subs,
     gpointer user_data);
 
@@ -167,9 +175,7 @@ gst_dvbsub_overlay_flush_subtitles (GstDVBSubOverlay * render)
     dvb_subtitles_free (subs);
   }
 
-  if (render->current_subtitle)
-    dvb_subtitles_free (render->current_subtitle);
-  render->current_subtitle = NULL;
+  gst_dvbsub_overlay_set_current_subtitle (render, NULL);
 
   if (render->dvb_sub)
     dvb_sub_free (render->dvb_sub);
@@ -231,6 +237,9 @@ gst_dvbsub_overlay_init (GstDVBSubOverlay * render,
 
   render->current_subtitle = NULL;
   render->pending_subtitles = g_queue_new ();
+  render->regions = NULL;
+  render->n_regions = 0;
+  render->page_rendered = FALSE;
 
   render->enable = DEFAULT_ENABLE;
   render->max_page_timeout = DEFAULT_MAX_PAGE_TIMEOUT;
@@ -255,9 +264,7 @@ gst_dvbsub_overlay_finalize (GObject * object)
   }
   g_queue_free (overlay->pending_subtitles);
 
-  if (overlay->current_subtitle)
-    dvb_subtitles_free (overlay->current_subtitle);
-  overlay->current_subtitle = NULL;
+  gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
 
   if (overlay->dvb_sub)
     dvb_sub_free (overlay->dvb_sub);
@@ -432,41 +439,140 @@ gst_dvbsub_overlay_getcaps (GstPad * pad)
 }
 
 static void
-blit_i420 (GstDVBSubOverlay * overlay, DVBSubtitles * subs, GstBuffer * buffer)
+gst_dvbsub_overlay_clear_regions (GstDVBSubOverlay * overlay)
+{
+  guint i;
+
+  /* all planes of a region live in one allocation */
+  for (i = 0; i < overlay->n_regions; i++)
+    g_free (overlay->regions[i].y_data);
+  g_free (overlay->regions);
+  overlay->regions = NULL;
+  overlay->n_regions = 0;
+  overlay->page_rendered = FALSE;
+}
+
+/* takes ownership of subs, must be called with the dvbsub_mutex held */
+static void
+gst_dvbsub_overlay_set_current_subtitle (GstDVBSubOverlay * overlay,
+    DVBSubtitles * subs)
+{
+  if (overlay->current_subtitle)
+    dvb_subtitles_free (overlay->current_subtitle);
+  overlay->current_subtitle = subs;
+  gst_dvbsub_overlay_clear_regions (overlay);
+}
+
+static void
+gst_dvbsub_overlay_render_region (GstDVBSubOverlay * overlay,
+    DVBSubtitleRect * sub_region, gint dx, gint dy, gint dw, gint dh,
+    GstDVBSubOverlayRegion * region)
+{
+  guint8 pal_y[256], pal_a[256];
+  guint16 pal_u[256], pal_v[256];
+  guint32 *acc_a, *acc_u, *acc_v;
+  const guint8 *src;
+  gint32 xstep, ystep;          /* 16.16 fixed point */
+  gint n_colors, src_stride;
+  gint x, y, w, h, cw, ch;
+  gint i;
+
+  xstep = (sub_region->w << 16) / dw;
+  ystep = (sub_region->h << 16) / dh;
+
+  /* premultiply the palette once, all pixels of the region refer to it */
+  memset (pal_a, 0, sizeof (pal_a));
+  memset (pal_y, 0, sizeof (pal_y));
+  memset (pal_u, 0, sizeof (pal_u));
+  memset (pal_v, 0, sizeof (pal_v));
+  n_colors = 1 << MIN (sub_region->pict.palette_bits_count, 8);
+  for (i = 0; i < n_colors; i++) {
+    guint32 color = sub_region->pict.palette[i];
+    guint a = (color >> 24) & 0xff;
+
+    pal_a[i] = a;
+    pal_y[i] = (a * ((color >> 16) & 0xff) + 127) / 255;
+    pal_u[i] = a * ((color >> 8) & 0xff);
+    pal_v[i] = a * (color & 0xff);
+  }
+
+  /* align the bounding box to the chroma grid */
+  region->x = dx & ~1;
+  region->y = dy & ~1;
+  region->w = w = dx + dw - region->x;
+  region->h = h = dy + dh - region->y;
+  cw = (w + 1) / 2;
+  ch = (h + 1) / 2;
+
+  region->y_data = g_malloc (2 * w * h + 3 * cw * ch);
+  region->y_alpha = region->y_data + w * h;
+  region->u_data = region->y_alpha + w * h;
+  region->v_data = region->u_data + cw * ch;
+  region->uv_alpha = region->v_data + cw * ch;
+
+  /* pixels of the box outside of the region stay transparent */
+  memset (region->y_data, 0, w * h);
+  memset (region->y_alpha, 255, w * h);
+
+  acc_a = g_new0 (guint32, 3 * cw * ch);
+  acc_u = acc_a + cw * ch;
+  acc_v = acc_u + cw * ch;
+
+  src = sub_region->pict.data;
+  src_stride = sub_region->pict.rowstride;
+
+  for (y = 0; y < dh; y++) {
+    const guint8 *src_row = src + ((y * ystep) >> 16) * src_stride;
+    gint by = dy - region->y + y;
+    guint8 *y_data = region->y_data + by * w + (dx - region->x);
+    guint8 *y_alpha = region->y_alpha + by * w + (dx - region->x);
+    gint c_row = (by / 2) * cw;
+
+    for (x = 0; x < dw; x++) {
+      guint8 idx = src_row[(x * xstep) >> 16];
+      gint c = c_row + (dx - region->x + x) / 2;
+
+      y_data[x] = pal_y[idx];
+      y_alpha[x] = 255 - pal_a[idx];
+      acc_a[c] += pal_a[idx];
+      acc_u[c] += pal_u[idx];
+      acc_v[c] += pal_v[idx];
+    }
+  }
+
+  /* average each 2x2 block, or what is left of it at the box edges */
+  for (y = 0; y < ch; y++) {
+    gint n_y = MIN (2, h - 2 * y);
+
+    for (x = 0; x < cw; x++) {
+      gint n = n_y * MIN (2, w - 2 * x);
+      gint c = y * cw + x;
+
+      region->u_data[c] = (acc_u[c] / n + 127) / 255;
+      region->v_data[c] = (acc_v[c] / n + 127) / 255;
+      region->uv_alpha[c] = 255 - acc_a[c] / n;
+    }
+  }
+
+  g_free (acc_a);
+}
+
+static void
+gst_dvbsub_overlay_render_page (GstDVBSubOverlay * overlay,
+    DVBSubtitles * subs)
 {
   guint counter;
   DVBSubtitleRect *sub_region;
-  gint a1, a2, a3, a4;
-  gint y1, y2, y3, y4;
-  gint u1, u2, u3, u4;
-  gint v1, v2, v3, v4;
-  guint32 color;
-  const guint8 *src;
-  guint8 *dst_y, *dst_y2, *dst_u, *dst_v;
-  gint x, y;
-  gint w2;
   gint width = overlay->width;
   gint height = overlay->height;
-  gint src_stride;
-  gint y_offset, y_stride;
-  gint u_offset, u_stride;
-  gint v_offset, v_stride;
   gint scale = 0;
   gint scale_x = 0, scale_y = 0;        /* 16.16 fixed point */
 
-  y_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 0, width,
-      height);
-  u_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 1, width,
-      height);
-  v_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 2, width,
-      height);
+  gst_dvbsub_overlay_clear_regions (overlay);
+  overlay->page_rendered = TRUE;
 
-  y_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
-  u_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 1, width);
-  v_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 2, width);
+  if (subs->num_rects == 0 || width <= 0 || height <= 0)
+    return;
 
   if (width != subs->display_def.display_width &&
       height != subs->display_def.display_height) {
@@ -480,16 +586,15 @@ blit_i420 (GstDVBSubOverlay * overlay, DVBSubtitles * subs, GstBuffer * buffer)
     }
   }
 
+  overlay->regions = g_new0 (GstDVBSubOverlayRegion, subs->num_rects);
+
   for (counter = 0; counter < subs->num_rects; counter++) {
     gint dw, dh, dx, dy;
-    gint32 sx = 0, sy;          /* 16.16 fixed point */
-    gint32 xstep, ystep;        /* 16.16 fixed point */
 
     sub_region = &subs->rects[counter];
-    if (sub_region->y > height || sub_region->x > width)
+    if (sub_region->y >= height || sub_region->x >= width)
       continue;
 
-    /* blend subtitles onto the video frame */
     dx = sub_region->x;
     dy = sub_region->y;
     dw = sub_region->w;
@@ -508,164 +613,58 @@ blit_i420 (GstDVBSubOverlay * overlay, DVBSubtitles * subs, GstBuffer * buffer)
     }
 
     dw = MIN (dw, width - dx);
-    dh = MIN (dh, height - dx);
-
-    xstep = (sub_region->w << 16) / dw;
-    ystep = (sub_region->h << 16) / dh;
-
-    w2 = (dw + 1) / 2;
-
-    src_stride = sub_region->pict.rowstride;
-
-    src = sub_region->pict.data;
-    dst_y = buffer->data + y_offset + dy * y_stride + dx;
-    dst_y2 = buffer->data + y_offset + (dy + 1) * y_stride + dx;
-    dst_u = buffer->data + u_offset + ((dy + 1) / 2) * u_stride + (dx + 1) / 2;
-    dst_v = buffer->data + v_offset + ((dy + 1) / 2) * v_stride + (dx + 1) / 2;
-
-    sy = 0;
-    for (y = 0; y < dh - 1; y += 2) {
-      sx = 0;
-      for (x = 0; x < dw - 1; x += 2) {
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + ((sx +
-                        xstep) >> 16)]];
-        a2 = (color >> 24) & 0xff;
-        y2 = (color >> 16) & 0xff;
-        u2 = ((color >> 8) & 0xff) * a2;
-        v2 = (color & 0xff) * a2;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                (sx >> 16)]];
-        a3 = (color >> 24) & 0xff;
-        y3 = (color >> 16) & 0xff;
-        u3 = ((color >> 8) & 0xff) * a3;
-        v3 = (color & 0xff) * a3;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                ((sx + xstep) >> 16)]];
-        a4 = (color >> 24) & 0xff;
-        y4 = (color >> 16) & 0xff;
-        u4 = ((color >> 8) & 0xff) * a4;
-        v4 = (color & 0xff) * a4;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y[1] = (a2 * y2 + (255 - a2) * dst_y[1]) / 255;
-        dst_y2[0] = (a3 * y3 + (255 - a3) * dst_y2[0]) / 255;
-        dst_y2[1] = (a4 * y4 + (255 - a4) * dst_y2[1]) / 255;
-
-        a1 = (a1 + a2 + a3 + a4) / 4;
-        dst_u[0] = ((u1 + u2 + u3 + u4) / 4 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v2 + v3 + v4) / 4 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 2;
-        dst_y2 += 2;
-        dst_u += 1;
-        dst_v += 1;
-        sx += 2 * xstep;
-      }
-
-      /* Odd width */
-      if (x < dw) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                (sx >> 16)]];
-        a3 = (color >> 24) & 0xff;
-        y3 = (color >> 16) & 0xff;
-        u3 = ((color >> 8) & 0xff) * a3;
-        v3 = (color & 0xff) * a3;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y2[0] = (a3 * y3 + (255 - a3) * dst_y2[0]) / 255;
-
-        a1 = (a1 + a3) / 2;
-        dst_u[0] = ((u1 + u3) / 2 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v3) / 2 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 1;
-        dst_y2 += 1;
-        dst_u += 1;
-        dst_v += 1;
-        sx += xstep;
-      }
-
-      sy += 2 * ystep;
+    dh = MIN (dh, height - dy);
+    if (dw <= 0 || dh <= 0)
+      continue;
 
-      dst_y += y_stride + (y_stride - dw);
-      dst_y2 += y_stride + (y_stride - dw);
-      dst_u += u_stride - w2;
-      dst_v += v_stride - w2;
-    }
+    gst_dvbsub_overlay_render_region (overlay, sub_region, dx, dy, dw, dh,
+        &overlay->regions[overlay->n_regions++]);
+  }
 
-    /* Odd height */
-    if (y < dh) {
-      sx = 0;
-      for (x = 0; x < dw - 1; x += 2) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + ((sx +
-                        xstep) >> 16)]];
-        a2 = (color >> 24) & 0xff;
-        y2 = (color >> 16) & 0xff;
-        u2 = ((color >> 8) & 0xff) * a2;
-        v2 = (color & 0xff) * a2;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y[1] = (a2 * y2 + (255 - a2) * dst_y[1]) / 255;
-
-        a1 = (a1 + a2) / 2;
-        dst_u[0] = ((u1 + u2) / 2 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v2) / 2 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 2;
-        dst_u += 1;
-        dst_v += 1;
-        sx += 2 * xstep;
-      }
+  GST_DEBUG_OBJECT (overlay, "pre-rendered %u of %u DVBSubtitleRect",
+      overlay->n_regions, subs->num_rects);
+}
 
-      /* Odd height and width */
-      if (x < dw) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
+static void
+gst_dvbsub_overlay_blend_regions (GstDVBSubOverlay * overlay,
+    GstBuffer * buffer)
+{
+  guint counter;
+  gint width = overlay->width;
+  gint height = overlay->height;
+  gint y_offset, y_stride;
+  gint u_offset, u_stride;
+  gint v_offset, v_stride;
+  guint8 *data = GST_BUFFER_DATA (buffer);
 
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
+  y_offset =
+      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 0, width,
+      height);
+  u_offset =
+      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 1, width,
+      height);
+  v_offset =
+      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 2, width,
+      height);
 
-        dst_u[0] = (u1 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = (v1 + (255 - a1) * dst_v[0]) / 255;
+  y_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
+  u_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 1, width);
+  v_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 2, width);
 
-        dst_y += 1;
-        dst_u += 1;
-        dst_v += 1;
-        sx += xstep;
-      }
-    }
+  for (counter = 0; counter < overlay->n_regions; counter++) {
+    GstDVBSubOverlayRegion *region = &overlay->regions[counter];
+    gint cw = (region->w + 1) / 2;
+    gint ch = (region->h + 1) / 2;
+
+    dvbsub_orc_blend_u8 (data + y_offset + region->y * y_stride + region->x,
+        y_stride, region->y_data, region->w, region->y_alpha, region->w,
+        region->w, region->h);
+    dvbsub_orc_blend_u8 (data + u_offset + (region->y / 2) * u_stride +
+        region->x / 2, u_stride, region->u_data, cw, region->uv_alpha, cw,
+        cw, ch);
+    dvbsub_orc_blend_u8 (data + v_offset + (region->y / 2) * v_stride +
+        region->x / 2, v_stride, region->v_data, cw, region->uv_alpha, cw,
+        cw, ch);
   }
 
   GST_LOG_OBJECT (overlay, "amount of rendered DVBSubtitleRect: %u", counter);
@@ -691,6 +690,11 @@ gst_dvbsub_overlay_setcaps_video (GstPad * pad, GstCaps * caps)
   gst_video_parse_caps_pixel_aspect_ratio (caps, &render->par_n,
       &render->par_d);
 
+  /* the pre-rendered page depends on the video size */
+  g_mutex_lock (render->dvbsub_mutex);
+  gst_dvbsub_overlay_clear_regions (render);
+  g_mutex_unlock (render->dvbsub_mutex);
+
   ret = gst_pad_set_caps (render->srcpad, caps);
   if (!ret)
     goto out;
@@ -881,9 +885,7 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
         break;
       } else if (tmp->num_rects == 0) {
         /* Clear screen */
-        if (overlay->current_subtitle)
-          dvb_subtitles_free (overlay->current_subtitle);
-        overlay->current_subtitle = NULL;
+        gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
         if (candidate)
           dvb_subtitles_free (candidate);
         candidate = NULL;
@@ -910,9 +912,7 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
           GST_TIME_FORMAT ") - it has %u regions",
           GST_TIME_ARGS (vid_running_time), GST_TIME_ARGS (candidate->pts),
           candidate->num_rects);
-      dvb_subtitles_free (overlay->current_subtitle);
-      overlay->current_subtitle = candidate;
-      /* FIXME: Pre-convert current_subtitle to a quick-blend format, num_rects=0 means that there are no regions, e.g, a subtitle "clear" happened */
+      gst_dvbsub_overlay_set_current_subtitle (overlay, candidate);
     }
   }
 
@@ -925,14 +925,18 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
     GST_INFO_OBJECT (overlay,
         "Subtitle page not redefined before fallback page_time_out of %u seconds (missed data?) - deleting current page",
         overlay->current_subtitle->page_time_out);
-    dvb_subtitles_free (overlay->current_subtitle);
-    overlay->current_subtitle = NULL;
+    gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
   }
 
-  /* Now render it */
+  /* Now render it, the page is converted only once while it is shown */
   if (g_atomic_int_get (&overlay->enable) && overlay->current_subtitle) {
-    buffer = gst_buffer_make_writable (buffer);
-    blit_i420 (overlay, overlay->current_subtitle, buffer);
+    if (!overlay->page_rendered)
+      gst_dvbsub_overlay_render_page (overlay, overlay->current_subtitle);
+
+    if (overlay->n_regions > 0) {
+      buffer = gst_buffer_make_writable (buffer);
+      gst_dvbsub_overlay_blend_regions (overlay, buffer);
+    }
   }
   g_mutex_unlock (overlay->dvbsub_mutex);
 
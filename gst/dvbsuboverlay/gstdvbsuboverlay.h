@@ -35,6 +35,18 @@ G_BEGIN_DECLS
 
 typedef struct _GstDVBSubOverlay GstDVBSubOverlay;
 typedef struct _GstDVBSubOverlayClass GstDVBSubOverlayClass;
+typedef struct _GstDVBSubOverlayRegion GstDVBSubOverlayRegion;
+
+/* A subtitle region pre-rendered for the current video size: premultiplied
+ * I420 planes plus the inverted alpha of each plane, covering the bounding
+ * box of the region on the video frame (aligned to the chroma grid) */
+struct _GstDVBSubOverlayRegion
+{
+  gint x, y;
+  gint w, h;
+  guint8 *y_data, *y_alpha;
+  guint8 *u_data, *v_data, *uv_alpha;
+};
 
 struct _GstDVBSubOverlay
 {
@@ -59,6 +71,12 @@ struct _GstDVBSubOverlay
   GQueue *pending_subtitles; /* A queue of raw subtitle region sets with
 			      * metadata that are waiting their running time */
 
+  /* current_subtitle pre-rendered for blending, valid until the page or the
+   * video size changes */
+  GstDVBSubOverlayRegion *regions;
+  guint n_regions;
+  gboolean page_rendered;
+
   GMutex *dvbsub_mutex; /* protects the queue and the DvbSub instance */
   DvbSub *dvb_sub;
 };
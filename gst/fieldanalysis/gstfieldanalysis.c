@@ -53,6 +53,9 @@
  * |[
  * gst-launch -v uridecodebin uri=/path/to/foo.bar ! fieldanalysis ! deinterlace ! ffmpegcolorspace ! autovideosink
  * ]| This pipeline will analyse a video stream with default metrics and thresholds and output progressive frames.
+ * |[
+ * gst-launch -v uridecodebin uri=/path/to/foo.bar ! fieldanalysis n-threads=4 fast-pass=true ! deinterlace ! ffmpegcolorspace ! autovideosink
+ * ]| This pipeline will analyse the bands of lines of each frame on four threads and first estimate the frame metric on subsampled luma.
  * </refsect2>
  */
 
@@ -82,6 +85,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_field_analysis_debug);
 #define DEFAULT_BLOCK_HEIGHT 16
 #define DEFAULT_BLOCK_THRESH 80
 #define DEFAULT_IGNORED_LINES 2
+#define DEFAULT_N_THREADS 1
+#define DEFAULT_FAST_PASS FALSE
+
+#define MAX_THREADS 64
 
 enum
 {
@@ -96,7 +103,9 @@ enum
   PROP_BLOCK_WIDTH,
   PROP_BLOCK_HEIGHT,
   PROP_BLOCK_THRESH,
-  PROP_IGNORED_LINES
+  PROP_IGNORED_LINES,
+  PROP_N_THREADS,
+  PROP_FAST_PASS
 };
 
 static GstStaticPadTemplate sink_factory =
@@ -186,7 +195,7 @@ gst_fieldanalysis_frame_metric_get_type (void)
     static const GEnumValue fieldanalyis_frame_metrics[] = {
       {GST_FIELDANALYSIS_5_TAP, "5-tap [1,-3,4,-3,1] Vertical Filter", "5-tap"},
       {GST_FIELDANALYSIS_WINDOWED_COMB,
-            "Windowed Comb Detection (not optimised)",
+            "Windowed Comb Detection",
           "windowed-comb"},
       {0, NULL, NULL},
     };
@@ -289,6 +298,15 @@ gst_field_analysis_class_init (GstFieldAnalysisClass * klass)
           "Ignore this many lines from the top and bottom for windowed comb detection",
           2, G_MAXUINT64, DEFAULT_IGNORED_LINES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads used to analyse bands of lines of a frame in parallel (1 == no threads)",
+          1, MAX_THREADS, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_FAST_PASS,
+      g_param_spec_boolean ("fast-pass", "Fast pass",
+          "Estimate the 5-tap frame metric on horizontally subsampled luma first and only compute it at full resolution if the estimate is close to the frame threshold (planar formats only)",
+          DEFAULT_FAST_PASS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_field_analysis_change_state);
@@ -303,11 +321,14 @@ static gfloat same_parity_3_tap (GstFieldAnalysis * filter,
 static gfloat opposite_parity_5_tap (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields);
 static guint64 block_score_for_row_32detect (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    guint8 * base_fj, guint8 * base_fjp1, guint8 * comb_mask,
+    guint * block_scores);
 static guint64 block_score_for_row_iscombed (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    guint8 * base_fj, guint8 * base_fjp1, guint8 * comb_mask,
+    guint * block_scores);
 static guint64 block_score_for_row_5_tap (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    guint8 * base_fj, guint8 * base_fjp1, guint8 * comb_mask,
+    guint * block_scores);
 static gfloat opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields);
 
@@ -339,6 +360,7 @@ gst_field_analysis_reset (GstFieldAnalysis * filter)
   filter->comb_mask = NULL;
   g_free (filter->block_scores);
   filter->block_scores = NULL;
+  filter->n_scratch_bands = 0;
 }
 
 static void
@@ -375,6 +397,10 @@ gst_field_analysis_init (GstFieldAnalysis * filter,
   filter->block_height = DEFAULT_BLOCK_HEIGHT;
   filter->block_thresh = DEFAULT_BLOCK_THRESH;
   filter->ignored_lines = DEFAULT_IGNORED_LINES;
+  filter->n_threads = DEFAULT_N_THREADS;
+  filter->fast_pass = DEFAULT_FAST_PASS;
+  filter->pool_lock = g_mutex_new ();
+  filter->pool_cond = g_cond_new ();
 }
 
 static void
@@ -439,18 +465,11 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
       filter->spatial_thresh = g_value_get_int64 (value);
       break;
     case PROP_BLOCK_WIDTH:
+      /* the block scores are reallocated for the new width when needed */
+      GST_OBJECT_LOCK (filter);
       filter->block_width = g_value_get_uint64 (value);
-      if (filter->width) {
-        if (filter->block_scores) {
-          gsize nbytes = (filter->width / filter->block_width) * sizeof (guint);
-          filter->block_scores = g_realloc (filter->block_scores, nbytes);
-          memset (filter->block_scores, 0, nbytes);
-        } else {
-          filter->block_scores =
-              g_malloc0 ((filter->width / filter->block_width) *
-              sizeof (guint));
-        }
-      }
+      filter->n_scratch_bands = 0;
+      GST_OBJECT_UNLOCK (filter);
       break;
     case PROP_BLOCK_HEIGHT:
       filter->block_height = g_value_get_uint64 (value);
@@ -461,6 +480,18 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       filter->ignored_lines = g_value_get_uint64 (value);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (filter);
+      filter->n_threads = g_value_get_uint (value);
+      /* the streaming thread analyses one of the bands itself */
+      if (filter->pool && filter->n_threads > 1)
+        g_thread_pool_set_max_threads (filter->pool, filter->n_threads - 1,
+            NULL);
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    case PROP_FAST_PASS:
+      filter->fast_pass = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -535,6 +566,12 @@ gst_field_analysis_get_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       g_value_set_uint64 (value, filter->ignored_lines);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, filter->n_threads);
+      break;
+    case PROP_FAST_PASS:
+      g_value_set_boolean (value, filter->fast_pass);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -590,20 +627,9 @@ gst_field_analysis_update_format (GstFieldAnalysis * filter, GstCaps * caps)
   filter->sample_incr = sample_incr;
   filter->line_stride = line_stride;
 
-  /* update allocations for metric scores */
-  if (filter->comb_mask) {
-    filter->comb_mask = g_realloc (filter->comb_mask, width);
-  } else {
-    filter->comb_mask = g_malloc (width);
-  }
-  if (filter->block_scores) {
-    gsize nbytes = (width / filter->block_width) * sizeof (guint);
-    filter->block_scores = g_realloc (filter->block_scores, nbytes);
-    memset (filter->block_scores, 0, nbytes);
-  } else {
-    filter->block_scores =
-        g_malloc0 ((width / filter->block_width) * sizeof (guint));
-  }
+  /* the comb masks and block scores are reallocated for the new width when
+   * needed */
+  filter->n_scratch_bands = 0;
 
   GST_OBJECT_UNLOCK (filter);
   return;
@@ -826,11 +852,115 @@ gst_field_analysis_sink_event (GstPad * pad, GstEvent * event)
 }
 
 
-static gfloat
-same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+/* the metrics are computed over bands of consecutive units (field lines or
+ * rows of blocks), each band on a thread of its own if n-threads > 1. a band
+ * function handles the units [first, last) and returns its partial result */
+typedef guint64 (*FieldAnalysisBandFunc) (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, gint first, gint last, guint band);
+
+typedef struct
+{
+  GstFieldAnalysis *filter;
+  FieldAnalysisFields *fields;
+  FieldAnalysisBandFunc func;
+  gint first, last;
+  guint band;
+  guint64 result;
+  gint *pending;
+} FieldAnalysisBand;
+
+static void
+gst_field_analysis_band_func (FieldAnalysisBand * band, gpointer user_data)
+{
+  GstFieldAnalysis *filter = band->filter;
+
+  band->result =
+      band->func (filter, band->fields, band->first, band->last, band->band);
+
+  g_mutex_lock (filter->pool_lock);
+  *band->pending -= 1;
+  if (*band->pending == 0)
+    g_cond_signal (filter->pool_cond);
+  g_mutex_unlock (filter->pool_lock);
+}
+
+/* must be called with the object lock, which the chain function holds for
+ * the whole analysis of a buffer, so that the band count cannot change
+ * between allocating the scratch memory and running the bands */
+static guint
+gst_field_analysis_n_bands (GstFieldAnalysis * filter, gint n_units)
+{
+  return MAX (MIN ((gint) filter->n_threads, n_units), 1);
+}
+
+/* splits @n_units into @n_bands bands, as returned by
+ * gst_field_analysis_n_bands(), and returns the sum of the results of the
+ * bands or, if max is TRUE, the largest one */
+static guint64
+gst_field_analysis_run_bands (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, FieldAnalysisBandFunc func, gint n_units,
+    guint n_bands, gboolean max)
+{
+  FieldAnalysisBand bands[MAX_THREADS];
+  guint64 result;
+  guint i;
+  gint pending;
+
+  if (n_bands > 1 && !filter->pool) {
+    GError *err = NULL;
+
+    /* the streaming thread analyses one of the bands itself */
+    filter->pool =
+        g_thread_pool_new ((GFunc) gst_field_analysis_band_func, NULL,
+        filter->n_threads - 1, FALSE, &err);
+    if (!filter->pool) {
+      GST_WARNING_OBJECT (filter, "Could not create threads: %s",
+          err ? err->message : "unknown error");
+      g_clear_error (&err);
+    }
+  }
+
+  if (n_bands <= 1 || !filter->pool)
+    return func (filter, fields, 0, n_units, 0);
+
+  pending = n_bands - 1;
+  for (i = 0; i < n_bands; i++) {
+    bands[i].filter = filter;
+    bands[i].fields = fields;
+    bands[i].func = func;
+    bands[i].first = (gint64) n_units * i / n_bands;
+    bands[i].last = (gint64) n_units * (i + 1) / n_bands;
+    bands[i].band = i;
+    bands[i].result = 0;
+    bands[i].pending = &pending;
+    if (i > 0)
+      g_thread_pool_push (filter->pool, &bands[i], NULL);
+  }
+
+  bands[0].result = func (filter, fields, bands[0].first, bands[0].last, 0);
+
+  g_mutex_lock (filter->pool_lock);
+  while (pending > 0)
+    g_cond_wait (filter->pool_cond, filter->pool_lock);
+  g_mutex_unlock (filter->pool_lock);
+
+  result = bands[0].result;
+  for (i = 1; i < n_bands; i++) {
+    if (max)
+      result = MAX (result, bands[i].result);
+    else
+      result += bands[i].result;
+  }
+
+  return result;
+}
+
+static guint64
+same_parity_sad_band (GstFieldAnalysis * filter, FieldAnalysisFields * fields,
+    gint first, gint last, guint band)
 {
   gint j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
 
   const gint y_offset = filter->data_offset;
@@ -838,11 +968,13 @@ same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
   const gint stridex2 = stride << 1;
   const guint32 noise_floor = filter->noise_floor;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride +
+      first * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride +
+      first * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = first; j < last; j++) {
     guint32 tempsum = 0;
     orc_same_parity_sad_planar_yuv (&tempsum, f1j, f2j, noise_floor,
         filter->width);
@@ -851,14 +983,27 @@ same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
-  return sum / (0.5f * filter->width * filter->height);
+  return sum;
 }
 
 static gfloat
-same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  sum = gst_field_analysis_run_bands (filter, fields, same_parity_sad_band,
+      filter->height >> 1, gst_field_analysis_n_bands (filter,
+          filter->height >> 1), FALSE);
+
+  return sum / (0.5f * filter->width * filter->height);
+}
+
+static guint64
+same_parity_ssd_band (GstFieldAnalysis * filter, FieldAnalysisFields * fields,
+    gint first, gint last, guint band)
 {
   gint j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
 
   const gint y_offset = filter->data_offset;
@@ -867,11 +1012,13 @@ same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
   /* noise floor needs to be squared for SSD */
   const guint32 noise_floor = filter->noise_floor * filter->noise_floor;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride +
+      first * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride +
+      first * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = first; j < last; j++) {
     guint32 tempsum = 0;
     orc_same_parity_ssd_planar_yuv (&tempsum, f1j, f2j, noise_floor,
         filter->width);
@@ -880,16 +1027,29 @@ same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
+  return sum;
+}
+
+static gfloat
+same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  sum = gst_field_analysis_run_bands (filter, fields, same_parity_ssd_band,
+      filter->height >> 1, gst_field_analysis_n_bands (filter,
+          filter->height >> 1), FALSE);
+
   return sum / (0.5f * filter->width * filter->height); /* field is half height */
 }
 
 /* horizontal [1,4,1] diff between fields - is this a good idea or should the
  * current sample be emphasised more or less? */
-static gfloat
-same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+static guint64
+same_parity_3_tap_band (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, gint first, gint last, guint band)
 {
   gint i, j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
 
   const gint y_offset = filter->data_offset;
@@ -899,11 +1059,13 @@ same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
   /* noise floor needs to be squared for [1,4,1] */
   const guint32 noise_floor = filter->noise_floor * 6;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride +
+      first * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride +
+      first * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = first; j < last; j++) {
     guint32 tempsum = 0;
     guint32 diff;
 
@@ -929,286 +1091,278 @@ same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
+  return sum;
+}
+
+static gfloat
+same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  sum = gst_field_analysis_run_bands (filter, fields, same_parity_3_tap_band,
+      filter->height >> 1, gst_field_analysis_n_bands (filter,
+          filter->height >> 1), FALSE);
+
   return sum / ((6.0f / 2.0f) * filter->width * filter->height);        /* 1 + 4 + 1 = 6; field is half height */
 }
 
+/* fj is line j of the combined frame made from the top field even lines of
+ *   field 0 and the bottom field odd lines from field 1
+ * fjp1 is one line down from fj
+ * fjm2 is two lines up from fj
+ * fj with j == 0 is the 0th line of the top field
+ * fj with j == 1 is the 0th line of the bottom field or the 1st field of
+ *   the frame */
+/* 0th field's parity defines operation */
+static void
+opposite_parity_get_lines (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, guint8 ** fj, guint8 ** fjp1)
+{
+  const gint y_offset = filter->data_offset;
+  const gint stride = filter->line_stride;
+
+  if (fields[0].parity == TOP_FIELD) {
+    *fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
+    *fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
+  } else {
+    *fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
+    *fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
+  }
+}
+
 /* vertical [1,-3,4,-3,1] - same as is used in FieldDiff from TIVTC,
  * tritical's AVISynth IVTC filter */
-/* 0th field's parity defines operation */
-static gfloat
-opposite_parity_5_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+static guint64
+opposite_parity_5_tap_band (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, gint first, gint last, guint band)
 {
   gint j;
-  gfloat sum;
+  guint64 sum;
+  guint8 *base_fj, *base_fjp1;
   guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
   guint32 tempsum;
 
-  const gint y_offset = filter->data_offset;
-  const gint stride = filter->line_stride;
-  const gint stridex2 = stride << 1;
+  const gint stridex2 = filter->line_stride << 1;
+  const gint n_lines = filter->height >> 1;
   /* noise floor needs to be *6 for [1,-3,4,-3,1] */
   const guint32 noise_floor = filter->noise_floor * 6;
 
-  sum = 0.0f;
-
-  /* fj is line j of the combined frame made from the top field even lines of
-   *   field 0 and the bottom field odd lines from field 1
-   * fjp1 is one line down from fj
-   * fjm2 is two lines up from fj
-   * fj with j == 0 is the 0th line of the top field
-   * fj with j == 1 is the 0th line of the bottom field or the 1st field of
-   *   the frame*/
+  opposite_parity_get_lines (filter, fields, &base_fj, &base_fjp1);
+
+  sum = 0;
+  for (j = first; j < last; j++) {
+    fj = base_fj + j * stridex2;
+    fjp1 = base_fjp1 + j * stridex2;
+
+    /* the first and last lines are special cases, the missing lines are
+     * mirrored */
+    if (j == 0) {
+      fjp2 = fj + stridex2;
+      fjm2 = fjp2;
+      fjm1 = fjp1;
+    } else if (j == n_lines - 1) {
+      fjm2 = fj - stridex2;
+      fjm1 = fjp1 - stridex2;
+      fjp1 = fjm1;
+      fjp2 = fjm2;
+    } else {
+      fjm2 = fj - stridex2;
+      fjm1 = fjp1 - stridex2;
+      fjp2 = fj + stridex2;
+    }
 
-  /* unroll first line as it is a special case */
-  if (fields[0].parity == TOP_FIELD) {
-    fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
-    fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
-  } else {
-    fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
-    fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
+    tempsum = 0;
+    orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjp1, fjp2,
+        noise_floor, filter->width);
+    sum += tempsum;
   }
-  fjp2 = fj + stridex2;
 
-  tempsum = 0;
-  orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjp2, fjp1, fj, fjp1, fjp2,
-      noise_floor, filter->width);
-  sum += tempsum;
+  return sum;
+}
+
+/* same as above on every other sample of planar luma */
+static guint64
+opposite_parity_5_tap_subsampled_band (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, gint first, gint last, guint band)
+{
+  gint j;
+  guint64 sum;
+  guint8 *base_fj, *base_fjp1;
+  guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
+  guint32 tempsum;
+
+  const gint stridex2 = filter->line_stride << 1;
+  const gint n_lines = filter->height >> 1;
+  const guint32 noise_floor = filter->noise_floor * 6;
 
-  for (j = 1; j < (filter->height >> 1) - 1; j++) {
-    /* shift everything down a line in the field of interest (means += stridex2) */
-    fjm2 = fj;
-    fjm1 = fjp1;
-    fj = fjp2;
-    fjp1 += stridex2;
-    fjp2 += stridex2;
+  opposite_parity_get_lines (filter, fields, &base_fj, &base_fjp1);
+
+  sum = 0;
+  for (j = first; j < last; j++) {
+    fj = base_fj + j * stridex2;
+    fjp1 = base_fjp1 + j * stridex2;
+
+    if (j == 0) {
+      fjp2 = fj + stridex2;
+      fjm2 = fjp2;
+      fjm1 = fjp1;
+    } else if (j == n_lines - 1) {
+      fjm2 = fj - stridex2;
+      fjm1 = fjp1 - stridex2;
+      fjp1 = fjm1;
+      fjp2 = fjm2;
+    } else {
+      fjm2 = fj - stridex2;
+      fjm1 = fjp1 - stridex2;
+      fjp2 = fj + stridex2;
+    }
 
     tempsum = 0;
-    orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjp1, fjp2,
-        noise_floor, filter->width);
+    orc_opposite_parity_5_tap_subsampled_planar_yuv (&tempsum, fjm2, fjm1, fj,
+        fjp1, fjp2, noise_floor, filter->width >> 1);
     sum += tempsum;
   }
 
-  /* unroll the last line as it is a special case */
-  /* shift everything down a line in the field of interest (means += stridex2) */
-  fjm2 = fj;
-  fjm1 = fjp1;
-  fj = fjp2;
+  return sum;
+}
+
+static gfloat
+opposite_parity_5_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  const gint n_lines = filter->height >> 1;
+  const guint n_bands = gst_field_analysis_n_bands (filter, n_lines);
+
+  /* the frame metric is only ever compared to the frame threshold, so an
+   * estimate made on every other sample is used as is if it is far enough
+   * from the threshold */
+  if (filter->fast_pass && filter->sample_incr == 1 && filter->width >= 2) {
+    gfloat estimate;
+
+    sum = gst_field_analysis_run_bands (filter, fields,
+        opposite_parity_5_tap_subsampled_band, n_lines, n_bands, FALSE);
+    estimate = sum / ((6.0f / 2.0f) * (filter->width >> 1) * filter->height);
+
+    if (estimate <= 0.5f * filter->frame_thresh
+        || estimate > 2.0f * filter->frame_thresh) {
+      GST_LOG_OBJECT (filter, "Using fast pass estimate %f", estimate);
+      return estimate;
+    }
+  }
 
-  tempsum = 0;
-  orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjm1, fjm2,
-      noise_floor, filter->width);
-  sum += tempsum;
+  sum = gst_field_analysis_run_bands (filter, fields,
+      opposite_parity_5_tap_band, n_lines, n_bands, FALSE);
 
   return sum / ((6.0f / 2.0f) * filter->width * filter->height);        /* 1 + 4 + 1 == 3 + 3 == 6; field is half height */
 }
 
-/* this metric was sourced from HandBrake but originally from transcode
- * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_32detect (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+/* a comb mask function sets comb_mask[i] to 1 if sample i of line j is combed
+ * and to 0 otherwise; fjm2..fjp2 are lines j-2..j+2 of the combined frame */
+typedef void (*FieldAnalysisCombMaskFunc) (GstFieldAnalysis * filter,
+    guint8 * comb_mask, guint8 * fjm2, guint8 * fjm1, guint8 * fj,
+    guint8 * fjp1, guint8 * fjp2, gint width);
+
+/* the spatial threshold is clamped to what can make a difference for 8-bit
+ * samples, so that it fits the 16-bit arithmetic of the orc versions */
+#define SPATIAL_THRESH(filter) ((gint) MIN ((filter)->spatial_thresh, 255))
+
+/* this metric was sourced from HandBrake but originally from transcode */
+static void
+comb_mask_32detect (GstFieldAnalysis * filter, guint8 * comb_mask,
+    guint8 * fjm2, guint8 * fjm1, guint8 * fj, guint8 * fjp1, guint8 * fjp2,
+    gint width)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
-  guint8 *fjm2, *fjm1, *fj, *fjp1;
+  gint i;
   const gint incr = filter->sample_incr;
-  const gint stridex2 = filter->line_stride << 1;
-  const guint64 block_width = filter->block_width;
-  const guint64 block_height = filter->block_height;
-  const gint64 spatial_thresh = filter->spatial_thresh;
-  const gint width = filter->width - (filter->width % block_width);
+  const gint spatial_thresh = SPATIAL_THRESH (filter);
 
-  fjm2 = base_fj - stridex2;
-  fjm1 = base_fjp1 - stridex2;
-  fj = base_fj;
-  fjp1 = base_fjp1;
+  if (incr == 1) {
+    orc_comb_mask_32detect_planar_yuv (comb_mask, fjm2, fjm1, fj, fjp1,
+        spatial_thresh, width);
+    return;
+  }
 
-  for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    const gint diff1 = fj[idx] - fjm1[idx];
+    const gint diff2 = fj[idx] - fjp1[idx];
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
     /* change in the same direction */
     if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
         || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] = abs (fj[0] - fjm2[0]) < 10 && abs (fj[0] - fjm1[0]) > 15;
+      comb_mask[i] = abs (fj[idx] - fjm2[idx]) < 10
+          && abs (fj[idx] - fjm1[idx]) > 15;
     } else {
-      comb_mask[0] = FALSE;
+      comb_mask[i] = FALSE;
     }
-
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] = abs (fj[idx] - fjm2[idx]) < 10
-            && abs (fj[idx] - fjm1[idx]) > 15;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
-    }
-    /* advance down a line */
-    fjm2 = fjm1;
-    fjm1 = fj;
-    fj = fjp1;
-    fjp1 = fjm1 + stridex2;
-  }
-
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
   }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
 }
 
 /* this metric was sourced from HandBrake but originally from
- * tritical's isCombedT Avisynth function
- * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_iscombed (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+ * tritical's isCombedT Avisynth function */
+static void
+comb_mask_iscombed (GstFieldAnalysis * filter, guint8 * comb_mask,
+    guint8 * fjm2, guint8 * fjm1, guint8 * fj, guint8 * fjp1, guint8 * fjp2,
+    gint width)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
-  guint8 *fjm1, *fj, *fjp1;
+  gint i;
   const gint incr = filter->sample_incr;
-  const gint stridex2 = filter->line_stride << 1;
-  const guint64 block_width = filter->block_width;
-  const guint64 block_height = filter->block_height;
-  const gint64 spatial_thresh = filter->spatial_thresh;
-  const gint64 spatial_thresh_squared = spatial_thresh * spatial_thresh;
-  const gint width = filter->width - (filter->width % block_width);
+  const gint spatial_thresh = SPATIAL_THRESH (filter);
+  const gint spatial_thresh_squared = spatial_thresh * spatial_thresh;
 
-  fjm1 = base_fjp1 - stridex2;
-  fj = base_fj;
-  fjp1 = base_fjp1;
+  if (incr == 1) {
+    orc_comb_mask_iscombed_planar_yuv (comb_mask, fjm1, fj, fjp1,
+        spatial_thresh, spatial_thresh_squared, width);
+    return;
+  }
 
-  for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    const gint diff1 = fj[idx] - fjm1[idx];
+    const gint diff2 = fj[idx] - fjp1[idx];
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
     /* change in the same direction */
     if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
         || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          (fjm1[0] - fj[0]) * (fjp1[0] - fj[0]) > spatial_thresh_squared;
+      comb_mask[i] =
+          (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
+          spatial_thresh_squared;
     } else {
-      comb_mask[0] = FALSE;
-    }
-
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
-            spatial_thresh_squared;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
+      comb_mask[i] = FALSE;
     }
-    /* advance down a line */
-    fjm1 = fj;
-    fj = fjp1;
-    fjp1 = fjm1 + stridex2;
   }
-
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
-  }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
 }
 
 /* this metric was sourced from HandBrake but originally from
- * tritical's isCombedT Avisynth function
- * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+ * tritical's isCombedT Avisynth function */
+static void
+comb_mask_5_tap (GstFieldAnalysis * filter, guint8 * comb_mask,
+    guint8 * fjm2, guint8 * fjm1, guint8 * fj, guint8 * fjp1, guint8 * fjp2,
+    gint width)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
-  guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
+  gint i;
   const gint incr = filter->sample_incr;
-  const gint stridex2 = filter->line_stride << 1;
-  const guint64 block_width = filter->block_width;
-  const guint64 block_height = filter->block_height;
-  const gint64 spatial_thresh = filter->spatial_thresh;
-  const gint64 spatial_threshx6 = 6 * spatial_thresh;
-  const gint width = filter->width - (filter->width % block_width);
+  const gint spatial_thresh = SPATIAL_THRESH (filter);
+  const gint spatial_threshx6 = 6 * spatial_thresh;
 
-  fjm2 = base_fj - stridex2;
-  fjm1 = base_fjp1 - stridex2;
-  fj = base_fj;
-  fjp1 = base_fjp1;
-  fjp2 = fj + stridex2;
+  if (incr == 1) {
+    orc_comb_mask_5_tap_planar_yuv (comb_mask, fjm2, fjm1, fj, fjp1, fjp2,
+        spatial_thresh, spatial_threshx6, width);
+    return;
+  }
 
-  for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    const gint diff1 = fj[idx] - fjm1[idx];
+    const gint diff2 = fj[idx] - fjp1[idx];
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
     /* change in the same direction */
     if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
         || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          abs (fjm2[0] + (fj[0] << 2) + fjp2[0] - 3 * (fjm1[0] + fjp1[0])) >
-          spatial_threshx6;
+      comb_mask[i] =
+          abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] - 3 * (fjm1[idx] +
+              fjp1[idx])) > spatial_threshx6;
 
       /* motion detection that needs previous and next frames
          this isn't really necessary, but acts as an optimisation if the
@@ -1227,37 +1381,59 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
          }
        */
     } else {
-      comb_mask[0] = FALSE;
+      comb_mask[i] = FALSE;
     }
+  }
+}
 
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] - 3 * (fjm1[idx] +
-                fjp1[idx])) > spatial_threshx6;
-      } else {
-        comb_mask[i] = FALSE;
-      }
+/* the comb mask is computed for each line of a row of blocks and every combed
+ * sample with combed samples to its left and right contributes to the score
+ * of its block. the return value is the highest block score for the row of
+ * blocks */
+static inline guint64
+block_score_for_row (GstFieldAnalysis * filter,
+    FieldAnalysisCombMaskFunc comb_mask_func, guint8 * base_fj,
+    guint8 * base_fjp1, guint8 * comb_mask, guint * block_scores)
+{
+  guint64 b, j;
+  guint64 block_score;
+  guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
+  const gint stridex2 = filter->line_stride << 1;
+  const guint64 block_width = filter->block_width;
+  const guint64 block_height = filter->block_height;
+  const gint width = filter->width - (filter->width % block_width);
+  const guint64 n_blocks = width / block_width;
 
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
+  if (n_blocks == 0 || width < 2)
+    return 0;
+
+  memset (block_scores, 0, n_blocks * sizeof (guint));
+
+  fjm2 = base_fj - stridex2;
+  fjm1 = base_fjp1 - stridex2;
+  fj = base_fj;
+  fjp1 = base_fjp1;
+  fjp2 = fj + stridex2;
+
+  for (j = 0; j < block_height; j++) {
+    gint i = 2;
+
+    comb_mask_func (filter, comb_mask, fjm2, fjm1, fj, fjp1, fjp2, width);
+
+    /* left edge */
+    block_scores[0] += comb_mask[0] & comb_mask[1];
+    /* sample i - 1 is in block (i - 1) / block_width */
+    for (b = 0; b < n_blocks; b++) {
+      const gint end = MIN ((gint) ((b + 1) * block_width) + 1, width);
+      guint score = 0;
+
+      for (; i < end; i++)
+        score += comb_mask[i - 2] & comb_mask[i - 1] & comb_mask[i];
+      block_scores[b] += score;
     }
+    /* right edge */
+    block_scores[n_blocks - 1] += comb_mask[width - 2] & comb_mask[width - 1];
+
     /* advance down a line */
     fjm2 = fjm1;
     fjm1 = fj;
@@ -1267,16 +1443,95 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
   }
 
   block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
+  for (b = 0; b < n_blocks; b++) {
+    if (block_scores[b] > block_score)
+      block_score = block_scores[b];
   }
 
-  g_free (block_scores);
-  g_free (comb_mask);
   return block_score;
 }
 
+static guint64
+block_score_for_row_32detect (GstFieldAnalysis * filter, guint8 * base_fj,
+    guint8 * base_fjp1, guint8 * comb_mask, guint * block_scores)
+{
+  return block_score_for_row (filter, comb_mask_32detect, base_fj, base_fjp1,
+      comb_mask, block_scores);
+}
+
+static guint64
+block_score_for_row_iscombed (GstFieldAnalysis * filter, guint8 * base_fj,
+    guint8 * base_fjp1, guint8 * comb_mask, guint * block_scores)
+{
+  return block_score_for_row (filter, comb_mask_iscombed, base_fj, base_fjp1,
+      comb_mask, block_scores);
+}
+
+static guint64
+block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
+    guint8 * base_fjp1, guint8 * comb_mask, guint * block_scores)
+{
+  return block_score_for_row (filter, comb_mask_5_tap, base_fj, base_fjp1,
+      comb_mask, block_scores);
+}
+
+/* each band of rows of blocks has a comb mask line and a row of block scores
+ * of its own */
+static void
+gst_field_analysis_ensure_scratch (GstFieldAnalysis * filter, guint n_bands)
+{
+  if (filter->n_scratch_bands >= n_bands)
+    return;
+
+  g_free (filter->comb_mask);
+  g_free (filter->block_scores);
+  filter->comb_mask = g_malloc (n_bands * filter->width);
+  filter->block_scores =
+      g_malloc (n_bands * (filter->width / filter->block_width) *
+      sizeof (guint));
+  filter->n_scratch_bands = n_bands;
+}
+
+/* returns 2 if a row of blocks in the band is combed, 1 if one is slightly
+ * combed and 0 otherwise */
+static guint64
+opposite_parity_windowed_comb_band (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields, gint first, gint last, guint band)
+{
+  gint j;
+  guint64 result;
+  guint8 *base_fj, *base_fjp1;
+  guint8 *comb_mask;
+  guint *block_scores;
+
+  const gint stride = filter->line_stride;
+  const guint64 block_thresh = filter->block_thresh;
+  const guint64 block_height = filter->block_height;
+
+  opposite_parity_get_lines (filter, fields, &base_fj, &base_fjp1);
+  comb_mask = filter->comb_mask + band * filter->width;
+  block_scores =
+      filter->block_scores + band * (filter->width / filter->block_width);
+
+  /* we operate on a row of blocks of height block_height through each iteration */
+  result = 0;
+  for (j = first; j < last; j++) {
+    guint64 line_offset = (filter->ignored_lines + j * block_height) * stride;
+    guint64 block_score =
+        filter->block_score_for_row (filter, base_fj + line_offset,
+        base_fjp1 + line_offset, comb_mask, block_scores);
+
+    if (block_score > block_thresh) {
+      return 2;
+    } else if (block_score > (block_thresh >> 1)) {
+      /* blend if nothing more combed comes along */
+      result = 1;
+    }
+  }
+
+  return result;
+}
+
 /* a pass is made over the field using one of three comb-detection metrics
    and the results are then analysed block-wise. if the samples to the left
    and right are combed, they contribute to the block score. if the block
@@ -1284,56 +1539,42 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
    score is between half the threshold and the threshold, the block is
    slightly combed. if when analysis is complete, slight combing is detected
    that is returned. if any results are observed that are above the threshold,
-   the function returns immediately */
+   the band stops immediately */
 /* 0th field's parity defines operation */
 static gfloat
 opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields)
 {
-  gint j;
-  gboolean slightly_combed;
+  gint n_rows = 0;
+  guint n_bands;
+  guint64 combed;
 
-  const gint y_offset = filter->data_offset;
-  const gint stride = filter->line_stride;
-  const guint64 block_thresh = filter->block_thresh;
   const guint64 block_height = filter->block_height;
-  guint8 *base_fj, *base_fjp1;
 
-  if (fields[0].parity == TOP_FIELD) {
-    base_fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
-    base_fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
-  } else {
-    base_fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
-    base_fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
-  }
+  if (block_height > 0 && filter->block_width > 0
+      && filter->height >= filter->ignored_lines + block_height)
+    n_rows = (filter->height - filter->ignored_lines - block_height) /
+        block_height + 1;
 
-  /* we operate on a row of blocks of height block_height through each iteration */
-  slightly_combed = FALSE;
-  for (j = 0; j <= filter->height - filter->ignored_lines - block_height;
-      j += block_height) {
-    guint64 line_offset = (filter->ignored_lines + j) * stride;
-    guint block_score =
-        filter->block_score_for_row (filter, base_fj + line_offset,
-        base_fjp1 + line_offset);
+  n_bands = gst_field_analysis_n_bands (filter, n_rows);
+  gst_field_analysis_ensure_scratch (filter, n_bands);
 
-    if (block_score > (block_thresh >> 1)
-        && block_score <= block_thresh) {
-      /* blend if nothing more combed comes along */
-      slightly_combed = TRUE;
-    } else if (block_score > block_thresh) {
-      GstCaps *caps = GST_BUFFER_CAPS (fields[0].buf);
-      GstStructure *struc = gst_caps_get_structure (caps, 0);
-      gboolean interlaced;
-      if (gst_structure_get_boolean (struc, "interlaced", &interlaced)
-          && interlaced == TRUE) {
-        return 1.0f;            /* blend */
-      } else {
-        return 2.0f;            /* deinterlace */
-      }
+  combed = gst_field_analysis_run_bands (filter, fields,
+      opposite_parity_windowed_comb_band, n_rows, n_bands, TRUE);
+
+  if (combed == 2) {
+    GstCaps *caps = GST_BUFFER_CAPS (fields[0].buf);
+    GstStructure *struc = gst_caps_get_structure (caps, 0);
+    gboolean interlaced;
+    if (gst_structure_get_boolean (struc, "interlaced", &interlaced)
+        && interlaced == TRUE) {
+      return 1.0f;              /* blend */
+    } else {
+      return 2.0f;              /* deinterlace */
     }
   }
 
-  return (gfloat) slightly_combed;      /* TRUE means blend, else don't */
+  return (gfloat) combed;       /* 1 means blend, else don't */
 }
 
 /* this is where the magic happens
@@ -1789,6 +2030,11 @@ gst_field_analysis_finalize (GObject * object)
   gst_field_analysis_reset (filter);
   g_queue_free (filter->frames);
 
+  if (filter->pool)
+    g_thread_pool_free (filter->pool, FALSE, TRUE);
+  g_cond_free (filter->pool_cond);
+  g_mutex_free (filter->pool_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -115,12 +115,15 @@ struct _GstFieldAnalysis
   FieldAnalysis results[2];
   gfloat (*same_field) (GstFieldAnalysis *, FieldAnalysisFields *);
   gfloat (*same_frame) (GstFieldAnalysis *, FieldAnalysisFields *);
-  guint64 (*block_score_for_row) (GstFieldAnalysis *, guint8 *, guint8 *);
+  guint64 (*block_score_for_row) (GstFieldAnalysis *, guint8 *, guint8 *,
+      guint8 *, guint *);
   gboolean is_telecine;
   gboolean first_buffer; /* indicates the first buffer for which a buffer will be output
                           * after a discont or flushing seek */
+  /* one comb mask line and one row of block scores per band */
   guint8 *comb_mask;
   guint *block_scores;
+  guint n_scratch_bands;
   gboolean flushing;     /* indicates whether we are flushing or not */
 
   /* properties */
@@ -131,6 +134,13 @@ struct _GstFieldAnalysis
   guint64 block_width, block_height; /* width/height of window used for comb clusted detection */
   guint64 block_thresh;
   guint64 ignored_lines;
+  guint n_threads;
+  gboolean fast_pass; /* estimate the 5-tap frame metric on subsampled luma first */
+
+  /* bands of lines are analysed in parallel if n_threads > 1 */
+  GThreadPool *pool;
+  GMutex *pool_lock;
+  GCond *pool_cond;
 };
 
 struct _GstFieldAnalysisClass
@@ -97,6 +97,21 @@ void orc_opposite_parity_5_tap_planar_yuv (guint32 * ORC_RESTRICT a1,
     const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
     const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
     const orc_uint8 * ORC_RESTRICT s5, int p2, int n);
+void orc_opposite_parity_5_tap_subsampled_planar_yuv (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int n);
+void orc_comb_mask_5_tap_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n);
+void orc_comb_mask_iscombed_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n);
+void orc_comb_mask_32detect_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n);
 
 void gst_fieldanalysis_orc_init (void);
 
@@ -868,150 +883,1319 @@ orc_opposite_parity_5_tap_planar_yuv (guint32 * ORC_RESTRICT a1,
 #endif
 
 
+/* orc_opposite_parity_5_tap_subsampled_planar_yuv */
+#ifdef DISABLE_ORC
 void
-gst_fieldanalysis_orc_init (void)
+orc_opposite_parity_5_tap_subsampled_planar_yuv (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int n)
 {
-#ifndef DISABLE_ORC
-  {
-    /* orc_same_parity_sad_planar_yuv */
-    OrcProgram *p;
+  int i;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union32 var12 = { 0 };
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_int8 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union32 var67;
+
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+
+  /* 16: loadpw */
+  var49.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 18: loadpw */
+  var50.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 26: loadpl */
+  var51.i = p1;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_sad_planar_yuv");
-    orc_program_set_backup_function (p, _backup_orc_same_parity_sad_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 4, "t3");
-    orc_program_add_temporary (p, 4, "t4");
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var39 = ptr4[i];
+    /* 1: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var39.i;
+      var44 = _src.x2[0];
+    }
+    /* 2: convubw */
+    var52.i = (orc_uint8) var44;
+    /* 3: loadw */
+    var40 = ptr5[i];
+    /* 4: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var40.i;
+      var45 = _src.x2[0];
+    }
+    /* 5: convubw */
+    var53.i = (orc_uint8) var45;
+    /* 6: loadw */
+    var41 = ptr6[i];
+    /* 7: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var41.i;
+      var46 = _src.x2[0];
+    }
+    /* 8: convubw */
+    var54.i = (orc_uint8) var46;
+    /* 9: loadw */
+    var42 = ptr7[i];
+    /* 10: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var42.i;
+      var47 = _src.x2[0];
+    }
+    /* 11: convubw */
+    var55.i = (orc_uint8) var47;
+    /* 12: loadw */
+    var43 = ptr8[i];
+    /* 13: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var43.i;
+      var48 = _src.x2[0];
+    }
+    /* 14: convubw */
+    var56.i = (orc_uint8) var48;
+    /* 15: shlw */
+    var57.i = var54.i << 2;
+    /* 17: mullw */
+    var58.i = (var53.i * var49.i) & 0xffff;
+    /* 19: mullw */
+    var59.i = (var55.i * var50.i) & 0xffff;
+    /* 20: subw */
+    var60.i = var52.i - var58.i;
+    /* 21: addw */
+    var61.i = var60.i + var57.i;
+    /* 22: subw */
+    var62.i = var61.i - var59.i;
+    /* 23: addw */
+    var63.i = var62.i + var56.i;
+    /* 24: absw */
+    var64.i = ORC_ABS (var63.i);
+    /* 25: convuwl */
+    var65.i = (orc_uint16) var64.i;
+    /* 27: cmpgtsl */
+    var66.i = (var65.i > var51.i) ? (~0) : 0;
+    /* 28: andl */
+    var67.i = var65.i & var66.i;
+    /* 29: accl */
+    var12.i = var12.i + var67.i;
+  }
+  *a1 = var12.i;
 
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
-        ORC_VAR_D1);
+}
 
-    orc_program_compile (p);
+#else
+static void
+_backup_orc_opposite_parity_5_tap_subsampled_planar_yuv (OrcExecutor *
+    ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union32 var12 = { 0 };
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_int8 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union32 var65;
+  orc_union32 var66;
+  orc_union32 var67;
+
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+
+  /* 16: loadpw */
+  var49.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 18: loadpw */
+  var50.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 26: loadpl */
+  var51.i = ex->params[24];
 
-    _orc_program_orc_same_parity_sad_planar_yuv = p;
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var39 = ptr4[i];
+    /* 1: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var39.i;
+      var44 = _src.x2[0];
+    }
+    /* 2: convubw */
+    var52.i = (orc_uint8) var44;
+    /* 3: loadw */
+    var40 = ptr5[i];
+    /* 4: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var40.i;
+      var45 = _src.x2[0];
+    }
+    /* 5: convubw */
+    var53.i = (orc_uint8) var45;
+    /* 6: loadw */
+    var41 = ptr6[i];
+    /* 7: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var41.i;
+      var46 = _src.x2[0];
+    }
+    /* 8: convubw */
+    var54.i = (orc_uint8) var46;
+    /* 9: loadw */
+    var42 = ptr7[i];
+    /* 10: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var42.i;
+      var47 = _src.x2[0];
+    }
+    /* 11: convubw */
+    var55.i = (orc_uint8) var47;
+    /* 12: loadw */
+    var43 = ptr8[i];
+    /* 13: select0wb */
+    {
+      orc_union16 _src;
+      _src.i = var43.i;
+      var48 = _src.x2[0];
+    }
+    /* 14: convubw */
+    var56.i = (orc_uint8) var48;
+    /* 15: shlw */
+    var57.i = var54.i << 2;
+    /* 17: mullw */
+    var58.i = (var53.i * var49.i) & 0xffff;
+    /* 19: mullw */
+    var59.i = (var55.i * var50.i) & 0xffff;
+    /* 20: subw */
+    var60.i = var52.i - var58.i;
+    /* 21: addw */
+    var61.i = var60.i + var57.i;
+    /* 22: subw */
+    var62.i = var61.i - var59.i;
+    /* 23: addw */
+    var63.i = var62.i + var56.i;
+    /* 24: absw */
+    var64.i = ORC_ABS (var63.i);
+    /* 25: convuwl */
+    var65.i = (orc_uint16) var64.i;
+    /* 27: cmpgtsl */
+    var66.i = (var65.i > var51.i) ? (~0) : 0;
+    /* 28: andl */
+    var67.i = var65.i & var66.i;
+    /* 29: accl */
+    var12.i = var12.i + var67.i;
   }
-  {
-    /* orc_same_parity_ssd_planar_yuv */
-    OrcProgram *p;
+  ex->accumulators[0] = var12.i;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_ssd_planar_yuv");
-    orc_program_set_backup_function (p, _backup_orc_same_parity_ssd_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 4, "t3");
-    orc_program_add_temporary (p, 4, "t4");
+}
 
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_T1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
-        ORC_VAR_D1);
+static OrcProgram *_orc_program_orc_opposite_parity_5_tap_subsampled_planar_yuv;
+void
+orc_opposite_parity_5_tap_subsampled_planar_yuv (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_opposite_parity_5_tap_subsampled_planar_yuv;
+  void (*func) (OrcExecutor *);
 
-    orc_program_compile (p);
+  ex->program = p;
 
-    _orc_program_orc_same_parity_ssd_planar_yuv = p;
-  }
-  {
-    /* orc_same_parity_3_tap_planar_yuv */
-    OrcProgram *p;
+  ex->n = n;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->params[ORC_VAR_P1] = p1;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_3_tap_planar_yuv");
-    orc_program_set_backup_function (p,
-        _backup_orc_same_parity_3_tap_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_source (p, 1, "s3");
-    orc_program_add_source (p, 1, "s4");
-    orc_program_add_source (p, 1, "s5");
-    orc_program_add_source (p, 1, "s6");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_constant (p, 4, 0x00000002, "c1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 2, "t3");
-    orc_program_add_temporary (p, 2, "t4");
-    orc_program_add_temporary (p, 2, "t5");
-    orc_program_add_temporary (p, 2, "t6");
-    orc_program_add_temporary (p, 4, "t7");
-    orc_program_add_temporary (p, 4, "t8");
+  func = p->code_exec;
+  func (ex);
+  *a1 = orc_executor_get_accumulator (ex, ORC_VAR_A1);
+}
+#endif
 
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_S6, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T6,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T7, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T7, ORC_VAR_D1,
-        ORC_VAR_D1);
+/* orc_comb_mask_5_tap_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_mask_5_tap_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_union16 var74;
+  orc_union16 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_int8 var78;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+  ptr8 = (orc_int8 *) s5;
 
-    orc_program_compile (p);
+  /* 12: loadpw */
+  var45.i = p1;
+  /* 14: loadpw */
+  var46.i = p1;
+  /* 19: loadpw */
+  var47.i = p1;
+  /* 21: loadpw */
+  var48.i = p1;
+  /* 29: loadpw */
+  var49.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 33: loadpw */
+  var50.i = p2;
+  /* 36: loadpw */
+  var51.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
 
-    _orc_program_orc_same_parity_3_tap_planar_yuv = p;
-  }
-  {
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var40 = ptr4[i];
+    /* 1: convubw */
+    var52.i = (orc_uint8) var40;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var53.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var42 = ptr6[i];
+    /* 5: convubw */
+    var54.i = (orc_uint8) var42;
+    /* 6: loadb */
+    var43 = ptr7[i];
+    /* 7: convubw */
+    var55.i = (orc_uint8) var43;
+    /* 8: loadb */
+    var44 = ptr8[i];
+    /* 9: convubw */
+    var56.i = (orc_uint8) var44;
+    /* 10: subw */
+    var57.i = var54.i - var53.i;
+    /* 11: subw */
+    var58.i = var54.i - var55.i;
+    /* 13: cmpgtsw */
+    var59.i = (var57.i > var45.i) ? (~0) : 0;
+    /* 15: cmpgtsw */
+    var60.i = (var58.i > var46.i) ? (~0) : 0;
+    /* 16: andw */
+    var61.i = var59.i & var60.i;
+    /* 17: subw */
+    var62.i = var53.i - var54.i;
+    /* 18: subw */
+    var63.i = var55.i - var54.i;
+    /* 20: cmpgtsw */
+    var64.i = (var62.i > var47.i) ? (~0) : 0;
+    /* 22: cmpgtsw */
+    var65.i = (var63.i > var48.i) ? (~0) : 0;
+    /* 23: andw */
+    var66.i = var64.i & var65.i;
+    /* 24: orw */
+    var67.i = var61.i | var66.i;
+    /* 25: addw */
+    var68.i = var52.i + var56.i;
+    /* 26: shlw */
+    var69.i = var54.i << 2;
+    /* 27: addw */
+    var70.i = var68.i + var69.i;
+    /* 28: addw */
+    var71.i = var53.i + var55.i;
+    /* 30: mullw */
+    var72.i = (var71.i * var49.i) & 0xffff;
+    /* 31: subw */
+    var73.i = var70.i - var72.i;
+    /* 32: absw */
+    var74.i = ORC_ABS (var73.i);
+    /* 34: cmpgtsw */
+    var75.i = (var74.i > var50.i) ? (~0) : 0;
+    /* 35: andw */
+    var76.i = var67.i & var75.i;
+    /* 37: andw */
+    var77.i = var76.i & var51.i;
+    /* 38: convwb */
+    var78 = var77.i;
+    /* 39: storeb */
+    ptr0[i] = var78;
+  }
+
+}
+
+#else
+static void
+_backup_orc_comb_mask_5_tap_planar_yuv (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_union16 var74;
+  orc_union16 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_int8 var78;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+  ptr8 = (orc_int8 *) ex->arrays[8];
+
+  /* 12: loadpw */
+  var45.i = ex->params[24];
+  /* 14: loadpw */
+  var46.i = ex->params[24];
+  /* 19: loadpw */
+  var47.i = ex->params[24];
+  /* 21: loadpw */
+  var48.i = ex->params[24];
+  /* 29: loadpw */
+  var49.i = (int) 0x00000003;   /* 3 or 1.4822e-323f */
+  /* 33: loadpw */
+  var50.i = ex->params[25];
+  /* 36: loadpw */
+  var51.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var40 = ptr4[i];
+    /* 1: convubw */
+    var52.i = (orc_uint8) var40;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var53.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var42 = ptr6[i];
+    /* 5: convubw */
+    var54.i = (orc_uint8) var42;
+    /* 6: loadb */
+    var43 = ptr7[i];
+    /* 7: convubw */
+    var55.i = (orc_uint8) var43;
+    /* 8: loadb */
+    var44 = ptr8[i];
+    /* 9: convubw */
+    var56.i = (orc_uint8) var44;
+    /* 10: subw */
+    var57.i = var54.i - var53.i;
+    /* 11: subw */
+    var58.i = var54.i - var55.i;
+    /* 13: cmpgtsw */
+    var59.i = (var57.i > var45.i) ? (~0) : 0;
+    /* 15: cmpgtsw */
+    var60.i = (var58.i > var46.i) ? (~0) : 0;
+    /* 16: andw */
+    var61.i = var59.i & var60.i;
+    /* 17: subw */
+    var62.i = var53.i - var54.i;
+    /* 18: subw */
+    var63.i = var55.i - var54.i;
+    /* 20: cmpgtsw */
+    var64.i = (var62.i > var47.i) ? (~0) : 0;
+    /* 22: cmpgtsw */
+    var65.i = (var63.i > var48.i) ? (~0) : 0;
+    /* 23: andw */
+    var66.i = var64.i & var65.i;
+    /* 24: orw */
+    var67.i = var61.i | var66.i;
+    /* 25: addw */
+    var68.i = var52.i + var56.i;
+    /* 26: shlw */
+    var69.i = var54.i << 2;
+    /* 27: addw */
+    var70.i = var68.i + var69.i;
+    /* 28: addw */
+    var71.i = var53.i + var55.i;
+    /* 30: mullw */
+    var72.i = (var71.i * var49.i) & 0xffff;
+    /* 31: subw */
+    var73.i = var70.i - var72.i;
+    /* 32: absw */
+    var74.i = ORC_ABS (var73.i);
+    /* 34: cmpgtsw */
+    var75.i = (var74.i > var50.i) ? (~0) : 0;
+    /* 35: andw */
+    var76.i = var67.i & var75.i;
+    /* 37: andw */
+    var77.i = var76.i & var51.i;
+    /* 38: convwb */
+    var78 = var77.i;
+    /* 39: storeb */
+    ptr0[i] = var78;
+  }
+
+}
+
+static OrcProgram *_orc_program_orc_comb_mask_5_tap_planar_yuv;
+void
+orc_comb_mask_5_tap_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_5_tap_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+/* orc_comb_mask_iscombed_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_mask_iscombed_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_int8 var69;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  /* 8: loadpw */
+  var44.i = p1;
+  /* 10: loadpw */
+  var45.i = p1;
+  /* 15: loadpw */
+  var46.i = p1;
+  /* 17: loadpw */
+  var47.i = p1;
+  /* 22: loadpl */
+  var48.i = p2;
+  /* 26: loadpw */
+  var49.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var41 = ptr4[i];
+    /* 1: convubw */
+    var50.i = (orc_uint8) var41;
+    /* 2: loadb */
+    var42 = ptr5[i];
+    /* 3: convubw */
+    var51.i = (orc_uint8) var42;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var52.i = (orc_uint8) var43;
+    /* 6: subw */
+    var53.i = var51.i - var50.i;
+    /* 7: subw */
+    var54.i = var51.i - var52.i;
+    /* 9: cmpgtsw */
+    var55.i = (var53.i > var44.i) ? (~0) : 0;
+    /* 11: cmpgtsw */
+    var56.i = (var54.i > var45.i) ? (~0) : 0;
+    /* 12: andw */
+    var57.i = var55.i & var56.i;
+    /* 13: subw */
+    var58.i = var50.i - var51.i;
+    /* 14: subw */
+    var59.i = var52.i - var51.i;
+    /* 16: cmpgtsw */
+    var60.i = (var58.i > var46.i) ? (~0) : 0;
+    /* 18: cmpgtsw */
+    var61.i = (var59.i > var47.i) ? (~0) : 0;
+    /* 19: andw */
+    var62.i = var60.i & var61.i;
+    /* 20: orw */
+    var63.i = var57.i | var62.i;
+    /* 21: mulswl */
+    var64.i = var58.i * var59.i;
+    /* 23: cmpgtsl */
+    var65.i = (var64.i > var48.i) ? (~0) : 0;
+    /* 24: convlw */
+    var66.i = var65.i;
+    /* 25: andw */
+    var67.i = var63.i & var66.i;
+    /* 27: andw */
+    var68.i = var67.i & var49.i;
+    /* 28: convwb */
+    var69 = var68.i;
+    /* 29: storeb */
+    ptr0[i] = var69;
+  }
+
+}
+
+#else
+static void
+_backup_orc_comb_mask_iscombed_planar_yuv (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union32 var64;
+  orc_union32 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_int8 var69;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  /* 8: loadpw */
+  var44.i = ex->params[24];
+  /* 10: loadpw */
+  var45.i = ex->params[24];
+  /* 15: loadpw */
+  var46.i = ex->params[24];
+  /* 17: loadpw */
+  var47.i = ex->params[24];
+  /* 22: loadpl */
+  var48.i = ex->params[25];
+  /* 26: loadpw */
+  var49.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var41 = ptr4[i];
+    /* 1: convubw */
+    var50.i = (orc_uint8) var41;
+    /* 2: loadb */
+    var42 = ptr5[i];
+    /* 3: convubw */
+    var51.i = (orc_uint8) var42;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var52.i = (orc_uint8) var43;
+    /* 6: subw */
+    var53.i = var51.i - var50.i;
+    /* 7: subw */
+    var54.i = var51.i - var52.i;
+    /* 9: cmpgtsw */
+    var55.i = (var53.i > var44.i) ? (~0) : 0;
+    /* 11: cmpgtsw */
+    var56.i = (var54.i > var45.i) ? (~0) : 0;
+    /* 12: andw */
+    var57.i = var55.i & var56.i;
+    /* 13: subw */
+    var58.i = var50.i - var51.i;
+    /* 14: subw */
+    var59.i = var52.i - var51.i;
+    /* 16: cmpgtsw */
+    var60.i = (var58.i > var46.i) ? (~0) : 0;
+    /* 18: cmpgtsw */
+    var61.i = (var59.i > var47.i) ? (~0) : 0;
+    /* 19: andw */
+    var62.i = var60.i & var61.i;
+    /* 20: orw */
+    var63.i = var57.i | var62.i;
+    /* 21: mulswl */
+    var64.i = var58.i * var59.i;
+    /* 23: cmpgtsl */
+    var65.i = (var64.i > var48.i) ? (~0) : 0;
+    /* 24: convlw */
+    var66.i = var65.i;
+    /* 25: andw */
+    var67.i = var63.i & var66.i;
+    /* 27: andw */
+    var68.i = var67.i & var49.i;
+    /* 28: convwb */
+    var69 = var68.i;
+    /* 29: storeb */
+    ptr0[i] = var69;
+  }
+
+}
+
+static OrcProgram *_orc_program_orc_comb_mask_iscombed_planar_yuv;
+void
+orc_comb_mask_iscombed_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_iscombed_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+/* orc_comb_mask_32detect_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_mask_32detect_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var39;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_int8 var74;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+
+  /* 10: loadpw */
+  var43.i = p1;
+  /* 12: loadpw */
+  var44.i = p1;
+  /* 17: loadpw */
+  var45.i = p1;
+  /* 19: loadpw */
+  var46.i = p1;
+  /* 25: loadpw */
+  var47.i = (int) 0x00000009;   /* 9 or 4.44659e-323f */
+  /* 27: loadpw */
+  var48.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
+  /* 32: loadpw */
+  var49.i = (int) 0x0000000f;   /* 15 or 7.41098e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var50.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var40 = ptr5[i];
+    /* 3: convubw */
+    var51.i = (orc_uint8) var40;
+    /* 4: loadb */
+    var41 = ptr6[i];
+    /* 5: convubw */
+    var52.i = (orc_uint8) var41;
+    /* 6: loadb */
+    var42 = ptr7[i];
+    /* 7: convubw */
+    var53.i = (orc_uint8) var42;
+    /* 8: subw */
+    var54.i = var52.i - var51.i;
+    /* 9: subw */
+    var55.i = var52.i - var53.i;
+    /* 11: cmpgtsw */
+    var56.i = (var54.i > var43.i) ? (~0) : 0;
+    /* 13: cmpgtsw */
+    var57.i = (var55.i > var44.i) ? (~0) : 0;
+    /* 14: andw */
+    var58.i = var56.i & var57.i;
+    /* 15: subw */
+    var59.i = var51.i - var52.i;
+    /* 16: subw */
+    var60.i = var53.i - var52.i;
+    /* 18: cmpgtsw */
+    var61.i = (var59.i > var45.i) ? (~0) : 0;
+    /* 20: cmpgtsw */
+    var62.i = (var60.i > var46.i) ? (~0) : 0;
+    /* 21: andw */
+    var63.i = var61.i & var62.i;
+    /* 22: orw */
+    var64.i = var58.i | var63.i;
+    /* 23: subw */
+    var65.i = var52.i - var50.i;
+    /* 24: absw */
+    var66.i = ORC_ABS (var65.i);
+    /* 26: cmpgtsw */
+    var67.i = (var66.i > var47.i) ? (~0) : 0;
+    /* 28: addw */
+    var68.i = var67.i + var48.i;
+    /* 29: andw */
+    var69.i = var64.i & var68.i;
+    /* 30: subw */
+    var70.i = var52.i - var51.i;
+    /* 31: absw */
+    var71.i = ORC_ABS (var70.i);
+    /* 33: cmpgtsw */
+    var72.i = (var71.i > var49.i) ? (~0) : 0;
+    /* 34: andw */
+    var73.i = var69.i & var72.i;
+    /* 35: convwb */
+    var74 = var73.i;
+    /* 36: storeb */
+    ptr0[i] = var74;
+  }
+
+}
+
+#else
+static void
+_backup_orc_comb_mask_32detect_planar_yuv (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var39;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_int8 var74;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+
+  /* 10: loadpw */
+  var43.i = ex->params[24];
+  /* 12: loadpw */
+  var44.i = ex->params[24];
+  /* 17: loadpw */
+  var45.i = ex->params[24];
+  /* 19: loadpw */
+  var46.i = ex->params[24];
+  /* 25: loadpw */
+  var47.i = (int) 0x00000009;   /* 9 or 4.44659e-323f */
+  /* 27: loadpw */
+  var48.i = (int) 0x00000001;   /* 1 or 4.94066e-324f */
+  /* 32: loadpw */
+  var49.i = (int) 0x0000000f;   /* 15 or 7.41098e-323f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var50.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var40 = ptr5[i];
+    /* 3: convubw */
+    var51.i = (orc_uint8) var40;
+    /* 4: loadb */
+    var41 = ptr6[i];
+    /* 5: convubw */
+    var52.i = (orc_uint8) var41;
+    /* 6: loadb */
+    var42 = ptr7[i];
+    /* 7: convubw */
+    var53.i = (orc_uint8) var42;
+    /* 8: subw */
+    var54.i = var52.i - var51.i;
+    /* 9: subw */
+    var55.i = var52.i - var53.i;
+    /* 11: cmpgtsw */
+    var56.i = (var54.i > var43.i) ? (~0) : 0;
+    /* 13: cmpgtsw */
+    var57.i = (var55.i > var44.i) ? (~0) : 0;
+    /* 14: andw */
+    var58.i = var56.i & var57.i;
+    /* 15: subw */
+    var59.i = var51.i - var52.i;
+    /* 16: subw */
+    var60.i = var53.i - var52.i;
+    /* 18: cmpgtsw */
+    var61.i = (var59.i > var45.i) ? (~0) : 0;
+    /* 20: cmpgtsw */
+    var62.i = (var60.i > var46.i) ? (~0) : 0;
+    /* 21: andw */
+    var63.i = var61.i & var62.i;
+    /* 22: orw */
+    var64.i = var58.i | var63.i;
+    /* 23: subw */
+    var65.i = var52.i - var50.i;
+    /* 24: absw */
+    var66.i = ORC_ABS (var65.i);
+    /* 26: cmpgtsw */
+    var67.i = (var66.i > var47.i) ? (~0) : 0;
+    /* 28: addw */
+    var68.i = var67.i + var48.i;
+    /* 29: andw */
+    var69.i = var64.i & var68.i;
+    /* 30: subw */
+    var70.i = var52.i - var51.i;
+    /* 31: absw */
+    var71.i = ORC_ABS (var70.i);
+    /* 33: cmpgtsw */
+    var72.i = (var71.i > var49.i) ? (~0) : 0;
+    /* 34: andw */
+    var73.i = var69.i & var72.i;
+    /* 35: convwb */
+    var74 = var73.i;
+    /* 36: storeb */
+    ptr0[i] = var74;
+  }
+
+}
+
+static OrcProgram *_orc_program_orc_comb_mask_32detect_planar_yuv;
+void
+orc_comb_mask_32detect_planar_yuv (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_32detect_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+void
+gst_fieldanalysis_orc_init (void)
+{
+#ifndef DISABLE_ORC
+  {
+    /* orc_same_parity_sad_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_sad_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_same_parity_sad_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 4, "t3");
+    orc_program_add_temporary (p, 4, "t4");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_same_parity_sad_planar_yuv = p;
+  }
+  {
+    /* orc_same_parity_ssd_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_ssd_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_same_parity_ssd_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 4, "t3");
+    orc_program_add_temporary (p, 4, "t4");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_same_parity_ssd_planar_yuv = p;
+  }
+  {
+    /* orc_same_parity_3_tap_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_3_tap_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_same_parity_3_tap_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_source (p, 1, "s5");
+    orc_program_add_source (p, 1, "s6");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 4, "t7");
+    orc_program_add_temporary (p, 4, "t8");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_S6, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T7, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_same_parity_3_tap_planar_yuv = p;
+  }
+  {
     /* orc_opposite_parity_5_tap_planar_yuv */
     OrcProgram *p;
 
@@ -1075,5 +2259,320 @@ gst_fieldanalysis_orc_init (void)
 
     _orc_program_orc_opposite_parity_5_tap_planar_yuv = p;
   }
+  {
+    /* orc_opposite_parity_5_tap_subsampled_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_opposite_parity_5_tap_subsampled_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_opposite_parity_5_tap_subsampled_planar_yuv);
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_source (p, 2, "s3");
+    orc_program_add_source (p, 2, "s4");
+    orc_program_add_source (p, 2, "s5");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_constant (p, 4, 0x00000003, "c2");
+    orc_program_add_parameter (p, 4, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 4, "t6");
+    orc_program_add_temporary (p, 4, "t7");
+    orc_program_add_temporary (p, 1, "t8");
+    orc_program_add_temporary (p, 1, "t9");
+    orc_program_add_temporary (p, 1, "t10");
+    orc_program_add_temporary (p, 1, "t11");
+    orc_program_add_temporary (p, 1, "t12");
+
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T8, ORC_VAR_S1,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_T8,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T9, ORC_VAR_S2,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_T9,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T10, ORC_VAR_S3,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_T10,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T11, ORC_VAR_S4,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_T11,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T12, ORC_VAR_S5,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_T12,
+        ORC_VAR_D1, ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T6, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T6, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_opposite_parity_5_tap_subsampled_planar_yuv = p;
+  }
+  {
+    /* orc_comb_mask_5_tap_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_5_tap_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_comb_mask_5_tap_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_source (p, 1, "s5");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_constant (p, 4, 0x00000003, "c2");
+    orc_program_add_constant (p, 4, 0x00000001, "c3");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_parameter (p, 2, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+    orc_program_add_temporary (p, 2, "t8");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T8, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T8, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_5_tap_planar_yuv = p;
+  }
+  {
+    /* orc_comb_mask_iscombed_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_iscombed_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_comb_mask_iscombed_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_constant (p, 4, 0x00000001, "c1");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+    orc_program_add_temporary (p, 2, "t8");
+    orc_program_add_temporary (p, 4, "t9");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T8, ORC_VAR_T5, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T9, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T9, ORC_VAR_T9, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convlw", 0, ORC_VAR_T7, ORC_VAR_T9, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T6, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_iscombed_planar_yuv = p;
+  }
+  {
+    /* orc_comb_mask_32detect_planar_yuv */
+    OrcProgram *p;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_32detect_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_comb_mask_32detect_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_constant (p, 4, 0x00000009, "c1");
+    orc_program_add_constant (p, 4, 0x00000001, "c2");
+    orc_program_add_constant (p, 4, 0x0000000f, "c3");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_32detect_planar_yuv = p;
+  }
 #endif
 }
@@ -33,6 +33,9 @@
  *
  * Reverberation/room effect.
  *
+ * Integer samples are processed in fixed point, float samples in floating
+ * point.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -52,6 +55,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
@@ -82,7 +86,12 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) [ 1, 2 ], "
         "endianness = (int) BYTE_ORDER, "
-        "width = (int) 16, " "depth = (int) 16, " "signed = (boolean) true")
+        "width = (int) 16, " "depth = (int) 16, " "signed = (boolean) true; "
+        "audio/x-raw-int, "
+        "rate = (int) [ 1, MAX ], "
+        "channels = (int) [ 1, 2 ], "
+        "endianness = (int) BYTE_ORDER, "
+        "width = (int) 32, " "depth = (int) 32, " "signed = (boolean) true")
     );
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
@@ -96,7 +105,12 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) 2, "
         "endianness = (int) BYTE_ORDER, "
-        "width = (int) 16, " "depth = (int) 16, " "signed = (boolean) true")
+        "width = (int) 16, " "depth = (int) 16, " "signed = (boolean) true; "
+        "audio/x-raw-int, "
+        "rate = (int) [ 1, MAX ], "
+        "channels = (int) 2, "
+        "endianness = (int) BYTE_ORDER, "
+        "width = (int) 32, " "depth = (int) 32, " "signed = (boolean) true")
     );
 
 #define _do_init(type) {                                                       \
@@ -131,6 +145,10 @@ static gboolean gst_freeverb_transform_m2s_int (GstFreeverb * filter,
     gint16 * idata, gint16 * odata, guint num_samples);
 static gboolean gst_freeverb_transform_s2s_int (GstFreeverb * filter,
     gint16 * idata, gint16 * odata, guint num_samples);
+static gboolean gst_freeverb_transform_m2s_int32 (GstFreeverb * filter,
+    gint32 * idata, gint32 * odata, guint num_samples);
+static gboolean gst_freeverb_transform_s2s_int32 (GstFreeverb * filter,
+    gint32 * idata, gint32 * odata, guint num_samples);
 static gboolean gst_freeverb_transform_m2s_float (GstFreeverb * filter,
     gfloat * idata, gfloat * odata, guint num_samples);
 static gboolean gst_freeverb_transform_s2s_float (GstFreeverb * filter,
@@ -138,13 +156,15 @@ static gboolean gst_freeverb_transform_s2s_float (GstFreeverb * filter,
 
 
 /* Table with processing functions: [channels][format] */
-static GstFreeverbProcessFunc process_functions[2][2] = {
+static GstFreeverbProcessFunc process_functions[2][3] = {
   {
         (GstFreeverbProcessFunc) gst_freeverb_transform_m2s_int,
+        (GstFreeverbProcessFunc) gst_freeverb_transform_m2s_int32,
         (GstFreeverbProcessFunc) gst_freeverb_transform_m2s_float,
       },
   {
         (GstFreeverbProcessFunc) gst_freeverb_transform_s2s_int,
+        (GstFreeverbProcessFunc) gst_freeverb_transform_s2s_int32,
         (GstFreeverbProcessFunc) gst_freeverb_transform_s2s_float,
       }
 };
@@ -168,12 +188,42 @@ static GstFreeverbProcessFunc process_functions[2][2] = {
 #define DC_OFFSET 1e-8
 //#define DC_OFFSET 0.001f
 
+/* Fixed point:
+ *
+ * The integer formats are processed without converting them to float.
+ * Samples are kept in 32 bit integers in units of 1/256 of a 16 bit sample,
+ * which leaves plenty of headroom for the gain of the comb filters, and the
+ * coefficients have 15 fractional bits.  The products of the recursive
+ * filters are rounded towards zero, so that the filters decay to silence
+ * instead of cycling around the last bits, which makes the DC offset
+ * unnecessary.
+ */
+
+#define FIXED_SHIFT 15
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_SAMPLE_SHIFT 8
+
+#define freeverb_fixed(_val) ((gint32) ((_val) * FIXED_ONE + 0.5f))
+#define freeverb_fixed_mul(_a, _b) \
+  ((gint32) (((gint64) (_a) * (_b)) / FIXED_ONE))
+
+/* Block processing:
+ *
+ * Every filter processes a whole block of samples before the next one does,
+ * instead of all filters processing one sample after the other.  The state
+ * of the filter stays in registers and its delay line is walked in order.
+ */
+
+#define BLOCK_SIZE 256
+
 /* all pass filter */
 
 typedef struct _freeverb_allpass
 {
   gfloat feedback;
-  gfloat *buffer;
+  gint32 ifeedback;
+  /* gfloat or gint32 samples, depending on the format */
+  gpointer buffer;
   gint bufsize;
   gint bufidx;
 } freeverb_allpass;
@@ -193,13 +243,22 @@ freeverb_allpass_release (freeverb_allpass * allpass)
 }
 
 static void
-freeverb_allpass_init (freeverb_allpass * allpass)
+freeverb_allpass_init (freeverb_allpass * allpass, gboolean format_float)
 {
   gint i, len = allpass->bufsize;
-  gfloat *buf = allpass->buffer;
 
-  for (i = 0; i < len; i++) {
-    buf[i] = DC_OFFSET;         /* this is not 100 % correct. */
+  if (format_float) {
+    gfloat *buf = allpass->buffer;
+
+    for (i = 0; i < len; i++) {
+      buf[i] = DC_OFFSET;       /* this is not 100 % correct. */
+    }
+  } else {
+    gint32 *buf = allpass->buffer;
+
+    for (i = 0; i < len; i++) {
+      buf[i] = 0;
+    }
   }
 }
 
@@ -207,6 +266,7 @@ static void
 freeverb_allpass_setfeedback (freeverb_allpass * allpass, gfloat val)
 {
   allpass->feedback = val;
+  allpass->ifeedback = freeverb_fixed (val);
 }
 
 /*
@@ -216,17 +276,56 @@ freeverb_allpass_getfeedback(freeverb_allpass* allpass)
   return allpass->feedback;
 }*/
 
-#define freeverb_allpass_process(_allpass, _input_1) \
-{ \
-  gfloat output; \
-  gfloat bufout; \
-  bufout = _allpass.buffer[_allpass.bufidx]; \
-  output = bufout-_input_1; \
-  _allpass.buffer[_allpass.bufidx] = _input_1 + (bufout * _allpass.feedback); \
-  if (++_allpass.bufidx >= _allpass.bufsize) { \
-    _allpass.bufidx = 0; \
-  } \
-  _input_1 = output; \
+static void
+freeverb_allpass_process_float (freeverb_allpass * allpass, gfloat * data,
+    gint len)
+{
+  gfloat *buffer = allpass->buffer;
+  gfloat feedback = allpass->feedback;
+  gint k, n, bufidx = allpass->bufidx;
+
+  while (len > 0) {
+    n = MIN (len, allpass->bufsize - bufidx);
+    for (k = 0; k < n; k++) {
+      gfloat bufout = buffer[bufidx + k];
+      gfloat input = data[k];
+
+      buffer[bufidx + k] = input + (bufout * feedback);
+      data[k] = bufout - input;
+    }
+    bufidx += n;
+    if (bufidx >= allpass->bufsize)
+      bufidx = 0;
+    data += n;
+    len -= n;
+  }
+  allpass->bufidx = bufidx;
+}
+
+static void
+freeverb_allpass_process_fixed (freeverb_allpass * allpass, gint32 * data,
+    gint len)
+{
+  gint32 *buffer = allpass->buffer;
+  gint32 feedback = allpass->ifeedback;
+  gint k, n, bufidx = allpass->bufidx;
+
+  while (len > 0) {
+    n = MIN (len, allpass->bufsize - bufidx);
+    for (k = 0; k < n; k++) {
+      gint32 bufout = buffer[bufidx + k];
+      gint32 input = data[k];
+
+      buffer[bufidx + k] = input + freeverb_fixed_mul (bufout, feedback);
+      data[k] = bufout - input;
+    }
+    bufidx += n;
+    if (bufidx >= allpass->bufsize)
+      bufidx = 0;
+    data += n;
+    len -= n;
+  }
+  allpass->bufidx = bufidx;
 }
 
 /* comb filter */
@@ -237,7 +336,12 @@ typedef struct _freeverb_comb
   gfloat filterstore;
   gfloat damp1;
   gfloat damp2;
-  gfloat *buffer;
+  gint32 ifeedback;
+  gint32 ifilterstore;
+  gint32 idamp1;
+  gint32 idamp2;
+  /* gfloat or gint32 samples, depending on the format */
+  gpointer buffer;
   gint bufsize;
   gint bufidx;
 } freeverb_comb;
@@ -246,6 +350,7 @@ static void
 freeverb_comb_setbuffer (freeverb_comb * comb, gint size)
 {
   comb->filterstore = 0;
+  comb->ifilterstore = 0;
   comb->bufidx = 0;
   comb->buffer = g_new (gfloat, size);
   comb->bufsize = size;
@@ -258,13 +363,22 @@ freeverb_comb_release (freeverb_comb * comb)
 }
 
 static void
-freeverb_comb_init (freeverb_comb * comb)
+freeverb_comb_init (freeverb_comb * comb, gboolean format_float)
 {
   gint i, len = comb->bufsize;
-  gfloat *buf = comb->buffer;
 
-  for (i = 0; i < len; i++) {
-    buf[i] = DC_OFFSET;         /* This is not 100 % correct. */
+  if (format_float) {
+    gfloat *buf = comb->buffer;
+
+    for (i = 0; i < len; i++) {
+      buf[i] = DC_OFFSET;       /* This is not 100 % correct. */
+    }
+  } else {
+    gint32 *buf = comb->buffer;
+
+    for (i = 0; i < len; i++) {
+      buf[i] = 0;
+    }
   }
 }
 
@@ -273,6 +387,8 @@ freeverb_comb_setdamp (freeverb_comb * comb, gfloat val)
 {
   comb->damp1 = val;
   comb->damp2 = 1 - val;
+  comb->idamp1 = freeverb_fixed (val);
+  comb->idamp2 = FIXED_ONE - comb->idamp1;
 }
 
 /*
@@ -286,6 +402,7 @@ static void
 freeverb_comb_setfeedback (freeverb_comb * comb, gfloat val)
 {
   comb->feedback = val;
+  comb->ifeedback = freeverb_fixed (val);
 }
 
 /*
@@ -295,15 +412,104 @@ freeverb_comb_getfeedback(freeverb_comb* comb)
   return comb->feedback;
 }*/
 
-#define freeverb_comb_process(_comb, _input_1, _output) \
-{ \
-  gfloat _tmp = _comb.buffer[_comb.bufidx]; \
-  _comb.filterstore = (_tmp * _comb.damp2) + (_comb.filterstore * _comb.damp1); \
-  _comb.buffer[_comb.bufidx] = _input_1 + (_comb.filterstore * _comb.feedback); \
-  if (++_comb.bufidx >= _comb.bufsize) { \
-    _comb.bufidx = 0; \
-  } \
-  _output += _tmp; \
+/* Adds the output of a comb filter of each channel for the blocks of
+ * @input_l and @input_r to @output_l and @output_r.  The filter store of a
+ * comb filter depends on its previous value, so the two channels are
+ * interleaved to give the CPU independent work. */
+static void
+freeverb_comb_process_float (freeverb_comb * comb_l, freeverb_comb * comb_r,
+    const gfloat * input_l, const gfloat * input_r, gfloat * output_l,
+    gfloat * output_r, gint len)
+{
+  gfloat *buffer_l = comb_l->buffer, *buffer_r = comb_r->buffer;
+  gfloat filterstore_l = comb_l->filterstore;
+  gfloat filterstore_r = comb_r->filterstore;
+  gfloat damp1_l = comb_l->damp1, damp2_l = comb_l->damp2;
+  gfloat damp1_r = comb_r->damp1, damp2_r = comb_r->damp2;
+  gfloat feedback_l = comb_l->feedback, feedback_r = comb_r->feedback;
+  gint bufidx_l = comb_l->bufidx, bufidx_r = comb_r->bufidx;
+  gint k, n;
+
+  while (len > 0) {
+    gfloat *buf_l = buffer_l + bufidx_l, *buf_r = buffer_r + bufidx_r;
+
+    n = MIN (len, MIN (comb_l->bufsize - bufidx_l,
+            comb_r->bufsize - bufidx_r));
+    for (k = 0; k < n; k++) {
+      gfloat tmp_l = buf_l[k], tmp_r = buf_r[k];
+
+      filterstore_l = (tmp_l * damp2_l) + (filterstore_l * damp1_l);
+      filterstore_r = (tmp_r * damp2_r) + (filterstore_r * damp1_r);
+      buf_l[k] = input_l[k] + (filterstore_l * feedback_l);
+      buf_r[k] = input_r[k] + (filterstore_r * feedback_r);
+      output_l[k] += tmp_l;
+      output_r[k] += tmp_r;
+    }
+    bufidx_l += n;
+    if (bufidx_l >= comb_l->bufsize)
+      bufidx_l = 0;
+    bufidx_r += n;
+    if (bufidx_r >= comb_r->bufsize)
+      bufidx_r = 0;
+    input_l += n;
+    input_r += n;
+    output_l += n;
+    output_r += n;
+    len -= n;
+  }
+  comb_l->filterstore = filterstore_l;
+  comb_r->filterstore = filterstore_r;
+  comb_l->bufidx = bufidx_l;
+  comb_r->bufidx = bufidx_r;
+}
+
+static void
+freeverb_comb_process_fixed (freeverb_comb * comb_l, freeverb_comb * comb_r,
+    const gint32 * input_l, const gint32 * input_r, gint32 * output_l,
+    gint32 * output_r, gint len)
+{
+  gint32 *buffer_l = comb_l->buffer, *buffer_r = comb_r->buffer;
+  gint32 filterstore_l = comb_l->ifilterstore;
+  gint32 filterstore_r = comb_r->ifilterstore;
+  gint32 damp1_l = comb_l->idamp1, damp2_l = comb_l->idamp2;
+  gint32 damp1_r = comb_r->idamp1, damp2_r = comb_r->idamp2;
+  gint32 feedback_l = comb_l->ifeedback, feedback_r = comb_r->ifeedback;
+  gint bufidx_l = comb_l->bufidx, bufidx_r = comb_r->bufidx;
+  gint k, n;
+
+  while (len > 0) {
+    gint32 *buf_l = buffer_l + bufidx_l, *buf_r = buffer_r + bufidx_r;
+
+    n = MIN (len, MIN (comb_l->bufsize - bufidx_l,
+            comb_r->bufsize - bufidx_r));
+    for (k = 0; k < n; k++) {
+      gint32 tmp_l = buf_l[k], tmp_r = buf_r[k];
+
+      filterstore_l = (gint32) (((gint64) tmp_l * damp2_l +
+              (gint64) filterstore_l * damp1_l) / FIXED_ONE);
+      filterstore_r = (gint32) (((gint64) tmp_r * damp2_r +
+              (gint64) filterstore_r * damp1_r) / FIXED_ONE);
+      buf_l[k] = input_l[k] + freeverb_fixed_mul (filterstore_l, feedback_l);
+      buf_r[k] = input_r[k] + freeverb_fixed_mul (filterstore_r, feedback_r);
+      output_l[k] += tmp_l;
+      output_r[k] += tmp_r;
+    }
+    bufidx_l += n;
+    if (bufidx_l >= comb_l->bufsize)
+      bufidx_l = 0;
+    bufidx_r += n;
+    if (bufidx_r >= comb_r->bufsize)
+      bufidx_r = 0;
+    input_l += n;
+    input_r += n;
+    output_l += n;
+    output_r += n;
+    len -= n;
+  }
+  comb_l->ifilterstore = filterstore_l;
+  comb_r->ifilterstore = filterstore_r;
+  comb_l->bufidx = bufidx_l;
+  comb_r->bufidx = bufidx_r;
 }
 
 #define numcombs 8
@@ -352,6 +558,9 @@ struct _GstFreeverbPrivate
   gfloat wet, wet1, wet2, dry;
   gfloat width;
   gfloat gain;
+  /* the same in fixed point */
+  gint32 iwet1, iwet2, idry;
+  gint32 igain;
   /*
      The following are all declared inline
      to remove the need for dynamic allocation
@@ -372,12 +581,12 @@ freeverb_revmodel_init (GstFreeverb * filter)
   gint i;
 
   for (i = 0; i < numcombs; i++) {
-    freeverb_comb_init (&priv->combL[i]);
-    freeverb_comb_init (&priv->combR[i]);
+    freeverb_comb_init (&priv->combL[i], filter->format_float);
+    freeverb_comb_init (&priv->combR[i], filter->format_float);
   }
   for (i = 0; i < numallpasses; i++) {
-    freeverb_allpass_init (&priv->allpassL[i]);
-    freeverb_allpass_init (&priv->allpassR[i]);
+    freeverb_allpass_init (&priv->allpassL[i], filter->format_float);
+    freeverb_allpass_init (&priv->allpassR[i], filter->format_float);
   }
 }
 
@@ -397,6 +606,54 @@ freeverb_revmodel_free (GstFreeverb * filter)
   }
 }
 
+/* Runs a block of each channel through the network: the input through the
+ * comb filters in parallel, their sum through the allpasses in series. */
+static void
+freeverb_revmodel_process_float (GstFreeverbPrivate * priv,
+    const gfloat * input_l, const gfloat * input_r, gfloat * output_l,
+    gfloat * output_r, gint len)
+{
+  gint i, k;
+
+  for (k = 0; k < len; k++)
+    output_l[k] = output_r[k] = 0.0;
+
+  /* Accumulate comb filters in parallel */
+  for (i = 0; i < numcombs; i++)
+    freeverb_comb_process_float (&priv->combL[i], &priv->combR[i], input_l,
+        input_r, output_l, output_r, len);
+  /* Feed through allpasses in series */
+  for (i = 0; i < numallpasses; i++) {
+    freeverb_allpass_process_float (&priv->allpassL[i], output_l, len);
+    freeverb_allpass_process_float (&priv->allpassR[i], output_r, len);
+  }
+
+  /* Remove the DC offset */
+  for (k = 0; k < len; k++) {
+    output_l[k] -= DC_OFFSET;
+    output_r[k] -= DC_OFFSET;
+  }
+}
+
+static void
+freeverb_revmodel_process_fixed (GstFreeverbPrivate * priv,
+    const gint32 * input_l, const gint32 * input_r, gint32 * output_l,
+    gint32 * output_r, gint len)
+{
+  gint i;
+
+  memset (output_l, 0, len * sizeof (gint32));
+  memset (output_r, 0, len * sizeof (gint32));
+
+  for (i = 0; i < numcombs; i++)
+    freeverb_comb_process_fixed (&priv->combL[i], &priv->combR[i], input_l,
+        input_r, output_l, output_r, len);
+  for (i = 0; i < numallpasses; i++) {
+    freeverb_allpass_process_fixed (&priv->allpassL[i], output_l, len);
+    freeverb_allpass_process_fixed (&priv->allpassR[i], output_r, len);
+  }
+}
+
 /* GObject vmethod implementations */
 
 static void
@@ -494,7 +751,10 @@ gst_freeverb_set_process_function (GstFreeverb * filter)
     return FALSE;
   }
 
-  format_index = (filter->format_float) ? 1 : 0;
+  if (filter->format_float)
+    format_index = 2;
+  else
+    format_index = (filter->width == 4) ? 1 : 0;
 
   filter->process = process_functions[channel_index][format_index];
 
@@ -511,6 +771,7 @@ gst_freeverb_init_rev_model (GstFreeverb * filter)
   freeverb_revmodel_free (filter);
 
   priv->gain = fixedgain;
+  priv->igain = freeverb_fixed (fixedgain);
 
   freeverb_comb_setbuffer (&priv->combL[0], combtuningL1 * srfactor);
   freeverb_comb_setbuffer (&priv->combR[0], combtuningR1 * srfactor);
@@ -581,6 +842,8 @@ gst_freeverb_set_property (GObject * object, guint prop_id,
       priv->width = filter->pan_width;
       priv->wet1 = priv->wet * (priv->width / 2.0f + 0.5f);
       priv->wet2 = priv->wet * ((1.0f - priv->width) / 2.0f);
+      priv->iwet1 = freeverb_fixed (priv->wet1);
+      priv->iwet2 = freeverb_fixed (priv->wet2);
       break;
     case PROP_LEVEL:
       filter->level = g_value_get_float (value);
@@ -588,6 +851,9 @@ gst_freeverb_set_property (GObject * object, guint prop_id,
       priv->dry = (1.0 - filter->level) * scaledry;
       priv->wet1 = priv->wet * (priv->width / 2.0f + 0.5f);
       priv->wet2 = priv->wet * ((1.0f - priv->width) / 2.0f);
+      priv->iwet1 = freeverb_fixed (priv->wet1);
+      priv->iwet2 = freeverb_fixed (priv->wet2);
+      priv->idry = freeverb_fixed (priv->dry);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -724,50 +990,56 @@ no_rate:
   return ret;
 }
 
+/* mixes the dry signal and the two wet channels in fixed point, giving
+ * the output in units of 1 / (1 << (FIXED_SHIFT + FIXED_SAMPLE_SHIFT)) of
+ * a 16 bit sample */
+#define freeverb_mix_fixed(_priv, _out_1, _out_2, _input) \
+  ((gint64) (_out_1) * (_priv)->iwet1 + (gint64) (_out_2) * (_priv)->iwet2 + \
+   (gint64) (_input) * (_priv)->idry)
+
 static gboolean
 gst_freeverb_transform_m2s_int (GstFreeverb * filter,
     gint16 * idata, gint16 * odata, guint num_samples)
 {
   GstFreeverbPrivate *priv = filter->priv;
-  gint i, k;
-  gfloat out_l1, out_r1, input_1;
-  gfloat out_l2, out_r2, input_2;
+  gint32 input_1[BLOCK_SIZE], input_2[BLOCK_SIZE];
+  gint32 out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
+  gint k, len;
+  gint64 out_l2, out_r2;
   gboolean drained = TRUE;
 
-  for (k = 0; k < num_samples; k++) {
-
-    out_l1 = out_r1 = 0.0;
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
 
     /* The original Freeverb code expects a stereo signal and 'input_1'
      * is set to the sum of the left and right input_1 sample. Since
      * this code works on a mono signal, 'input_1' is set to twice the
      * input_1 sample. */
-    input_2 = (gfloat) * idata++;
-    input_1 = (2.0f * input_2 + DC_OFFSET) * priv->gain;
-
-    /* Accumulate comb filters in parallel */
-    for (i = 0; i < numcombs; i++) {
-      freeverb_comb_process (priv->combL[i], input_1, out_l1);
-      freeverb_comb_process (priv->combR[i], input_1, out_r1);
-    }
-    /* Feed through allpasses in series */
-    for (i = 0; i < numallpasses; i++) {
-      freeverb_allpass_process (priv->allpassL[i], out_l1);
-      freeverb_allpass_process (priv->allpassR[i], out_r1);
+    for (k = 0; k < len; k++) {
+      input_2[k] = idata[k] << FIXED_SAMPLE_SHIFT;
+      input_1[k] = freeverb_fixed_mul (2 * input_2[k], priv->igain);
     }
 
-    /* Remove the DC offset */
-    out_l1 -= DC_OFFSET;
-    out_r1 -= DC_OFFSET;
+    freeverb_revmodel_process_fixed (priv, input_1, input_1, out_l1, out_r1,
+        len);
 
     /* Calculate output */
-    out_l2 = out_l1 * priv->wet1 + out_r1 * priv->wet2 + input_2 * priv->dry;
-    out_r2 = out_r1 * priv->wet1 + out_l1 * priv->wet2 + input_2 * priv->dry;
-    *odata++ = (gint16) CLAMP (out_l2, G_MININT16, G_MAXINT16);
-    *odata++ = (gint16) CLAMP (out_r2, G_MININT16, G_MAXINT16);
+    for (k = 0; k < len; k++) {
+      out_l2 = freeverb_mix_fixed (priv, out_l1[k], out_r1[k], input_2[k]);
+      out_r2 = freeverb_mix_fixed (priv, out_r1[k], out_l1[k], input_2[k]);
+      out_l2 = (out_l2 + (1 << (FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 1))) >>
+          (FIXED_SHIFT + FIXED_SAMPLE_SHIFT);
+      out_r2 = (out_r2 + (1 << (FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 1))) >>
+          (FIXED_SHIFT + FIXED_SAMPLE_SHIFT);
+      *odata++ = (gint16) CLAMP (out_l2, G_MININT16, G_MAXINT16);
+      *odata++ = (gint16) CLAMP (out_r2, G_MININT16, G_MAXINT16);
+
+      if (out_l2 != 0 || out_r2 != 0)
+        drained = FALSE;
+    }
 
-    if (abs (out_l2) > 0 || abs (out_r2) > 0)
-      drained = FALSE;
+    idata += len;
+    num_samples -= len;
   }
   return drained;
 }
@@ -777,43 +1049,130 @@ gst_freeverb_transform_s2s_int (GstFreeverb * filter,
     gint16 * idata, gint16 * odata, guint num_samples)
 {
   GstFreeverbPrivate *priv = filter->priv;
-  gint i, k;
-  gfloat out_l1, out_r1, input_1l, input_1r;
-  gfloat out_l2, out_r2, input_2l, input_2r;
+  gint32 input_1l[BLOCK_SIZE], input_1r[BLOCK_SIZE];
+  gint32 input_2l[BLOCK_SIZE], input_2r[BLOCK_SIZE];
+  gint32 out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
+  gint k, len;
+  gint64 out_l2, out_r2;
   gboolean drained = TRUE;
 
-  for (k = 0; k < num_samples; k++) {
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
 
-    out_l1 = out_r1 = 0.0;
+    for (k = 0; k < len; k++) {
+      input_2l[k] = idata[2 * k] << FIXED_SAMPLE_SHIFT;
+      input_2r[k] = idata[2 * k + 1] << FIXED_SAMPLE_SHIFT;
+      input_1l[k] = freeverb_fixed_mul (input_2l[k], priv->igain);
+      input_1r[k] = freeverb_fixed_mul (input_2r[k], priv->igain);
+    }
 
-    input_2l = (gfloat) * idata++;
-    input_2r = (gfloat) * idata++;
-    input_1l = (input_2l + DC_OFFSET) * priv->gain;
-    input_1r = (input_2r + DC_OFFSET) * priv->gain;
+    freeverb_revmodel_process_fixed (priv, input_1l, input_1r, out_l1, out_r1,
+        len);
 
-    /* Accumulate comb filters in parallel */
-    for (i = 0; i < numcombs; i++) {
-      freeverb_comb_process (priv->combL[i], input_1l, out_l1);
-      freeverb_comb_process (priv->combR[i], input_1r, out_r1);
+    /* Calculate output */
+    for (k = 0; k < len; k++) {
+      out_l2 = freeverb_mix_fixed (priv, out_l1[k], out_r1[k], input_2l[k]);
+      out_r2 = freeverb_mix_fixed (priv, out_r1[k], out_l1[k], input_2r[k]);
+      out_l2 = (out_l2 + (1 << (FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 1))) >>
+          (FIXED_SHIFT + FIXED_SAMPLE_SHIFT);
+      out_r2 = (out_r2 + (1 << (FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 1))) >>
+          (FIXED_SHIFT + FIXED_SAMPLE_SHIFT);
+      *odata++ = (gint16) CLAMP (out_l2, G_MININT16, G_MAXINT16);
+      *odata++ = (gint16) CLAMP (out_r2, G_MININT16, G_MAXINT16);
+
+      if (out_l2 != 0 || out_r2 != 0)
+        drained = FALSE;
     }
-    /* Feed through allpasses in series */
-    for (i = 0; i < numallpasses; i++) {
-      freeverb_allpass_process (priv->allpassL[i], out_l1);
-      freeverb_allpass_process (priv->allpassR[i], out_r1);
+
+    idata += 2 * len;
+    num_samples -= len;
+  }
+  return drained;
+}
+
+/* 32 bit samples are processed with the 24 most significant bits, the
+ * output keeps 16 fractional bits more than the 16 bit format */
+static gboolean
+gst_freeverb_transform_m2s_int32 (GstFreeverb * filter,
+    gint32 * idata, gint32 * odata, guint num_samples)
+{
+  GstFreeverbPrivate *priv = filter->priv;
+  gint32 input_1[BLOCK_SIZE], input_2[BLOCK_SIZE];
+  gint32 out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
+  gint k, len;
+  gint64 out_l2, out_r2;
+  gboolean drained = TRUE;
+
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
+
+    for (k = 0; k < len; k++) {
+      input_2[k] = idata[k] >> (16 - FIXED_SAMPLE_SHIFT);
+      input_1[k] = freeverb_fixed_mul (2 * input_2[k], priv->igain);
     }
 
-    /* Remove the DC offset */
-    out_l1 -= DC_OFFSET;
-    out_r1 -= DC_OFFSET;
+    freeverb_revmodel_process_fixed (priv, input_1, input_1, out_l1, out_r1,
+        len);
 
     /* Calculate output */
-    out_l2 = out_l1 * priv->wet1 + out_r1 * priv->wet2 + input_2l * priv->dry;
-    out_r2 = out_r1 * priv->wet1 + out_l1 * priv->wet2 + input_2r * priv->dry;
-    *odata++ = (gint16) CLAMP (out_l2, G_MININT16, G_MAXINT16);
-    *odata++ = (gint16) CLAMP (out_r2, G_MININT16, G_MAXINT16);
+    for (k = 0; k < len; k++) {
+      out_l2 = freeverb_mix_fixed (priv, out_l1[k], out_r1[k], input_2[k]);
+      out_r2 = freeverb_mix_fixed (priv, out_r1[k], out_l1[k], input_2[k]);
+      out_l2 >>= FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 16;
+      out_r2 >>= FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 16;
+      *odata++ = (gint32) CLAMP (out_l2, G_MININT32, G_MAXINT32);
+      *odata++ = (gint32) CLAMP (out_r2, G_MININT32, G_MAXINT32);
+
+      if (out_l2 != 0 || out_r2 != 0)
+        drained = FALSE;
+    }
 
-    if (abs (out_l2) > 0 || abs (out_r2) > 0)
-      drained = FALSE;
+    idata += len;
+    num_samples -= len;
+  }
+  return drained;
+}
+
+static gboolean
+gst_freeverb_transform_s2s_int32 (GstFreeverb * filter,
+    gint32 * idata, gint32 * odata, guint num_samples)
+{
+  GstFreeverbPrivate *priv = filter->priv;
+  gint32 input_1l[BLOCK_SIZE], input_1r[BLOCK_SIZE];
+  gint32 input_2l[BLOCK_SIZE], input_2r[BLOCK_SIZE];
+  gint32 out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
+  gint k, len;
+  gint64 out_l2, out_r2;
+  gboolean drained = TRUE;
+
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
+
+    for (k = 0; k < len; k++) {
+      input_2l[k] = idata[2 * k] >> (16 - FIXED_SAMPLE_SHIFT);
+      input_2r[k] = idata[2 * k + 1] >> (16 - FIXED_SAMPLE_SHIFT);
+      input_1l[k] = freeverb_fixed_mul (input_2l[k], priv->igain);
+      input_1r[k] = freeverb_fixed_mul (input_2r[k], priv->igain);
+    }
+
+    freeverb_revmodel_process_fixed (priv, input_1l, input_1r, out_l1, out_r1,
+        len);
+
+    /* Calculate output */
+    for (k = 0; k < len; k++) {
+      out_l2 = freeverb_mix_fixed (priv, out_l1[k], out_r1[k], input_2l[k]);
+      out_r2 = freeverb_mix_fixed (priv, out_r1[k], out_l1[k], input_2r[k]);
+      out_l2 >>= FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 16;
+      out_r2 >>= FIXED_SHIFT + FIXED_SAMPLE_SHIFT - 16;
+      *odata++ = (gint32) CLAMP (out_l2, G_MININT32, G_MAXINT32);
+      *odata++ = (gint32) CLAMP (out_r2, G_MININT32, G_MAXINT32);
+
+      if (out_l2 != 0 || out_r2 != 0)
+        drained = FALSE;
+    }
+
+    idata += 2 * len;
+    num_samples -= len;
   }
   return drained;
 }
@@ -823,45 +1182,40 @@ gst_freeverb_transform_m2s_float (GstFreeverb * filter,
     gfloat * idata, gfloat * odata, guint num_samples)
 {
   GstFreeverbPrivate *priv = filter->priv;
-  gint i, k;
-  gfloat out_l1, out_r1, input_1;
+  gfloat input_1[BLOCK_SIZE];
+  gfloat out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
   gfloat out_l2, out_r2, input_2;
+  gint k, len;
   gboolean drained = TRUE;
 
-  for (k = 0; k < num_samples; k++) {
-
-    out_l1 = out_r1 = 0.0;
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
 
     /* The original Freeverb code expects a stereo signal and 'input_1'
      * is set to the sum of the left and right input_1 sample. Since
      * this code works on a mono signal, 'input_1' is set to twice the
      * input_1 sample. */
-    input_2 = *idata++;
-    input_1 = (2.0f * input_2 + DC_OFFSET) * priv->gain;
-
-    /* Accumulate comb filters in parallel */
-    for (i = 0; i < numcombs; i++) {
-      freeverb_comb_process (priv->combL[i], input_1, out_l1);
-      freeverb_comb_process (priv->combR[i], input_1, out_r1);
-    }
-    /* Feed through allpasses in series */
-    for (i = 0; i < numallpasses; i++) {
-      freeverb_allpass_process (priv->allpassL[i], out_l1);
-      freeverb_allpass_process (priv->allpassR[i], out_r1);
-    }
+    for (k = 0; k < len; k++)
+      input_1[k] = (2.0f * idata[k] + DC_OFFSET) * priv->gain;
 
-    /* Remove the DC offset */
-    out_l1 -= DC_OFFSET;
-    out_r1 -= DC_OFFSET;
+    freeverb_revmodel_process_float (priv, input_1, input_1, out_l1, out_r1,
+        len);
 
     /* Calculate output */
-    out_l2 = out_l1 * priv->wet1 + out_r1 * priv->wet2 + input_2 * priv->dry;
-    out_r2 = out_r1 * priv->wet1 + out_l1 * priv->wet2 + input_2 * priv->dry;
-    *odata++ = out_l2;
-    *odata++ = out_r2;
+    for (k = 0; k < len; k++) {
+      input_2 = *idata++;
+      out_l2 = out_l1[k] * priv->wet1 + out_r1[k] * priv->wet2 +
+          input_2 * priv->dry;
+      out_r2 = out_r1[k] * priv->wet1 + out_l1[k] * priv->wet2 +
+          input_2 * priv->dry;
+      *odata++ = out_l2;
+      *odata++ = out_r2;
+
+      if (fabs (out_l2) > 0 || fabs (out_r2) > 0)
+        drained = FALSE;
+    }
 
-    if (fabs (out_l2) > 0 || fabs (out_r2) > 0)
-      drained = FALSE;
+    num_samples -= len;
   }
   return drained;
 }
@@ -871,43 +1225,39 @@ gst_freeverb_transform_s2s_float (GstFreeverb * filter,
     gfloat * idata, gfloat * odata, guint num_samples)
 {
   GstFreeverbPrivate *priv = filter->priv;
-  gint i, k;
-  gfloat out_l1, out_r1, input_1l, input_1r;
+  gfloat input_1l[BLOCK_SIZE], input_1r[BLOCK_SIZE];
+  gfloat out_l1[BLOCK_SIZE], out_r1[BLOCK_SIZE];
   gfloat out_l2, out_r2, input_2l, input_2r;
+  gint k, len;
   gboolean drained = TRUE;
 
-  for (k = 0; k < num_samples; k++) {
-
-    out_l1 = out_r1 = 0.0;
+  while (num_samples > 0) {
+    len = MIN (num_samples, BLOCK_SIZE);
 
-    input_2l = *idata++;
-    input_2r = *idata++;
-    input_1l = (input_2l + DC_OFFSET) * priv->gain;
-    input_1r = (input_2r + DC_OFFSET) * priv->gain;
-
-    /* Accumulate comb filters in parallel */
-    for (i = 0; i < numcombs; i++) {
-      freeverb_comb_process (priv->combL[i], input_1l, out_l1);
-      freeverb_comb_process (priv->combR[i], input_1r, out_r1);
-    }
-    /* Feed through allpasses in series */
-    for (i = 0; i < numallpasses; i++) {
-      freeverb_allpass_process (priv->allpassL[i], out_l1);
-      freeverb_allpass_process (priv->allpassR[i], out_r1);
+    for (k = 0; k < len; k++) {
+      input_1l[k] = (idata[2 * k] + DC_OFFSET) * priv->gain;
+      input_1r[k] = (idata[2 * k + 1] + DC_OFFSET) * priv->gain;
     }
 
-    /* Remove the DC offset */
-    out_l1 -= DC_OFFSET;
-    out_r1 -= DC_OFFSET;
+    freeverb_revmodel_process_float (priv, input_1l, input_1r, out_l1, out_r1,
+        len);
 
     /* Calculate output */
-    out_l2 = out_l1 * priv->wet1 + out_r1 * priv->wet2 + input_2l * priv->dry;
-    out_r2 = out_r1 * priv->wet1 + out_l1 * priv->wet2 + input_2r * priv->dry;
-    *odata++ = out_l2;
-    *odata++ = out_r2;
+    for (k = 0; k < len; k++) {
+      input_2l = *idata++;
+      input_2r = *idata++;
+      out_l2 = out_l1[k] * priv->wet1 + out_r1[k] * priv->wet2 +
+          input_2l * priv->dry;
+      out_r2 = out_r1[k] * priv->wet1 + out_l1[k] * priv->wet2 +
+          input_2r * priv->dry;
+      *odata++ = out_l2;
+      *odata++ = out_r2;
+
+      if (fabs (out_l2) > 0 || fabs (out_r2) > 0)
+        drained = FALSE;
+    }
 
-    if (fabs (out_l2) > 0 || fabs (out_r2) > 0)
-      drained = FALSE;
+    num_samples -= len;
   }
   return drained;
 }
@@ -100,6 +100,13 @@ struct _GstInterlace
   int src_fps_n;
   int src_fps_d;
 
+  /* layout of a frame */
+  guint frame_size;
+  int n_planes;
+  int plane_offset[3];
+  int plane_stride[3];
+  int plane_height[3];
+
   GstBuffer *stored_frame;
   gint stored_fields;
   gint phase_index;
@@ -184,6 +191,7 @@ static void gst_interlace_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
 
 static gboolean gst_interlace_setcaps (GstPad * pad, GstCaps * caps);
+static void gst_interlace_setup_planes (GstInterlace * interlace);
 static GstCaps *gst_interlace_getcaps (GstPad * pad);
 static GstStateChangeReturn gst_interlace_change_state (GstElement * element,
     GstStateChange transition);
@@ -356,6 +364,13 @@ gst_interlace_decorate_buffer (GstInterlace * interlace, GstBuffer * buf,
   /* increment the buffer timestamp by duration for the next buffer */
   gst_buffer_set_caps (buf, interlace->srccaps);
 
+  /* the buffer may be an incoming one we weave into or pass on, which
+   * carries the field flags and the delta unit flag of the input */
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_TFF);
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_RFF);
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_ONEFIELD);
+  GST_BUFFER_FLAG_UNSET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+
   if (interlace->field_index == 0) {
     GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_TFF);
   }
@@ -525,6 +540,7 @@ gst_interlace_setcaps (GstPad * pad, GstCaps * caps)
   interlace->format = format;
   interlace->width = width;
   interlace->height = height;
+  gst_interlace_setup_planes (interlace);
 
   interlace->phase_index = interlace->pattern_offset;
 
@@ -546,109 +562,75 @@ error:
   return ret;
 }
 
+/* the planes of a frame, i.e. the sets of lines that belong to the same
+ * image: one for packed formats, luma and interleaved chroma for NV12 and
+ * NV21, and one per component for planar formats */
 static void
-copy_field (GstInterlace * interlace, GstBuffer * d, GstBuffer * s,
-    int field_index)
+gst_interlace_setup_planes (GstInterlace * interlace)
 {
-  int j;
-  guint8 *dest;
-  guint8 *src;
+  GstVideoFormat format = interlace->format;
   int width = interlace->width;
   int height = interlace->height;
+  int i;
 
-  if (interlace->format == GST_VIDEO_FORMAT_I420 ||
-      interlace->format == GST_VIDEO_FORMAT_YV12) {
-    /* planar 4:2:0 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width / 2;
-      src = GST_BUFFER_DATA (s) + width * height + j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest =
-          GST_BUFFER_DATA (d) + width * height + width / 2 * height / 2 +
-          j * width / 2;
-      src =
-          GST_BUFFER_DATA (s) + width * height + width / 2 * height / 2 +
-          j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_UYVY ||
-      interlace->format == GST_VIDEO_FORMAT_YUY2) {
-    /* packed 4:2:2 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width * 2;
-      src = GST_BUFFER_DATA (s) + j * width * 2;
-      memcpy (dest, src, width * 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_AYUV) {
-    /* packed 4:4:4 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width * 4;
-      src = GST_BUFFER_DATA (s) + j * width * 4;
-      memcpy (dest, src, width * 4);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_Y42B) {
-    /* planar 4:2:2 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width / 2;
-      src = GST_BUFFER_DATA (s) + width * height + j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest =
-          GST_BUFFER_DATA (d) + width * height + width / 2 * height +
-          j * width / 2;
-      src =
-          GST_BUFFER_DATA (s) + width * height + width / 2 * height +
-          j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_Y444) {
-    /* planar 4:4:4 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_NV12 ||
-      interlace->format == GST_VIDEO_FORMAT_NV21) {
-    /* planar/packed 4:2:0 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-  } else {
-    g_assert_not_reached ();
+  switch (format) {
+    case GST_VIDEO_FORMAT_AYUV:
+    case GST_VIDEO_FORMAT_YUY2:
+    case GST_VIDEO_FORMAT_UYVY:
+      interlace->n_planes = 1;
+      break;
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+      interlace->n_planes = 2;
+      break;
+    default:
+      interlace->n_planes = 3;
+      break;
   }
+
+  for (i = 0; i < interlace->n_planes; i++) {
+    interlace->plane_offset[i] =
+        gst_video_format_get_component_offset (format, i, width, height);
+    interlace->plane_stride[i] =
+        gst_video_format_get_row_stride (format, i, width);
+    interlace->plane_height[i] =
+        gst_video_format_get_component_height (format, i, height);
+  }
+  /* the chroma plane of NV21 starts with V */
+  if (interlace->n_planes == 2)
+    interlace->plane_offset[1] = MIN (interlace->plane_offset[1],
+        gst_video_format_get_component_offset (format, 2, width, height));
+
+  interlace->frame_size = gst_video_format_get_size (format, width, height);
 }
 
+/* weaves the field @field_index of @first and the other field of @second
+ * into @dest, in a single pass over the lines of the output. @dest may be
+ * the data of @second, then only the lines of the first field are copied */
+static void
+gst_interlace_weave (GstInterlace * interlace, guint8 * dest,
+    const guint8 * first, const guint8 * second, int field_index)
+{
+  int i, j;
+
+  for (i = 0; i < interlace->n_planes; i++) {
+    int offset = interlace->plane_offset[i];
+    int stride = interlace->plane_stride[i];
+    const guint8 *src[2];
+    guint8 *d = dest + offset;
+
+    src[field_index] = first + offset;
+    src[field_index ^ 1] = second + offset;
+
+    for (j = 0; j < interlace->plane_height[i]; j++) {
+      const guint8 *s = src[j & 1] + j * stride;
+
+      if (s != d)
+        memcpy (d, s, stride);
+      d += stride;
+    }
+  }
+}
 
 static GstFlowReturn
 gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
@@ -721,20 +703,41 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
         num_fields, current_fields, interlace->stored_fields);
 
     if (interlace->stored_fields > 0) {
+      const guint8 *current_data = GST_BUFFER_DATA (buffer);
+
       GST_DEBUG ("1 field from stored, 1 from current");
 
-      output_buffer = gst_buffer_new_and_alloc (GST_BUFFER_SIZE (buffer));
-      /* take the first field from the stored frame */
-      copy_field (interlace, output_buffer, interlace->stored_frame,
+      if (current_fields == 1 && gst_buffer_is_writable (buffer) &&
+          GST_BUFFER_SIZE (buffer) >= interlace->frame_size) {
+        /* this is the last field of the incoming buffer and nobody else
+         * uses it, weave the stored field into it */
+        GST_DEBUG ("weaving into the incoming buffer");
+        output_buffer = buffer;
+        buffer = NULL;
+      } else {
+        /* downstream may well recycle its buffers */
+        ret = gst_pad_alloc_buffer_and_set_caps (interlace->srcpad,
+            GST_BUFFER_OFFSET_NONE, interlace->frame_size, interlace->srccaps,
+            &output_buffer);
+        if (ret != GST_FLOW_OK) {
+          GST_DEBUG_OBJECT (interlace, "Failed to allocate buffer: %s",
+              gst_flow_get_name (ret));
+          break;
+        }
+        if (GST_BUFFER_SIZE (output_buffer) < interlace->frame_size) {
+          gst_buffer_unref (output_buffer);
+          output_buffer = gst_buffer_new_and_alloc (interlace->frame_size);
+        }
+      }
+      /* take the first field from the stored frame and the second field
+       * from the incoming buffer */
+      gst_interlace_weave (interlace, GST_BUFFER_DATA (output_buffer),
+          GST_BUFFER_DATA (interlace->stored_frame), current_data,
           interlace->field_index);
       interlace->stored_fields--;
-      /* take the second field from the incoming buffer */
-      copy_field (interlace, output_buffer, buffer, interlace->field_index ^ 1);
       current_fields--;
       n_output_fields = 2;
     } else {
-      output_buffer =
-          gst_buffer_make_metadata_writable (gst_buffer_ref (buffer));
       if (num_fields >= 3 && interlace->allow_rff) {
         GST_DEBUG ("3 fields from current");
         /* take both fields from incoming buffer */
@@ -746,6 +749,15 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
         current_fields -= 2;
         n_output_fields = 2;
       }
+      /* only the flags change; if no field of the incoming buffer is left,
+       * hand our reference over so that it stays writable downstream */
+      if (current_fields == 0) {
+        output_buffer = gst_buffer_make_metadata_writable (buffer);
+        buffer = NULL;
+      } else {
+        output_buffer =
+            gst_buffer_make_metadata_writable (gst_buffer_ref (buffer));
+      }
     }
     num_fields -= n_output_fields;
 
@@ -781,7 +793,7 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
   if (current_fields > 0) {
     interlace->stored_frame = buffer;
     interlace->stored_fields = current_fields;
-  } else {
+  } else if (buffer) {
     gst_buffer_unref (buffer);
   }
 
@@ -62,11 +62,13 @@ enum
 {
   PROP_0,
   PROP_MAX_LAYERS,
-  PROP_MAX_DECOMPOSITION_LEVELS
+  PROP_MAX_DECOMPOSITION_LEVELS,
+  PROP_N_THREADS
 };
 
 #define DEFAULT_MAX_LAYERS (0)
 #define DEFAULT_MAX_DECOMPOSITION_LEVELS (-1)
+#define DEFAULT_N_THREADS (1)
 
 static void gst_jp2k_decimator_finalize (GObject * obj);
 static void gst_jp2k_decimator_set_property (GObject * object,
@@ -126,6 +128,12 @@ gst_jp2k_decimator_class_init (GstJP2kDecimatorClass * klass)
           "Maximum number of decomposition levels to keep (-1 == all)", -1, 32,
           DEFAULT_MAX_DECOMPOSITION_LEVELS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of Threads",
+          "Number of threads used to process the tiles of a frame in "
+          "parallel (1 == no threads)", 1, 64, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -134,6 +142,9 @@ gst_jp2k_decimator_init (GstJP2kDecimator * self,
 {
   self->max_layers = DEFAULT_MAX_LAYERS;
   self->max_decomposition_levels = DEFAULT_MAX_DECOMPOSITION_LEVELS;
+  self->n_threads = DEFAULT_N_THREADS;
+  self->pool_lock = g_mutex_new ();
+  self->pool_cond = g_cond_new ();
 
   self->sinkpad = gst_pad_new_from_static_template (&sink_pad_template, "sink");
   gst_pad_set_chain_function (self->sinkpad,
@@ -165,6 +176,13 @@ gst_jp2k_decimator_init (GstJP2kDecimator * self,
 static void
 gst_jp2k_decimator_finalize (GObject * obj)
 {
+  GstJP2kDecimator *self = GST_JP2K_DECIMATOR (obj);
+
+  if (self->pool)
+    g_thread_pool_free (self->pool, FALSE, TRUE);
+  g_cond_free (self->pool_cond);
+  g_mutex_free (self->pool_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
 
@@ -181,6 +199,11 @@ gst_jp2k_decimator_set_property (GObject * object,
     case PROP_MAX_DECOMPOSITION_LEVELS:
       self->max_decomposition_levels = g_value_get_int (value);
       break;
+    case PROP_N_THREADS:
+      self->n_threads = g_value_get_uint (value);
+      if (self->pool)
+        g_thread_pool_set_max_threads (self->pool, self->n_threads, NULL);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -200,6 +223,9 @@ gst_jp2k_decimator_get_property (GObject * object,
     case PROP_MAX_DECOMPOSITION_LEVELS:
       g_value_set_int (value, self->max_decomposition_levels);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, self->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -308,8 +334,6 @@ gst_jp2k_decimator_decimate_jpc (GstJP2kDecimator * self, GstBuffer * inbuf,
   GstByteWriter writer;
   MainHeader main_header;
 
-  gst_byte_writer_init_with_size (&writer, GST_BUFFER_SIZE (inbuf), FALSE);
-
   /* main header */
   memset (&main_header, 0, sizeof (MainHeader));
   ret = parse_main_header (self, &reader, &main_header);
@@ -320,6 +344,10 @@ gst_jp2k_decimator_decimate_jpc (GstJP2kDecimator * self, GstBuffer * inbuf,
   if (ret != GST_FLOW_OK)
     goto done;
 
+  /* the size is known exactly now, the writer never has to grow */
+  gst_byte_writer_init_with_size (&writer,
+      sizeof_main_header (self, &main_header), FALSE);
+
   ret = write_main_header (self, &writer, &main_header);
   if (ret != GST_FLOW_OK)
     goto done;
@@ -44,6 +44,12 @@ struct _GstJP2kDecimator
 
   gint max_layers;
   gint max_decomposition_levels;
+
+  /* tiles are parsed and decimated in parallel if n_threads > 1 */
+  guint n_threads;
+  GThreadPool *pool;
+  GMutex *pool_lock;
+  GCond *pool_cond;
 };
 
 struct _GstJP2kDecimatorClass
@@ -670,44 +670,96 @@ write_cod (GstJP2kDecimator * self, GstByteWriter * writer,
   return GST_FLOW_OK;
 }
 
+/* Reads length bytes of Iplt/Iplm packet lengths */
 static GstFlowReturn
-parse_plt (GstJP2kDecimator * self, GstByteReader * reader,
-    PacketLengthTilePart * plt, guint length)
+parse_packet_lengths (GstJP2kDecimator * self, GstByteReader * reader,
+    GArray * packet_lengths, guint length)
 {
   guint32 n;
   guint8 b = 0;
   gint i;
 
-  if (length < 3) {
-    GST_ERROR_OBJECT (self, "Invalid PLT");
-    return GST_FLOW_ERROR;
-  }
-
-  plt->index = gst_byte_reader_get_uint8_unchecked (reader);
-  plt->packet_lengths = g_array_new (FALSE, FALSE, sizeof (guint32));
-
-  length -= 3;
-
   n = 0;
   for (i = 0; i < length; i++) {
     b = gst_byte_reader_get_uint8_unchecked (reader);
 
     if ((n & 0xfe000000)) {
-      GST_ERROR_OBJECT (self, "PLT element overflow");
+      GST_ERROR_OBJECT (self, "Packet length overflow");
       return GST_FLOW_ERROR;
     }
 
     n = (n << 7) | (b & 0x7f);
     if ((b & 0x80) == 0x00) {
-      g_array_append_val (plt->packet_lengths, n);
+      g_array_append_val (packet_lengths, n);
       n = 0;
     }
   }
 
   if ((b & 0x80) != 0x00) {
-    GST_ERROR_OBJECT (self, "Truncated PLT");
+    GST_ERROR_OBJECT (self, "Truncated packet lengths");
+    return GST_FLOW_ERROR;
+  }
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+parse_plt (GstJP2kDecimator * self, GstByteReader * reader,
+    PacketLengthTilePart * plt, guint length)
+{
+  if (length < 3) {
+    GST_ERROR_OBJECT (self, "Invalid PLT");
+    return GST_FLOW_ERROR;
+  }
+
+  plt->index = gst_byte_reader_get_uint8_unchecked (reader);
+  plt->packet_lengths = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  return parse_packet_lengths (self, reader, plt->packet_lengths, length - 3);
+}
+
+/* PLM carries the packet lengths of the tile-parts in codestream order,
+ * each preceded by the number of bytes used for them (Nplm) */
+static GstFlowReturn
+parse_plm (GstJP2kDecimator * self, GstByteReader * reader,
+    MainHeader * header, guint length)
+{
+  GstFlowReturn ret;
+
+  if (length < 3) {
+    GST_ERROR_OBJECT (self, "Invalid PLM");
     return GST_FLOW_ERROR;
   }
+
+  /* Zplm, the segments are expected in order */
+  gst_byte_reader_skip_unchecked (reader, 1);
+  length -= 3;
+
+  if (!header->plm)
+    header->plm = g_ptr_array_new ();
+
+  while (length > 0) {
+    PacketLengthTilePart *plt;
+    guint8 n;
+
+    n = gst_byte_reader_get_uint8_unchecked (reader);
+    length -= 1;
+    if (n > length) {
+      GST_ERROR_OBJECT (self,
+          "Tile-part lengths spanning multiple PLM not supported yet");
+      return GST_FLOW_ERROR;
+    }
+
+    plt = g_slice_new (PacketLengthTilePart);
+    plt->index = 0;
+    plt->packet_lengths = g_array_new (FALSE, FALSE, sizeof (guint32));
+    g_ptr_array_add (header->plm, plt);
+
+    ret = parse_packet_lengths (self, reader, plt->packet_lengths, n);
+    if (ret != GST_FLOW_OK)
+      return ret;
+    length -= n;
+  }
+
   return GST_FLOW_OK;
 }
 
@@ -844,7 +896,7 @@ parse_packet (GstJP2kDecimator * self, GstByteReader * reader,
   guint packet_start_pos;
   const guint8 *packet_start_data;
   gboolean sop, eph;
-  PacketLengthTilePart *plt = NULL;
+  const PacketLengthTilePart *plt = NULL;
 
   sop = (tile->cod) ? tile->cod->sop : header->cod.sop;
   eph = (tile->cod) ? tile->cod->eph : header->cod.eph;
@@ -856,6 +908,8 @@ parse_packet (GstJP2kDecimator * self, GstByteReader * reader,
       goto done;
     }
     plt = tile->plt->data;
+  } else {
+    plt = tile->plm;
   }
 
   if (plt) {
@@ -950,12 +1004,14 @@ parse_packet (GstJP2kDecimator * self, GstByteReader * reader,
     packet_start_data = reader->data + reader->byte;
     packet_start_pos = gst_byte_reader_get_pos (reader);
 
-    /* Find end of packet */
+    /* Find end of packet, the end of the tile-part ends the last one */
     while (TRUE) {
-      if (!gst_byte_reader_peek_uint16_be (reader, &marker)) {
-        GST_ERROR_OBJECT (self, "Truncated file");
-        ret = GST_FLOW_ERROR;
-        goto done;
+      if (gst_byte_reader_get_remaining (reader) < 2) {
+        gst_byte_reader_skip_unchecked (reader,
+            gst_byte_reader_get_remaining (reader));
+        marker = MARKER_SOT;
+      } else {
+        marker = gst_byte_reader_peek_uint16_be_unchecked (reader);
       }
 
       if (marker == MARKER_SOP || marker == MARKER_EOC || marker == MARKER_SOT) {
@@ -1345,6 +1401,57 @@ write_packet (GstJP2kDecimator * self, GstByteWriter * writer,
   return GST_FLOW_OK;
 }
 
+/* Retained packets are unchanged and usually adjacent in the input, so
+ * runs of them are copied at once */
+static GstFlowReturn
+write_packets (GstJP2kDecimator * self, GstByteWriter * writer,
+    const Tile * tile)
+{
+  const guint8 *run_start = NULL, *run_end = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GList *l;
+
+  for (l = tile->packets; l; l = l->next) {
+    Packet *p = l->data;
+
+    if (p->data) {
+      /* the SOP marker segment precedes the packet data in the input */
+      const guint8 *start = p->data - (p->sop ? 6 : 0);
+
+      if (run_start && start == run_end) {
+        run_end = p->data + p->length;
+        continue;
+      }
+      if (run_start && !gst_byte_writer_put_data (writer, run_start,
+              run_end - run_start)) {
+        GST_ERROR_OBJECT (self, "Could not ensure free space");
+        return GST_FLOW_ERROR;
+      }
+      run_start = start;
+      run_end = p->data + p->length;
+    } else {
+      if (run_start && !gst_byte_writer_put_data (writer, run_start,
+              run_end - run_start)) {
+        GST_ERROR_OBJECT (self, "Could not ensure free space");
+        return GST_FLOW_ERROR;
+      }
+      run_start = run_end = NULL;
+
+      ret = write_packet (self, writer, p);
+      if (ret != GST_FLOW_OK)
+        return ret;
+    }
+  }
+
+  if (run_start && !gst_byte_writer_put_data (writer, run_start,
+          run_end - run_start)) {
+    GST_ERROR_OBJECT (self, "Could not ensure free space");
+    return GST_FLOW_ERROR;
+  }
+
+  return ret;
+}
+
 static GstFlowReturn
 write_tile (GstJP2kDecimator * self, GstByteWriter * writer,
     const MainHeader * header, Tile * tile)
@@ -1407,13 +1514,7 @@ write_tile (GstJP2kDecimator * self, GstByteWriter * writer,
     goto done;
   }
 
-  for (l = tile->packets; l; l = l->next) {
-    Packet *p = l->data;
-
-    ret = write_packet (self, writer, p);
-    if (ret != GST_FLOW_OK)
-      goto done;
-  }
+  ret = write_packets (self, writer, tile);
 
 done:
 
@@ -1529,9 +1630,9 @@ parse_main_header (GstJP2kDecimator * self, GstByteReader * reader,
         goto done;
         break;
       case MARKER_PLM:
-        GST_ERROR_OBJECT (self, "PLM marker not supported yet");
-        ret = GST_FLOW_ERROR;
-        goto done;
+        ret = parse_plm (self, reader, header, length);
+        if (ret != GST_FLOW_OK)
+          goto done;
         break;
       case MARKER_PPM:
         GST_ERROR_OBJECT (self, "PPM marker not supported yet");
@@ -1592,14 +1693,47 @@ parse_main_header (GstJP2kDecimator * self, GstByteReader * reader,
 
   header->tiles = g_slice_alloc0 (sizeof (Tile) * header->n_tiles);
 
-  /* now at SOT marker, read the tiles */
+  /* now at SOT marker, locate the tile-parts by their Psot, they are
+   * parsed by decimate_main_header () */
   {
     gint i;
 
     for (i = 0; i < header->n_tiles; i++) {
-      ret = parse_tile (self, reader, header, &header->tiles[i]);
-      if (ret != GST_FLOW_OK)
+      Tile *tile = &header->tiles[i];
+      const guint8 *data;
+      guint32 length;
+
+      if (gst_byte_reader_get_remaining (reader) < 12 ||
+          !gst_byte_reader_peek_data (reader, 12, &data)) {
+        GST_ERROR_OBJECT (self, "Truncated tile part");
+        ret = GST_FLOW_ERROR;
+        goto done;
+      }
+
+      if (GST_READ_UINT16_BE (data) != MARKER_SOT) {
+        GST_ERROR_OBJECT (self, "Unexpected marker 0x%04x",
+            GST_READ_UINT16_BE (data));
+        ret = GST_FLOW_ERROR;
+        goto done;
+      }
+
+      /* Psot == 0 means the tile-part extends to the EOC */
+      length = GST_READ_UINT32_BE (data + 6);
+      if (length == 0 && gst_byte_reader_get_remaining (reader) >= 14)
+        length = gst_byte_reader_get_remaining (reader) - 2;
+
+      if (length < 14 || length > gst_byte_reader_get_remaining (reader)) {
+        GST_ERROR_OBJECT (self, "Invalid tile part length %u", length);
+        ret = GST_FLOW_ERROR;
         goto done;
+      }
+
+      tile->data = data;
+      tile->length = length;
+      if (header->plm && i < header->plm->len)
+        tile->plm = g_ptr_array_index (header->plm, i);
+
+      gst_byte_reader_skip_unchecked (reader, length);
     }
   }
 
@@ -1677,6 +1811,16 @@ reset_main_header (GstJP2kDecimator * self, MainHeader * header)
     g_slice_free (Buffer, l->data);
   g_list_free (header->crg);
 
+  if (header->plm) {
+    for (i = 0; i < header->plm->len; i++) {
+      PacketLengthTilePart *plt = g_ptr_array_index (header->plm, i);
+
+      reset_plt (self, plt);
+      g_slice_free (PacketLengthTilePart, plt);
+    }
+    g_ptr_array_free (header->plm, TRUE);
+  }
+
   reset_cod (self, &header->cod);
   reset_siz (self, &header->siz);
 
@@ -1751,67 +1895,160 @@ done:
   return ret;
 }
 
-GstFlowReturn
-decimate_main_header (GstJP2kDecimator * self, MainHeader * header)
+/* Parses the tile-part and drops the packets of the layers and
+ * resolutions that are not kept */
+static GstFlowReturn
+decimate_tile (GstJP2kDecimator * self, const MainHeader * header, Tile * tile)
 {
-  GstFlowReturn ret = GST_FLOW_OK;
-  gint i;
+  GstByteReader reader = GST_BYTE_READER_INIT (tile->data, tile->length);
+  GstFlowReturn ret;
+  GList *l;
+  PacketIterator it;
+  PacketLengthTilePart *plt = NULL;
 
-  for (i = 0; i < header->n_tiles; i++) {
-    Tile *tile = &header->tiles[i];
-    GList *l;
-    PacketIterator it;
-    PacketLengthTilePart *plt = NULL;
+  ret = parse_tile (self, &reader, header, tile);
+  if (ret != GST_FLOW_OK)
+    return ret;
 
-    if (tile->plt) {
-      if (g_list_length (tile->plt) > 1) {
-        GST_ERROR_OBJECT (self, "Multiple PLT per tile not supported yet");
-        ret = GST_FLOW_ERROR;
-        goto done;
-      }
-      plt = g_slice_new (PacketLengthTilePart);
-      plt->index = 0;
-      plt->packet_lengths = g_array_new (FALSE, FALSE, sizeof (guint32));
+  if (tile->plt) {
+    if (g_list_length (tile->plt) > 1) {
+      GST_ERROR_OBJECT (self, "Multiple PLT per tile not supported yet");
+      return GST_FLOW_ERROR;
     }
+  }
 
-    init_packet_iterator (self, &it, header, tile);
-
-    l = tile->packets;
-    while ((it.next (&it))) {
-      Packet *p;
+  /* Packet lengths from PLM are written as PLT of the tile */
+  if (tile->plt || tile->plm) {
+    plt = g_slice_new (PacketLengthTilePart);
+    plt->index = 0;
+    plt->packet_lengths = g_array_new (FALSE, FALSE, sizeof (guint32));
+  }
 
-      if (l == NULL) {
-        GST_ERROR_OBJECT (self, "Not enough packets");
-        ret = GST_FLOW_ERROR;
-        goto done;
-      }
+  init_packet_iterator (self, &it, header, tile);
 
-      p = l->data;
+  l = tile->packets;
+  while ((it.next (&it))) {
+    Packet *p;
 
-      if ((self->max_layers != 0 && it.cur_layer >= self->max_layers) ||
-          (self->max_decomposition_levels != -1
-              && it.cur_resolution > self->max_decomposition_levels)) {
-        p->data = NULL;
-        p->length = 1;
-      }
+    if (l == NULL) {
+      GST_ERROR_OBJECT (self, "Not enough packets");
+      ret = GST_FLOW_ERROR;
+      goto done;
+    }
 
-      if (plt) {
-        guint32 len = sizeof_packet (self, p);
-        g_array_append_val (plt->packet_lengths, len);
-      }
+    p = l->data;
 
-      l = l->next;
+    if ((self->max_layers != 0 && it.cur_layer >= self->max_layers) ||
+        (self->max_decomposition_levels != -1
+            && it.cur_resolution > self->max_decomposition_levels)) {
+      p->data = NULL;
+      p->length = 1;
     }
 
     if (plt) {
+      guint32 len = sizeof_packet (self, p);
+      g_array_append_val (plt->packet_lengths, len);
+    }
+
+    l = l->next;
+  }
+
+  if (plt) {
+    if (tile->plt) {
       reset_plt (self, tile->plt->data);
       g_slice_free (PacketLengthTilePart, tile->plt->data);
       tile->plt->data = plt;
+    } else {
+      tile->plt = g_list_append (NULL, plt);
     }
-
-    tile->sot.tile_part_size = sizeof_tile (self, tile);
+    plt = NULL;
   }
 
+  tile->sot.tile_part_size = sizeof_tile (self, tile);
+
 done:
+  if (plt) {
+    reset_plt (self, plt);
+    g_slice_free (PacketLengthTilePart, plt);
+  }
+
+  return ret;
+}
+
+typedef struct
+{
+  GstJP2kDecimator *self;
+  const MainHeader *header;
+  Tile *tile;
+  GstFlowReturn ret;
+  gint *pending;
+} TileJob;
+
+static void
+decimate_tile_func (TileJob * job, gpointer user_data)
+{
+  GstJP2kDecimator *self = job->self;
+
+  job->ret = decimate_tile (self, job->header, job->tile);
+
+  g_mutex_lock (self->pool_lock);
+  *job->pending -= 1;
+  if (*job->pending == 0)
+    g_cond_signal (self->pool_cond);
+  g_mutex_unlock (self->pool_lock);
+}
+
+GstFlowReturn
+decimate_main_header (GstJP2kDecimator * self, MainHeader * header)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  TileJob *jobs;
+  gint i, pending;
+
+  if (self->n_threads > 1 && header->n_tiles > 1 && !self->pool) {
+    GError *err = NULL;
+
+    self->pool = g_thread_pool_new ((GFunc) decimate_tile_func, NULL,
+        self->n_threads, FALSE, &err);
+    if (!self->pool) {
+      GST_WARNING_OBJECT (self, "Could not create threads: %s",
+          err ? err->message : "unknown error");
+      g_clear_error (&err);
+    }
+  }
+
+  if (self->n_threads <= 1 || header->n_tiles <= 1 || !self->pool) {
+    for (i = 0; i < header->n_tiles; i++) {
+      ret = decimate_tile (self, header, &header->tiles[i]);
+      if (ret != GST_FLOW_OK)
+        break;
+    }
+    return ret;
+  }
+
+  jobs = g_new (TileJob, header->n_tiles);
+  pending = header->n_tiles;
+  for (i = 0; i < header->n_tiles; i++) {
+    jobs[i].self = self;
+    jobs[i].header = header;
+    jobs[i].tile = &header->tiles[i];
+    jobs[i].ret = GST_FLOW_OK;
+    jobs[i].pending = &pending;
+    g_thread_pool_push (self->pool, &jobs[i], NULL);
+  }
+
+  g_mutex_lock (self->pool_lock);
+  while (pending > 0)
+    g_cond_wait (self->pool_cond, self->pool_lock);
+  g_mutex_unlock (self->pool_lock);
+
+  for (i = 0; i < header->n_tiles; i++) {
+    if (jobs[i].ret != GST_FLOW_OK) {
+      ret = jobs[i].ret;
+      break;
+    }
+  }
+  g_free (jobs);
+
   return ret;
 }
@@ -129,6 +129,14 @@ typedef struct
 
   /* TODO: COC, PPT */
 
+  /* The tile-part from SOT on, located by parse_main_header () */
+  const guint8 *data;
+  guint length;
+
+  /* Packet lengths of the tile-part from the main header PLM, used if the
+   * tile-part has no PLT */
+  const PacketLengthTilePart *plm;
+
   /* Calculated value */
   gint tile_x, tile_y;
   gint tx0, tx1, ty0, ty1;      /* tile dimensions */
@@ -144,7 +152,10 @@ typedef struct
   GList *qcc;                   /* list of Buffer */
   GList *crg, *com;             /* lists of Buffer */
 
-  /* TODO: COC, PPM, TLM, PLM */
+  GPtrArray *plm;               /* PacketLengthTilePart per tile-part, from
+                                 * PLM; written as PLT in the tiles */
+
+  /* TODO: COC, PPM, TLM */
 
   guint n_tiles_x, n_tiles_y, n_tiles;  /* calculated */
   Tile *tiles;
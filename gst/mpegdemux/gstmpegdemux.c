@@ -62,6 +62,15 @@
 
 #define DURATION_SCAN_LIMIT         4 * 1024 * 1024
 
+/* Seeking in pull mode: the SCR is bisected until the pack we look for is
+ * within SEEK_BISECT_SZ bytes, with at most SEEK_MAX_PROBES probes. Index
+ * entries closer than SCR_INDEX_INTERVAL are not kept. Key unit seeks look
+ * back at most KEYFRAME_MAX_DISTANCE for a sequence or GOP header */
+#define SEEK_BISECT_SZ              BLOCK_SZ
+#define SEEK_MAX_PROBES             32
+#define SCR_INDEX_INTERVAL          (CLOCK_FREQ / 4)
+#define KEYFRAME_MAX_DISTANCE       (5 * CLOCK_FREQ)
+
 typedef enum
 {
   SCAN_SCR,
@@ -76,6 +85,12 @@ typedef enum
 
 #define ADAPTER_OFFSET_FLUSH(_bytes_) demux->adapter_offset += (_bytes_)
 
+typedef struct
+{
+  guint64 offset;
+  guint64 scr;
+} GstFluPSIndexEntry;
+
 GST_DEBUG_CATEGORY_STATIC (gstflupsdemux_debug);
 #define GST_CAT_DEFAULT (gstflupsdemux_debug)
 
@@ -159,6 +174,8 @@ static inline gboolean gst_flups_demux_scan_forward_ts (GstFluPSDemux * demux,
     guint64 * pos, SCAN_MODE mode, guint64 * rts, gint limit);
 static inline gboolean gst_flups_demux_scan_backward_ts (GstFluPSDemux * demux,
     guint64 * pos, SCAN_MODE mode, guint64 * rts, gint limit);
+static inline gboolean gst_flups_demux_scan_ts (GstFluPSDemux * demux,
+    const guint8 * data, SCAN_MODE mode, guint64 * rts);
 
 static inline void gst_flups_demux_send_segment_updates (GstFluPSDemux * demux,
     GstClockTime new_time);
@@ -262,6 +279,7 @@ gst_flups_demux_init (GstFluPSDemux * demux)
       g_malloc0 (sizeof (GstFluPSStream *) * (GST_FLUPS_DEMUX_MAX_STREAMS));
   demux->found_count = 0;
 
+  demux->scr_index = g_array_new (FALSE, FALSE, sizeof (GstFluPSIndexEntry));
 }
 
 static void
@@ -270,6 +288,7 @@ gst_flups_demux_finalize (GstFluPSDemux * demux)
   gst_flups_demux_reset (demux);
   g_free (demux->streams);
   g_free (demux->streams_found);
+  g_array_free (demux->scr_index, TRUE);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (demux));
 }
@@ -1027,14 +1046,192 @@ not_supported:
   }
 }
 
+/* Returns the position of the first pack start code in the @size bytes at
+ * @data, or -1. The byte checked is the 0x01 of the prefix, which lets us
+ * skip three bytes whenever it is larger than 1 */
+static inline gint
+gst_flups_demux_find_pack_start (const guint8 * data, guint size)
+{
+  guint i = 2;
+
+  while (i + 1 < size) {
+    if (data[i] > 1)
+      i += 3;
+    else if (data[i] == 0)
+      i++;
+    else {
+      if (data[i - 1] == 0 && data[i - 2] == 0 && data[i + 1] == 0xba)
+        return i - 2;
+      i += 3;
+    }
+  }
+  return -1;
+}
+
+/* Returns the position of the last MPEG video sequence header or GOP start
+ * code in the @size bytes at @data, or -1 */
+static inline gint
+gst_flups_demux_find_keyframe_code (const guint8 * data, guint size)
+{
+  gint i = (gint) size - 4;
+
+  while (i >= 0) {
+    if (data[i] > 1)
+      i -= 3;
+    else if (data[i] == 1)
+      i -= 2;
+    else if (data[i + 1] == 0 && data[i + 2] == 1 &&
+        (data[i + 3] == 0xb3 || data[i + 3] == 0xb8))
+      return i;
+    else
+      i--;
+  }
+  return -1;
+}
+
+/* Adds the pack at @offset with @scr to the index, unless it is too close
+ * to an entry we already have or out of order (SCR discontinuities) */
+static void
+gst_flups_demux_index_add (GstFluPSDemux * demux, guint64 offset, guint64 scr)
+{
+  GstFluPSIndexEntry *entries = (GstFluPSIndexEntry *) demux->scr_index->data;
+  GstFluPSIndexEntry entry;
+  guint lo = 0, hi = demux->scr_index->len, mid;
+
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (entries[mid].offset < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  if (lo > 0 && (entries[lo - 1].scr > scr ||
+          scr - entries[lo - 1].scr < SCR_INDEX_INTERVAL))
+    return;
+  if (lo < demux->scr_index->len && (entries[lo].offset == offset ||
+          entries[lo].scr < scr || entries[lo].scr - scr < SCR_INDEX_INTERVAL))
+    return;
+
+  entry.offset = offset;
+  entry.scr = scr;
+  g_array_insert_val (demux->scr_index, lo, entry);
+}
+
+/* Narrows @lo and @hi down to the index entries around @scr */
+static void
+gst_flups_demux_index_lookup (GstFluPSDemux * demux, guint64 scr,
+    GstFluPSIndexEntry * lo, GstFluPSIndexEntry * hi)
+{
+  GstFluPSIndexEntry *entries = (GstFluPSIndexEntry *) demux->scr_index->data;
+  guint l = 0, h = demux->scr_index->len, mid;
+
+  while (l < h) {
+    mid = (l + h) / 2;
+    if (entries[mid].scr <= scr)
+      l = mid + 1;
+    else
+      h = mid;
+  }
+
+  if (l > 0 && entries[l - 1].offset > lo->offset &&
+      entries[l - 1].offset < hi->offset)
+    *lo = entries[l - 1];
+  if (l < demux->scr_index->len && entries[l].offset < hi->offset &&
+      entries[l].offset > lo->offset)
+    *hi = entries[l];
+}
+
+static gboolean
+gst_flups_demux_has_mpeg_video (GstFluPSDemux * demux)
+{
+  gint i;
+
+  for (i = 0; i < demux->found_count; i++) {
+    gint type = demux->streams_found[i]->type;
+
+    if (type == ST_VIDEO_MPEG1 || type == ST_VIDEO_MPEG2 ||
+        type == ST_GST_VIDEO_MPEG1_OR_2)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* Looks back from @end for the closest video sequence header or GOP, no
+ * further than KEYFRAME_MAX_DISTANCE before @scr, and returns the offset
+ * and SCR of the pack it starts in */
+static gboolean
+gst_flups_demux_find_keyframe (GstFluPSDemux * demux, guint64 end,
+    guint64 * offset, guint64 * scr)
+{
+  GstBuffer *buffer;
+  guint64 start, limit, span;
+  guint8 *data;
+  gint pos, i;
+
+  span = gst_util_uint64_scale (KEYFRAME_MAX_DISTANCE, demux->scr_rate_n,
+      demux->scr_rate_d);
+  /* the bitrate is only an average, leave room for busier sections */
+  span *= 2;
+  limit = end > span ? end - span : 0;
+
+  while (end > limit) {
+    start = end > limit + BLOCK_SZ ? end - BLOCK_SZ : limit;
+
+    /* overlap with the next block so start codes at the boundary are found */
+    if (gst_pad_pull_range (demux->sinkpad, start, end - start + 3,
+            &buffer) != GST_FLOW_OK)
+      return FALSE;
+
+    data = GST_BUFFER_DATA (buffer);
+    pos = gst_flups_demux_find_keyframe_code (data, GST_BUFFER_SIZE (buffer));
+    while (pos >= 0) {
+      /* make sure the code is in a video PES, the closest system start code
+       * before it must be a video stream id */
+      for (i = pos - 1; i >= 2; i--) {
+        if (data[i - 2] == 0 && data[i - 1] == 0 && data[i] == 1 &&
+            data[i + 1] >= 0xb9)
+          break;
+      }
+      if (i < 2 || (data[i + 1] & 0xf0) == 0xe0)
+        break;
+      pos = gst_flups_demux_find_keyframe_code (data, pos + 3);
+    }
+    gst_buffer_unref (buffer);
+
+    if (pos >= 0) {
+      guint64 kf_offset = start + pos, kf_scr;
+
+      if (!gst_flups_demux_scan_backward_ts (demux, &kf_offset, SCAN_SCR,
+              &kf_scr, 0))
+        return FALSE;
+
+      if (kf_scr > *scr || *scr - kf_scr > KEYFRAME_MAX_DISTANCE)
+        return FALSE;
+
+      GST_DEBUG_OBJECT (demux, "keyframe in pack at %" G_GUINT64_FORMAT
+          " SCR %" G_GUINT64_FORMAT, kf_offset, kf_scr);
+      *offset = kf_offset;
+      *scr = kf_scr;
+      return TRUE;
+    }
+    end = start;
+  }
+
+  return FALSE;
+}
+
 static inline void
-gst_flups_demux_do_seek (GstFluPSDemux * demux, GstSegment * seeksegment)
+gst_flups_demux_do_seek (GstFluPSDemux * demux, GstSegment * seeksegment,
+    gboolean keyframe)
 {
-  gboolean found;
-  guint64 fscr, offset;
+  GstFluPSIndexEntry lo, hi, probe;
+  GstBuffer *buffer;
   guint64 scr = GSTTIME_TO_MPEGTIME (seeksegment->last_stop + demux->base_time);
-  guint64 scr_rate_n = demux->last_scr_offset - demux->first_scr_offset;
-  guint64 scr_rate_d = demux->last_scr - demux->first_scr;
+  guint64 offset, next, span, ts;
+  guint8 *data;
+  guint size, pos, probes = 0;
+  gint skip;
 
   /* In some clips the PTS values are completely unaligned with SCR values.
    * To improve the seek in that situation we apply a factor considering the
@@ -1044,37 +1241,106 @@ gst_flups_demux_do_seek (GstFluPSDemux * demux, GstSegment * seeksegment)
 
   scr = MIN (demux->last_scr, scr);
   scr = MAX (demux->first_scr, scr);
-  fscr = scr;
 
   GST_INFO_OBJECT (demux, "sink segment configured %" GST_SEGMENT_FORMAT
       ", trying to go at SCR: %" G_GUINT64_FORMAT, &demux->sink_segment, scr);
 
-  offset =
-      MIN (gst_util_uint64_scale (scr - demux->first_scr, scr_rate_n,
-          scr_rate_d), demux->sink_segment.stop);
+  /* Bisect the SCR between the closest packs we know of. The probe position
+   * is interpolated inside the bracket, but kept away from its ends so that
+   * very uneven bitrates still halve it quickly */
+  lo.offset = demux->first_scr_offset;
+  lo.scr = demux->first_scr;
+  hi.offset = demux->last_scr_offset;
+  hi.scr = demux->last_scr;
+  gst_flups_demux_index_lookup (demux, scr, &lo, &hi);
+  if (hi.scr <= scr)
+    lo = hi;
+
+  while (hi.offset - lo.offset > SEEK_BISECT_SZ && lo.scr < scr &&
+      hi.scr > scr && probes++ < SEEK_MAX_PROBES) {
+    span = hi.offset - lo.offset;
+    offset = lo.offset + gst_util_uint64_scale (span, scr - lo.scr,
+        hi.scr - lo.scr);
+    offset = CLAMP (offset, lo.offset + span / 8, hi.offset - span / 8);
+
+    probe.offset = offset;
+    if (!gst_flups_demux_scan_forward_ts (demux, &probe.offset, SCAN_SCR,
+            &probe.scr, MIN (hi.offset - offset, G_MAXINT)) ||
+        probe.offset >= hi.offset) {
+      /* no pack between the probe and the upper end */
+      hi.offset = offset;
+      continue;
+    }
+
+    GST_LOG_OBJECT (demux, "probe at %" G_GUINT64_FORMAT " found SCR %"
+        G_GUINT64_FORMAT " at %" G_GUINT64_FORMAT, offset, probe.scr,
+        probe.offset);
+    gst_flups_demux_index_add (demux, probe.offset, probe.scr);
 
-  found = gst_flups_demux_scan_forward_ts (demux, &offset, SCAN_SCR, &fscr, 0);
-  if (!found) {
-    found =
-        gst_flups_demux_scan_backward_ts (demux, &offset, SCAN_SCR, &fscr, 0);
+    if (probe.scr <= scr)
+      lo = probe;
+    else
+      hi = probe;
   }
 
-  while (found && fscr < scr) {
-    offset++;
-    found =
-        gst_flups_demux_scan_forward_ts (demux, &offset, SCAN_SCR, &fscr, 0);
+  /* The pack we want is within a block now, look for the last one not
+   * after the target in one pull */
+  next = hi.offset;
+  size = MIN (hi.offset - lo.offset, 2 * SEEK_BISECT_SZ) + SCAN_PTS_SZ;
+  if (hi.offset > lo.offset + 1 &&
+      gst_pad_pull_range (demux->sinkpad, lo.offset, size,
+          &buffer) == GST_FLOW_OK) {
+    data = GST_BUFFER_DATA (buffer);
+    size = GST_BUFFER_SIZE (buffer);
+
+    for (pos = 1; pos + SCAN_PTS_SZ <= size; pos++) {
+      skip = gst_flups_demux_find_pack_start (data + pos, size - pos);
+      if (skip < 0)
+        break;
+      pos += skip;
+      if (pos + SCAN_PTS_SZ > size || lo.offset + pos >= hi.offset)
+        break;
+      if (!gst_flups_demux_scan_ts (demux, data + pos, SCAN_SCR, &ts))
+        continue;
+      if (ts > scr) {
+        next = lo.offset + pos;
+        break;
+      }
+      lo.offset += pos;
+      lo.scr = ts;
+      data += pos;
+      size -= pos;
+      pos = 0;
+    }
+    gst_buffer_unref (buffer);
   }
 
-  while (found && fscr > scr && offset > 0) {
-    offset--;
-    found =
-        gst_flups_demux_scan_backward_ts (demux, &offset, SCAN_SCR, &fscr, 0);
+  GST_INFO_OBJECT (demux, "found SCR %" G_GUINT64_FORMAT " at offset %"
+      G_GUINT64_FORMAT " after %u probes", lo.scr, lo.offset, probes);
+
+  if (keyframe && gst_flups_demux_has_mpeg_video (demux) &&
+      gst_flups_demux_find_keyframe (demux, next, &lo.offset, &lo.scr)) {
+    GstClockTime time;
+
+    /* start the segment at the keyframe so that it is not clipped */
+    ts = lo.scr;
+    if (demux->last_scr > demux->last_pts)
+      ts = gst_util_uint64_scale (ts, demux->last_pts, demux->last_scr);
+    time = MPEGTIME_TO_GSTTIME (ts);
+    time = time > demux->base_time ? time - demux->base_time : 0;
+
+    if (seeksegment->rate > 0.0 && time < seeksegment->start) {
+      seeksegment->start = time;
+      seeksegment->last_stop = time;
+      seeksegment->time = time;
+    }
   }
 
   GST_INFO_OBJECT (demux, "doing seek at offset %" G_GUINT64_FORMAT
       " SCR: %" G_GUINT64_FORMAT " %" GST_TIME_FORMAT,
-      offset, fscr, GST_TIME_ARGS (MPEGTIME_TO_GSTTIME (fscr)));
-  gst_segment_set_last_stop (&demux->sink_segment, GST_FORMAT_BYTES, offset);
+      lo.offset, lo.scr, GST_TIME_ARGS (MPEGTIME_TO_GSTTIME (lo.scr)));
+  gst_segment_set_last_stop (&demux->sink_segment, GST_FORMAT_BYTES,
+      lo.offset);
 }
 
 static gboolean
@@ -1085,7 +1351,7 @@ gst_flups_demux_handle_seek_pull (GstFluPSDemux * demux, GstEvent * event)
   GstSeekType start_type, stop_type;
   gint64 start, stop;
   gdouble rate;
-  gboolean update, flush;
+  gboolean update, flush, keyframe;
   GstSegment seeksegment;
   GstClockTime first_pts = MPEGTIME_TO_GSTTIME (demux->first_pts);
 
@@ -1103,7 +1369,7 @@ gst_flups_demux_handle_seek_pull (GstFluPSDemux * demux, GstEvent * event)
     goto no_scr_rate;
 
   flush = flags & GST_SEEK_FLAG_FLUSH;
-  /* keyframe = flags & GST_SEEK_FLAG_KEY_UNIT; *//* FIXME */
+  keyframe = flags & GST_SEEK_FLAG_KEY_UNIT;
 
   if (flush) {
     /* Flush start up and downstream to make sure data flow and loops are
@@ -1140,7 +1406,7 @@ gst_flups_demux_handle_seek_pull (GstFluPSDemux * demux, GstEvent * event)
 
   if (flush || seeksegment.last_stop != demux->src_segment.last_stop) {
     /* Do the actual seeking */
-    gst_flups_demux_do_seek (demux, &seeksegment);
+    gst_flups_demux_do_seek (demux, &seeksegment, keyframe);
   }
 
   /* check the limits */
@@ -1580,6 +1846,11 @@ gst_flups_demux_parse_pack_start (GstFluPSDemux * demux)
   }
   new_rate *= MPEG_MUX_RATE_MULT;
 
+  /* remember where this SCR is for later seeks */
+  if (demux->random_access && demux->sink_segment.rate > 0.0 &&
+      demux->adapter_offset != G_MAXUINT64)
+    gst_flups_demux_index_add (demux, demux->adapter_offset, scr);
+
   /* scr adjusted is the new scr found + the colected adjustment */
   scr_adjusted = scr + demux->scr_adjust;
 
@@ -2398,6 +2669,7 @@ gst_flups_demux_scan_forward_ts (GstFluPSDemux * demux, guint64 * pos,
   guint cursor, to_read = BLOCK_SZ;
   guint8 *data;
   guint end_scan, data_size;
+  gint skip;
 
   do {
     if (offset + scan_sz > demux->sink_segment.stop)
@@ -2422,9 +2694,16 @@ gst_flups_demux_scan_forward_ts (GstFluPSDemux * demux, guint64 * pos,
     data = GST_BUFFER_DATA (buffer);
     end_scan = data_size - scan_sz;
 
-    /* scan the block */
+    /* scan the block, only trying the positions of pack start codes */
     for (cursor = 0; !found && cursor <= end_scan; cursor++) {
-      found = gst_flups_demux_scan_ts (demux, data++, mode, &ts);
+      skip = gst_flups_demux_find_pack_start (data + cursor,
+          end_scan - cursor + 4);
+      if (skip < 0) {
+        cursor = end_scan + 1;
+        break;
+      }
+      cursor += skip;
+      found = gst_flups_demux_scan_ts (demux, data + cursor, mode, &ts);
     }
 
     /* done with the buffer, unref it */
@@ -3002,6 +3281,7 @@ gst_flups_demux_change_state (GstElement * element, GstStateChange transition)
       demux->first_pts = G_MAXUINT64;
       demux->last_pts = G_MAXUINT64;
       gst_flups_demux_reset_psm (demux);
+      g_array_set_size (demux->scr_index, 0);
       gst_segment_init (&demux->sink_segment, GST_FORMAT_UNDEFINED);
       gst_segment_init (&demux->src_segment, GST_FORMAT_TIME);
       gst_flups_demux_flush (demux);
@@ -126,6 +126,10 @@ struct _GstFluPSDemux
   guint64 first_pts;
   guint64 last_pts;
 
+  /* Pack offsets and SCRs learnt in pull mode while seeking and playing,
+   * sorted by offset */
+  GArray *scr_index;
+
   gint16 psm[GST_FLUPS_DEMUX_MAX_PSM];
 
   GstSegment sink_segment;
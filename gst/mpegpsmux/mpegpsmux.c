@@ -94,8 +94,7 @@ static void gst_mpegpsmux_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 
 static void mpegpsmux_dispose (GObject * object);
-static gboolean new_packet_cb (guint8 * data, guint len, void *user_data);
-static void release_buffer_cb (guint8 * data, void *user_data);
+static gboolean new_packet_cb (GstBufferList * list, void *user_data);
 
 static gboolean mpegpsdemux_prepare_srcpad (MpegPsMux * mux);
 static GstFlowReturn mpegpsmux_collected (GstCollectPads * pads,
@@ -219,15 +218,6 @@ gst_mpegpsmux_get_property (GObject * object, guint prop_id,
   }
 }
 
-static void
-release_buffer_cb (guint8 * data, void *user_data)
-{
-  /* release a given buffer. callback func */
-
-  GstBuffer *buf = (GstBuffer *) user_data;
-  gst_buffer_unref (buf);
-}
-
 static GstFlowReturn
 mpegpsmux_create_stream (MpegPsMux * mux, MpegPsPadData * ps_data, GstPad * pad)
 {
@@ -347,8 +337,6 @@ mpegpsmux_create_stream (MpegPsMux * mux, MpegPsPadData * ps_data, GstPad * pad)
     gst_structure_get_int (s, "channels", &ps_data->stream->audio_channels);
     gst_structure_get_int (s, "bitrate", &ps_data->stream->audio_bitrate);
 
-    psmux_stream_set_buffer_release_func (ps_data->stream, release_buffer_cb);
-
     ret = GST_FLOW_OK;
 
     if (is_video && mux->video_stream_id == 0) {
@@ -550,8 +538,7 @@ mpegpsmux_collected (GstCollectPads * pads, MpegPsMux * mux)
     }
 
     /* give the buffer to libpsmux for processing */
-    psmux_stream_add_data (best->stream, GST_BUFFER_DATA (buf),
-        GST_BUFFER_SIZE (buf), buf, pts, -1, keyunit);
+    psmux_stream_add_data (best->stream, buf, pts, -1, keyunit);
 
     best->queued_buf = NULL;
 
@@ -567,12 +554,12 @@ mpegpsmux_collected (GstCollectPads * pads, MpegPsMux * mux)
   } else {
     /* FIXME: Drain all remaining streams */
     /* At EOS */
-    if (mux->gop_list != NULL)
-      mpegpsmux_push_gop_list (mux);
-
-    if (psmux_write_end_code (mux->psmux)) {
+    if (!psmux_write_end_code (mux->psmux)) {
       GST_WARNING_OBJECT (mux, "Writing MPEG PS Program end code failed.");
     }
+
+    if (mux->gop_list != NULL)
+      mpegpsmux_push_gop_list (mux);
     gst_pad_push_event (mux->srcpad, gst_event_new_eos ());
   }
 
@@ -653,52 +640,71 @@ mpegpsmux_release_pad (GstElement * element, GstPad * pad)
 }
 
 static void
-add_buffer_to_goplist (MpegPsMux * mux, GstBuffer * buf)
+add_list_to_goplist (MpegPsMux * mux, GstBufferList * list)
 {
-  GstBufferListIterator *it;
+  GstBufferListIterator *it, *gop_it;
+  GstBuffer *buf;
 
   if (mux->gop_list == NULL)
     mux->gop_list = gst_buffer_list_new ();
 
-  it = gst_buffer_list_iterate (mux->gop_list);
+  gop_it = gst_buffer_list_iterate (mux->gop_list);
 
   /* move iterator to end */
-  while (gst_buffer_list_iterator_next_group (it)) {
+  while (gst_buffer_list_iterator_next_group (gop_it)) {
     /* .. */
   }
 
-  gst_buffer_list_iterator_add_group (it);
-  gst_buffer_list_iterator_add (it, buf);
+  gst_buffer_list_iterator_add_group (gop_it);
+
+  it = gst_buffer_list_iterate (list);
+  gst_buffer_list_iterator_next_group (it);
+  while ((buf = gst_buffer_list_iterator_next (it)))
+    gst_buffer_list_iterator_add (gop_it, gst_buffer_ref (buf));
   gst_buffer_list_iterator_free (it);
+
+  gst_buffer_list_iterator_free (gop_it);
+  gst_buffer_list_unref (list);
+}
+
+static GstBuffer *
+set_packet_metadata (GstBuffer * buf, MpegPsMux * mux)
+{
+  buf = gst_buffer_make_metadata_writable (buf);
+  gst_buffer_set_caps (buf, GST_PAD_CAPS (mux->srcpad));
+  GST_BUFFER_TIMESTAMP (buf) = mux->last_ts;
+
+  return buf;
 }
 
 static gboolean
-new_packet_cb (guint8 * data, guint len, void *user_data)
+new_packet_cb (GstBufferList * list, void *user_data)
 {
   /* Called when the PsMux has prepared a packet for output. Return FALSE
    * on error */
 
   MpegPsMux *mux = (MpegPsMux *) user_data;
-  GstBuffer *buf;
+  GstBufferListIterator *it;
   GstFlowReturn ret;
 
-  GST_LOG_OBJECT (mux, "Outputting a packet of length %d", len);
-  buf = gst_buffer_new_and_alloc (len);
-  if (G_UNLIKELY (buf == NULL)) {
-    mux->last_flow_ret = GST_FLOW_ERROR;
-    return FALSE;
+  /* the headers and the payload are output without copying, the caps and
+   * timestamp go on the first buffer of the group */
+  it = gst_buffer_list_iterate (list);
+  if (gst_buffer_list_iterator_next_group (it)) {
+    GST_LOG_OBJECT (mux, "Outputting a packet of %u buffers",
+        gst_buffer_list_iterator_n_buffers (it));
+    if (gst_buffer_list_iterator_next (it))
+      gst_buffer_list_iterator_do (it,
+          (GstBufferListDoFunction) set_packet_metadata, mux);
   }
-  gst_buffer_set_caps (buf, GST_PAD_CAPS (mux->srcpad));
-
-  memcpy (GST_BUFFER_DATA (buf), data, len);
-  GST_BUFFER_TIMESTAMP (buf) = mux->last_ts;
+  gst_buffer_list_iterator_free (it);
 
   if (mux->aggregate_gops) {
-    add_buffer_to_goplist (mux, buf);
+    add_list_to_goplist (mux, list);
     return TRUE;
   }
 
-  ret = gst_pad_push (mux->srcpad, buf);
+  ret = gst_pad_push_list (mux->srcpad, list);
 
   if (G_UNLIKELY (ret != GST_FLOW_OK)) {
     mux->last_flow_ret = ret;
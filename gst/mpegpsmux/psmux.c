@@ -54,10 +54,11 @@
 #include "psmux.h"
 #include "crc.h"
 
-static gboolean psmux_packet_out (PsMux * mux);
-static gboolean psmux_write_pack_header (PsMux * mux);
-static gboolean psmux_write_system_header (PsMux * mux);
-static gboolean psmux_write_program_stream_map (PsMux * mux);
+static gboolean psmux_packet_out (PsMux * mux, GstBufferList * list);
+static void psmux_write_pack_header (PsMux * mux, GstBufferListIterator * it);
+static void psmux_write_system_header (PsMux * mux, GstBufferListIterator * it);
+static void psmux_write_program_stream_map (PsMux * mux,
+    GstBufferListIterator * it);
 
 /**
  * psmux_new:
@@ -114,8 +115,22 @@ psmux_set_write_func (PsMux * mux, PsMuxWriteFunc func, void *user_data)
 gboolean
 psmux_write_end_code (PsMux * mux)
 {
-  guint8 end_code[4] = { 0, 0, 1, PSMUX_PROGRAM_END };
-  return mux->write_func (end_code, 4, mux->write_func_data);
+  GstBufferList *list;
+  GstBufferListIterator *it;
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_and_alloc (4);
+  GST_WRITE_UINT32_BE (GST_BUFFER_DATA (buf),
+      (PSMUX_START_CODE_PREFIX << 8) | PSMUX_PROGRAM_END);
+
+  list = gst_buffer_list_new ();
+  it = gst_buffer_list_iterate (list);
+  gst_buffer_list_iterator_add_group (it);
+  gst_buffer_list_iterator_add (it, buf);
+  gst_buffer_list_iterator_free (it);
+  mux->packet_bytes_written = 4;
+
+  return psmux_packet_out (mux, list);
 }
 
 
@@ -203,14 +218,16 @@ psmux_create_stream (PsMux * mux, PsMuxStreamType stream_type)
 }
 
 static gboolean
-psmux_packet_out (PsMux * mux)
+psmux_packet_out (PsMux * mux, GstBufferList * list)
 {
   gboolean res;
-  if (G_UNLIKELY (mux->write_func == NULL))
+  if (G_UNLIKELY (mux->write_func == NULL)) {
+    gst_buffer_list_unref (list);
+    mux->packet_bytes_written = 0;
     return TRUE;
+  }
 
-  res = mux->write_func (mux->packet_buf, mux->packet_bytes_written,
-      mux->write_func_data);
+  res = mux->write_func (list, mux->write_func_data);
 
   if (res) {
     mux->bit_size += mux->packet_bytes_written;
@@ -224,13 +241,18 @@ psmux_packet_out (PsMux * mux)
  * @mux: a #PsMux
  * @stream: a #PsMuxStream
  *
- * Write a packet of @stream.
+ * Write a packet of @stream, preceded by the pack header, system header and
+ * program stream map if they are due. Everything is handed to the write
+ * function as one buffer list group.
  *
  * Returns: TRUE if the packet could be written.
  */
 gboolean
 psmux_write_stream_packet (PsMux * mux, PsMuxStream * stream)
 {
+  GstBufferList *list;
+  GstBufferListIterator *it;
+  guint len;
   gboolean res;
 
   g_return_val_if_fail (mux != NULL, FALSE);
@@ -243,6 +265,10 @@ psmux_write_stream_packet (PsMux * mux, PsMuxStream * stream)
       mux->pts = ts;
   }
 
+  list = gst_buffer_list_new ();
+  it = gst_buffer_list_iterate (list);
+  gst_buffer_list_iterator_add_group (it);
+
   if (mux->pts - mux->pack_hdr_pts > PSMUX_PACK_HDR_INTERVAL
       || mux->pes_cnt % mux->pack_hdr_freq == 0) {
     /* Time to write pack header */
@@ -263,30 +289,34 @@ psmux_write_stream_packet (PsMux * mux, PsMuxStream * stream)
       mux->bit_pts = mux->pts;
     }
 
-    psmux_write_pack_header (mux);
+    psmux_write_pack_header (mux, it);
     mux->pack_hdr_pts = mux->pts;
   }
 
   if (mux->pes_cnt % mux->sys_hdr_freq == 0) {
     /* Time to write system header */
-    psmux_write_system_header (mux);
+    psmux_write_system_header (mux, it);
     mux->sys_hdr_pts = mux->pts;
   }
 
   if (mux->pes_cnt % mux->psm_freq == 0) {
     /* Time to write program stream map (PSM) */
-    psmux_write_program_stream_map (mux);
+    psmux_write_program_stream_map (mux, it);
     mux->psm_pts = mux->pts;
   }
 
   /* Write the packet */
-  if (!(mux->packet_bytes_written =
-          psmux_stream_get_data (stream, mux->packet_buf,
-              mux->pes_max_payload + PSMUX_PES_MAX_HDR_LEN))) {
+  len = psmux_stream_get_data (stream, it,
+      mux->pes_max_payload + PSMUX_PES_MAX_HDR_LEN);
+  gst_buffer_list_iterator_free (it);
+  if (!len) {
+    gst_buffer_list_unref (list);
+    mux->packet_bytes_written = 0;
     return FALSE;
   }
+  mux->packet_bytes_written += len;
 
-  res = psmux_packet_out (mux);
+  res = psmux_packet_out (mux, list);
   if (!res) {
     PS_DEBUG ("packet write false");
     return FALSE;
@@ -297,16 +327,19 @@ psmux_write_stream_packet (PsMux * mux, PsMuxStream * stream)
   return res;
 }
 
-static gboolean
-psmux_write_pack_header (PsMux * mux)
+static void
+psmux_write_pack_header (PsMux * mux, GstBufferListIterator * it)
 {
+  GstBuffer *buf;
   bits_buffer_t bw;
   guint64 scr = mux->pts;       /* XXX: is this correct? necessary to put any offset? */
   if (mux->pts == -1)
     scr = 0;
 
+  buf = gst_buffer_new_and_alloc (14);
+
   /* pack_start_code */
-  bits_initwrite (&bw, 14, mux->packet_buf);
+  bits_initwrite (&bw, 14, GST_BUFFER_DATA (buf));
   bits_write (&bw, 24, PSMUX_START_CODE_PREFIX);
   bits_write (&bw, 8, PSMUX_PACK_HEADER);
 
@@ -334,8 +367,8 @@ psmux_write_pack_header (PsMux * mux)
   bits_write (&bw, 5, 0x1f);
   bits_write (&bw, 3, 0);       /* pack_stuffing_length */
 
-  mux->packet_bytes_written = 14;
-  return psmux_packet_out (mux);
+  gst_buffer_list_iterator_add (it, buf);
+  mux->packet_bytes_written += 14;
 }
 
 static void
@@ -395,16 +428,13 @@ psmux_ensure_system_header (PsMux * mux)
   mux->sys_header = buf;
 }
 
-static gboolean
-psmux_write_system_header (PsMux * mux)
+static void
+psmux_write_system_header (PsMux * mux, GstBufferListIterator * it)
 {
   psmux_ensure_system_header (mux);
 
-  memcpy (mux->packet_buf, GST_BUFFER_DATA (mux->sys_header),
-      GST_BUFFER_SIZE (mux->sys_header));
-  mux->packet_bytes_written = GST_BUFFER_SIZE (mux->sys_header);
-
-  return psmux_packet_out (mux);
+  gst_buffer_list_iterator_add (it, gst_buffer_ref (mux->sys_header));
+  mux->packet_bytes_written += GST_BUFFER_SIZE (mux->sys_header);
 }
 
 static void
@@ -477,16 +507,13 @@ psmux_ensure_program_stream_map (PsMux * mux)
   mux->psm = buf;
 }
 
-static gboolean
-psmux_write_program_stream_map (PsMux * mux)
+static void
+psmux_write_program_stream_map (PsMux * mux, GstBufferListIterator * it)
 {
   psmux_ensure_program_stream_map (mux);
 
-  memcpy (mux->packet_buf, GST_BUFFER_DATA (mux->psm),
-      GST_BUFFER_SIZE (mux->psm));
-  mux->packet_bytes_written = GST_BUFFER_SIZE (mux->psm);
-
-  return psmux_packet_out (mux);
+  gst_buffer_list_iterator_add (it, gst_buffer_ref (mux->psm));
+  mux->packet_bytes_written += GST_BUFFER_SIZE (mux->psm);
 }
 
 GList *
@@ -54,7 +54,9 @@ G_BEGIN_DECLS
 
 #define PSMUX_MAX_ES_INFO_LENGTH ((1 << 12) - 1)
 
-typedef gboolean (*PsMuxWriteFunc) (guint8 *data, guint len, void *user_data);
+/* Gets ownership of a list with one group: the headers and PES packet written
+ * by one psmux_write_stream_packet() call */
+typedef gboolean (*PsMuxWriteFunc) (GstBufferList *list, void *user_data);
 
 struct PsMux {
   GList *streams;    /* PsMuxStream* array of all streams */
@@ -81,8 +83,7 @@ struct PsMux {
   guint psm_freq; /* program stream map frequency */ 
   GstClockTime psm_pts; /* last time a psm is written */
 
-  guint8 packet_buf[PSMUX_MAX_PACKET_LEN];
-  guint packet_bytes_written; /* # of bytes written in the buf */
+  guint packet_bytes_written; /* # of bytes in the current group */
   PsMuxWriteFunc write_func;
   void *write_func_data;
 
@@ -174,8 +174,6 @@ psmux_stream_new (PsMux * mux, PsMuxStreamType stream_type)
 
   stream->cur_pes_payload_size = 0;
 
-  stream->buffer_release = NULL;
-
   stream->pts = -1;
   stream->dts = -1;
   stream->last_pts = -1;
@@ -215,24 +213,6 @@ psmux_stream_free (PsMuxStream * stream)
   g_slice_free (PsMuxStream, stream);
 }
 
-/**
- * psmux_stream_set_buffer_release_func:
- * @stream: a #PsMuxStream
- * @func: the new #PsMuxStreamBufferReleaseFunc
- *
- * Set the function that will be called when a a piece of data fed to @stream
- * with psmux_stream_add_data() can be freed. @func will be called with user
- * data as provided with the call to psmux_stream_add_data().
- */
-void
-psmux_stream_set_buffer_release_func (PsMuxStream * stream,
-    PsMuxStreamBufferReleaseFunc func)
-{
-  g_return_if_fail (stream != NULL);
-
-  stream->buffer_release = func;
-}
-
 /* Advance the current packet stream position by len bytes.
  * Mustn't consume more than available in the current packet */
 static void
@@ -254,11 +234,7 @@ psmux_stream_consume (PsMuxStream * stream, guint len)
     /* Current packet is completed, move along */
     stream->buffers = g_list_delete_link (stream->buffers, stream->buffers);
 
-    if (stream->buffer_release) {
-      stream->buffer_release (stream->cur_buffer->data,
-          stream->cur_buffer->user_data);
-    }
-
+    gst_buffer_unref (stream->cur_buffer->buf);
     g_slice_free (PsMuxStreamBuffer, stream->cur_buffer);
     stream->cur_buffer = NULL;
   }
@@ -284,21 +260,25 @@ psmux_stream_bytes_in_buffer (PsMuxStream * stream)
 /**
  * psmux_stream_get_data:
  * @stream: a #PsMuxStream
- * @buf: a buffer to hold the result
- * @len: the length of @buf
+ * @it: a #GstBufferListIterator positioned in the group to add to
+ * @len: the maximum size of the packet
  *
- * Write a PES packet to @buf, up to @len bytes
+ * Write a PES packet of up to @len bytes to @it. The header goes into a
+ * buffer of its own, the payload is added as sub-buffers of the buffers
+ * given to psmux_stream_add_data(), so that it is never copied.
  *
  * Returns: number of bytes having been written, 0 if error
  */
 guint
-psmux_stream_get_data (PsMuxStream * stream, guint8 * buf, guint len)
+psmux_stream_get_data (PsMuxStream * stream, GstBufferListIterator * it,
+    guint len)
 {
+  GstBuffer *hdr;
   guint8 pes_hdr_length;
   guint w;
 
   g_return_val_if_fail (stream != NULL, FALSE);
-  g_return_val_if_fail (buf != NULL, FALSE);
+  g_return_val_if_fail (it != NULL, FALSE);
   g_return_val_if_fail (len >= PSMUX_PES_MAX_HDR_LEN, FALSE);
 
   stream->cur_pes_payload_size =
@@ -328,14 +308,15 @@ psmux_stream_get_data (PsMuxStream * stream, guint8 * buf, guint len)
   /* write pes header */
   PS_DEBUG ("Writing PES header of length %u and payload %d",
       pes_hdr_length, stream->cur_pes_payload_size);
-  psmux_stream_write_pes_header (stream, buf);
+  hdr = gst_buffer_new_and_alloc (pes_hdr_length);
+  psmux_stream_write_pes_header (stream, GST_BUFFER_DATA (hdr));
+  gst_buffer_list_iterator_add (it, hdr);
 
-  buf += pes_hdr_length;
   w = stream->cur_pes_payload_size;     /* number of bytes of payload to write */
 
   while (w > 0) {
     guint32 avail;
-    guint8 *cur;
+    GstBuffer *sub;
 
     if (stream->cur_buffer == NULL) {
       /* Start next packet */
@@ -347,19 +328,24 @@ psmux_stream_get_data (PsMuxStream * stream, guint8 * buf, guint len)
 
     /* Take as much as we can from the current buffer */
     avail = stream->cur_buffer->size - stream->cur_buffer_consumed;
-    cur = stream->cur_buffer->data + stream->cur_buffer_consumed;
-    if (avail < w) {
-      memcpy (buf, cur, avail);
-      psmux_stream_consume (stream, avail);
-
-      buf += avail;
-      w -= avail;
-    } else {
-      memcpy (buf, cur, w);
-      psmux_stream_consume (stream, w);
-
-      w = 0;
+    avail = MIN (avail, w);
+    sub = gst_buffer_create_sub (stream->cur_buffer->buf,
+        stream->cur_buffer_consumed, avail);
+    if (avail == stream->cur_buffer->size) {
+      /* a sub-buffer of the whole buffer takes over its caps and timestamps,
+       * which belong to the elementary stream and not to the PS output */
+      gst_buffer_set_caps (sub, NULL);
+      GST_BUFFER_TIMESTAMP (sub) = GST_CLOCK_TIME_NONE;
+      GST_BUFFER_DURATION (sub) = GST_CLOCK_TIME_NONE;
+      GST_BUFFER_OFFSET (sub) = GST_BUFFER_OFFSET_NONE;
+      GST_BUFFER_OFFSET_END (sub) = GST_BUFFER_OFFSET_NONE;
+      GST_BUFFER_FLAG_UNSET (sub, GST_BUFFER_FLAG_DISCONT);
+      GST_BUFFER_FLAG_UNSET (sub, GST_BUFFER_FLAG_DELTA_UNIT);
     }
+    gst_buffer_list_iterator_add (it, sub);
+    psmux_stream_consume (stream, avail);
+
+    w -= avail;
   }
 
   return pes_hdr_length + stream->cur_pes_payload_size;
@@ -498,31 +484,30 @@ psmux_stream_write_pes_header (PsMuxStream * stream, guint8 * data)
 /**
  * psmux_stream_add_data:
  * @stream: a #PsMuxStream
- * @data: data to add
- * @len: length of @data
- * @user_data: user data to pass to release func
- * @pts: PTS of access unit in @data
- * @dts: DTS of access unit in @data
+ * @buf: buffer to add
+ * @pts: PTS of access unit in @buf
+ * @dts: DTS of access unit in @buf
  *
- * Submit @len bytes of @data into @stream. @pts and @dts can be set to the
- * timestamp (against a 90Hz clock) of the first access unit in @data. A
- * timestamp of -1 for @pts or @dts means unknown.
+ * Submit the data of @buf into @stream, taking ownership of @buf. @pts and
+ * @dts can be set to the timestamp (against a 90Hz clock) of the first access
+ * unit in @buf. A timestamp of -1 for @pts or @dts means unknown.
  *
- * @user_data will be passed to the release function as set with
- * psmux_stream_set_buffer_release_func() when @data can be freed.
+ * The reference to @buf is dropped once all of its data has been written.
  */
 void
-psmux_stream_add_data (PsMuxStream * stream, guint8 * data, guint len,
-    void *user_data, gint64 pts, gint64 dts, gboolean keyunit)
+psmux_stream_add_data (PsMuxStream * stream, GstBuffer * buf,
+    gint64 pts, gint64 dts, gboolean keyunit)
 {
   PsMuxStreamBuffer *packet;
+  guint len;
 
   g_return_if_fail (stream != NULL);
 
+  len = GST_BUFFER_SIZE (buf);
+
   packet = g_slice_new (PsMuxStreamBuffer);
-  packet->data = data;
+  packet->buf = buf;
   packet->size = len;
-  packet->user_data = user_data;
 
   packet->keyunit = keyunit;
   packet->pts = pts;
@@ -52,8 +52,6 @@
 G_BEGIN_DECLS
 
 
-typedef void (*PsMuxStreamBufferReleaseFunc) (guint8 *data, void *user_data);
-
 enum PsMuxStreamType { /* Table 2-29 in spec */
   PSMUX_ST_RESERVED                   = 0x00,
   PSMUX_ST_VIDEO_MPEG1                = 0x01,
@@ -83,7 +81,7 @@ enum PsMuxStreamType { /* Table 2-29 in spec */
 
 struct PsMuxStreamBuffer
 {
-  guint8 *data;
+  GstBuffer *buf;
   guint32 size;
 
   gboolean keyunit;
@@ -91,8 +89,6 @@ struct PsMuxStreamBuffer
   /* PTS & DTS associated with the contents of this buffer */
   GstClockTime pts;
   GstClockTime dts;
-
-  void *user_data;
 };
 
 /* PsMuxStream receives elementary streams for parsing.
@@ -116,9 +112,6 @@ struct PsMuxStream{
   guint16 cur_pes_payload_size;
   guint16 pes_bytes_written; /* delete*/
 
-  /* Release function */
-  PsMuxStreamBufferReleaseFunc buffer_release;
-
   /* PTS/DTS to write if the flags in the packet info are set */
   gint64 pts; /* TODO: cur_buffer->pts?*/
   gint64 dts; /* TODO: cur_buffer->dts?*/
@@ -141,23 +134,20 @@ struct PsMuxStream{
 PsMuxStream*    psmux_stream_new                (PsMux * mux, PsMuxStreamType stream_type);
 void 		psmux_stream_free 		(PsMuxStream *stream);
 
-/* The callback when a buffer is released. Used to unref the buffer in GStreamer */
-void 		psmux_stream_set_buffer_release_func 	(PsMuxStream *stream,
-       							 PsMuxStreamBufferReleaseFunc func);
-
 /* Add a new buffer to the pool of available bytes. If pts or dts are not -1, they
- * indicate the PTS or DTS of the first access unit within this packet */
-void 		psmux_stream_add_data 		(PsMuxStream *stream, guint8 *data, guint len,
-						 void *user_data, gint64 pts, gint64 dts,
-						 gboolean keyunit);
+ * indicate the PTS or DTS of the first access unit within this packet. Takes
+ * ownership of the buffer */
+void 		psmux_stream_add_data 		(PsMuxStream *stream, GstBuffer *buf,
+						 gint64 pts, gint64 dts, gboolean keyunit);
 
 /* total bytes in buffer */
 gint 		psmux_stream_bytes_in_buffer 	(PsMuxStream *stream);
 /* number of bytes of raw data available for writing */
 gint 		psmux_stream_bytes_avail 	(PsMuxStream *stream);
 
-/* write PES data */
-guint	 	psmux_stream_get_data 		(PsMuxStream *stream, guint8 *buf, guint len);
+/* write PES data, as a header buffer followed by sub-buffers of the payload */
+guint	 	psmux_stream_get_data 		(PsMuxStream *stream, GstBufferListIterator *it,
+						 guint len);
 
 /* write corresponding descriptors of the stream */
 void 		psmux_stream_get_es_descrs 	(PsMuxStream *stream, guint8 *buf, guint16 *len);
@@ -36,6 +36,9 @@
 #include <string.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <gst/gst-i18n-plugin.h>
 #include "mpegtsbase.h"
@@ -192,12 +195,20 @@ mpegts_base_class_init (MpegTSBaseClass * klass)
 
 }
 
+static void mpegts_base_save_index (MpegTSBase * base);
+
 static void
 mpegts_base_reset (MpegTSBase * base)
 {
   MpegTSBaseClass *klass = GST_MPEGTS_BASE_GET_CLASS (base);
 
+  /* Store what we learnt about the file before forgetting about it */
+  mpegts_base_save_index (base);
+  base->index_file_size = -1;
+  base->index_file_mtime = -1;
+
   mpegts_packetizer_clear (base->packetizer);
+  mpegts_packetizer_clear_observations (base->packetizer);
   memset (base->is_pes, 0, 1024);
   memset (base->known_psi, 0, 1024);
 
@@ -290,6 +301,7 @@ mpegts_base_finalize (GObject * object)
     base->pat = NULL;
   }
   g_hash_table_destroy (base->programs);
+  g_free (base->index_location);
 
   if (G_OBJECT_CLASS (parent_class)->finalize)
     G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1419,6 +1431,7 @@ mpegts_base_chain (GstPad * pad, GstBuffer * buf)
   if (klass->input_done)
     gst_buffer_ref (buf);
 
+  base->current_buffer = buf;
   mpegts_packetizer_push (base->packetizer, buf);
   while (res == GST_FLOW_OK
       && ((pret =
@@ -1462,6 +1475,7 @@ mpegts_base_chain (GstPad * pad, GstBuffer * buf)
   next:
     mpegts_packetizer_clear_packet (base->packetizer, &packet);
   }
+  base->current_buffer = NULL;
 
   if (klass->input_done) {
     if (res == GST_FLOW_OK)
@@ -1504,6 +1518,7 @@ mpegts_base_scan (MpegTSBase * base)
       if (base->seek_offset == -1) {
         /* Mark the initial sync point and remember the packetsize */
         base->seek_offset = base->packetizer->offset;
+        base->initial_sync_offset = base->seek_offset;
         GST_DEBUG ("Sync point is now %" G_GUINT64_FORMAT, base->seek_offset);
         base->packetsize = base->packetizer->packet_size;
       }
@@ -1578,6 +1593,203 @@ no_initial_pcr:
   return GST_FLOW_ERROR;
 }
 
+#define INDEX_MAGIC 0x54534958     /* "TSIX" */
+#define INDEX_VERSION 1
+
+/* Gets the size and modification time of the upstream file, which the
+ * sidecar index is only valid for */
+static gboolean
+mpegts_base_get_file_key (MpegTSBase * base)
+{
+  GstQuery *query;
+  gchar *uri = NULL, *location = NULL;
+  struct stat st;
+  gboolean res = FALSE;
+
+  query = gst_query_new_uri ();
+  if (gst_pad_peer_query (base->sinkpad, query))
+    gst_query_parse_uri (query, &uri);
+  if (uri && gst_uri_has_protocol (uri, "file"))
+    location = g_filename_from_uri (uri, NULL, NULL);
+  gst_query_unref (query);
+
+  if (location && g_stat (location, &st) == 0) {
+    base->index_file_size = st.st_size;
+    base->index_file_mtime = st.st_mtime;
+    res = TRUE;
+  } else {
+    GST_DEBUG_OBJECT (base, "upstream is not a local file, not using index");
+  }
+  g_free (location);
+
+  return res;
+}
+
+/* Index file layout, all values big-endian:
+ *   u32 magic, u32 version, u64 file size, s64 file mtime,
+ *   u16 packet size, u64 initial sync offset,
+ *   followed by the packetizer index (see mpegts_packetizer_write_index) */
+static gboolean
+mpegts_base_load_index (MpegTSBase * base)
+{
+  GstByteReader reader;
+  GError *err = NULL;
+  gchar *data = NULL;
+  gsize size;
+  guint32 magic, version;
+  guint64 file_size, seek_offset;
+  gint64 file_mtime;
+  guint16 packetsize;
+  gchar *location;
+
+  /* the property can change while we read the file */
+  GST_OBJECT_LOCK (base);
+  location = g_strdup (base->index_location);
+  GST_OBJECT_UNLOCK (base);
+
+  if (location == NULL || !mpegts_base_get_file_key (base))
+    goto no_index;
+
+  if (!g_file_get_contents (location, &data, &size, &err)) {
+    GST_INFO_OBJECT (base, "could not read index: %s", err->message);
+    g_error_free (err);
+    goto no_index;
+  }
+
+  gst_byte_reader_init (&reader, (const guint8 *) data, size);
+  if (!gst_byte_reader_get_uint32_be (&reader, &magic) ||
+      !gst_byte_reader_get_uint32_be (&reader, &version) ||
+      !gst_byte_reader_get_uint64_be (&reader, &file_size) ||
+      !gst_byte_reader_get_int64_be (&reader, &file_mtime) ||
+      !gst_byte_reader_get_uint16_be (&reader, &packetsize) ||
+      !gst_byte_reader_get_uint64_be (&reader, &seek_offset))
+    goto invalid;
+  if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+    goto invalid;
+  if (file_size != base->index_file_size || file_mtime != base->index_file_mtime)
+    goto stale;
+  if (packetsize < MPEGTS_MIN_PACKETSIZE || packetsize > MPEGTS_MAX_PACKETSIZE
+      || seek_offset >= file_size)
+    goto invalid;
+  if (!mpegts_packetizer_read_index (base->packetizer, &reader))
+    goto invalid;
+
+  base->packetsize = packetsize;
+  base->seek_offset = base->initial_sync_offset = seek_offset;
+  g_free (data);
+
+  GST_INFO_OBJECT (base, "Using index %s", location);
+  g_free (location);
+  return TRUE;
+
+invalid:
+  GST_WARNING_OBJECT (base, "Invalid index %s, ignoring it", location);
+  g_free (data);
+  g_free (location);
+  return FALSE;
+
+stale:
+  GST_INFO_OBJECT (base, "Index %s is stale, ignoring it", location);
+  g_free (data);
+  g_free (location);
+  return FALSE;
+
+no_index:
+  g_free (location);
+  return FALSE;
+}
+
+static void
+mpegts_base_save_index (MpegTSBase * base)
+{
+  GstByteWriter writer;
+  GError *err = NULL;
+  guint size;
+  guint8 *data;
+  gchar *location;
+
+  if (base->index_file_size == -1 ||
+      !mpegts_packetizer_index_changed (base->packetizer))
+    return;
+
+  /* the property can change while we write the file */
+  GST_OBJECT_LOCK (base);
+  location = g_strdup (base->index_location);
+  GST_OBJECT_UNLOCK (base);
+  if (location == NULL)
+    return;
+
+  gst_byte_writer_init_with_size (&writer, 4096, FALSE);
+  gst_byte_writer_put_uint32_be (&writer, INDEX_MAGIC);
+  gst_byte_writer_put_uint32_be (&writer, INDEX_VERSION);
+  gst_byte_writer_put_uint64_be (&writer, base->index_file_size);
+  gst_byte_writer_put_int64_be (&writer, base->index_file_mtime);
+  gst_byte_writer_put_uint16_be (&writer, base->packetsize);
+  gst_byte_writer_put_uint64_be (&writer, base->initial_sync_offset);
+  mpegts_packetizer_write_index (base->packetizer, &writer);
+
+  size = gst_byte_writer_get_size (&writer);
+  data = gst_byte_writer_reset_and_get_data (&writer);
+  if (!g_file_set_contents (location, (gchar *) data, size, &err)) {
+    GST_WARNING_OBJECT (base, "could not write index: %s", err->message);
+    g_error_free (err);
+  } else {
+    GST_INFO_OBJECT (base, "Wrote %u bytes to index %s", size, location);
+  }
+  g_free (data);
+  g_free (location);
+}
+
+/* Maximum time between the PCR index entries around a seek target before we
+ * stop probing the file */
+#define SEEK_INDEX_ACCURACY (GST_SECOND)
+#define SEEK_MAX_PROBES 16
+
+/* Returns the byte offset of the packet with PCR @pcr_pid at or just before
+ * @ts. In pull mode the file is probed around the estimated position until
+ * the PCR index brackets @ts closely enough, so that variable bitrate streams
+ * don't end up wildly off target. */
+guint64
+mpegts_base_find_offset (MpegTSBase * base, GstClockTime ts, guint16 pcr_pid)
+{
+  MpegTSPacketizer2 *packetizer = base->packetizer;
+  GstBuffer *buf = NULL;
+  GstClockTime span;
+  guint64 offset;
+  guint i;
+
+  offset = mpegts_packetizer_ts_to_offset (packetizer, ts, pcr_pid);
+  if (base->mode == BASE_MODE_PUSHING)
+    return offset;
+
+  for (i = 0; i < SEEK_MAX_PROBES && offset != -1; i++) {
+    span = mpegts_packetizer_get_index_span (packetizer, ts, pcr_pid);
+    if (GST_CLOCK_TIME_IS_VALID (span) && span <= SEEK_INDEX_ACCURACY)
+      break;
+
+    GST_DEBUG ("Probing %" G_GUINT64_FORMAT " for %" GST_TIME_FORMAT
+        " (span %" GST_TIME_FORMAT ")", offset, GST_TIME_ARGS (ts),
+        GST_TIME_ARGS (span));
+
+    if (gst_pad_pull_range (base->sinkpad, offset, 65536, &buf) != GST_FLOW_OK)
+      break;
+    GST_BUFFER_OFFSET (buf) = offset;
+    if (!mpegts_packetizer_scan_pcr (packetizer, buf, base->packetsize,
+            pcr_pid)) {
+      gst_buffer_unref (buf);
+      break;
+    }
+    gst_buffer_unref (buf);
+
+    offset = mpegts_packetizer_ts_to_offset (packetizer, ts, pcr_pid);
+  }
+
+  GST_DEBUG ("Found offset %" G_GUINT64_FORMAT " for %" GST_TIME_FORMAT
+      " after %u probes", offset, GST_TIME_ARGS (ts), i);
+
+  return offset;
+}
+
 
 static void
 mpegts_base_loop (MpegTSBase * base)
@@ -1586,10 +1798,12 @@ mpegts_base_loop (MpegTSBase * base)
 
   switch (base->mode) {
     case BASE_MODE_SCANNING:
-      /* Find first sync point */
-      ret = mpegts_base_scan (base);
-      if (G_UNLIKELY (ret != GST_FLOW_OK))
-        goto error;
+      /* Find first sync point, unless we know the file already */
+      if (!mpegts_base_load_index (base)) {
+        ret = mpegts_base_scan (base);
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          goto error;
+      }
       base->mode = BASE_MODE_STREAMING;
       GST_DEBUG ("Changing to Streaming");
       break;
@@ -1625,6 +1839,7 @@ error:
     const gchar *reason = gst_flow_get_name (ret);
     GST_DEBUG_OBJECT (base, "Pausing task, reason %s", reason);
     if (ret == GST_FLOW_UNEXPECTED) {
+      mpegts_base_save_index (base);
       /* Push EOS downstream */
       if (!GST_MPEGTS_BASE_GET_CLASS (base)->push_event (base,
               gst_event_new_eos ())) {
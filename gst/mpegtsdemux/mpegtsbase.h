@@ -138,6 +138,21 @@ struct _MpegTSBase {
 
   /* Upstream segment */
   GstSegment segment;
+
+  /* Buffer being processed by the chain function. The packets handed to
+   * push() point into its data if they are fully contained in it. Only
+   * kept alive until the end of the chain function if the subclass
+   * implements input_done() */
+  GstBuffer *current_buffer;
+
+  /* Sidecar index file, only used in pull mode from local files which are
+   * identified by their size and modification time. The location is
+   * protected by the object lock */
+  gchar *index_location;
+  guint64 index_file_size;
+  gint64 index_file_mtime;
+  /* Offset of the first packet in the file */
+  guint64 initial_sync_offset;
 };
 
 struct _MpegTSBaseClass {
@@ -194,6 +209,9 @@ G_GNUC_INTERNAL guint8 *mpegts_get_descriptor_from_program (MpegTSBaseProgram *
 G_GNUC_INTERNAL gboolean
 mpegts_base_handle_seek_event(MpegTSBase * base, GstPad * pad, GstEvent * event);
 
+G_GNUC_INTERNAL guint64
+mpegts_base_find_offset (MpegTSBase * base, GstClockTime ts, guint16 pcr_pid);
+
 G_GNUC_INTERNAL gboolean gst_mpegtsbase_plugin_init (GstPlugin * plugin);
 
 G_GNUC_INTERNAL gboolean mpegts_base_handle_psi (MpegTSBase * base, MpegTSPacketizerSection * section);
@@ -36,6 +36,9 @@
 #define PCR_GST_MAX_VALUE (PCR_MAX_VALUE * GST_MSECOND / (27000))
 #define PTS_DTS_MAX_VALUE (((guint64)1) << 33)
 
+/* Minimal PCR distance between two entries of the PCR index */
+#define PCR_INDEX_INTERVAL GSTTIME_TO_PCRTIME (250 * GST_MSECOND)
+
 #include "mpegtspacketizer.h"
 #include "gstmpegdesc.h"
 
@@ -206,8 +209,25 @@ typedef struct _MpegTSPCR
   guint64 last_pcr;
   GstClockTime last_pcr_ts;
 
+  /* Sparse index of MpegTSPCRIndexEntry, sorted by offset (and PCR), used
+   * for offset <=> time conversions */
+  GArray *index;
 } MpegTSPCR;
 
+typedef struct
+{
+  guint64 offset;
+  /* PCR with rollover taken into account */
+  guint64 pcr;
+} MpegTSPCRIndexEntry;
+
+typedef struct
+{
+  guint64 offset;
+  GstClockTime ts;
+  guint16 pid;
+} MpegTSKeyframe;
+
 struct _MpegTSPacketizerPrivate
 {
   /* Shortcuts for adapter usage */
@@ -229,6 +249,13 @@ struct _MpegTSPacketizerPrivate
   MpegTSPCR *observations[MAX_PCR_OBS_CHANNELS];
   guint8 lastobsid;
 
+  /* MpegTSKeyframe seen so far, sorted by timestamp */
+  GArray *keyframes;
+
+  /* TRUE if entries were added to the PCR indexes or the keyframe table
+   * since they were last read or written */
+  gboolean index_changed;
+
   /* Conversion tables */
   GIConv iconvs[_ICONV_MAX];
 };
@@ -239,8 +266,9 @@ static gchar *get_encoding_and_convert (MpegTSPacketizer2 * packetizer,
     const gchar * text, guint length);
 static GstClockTime calculate_skew (MpegTSPCR * pcr, guint64 pcrtime,
     GstClockTime time);
-static void record_pcr (MpegTSPacketizer2 * packetizer, MpegTSPCR * pcrtable,
-    guint64 pcr, guint64 offset);
+static gboolean record_pcr (MpegTSPacketizer2 * packetizer,
+    MpegTSPCR * pcrtable, guint64 pcr, guint64 offset);
+static void reset_skew (MpegTSPCR * pcrtable);
 
 #define CONTINUITY_UNSET 255
 #define MAX_CONTINUITY 15
@@ -274,21 +302,28 @@ get_pcr_table (MpegTSPacketizer2 * packetizer, guint16 pid)
     res->last_offset = -1;
     res->last_pcr = -1;
     res->last_pcr_ts = GST_CLOCK_TIME_NONE;
-    res->base_time = GST_CLOCK_TIME_NONE;
-    res->base_pcrtime = GST_CLOCK_TIME_NONE;
-    res->last_pcrtime = GST_CLOCK_TIME_NONE;
-    res->window_pos = 0;
-    res->window_filling = TRUE;
-    res->window_min = 0;
-    res->skew = 0;
-    res->prev_send_diff = GST_CLOCK_TIME_NONE;
-    res->prev_out_time = GST_CLOCK_TIME_NONE;
-    res->pcroffset = 0;
+    res->index = g_array_new (FALSE, FALSE, sizeof (MpegTSPCRIndexEntry));
+    reset_skew (res);
   }
 
   return res;
 }
 
+static void
+reset_skew (MpegTSPCR * pcrtable)
+{
+  pcrtable->base_time = GST_CLOCK_TIME_NONE;
+  pcrtable->base_pcrtime = GST_CLOCK_TIME_NONE;
+  pcrtable->last_pcrtime = GST_CLOCK_TIME_NONE;
+  pcrtable->window_pos = 0;
+  pcrtable->window_filling = TRUE;
+  pcrtable->window_min = 0;
+  pcrtable->skew = 0;
+  pcrtable->prev_send_diff = GST_CLOCK_TIME_NONE;
+  pcrtable->prev_out_time = GST_CLOCK_TIME_NONE;
+  pcrtable->pcroffset = 0;
+}
+
 static void
 flush_observations (MpegTSPacketizer2 * packetizer)
 {
@@ -296,11 +331,15 @@ flush_observations (MpegTSPacketizer2 * packetizer)
   gint i;
 
   for (i = 0; i < priv->lastobsid; i++) {
+    g_array_free (priv->observations[i]->index, TRUE);
     g_free (priv->observations[i]);
     priv->observations[i] = NULL;
   }
-  memset (priv->pcrtablelut, 0xff, 0x200);
+  memset (priv->pcrtablelut, 0xff, sizeof (priv->pcrtablelut));
   priv->lastobsid = 0;
+  priv->nb_seen_offsets = 0;
+  g_array_set_size (priv->keyframes, 0);
+  priv->index_changed = FALSE;
 }
 
 static gint
@@ -396,8 +435,9 @@ mpegts_packetizer_init (MpegTSPacketizer2 * packetizer)
   priv->mapped_size = 0;
   priv->offset = 0;
 
-  memset (priv->pcrtablelut, 0xff, 0x200);
+  memset (priv->pcrtablelut, 0xff, sizeof (priv->pcrtablelut));
   memset (priv->observations, 0x0, sizeof (priv->observations));
+  priv->keyframes = g_array_new (FALSE, FALSE, sizeof (MpegTSKeyframe));
   for (i = 0; i < _ICONV_MAX; i++)
     priv->iconvs[i] = (GIConv) - 1;
 
@@ -440,6 +480,7 @@ mpegts_packetizer_dispose (GObject * object)
         g_iconv_close (packetizer->priv->iconvs[i]);
 
     flush_observations (packetizer);
+    g_array_free (packetizer->priv->keyframes, TRUE);
   }
 
   if (G_OBJECT_CLASS (mpegts_packetizer_parent_class)->dispose)
@@ -570,6 +611,7 @@ mpegts_packetizer_parse_packet (MpegTSPacketizer2 * packetizer,
   data += 1;
 
   packet->data = data;
+  packet->afc_flags = 0;
 
   if (packet->adaptation_field_control & 0x02)
     if (!mpegts_packetizer_parse_adaptation_field_control (packetizer, packet))
@@ -2482,10 +2524,11 @@ mpegts_packetizer_clear (MpegTSPacketizer2 * packetizer)
 void
 mpegts_packetizer_flush (MpegTSPacketizer2 * packetizer)
 {
+  guint i;
+
   GST_DEBUG ("Flushing");
 
   if (packetizer->streams) {
-    int i;
     for (i = 0; i < 8192; i++) {
       if (packetizer->streams[i]) {
         mpegts_packetizer_clear_section (packetizer->streams[i]);
@@ -2501,6 +2544,18 @@ mpegts_packetizer_flush (MpegTSPacketizer2 * packetizer)
   packetizer->priv->offset = 0;
   packetizer->priv->mapped_size = 0;
   packetizer->priv->last_in_time = GST_CLOCK_TIME_NONE;
+
+  /* The PCR observations describe the stream and not the current position in
+   * it, only the clock skew estimation needs to start over */
+  for (i = 0; i < packetizer->priv->lastobsid; i++)
+    reset_skew (packetizer->priv->observations[i]);
+}
+
+void
+mpegts_packetizer_clear_observations (MpegTSPacketizer2 * packetizer)
+{
+  GST_DEBUG ("Clearing PCR observations and keyframes");
+
   flush_observations (packetizer);
 }
 
@@ -3611,7 +3666,149 @@ no_skew:
   return out_time;
 }
 
-static void
+/* returns the position of the first index entry at or after @offset */
+static guint
+pcr_index_find_offset (GArray * index, guint64 offset)
+{
+  MpegTSPCRIndexEntry *entries = (MpegTSPCRIndexEntry *) index->data;
+  guint lo = 0, hi = index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].offset < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/* returns the position of the first index entry at or after @pcr */
+static guint
+pcr_index_find_pcr (GArray * index, guint64 pcr)
+{
+  MpegTSPCRIndexEntry *entries = (MpegTSPCRIndexEntry *) index->data;
+  guint lo = 0, hi = index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].pcr < pcr)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/* Adds an entry to the index unless it is closer than PCR_INDEX_INTERVAL
+ * to its neighbours or would make the index non-monotonic (PCR
+ * discontinuity). Returns TRUE if the entry was added */
+static gboolean
+pcr_index_add (MpegTSPacketizer2 * packetizer, MpegTSPCR * pcrtable,
+    guint64 pcr, guint64 offset)
+{
+  GArray *index = pcrtable->index;
+  MpegTSPCRIndexEntry *entries = (MpegTSPCRIndexEntry *) index->data;
+  MpegTSPCRIndexEntry entry;
+  guint pos;
+
+  if (G_UNLIKELY (pcrtable->first_pcr != -1 && pcr < pcrtable->first_pcr))
+    pcr += PCR_MAX_VALUE;
+
+  /* Common case, reading forward */
+  if (G_LIKELY (index->len == 0 || entries[index->len - 1].offset < offset))
+    pos = index->len;
+  else
+    pos = pcr_index_find_offset (index, offset);
+
+  if (pos > 0 && pcr < entries[pos - 1].pcr + PCR_INDEX_INTERVAL)
+    return FALSE;
+  if (pos < index->len && (entries[pos].offset == offset
+          || pcr + PCR_INDEX_INTERVAL > entries[pos].pcr))
+    return FALSE;
+
+  entry.offset = offset;
+  entry.pcr = pcr;
+  g_array_insert_val (index, pos, entry);
+  packetizer->priv->index_changed = TRUE;
+
+  GST_LOG ("Indexed PCR %" G_GUINT64_FORMAT " at offset %" G_GUINT64_FORMAT
+      " pcr_pid:0x%04x (%u entries)", pcr, offset, pcrtable->pid, index->len);
+
+  return TRUE;
+}
+
+/* Interpolates between the index entries around @pcr. Outside of the index
+ * the average bitrate of the indexed part of the stream is used */
+static guint64
+pcr_index_pcr_to_offset (MpegTSPCR * pcrtable, guint64 pcr)
+{
+  GArray *index = pcrtable->index;
+  MpegTSPCRIndexEntry *entries = (MpegTSPCRIndexEntry *) index->data;
+  MpegTSPCRIndexEntry *first, *last, *prev, *next;
+  guint pos;
+
+  first = &entries[0];
+  last = &entries[index->len - 1];
+
+  pos = pcr_index_find_pcr (index, pcr);
+  if (pos == 0 || pos == index->len) {
+    MpegTSPCRIndexEntry *anchor = pos == 0 ? first : last;
+    guint64 diff;
+
+    if (pcr >= anchor->pcr)
+      return anchor->offset + gst_util_uint64_scale (pcr - anchor->pcr,
+          last->offset - first->offset, last->pcr - first->pcr);
+
+    diff = gst_util_uint64_scale (anchor->pcr - pcr,
+        last->offset - first->offset, last->pcr - first->pcr);
+    return anchor->offset > diff ? anchor->offset - diff : 0;
+  }
+
+  prev = &entries[pos - 1];
+  next = &entries[pos];
+
+  return prev->offset + gst_util_uint64_scale (pcr - prev->pcr,
+      next->offset - prev->offset, next->pcr - prev->pcr);
+}
+
+static guint64
+pcr_index_offset_to_pcr (MpegTSPCR * pcrtable, guint64 offset)
+{
+  GArray *index = pcrtable->index;
+  MpegTSPCRIndexEntry *entries = (MpegTSPCRIndexEntry *) index->data;
+  MpegTSPCRIndexEntry *first, *last, *prev, *next;
+  guint pos;
+
+  first = &entries[0];
+  last = &entries[index->len - 1];
+
+  pos = pcr_index_find_offset (index, offset);
+  if (pos == 0 || pos == index->len) {
+    MpegTSPCRIndexEntry *anchor = pos == 0 ? first : last;
+    guint64 diff;
+
+    if (offset >= anchor->offset)
+      return anchor->pcr + gst_util_uint64_scale (offset - anchor->offset,
+          last->pcr - first->pcr, last->offset - first->offset);
+
+    diff = gst_util_uint64_scale (anchor->offset - offset,
+        last->pcr - first->pcr, last->offset - first->offset);
+    return anchor->pcr > diff ? anchor->pcr - diff : 0;
+  }
+
+  prev = &entries[pos - 1];
+  next = &entries[pos];
+
+  return prev->pcr + gst_util_uint64_scale (offset - prev->offset,
+      next->pcr - prev->pcr, next->offset - prev->offset);
+}
+
+static gboolean
 record_pcr (MpegTSPacketizer2 * packetizer, MpegTSPCR * pcrtable, guint64 pcr,
     guint64 offset)
 {
@@ -3628,17 +3825,21 @@ record_pcr (MpegTSPacketizer2 * packetizer, MpegTSPCR * pcrtable, guint64 pcr,
   } else
     /* If we didn't update the first PCR, let's check against last PCR */
   if (pcrtable->last_pcr == -1 || pcrtable->last_offset < offset) {
+    guint64 last_pcr = pcr;
+
     GST_DEBUG ("Recording last value. PCR:%" G_GUINT64_FORMAT " offset:%"
         G_GUINT64_FORMAT " pcr_pid:0x%04x", pcr, offset, pcrtable->pid);
     if (G_UNLIKELY (pcrtable->first_pcr != -1 && pcr < pcrtable->first_pcr)) {
       GST_DEBUG ("rollover detected");
-      pcr += PCR_MAX_VALUE;
+      last_pcr += PCR_MAX_VALUE;
     }
-    pcrtable->last_pcr = pcr;
-    pcrtable->last_pcr_ts = PCRTIME_TO_GSTTIME (pcr);
+    pcrtable->last_pcr = last_pcr;
+    pcrtable->last_pcr_ts = PCRTIME_TO_GSTTIME (last_pcr);
     pcrtable->last_offset = offset;
     priv->nb_seen_offsets++;
   }
+
+  return pcr_index_add (packetizer, pcrtable, pcr, offset);
 }
 
 guint
@@ -3647,6 +3848,53 @@ mpegts_packetizer_get_seen_pcr (MpegTSPacketizer2 * packetizer)
   return packetizer->priv->nb_seen_offsets;
 }
 
+guint
+mpegts_packetizer_scan_pcr (MpegTSPacketizer2 * packetizer,
+    GstBuffer * buffer, guint16 packet_size, guint16 pcr_pid)
+{
+  MpegTSPCR *pcrtable;
+  guint8 *data = GST_BUFFER_DATA (buffer);
+  guint size = GST_BUFFER_SIZE (buffer);
+  /* M2TS packets don't start with the sync byte */
+  guint sync = packet_size == MPEGTS_M2TS_PACKETSIZE ? 4 : 0;
+  guint i, added = 0;
+
+  if (G_UNLIKELY (packet_size < MPEGTS_MIN_PACKETSIZE))
+    return 0;
+
+  /* Find two consecutive sync bytes */
+  for (i = 0; i + sync + packet_size < size; i++) {
+    if (data[i + sync] == PACKET_SYNC_BYTE
+        && data[i + sync + packet_size] == PACKET_SYNC_BYTE)
+      break;
+  }
+
+  pcrtable = get_pcr_table (packetizer, pcr_pid);
+
+  for (; i + packet_size <= size; i += packet_size) {
+    guint8 *packet = data + i + sync;
+
+    if (G_UNLIKELY (packet[0] != PACKET_SYNC_BYTE))
+      break;
+
+    /* PID, adaptation field of at least 7 bytes with the PCR flag set */
+    if ((GST_READ_UINT16_BE (packet + 1) & 0x1FFF) != pcr_pid
+        || !(packet[3] & 0x20) || packet[4] < 7
+        || !(packet[5] & MPEGTS_AFC_PCR_FLAG))
+      continue;
+
+    if (record_pcr (packetizer, pcrtable,
+            mpegts_packetizer_compute_pcr (packet + 6),
+            GST_BUFFER_OFFSET (buffer) + i))
+      added++;
+  }
+
+  GST_DEBUG ("Added %u index entries from %u bytes at offset %"
+      G_GUINT64_FORMAT, added, size, GST_BUFFER_OFFSET (buffer));
+
+  return added;
+}
+
 GstClockTime
 mpegts_packetizer_offset_to_ts (MpegTSPacketizer2 * packetizer, guint64 offset,
     guint16 pid)
@@ -3666,10 +3914,17 @@ mpegts_packetizer_offset_to_ts (MpegTSPacketizer2 * packetizer, guint64 offset,
 
   pcrtable = get_pcr_table (packetizer, pid);
 
-  /* Convert byte difference into time difference */
-  res = PCRTIME_TO_GSTTIME (gst_util_uint64_scale (offset - priv->refoffset,
-          pcrtable->last_pcr - pcrtable->first_pcr,
-          pcrtable->last_offset - pcrtable->first_offset));
+  if (pcrtable->index->len >= 2) {
+    guint64 pcr = pcr_index_offset_to_pcr (pcrtable, offset);
+
+    res = pcr > pcrtable->first_pcr ?
+        PCRTIME_TO_GSTTIME (pcr - pcrtable->first_pcr) : 0;
+  } else {
+    /* Convert byte difference into time difference */
+    res = PCRTIME_TO_GSTTIME (gst_util_uint64_scale (offset - priv->refoffset,
+            pcrtable->last_pcr - pcrtable->first_pcr,
+            pcrtable->last_offset - pcrtable->first_offset));
+  }
   GST_DEBUG ("Returning timestamp %" GST_TIME_FORMAT " for offset %"
       G_GUINT64_FORMAT, GST_TIME_ARGS (res), offset);
 
@@ -3708,6 +3963,12 @@ mpegts_packetizer_pts_to_ts (MpegTSPacketizer2 * packetizer, GstClockTime pts,
   return res;
 }
 
+GstClockTime
+mpegts_packetizer_get_current_time (MpegTSPacketizer2 * packetizer)
+{
+  return packetizer->priv->last_in_time;
+}
+
 guint64
 mpegts_packetizer_ts_to_offset (MpegTSPacketizer2 * packetizer, GstClockTime ts,
     guint16 pcr_pid)
@@ -3726,11 +3987,16 @@ mpegts_packetizer_ts_to_offset (MpegTSPacketizer2 * packetizer, GstClockTime ts,
   GST_DEBUG ("ts(pcr) %" G_GUINT64_FORMAT " first_pcr:%" G_GUINT64_FORMAT,
       GSTTIME_TO_MPEGTIME (ts), pcrtable->first_pcr);
 
-  /* Convert ts to PCRTIME */
-  res = gst_util_uint64_scale (GSTTIME_TO_PCRTIME (ts),
-      pcrtable->last_offset - pcrtable->first_offset,
-      pcrtable->last_pcr - pcrtable->first_pcr);
-  res += pcrtable->first_offset + priv->refoffset;
+  if (pcrtable->index->len >= 2) {
+    res = pcr_index_pcr_to_offset (pcrtable,
+        pcrtable->first_pcr + GSTTIME_TO_PCRTIME (ts));
+  } else {
+    /* Convert ts to PCRTIME */
+    res = gst_util_uint64_scale (GSTTIME_TO_PCRTIME (ts),
+        pcrtable->last_offset - pcrtable->first_offset,
+        pcrtable->last_pcr - pcrtable->first_pcr);
+    res += pcrtable->first_offset + priv->refoffset;
+  }
 
   GST_DEBUG ("Returning offset %" G_GUINT64_FORMAT " for ts %" GST_TIME_FORMAT,
       res, GST_TIME_ARGS (ts));
@@ -3738,6 +4004,244 @@ mpegts_packetizer_ts_to_offset (MpegTSPacketizer2 * packetizer, GstClockTime ts,
   return res;
 }
 
+GstClockTime
+mpegts_packetizer_get_index_span (MpegTSPacketizer2 * packetizer,
+    GstClockTime ts, guint16 pcr_pid)
+{
+  MpegTSPCR *pcrtable;
+  MpegTSPCRIndexEntry *entries;
+  guint64 pcr;
+  guint pos;
+
+  if (!packetizer->calculate_offset)
+    return GST_CLOCK_TIME_NONE;
+
+  pcrtable = get_pcr_table (packetizer, pcr_pid);
+  if (pcrtable->first_pcr == -1 || pcrtable->index->len < 2)
+    return GST_CLOCK_TIME_NONE;
+
+  entries = (MpegTSPCRIndexEntry *) pcrtable->index->data;
+  pcr = pcrtable->first_pcr + GSTTIME_TO_PCRTIME (ts);
+  pos = pcr_index_find_pcr (pcrtable->index, pcr);
+
+  if (pos < pcrtable->index->len && entries[pos].pcr == pcr)
+    return 0;
+  if (pos == 0 || pos == pcrtable->index->len)
+    return GST_CLOCK_TIME_NONE;
+
+  return PCRTIME_TO_GSTTIME (entries[pos].pcr - entries[pos - 1].pcr);
+}
+
+/* returns the position of the first keyframe after @ts */
+static guint
+keyframes_find_ts (GArray * keyframes, GstClockTime ts)
+{
+  MpegTSKeyframe *entries = (MpegTSKeyframe *) keyframes->data;
+  guint lo = 0, hi = keyframes->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].ts <= ts)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+void
+mpegts_packetizer_add_keyframe (MpegTSPacketizer2 * packetizer, guint16 pid,
+    guint64 offset, GstClockTime ts)
+{
+  GArray *keyframes = packetizer->priv->keyframes;
+  MpegTSKeyframe *entries = (MpegTSKeyframe *) keyframes->data;
+  MpegTSKeyframe keyframe;
+  guint pos;
+
+  if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (ts) || offset == -1))
+    return;
+
+  /* Common case, reading forward */
+  if (G_LIKELY (keyframes->len == 0 || entries[keyframes->len - 1].ts < ts))
+    pos = keyframes->len;
+  else
+    pos = keyframes_find_ts (keyframes, ts);
+
+  /* Already known, the same part of the stream was read again */
+  if (pos > 0 && entries[pos - 1].ts == ts && entries[pos - 1].pid == pid)
+    return;
+
+  keyframe.offset = offset;
+  keyframe.ts = ts;
+  keyframe.pid = pid;
+  g_array_insert_val (keyframes, pos, keyframe);
+  packetizer->priv->index_changed = TRUE;
+
+  GST_LOG ("Keyframe at offset %" G_GUINT64_FORMAT " ts %" GST_TIME_FORMAT
+      " pid:0x%04x", offset, GST_TIME_ARGS (ts), pid);
+}
+
+guint64
+mpegts_packetizer_get_keyframe (MpegTSPacketizer2 * packetizer, guint16 pid,
+    GstClockTime ts, GstClockTime * keyframe_ts)
+{
+  GArray *keyframes = packetizer->priv->keyframes;
+  MpegTSKeyframe *entries = (MpegTSKeyframe *) keyframes->data;
+  guint pos;
+
+  for (pos = keyframes_find_ts (keyframes, ts); pos > 0; pos--) {
+    if (entries[pos - 1].pid == pid) {
+      if (keyframe_ts)
+        *keyframe_ts = entries[pos - 1].ts;
+      return entries[pos - 1].offset;
+    }
+  }
+
+  return -1;
+}
+
+gboolean
+mpegts_packetizer_index_changed (MpegTSPacketizer2 * packetizer)
+{
+  return packetizer->priv->index_changed;
+}
+
+/* All values are stored big-endian:
+ *   u16 number of PCR tables, for each of them:
+ *     u16 pid, u64 first PCR, u64 first offset, u64 last PCR, u64 last offset
+ *     u32 number of index entries, for each of them u64 offset, u64 PCR
+ *   u32 number of keyframes, for each of them u64 offset, u64 ts, u16 pid
+ */
+void
+mpegts_packetizer_write_index (MpegTSPacketizer2 * packetizer,
+    GstByteWriter * writer)
+{
+  MpegTSPacketizerPrivate *priv = packetizer->priv;
+  guint i, j;
+
+  gst_byte_writer_put_uint16_be (writer, priv->lastobsid);
+  for (i = 0; i < priv->lastobsid; i++) {
+    MpegTSPCR *pcrtable = priv->observations[i];
+    MpegTSPCRIndexEntry *entries =
+        (MpegTSPCRIndexEntry *) pcrtable->index->data;
+
+    gst_byte_writer_put_uint16_be (writer, pcrtable->pid);
+    gst_byte_writer_put_uint64_be (writer, pcrtable->first_pcr);
+    gst_byte_writer_put_uint64_be (writer, pcrtable->first_offset);
+    gst_byte_writer_put_uint64_be (writer, pcrtable->last_pcr);
+    gst_byte_writer_put_uint64_be (writer, pcrtable->last_offset);
+    gst_byte_writer_put_uint32_be (writer, pcrtable->index->len);
+    for (j = 0; j < pcrtable->index->len; j++) {
+      gst_byte_writer_put_uint64_be (writer, entries[j].offset);
+      gst_byte_writer_put_uint64_be (writer, entries[j].pcr);
+    }
+  }
+
+  gst_byte_writer_put_uint32_be (writer, priv->keyframes->len);
+  for (i = 0; i < priv->keyframes->len; i++) {
+    MpegTSKeyframe *keyframe =
+        &g_array_index (priv->keyframes, MpegTSKeyframe, i);
+
+    gst_byte_writer_put_uint64_be (writer, keyframe->offset);
+    gst_byte_writer_put_uint64_be (writer, keyframe->ts);
+    gst_byte_writer_put_uint16_be (writer, keyframe->pid);
+  }
+
+  priv->index_changed = FALSE;
+}
+
+/* Replaces the current observations with the ones from @reader. On error
+ * nothing is kept and FALSE is returned */
+gboolean
+mpegts_packetizer_read_index (MpegTSPacketizer2 * packetizer,
+    GstByteReader * reader)
+{
+  MpegTSPacketizerPrivate *priv = packetizer->priv;
+  guint16 n_tables, pid;
+  guint32 n_entries;
+  guint i, j;
+
+  flush_observations (packetizer);
+
+  if (!gst_byte_reader_get_uint16_be (reader, &n_tables))
+    goto error;
+  if (n_tables >= MAX_PCR_OBS_CHANNELS)
+    goto error;
+
+  for (i = 0; i < n_tables; i++) {
+    MpegTSPCR *pcrtable;
+    MpegTSPCRIndexEntry entry;
+    guint64 first_pcr, first_offset, last_pcr, last_offset;
+
+    if (!gst_byte_reader_get_uint16_be (reader, &pid) || pid > 0x1fff ||
+        priv->pcrtablelut[pid] != 0xff ||
+        !gst_byte_reader_get_uint64_be (reader, &first_pcr) ||
+        !gst_byte_reader_get_uint64_be (reader, &first_offset) ||
+        !gst_byte_reader_get_uint64_be (reader, &last_pcr) ||
+        !gst_byte_reader_get_uint64_be (reader, &last_offset) ||
+        !gst_byte_reader_get_uint32_be (reader, &n_entries))
+      goto error;
+    if (gst_byte_reader_get_remaining (reader) / 16 < n_entries)
+      goto error;
+
+    pcrtable = get_pcr_table (packetizer, pid);
+    pcrtable->first_pcr = first_pcr;
+    pcrtable->first_offset = first_offset;
+    pcrtable->last_pcr = last_pcr;
+    pcrtable->last_offset = last_offset;
+    if (first_pcr != -1) {
+      pcrtable->first_pcr_ts = PCRTIME_TO_GSTTIME (first_pcr);
+      priv->nb_seen_offsets++;
+    }
+    if (last_pcr != -1) {
+      pcrtable->last_pcr_ts = PCRTIME_TO_GSTTIME (last_pcr);
+      priv->nb_seen_offsets++;
+    }
+
+    g_array_set_size (pcrtable->index, 0);
+    for (j = 0; j < n_entries; j++) {
+      entry.offset = gst_byte_reader_get_uint64_be_unchecked (reader);
+      entry.pcr = gst_byte_reader_get_uint64_be_unchecked (reader);
+      /* the interpolation relies on both being strictly increasing */
+      if (j > 0 && (entry.offset <= g_array_index (pcrtable->index,
+                  MpegTSPCRIndexEntry, j - 1).offset
+              || entry.pcr <= g_array_index (pcrtable->index,
+                  MpegTSPCRIndexEntry, j - 1).pcr))
+        goto error;
+      g_array_append_val (pcrtable->index, entry);
+    }
+  }
+
+  if (!gst_byte_reader_get_uint32_be (reader, &n_entries))
+    goto error;
+  if (gst_byte_reader_get_remaining (reader) / 18 < n_entries)
+    goto error;
+  g_array_set_size (priv->keyframes, n_entries);
+  for (i = 0; i < n_entries; i++) {
+    MpegTSKeyframe *keyframe =
+        &g_array_index (priv->keyframes, MpegTSKeyframe, i);
+
+    keyframe->offset = gst_byte_reader_get_uint64_be_unchecked (reader);
+    keyframe->ts = gst_byte_reader_get_uint64_be_unchecked (reader);
+    keyframe->pid = gst_byte_reader_get_uint16_be_unchecked (reader);
+    if (i > 0 && keyframe->ts < (keyframe - 1)->ts)
+      goto error;
+  }
+
+  GST_DEBUG ("Read %u PCR tables and %u keyframes", n_tables,
+      priv->keyframes->len);
+  priv->index_changed = FALSE;
+
+  return TRUE;
+
+error:
+  GST_WARNING ("Invalid index");
+  flush_observations (packetizer);
+  return FALSE;
+}
+
 void
 mpegts_packetizer_set_reference_offset (MpegTSPacketizer2 * packetizer,
     guint64 refoffset)
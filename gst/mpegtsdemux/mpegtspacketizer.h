@@ -26,6 +26,8 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstadapter.h>
+#include <gst/base/gstbytereader.h>
+#include <gst/base/gstbytewriter.h>
 #include <glib.h>
 
 #include "gstmpegdefs.h"
@@ -38,6 +40,7 @@
 #define MPEGTS_MIN_PACKETSIZE MPEGTS_NORMAL_PACKETSIZE
 #define MPEGTS_MAX_PACKETSIZE MPEGTS_ATSC_PACKETSIZE
 
+#define MPEGTS_AFC_RANDOM_ACCESS_FLAG	0x40
 #define MPEGTS_AFC_PCR_FLAG	0x10
 #define MPEGTS_AFC_OPCR_FLAG	0x08
 
@@ -169,6 +172,7 @@ G_GNUC_INTERNAL GType mpegts_packetizer_get_type(void);
 G_GNUC_INTERNAL MpegTSPacketizer2 *mpegts_packetizer_new (void);
 G_GNUC_INTERNAL void mpegts_packetizer_clear (MpegTSPacketizer2 *packetizer);
 G_GNUC_INTERNAL void mpegts_packetizer_flush (MpegTSPacketizer2 *packetizer);
+G_GNUC_INTERNAL void mpegts_packetizer_clear_observations (MpegTSPacketizer2 *packetizer);
 G_GNUC_INTERNAL void mpegts_packetizer_push (MpegTSPacketizer2 *packetizer, GstBuffer *buffer);
 G_GNUC_INTERNAL gboolean mpegts_packetizer_has_packets (MpegTSPacketizer2 *packetizer);
 G_GNUC_INTERNAL MpegTSPacketizerPacketReturn mpegts_packetizer_next_packet (MpegTSPacketizer2 *packetizer,
@@ -211,9 +215,44 @@ mpegts_packetizer_ts_to_offset (MpegTSPacketizer2 * packetizer,
 G_GNUC_INTERNAL GstClockTime
 mpegts_packetizer_pts_to_ts (MpegTSPacketizer2 * packetizer,
 			     GstClockTime pts, guint16 pcr_pid);
+/* Timestamp of the latest input buffer that had one */
+G_GNUC_INTERNAL GstClockTime
+mpegts_packetizer_get_current_time (MpegTSPacketizer2 * packetizer);
 G_GNUC_INTERNAL void
 mpegts_packetizer_set_reference_offset (MpegTSPacketizer2 * packetizer,
 					guint64 refoffset);
+
+/* PCR index, only valid if calculate_offset is TRUE */
+/* Adds the PCR of @pcr_pid found in @buffer (which must have a valid offset)
+ * to the index, without parsing state being affected. Returns the number of
+ * entries added */
+G_GNUC_INTERNAL guint
+mpegts_packetizer_scan_pcr (MpegTSPacketizer2 * packetizer, GstBuffer * buffer,
+			    guint16 packet_size, guint16 pcr_pid);
+/* Time between the index entries around @ts, 0 if @ts is indexed and
+ * GST_CLOCK_TIME_NONE if @ts is outside of the index */
+G_GNUC_INTERNAL GstClockTime
+mpegts_packetizer_get_index_span (MpegTSPacketizer2 * packetizer,
+				  GstClockTime ts, guint16 pcr_pid);
+
+/* Keyframe table */
+G_GNUC_INTERNAL void
+mpegts_packetizer_add_keyframe (MpegTSPacketizer2 * packetizer, guint16 pid,
+				guint64 offset, GstClockTime ts);
+/* Returns the offset of the last keyframe of @pid at or before @ts or -1 */
+G_GNUC_INTERNAL guint64
+mpegts_packetizer_get_keyframe (MpegTSPacketizer2 * packetizer, guint16 pid,
+				GstClockTime ts, GstClockTime * keyframe_ts);
+
+/* (De)serialization of the PCR observations, PCR index and keyframe table */
+G_GNUC_INTERNAL gboolean
+mpegts_packetizer_index_changed (MpegTSPacketizer2 * packetizer);
+G_GNUC_INTERNAL void
+mpegts_packetizer_write_index (MpegTSPacketizer2 * packetizer,
+			       GstByteWriter * writer);
+G_GNUC_INTERNAL gboolean
+mpegts_packetizer_read_index (MpegTSPacketizer2 * packetizer,
+			      GstByteReader * reader);
 G_END_DECLS
 
 #endif /* GST_MPEGTS_PACKETIZER_H */
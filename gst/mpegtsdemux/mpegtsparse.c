@@ -40,6 +40,13 @@
 #define TABLE_ID_UNSET 0xFF
 #define RUNNING_STATUS_RUNNING 4
 
+#define DEFAULT_PACKETS_PER_BUFFER 7
+#define DEFAULT_MAX_LATENCY (100 * GST_MSECOND)
+
+/* runs of at least that many consecutive packets going to the same pad are
+ * pushed as sub-buffers of the input instead of being copied */
+#define MIN_SUBBUFFER_PACKETS 4
+
 GST_DEBUG_CATEGORY_STATIC (mpegts_parse_debug);
 #define GST_CAT_DEFAULT mpegts_parse_debug
 
@@ -64,6 +71,25 @@ struct _MpegTSParsePad
 
   /* the return of the latest push */
   GstFlowReturn flow_return;
+
+  /* Buffers waiting to be pushed as one, in order. Sub-buffers of the input
+   * or of the scratch buffer */
+  GPtrArray *pending;
+  guint pending_packets;
+  GstClockTime pending_ts;
+  /* the return of the latest actual push downstream */
+  GstFlowReturn last_flow;
+
+  /* Packets consecutive in the memory of run_buffer */
+  GstBuffer *run_buffer;
+  const guint8 *run_data;
+  guint run_size;
+
+  /* Packets which are not part of a long enough run are copied here, the
+   * data from scratch_start on is not in pending yet */
+  GstBuffer *scratch;
+  guint scratch_start;
+  guint scratch_used;
 };
 
 static GstStaticPadTemplate src_template =
@@ -80,10 +106,17 @@ GST_STATIC_PAD_TEMPLATE ("program_%d", GST_PAD_SRC,
 
 enum
 {
-  ARG_0,
+  PROP_0,
+  PROP_PACKETS_PER_BUFFER,
+  PROP_MAX_LATENCY,
   /* FILL ME */
 };
 
+static void mpegts_parse_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void mpegts_parse_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static void
 mpegts_parse_program_started (MpegTSBase * base, MpegTSBaseProgram * program);
 static void
@@ -97,6 +130,9 @@ static MpegTSParsePad *mpegts_parse_create_tspad (MpegTSParse2 * parse,
     const gchar * name);
 static void mpegts_parse_destroy_tspad (MpegTSParse2 * parse,
     MpegTSParsePad * tspad);
+static GstFlowReturn mpegts_parse_tspad_flush (MpegTSParse2 * parse,
+    MpegTSParsePad * tspad);
+static void mpegts_parse_discard_pad (GstPad * pad, gpointer user_data);
 
 static void mpegts_parse_pad_removed (GstElement * element, GstPad * pad);
 static GstPad *mpegts_parse_request_new_pad (GstElement * element,
@@ -129,9 +165,43 @@ mpegts_parse_base_init (gpointer klass)
 static void
 mpegts_parse_class_init (MpegTSParse2Class * klass)
 {
+  GObjectClass *gobject_class;
   GstElementClass *element_class;
   MpegTSBaseClass *ts_class;
 
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->set_property = mpegts_parse_set_property;
+  gobject_class->get_property = mpegts_parse_get_property;
+
+  /**
+   * MpegTSParse2:packets-per-buffer
+   *
+   * Number of packets gathered in one buffer before pushing it on a program
+   * pad.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PACKETS_PER_BUFFER,
+      g_param_spec_uint ("packets-per-buffer", "Packets per buffer",
+          "Number of packets pushed at once on the program pads", 1,
+          G_MAXUINT / 188, DEFAULT_PACKETS_PER_BUFFER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * MpegTSParse2:max-latency
+   *
+   * Maximum time packets are held back on a program pad while gathering
+   * them, based on the input timestamps. Packets of untimestamped input are
+   * only held back until enough of them were gathered.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LATENCY,
+      g_param_spec_uint64 ("max-latency", "Maximum latency",
+          "Maximum time packets are held back on the program pads (in ns)",
+          0, G_MAXUINT64, DEFAULT_MAX_LATENCY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class = GST_ELEMENT_CLASS (klass);
   element_class->pad_removed = mpegts_parse_pad_removed;
   element_class->request_new_pad = mpegts_parse_request_new_pad;
@@ -153,6 +223,45 @@ mpegts_parse_init (MpegTSParse2 * parse, MpegTSParse2Class * klass)
 
   parse->srcpad = gst_pad_new_from_static_template (&src_template, "src");
   gst_element_add_pad (GST_ELEMENT (parse), parse->srcpad);
+
+  parse->packets_per_buffer = DEFAULT_PACKETS_PER_BUFFER;
+  parse->max_latency = DEFAULT_MAX_LATENCY;
+}
+
+static void
+mpegts_parse_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  MpegTSParse2 *parse = GST_MPEGTS_PARSE (object);
+
+  switch (prop_id) {
+    case PROP_PACKETS_PER_BUFFER:
+      parse->packets_per_buffer = g_value_get_uint (value);
+      break;
+    case PROP_MAX_LATENCY:
+      parse->max_latency = g_value_get_uint64 (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+  }
+}
+
+static void
+mpegts_parse_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  MpegTSParse2 *parse = GST_MPEGTS_PARSE (object);
+
+  switch (prop_id) {
+    case PROP_PACKETS_PER_BUFFER:
+      g_value_set_uint (value, parse->packets_per_buffer);
+      break;
+    case PROP_MAX_LATENCY:
+      g_value_set_uint64 (value, parse->max_latency);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+  }
 }
 
 static void
@@ -181,6 +290,8 @@ mpegts_parse_reset (MpegTSBase * base)
   /* SIT */
   MPEGTS_BIT_SET (base->known_psi, 0x1f);
 
+  g_list_foreach (GST_MPEGTS_PARSE (base)->srcpads,
+      (GFunc) mpegts_parse_discard_pad, NULL);
 }
 
 static gboolean
@@ -192,6 +303,15 @@ push_event (MpegTSBase * base, GstEvent * event)
   for (tmp = parse->srcpads; tmp; tmp = tmp->next) {
     GstPad *pad = (GstPad *) tmp->data;
     if (pad) {
+      MpegTSParsePad *tspad =
+          (MpegTSParsePad *) gst_pad_get_element_private (pad);
+
+      /* gathered packets go before serialized events */
+      if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+        mpegts_parse_discard_pad (pad, NULL);
+      else if (GST_EVENT_IS_SERIALIZED (event))
+        mpegts_parse_tspad_flush (parse, tspad);
+
       gst_event_ref (event);
       gst_pad_push_event (pad, event);
     }
@@ -219,6 +339,9 @@ mpegts_parse_create_tspad (MpegTSParse2 * parse, const gchar * pad_name)
   tspad->program = NULL;
   tspad->pushed = FALSE;
   tspad->flow_return = GST_FLOW_NOT_LINKED;
+  tspad->pending = g_ptr_array_new ();
+  tspad->pending_ts = GST_CLOCK_TIME_NONE;
+  tspad->last_flow = GST_FLOW_OK;
   gst_pad_set_element_private (pad, tspad);
 
   return tspad;
@@ -227,10 +350,187 @@ mpegts_parse_create_tspad (MpegTSParse2 * parse, const gchar * pad_name)
 static void
 mpegts_parse_destroy_tspad (MpegTSParse2 * parse, MpegTSParsePad * tspad)
 {
+  mpegts_parse_discard_pad (tspad->pad, NULL);
+  g_ptr_array_free (tspad->pending, TRUE);
+
   /* free the wrapper */
   g_free (tspad);
 }
 
+/* Moves the copied packets which are not pending yet to pending */
+static void
+mpegts_parse_tspad_close_scratch (MpegTSParsePad * tspad)
+{
+  if (tspad->scratch_used > tspad->scratch_start) {
+    g_ptr_array_add (tspad->pending, gst_buffer_create_sub (tspad->scratch,
+            tspad->scratch_start, tspad->scratch_used - tspad->scratch_start));
+    tspad->scratch_start = tspad->scratch_used;
+  }
+}
+
+static void
+mpegts_parse_tspad_copy (MpegTSParse2 * parse, MpegTSParsePad * tspad,
+    const guint8 * data, guint size)
+{
+  if (tspad->scratch &&
+      tspad->scratch_used + size > GST_BUFFER_SIZE (tspad->scratch)) {
+    mpegts_parse_tspad_close_scratch (tspad);
+    gst_buffer_unref (tspad->scratch);
+    tspad->scratch = NULL;
+  }
+  if (tspad->scratch == NULL) {
+    tspad->scratch = gst_buffer_new_and_alloc (MAX (size,
+            parse->packets_per_buffer * 188));
+    tspad->scratch_start = tspad->scratch_used = 0;
+  }
+
+  memcpy (GST_BUFFER_DATA (tspad->scratch) + tspad->scratch_used, data, size);
+  tspad->scratch_used += size;
+}
+
+/* Moves the current run of packets to pending */
+static void
+mpegts_parse_tspad_close_run (MpegTSParse2 * parse, MpegTSParsePad * tspad)
+{
+  if (tspad->run_buffer == NULL)
+    return;
+
+  if (tspad->run_size >= MIN_SUBBUFFER_PACKETS * 188) {
+    GstBuffer *sub;
+
+    sub = gst_buffer_create_sub (tspad->run_buffer,
+        tspad->run_data - GST_BUFFER_DATA (tspad->run_buffer),
+        tspad->run_size);
+    if (sub) {
+      mpegts_parse_tspad_close_scratch (tspad);
+      g_ptr_array_add (tspad->pending, sub);
+    } else {
+      mpegts_parse_tspad_copy (parse, tspad, tspad->run_data,
+          tspad->run_size);
+    }
+  } else {
+    mpegts_parse_tspad_copy (parse, tspad, tspad->run_data, tspad->run_size);
+  }
+
+  gst_buffer_unref (tspad->run_buffer);
+  tspad->run_buffer = NULL;
+  tspad->run_size = 0;
+}
+
+/* Pushes all the gathered packets of @tspad downstream as one buffer, or as
+ * a one group buffer list if they are not contiguous in memory */
+static GstFlowReturn
+mpegts_parse_tspad_flush (MpegTSParse2 * parse, MpegTSParsePad * tspad)
+{
+  GstFlowReturn ret;
+  GstCaps *caps;
+  guint i;
+
+  mpegts_parse_tspad_close_run (parse, tspad);
+  mpegts_parse_tspad_close_scratch (tspad);
+  if (tspad->scratch) {
+    /* the pending sub-buffers keep it alive */
+    gst_buffer_unref (tspad->scratch);
+    tspad->scratch = NULL;
+  }
+
+  if (tspad->pending->len == 0)
+    return tspad->last_flow;
+
+  GST_LOG_OBJECT (tspad->pad, "pushing %u packets in %u buffers",
+      tspad->pending_packets, tspad->pending->len);
+
+  caps = GST_PAD_CAPS (tspad->pad);
+  for (i = 0; i < tspad->pending->len; i++)
+    gst_buffer_set_caps (GST_BUFFER_CAST (tspad->pending->pdata[i]), caps);
+
+  if (tspad->pending->len == 1) {
+    ret = gst_pad_push (tspad->pad, tspad->pending->pdata[0]);
+  } else {
+    GstBufferList *list = gst_buffer_list_new ();
+    GstBufferListIterator *it = gst_buffer_list_iterate (list);
+
+    gst_buffer_list_iterator_add_group (it);
+    for (i = 0; i < tspad->pending->len; i++)
+      gst_buffer_list_iterator_add (it, tspad->pending->pdata[i]);
+    gst_buffer_list_iterator_free (it);
+
+    ret = gst_pad_push_list (tspad->pad, list);
+  }
+
+  g_ptr_array_set_size (tspad->pending, 0);
+  tspad->pending_packets = 0;
+  tspad->pending_ts = GST_CLOCK_TIME_NONE;
+  tspad->last_flow = ret;
+
+  return ret;
+}
+
+/* Drops all the gathered packets of the pad */
+static void
+mpegts_parse_discard_pad (GstPad * pad, gpointer user_data)
+{
+  MpegTSParsePad *tspad = (MpegTSParsePad *) gst_pad_get_element_private (pad);
+
+  if (tspad->run_buffer) {
+    gst_buffer_unref (tspad->run_buffer);
+    tspad->run_buffer = NULL;
+    tspad->run_size = 0;
+  }
+  if (tspad->scratch) {
+    gst_buffer_unref (tspad->scratch);
+    tspad->scratch = NULL;
+  }
+  g_ptr_array_foreach (tspad->pending, (GFunc) gst_mini_object_unref, NULL);
+  g_ptr_array_set_size (tspad->pending, 0);
+  tspad->pending_packets = 0;
+  tspad->pending_ts = GST_CLOCK_TIME_NONE;
+  tspad->last_flow = GST_FLOW_OK;
+}
+
+/* Gathers @packet for @tspad, extending the current run if it directly
+ * follows it in the same input buffer, and pushes once enough packets were
+ * gathered or they were held back for too long */
+static GstFlowReturn
+mpegts_parse_tspad_add_packet (MpegTSParse2 * parse, MpegTSParsePad * tspad,
+    MpegTSPacketizerPacket * packet)
+{
+  GstBuffer *input = ((MpegTSBase *) parse)->current_buffer;
+  const guint8 *data = packet->data_start;
+  guint size = packet->data_end - packet->data_start;
+
+  /* consecutive input buffers can be adjacent in memory, for example when
+   * they are sub-buffers of one parent, but a run never leaves its buffer */
+  if (tspad->run_buffer && tspad->run_buffer == input &&
+      data == tspad->run_data + tspad->run_size &&
+      data + size <= GST_BUFFER_DATA (input) + GST_BUFFER_SIZE (input)) {
+    tspad->run_size += size;
+  } else {
+    mpegts_parse_tspad_close_run (parse, tspad);
+    if (input && data >= GST_BUFFER_DATA (input) &&
+        data + size <= GST_BUFFER_DATA (input) + GST_BUFFER_SIZE (input)) {
+      tspad->run_buffer = gst_buffer_ref (input);
+      tspad->run_data = data;
+      tspad->run_size = size;
+    } else {
+      /* the packet is in the packetizer's own memory */
+      mpegts_parse_tspad_copy (parse, tspad, data, size);
+    }
+  }
+
+  tspad->pending_packets++;
+  if (!GST_CLOCK_TIME_IS_VALID (tspad->pending_ts))
+    tspad->pending_ts = packet->origts;
+
+  if (tspad->pending_packets >= parse->packets_per_buffer ||
+      (GST_CLOCK_TIME_IS_VALID (tspad->pending_ts) &&
+          GST_CLOCK_TIME_IS_VALID (packet->origts) &&
+          packet->origts >= tspad->pending_ts + parse->max_latency))
+    return mpegts_parse_tspad_flush (parse, tspad);
+
+  return tspad->last_flow;
+}
+
 static void
 mpegts_parse_pad_removed (GstElement * element, GstPad * pad)
 {
@@ -295,6 +595,18 @@ mpegts_parse_request_new_pad (GstElement * element, GstPadTemplate * template,
 static void
 mpegts_parse_release_pad (GstElement * element, GstPad * pad)
 {
+  MpegTSParse2 *parse = GST_MPEGTS_PARSE (element);
+  MpegTSParsePad *tspad;
+  GstPad *sinkpad = ((MpegTSBase *) parse)->sinkpad;
+
+  /* push the packets gathered for the pad while it is still active; the
+   * streaming thread gathers them with the stream lock held */
+  GST_PAD_STREAM_LOCK (sinkpad);
+  tspad = (MpegTSParsePad *) gst_pad_get_element_private (pad);
+  if (tspad)
+    mpegts_parse_tspad_flush (parse, tspad);
+  GST_PAD_STREAM_UNLOCK (sinkpad);
+
   gst_pad_set_active (pad, FALSE);
   /* we do the cleanup in GstElement::pad-removed */
   gst_element_remove_pad (element, pad);
@@ -327,14 +639,8 @@ mpegts_parse_tspad_push_section (MpegTSParse2 * parse, MpegTSParsePad * tspad,
       "pushing section: %d program number: %d table_id: %d", to_push,
       tspad->program_number, section->table_id);
 
-  if (to_push) {
-    GstBuffer *buf =
-        gst_buffer_new_and_alloc (packet->data_end - packet->data_start);
-    memcpy (GST_BUFFER_DATA (buf), packet->data_start,
-        packet->data_end - packet->data_start);
-    gst_buffer_set_caps (buf, GST_PAD_CAPS (tspad->pad));
-    ret = gst_pad_push (tspad->pad, buf);
-  }
+  if (to_push)
+    ret = mpegts_parse_tspad_add_packet (parse, tspad, packet);
 
   return ret;
 }
@@ -357,15 +663,9 @@ mpegts_parse_tspad_push (MpegTSParse2 * parse, MpegTSParsePad * tspad,
     }
   }
 
-  if (pad_pids == NULL || pad_pids[packet->pid]) {
-    GstBuffer *buf =
-        gst_buffer_new_and_alloc (packet->data_end - packet->data_start);
-    memcpy (GST_BUFFER_DATA (buf), packet->data_start,
-        packet->data_end - packet->data_start);
-    gst_buffer_set_caps (buf, GST_PAD_CAPS (tspad->pad));
-    /* push if there's no filter or if the pid is in the filter */
-    ret = gst_pad_push (tspad->pad, buf);
-  }
+  /* push if there's no filter or if the pid is in the filter */
+  if (pad_pids == NULL || pad_pids[packet->pid])
+    ret = mpegts_parse_tspad_add_packet (parse, tspad, packet);
 
 out:
   return ret;
@@ -469,6 +769,21 @@ static GstFlowReturn
 mpegts_parse_input_done (MpegTSBase * base, GstBuffer * buffer)
 {
   MpegTSParse2 *parse = GST_MPEGTS_PARSE (base);
+  GstClockTime ts = GST_BUFFER_TIMESTAMP (buffer);
+  GList *tmp;
+
+  /* Don't hold back packets of pads which didn't get any new ones for too
+   * long. Flow errors get reported with the next packet of the pad */
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    for (tmp = parse->srcpads; tmp; tmp = tmp->next) {
+      MpegTSParsePad *tspad =
+          (MpegTSParsePad *) gst_pad_get_element_private (tmp->data);
+
+      if (GST_CLOCK_TIME_IS_VALID (tspad->pending_ts) &&
+          ts >= tspad->pending_ts + parse->max_latency)
+        mpegts_parse_tspad_flush (parse, tspad);
+    }
+  }
 
   return gst_pad_push (parse->srcpad, buffer);
 }
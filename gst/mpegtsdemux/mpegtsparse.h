@@ -52,6 +52,10 @@ struct _MpegTSParse2 {
   GstPad *srcpad;
 
   GList *srcpads;
+
+  /* properties */
+  guint packets_per_buffer;
+  GstClockTime max_latency;
 };
 
 struct _MpegTSParse2Class {
@@ -50,9 +50,16 @@
  * See TODO for explanations on improvements needed
  */
 
-/* latency in mseconds */
+/* latency in mseconds, reported until it was measured */
 #define TS_LATENCY 700
 
+/* Live latency measurement: number of samples taken before the measured
+ * value replaces TS_LATENCY, margin added to the measured value and drift
+ * from the reported value after which a latency message is posted */
+#define LATENCY_MIN_SAMPLES 25
+#define LATENCY_MARGIN (50 * GST_MSECOND)
+#define LATENCY_DRIFT (25 * GST_MSECOND)
+
 #define TABLE_ID_UNSET 0xFF
 
 #define CONTINUITY_UNSET 255
@@ -72,6 +79,10 @@
  */
 #define SEEK_TIMESTAMP_OFFSET (500 * GST_MSECOND)
 
+/* only seek to a known keyframe if it is at most MAX_KEYFRAME_DISTANCE before
+ * the desired position, else go through the PCR index */
+#define MAX_KEYFRAME_DISTANCE (5 * GST_SECOND)
+
 #define SEGMENT_FORMAT "[format:%s, rate:%f, start:%"			\
   GST_TIME_FORMAT", stop:%"GST_TIME_FORMAT", time:%"GST_TIME_FORMAT	\
   ", accum:%"GST_TIME_FORMAT", last_stop:%"GST_TIME_FORMAT		\
@@ -153,6 +164,10 @@ struct _TSDemuxStream
   GstTagList *taglist;
 
   gint continuity_counter;
+
+  /* Smoothed delay between the arrival of the input and the timestamp of
+   * the output on live streams */
+  GstClockTime latency;
 };
 
 #define VIDEO_CAPS \
@@ -222,6 +237,8 @@ enum
   ARG_0,
   PROP_PROGRAM_NUMBER,
   PROP_EMIT_STATS,
+  PROP_INDEX_LOCATION,
+  PROP_LATENCY_STATS,
   /* FILL ME */
 };
 
@@ -310,6 +327,38 @@ gst_ts_demux_class_init (GstTSDemuxClass * klass)
           "Emit messages for every pcr/opcr/pts/dts", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTSDemux:index-location
+   *
+   * Location of a sidecar index file for the demuxed file. When reading a
+   * local file in pull mode, the PCR and keyframe positions are read from
+   * it instead of scanning the file, provided the file size and
+   * modification time still match. The index is (re)written with everything
+   * that was learnt about the file when stopping.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_INDEX_LOCATION,
+      g_param_spec_string ("index-location", "Index location",
+          "Location of the sidecar index file (NULL to disable)", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTSDemux:latency-stats
+   *
+   * Statistics of the latency measured on live streams, as a structure
+   * with the reported latency ("latency"), the smoothed measurement it is
+   * derived from ("measured"), the extreme samples ("min" and "max") and
+   * the number of samples taken ("samples"). Latencies are in nanoseconds
+   * and "latency" is GST_CLOCK_TIME_NONE until enough samples were taken.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (gobject_class, PROP_LATENCY_STATS,
+      g_param_spec_boxed ("latency-stats", "Latency statistics",
+          "Statistics of the latency measured on live streams",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
 
   ts_class = GST_MPEGTS_BASE_CLASS (klass);
   ts_class->reset = GST_DEBUG_FUNCPTR (gst_ts_demux_reset);
@@ -341,6 +390,14 @@ gst_ts_demux_reset (MpegTSBase * base)
     gst_event_unref (demux->update_segment);
     demux->update_segment = NULL;
   }
+
+  GST_OBJECT_LOCK (demux);
+  demux->latency = GST_CLOCK_TIME_NONE;
+  demux->measured_latency = 0;
+  demux->min_latency_sample = GST_CLOCK_TIME_NONE;
+  demux->max_latency_sample = 0;
+  demux->latency_samples = 0;
+  GST_OBJECT_UNLOCK (demux);
 }
 
 static void
@@ -367,6 +424,12 @@ gst_ts_demux_set_property (GObject * object, guint prop_id,
     case PROP_EMIT_STATS:
       demux->emit_statistics = g_value_get_boolean (value);
       break;
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (demux);
+      g_free (GST_MPEGTS_BASE (demux)->index_location);
+      GST_MPEGTS_BASE (demux)->index_location = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -385,6 +448,21 @@ gst_ts_demux_get_property (GObject * object, guint prop_id,
     case PROP_EMIT_STATS:
       g_value_set_boolean (value, demux->emit_statistics);
       break;
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_string (value, GST_MPEGTS_BASE (demux)->index_location);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_LATENCY_STATS:
+      GST_OBJECT_LOCK (demux);
+      g_value_take_boxed (value, gst_structure_new ("latency-stats",
+              "latency", G_TYPE_UINT64, demux->latency,
+              "measured", G_TYPE_UINT64, demux->measured_latency,
+              "min", G_TYPE_UINT64, demux->min_latency_sample,
+              "max", G_TYPE_UINT64, demux->max_latency_sample,
+              "samples", G_TYPE_UINT, demux->latency_samples, NULL));
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -447,7 +525,7 @@ gst_ts_demux_srcpad_query (GstPad * pad, GstQuery * query)
       GST_DEBUG ("query latency");
       res = gst_pad_peer_query (base->sinkpad, query);
       if (res && base->upstream_live) {
-        GstClockTime min_lat, max_lat;
+        GstClockTime min_lat, max_lat, latency;
         gboolean live;
 
         /* According to H.222.0
@@ -455,13 +533,23 @@ gst_ts_demux_srcpad_query (GstPad * pad, GstQuery * query)
            and D.0.2 (Audio and video presentation synchronization)
 
            We can end up with an interval of up to 700ms between valid
-           PCR/SCR. We therefore allow a latency of 700ms for that.
+           PCR/SCR. We therefore allow a latency of 700ms for that until
+           the actual latency of the stream was measured.
          */
+        GST_OBJECT_LOCK (demux);
+        latency = demux->latency;
+        GST_OBJECT_UNLOCK (demux);
+        if (!GST_CLOCK_TIME_IS_VALID (latency))
+          latency = TS_LATENCY * GST_MSECOND;
+
+        GST_DEBUG_OBJECT (demux, "adding latency %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (latency));
+
         gst_query_parse_latency (query, &live, &min_lat, &max_lat);
         if (min_lat != -1)
-          min_lat += 700 * GST_MSECOND;
+          min_lat += latency;
         if (max_lat != -1)
-          max_lat += 700 * GST_MSECOND;
+          max_lat += latency;
         gst_query_set_latency (query, live, min_lat, max_lat);
       }
       break;
@@ -497,6 +585,43 @@ gst_ts_demux_srcpad_query (GstPad * pad, GstQuery * query)
 
 }
 
+static gboolean
+is_video_stream_type (guint8 stream_type)
+{
+  return stream_type == ST_VIDEO_MPEG1 || stream_type == ST_VIDEO_MPEG2 ||
+      stream_type == ST_VIDEO_H264;
+}
+
+/* Returns the lowest offset of the keyframes of all video streams of the
+ * current program at or before @ts, or -1 if one of them has none within
+ * MAX_KEYFRAME_DISTANCE */
+static guint64
+gst_ts_demux_find_keyframe (GstTSDemux * demux, GstClockTime ts)
+{
+  MpegTSBase *base = (MpegTSBase *) demux;
+  GstClockTime keyframe_ts;
+  guint64 offset, res = -1;
+  GList *tmp;
+
+  for (tmp = demux->program->stream_list; tmp; tmp = tmp->next) {
+    MpegTSBaseStream *bs = (MpegTSBaseStream *) tmp->data;
+
+    if (!is_video_stream_type (bs->stream_type))
+      continue;
+
+    offset = mpegts_packetizer_get_keyframe (base->packetizer, bs->pid, ts,
+        &keyframe_ts);
+    if (offset == -1 || ts - keyframe_ts > MAX_KEYFRAME_DISTANCE)
+      return -1;
+
+    GST_DEBUG ("pid 0x%04x keyframe at %" GST_TIME_FORMAT " offset %"
+        G_GUINT64_FORMAT, bs->pid, GST_TIME_ARGS (keyframe_ts), offset);
+    res = MIN (res, offset);
+  }
+
+  return res;
+}
+
 static GstFlowReturn
 gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
 {
@@ -545,10 +670,11 @@ gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
   GST_DEBUG ("seeksegment after set_seek " SEGMENT_FORMAT,
       SEGMENT_ARGS (seeksegment));
 
-  /* Convert start/stop to offset */
-  start_offset =
-      mpegts_packetizer_ts_to_offset (base->packetizer, MAX (0,
-          start - SEEK_TIMESTAMP_OFFSET), demux->program->pcr_pid);
+  /* Convert start/stop to offset, preferring a keyframe we already saw */
+  start_offset = gst_ts_demux_find_keyframe (demux, start);
+  if (start_offset == -1)
+    start_offset = mpegts_base_find_offset (base, MAX (0,
+            start - SEEK_TIMESTAMP_OFFSET), demux->program->pcr_pid);
 
   if (G_UNLIKELY (start_offset == -1)) {
     GST_WARNING ("Couldn't convert start position to an offset");
@@ -1054,6 +1180,7 @@ gst_ts_demux_stream_added (MpegTSBase * base, MpegTSBaseStream * bstream,
     stream->nb_pts_rollover = 0;
     stream->nb_dts_rollover = 0;
     stream->continuity_counter = CONTINUITY_UNSET;
+    stream->latency = 0;
   }
   stream->flow_return = GST_FLOW_OK;
 }
@@ -1137,6 +1264,7 @@ gst_ts_demux_stream_flush (TSDemuxStream * stream)
   stream->nb_pts_rollover = 0;
   stream->nb_dts_rollover = 0;
   stream->continuity_counter = CONTINUITY_UNSET;
+  stream->latency = 0;
   if (stream->flow_return == GST_FLOW_WRONG_STATE) {
     stream->flow_return = GST_FLOW_OK;
   }
@@ -1284,9 +1412,48 @@ gst_ts_demux_record_dts (GstTSDemux * demux, TSDemuxStream * stream,
   }
 }
 
+/* Minimal parsing of the start of a video PES payload to find out whether it
+ * can be decoded on its own */
+static gboolean
+gst_ts_demux_is_keyframe (guint8 stream_type, const guint8 * data, guint size)
+{
+  guint i;
+
+  for (i = 0; i + 3 < size; i++) {
+    if (data[i] != 0x00 || data[i + 1] != 0x00 || data[i + 2] != 0x01)
+      continue;
+
+    if (stream_type == ST_VIDEO_H264) {
+      switch (data[i + 3] & 0x1f) {
+        case 5:                /* IDR slice */
+        case 7:                /* SPS */
+          return TRUE;
+        case 1:                /* non-IDR slice */
+          return FALSE;
+        default:
+          break;
+      }
+    } else {
+      switch (data[i + 3]) {
+        case 0xb3:             /* sequence header */
+        case 0xb8:             /* GOP */
+          return TRUE;
+        case 0x00:             /* picture */
+          return FALSE;
+        default:
+          break;
+      }
+    }
+    i += 2;
+  }
+
+  return FALSE;
+}
+
 static void
 gst_ts_demux_parse_pes_header (GstTSDemux * demux, TSDemuxStream * stream,
-    guint8 * data, guint32 length, guint64 bufferoffset)
+    guint8 * data, guint32 length, guint64 bufferoffset,
+    gboolean random_access)
 {
   MpegTSBase *base = (MpegTSBase *) demux;
   PESHeader header;
@@ -1327,6 +1494,21 @@ gst_ts_demux_parse_pes_header (GstTSDemux * demux, TSDemuxStream * stream,
   data += header.header_size;
   length -= header.header_size;
 
+  /* Remember where the keyframes are for seeking */
+  if (base->mode != BASE_MODE_PUSHING &&
+      is_video_stream_type (stream->stream.stream_type) &&
+      GST_CLOCK_TIME_IS_VALID (stream->pts) && demux->program &&
+      (random_access ||
+          gst_ts_demux_is_keyframe (stream->stream.stream_type, data,
+              length))) {
+    GstClockTime ts = mpegts_packetizer_pts_to_ts (base->packetizer,
+        stream->pts, demux->program->pcr_pid);
+
+    if (GST_CLOCK_TIME_IS_VALID (ts))
+      mpegts_packetizer_add_keyframe (base->packetizer, stream->stream.pid,
+          bufferoffset, ts);
+  }
+
   /* Create the output buffer */
   if (stream->expected_size)
     stream->allocated_size = stream->expected_size;
@@ -1391,7 +1573,8 @@ gst_ts_demux_queue_data (GstTSDemux * demux, TSDemuxStream * stream,
       GST_LOG ("HEADER: Parsing PES header");
 
       /* parse the header */
-      gst_ts_demux_parse_pes_header (demux, stream, data, size, packet->offset);
+      gst_ts_demux_parse_pes_header (demux, stream, data, size, packet->offset,
+          packet->afc_flags & MPEGTS_AFC_RANDOM_ACCESS_FLAG);
       break;
     }
     case PENDING_PACKET_BUFFER:
@@ -1554,6 +1737,65 @@ push_new_segment:
   stream->need_newsegment = FALSE;
 }
 
+/* Takes a latency sample for @stream which is about to push a buffer with
+ * timestamp @ts: the delay between the arrival of the input we are
+ * processing and @ts. Posts a latency message when the reported latency
+ * drifted away from the measurement */
+static void
+gst_ts_demux_update_latency (GstTSDemux * demux, TSDemuxStream * stream,
+    GstClockTime ts)
+{
+  MpegTSBase *base = (MpegTSBase *) demux;
+  GstClockTime now, sample, measured, latency;
+  gboolean post = FALSE;
+  GList *tmp;
+
+  now = mpegts_packetizer_get_current_time (base->packetizer);
+  if (!GST_CLOCK_TIME_IS_VALID (now) || !GST_CLOCK_TIME_IS_VALID (ts))
+    return;
+
+  sample = now > ts ? now - ts : 0;
+
+  /* follow increases immediately so that we don't keep being late, only
+   * decay slowly on decreases */
+  if (sample > stream->latency)
+    stream->latency = sample;
+  else
+    stream->latency = (15 * stream->latency + sample) / 16;
+
+  /* audio and video can be up to one second apart in the stream, we need
+   * to cover the one lagging most */
+  measured = 0;
+  for (tmp = demux->program->stream_list; tmp; tmp = tmp->next)
+    measured = MAX (measured, ((TSDemuxStream *) tmp->data)->latency);
+
+  GST_OBJECT_LOCK (demux);
+  demux->latency_samples++;
+  demux->measured_latency = measured;
+  if (!GST_CLOCK_TIME_IS_VALID (demux->min_latency_sample) ||
+      sample < demux->min_latency_sample)
+    demux->min_latency_sample = sample;
+  demux->max_latency_sample = MAX (demux->max_latency_sample, sample);
+
+  if (demux->latency_samples >= LATENCY_MIN_SAMPLES) {
+    latency = measured + LATENCY_MARGIN;
+    if (!GST_CLOCK_TIME_IS_VALID (demux->latency) ||
+        latency > demux->latency + LATENCY_DRIFT ||
+        latency + LATENCY_DRIFT < demux->latency) {
+      GST_INFO_OBJECT (demux, "latency changed from %" GST_TIME_FORMAT
+          " to %" GST_TIME_FORMAT, GST_TIME_ARGS (demux->latency),
+          GST_TIME_ARGS (latency));
+      demux->latency = latency;
+      post = TRUE;
+    }
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  if (post)
+    gst_element_post_message (GST_ELEMENT_CAST (demux),
+        gst_message_new_latency (GST_OBJECT_CAST (demux)));
+}
+
 static GstFlowReturn
 gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream)
 {
@@ -1612,6 +1854,9 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream)
         mpegts_packetizer_pts_to_ts (packetizer, stream->pts,
         demux->program->pcr_pid);
 
+  if (demux->parent.upstream_live)
+    gst_ts_demux_update_latency (demux, stream, GST_BUFFER_TIMESTAMP (buffer));
+
   GST_DEBUG_OBJECT (stream->pad,
       "Pushing buffer with PTS: %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)));
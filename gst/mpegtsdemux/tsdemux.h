@@ -72,6 +72,15 @@ struct _GstTSDemux
 
   /* Full stream duration */
   GstClockTime duration;
+
+  /* Latency measured on live streams, protected by the OBJECT_LOCK.
+   * latency is the value reported in latency queries, NONE until enough
+   * samples were taken */
+  GstClockTime latency;
+  GstClockTime measured_latency;
+  GstClockTime min_latency_sample;
+  GstClockTime max_latency_sample;
+  guint latency_samples;
 };
 
 struct _GstTSDemuxClass
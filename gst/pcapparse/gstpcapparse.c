@@ -25,6 +25,16 @@
  * #GstPcapParse:src-port and #GstPcapParse:dst-port to restrict which packets
  * should be included.
  *
+ * Classic libpcap files with micro- or nanosecond timestamps and pcapng files
+ * are understood. The payloads are pushed as sub-buffers of the input without
+ * copying, in one buffer list per input buffer.
+ *
+ * Several flows can be extracted in one pass by configuring them with
+ * #GstPcapParse:flows and requesting a src_%d pad for each of them. A flow is
+ * given as proto:src-ip:src-port:dst-ip:dst-port where proto is udp or tcp
+ * and any field can be * to match everything; flows are separated by ';'.
+ * The n-th flow is pushed on the pad src_n.
+ *
  * <refsect2>
  * <title>Example pipelines</title>
  * |[
@@ -32,6 +42,11 @@
  * ! ffdec_h264 ! fakesink
  * ]| Read from a pcap dump file using filesrc, extract the raw UDP packets,
  * depayload and decode them.
+ * |[
+ * gst-launch-0.10 filesrc location=capture.pcapng ! pcapparse name=p
+ * flows="udp:*:*:239.0.0.1:5004;udp:*:*:239.0.0.2:5004"
+ * p.src_0 ! queue ! fakesink p.src_1 ! queue ! fakesink
+ * ]| Demultiplex two multicast streams from one capture.
  * </refsect2>
  */
 
@@ -46,6 +61,8 @@
 
 #include "gstpcapparse.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifndef G_OS_WIN32
@@ -65,6 +82,7 @@ enum
   PROP_DST_PORT,
   PROP_CAPS,
   PROP_TS_OFFSET,
+  PROP_FLOWS,
   PROP_LAST
 };
 
@@ -81,13 +99,58 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+static GstStaticPadTemplate flow_src_template =
+GST_STATIC_PAD_TEMPLATE ("src_%d",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS_ANY);
+
+#define PCAP_MAGIC            0xa1b2c3d4
+#define PCAP_MAGIC_SWAPPED    0xd4c3b2a1
+#define PCAP_NSEC_MAGIC       0xa1b23c4d
+#define PCAP_NSEC_MAGIC_SWAPPED 0x4d3cb2a1
+
+#define PCAPNG_BLOCK_SHB      0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB      0x00000001
+#define PCAPNG_BLOCK_SPB      0x00000003
+#define PCAPNG_BLOCK_EPB      0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1a2b3c4d
+#define PCAPNG_OPT_ENDOFOPT   0
+#define PCAPNG_OPT_IF_TSRESOL 9
+
+#define ETH_HEADER_LEN    14
+#define SLL_HEADER_LEN    16
+#define IP_HEADER_MIN_LEN 20
+#define UDP_HEADER_LEN     8
+
+#define IP_PROTO_UDP      17
+#define IP_PROTO_TCP      6
+
+/* what gst_pcap_parse_scan_frame() found out about a frame */
+typedef struct
+{
+  guint8 protocol;
+  guint32 src_ip;
+  guint32 dst_ip;
+  guint16 src_port;
+  guint16 dst_port;
+  /* relative to the start of the frame */
+  guint payload_offset;
+  guint payload_size;
+} GstPcapParsePacket;
+
 static void gst_pcap_parse_finalize (GObject * object);
 static void gst_pcap_parse_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 static void gst_pcap_parse_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 
+static GstPad *gst_pcap_parse_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name);
+static void gst_pcap_parse_release_pad (GstElement * element, GstPad * pad);
+
 static void gst_pcap_parse_reset (GstPcapParse * self);
+static void gst_pcap_parse_free_flow (GstPcapParseFlow * flow);
 
 static GstFlowReturn gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer);
 static gboolean gst_pcap_sink_event (GstPad * pad, GstEvent * event);
@@ -102,6 +165,8 @@ gst_pcap_parse_base_init (gpointer gclass)
   gst_element_class_add_static_pad_template (element_class,
       &sink_template);
   gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_add_static_pad_template (element_class,
+      &flow_src_template);
 
   gst_element_class_set_details_simple (element_class, "PCapParse",
       "Raw/Parser",
@@ -113,11 +178,16 @@ static void
 gst_pcap_parse_class_init (GstPcapParseClass * klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
 
   gobject_class->finalize = gst_pcap_parse_finalize;
   gobject_class->get_property = gst_pcap_parse_get_property;
   gobject_class->set_property = gst_pcap_parse_set_property;
 
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_pcap_parse_request_new_pad);
+  element_class->release_pad = GST_DEBUG_FUNCPTR (gst_pcap_parse_release_pad);
+
   g_object_class_install_property (gobject_class,
       PROP_SRC_IP, g_param_spec_string ("src-ip", "Source IP",
           "Source IP to restrict to", "",
@@ -148,6 +218,12 @@ gst_pcap_parse_class_init (GstPcapParseClass * klass)
           "Relative timestamp offset (ns) to apply (-1 = use absolute packet time)",
           -1, G_MAXINT64, -1, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_FLOWS,
+      g_param_spec_string ("flows", "Flows",
+          "';' separated list of proto:src-ip:src-port:dst-ip:dst-port flows "
+          "to push on the src_%d request pads, '*' matches anything", "",
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_DEBUG_CATEGORY_INIT (gst_pcap_parse_debug, "pcapparse", 0, "pcap parser");
 }
 
@@ -173,6 +249,10 @@ gst_pcap_parse_init (GstPcapParse * self, GstPcapParseClass * gclass)
   self->offset = -1;
 
   self->adapter = gst_adapter_new ();
+  self->interfaces = g_array_new (FALSE, FALSE,
+      sizeof (GstPcapParseInterface));
+  self->flows = g_ptr_array_new ();
+  self->outputs = g_array_new (FALSE, FALSE, sizeof (GstPcapParseOutput));
 
   gst_pcap_parse_reset (self);
 }
@@ -185,6 +265,13 @@ gst_pcap_parse_finalize (GObject * object)
   g_object_unref (self->adapter);
   if (self->caps)
     gst_caps_unref (self->caps);
+  g_array_free (self->interfaces, TRUE);
+  g_ptr_array_foreach (self->flows, (GFunc) gst_pcap_parse_free_flow, NULL);
+  g_ptr_array_free (self->flows, TRUE);
+  g_free (self->flows_str);
+  g_array_free (self->outputs, TRUE);
+  if (self->out_caps)
+    gst_caps_unref (self->out_caps);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -213,6 +300,135 @@ set_ip_address_from_string (gint64 * ip_addr, const gchar * ip_str)
   }
 }
 
+static void
+gst_pcap_parse_free_list (GstBufferList ** list, GstBufferListIterator ** it)
+{
+  if (*it) {
+    gst_buffer_list_iterator_free (*it);
+    *it = NULL;
+  }
+  if (*list) {
+    gst_buffer_list_unref (*list);
+    *list = NULL;
+  }
+}
+
+static void
+gst_pcap_parse_free_flow (GstPcapParseFlow * flow)
+{
+  g_slice_free (GstPcapParseFlow, flow);
+}
+
+static gboolean
+is_wildcard (const gchar * str)
+{
+  return str[0] == '\0' || strcmp (str, "*") == 0;
+}
+
+/* parses proto:src-ip:src-port:dst-ip:dst-port */
+static gboolean
+gst_pcap_parse_parse_filter (const gchar * str, GstPcapParseFilter * filter)
+{
+  gchar **fields;
+  gboolean ret = FALSE;
+  gint i;
+
+  fields = g_strsplit (str, ":", 5);
+  if (g_strv_length (fields) != 5)
+    goto done;
+
+  for (i = 0; i < 5; i++)
+    g_strstrip (fields[i]);
+
+  if (is_wildcard (fields[0]))
+    filter->protocol = -1;
+  else if (g_ascii_strcasecmp (fields[0], "udp") == 0)
+    filter->protocol = IP_PROTO_UDP;
+  else if (g_ascii_strcasecmp (fields[0], "tcp") == 0)
+    filter->protocol = IP_PROTO_TCP;
+  else
+    goto done;
+
+  for (i = 1; i < 5; i += 2) {
+    gint64 *ip = (i == 1) ? &filter->src_ip : &filter->dst_ip;
+    gint32 *port = (i == 1) ? &filter->src_port : &filter->dst_port;
+
+    *ip = -1;
+    if (!is_wildcard (fields[i])) {
+      set_ip_address_from_string (ip, fields[i]);
+      if (*ip < 0)
+        goto done;
+    }
+
+    *port = -1;
+    if (!is_wildcard (fields[i + 1])) {
+      gchar *end;
+      glong val = strtol (fields[i + 1], &end, 10);
+
+      if (*end != '\0' || val < 0 || val > G_MAXUINT16)
+        goto done;
+      *port = val;
+    }
+  }
+  ret = TRUE;
+
+done:
+  g_strfreev (fields);
+  return ret;
+}
+
+static void
+gst_pcap_parse_set_flows (GstPcapParse * self, const gchar * flows_str)
+{
+  GPtrArray *flows;
+  gchar **specs;
+  guint i;
+
+  flows = g_ptr_array_new ();
+  specs = g_strsplit (flows_str ? flows_str : "", ";", -1);
+  for (i = 0; specs[i] != NULL; i++) {
+    GstPcapParseFlow *flow;
+
+    g_strstrip (specs[i]);
+    if (specs[i][0] == '\0')
+      continue;
+
+    flow = g_slice_new0 (GstPcapParseFlow);
+    if (!gst_pcap_parse_parse_filter (specs[i], &flow->filter)) {
+      GST_WARNING_OBJECT (self, "ignoring invalid flow '%s'", specs[i]);
+      g_slice_free (GstPcapParseFlow, flow);
+      continue;
+    }
+    g_ptr_array_add (flows, flow);
+  }
+  g_strfreev (specs);
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < self->flows->len; i++) {
+    GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
+
+    if (flow->pad)
+      goto have_pads;
+  }
+  g_ptr_array_foreach (self->flows, (GFunc) gst_pcap_parse_free_flow, NULL);
+  g_ptr_array_free (self->flows, TRUE);
+  self->flows = flows;
+  g_free (self->flows_str);
+  self->flows_str = g_strdup (flows_str);
+  GST_OBJECT_UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "configured %u flows", flows->len);
+  return;
+
+have_pads:
+  {
+    GST_OBJECT_UNLOCK (self);
+    GST_WARNING_OBJECT (self, "can't change flows while flow pads exist");
+    g_ptr_array_foreach (flows, (GFunc) gst_pcap_parse_free_flow, NULL);
+    g_ptr_array_free (flows, TRUE);
+  }
+}
+
 static void
 gst_pcap_parse_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
@@ -244,6 +460,12 @@ gst_pcap_parse_get_property (GObject * object, guint prop_id,
       g_value_set_int64 (value, self->offset);
       break;
 
+    case PROP_FLOWS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_string (value, self->flows_str ? self->flows_str : "");
+      GST_OBJECT_UNLOCK (self);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -258,25 +480,34 @@ gst_pcap_parse_set_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case PROP_SRC_IP:
+      GST_OBJECT_LOCK (self);
       set_ip_address_from_string (&self->src_ip, g_value_get_string (value));
+      GST_OBJECT_UNLOCK (self);
       break;
 
     case PROP_DST_IP:
+      GST_OBJECT_LOCK (self);
       set_ip_address_from_string (&self->dst_ip, g_value_get_string (value));
+      GST_OBJECT_UNLOCK (self);
       break;
 
     case PROP_SRC_PORT:
+      GST_OBJECT_LOCK (self);
       self->src_port = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (self);
       break;
 
     case PROP_DST_PORT:
+      GST_OBJECT_LOCK (self);
       self->dst_port = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (self);
       break;
 
     case PROP_CAPS:
     {
       const GstCaps *new_caps_val;
       GstCaps *new_caps, *old_caps;
+      guint i;
 
       new_caps_val = gst_value_get_caps (value);
       if (new_caps_val == NULL) {
@@ -285,17 +516,31 @@ gst_pcap_parse_set_property (GObject * object, guint prop_id,
         new_caps = gst_caps_copy (new_caps_val);
       }
 
+      gst_pad_set_caps (self->src_pad, new_caps);
+
+      GST_OBJECT_LOCK (self);
       old_caps = self->caps;
       self->caps = new_caps;
       if (old_caps)
         gst_caps_unref (old_caps);
+      for (i = 0; i < self->flows->len; i++) {
+        GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
 
-      gst_pad_set_caps (self->src_pad, new_caps);
+        if (flow->pad)
+          gst_pad_set_caps (flow->pad, new_caps);
+      }
+      GST_OBJECT_UNLOCK (self);
       break;
     }
 
     case PROP_TS_OFFSET:
+      GST_OBJECT_LOCK (self);
       self->offset = g_value_get_int64 (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+
+    case PROP_FLOWS:
+      gst_pcap_parse_set_flows (self, g_value_get_string (value));
       break;
 
     default:
@@ -304,17 +549,108 @@ gst_pcap_parse_set_property (GObject * object, guint prop_id,
   }
 }
 
+static GstPad *
+gst_pcap_parse_request_new_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * name)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (element);
+  GstPcapParseFlow *flow = NULL;
+  GstPad *pad;
+  GstCaps *caps;
+  gchar *pad_name;
+  guint idx;
+
+  GST_OBJECT_LOCK (self);
+  if (name != NULL) {
+    if (sscanf (name, "src_%u", &idx) == 1 && idx < self->flows->len)
+      flow = g_ptr_array_index (self->flows, idx);
+  } else {
+    /* pick the first flow that has no pad yet */
+    for (idx = 0; idx < self->flows->len; idx++) {
+      GstPcapParseFlow *f = g_ptr_array_index (self->flows, idx);
+
+      if (f->pad == NULL) {
+        flow = f;
+        break;
+      }
+    }
+  }
+  if (flow == NULL || flow->pad != NULL)
+    goto no_flow;
+
+  pad_name = g_strdup_printf ("src_%u", idx);
+  pad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+  flow->pad = pad;
+  flow->newsegment_sent = FALSE;
+  caps = self->caps ? gst_caps_ref (self->caps) : NULL;
+  GST_OBJECT_UNLOCK (self);
+
+  gst_pad_use_fixed_caps (pad);
+  if (caps) {
+    gst_pad_set_caps (pad, caps);
+    gst_caps_unref (caps);
+  }
+  gst_pad_set_active (pad, TRUE);
+  gst_element_add_pad (element, pad);
+
+  return pad;
+
+no_flow:
+  {
+    GST_OBJECT_UNLOCK (self);
+    GST_WARNING_OBJECT (self, "no unused flow for pad %s, check the flows "
+        "property", GST_STR_NULL (name));
+    return NULL;
+  }
+}
+
+static void
+gst_pcap_parse_release_pad (GstElement * element, GstPad * pad)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (element);
+  guint i;
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < self->flows->len; i++) {
+    GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
+
+    if (flow->pad == pad) {
+      flow->pad = NULL;
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+}
+
 static void
 gst_pcap_parse_reset (GstPcapParse * self)
 {
+  guint i;
+
   self->initialized = FALSE;
   self->swap_endian = FALSE;
+  self->format = PCAP_PARSE_FORMAT_PCAP;
   self->cur_packet_size = -1;
   self->buffer_offset = 0;
   self->cur_ts = GST_CLOCK_TIME_NONE;
   self->base_ts = GST_CLOCK_TIME_NONE;
   self->newsegment_sent = FALSE;
 
+  g_array_set_size (self->interfaces, 0);
+  gst_pcap_parse_free_list (&self->list, &self->it);
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < self->flows->len; i++) {
+    GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
+
+    flow->newsegment_sent = FALSE;
+  }
+  GST_OBJECT_UNLOCK (self);
+
   gst_adapter_clear (self->adapter);
 }
 
@@ -334,19 +670,25 @@ gst_pcap_parse_read_uint32 (GstPcapParse * self, const guint8 * p)
   }
 }
 
-#define ETH_HEADER_LEN    14
-#define SLL_HEADER_LEN    16
-#define IP_HEADER_MIN_LEN 20
-#define UDP_HEADER_LEN     8
-
-#define IP_PROTO_UDP      17
-#define IP_PROTO_TCP      6
+static guint16
+gst_pcap_parse_read_uint16 (GstPcapParse * self, const guint8 * p)
+{
+  guint16 val = *((guint16 *) p);
 
+  if (self->swap_endian) {
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    return GUINT16_FROM_BE (val);
+#else
+    return GUINT16_FROM_LE (val);
+#endif
+  } else {
+    return val;
+  }
+}
 
 static gboolean
 gst_pcap_parse_scan_frame (GstPcapParse * self,
-    const guint8 * buf,
-    gint buf_size, const guint8 ** payload, gint * payload_size)
+    const guint8 * buf, gint buf_size, GstPcapParsePacket * packet)
 {
   const guint8 *buf_ip = 0;
   const guint8 *buf_proto;
@@ -354,10 +696,6 @@ gst_pcap_parse_scan_frame (GstPcapParse * self,
   guint8 b;
   guint8 ip_header_size;
   guint8 ip_protocol;
-  guint32 ip_src_addr;
-  guint32 ip_dst_addr;
-  guint16 src_port;
-  guint16 dst_port;
   guint16 len;
 
   switch (self->linktype) {
@@ -387,7 +725,7 @@ gst_pcap_parse_scan_frame (GstPcapParse * self,
     return FALSE;
 
   ip_header_size = (b & 0x0f) * 4;
-  if (buf_ip + ip_header_size > buf + buf_size)
+  if (buf_ip + ip_header_size + 4 > buf + buf_size)
     return FALSE;
 
   ip_protocol = *(buf_ip + 9);
@@ -397,22 +735,25 @@ gst_pcap_parse_scan_frame (GstPcapParse * self,
     return FALSE;
 
   /* ip info */
-  ip_src_addr = *((guint32 *) (buf_ip + 12));
-  ip_dst_addr = *((guint32 *) (buf_ip + 16));
+  packet->protocol = ip_protocol;
+  packet->src_ip = *((guint32 *) (buf_ip + 12));
+  packet->dst_ip = *((guint32 *) (buf_ip + 16));
   buf_proto = buf_ip + ip_header_size;
 
   /* ok for tcp and udp */
-  src_port = GUINT16_FROM_BE (*((guint16 *) (buf_proto + 0)));
-  dst_port = GUINT16_FROM_BE (*((guint16 *) (buf_proto + 2)));
+  packet->src_port = GUINT16_FROM_BE (*((guint16 *) (buf_proto + 0)));
+  packet->dst_port = GUINT16_FROM_BE (*((guint16 *) (buf_proto + 2)));
 
   /* extract some params and data according to protocol */
   if (ip_protocol == IP_PROTO_UDP) {
+    if (buf_proto + UDP_HEADER_LEN > buf + buf_size)
+      return FALSE;
     len = GUINT16_FROM_BE (*((guint16 *) (buf_proto + 4)));
     if (len < UDP_HEADER_LEN || buf_proto + len > buf + buf_size)
       return FALSE;
 
-    *payload = buf_proto + UDP_HEADER_LEN;
-    *payload_size = len - UDP_HEADER_LEN;
+    packet->payload_offset = buf_proto + UDP_HEADER_LEN - buf;
+    packet->payload_size = len - UDP_HEADER_LEN;
   } else {
     if (buf_proto + 12 >= buf + buf_size)
       return FALSE;
@@ -421,164 +762,580 @@ gst_pcap_parse_scan_frame (GstPcapParse * self,
       return FALSE;
 
     /* all remaining data following tcp header is payload */
-    *payload = buf_proto + len;
-    *payload_size = self->cur_packet_size - (buf_proto - buf) - len;
+    packet->payload_offset = buf_proto + len - buf;
+    packet->payload_size = buf_size - packet->payload_offset;
   }
 
-  /* but still filter as configured */
-  if (self->src_ip >= 0 && ip_src_addr != self->src_ip)
+  return TRUE;
+}
+
+static gboolean
+gst_pcap_parse_filter_matches (const GstPcapParseFilter * filter,
+    const GstPcapParsePacket * packet)
+{
+  if (filter->protocol >= 0 && packet->protocol != filter->protocol)
+    return FALSE;
+
+  if (filter->src_ip >= 0 && packet->src_ip != filter->src_ip)
     return FALSE;
 
-  if (self->dst_ip >= 0 && ip_dst_addr != self->dst_ip)
+  if (filter->dst_ip >= 0 && packet->dst_ip != filter->dst_ip)
     return FALSE;
 
-  if (self->src_port >= 0 && src_port != self->src_port)
+  if (filter->src_port >= 0 && packet->src_port != filter->src_port)
     return FALSE;
 
-  if (self->dst_port >= 0 && dst_port != self->dst_port)
+  if (filter->dst_port >= 0 && packet->dst_port != filter->dst_port)
     return FALSE;
 
   return TRUE;
 }
 
-static GstFlowReturn
-gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer)
+static void
+gst_pcap_parse_add_to_list (GstBufferList ** list, GstBufferListIterator ** it,
+    GstBuffer * buf)
 {
-  GstPcapParse *self = GST_PCAP_PARSE (GST_PAD_PARENT (pad));
-  GstFlowReturn ret = GST_FLOW_OK;
+  if (*list == NULL) {
+    *list = gst_buffer_list_new ();
+    *it = gst_buffer_list_iterate (*list);
+  }
+  gst_buffer_list_iterator_add_group (*it);
+  gst_buffer_list_iterator_add (*it, buf);
+}
 
-  gst_adapter_push (self->adapter, buffer);
+static void
+gst_pcap_parse_send_newsegment (GstPcapParse * self, GstPad * pad,
+    gboolean * newsegment_sent)
+{
+  GstEvent *newsegment;
 
-  while (ret == GST_FLOW_OK) {
-    gint avail;
-    const guint8 *data;
+  if (*newsegment_sent || !GST_CLOCK_TIME_IS_VALID (self->cur_ts))
+    return;
 
-    avail = gst_adapter_available (self->adapter);
+  newsegment = gst_event_new_new_segment (FALSE, 1, GST_FORMAT_TIME,
+      self->cur_ts, -1, 0);
+  gst_pad_push_event (pad, newsegment);
+  *newsegment_sent = TRUE;
+}
 
-    if (self->initialized) {
-      if (self->cur_packet_size >= 0) {
-        if (avail < self->cur_packet_size)
-          break;
+/* the payload of @packet as a sub-buffer of @frame, timestamped */
+static GstBuffer *
+gst_pcap_parse_create_payload (GstPcapParse * self, GstBuffer * frame,
+    guint offset, const GstPcapParsePacket * packet)
+{
+  GstBuffer *out_buf;
+
+  if (GST_CLOCK_TIME_IS_VALID (self->cur_ts)) {
+    if (!GST_CLOCK_TIME_IS_VALID (self->base_ts))
+      self->base_ts = self->cur_ts;
+    if (self->ts_offset >= 0) {
+      self->cur_ts -= self->base_ts;
+      self->cur_ts += self->ts_offset;
+    }
+  }
 
-        if (self->cur_packet_size > 0) {
-          const guint8 *payload_data;
-          gint payload_size;
+  out_buf = gst_buffer_create_sub (frame, offset + packet->payload_offset,
+      packet->payload_size);
+  gst_buffer_set_caps (out_buf, self->out_caps);
+  GST_BUFFER_TIMESTAMP (out_buf) = self->cur_ts;
+  GST_BUFFER_OFFSET (out_buf) = self->buffer_offset;
+  self->buffer_offset += packet->payload_size;
 
-          data = gst_adapter_peek (self->adapter, self->cur_packet_size);
+  return out_buf;
+}
 
-          GST_LOG_OBJECT (self, "examining packet size %" G_GINT64_FORMAT,
-              self->cur_packet_size);
+/* copies the properties and the flows that have a pad for this chain call */
+static void
+gst_pcap_parse_take_outputs (GstPcapParse * self)
+{
+  guint i;
+
+  GST_OBJECT_LOCK (self);
+  self->src_filter.protocol = -1;
+  self->src_filter.src_ip = self->src_ip;
+  self->src_filter.dst_ip = self->dst_ip;
+  self->src_filter.src_port = self->src_port;
+  self->src_filter.dst_port = self->dst_port;
+  self->ts_offset = self->offset;
+  gst_caps_replace (&self->out_caps, self->caps);
+
+  for (i = 0; i < self->flows->len; i++) {
+    GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
+    GstPcapParseOutput output = { {0,}, NULL, FALSE, NULL, NULL };
+
+    if (flow->pad == NULL)
+      continue;
+
+    output.filter = flow->filter;
+    output.pad = gst_object_ref (flow->pad);
+    output.newsegment_sent = flow->newsegment_sent;
+    g_array_append_val (self->outputs, output);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* drops what was not pushed and remembers which flows got a newsegment */
+static void
+gst_pcap_parse_release_outputs (GstPcapParse * self)
+{
+  guint i, j;
+
+  gst_pcap_parse_free_list (&self->list, &self->it);
 
-          if (gst_pcap_parse_scan_frame (self, data, self->cur_packet_size,
-                  &payload_data, &payload_size)) {
-            GstBuffer *out_buf;
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < self->outputs->len; i++) {
+    GstPcapParseOutput *output =
+        &g_array_index (self->outputs, GstPcapParseOutput, i);
 
-            ret = gst_pad_alloc_buffer_and_set_caps (self->src_pad,
-                self->buffer_offset, payload_size, self->caps, &out_buf);
+    /* the pad might have been released meanwhile */
+    for (j = 0; j < self->flows->len; j++) {
+      GstPcapParseFlow *flow = g_ptr_array_index (self->flows, j);
+
+      if (flow->pad == output->pad) {
+        flow->newsegment_sent = output->newsegment_sent;
+        break;
+      }
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
 
-            if (ret == GST_FLOW_OK) {
+  for (i = 0; i < self->outputs->len; i++) {
+    GstPcapParseOutput *output =
+        &g_array_index (self->outputs, GstPcapParseOutput, i);
 
-              if (GST_CLOCK_TIME_IS_VALID (self->cur_ts)) {
-                if (!GST_CLOCK_TIME_IS_VALID (self->base_ts))
-                  self->base_ts = self->cur_ts;
-                if (self->offset >= 0) {
-                  self->cur_ts -= self->base_ts;
-                  self->cur_ts += self->offset;
-                }
-              }
+    gst_pcap_parse_free_list (&output->list, &output->it);
+    gst_object_unref (output->pad);
+  }
+  g_array_set_size (self->outputs, 0);
+}
 
-              memcpy (GST_BUFFER_DATA (out_buf), payload_data, payload_size);
-              GST_BUFFER_TIMESTAMP (out_buf) = self->cur_ts;
+/* looks at the frame at @offset in @frame and queues its payload as a
+ * sub-buffer on every pad that wants it */
+static void
+gst_pcap_parse_handle_frame (GstPcapParse * self, GstBuffer * frame,
+    guint offset, guint size)
+{
+  GstPcapParsePacket packet;
+  GstBuffer *out_buf = NULL;
+  guint i;
+
+  GST_LOG_OBJECT (self, "examining packet size %u", size);
+
+  if (!gst_pcap_parse_scan_frame (self, GST_BUFFER_DATA (frame) + offset,
+          size, &packet))
+    return;
+
+  /* the properties filter what goes to the always src pad */
+  if (gst_pcap_parse_filter_matches (&self->src_filter, &packet)) {
+    out_buf = gst_pcap_parse_create_payload (self, frame, offset, &packet);
+
+    /* events go out right away and the lists at the end of the chain
+     * function, so the newsegment still comes before the first buffer */
+    gst_pcap_parse_send_newsegment (self, self->src_pad,
+        &self->newsegment_sent);
+    gst_pcap_parse_add_to_list (&self->list, &self->it,
+        gst_buffer_ref (out_buf));
+  }
 
-              if (!self->newsegment_sent &&
-                  GST_CLOCK_TIME_IS_VALID (self->cur_ts)) {
-                GstEvent *newsegment =
-                    gst_event_new_new_segment (FALSE, 1, GST_FORMAT_TIME,
-                    self->cur_ts, -1, 0);
-                gst_pad_push_event (self->src_pad, newsegment);
-                self->newsegment_sent = TRUE;
-              }
+  for (i = 0; i < self->outputs->len; i++) {
+    GstPcapParseOutput *output =
+        &g_array_index (self->outputs, GstPcapParseOutput, i);
 
-              ret = gst_pad_push (self->src_pad, out_buf);
+    if (!gst_pcap_parse_filter_matches (&output->filter, &packet))
+      continue;
 
-              self->buffer_offset += payload_size;
-            }
-          }
+    /* the payload is shared by all pads that want it */
+    if (out_buf == NULL)
+      out_buf = gst_pcap_parse_create_payload (self, frame, offset, &packet);
 
-          gst_adapter_flush (self->adapter, self->cur_packet_size);
-        }
+    gst_pcap_parse_send_newsegment (self, output->pad,
+        &output->newsegment_sent);
+    gst_pcap_parse_add_to_list (&output->list, &output->it,
+        gst_buffer_ref (out_buf));
+  }
 
-        self->cur_packet_size = -1;
-      } else {
-        guint32 ts_sec;
-        guint32 ts_usec;
-        guint32 incl_len;
+  if (out_buf)
+    gst_buffer_unref (out_buf);
+}
 
-        if (avail < 16)
-          break;
+/* pushes everything collected during this chain call. NOT_LINKED is only
+ * returned when none of the pads that had data is linked */
+static GstFlowReturn
+gst_pcap_parse_push_lists (GstPcapParse * self)
+{
+  GstFlowReturn ret = GST_FLOW_OK, fret;
+  gboolean pushed = FALSE, linked = FALSE;
+  guint i;
+
+  if (self->list) {
+    gst_buffer_list_iterator_free (self->it);
+    self->it = NULL;
+    fret = gst_pad_push_list (self->src_pad, self->list);
+    self->list = NULL;
+
+    pushed = TRUE;
+    if (fret != GST_FLOW_NOT_LINKED)
+      linked = TRUE;
+    if (fret != GST_FLOW_OK && fret != GST_FLOW_NOT_LINKED)
+      ret = fret;
+  }
 
-        data = gst_adapter_peek (self->adapter, 16);
+  for (i = 0; i < self->outputs->len; i++) {
+    GstPcapParseOutput *output =
+        &g_array_index (self->outputs, GstPcapParseOutput, i);
+    GstBufferList *list = output->list;
 
-        ts_sec = gst_pcap_parse_read_uint32 (self, data + 0);
-        ts_usec = gst_pcap_parse_read_uint32 (self, data + 4);
-        incl_len = gst_pcap_parse_read_uint32 (self, data + 8);
-        /* orig_len = gst_pcap_parse_read_uint32 (self, data + 12); */
+    if (list == NULL)
+      continue;
 
-        gst_adapter_flush (self->adapter, 16);
+    gst_buffer_list_iterator_free (output->it);
+    output->it = NULL;
+    output->list = NULL;
 
-        self->cur_ts = ts_sec * GST_SECOND + ts_usec * GST_USECOND;
-        self->cur_packet_size = incl_len;
-      }
-    } else {
-      guint32 magic;
-      guint32 linktype;
-      guint16 major_version;
+    fret = gst_pad_push_list (output->pad, list);
 
-      if (avail < 24)
-        break;
+    /* a pad released during this chain call is inactive by now */
+    if (fret == GST_FLOW_WRONG_STATE &&
+        GST_OBJECT_PARENT (output->pad) != GST_OBJECT_CAST (self))
+      continue;
+
+    pushed = TRUE;
+    if (fret != GST_FLOW_NOT_LINKED)
+      linked = TRUE;
+    if (fret != GST_FLOW_OK && fret != GST_FLOW_NOT_LINKED
+        && ret == GST_FLOW_OK)
+      ret = fret;
+  }
+
+  if (ret == GST_FLOW_OK && pushed && !linked)
+    ret = GST_FLOW_NOT_LINKED;
+
+  return ret;
+}
+
+static GstClockTime
+gst_pcap_parse_ng_timestamp (guint64 ts, guint8 tsresol)
+{
+  guint64 den = 1;
+  guint i;
+
+  if (tsresol & 0x80) {
+    /* negative power of two */
+    if ((tsresol & 0x7f) > 63)
+      return GST_CLOCK_TIME_NONE;
+    den = G_GUINT64_CONSTANT (1) << (tsresol & 0x7f);
+  } else {
+    /* negative power of ten */
+    if (tsresol > 19)
+      return GST_CLOCK_TIME_NONE;
+    for (i = 0; i < tsresol; i++)
+      den *= 10;
+  }
+  return gst_util_uint64_scale (ts, GST_SECOND, den);
+}
+
+static void
+gst_pcap_parse_handle_ng_idb (GstPcapParse * self, const guint8 * data,
+    guint len)
+{
+  GstPcapParseInterface iface;
+  guint pos;
+
+  iface.linktype = gst_pcap_parse_read_uint16 (self, data + 8);
+  iface.tsresol = 6;
+
+  /* options, each padded to 32 bits */
+  pos = 16;
+  while (pos + 4 <= len - 4) {
+    guint16 code = gst_pcap_parse_read_uint16 (self, data + pos);
+    guint16 opt_len = gst_pcap_parse_read_uint16 (self, data + pos + 2);
+
+    if (code == PCAPNG_OPT_ENDOFOPT || pos + 4 + opt_len > len - 4)
+      break;
+    if (code == PCAPNG_OPT_IF_TSRESOL && opt_len >= 1)
+      iface.tsresol = data[pos + 4];
+
+    pos += 4 + GST_ROUND_UP_4 (opt_len);
+  }
+
+  if (iface.linktype != DLT_ETHER && iface.linktype != DLT_SLL)
+    GST_WARNING_OBJECT (self, "interface %u has unsupported linktype %u, "
+        "ignoring its packets", self->interfaces->len, iface.linktype);
+
+  GST_DEBUG_OBJECT (self, "interface %u: linktype %u, tsresol 0x%02x",
+      self->interfaces->len, iface.linktype, iface.tsresol);
+  g_array_append_val (self->interfaces, iface);
+}
+
+/* handles one complete pcapng block */
+static GstFlowReturn
+gst_pcap_parse_handle_ng_block (GstPcapParse * self, GstBuffer * block)
+{
+  const guint8 *data = GST_BUFFER_DATA (block);
+  guint len = GST_BUFFER_SIZE (block);
+  GstPcapParseInterface *iface;
+  guint32 type, iface_id, caplen;
+  guint64 ts;
+
+  type = gst_pcap_parse_read_uint32 (self, data);
+
+  switch (type) {
+    case PCAPNG_BLOCK_SHB:
+      /* new section, interface ids start again */
+      g_array_set_size (self->interfaces, 0);
+      break;
+    case PCAPNG_BLOCK_IDB:
+      if (len < 20)
+        goto invalid_block;
+      gst_pcap_parse_handle_ng_idb (self, data, len);
+      break;
+    case PCAPNG_BLOCK_EPB:
+      if (len < 32)
+        goto invalid_block;
+      iface_id = gst_pcap_parse_read_uint32 (self, data + 8);
+      if (iface_id >= self->interfaces->len)
+        goto invalid_block;
+      iface = &g_array_index (self->interfaces, GstPcapParseInterface,
+          iface_id);
+      ts = ((guint64) gst_pcap_parse_read_uint32 (self, data + 12) << 32) |
+          gst_pcap_parse_read_uint32 (self, data + 16);
+      caplen = gst_pcap_parse_read_uint32 (self, data + 20);
+      caplen = MIN (caplen, len - 32);
+
+      self->cur_ts = gst_pcap_parse_ng_timestamp (ts, iface->tsresol);
+      self->linktype = iface->linktype;
+      gst_pcap_parse_handle_frame (self, block, 28, caplen);
+      break;
+    case PCAPNG_BLOCK_SPB:
+      if (len < 16 || self->interfaces->len == 0)
+        goto invalid_block;
+      iface = &g_array_index (self->interfaces, GstPcapParseInterface, 0);
+      caplen = gst_pcap_parse_read_uint32 (self, data + 8);
+      caplen = MIN (caplen, len - 16);
+
+      /* simple packet blocks carry no timestamp */
+      self->cur_ts = GST_CLOCK_TIME_NONE;
+      self->linktype = iface->linktype;
+      gst_pcap_parse_handle_frame (self, block, 12, caplen);
+      break;
+    default:
+      GST_LOG_OBJECT (self, "skipping block type 0x%08x", type);
+      break;
+  }
+
+  return GST_FLOW_OK;
+
+invalid_block:
+  {
+    GST_WARNING_OBJECT (self, "skipping invalid block type 0x%08x length %u",
+        type, len);
+    return GST_FLOW_OK;
+  }
+}
+
+static GstFlowReturn
+gst_pcap_parse_chain_ng (GstPcapParse * self)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
 
-      data = gst_adapter_peek (self->adapter, 24);
+  while (ret == GST_FLOW_OK) {
+    const guint8 *data;
+    guint32 type, block_len;
+    GstBuffer *block;
+    guint avail;
 
-      magic = *((guint32 *) data);
-      major_version = *((guint16 *) (data + 4));
+    avail = gst_adapter_available (self->adapter);
+    if (avail < 12)
+      break;
+
+    data = gst_adapter_peek (self->adapter, 12);
 
-      if (magic == 0xa1b2c3d4) {
+    /* the section header is palindromic, its byte order magic tells us
+     * how to read everything in the section */
+    if (*((guint32 *) data) == PCAPNG_BLOCK_SHB) {
+      guint32 bom = *((guint32 *) (data + 8));
+
+      if (bom == PCAPNG_BYTE_ORDER_MAGIC) {
         self->swap_endian = FALSE;
-      } else if (magic == 0xd4c3b2a1) {
+      } else if (bom == GUINT32_SWAP_LE_BE (PCAPNG_BYTE_ORDER_MAGIC)) {
         self->swap_endian = TRUE;
-        major_version = major_version << 8 | major_version >> 8;
       } else {
         GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("File is not a libpcap file, magic is %X", magic));
-        ret = GST_FLOW_ERROR;
-        goto out;
+            ("Invalid pcapng byte order magic %X", bom));
+        return GST_FLOW_ERROR;
       }
+    }
 
-      if (major_version != 2) {
-        GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("File is not a libpcap major version 2, but %u", major_version));
-        ret = GST_FLOW_ERROR;
-        goto out;
-      }
+    type = gst_pcap_parse_read_uint32 (self, data);
+    block_len = gst_pcap_parse_read_uint32 (self, data + 4);
+    if (block_len < 12 || (block_len & 3) != 0) {
+      GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+          ("Invalid pcapng block type 0x%08x length %u", type, block_len));
+      return GST_FLOW_ERROR;
+    }
 
-      linktype = gst_pcap_parse_read_uint32 (self, data + 20);
+    if (avail < block_len)
+      break;
 
-      if (linktype != DLT_ETHER && linktype != DLT_SLL) {
-        GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("Only dumps of type Ethernet or Linux Coooked (SLL) understood,"
-                " type %d unknown", linktype));
-        ret = GST_FLOW_ERROR;
-        goto out;
+    /* a sub-buffer of the input when the block is in one input buffer */
+    block = gst_adapter_take_buffer (self->adapter, block_len);
+    ret = gst_pcap_parse_handle_ng_block (self, block);
+    gst_buffer_unref (block);
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_pcap_parse_chain_pcap (GstPcapParse * self)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  while (ret == GST_FLOW_OK) {
+    gint avail;
+    const guint8 *data;
+
+    avail = gst_adapter_available (self->adapter);
+
+    if (self->cur_packet_size >= 0) {
+      if (avail < self->cur_packet_size)
+        break;
+
+      if (self->cur_packet_size > 0) {
+        GstBuffer *frame;
+
+        /* a sub-buffer of the input when the record is in one input
+         * buffer, the payloads are sub-buffers of that again */
+        frame = gst_adapter_take_buffer (self->adapter,
+            self->cur_packet_size);
+        gst_pcap_parse_handle_frame (self, frame, 0, self->cur_packet_size);
+        gst_buffer_unref (frame);
       }
 
-      GST_DEBUG_OBJECT (self, "linktype %u", linktype);
-      self->linktype = linktype;
+      self->cur_packet_size = -1;
+    } else {
+      guint32 ts_sec;
+      guint32 ts_frac;
+      guint32 incl_len;
+
+      if (avail < 16)
+        break;
+
+      data = gst_adapter_peek (self->adapter, 16);
 
-      gst_adapter_flush (self->adapter, 24);
-      self->initialized = TRUE;
+      ts_sec = gst_pcap_parse_read_uint32 (self, data + 0);
+      ts_frac = gst_pcap_parse_read_uint32 (self, data + 4);
+      incl_len = gst_pcap_parse_read_uint32 (self, data + 8);
+      /* orig_len = gst_pcap_parse_read_uint32 (self, data + 12); */
+
+      gst_adapter_flush (self->adapter, 16);
+
+      if (self->format == PCAP_PARSE_FORMAT_PCAP_NSEC)
+        self->cur_ts = ts_sec * GST_SECOND + ts_frac;
+      else
+        self->cur_ts = ts_sec * GST_SECOND + ts_frac * GST_USECOND;
+      self->cur_packet_size = incl_len;
     }
   }
 
+  return ret;
+}
+
+static GstFlowReturn
+gst_pcap_parse_read_header (GstPcapParse * self)
+{
+  const guint8 *data;
+  guint32 magic;
+  guint32 linktype;
+  guint16 major_version;
+
+  if (gst_adapter_available (self->adapter) < 4)
+    return GST_FLOW_OK;
+
+  data = gst_adapter_peek (self->adapter, 4);
+  if (*((guint32 *) data) == PCAPNG_BLOCK_SHB) {
+    /* the section header block is parsed like any other block */
+    GST_DEBUG_OBJECT (self, "pcapng file");
+    self->format = PCAP_PARSE_FORMAT_PCAPNG;
+    self->initialized = TRUE;
+    return GST_FLOW_OK;
+  }
+
+  if (gst_adapter_available (self->adapter) < 24)
+    return GST_FLOW_OK;
+
+  data = gst_adapter_peek (self->adapter, 24);
+
+  magic = *((guint32 *) data);
+  major_version = *((guint16 *) (data + 4));
+
+  if (magic == PCAP_MAGIC || magic == PCAP_NSEC_MAGIC) {
+    self->swap_endian = FALSE;
+  } else if (magic == PCAP_MAGIC_SWAPPED || magic == PCAP_NSEC_MAGIC_SWAPPED) {
+    self->swap_endian = TRUE;
+    major_version = major_version << 8 | major_version >> 8;
+  } else {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("File is not a libpcap file, magic is %X", magic));
+    return GST_FLOW_ERROR;
+  }
+
+  if (magic == PCAP_NSEC_MAGIC || magic == PCAP_NSEC_MAGIC_SWAPPED)
+    self->format = PCAP_PARSE_FORMAT_PCAP_NSEC;
+  else
+    self->format = PCAP_PARSE_FORMAT_PCAP;
+
+  if (major_version != 2) {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("File is not a libpcap major version 2, but %u", major_version));
+    return GST_FLOW_ERROR;
+  }
+
+  linktype = gst_pcap_parse_read_uint32 (self, data + 20);
+
+  if (linktype != DLT_ETHER && linktype != DLT_SLL) {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("Only dumps of type Ethernet or Linux Coooked (SLL) understood,"
+            " type %d unknown", linktype));
+    return GST_FLOW_ERROR;
+  }
+
+  GST_DEBUG_OBJECT (self, "linktype %u, %s timestamps", linktype,
+      self->format == PCAP_PARSE_FORMAT_PCAP_NSEC ? "nsec" : "usec");
+  self->linktype = linktype;
+
+  gst_adapter_flush (self->adapter, 24);
+  self->initialized = TRUE;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (GST_PAD_PARENT (pad));
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  gst_adapter_push (self->adapter, buffer);
+
+  if (!self->initialized) {
+    ret = gst_pcap_parse_read_header (self);
+    if (ret != GST_FLOW_OK || !self->initialized)
+      goto out;
+  }
+
+  gst_pcap_parse_take_outputs (self);
+
+  if (self->format == PCAP_PARSE_FORMAT_PCAPNG)
+    ret = gst_pcap_parse_chain_ng (self);
+  else
+    ret = gst_pcap_parse_chain_pcap (self);
+
+  if (ret == GST_FLOW_OK)
+    ret = gst_pcap_parse_push_lists (self);
+
+  gst_pcap_parse_release_outputs (self);
+
 out:
   if (ret != GST_FLOW_OK)
     gst_pcap_parse_reset (self);
@@ -591,6 +1348,8 @@ gst_pcap_sink_event (GstPad * pad, GstEvent * event)
 {
   gboolean ret = TRUE;
   GstPcapParse *self = GST_PCAP_PARSE (gst_pad_get_parent (pad));
+  GList *pads = NULL, *walk;
+  guint i;
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_NEWSEGMENT:
@@ -598,7 +1357,24 @@ gst_pcap_sink_event (GstPad * pad, GstEvent * event)
       gst_event_unref (event);
       break;
     default:
-      ret = gst_pad_push_event (self->src_pad, event);
+      /* goes to the src pad and to all requested flow pads */
+      GST_OBJECT_LOCK (self);
+      for (i = 0; i < self->flows->len; i++) {
+        GstPcapParseFlow *flow = g_ptr_array_index (self->flows, i);
+
+        if (flow->pad)
+          pads = g_list_prepend (pads, gst_object_ref (flow->pad));
+      }
+      GST_OBJECT_UNLOCK (self);
+
+      for (walk = pads; walk; walk = walk->next) {
+        gst_event_ref (event);
+        ret &= gst_pad_push_event (GST_PAD (walk->data), event);
+        gst_object_unref (walk->data);
+      }
+      g_list_free (pads);
+
+      ret &= gst_pad_push_event (self->src_pad, event);
       break;
   }
 
@@ -45,12 +45,57 @@ typedef enum
   PCAP_PARSE_STATE_PARSING,
 } GstPcapParseState;
 
+typedef enum
+{
+  PCAP_PARSE_FORMAT_PCAP,
+  PCAP_PARSE_FORMAT_PCAP_NSEC,
+  PCAP_PARSE_FORMAT_PCAPNG
+} GstPcapParseFormat;
+
 typedef enum
 {
   DLT_ETHER  = 1,
   DLT_SLL = 113
 } GstPcapParseLinktype;
 
+/* a 5-tuple to match packets against, negative values match anything */
+typedef struct
+{
+  gint protocol;
+  gint64 src_ip;
+  gint64 dst_ip;
+  gint32 src_port;
+  gint32 dst_port;
+} GstPcapParseFilter;
+
+/* one of the flows configured with the flows property. The pad is only
+ * created once the application requests it. */
+typedef struct
+{
+  GstPcapParseFilter filter;
+  GstPad *pad;
+  gboolean newsegment_sent;
+} GstPcapParseFlow;
+
+/* a flow with a pad, as copied at the start of a chain call, and the
+ * payloads collected for it during that call */
+typedef struct
+{
+  GstPcapParseFilter filter;
+  GstPad *pad;
+  gboolean newsegment_sent;
+  GstBufferList *list;
+  GstBufferListIterator *it;
+} GstPcapParseOutput;
+
+/* pcapng interface description */
+typedef struct
+{
+  GstPcapParseLinktype linktype;
+  /* timestamp resolution, decimal or binary exponent */
+  guint8 tsresol;
+} GstPcapParseInterface;
+
 /**
  * GstPcapParse:
  *
@@ -72,6 +117,7 @@ struct _GstPcapParse
   gint32 dst_port;
   GstCaps *caps;
   gint64 offset;
+  gchar *flows_str;
 
   /* state */
   GstAdapter * adapter;
@@ -81,10 +127,29 @@ struct _GstPcapParse
   GstClockTime cur_ts;
   GstClockTime base_ts;
   GstPcapParseLinktype linktype;
+  GstPcapParseFormat format;
 
   gboolean newsegment_sent;
 
   gint64 buffer_offset;
+
+  /* pcapng interfaces of the current section */
+  GArray *interfaces;
+
+  /* GstPcapParseFlow, one per configured flow */
+  GPtrArray *flows;
+
+  /* the properties and flow pads, copied at the start of each chain call
+   * so that the packets are handled without taking the object lock */
+  GstPcapParseFilter src_filter;
+  gint64 ts_offset;
+  GstCaps *out_caps;
+  /* GstPcapParseOutput, one per flow with a pad */
+  GArray *outputs;
+
+  /* payloads for the src pad collected during one chain call */
+  GstBufferList *list;
+  GstBufferListIterator *it;
 };
 
 struct _GstPcapParseClass
@@ -55,6 +55,7 @@ static gboolean gst_raw_parse_handle_seek_pull (GstRawParse * rp,
     GstEvent * event);
 
 static void gst_raw_parse_reset (GstRawParse * rp);
+static void gst_raw_parse_clear_pull_buffer (GstRawParse * rp);
 
 static GstStaticPadTemplate gst_raw_parse_sink_pad_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
@@ -184,6 +185,7 @@ gst_raw_parse_reset (GstRawParse * rp)
 
   gst_segment_init (&rp->segment, GST_FORMAT_TIME);
   gst_adapter_clear (rp->adapter);
+  gst_raw_parse_clear_pull_buffer (rp);
 }
 
 static gboolean
@@ -263,13 +265,16 @@ gst_raw_parse_push_buffer (GstRawParse * rp, GstBuffer * buffer)
   return ret;
 }
 
+/* Only the frame that is split over the previous and the current buffer goes
+ * through the adapter, all other frames are pushed as sub-buffers of the
+ * incoming buffer */
 static GstFlowReturn
 gst_raw_parse_chain (GstPad * pad, GstBuffer * buffer)
 {
   GstRawParse *rp = GST_RAW_PARSE (gst_pad_get_parent (pad));
   GstFlowReturn ret = GST_FLOW_OK;
   GstRawParseClass *rp_class = GST_RAW_PARSE_GET_CLASS (rp);
-  guint buffersize;
+  guint size, offset = 0, avail, buffersize;
 
   if (G_UNLIKELY (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DISCONT))) {
     GST_DEBUG_OBJECT (rp, "received DISCONT buffer");
@@ -280,22 +285,50 @@ gst_raw_parse_chain (GstPad * pad, GstBuffer * buffer)
   if (!gst_raw_parse_set_src_caps (rp))
     goto no_caps;
 
-  gst_adapter_push (rp->adapter, buffer);
+  size = GST_BUFFER_SIZE (buffer);
+
+  /* complete the frame started in the previous buffer */
+  avail = gst_adapter_available (rp->adapter);
+  if (avail > 0) {
+    guint needed = rp->framesize - avail;
+
+    if (size < needed) {
+      gst_adapter_push (rp->adapter, buffer);
+      goto done;
+    }
+
+    gst_adapter_push (rp->adapter, gst_buffer_create_sub (buffer, 0, needed));
+    ret = gst_raw_parse_push_buffer (rp,
+        gst_adapter_take_buffer (rp->adapter, rp->framesize));
+    offset = needed;
+  }
 
   if (rp_class->multiple_frames_per_buffer) {
-    buffersize = gst_adapter_available (rp->adapter);
+    buffersize = size - offset;
     buffersize -= buffersize % rp->framesize;
   } else {
     buffersize = rp->framesize;
   }
 
-  while (gst_adapter_available (rp->adapter) >= buffersize) {
-    buffer = gst_adapter_take_buffer (rp->adapter, buffersize);
+  while (ret == GST_FLOW_OK && buffersize > 0 && size - offset >= buffersize) {
+    GstBuffer *outbuf;
 
-    ret = gst_raw_parse_push_buffer (rp, buffer);
-    if (ret != GST_FLOW_OK)
-      break;
+    if (offset == 0 && buffersize == size)
+      outbuf = gst_buffer_make_metadata_writable (gst_buffer_ref (buffer));
+    else
+      outbuf = gst_buffer_create_sub (buffer, offset, buffersize);
+    offset += buffersize;
+
+    ret = gst_raw_parse_push_buffer (rp, outbuf);
   }
+
+  /* keep the start of the next frame */
+  if (ret == GST_FLOW_OK && offset < size)
+    gst_adapter_push (rp->adapter,
+        gst_buffer_create_sub (buffer, offset, size - offset));
+
+  gst_buffer_unref (buffer);
+
 done:
   gst_object_unref (rp);
 
@@ -305,11 +338,83 @@ done:
 no_caps:
   {
     GST_ERROR_OBJECT (rp, "could not set caps");
+    gst_buffer_unref (buffer);
     ret = GST_FLOW_NOT_NEGOTIATED;
     goto done;
   }
 }
 
+/* at least this much is pulled from upstream at once */
+#define PULL_SIZE (4 * 1024 * 1024)
+
+static void
+gst_raw_parse_clear_pull_buffer (GstRawParse * rp)
+{
+  if (rp->pull_buffer) {
+    gst_buffer_unref (rp->pull_buffer);
+    rp->pull_buffer = NULL;
+  }
+}
+
+/* Like pull_range, but upstream is asked for several frames at once and
+ * @buffer is a sub-buffer of them. The frames are pulled in the direction
+ * of playback. */
+static GstFlowReturn
+gst_raw_parse_pull_frames (GstRawParse * rp, guint64 offset, guint size,
+    GstBuffer ** buffer)
+{
+  GstFlowReturn ret;
+  guint64 start;
+  guint pull_size;
+
+  if (rp->pull_buffer && offset >= rp->pull_offset &&
+      offset + size <= rp->pull_offset + GST_BUFFER_SIZE (rp->pull_buffer))
+    goto done;
+
+  gst_raw_parse_clear_pull_buffer (rp);
+
+  /* a whole number of frames, so that a short read at the end of the file
+   * still ends on a frame boundary */
+  pull_size = MAX (size, PULL_SIZE - PULL_SIZE % size);
+
+  if (rp->segment.rate >= 0) {
+    start = offset;
+    if (rp->upstream_length != -1 && start + pull_size > rp->upstream_length)
+      pull_size = MAX (size, rp->upstream_length - start);
+  } else {
+    guint64 end = offset + size;
+
+    pull_size = MIN (pull_size, end - end % size);
+    pull_size = MAX (pull_size, size);
+    start = end - pull_size;
+  }
+
+  ret = gst_pad_pull_range (rp->sinkpad, start, pull_size, &rp->pull_buffer);
+  if (ret != GST_FLOW_OK) {
+    rp->pull_buffer = NULL;
+    return ret;
+  }
+  rp->pull_offset = start;
+
+  GST_LOG_OBJECT (rp, "pulled %u bytes at offset %" G_GUINT64_FORMAT,
+      GST_BUFFER_SIZE (rp->pull_buffer), start);
+
+  if (offset + size > start + GST_BUFFER_SIZE (rp->pull_buffer)) {
+    /* short read, hand out what there is */
+    if (offset >= start + GST_BUFFER_SIZE (rp->pull_buffer)) {
+      gst_raw_parse_clear_pull_buffer (rp);
+      return GST_FLOW_UNEXPECTED;
+    }
+    size = start + GST_BUFFER_SIZE (rp->pull_buffer) - offset;
+  }
+
+done:
+  *buffer = gst_buffer_create_sub (rp->pull_buffer, offset - rp->pull_offset,
+      size);
+
+  return GST_FLOW_OK;
+}
+
 static void
 gst_raw_parse_loop (GstElement * element)
 {
@@ -365,7 +470,7 @@ gst_raw_parse_loop (GstElement * element)
     rp->offset -= size;
   }
 
-  ret = gst_pad_pull_range (rp->sinkpad, rp->offset, size, &buffer);
+  ret = gst_raw_parse_pull_frames (rp, rp->offset, size, &buffer);
 
   if (ret != GST_FLOW_OK) {
     GST_DEBUG_OBJECT (rp, "pull_range (%" G_GINT64_FORMAT ", %u) "
@@ -475,6 +580,7 @@ gst_raw_parse_sink_activatepull (GstPad * sinkpad, gboolean active)
     result = gst_raw_parse_handle_seek_pull (rp, NULL);
   } else {
     result = gst_pad_stop_task (sinkpad);
+    gst_raw_parse_clear_pull_buffer (rp);
   }
 
   gst_object_unref (rp);
@@ -65,6 +65,11 @@ struct _GstRawParse
   gint64 upstream_length;
   gint64 offset;
 
+  /* pull mode: several frames are pulled at once and pushed as sub-buffers
+   * of this buffer, which starts at pull_offset */
+  GstBuffer *pull_buffer;
+  guint64 pull_offset;
+
   GstSegment segment;
   gboolean running;
   GstEvent *close_segment;
@@ -19,14 +19,20 @@
 /**
  * SECTION:element-gstsdidemux
  *
- * The gstsdidemux element does FIXME stuff.
+ * The sdidemux element extracts the active video from a raw 10-bit packed
+ * SDI stream (4 words in 5 bytes).  The video standard is taken from the
+ * "standard" field of the sink caps (ntsc, pal, 1080i60, 1080i50, 720p60 or
+ * 720p50, defaulting to pal); 60 stands for 60000/1001.  The video is output
+ * as 8-bit UYVY or, keeping all 10 bits, as v210 or v216.
  *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
- * gst-launch -v fakesrc ! gstsdidemux ! FIXME ! fakesink
+ * gst-launch -v filesrc location=capture.sdi !
+ *     application/x-raw-sdi,standard=1080i50 ! sdidemux !
+ *     video/x-raw-yuv,format=(fourcc)v210 ! fakesink
  * ]|
- * FIXME Describe what the pipeline does.
+ * Extracts 1080i50 video from an SDI capture as v210.
  * </refsect2>
  */
 
@@ -34,7 +40,6 @@
 #include "config.h"
 #endif
 
-#include <gst/gst.h>
 #include <gst/gst.h>
 #include <string.h>
 #include "gstsdidemux.h"
@@ -52,9 +57,11 @@ static void gst_sdi_demux_finalize (GObject * object);
 static GstStateChangeReturn
 gst_sdi_demux_change_state (GstElement * element, GstStateChange transition);
 static GstFlowReturn gst_sdi_demux_chain (GstPad * pad, GstBuffer * buffer);
+static gboolean gst_sdi_demux_sink_setcaps (GstPad * pad, GstCaps * caps);
 static gboolean gst_sdi_demux_sink_event (GstPad * pad, GstEvent * event);
 static gboolean gst_sdi_demux_src_event (GstPad * pad, GstEvent * event);
 static GstCaps *gst_sdi_demux_src_getcaps (GstPad * pad);
+static void gst_sdi_demux_reset (GstSdiDemux * sdidemux);
 
 
 enum
@@ -64,23 +71,6 @@ enum
 
 /* pad templates */
 
-#define GST_VIDEO_CAPS_NTSC(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
-  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=10/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_NTSC_WIDE(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
-  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=40/33," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_PAL(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
-  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=12/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_PAL_WIDE(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
-  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=16/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-
 static GstStaticPadTemplate gst_sdi_demux_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -92,8 +82,10 @@ static GstStaticPadTemplate gst_sdi_demux_src_template =
     GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_NTSC ("UYVY") ";"
-        GST_VIDEO_CAPS_PAL ("UYVY"))
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_NTSC (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_PAL (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_1080I (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_720P (GST_SDI_VIDEO_FORMATS))
     );
 
 /* class initialization */
@@ -127,9 +119,7 @@ gst_sdi_demux_class_init (GstSdiDemuxClass * klass)
   gobject_class->get_property = gst_sdi_demux_get_property;
   gobject_class->dispose = gst_sdi_demux_dispose;
   gobject_class->finalize = gst_sdi_demux_finalize;
-  if (0)
-    element_class->change_state =
-        GST_DEBUG_FUNCPTR (gst_sdi_demux_change_state);
+  element_class->change_state = GST_DEBUG_FUNCPTR (gst_sdi_demux_change_state);
 
 }
 
@@ -143,6 +133,8 @@ gst_sdi_demux_init (GstSdiDemux * sdidemux, GstSdiDemuxClass * sdidemux_class)
       GST_DEBUG_FUNCPTR (gst_sdi_demux_sink_event));
   gst_pad_set_chain_function (sdidemux->sinkpad,
       GST_DEBUG_FUNCPTR (gst_sdi_demux_chain));
+  gst_pad_set_setcaps_function (sdidemux->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_sdi_demux_sink_setcaps));
   gst_element_add_pad (GST_ELEMENT (sdidemux), sdidemux->sinkpad);
 
   sdidemux->srcpad =
@@ -153,7 +145,7 @@ gst_sdi_demux_init (GstSdiDemux * sdidemux, GstSdiDemuxClass * sdidemux_class)
       GST_DEBUG_FUNCPTR (gst_sdi_demux_src_getcaps));
   gst_element_add_pad (GST_ELEMENT (sdidemux), sdidemux->srcpad);
 
-
+  sdidemux->format = gst_sdi_format_from_name ("pal");
 }
 
 void
@@ -188,6 +180,7 @@ gst_sdi_demux_dispose (GObject * object)
   g_return_if_fail (GST_IS_SDI_DEMUX (object));
 
   /* clean up as possible.  may be called multiple times */
+  gst_sdi_demux_reset (GST_SDI_DEMUX (object));
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -206,30 +199,161 @@ gst_sdi_demux_finalize (GObject * object)
 static GstStateChangeReturn
 gst_sdi_demux_change_state (GstElement * element, GstStateChange transition)
 {
+  GstSdiDemux *sdidemux = GST_SDI_DEMUX (element);
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_sdi_demux_reset (sdidemux);
+      break;
+    default:
+      break;
+  }
 
-  return GST_STATE_CHANGE_SUCCESS;
+  return ret;
 }
 
 static GstCaps *
 gst_sdi_demux_src_getcaps (GstPad * pad)
 {
-  return gst_caps_from_string (GST_VIDEO_CAPS_NTSC ("UYVY"));
+  GstSdiDemux *sdidemux = GST_SDI_DEMUX (gst_pad_get_parent (pad));
+  GstCaps *caps;
+
+  GST_OBJECT_LOCK (sdidemux);
+  caps = gst_sdi_format_get_video_caps (sdidemux->format, 0);
+  GST_OBJECT_UNLOCK (sdidemux);
+
+  gst_object_unref (sdidemux);
+  return caps;
 }
 
-static void
+static gboolean
+gst_sdi_demux_sink_setcaps (GstPad * pad, GstCaps * caps)
+{
+  GstSdiDemux *sdidemux = GST_SDI_DEMUX (gst_pad_get_parent (pad));
+  GstStructure *structure = gst_caps_get_structure (caps, 0);
+  const GstSdiFormat *format;
+  const gchar *standard;
+
+  standard = gst_structure_get_string (structure, "standard");
+  format = gst_sdi_format_from_name (standard ? standard : "pal");
+  if (format == NULL)
+    goto unknown_standard;
+
+  if (format != sdidemux->format) {
+    GST_DEBUG_OBJECT (sdidemux, "switching to %s", format->name);
+    gst_sdi_demux_reset (sdidemux);
+    GST_OBJECT_LOCK (sdidemux);
+    sdidemux->format = format;
+    GST_OBJECT_UNLOCK (sdidemux);
+  }
+
+  gst_object_unref (sdidemux);
+  return TRUE;
+
+unknown_standard:
+  {
+    GST_ERROR_OBJECT (sdidemux, "unknown standard %s", standard);
+    gst_object_unref (sdidemux);
+    return FALSE;
+  }
+}
+
+/* picks the output format downstream prefers */
+static gboolean
+gst_sdi_demux_negotiate (GstSdiDemux * sdidemux)
+{
+  GstCaps *caps;
+  guint32 fourcc = GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y');
+
+  caps = gst_pad_get_allowed_caps (sdidemux->srcpad);
+  if (caps) {
+    if (gst_caps_is_empty (caps)) {
+      gst_caps_unref (caps);
+      return FALSE;
+    }
+    gst_structure_get_fourcc (gst_caps_get_structure (caps, 0), "format",
+        &fourcc);
+    gst_caps_unref (caps);
+  }
+
+  caps = gst_sdi_format_get_video_caps (sdidemux->format, fourcc);
+  if (!gst_pad_set_caps (sdidemux->srcpad, caps)) {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (sdidemux, "output caps %" GST_PTR_FORMAT, caps);
+
+  gst_caps_replace (&sdidemux->src_caps, caps);
+  gst_caps_unref (caps);
+  sdidemux->stride = gst_sdi_format_get_stride (sdidemux->format, fourcc);
+  sdidemux->unpack = gst_sdi_get_unpack_func (fourcc);
+
+  return TRUE;
+}
+
+static GstFlowReturn
 gst_sdi_demux_get_output_buffer (GstSdiDemux * sdidemux)
 {
-  sdidemux->output_buffer =
-      gst_buffer_new_and_alloc (720 * sdidemux->format->active_lines * 2);
-  gst_buffer_set_caps (sdidemux->output_buffer,
-      gst_caps_from_string (GST_VIDEO_CAPS_PAL ("UYVY")));
+  const GstSdiFormat *format = sdidemux->format;
+  GstFlowReturn ret;
+  guint size;
+
+  if (sdidemux->src_caps == NULL && !gst_sdi_demux_negotiate (sdidemux))
+    return GST_FLOW_NOT_NEGOTIATED;
+
+  size = sdidemux->stride * format->active_lines;
+
+  /* lets downstream hand out buffers from its pool instead of allocating
+   * a new frame every time */
+  ret = gst_pad_alloc_buffer_and_set_caps (sdidemux->srcpad,
+      GST_BUFFER_OFFSET_NONE, size, sdidemux->src_caps,
+      &sdidemux->output_buffer);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  if (GST_BUFFER_SIZE (sdidemux->output_buffer) < size ||
+      !gst_caps_is_equal (GST_BUFFER_CAPS (sdidemux->output_buffer),
+          sdidemux->src_caps)) {
+    gst_buffer_unref (sdidemux->output_buffer);
+    sdidemux->output_buffer = gst_buffer_new_and_alloc (size);
+    gst_buffer_set_caps (sdidemux->output_buffer, sdidemux->src_caps);
+  }
+
   GST_BUFFER_TIMESTAMP (sdidemux->output_buffer) =
-      GST_SECOND * sdidemux->frame_number;
+      gst_util_uint64_scale (sdidemux->frame_number,
+      GST_SECOND * format->fps_d, format->fps_n);
+  GST_BUFFER_DURATION (sdidemux->output_buffer) =
+      gst_util_uint64_scale (sdidemux->frame_number + 1,
+      GST_SECOND * format->fps_d, format->fps_n) -
+      GST_BUFFER_TIMESTAMP (sdidemux->output_buffer);
+  GST_BUFFER_OFFSET (sdidemux->output_buffer) = sdidemux->frame_number;
   sdidemux->frame_number++;
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_sdi_demux_reset (GstSdiDemux * sdidemux)
+{
+  if (sdidemux->output_buffer) {
+    gst_buffer_unref (sdidemux->output_buffer);
+    sdidemux->output_buffer = NULL;
+  }
+  gst_caps_replace (&sdidemux->src_caps, NULL);
+  sdidemux->have_hsync = FALSE;
+  sdidemux->have_vsync = FALSE;
+  sdidemux->line = 0;
+  sdidemux->offset = 0;
+  sdidemux->last_sync = 0;
+  sdidemux->frame_number = 0;
 }
 
 static guint32
-get_word10 (guint8 * ptr)
+get_word10 (const guint8 * ptr)
 {
   guint32 a;
 
@@ -241,74 +365,140 @@ get_word10 (guint8 * ptr)
   return a;
 }
 
-static void
-line10_copy (guint8 * dest, guint8 * src, int n)
+/* returns the SAV in front of the active samples of @line the way
+ * get_word10 () returns it for SD, or 0 */
+static guint32
+gst_sdi_demux_get_sav (GstSdiDemux * sdidemux, const guint8 * line)
 {
-  int i;
-  guint32 a;
-  for (i = 0; i < n; i++) {
-    a = get_word10 (src);
-    GST_WRITE_UINT32_BE (dest, a);
-    src += 5;
-    dest += 4;
+  const GstSdiFormat *format = sdidemux->format;
+  guint16 w[4];
+
+  if (!format->hd)
+    return get_word10 (line + ((format->width - format->active_width -
+                2) / 2) * 5);
+
+  /* 3ff 3ff 000 000 000 000 xyz xyz, chroma and luma interleaved */
+  gst_sdi_read_words (w,
+      line + ((format->width - format->active_width - 4) / 2) * 5);
+  if (w[0] != 0x3ff || w[1] != 0x3ff || w[2] != 0 || w[3] != 0)
+    return 0;
+  gst_sdi_read_words (w,
+      line + ((format->width - format->active_width - 2) / 2) * 5);
+  if (w[0] != 0 || w[1] != 0)
+    return 0;
+
+  return 0xff000000 | (w[2] >> 2);
+}
+
+/* returns the offset of the first EAV in @data, or -1 */
+static int
+gst_sdi_demux_find_eav (GstSdiDemux * sdidemux, const guint8 * data, int size)
+{
+  int offset;
+
+  if (!sdidemux->format->hd) {
+    for (offset = 0; offset + 5 <= size; offset += 5) {
+      guint32 sync = get_word10 (data + offset);
+
+      if (SDI_IS_SYNC (sync) && SDI_SYNC_H (sync))
+        return offset;
+    }
+  } else {
+    for (offset = 0; offset + 10 <= size; offset += 5) {
+      guint16 w[4];
+      guint32 sync;
+
+      gst_sdi_read_words (w, data + offset);
+      if (w[0] != 0x3ff || w[1] != 0x3ff || w[2] != 0 || w[3] != 0)
+        continue;
+      gst_sdi_read_words (w, data + offset + 5);
+      sync = 0xff000000 | (w[2] >> 2);
+      if (w[0] == 0 && w[1] == 0 && w[2] == w[3] && SDI_IS_SYNC (sync) &&
+          SDI_SYNC_H (sync))
+        return offset;
+    }
   }
 
+  return -1;
 }
 
-
 static GstFlowReturn
 copy_line (GstSdiDemux * sdidemux, guint8 * line)
 {
-  guint8 *output_data;
   GstFlowReturn ret = GST_FLOW_OK;
-  GstSdiFormat *format = sdidemux->format;
+  const GstSdiFormat *format = sdidemux->format;
+  int field_lines;
+  int row = -1;
 
-  output_data = GST_BUFFER_DATA (sdidemux->output_buffer);
+  field_lines = format->interlaced ? format->active_lines / 2 :
+      format->active_lines;
 
   /* line is one less than the video line */
   if (sdidemux->line >= format->start0 - 1 &&
-      sdidemux->line < format->start0 - 1 + format->active_lines / 2) {
-#if 0
-    memcpy (output_data + 720 * 2 * ((sdidemux->line -
-                (format->start0 - 1)) * 2 + (!format->tff)),
-        line + (format->width - 720) * 2, 720 * 2);
-#else
-    line10_copy (output_data + 720 * 2 * ((sdidemux->line -
-                (format->start0 - 1)) * 2 + (!format->tff)),
-        line + (format->width - 720) / 2 * 5, 720 / 2);
-#endif
+      sdidemux->line < format->start0 - 1 + field_lines) {
+    row = sdidemux->line - (format->start0 - 1);
+    if (format->interlaced)
+      row = row * 2 + (!format->tff);
+  } else if (format->interlaced && sdidemux->line >= format->start1 - 1 &&
+      sdidemux->line < format->start1 - 1 + field_lines) {
+    row = (sdidemux->line - (format->start1 - 1)) * 2 + (format->tff);
   }
-  if (sdidemux->line >= format->start1 - 1 &&
-      sdidemux->line < format->start1 - 1 + format->active_lines / 2) {
-#if 0
-    memcpy (output_data + 720 * 2 * ((sdidemux->line -
-                (format->start1 - 1)) * 2 + (format->tff)),
-        line + (format->width - 720) * 2, 720 * 2);
-#else
-    line10_copy (output_data + 720 * 2 * ((sdidemux->line -
-                (format->start1 - 1)) * 2 + (format->tff)),
-        line + (format->width - 720) / 2 * 5, 720 / 2);
-#endif
+
+  if (row >= 0) {
+    if (sdidemux->output_buffer == NULL)
+      ret = gst_sdi_demux_get_output_buffer (sdidemux);
+    if (ret == GST_FLOW_OK)
+      sdidemux->unpack (GST_BUFFER_DATA (sdidemux->output_buffer) +
+          row * sdidemux->stride,
+          line + (format->width - format->active_width) / 2 * 5,
+          format->active_width / 2);
   }
 
   sdidemux->offset = 0;
   sdidemux->line++;
   if (sdidemux->line == format->lines) {
-    ret = gst_pad_push (sdidemux->srcpad, sdidemux->output_buffer);
-    gst_sdi_demux_get_output_buffer (sdidemux);
+    if (sdidemux->output_buffer) {
+      ret = gst_pad_push (sdidemux->srcpad, sdidemux->output_buffer);
+      sdidemux->output_buffer = NULL;
+    }
     sdidemux->line = 0;
   }
 
   return ret;
 }
 
-#define SDI_IS_SYNC(a) (((a)&0xffffff80) == 0xff000080)
-#define SDI_SYNC_F(a) (((a)>>6)&1)
-#define SDI_SYNC_V(a) (((a)>>5)&1)
-#define SDI_SYNC_H(a) (((a)>>4)&1)
+static GstFlowReturn
+gst_sdi_demux_handle_line (GstSdiDemux * sdidemux, guint8 * line)
+{
+  const GstSdiFormat *format = sdidemux->format;
+  GstFlowReturn ret;
+  guint32 sync;
+
+  sync = gst_sdi_demux_get_sav (sdidemux, line);
 
-GstSdiFormat sd_ntsc = { 525, 480, 858, 20, 283, 0 };
-GstSdiFormat sd_pal = { 625, 576, 864, 23, 336, 1 };
+  if (!sdidemux->have_vsync) {
+    sdidemux->line = 0;
+    if (format->interlaced) {
+      /* first line of field 1 */
+      if (SDI_IS_SYNC (sync) && !SDI_SYNC_F (sync) &&
+          SDI_SYNC_F (sdidemux->last_sync))
+        sdidemux->have_vsync = TRUE;
+    } else {
+      /* first active line */
+      if (SDI_IS_SYNC (sync) && !SDI_SYNC_V (sync) &&
+          SDI_SYNC_V (sdidemux->last_sync)) {
+        sdidemux->have_vsync = TRUE;
+        sdidemux->line = format->start0 - 1;
+      }
+    }
+  }
+
+  ret = copy_line (sdidemux, line);
+
+  sdidemux->last_sync = sync;
+
+  return ret;
+}
 
 static GstFlowReturn
 gst_sdi_demux_chain (GstPad * pad, GstBuffer * buffer)
@@ -318,162 +508,58 @@ gst_sdi_demux_chain (GstPad * pad, GstBuffer * buffer)
   guint8 *data = GST_BUFFER_DATA (buffer);
   int size = GST_BUFFER_SIZE (buffer);
   GstFlowReturn ret = GST_FLOW_OK;
-  GstSdiFormat *format;
+  int line_size;
 
   sdidemux = GST_SDI_DEMUX (gst_pad_get_parent (pad));
-  sdidemux->format = &sd_pal;
-  format = sdidemux->format;
+  line_size = GST_SDI_FORMAT_LINE_SIZE (sdidemux->format);
 
   GST_DEBUG_OBJECT (sdidemux, "chain");
 
   if (GST_BUFFER_IS_DISCONT (buffer)) {
+    if (sdidemux->output_buffer) {
+      gst_buffer_unref (sdidemux->output_buffer);
+      sdidemux->output_buffer = NULL;
+    }
     sdidemux->have_hsync = FALSE;
     sdidemux->have_vsync = FALSE;
+    sdidemux->offset = 0;
   }
 
   if (!sdidemux->have_hsync) {
-#if 0
-    for (offset = 0; offset < size; offset += 4) {
-      guint32 sync = READ_UINT32_BE (data + offset);
-      GST_ERROR ("sync value %08x", sync);
-      if (SDI_IS_SYNC (sync) && SDI_SYNC_H (sync)) {
-        sdidemux->have_hsync = TRUE;
-        sdidemux->line = 0;
-        sdidemux->offset = 0;
-        break;
-      }
-    }
-#else
-    for (offset = 0; offset < size; offset += 5) {
-      guint32 sync = get_word10 (data + offset);
-      //GST_ERROR("sync value %08x", sync);
-      if (SDI_IS_SYNC (sync) && SDI_SYNC_H (sync)) {
-        sdidemux->have_hsync = TRUE;
-        sdidemux->line = 0;
-        sdidemux->offset = 0;
-        break;
-      }
-    }
-#endif
-    if (!sdidemux->have_hsync) {
-      GST_ERROR ("no sync");
+    offset = gst_sdi_demux_find_eav (sdidemux, data, size);
+    if (offset < 0) {
+      GST_DEBUG_OBJECT (sdidemux, "no sync");
       goto out;
     }
+    sdidemux->have_hsync = TRUE;
+    sdidemux->line = 0;
+    sdidemux->offset = 0;
   }
 
-  if (sdidemux->output_buffer == NULL) {
-    gst_sdi_demux_get_output_buffer (sdidemux);
-  }
-#if 0
-  if (sdidemux->offset) {
-    int n;
-
-    /* second half of a line */
-    n = MIN (size - offset, format->width * 2 - sdidemux->offset);
-
-    memcpy (sdidemux->stored_line + sdidemux->offset, data + offset, n);
-
-    offset += n;
-    sdidemux->offset += n;
-
-    if (sdidemux->offset == format->width * 2) {
-      guint32 sync =
-          GST_READ_UINT32_BE (data + offset + (format->width - 720 - 2) * 2);
-
-      //GST_ERROR("%08x", sync);
-      if (!sdidemux->have_vsync) {
-        //GST_ERROR("%08x", GST_READ_UINT32_BE(data+offset));
-        if (SDI_IS_SYNC (sync) && !SDI_SYNC_F (sync) &&
-            SDI_SYNC_F (sdidemux->last_sync)) {
-          sdidemux->have_vsync = TRUE;
-        }
-        sdidemux->line = 0;
-      }
-
-      ret = copy_line (sdidemux, sdidemux->stored_line);
-
-      sdidemux->last_sync = sync;
-    }
-  }
-
-  while (size - offset >= format->width * 2) {
-    guint32 sync =
-        GST_READ_UINT32_BE (data + offset + (format->width - 720 - 2) * 2);
-
-    //GST_ERROR("%08x", sync);
-    if (!sdidemux->have_vsync) {
-      if (SDI_IS_SYNC (sync) && !SDI_SYNC_F (sync) &&
-          SDI_SYNC_F (sdidemux->last_sync)) {
-        sdidemux->have_vsync = TRUE;
-      }
-      sdidemux->line = 0;
-    }
-
-    ret = copy_line (sdidemux, data + offset);
-    offset += format->width * 2;
-
-    sdidemux->last_sync = sync;
-  }
-
-  if (size - offset > 0) {
-    memcpy (sdidemux->stored_line, data + offset, size - offset);
-    sdidemux->offset = size - offset;
-  }
-#else
   if (sdidemux->offset) {
     int n;
 
     /* second half of a line */
-    n = MIN (size - offset, format->width / 2 * 5 - sdidemux->offset);
+    n = MIN (size - offset, line_size - sdidemux->offset);
 
     memcpy (sdidemux->stored_line + sdidemux->offset, data + offset, n);
 
     offset += n;
     sdidemux->offset += n;
 
-    if (sdidemux->offset == (format->width / 2) * 5) {
-      guint32 sync =
-          get_word10 (data + offset + ((format->width - 720 - 2) / 2) * 5);
-
-      if (!sdidemux->have_vsync) {
-        //GST_ERROR("%08x", GST_READ_UINT32_BE(data+offset));
-        if (SDI_IS_SYNC (sync) && !SDI_SYNC_F (sync) &&
-            SDI_SYNC_F (sdidemux->last_sync)) {
-          sdidemux->have_vsync = TRUE;
-        }
-        sdidemux->line = 0;
-      }
-
-      ret = copy_line (sdidemux, sdidemux->stored_line);
-
-      sdidemux->last_sync = sync;
-    }
+    if (sdidemux->offset == line_size)
+      ret = gst_sdi_demux_handle_line (sdidemux, sdidemux->stored_line);
   }
 
-  while (size - offset >= format->width / 2 * 5) {
-    guint32 sync =
-        get_word10 (data + offset + ((format->width - 720 - 2) / 2) * 5);
-
-    //GST_ERROR("%08x", sync);
-    if (!sdidemux->have_vsync) {
-      if (SDI_IS_SYNC (sync) && !SDI_SYNC_F (sync) &&
-          SDI_SYNC_F (sdidemux->last_sync)) {
-        sdidemux->have_vsync = TRUE;
-      }
-      sdidemux->line = 0;
-    }
-
-    ret = copy_line (sdidemux, data + offset);
-    offset += (format->width / 2) * 5;
-
-    sdidemux->last_sync = sync;
+  while (ret == GST_FLOW_OK && size - offset >= line_size) {
+    ret = gst_sdi_demux_handle_line (sdidemux, data + offset);
+    offset += line_size;
   }
 
-  if (size - offset > 0) {
+  if (ret == GST_FLOW_OK && size - offset > 0) {
     memcpy (sdidemux->stored_line, data + offset, size - offset);
     sdidemux->offset = size - offset;
   }
-#endif
 
 out:
   gst_buffer_unref (buffer);
@@ -496,12 +582,24 @@ gst_sdi_demux_sink_event (GstPad * pad, GstEvent * event)
       res = gst_pad_push_event (sdidemux->srcpad, event);
       break;
     case GST_EVENT_FLUSH_STOP:
+      if (sdidemux->output_buffer) {
+        gst_buffer_unref (sdidemux->output_buffer);
+        sdidemux->output_buffer = NULL;
+      }
+      sdidemux->have_hsync = FALSE;
+      sdidemux->have_vsync = FALSE;
+      sdidemux->offset = 0;
       res = gst_pad_push_event (sdidemux->srcpad, event);
       break;
     case GST_EVENT_NEWSEGMENT:
       res = gst_pad_push_event (sdidemux->srcpad, event);
       break;
     case GST_EVENT_EOS:
+      /* drop the incomplete frame */
+      if (sdidemux->output_buffer) {
+        gst_buffer_unref (sdidemux->output_buffer);
+        sdidemux->output_buffer = NULL;
+      }
       res = gst_pad_push_event (sdidemux->srcpad, event);
       break;
     default:
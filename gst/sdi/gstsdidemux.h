@@ -21,7 +21,7 @@
 #define _GST_SDI_DEMUX_H_
 
 #include <gst/gst.h>
-#include <gst/gst.h>
+#include "gstsdiformat.h"
 
 G_BEGIN_DECLS
 
@@ -33,7 +33,6 @@ G_BEGIN_DECLS
 
 typedef struct _GstSdiDemux GstSdiDemux;
 typedef struct _GstSdiDemuxClass GstSdiDemuxClass;
-typedef struct _GstSdiFormat GstSdiFormat;
 
 struct _GstSdiDemux
 {
@@ -47,21 +46,16 @@ struct _GstSdiDemux
 
   gboolean have_hsync;
   gboolean have_vsync;
-  guchar stored_line[2160]; /* 864/2*5 */
+  guchar stored_line[GST_SDI_FORMAT_MAX_LINE_SIZE];
 
   int frame_number;
   guint32 last_sync;
-  GstSdiFormat *format;
-};
+  const GstSdiFormat *format;
 
-struct _GstSdiFormat
-{
-  int lines;
-  int active_lines;
-  int width;
-  int start0;
-  int start1;
-  int tff;
+  /* negotiated output */
+  GstCaps *src_caps;
+  int stride;
+  GstSdiLineFunc unpack;
 };
 
 struct _GstSdiDemuxClass
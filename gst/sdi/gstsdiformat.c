@@ -0,0 +1,335 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include "gstsdiformat.h"
+
+static const GstSdiFormat formats[] = {
+  {"ntsc", 525, 480, 858, 720, 20, 283, 263, 0, TRUE, FALSE,
+      30000, 1001, 10, 11, 270},
+  {"pal", 625, 576, 864, 720, 23, 336, 313, 1, TRUE, FALSE,
+      25, 1, 12, 11, 270},
+  /* SMPTE 274M */
+  {"1080i60", 1125, 1080, 2200, 1920, 21, 584, 564, 1, TRUE, TRUE,
+      30000, 1001, 1, 1, 1485},
+  {"1080i50", 1125, 1080, 2640, 1920, 21, 584, 564, 1, TRUE, TRUE,
+      25, 1, 1, 1, 1485},
+  /* SMPTE 296M */
+  {"720p60", 750, 720, 1650, 1280, 26, 0, 0, 0, FALSE, TRUE,
+      60000, 1001, 1, 1, 1485},
+  {"720p50", 750, 720, 1980, 1280, 26, 0, 0, 0, FALSE, TRUE,
+      50, 1, 1, 1, 1485}
+};
+
+const GstSdiFormat *
+gst_sdi_format_from_name (const gchar * name)
+{
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    if (strcmp (formats[i].name, name) == 0)
+      return &formats[i];
+  }
+  return NULL;
+}
+
+const GstSdiFormat *
+gst_sdi_format_from_video (int width, int height, int fps_n, int fps_d)
+{
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    if (formats[i].active_width == width &&
+        formats[i].active_lines == height &&
+        (gint64) formats[i].fps_n * fps_d == (gint64) fps_n * formats[i].fps_d)
+      return &formats[i];
+  }
+  return NULL;
+}
+
+/* a fourcc of 0 gives caps for all the supported output formats */
+GstCaps *
+gst_sdi_format_get_video_caps (const GstSdiFormat * format, guint32 fourcc)
+{
+  GstCaps *caps;
+
+  if (fourcc == 0) {
+    caps = gst_sdi_format_get_video_caps (format,
+        GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'));
+    gst_caps_append (caps, gst_sdi_format_get_video_caps (format,
+            GST_MAKE_FOURCC ('v', '2', '1', '0')));
+    gst_caps_append (caps, gst_sdi_format_get_video_caps (format,
+            GST_MAKE_FOURCC ('v', '2', '1', '6')));
+    return caps;
+  }
+
+  caps = gst_caps_new_simple ("video/x-raw-yuv",
+      "format", GST_TYPE_FOURCC, fourcc,
+      "width", G_TYPE_INT, format->active_width,
+      "height", G_TYPE_INT, format->active_lines,
+      "framerate", GST_TYPE_FRACTION, format->fps_n, format->fps_d,
+      "interlaced", G_TYPE_BOOLEAN, format->interlaced,
+      "pixel-aspect-ratio", GST_TYPE_FRACTION, format->par_n, format->par_d,
+      "color-matrix", G_TYPE_STRING, format->hd ? "hdtv" : "sdtv", NULL);
+  if (!format->hd)
+    gst_caps_set_simple (caps, "chroma-site", G_TYPE_STRING, "mpeg2", NULL);
+
+  return caps;
+}
+
+GstCaps *
+gst_sdi_format_get_sdi_caps (const GstSdiFormat * format)
+{
+  return gst_caps_new_simple ("application/x-raw-sdi",
+      "rate", G_TYPE_INT, format->rate,
+      "standard", G_TYPE_STRING, format->name, NULL);
+}
+
+int
+gst_sdi_format_get_stride (const GstSdiFormat * format, guint32 fourcc)
+{
+  switch (fourcc) {
+    case GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'):
+      return format->active_width * 2;
+    case GST_MAKE_FOURCC ('v', '2', '1', '0'):
+      /* 6 pixels in 16 bytes, lines padded to 128 bytes */
+      return ((format->active_width + 47) / 48) * 128;
+    case GST_MAKE_FOURCC ('v', '2', '1', '6'):
+      return format->active_width * 4;
+    default:
+      g_assert_not_reached ();
+      return 0;
+  }
+}
+
+/* The 10-bit words are packed LSB first, 4 words in 5 bytes.  Orc has no
+ * 5 byte element size, so these work on whole 40-bit groups with shifts and
+ * masks only, which compilers turn into straight-line (and often vectorized)
+ * code instead of the per-word bit fiddling of get_word10 (). */
+#define READ_GROUP(p) \
+  ((guint64) (p)[0] | ((guint64) (p)[1] << 8) | ((guint64) (p)[2] << 16) | \
+   ((guint64) (p)[3] << 24) | ((guint64) (p)[4] << 32))
+
+#define WRITE_GROUP(p,v) G_STMT_START {                                 \
+  guint64 _v = (v);                                                     \
+  (p)[0] = _v; (p)[1] = _v >> 8; (p)[2] = _v >> 16; (p)[3] = _v >> 24;  \
+  (p)[4] = _v >> 32;                                                    \
+} G_STMT_END
+
+#define MAKE_GROUP(w0,w1,w2,w3) \
+  ((guint64) (w0) | ((guint64) (w1) << 10) | ((guint64) (w2) << 20) | \
+   ((guint64) (w3) << 30))
+
+/* keep video data out of the 000-003 and 3fc-3ff timing reference range */
+#define CLAMP10(w) CLAMP ((w), 0x004, 0x3fb)
+
+static void
+unpack_uyvy (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    guint64 v = READ_GROUP (src + i * 5);
+
+    dest[i * 4 + 0] = v >> 2;
+    dest[i * 4 + 1] = v >> 12;
+    dest[i * 4 + 2] = v >> 22;
+    dest[i * 4 + 3] = v >> 32;
+  }
+}
+
+static void
+unpack_v216 (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    guint64 v = READ_GROUP (src + i * 5);
+
+    GST_WRITE_UINT16_LE (dest + i * 8 + 0, (v & 0x3ff) << 6);
+    GST_WRITE_UINT16_LE (dest + i * 8 + 2, ((v >> 10) & 0x3ff) << 6);
+    GST_WRITE_UINT16_LE (dest + i * 8 + 4, ((v >> 20) & 0x3ff) << 6);
+    GST_WRITE_UINT16_LE (dest + i * 8 + 6, ((v >> 30) & 0x3ff) << 6);
+  }
+}
+
+/* 3 groups (12 words) make one v210 block of 4 32-bit words; the 3 words
+ * of a v210 word are contiguous in the SDI bit stream too */
+static inline void
+unpack_v210_block (guint8 * dest, const guint8 * src)
+{
+  guint64 a = READ_GROUP (src);
+  guint64 b = READ_GROUP (src + 5);
+  guint64 c = READ_GROUP (src + 10);
+
+  GST_WRITE_UINT32_LE (dest + 0, a & 0x3fffffff);
+  GST_WRITE_UINT32_LE (dest + 4, ((a >> 30) & 0x3ff) | ((b & 0xfffff) << 10));
+  GST_WRITE_UINT32_LE (dest + 8, ((b >> 20) & 0xfffff) | ((c & 0x3ff) << 20));
+  GST_WRITE_UINT32_LE (dest + 12, (c >> 10) & 0x3fffffff);
+}
+
+static void
+unpack_v210 (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i + 3 <= n; i += 3) {
+    unpack_v210_block (dest, src);
+    src += 15;
+    dest += 16;
+  }
+  if (i < n) {
+    /* incomplete last block (1280 pixel lines), pad with zero words */
+    guint8 tmp[15] = { 0 };
+
+    memcpy (tmp, src, (n - i) * 5);
+    unpack_v210_block (dest, tmp);
+  }
+}
+
+static void
+pack_uyvy (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    const guint8 *s = src + i * 4;
+
+    WRITE_GROUP (dest + i * 5, MAKE_GROUP (CLAMP10 (s[0] << 2),
+            CLAMP10 (s[1] << 2), CLAMP10 (s[2] << 2), CLAMP10 (s[3] << 2)));
+  }
+}
+
+static void
+pack_v216 (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    const guint8 *s = src + i * 8;
+
+    WRITE_GROUP (dest + i * 5,
+        MAKE_GROUP (CLAMP10 (GST_READ_UINT16_LE (s) >> 6),
+            CLAMP10 (GST_READ_UINT16_LE (s + 2) >> 6),
+            CLAMP10 (GST_READ_UINT16_LE (s + 4) >> 6),
+            CLAMP10 (GST_READ_UINT16_LE (s + 6) >> 6)));
+  }
+}
+
+static inline void
+pack_v210_block (guint8 * dest, const guint8 * src, int n)
+{
+  guint16 w[12];
+  int i;
+
+  for (i = 0; i < 4; i++) {
+    guint32 v = GST_READ_UINT32_LE (src + i * 4);
+
+    w[i * 3 + 0] = CLAMP10 (v & 0x3ff);
+    w[i * 3 + 1] = CLAMP10 ((v >> 10) & 0x3ff);
+    w[i * 3 + 2] = CLAMP10 ((v >> 20) & 0x3ff);
+  }
+  for (i = 0; i < n; i++)
+    WRITE_GROUP (dest + i * 5, MAKE_GROUP (w[i * 4], w[i * 4 + 1],
+            w[i * 4 + 2], w[i * 4 + 3]));
+}
+
+static void
+pack_v210 (guint8 * dest, const guint8 * src, int n)
+{
+  int i;
+
+  for (i = 0; i + 3 <= n; i += 3) {
+    pack_v210_block (dest, src, 3);
+    src += 16;
+    dest += 15;
+  }
+  if (i < n)
+    pack_v210_block (dest, src, n - i);
+}
+
+GstSdiLineFunc
+gst_sdi_get_unpack_func (guint32 fourcc)
+{
+  switch (fourcc) {
+    case GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'):
+      return unpack_uyvy;
+    case GST_MAKE_FOURCC ('v', '2', '1', '0'):
+      return unpack_v210;
+    case GST_MAKE_FOURCC ('v', '2', '1', '6'):
+      return unpack_v216;
+    default:
+      return NULL;
+  }
+}
+
+GstSdiLineFunc
+gst_sdi_get_pack_func (guint32 fourcc)
+{
+  switch (fourcc) {
+    case GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'):
+      return pack_uyvy;
+    case GST_MAKE_FOURCC ('v', '2', '1', '0'):
+      return pack_v210;
+    case GST_MAKE_FOURCC ('v', '2', '1', '6'):
+      return pack_v216;
+    default:
+      return NULL;
+  }
+}
+
+void
+gst_sdi_read_words (guint16 * words, const guint8 * src)
+{
+  guint64 v = READ_GROUP (src);
+
+  words[0] = v & 0x3ff;
+  words[1] = (v >> 10) & 0x3ff;
+  words[2] = (v >> 20) & 0x3ff;
+  words[3] = (v >> 30) & 0x3ff;
+}
+
+/* n is a multiple of 4 */
+void
+gst_sdi_pack_words (guint8 * dest, const guint16 * words, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i += 4) {
+    WRITE_GROUP (dest, MAKE_GROUP (words[i], words[i + 1], words[i + 2],
+            words[i + 3]));
+    dest += 5;
+  }
+}
+
+/* the xyz word of a timing reference code, with protection bits */
+guint16
+gst_sdi_xyz (gboolean f, gboolean v, gboolean h)
+{
+  f = ! !f;
+  v = ! !v;
+  h = ! !h;
+
+  return 0x200 | (f << 8) | (v << 7) | (h << 6) | ((v ^ h) << 5) |
+      ((f ^ h) << 4) | ((f ^ v) << 3) | ((f ^ v ^ h) << 2);
+}
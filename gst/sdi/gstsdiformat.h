@@ -0,0 +1,115 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _GST_SDI_FORMAT_H_
+#define _GST_SDI_FORMAT_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_VIDEO_CAPS_NTSC(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
+  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=10/11," \
+  "chroma-site=mpeg2,color-matrix=sdtv"
+#define GST_VIDEO_CAPS_NTSC_WIDE(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
+  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=40/33," \
+  "chroma-site=mpeg2,color-matrix=sdtv"
+#define GST_VIDEO_CAPS_PAL(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
+  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=12/11," \
+  "chroma-site=mpeg2,color-matrix=sdtv"
+#define GST_VIDEO_CAPS_PAL_WIDE(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
+  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=16/11," \
+  "chroma-site=mpeg2,color-matrix=sdtv"
+/* SMPTE 274M */
+#define GST_VIDEO_CAPS_1080I(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=1920,height=1080," \
+  "framerate={30000/1001,25/1},interlaced=TRUE,pixel-aspect-ratio=1/1," \
+  "color-matrix=hdtv"
+/* SMPTE 296M */
+#define GST_VIDEO_CAPS_720P(fourcc) \
+  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=1280,height=720," \
+  "framerate={60000/1001,50/1},interlaced=FALSE,pixel-aspect-ratio=1/1," \
+  "color-matrix=hdtv"
+
+#define GST_SDI_VIDEO_FORMATS "{UYVY,v210,v216}"
+
+#define GST_SDI_CAPS \
+  "application/x-raw-sdi,rate=(int){270,1485}," \
+  "standard=(string){ntsc,pal,1080i60,1080i50,720p60,720p50}"
+
+typedef struct _GstSdiFormat GstSdiFormat;
+
+/* line numbers count from the line where the F bit (or the V bit for
+ * progressive formats) of the timing reference codes falls, starting at 1 */
+struct _GstSdiFormat
+{
+  const gchar *name;
+  int lines;
+  int active_lines;
+  int width;                    /* total samples per line */
+  int active_width;
+  int start0;                   /* first active line of field 1 */
+  int start1;                   /* first active line of field 2 */
+  int field2;                   /* first line of field 2 */
+  int tff;
+  gboolean interlaced;
+  gboolean hd;                  /* luma and chroma timing codes multiplexed */
+  int fps_n;
+  int fps_d;
+  int par_n;
+  int par_d;
+  int rate;                     /* interface rate in Mbit/s */
+};
+
+/* one group of 5 bytes carries 4 10-bit words, i.e. 2 pixels */
+#define GST_SDI_FORMAT_LINE_SIZE(format) ((format)->width / 2 * 5)
+#define GST_SDI_FORMAT_MAX_LINE_SIZE (2640 / 2 * 5)
+
+/* the timing reference code as returned by get_word10 () (the upper 8 bits
+ * of 3ff 000 000 xyz) */
+#define SDI_IS_SYNC(a) (((a)&0xffffff80) == 0xff000080)
+#define SDI_SYNC_F(a) (((a)>>6)&1)
+#define SDI_SYNC_V(a) (((a)>>5)&1)
+#define SDI_SYNC_H(a) (((a)>>4)&1)
+
+/* converts n groups of 4 words between the packed line and a frame row */
+typedef void (*GstSdiLineFunc) (guint8 * dest, const guint8 * src, int n);
+
+const GstSdiFormat *gst_sdi_format_from_name (const gchar * name);
+const GstSdiFormat *gst_sdi_format_from_video (int width, int height,
+    int fps_n, int fps_d);
+GstCaps *gst_sdi_format_get_video_caps (const GstSdiFormat * format,
+    guint32 fourcc);
+GstCaps *gst_sdi_format_get_sdi_caps (const GstSdiFormat * format);
+int gst_sdi_format_get_stride (const GstSdiFormat * format, guint32 fourcc);
+
+GstSdiLineFunc gst_sdi_get_unpack_func (guint32 fourcc);
+GstSdiLineFunc gst_sdi_get_pack_func (guint32 fourcc);
+
+void gst_sdi_read_words (guint16 * words, const guint8 * src);
+void gst_sdi_pack_words (guint8 * dest, const guint16 * words, int n);
+guint16 gst_sdi_xyz (gboolean f, gboolean v, gboolean h);
+
+G_END_DECLS
+
+#endif
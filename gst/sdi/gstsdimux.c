@@ -19,14 +19,19 @@
 /**
  * SECTION:element-gstsdimux
  *
- * The gstsdimux element does FIXME stuff.
+ * The sdimux element turns raw video in one of the SDI standards (NTSC, PAL,
+ * SMPTE 274M 1080i or SMPTE 296M 720p) into a 10-bit packed SDI stream with
+ * timing reference codes and blanking, as read by sdidemux.  HD lines carry
+ * line numbers and CRCs.
  *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
- * gst-launch -v fakesrc ! gstsdimux ! FIXME ! fakesink
+ * gst-launch -v videotestsrc num-buffers=25 !
+ *     video/x-raw-yuv,format=(fourcc)UYVY,width=1920,height=1080,framerate=25/1,interlaced=true !
+ *     sdimux ! filesink location=test.sdi
  * ]|
- * FIXME Describe what the pipeline does.
+ * Writes one second of 1080i50 SDI to test.sdi.
  * </refsect2>
  */
 
@@ -35,7 +40,7 @@
 #endif
 
 #include <gst/gst.h>
-#include <gst/gst.h>
+#include <string.h>
 #include "gstsdimux.h"
 
 /* prototypes */
@@ -56,6 +61,7 @@ gst_sdi_mux_change_state (GstElement * element, GstStateChange transition);
 static const GstQueryType *gst_sdi_mux_get_query_types (GstElement * element);
 static gboolean gst_sdi_mux_query (GstElement * element, GstQuery * query);
 static GstFlowReturn gst_sdi_mux_chain (GstPad * pad, GstBuffer * buffer);
+static gboolean gst_sdi_mux_sink_setcaps (GstPad * pad, GstCaps * caps);
 static gboolean gst_sdi_mux_sink_event (GstPad * pad, GstEvent * event);
 static gboolean gst_sdi_mux_src_event (GstPad * pad, GstEvent * event);
 
@@ -66,37 +72,21 @@ enum
 
 /* pad templates */
 
-#define GST_VIDEO_CAPS_NTSC(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
-  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=10/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_NTSC_WIDE(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=480," \
-  "framerate=30000/1001,interlaced=TRUE,pixel-aspect-ratio=40/33," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_PAL(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
-  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=12/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-#define GST_VIDEO_CAPS_PAL_WIDE(fourcc) \
-  "video/x-raw-yuv,format=(fourcc)" fourcc ",width=720,height=576," \
-  "framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=16/11," \
-  "chroma-site=mpeg2,color-matrix=sdtv"
-
 static GstStaticPadTemplate gst_sdi_mux_sink_template =
     GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_NTSC ("{UYVY,v210}") ";"
-        GST_VIDEO_CAPS_PAL ("{UYVY,v210}"))
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_NTSC (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_PAL (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_1080I (GST_SDI_VIDEO_FORMATS) ";"
+        GST_VIDEO_CAPS_720P (GST_SDI_VIDEO_FORMATS))
     );
 
 static GstStaticPadTemplate gst_sdi_mux_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS
-    ("application/x-raw-sdi,rate=270,format=(fourcc){UYVY,v210}")
+    GST_STATIC_CAPS (GST_SDI_CAPS)
     );
 
 /* class initialization */
@@ -149,6 +139,8 @@ gst_sdi_mux_init (GstSdiMux * sdimux, GstSdiMuxClass * sdimux_class)
       GST_DEBUG_FUNCPTR (gst_sdi_mux_sink_event));
   gst_pad_set_chain_function (sdimux->sinkpad,
       GST_DEBUG_FUNCPTR (gst_sdi_mux_chain));
+  gst_pad_set_setcaps_function (sdimux->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_sdi_mux_sink_setcaps));
   gst_element_add_pad (GST_ELEMENT (sdimux), sdimux->sinkpad);
 
   sdimux->srcpad = gst_pad_new_from_static_template (&gst_sdi_mux_src_template,
@@ -201,6 +193,8 @@ gst_sdi_mux_finalize (GObject * object)
   g_return_if_fail (GST_IS_SDI_MUX (object));
 
   /* clean up object here */
+  g_free (GST_SDI_MUX (object)->header_words);
+  g_free (GST_SDI_MUX (object)->blank_line);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -224,8 +218,21 @@ gst_sdi_mux_release_pad (GstElement * element, GstPad * pad)
 static GstStateChangeReturn
 gst_sdi_mux_change_state (GstElement * element, GstStateChange transition)
 {
+  GstSdiMux *sdimux = GST_SDI_MUX (element);
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      sdimux->crc_c = 0;
+      sdimux->crc_y = 0;
+      break;
+    default:
+      break;
+  }
 
-  return GST_STATE_CHANGE_SUCCESS;
+  return ret;
 }
 
 static const GstQueryType *
@@ -242,18 +249,249 @@ gst_sdi_mux_query (GstElement * element, GstQuery * query)
   return FALSE;
 }
 
+/* CRC-18, x^18 + x^5 + x^4 + 1, over 10-bit words LSB first */
+static guint32
+gst_sdi_mux_crc (guint32 crc, guint16 word)
+{
+  int i;
+
+  for (i = 0; i < 10; i++) {
+    guint32 bit = (crc ^ (word >> i)) & 1;
+
+    crc >>= 1;
+    if (bit)
+      crc ^= 0x23000;
+  }
+
+  return crc;
+}
+
+/* adds the active samples of a HD line to the CRCs sent with the next line */
+static void
+gst_sdi_mux_update_crc (GstSdiMux * sdimux, const guint8 * src, int n)
+{
+  guint16 w[4];
+  int i;
+
+  for (i = 0; i < n; i++) {
+    gst_sdi_read_words (w, src + i * 5);
+    sdimux->crc_c = gst_sdi_mux_crc (sdimux->crc_c, w[0]);
+    sdimux->crc_y = gst_sdi_mux_crc (sdimux->crc_y, w[1]);
+    sdimux->crc_c = gst_sdi_mux_crc (sdimux->crc_c, w[2]);
+    sdimux->crc_y = gst_sdi_mux_crc (sdimux->crc_y, w[3]);
+  }
+}
+
+/* fills in the timing reference codes (and for HD the line number and CRC)
+ * of @line, returns the frame row carried on the line or -1 */
+static int
+gst_sdi_mux_fill_header (GstSdiMux * sdimux, int line)
+{
+  const GstSdiFormat *format = sdimux->format;
+  guint16 *w = sdimux->header_words;
+  int n_words = (format->width - format->active_width) * 2;
+  int field_lines;
+  gboolean f, v;
+  int row = -1;
+
+  field_lines = format->interlaced ? format->active_lines / 2 :
+      format->active_lines;
+
+  if (line >= format->start0 && line < format->start0 + field_lines) {
+    row = line - format->start0;
+    if (format->interlaced)
+      row = row * 2 + (!format->tff);
+  } else if (format->interlaced && line >= format->start1 &&
+      line < format->start1 + field_lines) {
+    row = (line - format->start1) * 2 + (format->tff);
+  }
+
+  f = format->interlaced && line >= format->field2;
+  v = (row < 0);
+
+  if (!format->hd) {
+    w[0] = 0x3ff;
+    w[1] = 0x000;
+    w[2] = 0x000;
+    w[3] = gst_sdi_xyz (f, v, TRUE);
+
+    w[n_words - 4] = 0x3ff;
+    w[n_words - 3] = 0x000;
+    w[n_words - 2] = 0x000;
+    w[n_words - 1] = gst_sdi_xyz (f, v, FALSE);
+  } else {
+    int i;
+
+    /* EAV, LN0, LN1 and CR0, CR1 for the chroma and luma streams */
+    w[0] = w[1] = 0x3ff;
+    w[2] = w[3] = w[4] = w[5] = 0x000;
+    w[6] = w[7] = gst_sdi_xyz (f, v, TRUE);
+    w[8] = w[9] = ((line & 0x7f) << 2) | ((line & 0x40) ? 0 : 0x200);
+    w[10] = w[11] = (((line >> 7) & 0xf) << 2) | 0x200;
+    for (i = 0; i < 12; i += 2) {
+      sdimux->crc_c = gst_sdi_mux_crc (sdimux->crc_c, w[i]);
+      sdimux->crc_y = gst_sdi_mux_crc (sdimux->crc_y, w[i + 1]);
+    }
+    w[12] = (sdimux->crc_c & 0x1ff) | ((sdimux->crc_c & 0x100) ? 0 : 0x200);
+    w[13] = (sdimux->crc_y & 0x1ff) | ((sdimux->crc_y & 0x100) ? 0 : 0x200);
+    w[14] = ((sdimux->crc_c >> 9) & 0x1ff) |
+        ((sdimux->crc_c & 0x20000) ? 0 : 0x200);
+    w[15] = ((sdimux->crc_y >> 9) & 0x1ff) |
+        ((sdimux->crc_y & 0x20000) ? 0 : 0x200);
+    sdimux->crc_c = 0;
+    sdimux->crc_y = 0;
+
+    w[n_words - 8] = w[n_words - 7] = 0x3ff;
+    w[n_words - 6] = w[n_words - 5] = w[n_words - 4] = w[n_words - 3] = 0x000;
+    w[n_words - 2] = w[n_words - 1] = gst_sdi_xyz (f, v, FALSE);
+  }
+
+  return row;
+}
+
+static gboolean
+gst_sdi_mux_sink_setcaps (GstPad * pad, GstCaps * caps)
+{
+  GstSdiMux *sdimux = GST_SDI_MUX (gst_pad_get_parent (pad));
+  GstStructure *structure = gst_caps_get_structure (caps, 0);
+  const GstSdiFormat *format;
+  GstCaps *src_caps;
+  guint16 *words;
+  guint32 fourcc;
+  int width, height, fps_n, fps_d;
+  int i, n_words;
+  gboolean ret;
+
+  if (!gst_structure_get_fourcc (structure, "format", &fourcc) ||
+      !gst_structure_get_int (structure, "width", &width) ||
+      !gst_structure_get_int (structure, "height", &height) ||
+      !gst_structure_get_fraction (structure, "framerate", &fps_n, &fps_d))
+    goto invalid_caps;
+
+  format = gst_sdi_format_from_video (width, height, fps_n, fps_d);
+  if (format == NULL || gst_sdi_get_pack_func (fourcc) == NULL)
+    goto invalid_caps;
+
+  src_caps = gst_sdi_format_get_sdi_caps (format);
+  ret = gst_pad_set_caps (sdimux->srcpad, src_caps);
+  gst_caps_unref (src_caps);
+  if (!ret)
+    goto done;
+
+  GST_DEBUG_OBJECT (sdimux, "muxing %" GST_FOURCC_FORMAT " as %s",
+      GST_FOURCC_ARGS (fourcc), format->name);
+
+  sdimux->format = format;
+  sdimux->stride = gst_sdi_format_get_stride (format, fourcc);
+  sdimux->pack = gst_sdi_get_pack_func (fourcc);
+
+  /* horizontal blanking, the timing codes are filled in per line */
+  n_words = (format->width - format->active_width) * 2;
+  g_free (sdimux->header_words);
+  sdimux->header_words = g_new (guint16, n_words);
+  for (i = 0; i < n_words; i++)
+    sdimux->header_words[i] = (i & 1) ? 0x040 : 0x200;
+
+  /* lines in the vertical blanking */
+  n_words = format->active_width * 2;
+  words = g_new (guint16, n_words);
+  for (i = 0; i < n_words; i++)
+    words[i] = (i & 1) ? 0x040 : 0x200;
+  g_free (sdimux->blank_line);
+  sdimux->blank_line = g_malloc (n_words / 4 * 5);
+  gst_sdi_pack_words (sdimux->blank_line, words, n_words);
+  g_free (words);
+
+done:
+  gst_object_unref (sdimux);
+  return ret;
+
+invalid_caps:
+  {
+    GST_WARNING_OBJECT (sdimux, "unsupported caps %" GST_PTR_FORMAT, caps);
+    gst_object_unref (sdimux);
+    return FALSE;
+  }
+}
+
 static GstFlowReturn
 gst_sdi_mux_chain (GstPad * pad, GstBuffer * buffer)
 {
   GstSdiMux *sdimux;
+  const GstSdiFormat *format;
+  GstBuffer *outbuf;
+  GstFlowReturn ret;
+  guint8 *dest;
+  int line_size, active_offset, header_words, line;
 
   sdimux = GST_SDI_MUX (gst_pad_get_parent (pad));
+  format = sdimux->format;
 
   GST_DEBUG_OBJECT (sdimux, "chain");
 
+  if (format == NULL)
+    goto not_negotiated;
+  if (GST_BUFFER_SIZE (buffer) < sdimux->stride * format->active_lines)
+    goto wrong_size;
+
+  line_size = GST_SDI_FORMAT_LINE_SIZE (format);
+  ret = gst_pad_alloc_buffer_and_set_caps (sdimux->srcpad,
+      GST_BUFFER_OFFSET_NONE, line_size * format->lines,
+      GST_PAD_CAPS (sdimux->srcpad), &outbuf);
+  if (ret != GST_FLOW_OK)
+    goto done;
+  if (GST_BUFFER_SIZE (outbuf) < line_size * format->lines) {
+    gst_buffer_unref (outbuf);
+    outbuf = gst_buffer_new_and_alloc (line_size * format->lines);
+    gst_buffer_set_caps (outbuf, GST_PAD_CAPS (sdimux->srcpad));
+  }
+  gst_buffer_copy_metadata (outbuf, buffer, GST_BUFFER_COPY_TIMESTAMPS);
+
+  dest = GST_BUFFER_DATA (outbuf);
+  active_offset = (format->width - format->active_width) / 2 * 5;
+  header_words = (format->width - format->active_width) * 2;
+  for (line = 1; line <= format->lines; line++) {
+    int row = gst_sdi_mux_fill_header (sdimux, line);
+
+    gst_sdi_pack_words (dest, sdimux->header_words, header_words);
+    if (row >= 0)
+      sdimux->pack (dest + active_offset,
+          GST_BUFFER_DATA (buffer) + row * sdimux->stride,
+          format->active_width / 2);
+    else
+      memcpy (dest + active_offset, sdimux->blank_line,
+          format->active_width / 2 * 5);
+    if (format->hd)
+      gst_sdi_mux_update_crc (sdimux, dest + active_offset,
+          format->active_width / 2);
+
+    dest += line_size;
+  }
+
+  ret = gst_pad_push (sdimux->srcpad, outbuf);
 
+done:
+  gst_buffer_unref (buffer);
   gst_object_unref (sdimux);
-  return GST_FLOW_OK;
+  return ret;
+
+not_negotiated:
+  {
+    GST_ELEMENT_ERROR (sdimux, CORE, NEGOTIATION, (NULL),
+        ("no format set before the first buffer"));
+    gst_buffer_unref (buffer);
+    gst_object_unref (sdimux);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+wrong_size:
+  {
+    GST_ELEMENT_ERROR (sdimux, STREAM, FORMAT, (NULL),
+        ("buffer of %u bytes is too small for a frame",
+            GST_BUFFER_SIZE (buffer)));
+    gst_buffer_unref (buffer);
+    gst_object_unref (sdimux);
+    return GST_FLOW_ERROR;
+  }
 }
 
 static gboolean
@@ -21,7 +21,7 @@
 #define _GST_SDI_MUX_H_
 
 #include <gst/gst.h>
-#include <gst/gst.h>
+#include "gstsdiformat.h"
 
 G_BEGIN_DECLS
 
@@ -40,6 +40,19 @@ struct _GstSdiMux
 
   GstPad *srcpad;
   GstPad *sinkpad;
+
+  const GstSdiFormat *format;
+  int stride;
+  GstSdiLineFunc pack;
+
+  /* horizontal blanking with the timing reference codes of the current
+   * line, and a line of vertical blanking */
+  guint16 *header_words;
+  guint8 *blank_line;
+
+  /* HD line CRCs, carried over from the previous line */
+  guint32 crc_c;
+  guint32 crc_y;
 };
 
 struct _GstSdiMuxClass
@@ -68,7 +68,23 @@
  *   the brightness variance of the frame.
  *   </para>
  * </listitem>
+ * <listitem>
+ *   <para>
+ *   #gdouble
+ *   <classname>&quot;difference&quot;</classname>:
+ *   the mean absolute luma difference with the previous analysed frame in
+ *   0.0 to 1.0, 0.0 for a frozen picture and -1.0 when there is no previous
+ *   frame yet. Only present when #GstVideoAnalyse:probe is #TRUE.
+ *   </para>
+ * </listitem>
  * </itemizedlist>
+ *
+ * The statistics can be restricted to a region of interest with the
+ * #GstVideoAnalyse:roi-x, #GstVideoAnalyse:roi-y, #GstVideoAnalyse:roi-width
+ * and #GstVideoAnalyse:roi-height properties, to every Nth line of it with
+ * #GstVideoAnalyse:line-step and to every Nth frame with
+ * #GstVideoAnalyse:interval, which makes it cheap enough to watch many
+ * streams for black or frozen pictures at the same time.
  * 
  * <refsect2>
  * <title>Example launch line</title>
@@ -85,6 +101,7 @@
 #endif
 
 #include "gstvideoanalyse.h"
+#include "gstvideosignalorc.h"
 
 #include <string.h>
 #include <math.h>
@@ -94,11 +111,25 @@
 /* GstVideoAnalyse signals and args */
 
 #define DEFAULT_MESSAGE		TRUE
+#define DEFAULT_ROI_X		0
+#define DEFAULT_ROI_Y		0
+#define DEFAULT_ROI_WIDTH	0
+#define DEFAULT_ROI_HEIGHT	0
+#define DEFAULT_LINE_STEP	1
+#define DEFAULT_INTERVAL	1
+#define DEFAULT_PROBE		FALSE
 
 enum
 {
   PROP_0,
-  PROP_MESSAGE
+  PROP_MESSAGE,
+  PROP_ROI_X,
+  PROP_ROI_Y,
+  PROP_ROI_WIDTH,
+  PROP_ROI_HEIGHT,
+  PROP_LINE_STEP,
+  PROP_INTERVAL,
+  PROP_PROBE
 };
 
 GST_DEBUG_CATEGORY_STATIC (video_analyse_debug);
@@ -138,6 +169,32 @@ gst_video_analyse_set_caps (GstBaseTransform * btrans, GstCaps * incaps,
   return ret;
 }
 
+static gboolean
+gst_video_analyse_start (GstBaseTransform * trans)
+{
+  GstVideoAnalyse *videoanalyse = GST_VIDEO_ANALYSE (trans);
+
+  videoanalyse->frame_count = 0;
+  videoanalyse->have_prev = FALSE;
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_analyse_stop (GstBaseTransform * trans)
+{
+  GstVideoAnalyse *videoanalyse = GST_VIDEO_ANALYSE (trans);
+
+  g_free (videoanalyse->prev);
+  videoanalyse->prev = NULL;
+  g_free (videoanalyse->next);
+  videoanalyse->next = NULL;
+  videoanalyse->prev_size = 0;
+  videoanalyse->have_prev = FALSE;
+
+  return TRUE;
+}
+
 /* Useful macros */
 #define GST_VIDEO_I420_Y_ROWSTRIDE(width) (GST_ROUND_UP_4(width))
 #define GST_VIDEO_I420_U_ROWSTRIDE(width) (GST_ROUND_UP_8(width)/2)
@@ -151,9 +208,10 @@ gst_video_analyse_set_caps (GstBaseTransform * btrans, GstCaps * incaps,
 
 static void
 gst_video_analyse_post_message (GstVideoAnalyse * videoanalyse,
-    GstBuffer * buffer)
+    GstBuffer * buffer, gboolean probe)
 {
   GstBaseTransform *trans;
+  GstStructure *s;
   GstMessage *m;
   guint64 duration, timestamp, running_time, stream_time;
 
@@ -167,51 +225,89 @@ gst_video_analyse_post_message (GstVideoAnalyse * videoanalyse,
   stream_time = gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
       timestamp);
 
-  m = gst_message_new_element (GST_OBJECT_CAST (videoanalyse),
-      gst_structure_new ("GstVideoAnalyse",
-          "timestamp", G_TYPE_UINT64, timestamp,
-          "stream-time", G_TYPE_UINT64, stream_time,
-          "running-time", G_TYPE_UINT64, running_time,
-          "duration", G_TYPE_UINT64, duration,
-          "brightness", G_TYPE_DOUBLE, videoanalyse->brightness,
-          "brightness-variance", G_TYPE_DOUBLE, videoanalyse->brightness_var,
-          NULL));
+  s = gst_structure_new ("GstVideoAnalyse",
+      "timestamp", G_TYPE_UINT64, timestamp,
+      "stream-time", G_TYPE_UINT64, stream_time,
+      "running-time", G_TYPE_UINT64, running_time,
+      "duration", G_TYPE_UINT64, duration,
+      "brightness", G_TYPE_DOUBLE, videoanalyse->brightness,
+      "brightness-variance", G_TYPE_DOUBLE, videoanalyse->brightness_var,
+      NULL);
+  if (probe)
+    gst_structure_set (s, "difference", G_TYPE_DOUBLE,
+        videoanalyse->difference, NULL);
+
+  m = gst_message_new_element (GST_OBJECT_CAST (videoanalyse), s);
 
   gst_element_post_message (GST_ELEMENT_CAST (videoanalyse), m);
 }
 
+/* analyses @lines lines of @width samples, @stride bytes apart, starting at
+ * @data. The sum and the sum of squares are gathered in a single pass, the
+ * variance is derived from them. In @probe mode the same pass also compares
+ * the lines with the ones of the previous frame. */
 static void
-gst_video_analyse_420 (GstVideoAnalyse * videoanalyse, guint8 * data,
-    gint width, gint height)
+gst_video_analyse_planar (GstVideoAnalyse * videoanalyse, guint8 * data,
+    gint width, gint lines, gint stride, gboolean probe)
 {
-  guint64 sum;
-  gint avg, diff;
-  gint i, j;
-  guint8 *d;
+  guint64 sum, sumsq, sad, n;
+  guint32 line_sum, line_sumsq, line_sad;
+  guint64 avg;
+  gsize size;
+  guint8 *tmp;
+  gint i;
+
+  n = (guint64) width * lines;
+  sum = sumsq = sad = 0;
+
+  if (probe) {
+    size = (gsize) width * lines;
+
+    if (videoanalyse->prev_size != size) {
+      g_free (videoanalyse->prev);
+      g_free (videoanalyse->next);
+      videoanalyse->prev = g_malloc0 (size);
+      videoanalyse->next = g_malloc (size);
+      videoanalyse->prev_size = size;
+      videoanalyse->have_prev = FALSE;
+    }
 
-  d = data;
-  sum = 0;
-  /* do brightness as average of pixel brightness in 0.0 to 1.0 */
-  for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
-      sum += d[j];
+    for (i = 0; i < lines; i++) {
+      orc_video_signal_probe_u8 (videoanalyse->next + i * width, &line_sum,
+          &line_sumsq, &line_sad, data, videoanalyse->prev + i * width, width);
+      sum += line_sum;
+      sumsq += line_sumsq;
+      sad += line_sad;
+      data += stride;
     }
-    d += GST_VIDEO_I420_Y_ROWSTRIDE (width);
-  }
-  avg = sum / (width * height);
-  videoanalyse->brightness = sum / (255.0 * width * height);
-
-  d = data;
-  sum = 0;
-  /* do variance */
-  for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
-      diff = (avg - d[j]);
-      sum += diff * diff;
+
+    if (videoanalyse->have_prev)
+      videoanalyse->difference = sad / (255.0 * n);
+    else
+      videoanalyse->difference = -1.0;
+
+    tmp = videoanalyse->prev;
+    videoanalyse->prev = videoanalyse->next;
+    videoanalyse->next = tmp;
+    videoanalyse->have_prev = TRUE;
+  } else {
+    for (i = 0; i < lines; i++) {
+      orc_video_signal_sum_sumsq_u8 (&line_sum, &line_sumsq, data, width);
+      sum += line_sum;
+      sumsq += line_sumsq;
+      data += stride;
     }
-    d += GST_VIDEO_I420_Y_ROWSTRIDE (width);
+    /* the lines kept are stale now */
+    videoanalyse->have_prev = FALSE;
   }
-  videoanalyse->brightness_var = sum / (255.0 * 255.0 * width * height);
+
+  /* do brightness as average of pixel brightness in 0.0 to 1.0 */
+  avg = sum / n;
+  videoanalyse->brightness = sum / (255.0 * n);
+
+  /* do variance, sum ((avg - x)^2) = sumsq - 2 * avg * sum + n * avg^2 */
+  videoanalyse->brightness_var =
+      (sumsq + n * avg * avg - 2 * avg * sum) / (255.0 * 255.0 * n);
 }
 
 static GstFlowReturn
@@ -219,19 +315,50 @@ gst_video_analyse_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 {
   GstVideoAnalyse *videoanalyse;
   GstFlowReturn ret = GST_FLOW_OK;
+  gint x, y, width, height, stride, lines;
+  guint line_step, interval;
+  gboolean message, probe;
   guint8 *data;
 
   videoanalyse = GST_VIDEO_ANALYSE (trans);
 
-  data = GST_BUFFER_DATA (buf);
+  GST_OBJECT_LOCK (videoanalyse);
+  message = videoanalyse->message;
+  probe = videoanalyse->probe;
+  line_step = videoanalyse->line_step;
+  interval = videoanalyse->interval;
+
+  /* clip the region of interest to the frame, 0 extends it to the edge */
+  x = MIN (videoanalyse->roi_x, videoanalyse->width - 1);
+  y = MIN (videoanalyse->roi_y, videoanalyse->height - 1);
+  width = videoanalyse->width - x;
+  if (videoanalyse->roi_width > 0)
+    width = MIN (width, videoanalyse->roi_width);
+  height = videoanalyse->height - y;
+  if (videoanalyse->roi_height > 0)
+    height = MIN (height, videoanalyse->roi_height);
+  GST_OBJECT_UNLOCK (videoanalyse);
 
-  gst_video_analyse_420 (videoanalyse, data, videoanalyse->width,
-      videoanalyse->height);
+  if (videoanalyse->frame_count++ % interval != 0)
+    goto skip;
 
-  if (videoanalyse->message)
-    gst_video_analyse_post_message (videoanalyse, buf);
+  stride = GST_VIDEO_I420_Y_ROWSTRIDE (videoanalyse->width);
+  lines = (height + line_step - 1) / line_step;
+  data = GST_BUFFER_DATA (buf) + y * stride + x;
+
+  gst_video_analyse_planar (videoanalyse, data, width, lines,
+      stride * line_step, probe);
+
+  if (message)
+    gst_video_analyse_post_message (videoanalyse, buf, probe);
 
   return ret;
+
+skip:
+  {
+    GST_LOG_OBJECT (videoanalyse, "skipping frame");
+    return ret;
+  }
 }
 
 static void
@@ -244,7 +371,44 @@ gst_video_analyse_set_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case PROP_MESSAGE:
+      GST_OBJECT_LOCK (videoanalyse);
       videoanalyse->message = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_X:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->roi_x = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_Y:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->roi_y = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_WIDTH:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->roi_width = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_HEIGHT:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->roi_height = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_LINE_STEP:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->line_step = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_INTERVAL:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->interval = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_PROBE:
+      GST_OBJECT_LOCK (videoanalyse);
+      videoanalyse->probe = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (videoanalyse);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -262,7 +426,44 @@ gst_video_analyse_get_property (GObject * object, guint prop_id, GValue * value,
 
   switch (prop_id) {
     case PROP_MESSAGE:
+      GST_OBJECT_LOCK (videoanalyse);
       g_value_set_boolean (value, videoanalyse->message);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_X:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_int (value, videoanalyse->roi_x);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_Y:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_int (value, videoanalyse->roi_y);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_WIDTH:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_int (value, videoanalyse->roi_width);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_ROI_HEIGHT:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_int (value, videoanalyse->roi_height);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_LINE_STEP:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_uint (value, videoanalyse->line_step);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_INTERVAL:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_uint (value, videoanalyse->interval);
+      GST_OBJECT_UNLOCK (videoanalyse);
+      break;
+    case PROP_PROBE:
+      GST_OBJECT_LOCK (videoanalyse);
+      g_value_set_boolean (value, videoanalyse->probe);
+      GST_OBJECT_UNLOCK (videoanalyse);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -305,6 +506,101 @@ gst_video_analyse_class_init (gpointer klass, gpointer class_data)
           DEFAULT_MESSAGE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoAnalyse:roi-x
+   *
+   * Left edge of the analysed region.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_ROI_X,
+      g_param_spec_int ("roi-x", "ROI x",
+          "Left edge of the analysed region", 0, G_MAXINT, DEFAULT_ROI_X,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:roi-y
+   *
+   * Top edge of the analysed region.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_ROI_Y,
+      g_param_spec_int ("roi-y", "ROI y",
+          "Top edge of the analysed region", 0, G_MAXINT, DEFAULT_ROI_Y,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:roi-width
+   *
+   * Width of the analysed region, 0 extends it to the right edge of the
+   * frame.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_ROI_WIDTH,
+      g_param_spec_int ("roi-width", "ROI width",
+          "Width of the analysed region (0 = up to the right edge)", 0,
+          G_MAXINT, DEFAULT_ROI_WIDTH,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:roi-height
+   *
+   * Height of the analysed region, 0 extends it to the bottom edge of the
+   * frame.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_ROI_HEIGHT,
+      g_param_spec_int ("roi-height", "ROI height",
+          "Height of the analysed region (0 = up to the bottom edge)", 0,
+          G_MAXINT, DEFAULT_ROI_HEIGHT,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:line-step
+   *
+   * Only analyse every Nth line of the region, starting with its first line.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_LINE_STEP,
+      g_param_spec_uint ("line-step", "Line step",
+          "Analyse every Nth line of the region", 1, G_MAXINT,
+          DEFAULT_LINE_STEP,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:interval
+   *
+   * Only analyse every Nth frame, starting with the first one. No message is
+   * posted for the skipped frames.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_INTERVAL,
+      g_param_spec_uint ("interval", "Interval",
+          "Analyse every Nth frame", 1, G_MAXUINT, DEFAULT_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoAnalyse:probe
+   *
+   * Also measure the difference with the previous analysed frame, in the
+   * same pass as the brightness statistics, and add it to the messages as
+   * the <classname>&quot;difference&quot;</classname> field.
+   *
+   * Since: 0.10.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_PROBE,
+      g_param_spec_boolean ("probe", "Probe",
+          "Also measure the difference with the previous analysed frame",
+          DEFAULT_PROBE,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
+  trans_class->start = GST_DEBUG_FUNCPTR (gst_video_analyse_start);
+  trans_class->stop = GST_DEBUG_FUNCPTR (gst_video_analyse_stop);
   trans_class->set_caps = GST_DEBUG_FUNCPTR (gst_video_analyse_set_caps);
   trans_class->transform_ip =
       GST_DEBUG_FUNCPTR (gst_video_analyse_transform_ip);
@@ -49,11 +49,23 @@ struct _GstVideoAnalyse {
   gint width, height;
 
   gboolean message;
+  gint roi_x, roi_y;
+  gint roi_width, roi_height;
+  guint line_step;
+  guint interval;
+  gboolean probe;
+
+  guint64 frame_count;
+
+  /* luma of the analysed lines of the previous frame and the buffer the
+   * current frame is copied to, swapped after every frame */
+  guint8 *prev, *next;
+  gsize prev_size;
+  gboolean have_prev;
 
   gdouble brightness;
   gdouble brightness_var;
-
-  guint64 interval;
+  gdouble difference;
 };
 
 struct _GstVideoAnalyseClass {
@@ -107,6 +107,7 @@
 #endif
 
 #include "gstvideodetect.h"
+#include "gstvideosignalorc.h"
 
 #include <string.h>
 #include <math.h>
@@ -220,13 +221,23 @@ gst_video_detect_calc_brightness (GstVideoDetect * videodetect, guint8 * data,
 {
   gint i, j;
   guint64 sum;
+  guint32 line_sum;
 
   sum = 0;
-  for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
-      sum += data[pixel_stride * j];
+  if (pixel_stride == 1) {
+    /* planar formats, the samples of a line are contiguous */
+    for (i = 0; i < height; i++) {
+      orc_video_signal_sum_u8 (&line_sum, data, width);
+      sum += line_sum;
+      data += row_stride;
+    }
+  } else {
+    for (i = 0; i < height; i++) {
+      for (j = 0; j < width; j++) {
+        sum += data[pixel_stride * j];
+      }
+      data += row_stride;
     }
-    data += row_stride;
   }
   return sum / (255.0 * width * height);
 }
@@ -24,12 +24,15 @@
 #include "gstvideoanalyse.h"
 #include "gstvideodetect.h"
 #include "gstvideomark.h"
+#include "gstvideosignalorc.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
   gboolean res;
 
+  gst_videosignal_orc_init ();
+
   res = gst_element_register (plugin, "videoanalyse", GST_RANK_NONE,
       GST_TYPE_VIDEO_ANALYSE);
 
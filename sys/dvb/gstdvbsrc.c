@@ -21,7 +21,20 @@
  * SECTION:element-dvbsrc
  *
  * dvbsrc can be used to capture video from DVB cards, DVB-T, DVB-S or DVB-T.
- * 
+ *
+ * The transport stream is read in blocks of #GstBaseSrc:blocksize bytes,
+ * rounded down to a whole number of 188 byte packets. The memory of pushed
+ * buffers is recycled once downstream releases them. At high transponder
+ * rates a larger blocksize reduces the per-buffer overhead considerably.
+ *
+ * When #GstDvbSrc:ring-size is not 0 a separate thread keeps reading from
+ * the DVR device into a ring of that many blocks, so the kernel buffer is
+ * drained even while downstream is briefly slow. The oldest block is dropped
+ * when the ring is full.
+ *
+ * #GstDvbSrc:dvr-device can point to a file or FIFO that is read instead of
+ * the DVR device of the adapter, without tuning the frontend.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -44,6 +57,7 @@
 #include <gst/gst.h>
 #include <sys/ioctl.h>
 #include <sys/poll.h>
+#include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <stdio.h>
@@ -89,6 +103,8 @@ enum
   ARG_DVBSRC_INVERSION,
   ARG_DVBSRC_STATS_REPORTING_INTERVAL,
   ARG_DVBSRC_TIMEOUT,
+  ARG_DVBSRC_DVR_DEVICE,
+  ARG_DVBSRC_RING_SIZE
 };
 
 #define DEFAULT_ADAPTER 0
@@ -109,7 +125,26 @@ enum
 #define DEFAULT_STATS_REPORTING_INTERVAL 100
 #define DEFAULT_TIMEOUT 1000000 /* 1 second */
 
-#define DEFAULT_BUFFER_SIZE 8192        /* not a property */
+#define DEFAULT_DVR_DEVICE NULL
+#define DEFAULT_RING_SIZE 0
+
+/* a whole number of packets close to the 8 kB read before */
+#define DEFAULT_BLOCKSIZE (TS_SIZE * 43)
+
+/* free blocks kept around by the pool on top of the ring */
+#define POOL_EXTRA_BLOCKS 4
+/* in front of the data of each block, keeps the data 16 byte aligned */
+#define POOL_HEADER_SIZE 16
+
+struct _GstDvbSrcBufferPool
+{
+  gint refcount;
+  GMutex *lock;
+  GSList *free_blocks;
+  guint n_free;
+  guint max_free;
+  guint size;
+};
 
 static void gst_dvbsrc_output_frontend_stats (GstDvbSrc * src);
 
@@ -452,6 +487,18 @@ gst_dvbsrc_class_init (GstDvbSrcClass * klass)
       g_param_spec_uint64 ("timeout", "Timeout",
           "Post a message after timeout microseconds (0 = disabled)", 0,
           G_MAXUINT64, DEFAULT_TIMEOUT, G_PARAM_READWRITE));
+
+  g_object_class_install_property (gobject_class, ARG_DVBSRC_DVR_DEVICE,
+      g_param_spec_string ("dvr-device", "DVR device",
+          "Read the transport stream from this file or FIFO instead of the "
+          "DVR device of the adapter, without tuning (NULL = disabled)",
+          DEFAULT_DVR_DEVICE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, ARG_DVBSRC_RING_SIZE,
+      g_param_spec_uint ("ring-size", "Ring size",
+          "Number of blocks a separate reader thread can read ahead of "
+          "downstream (0 = read in the streaming thread)", 0, 1024,
+          DEFAULT_RING_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 /* initialize the new element
@@ -499,6 +546,14 @@ gst_dvbsrc_init (GstDvbSrc * object, GstDvbSrcClass * klass)
 
   object->tune_mutex = g_mutex_new ();
   object->timeout = DEFAULT_TIMEOUT;
+
+  object->dvr_device = DEFAULT_DVR_DEVICE;
+  object->ring_size = DEFAULT_RING_SIZE;
+  object->ring_lock = g_mutex_new ();
+  object->ring_cond = g_cond_new ();
+  object->ring = g_queue_new ();
+
+  gst_base_src_set_blocksize (GST_BASE_SRC (object), DEFAULT_BLOCKSIZE);
 }
 
 
@@ -639,6 +694,13 @@ gst_dvbsrc_set_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_TIMEOUT:
       object->timeout = g_value_get_uint64 (value);
       break;
+    case ARG_DVBSRC_DVR_DEVICE:
+      g_free (object->dvr_device);
+      object->dvr_device = g_value_dup_string (value);
+      break;
+    case ARG_DVBSRC_RING_SIZE:
+      object->ring_size = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -705,6 +767,12 @@ gst_dvbsrc_get_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_TIMEOUT:
       g_value_set_uint64 (value, object->timeout);
       break;
+    case ARG_DVBSRC_DVR_DEVICE:
+      g_value_set_string (value, object->dvr_device);
+      break;
+    case ARG_DVBSRC_RING_SIZE:
+      g_value_set_uint (value, object->ring_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -717,8 +785,10 @@ gst_dvbsrc_close_devices (GstDvbSrc * object)
 
   close (object->fd_dvr);
   object->fd_dvr = -1;
-  close (object->fd_frontend);
-  object->fd_frontend = -1;
+  if (object->fd_frontend >= 0) {
+    close (object->fd_frontend);
+    object->fd_frontend = -1;
+  }
 
   return TRUE;
 }
@@ -824,9 +894,13 @@ static gboolean
 gst_dvbsrc_open_dvr (GstDvbSrc * object)
 {
   gchar *dvr_dev;
+  struct stat st;
 
-  dvr_dev = g_strdup_printf ("/dev/dvb/adapter%d/dvr%d",
-      object->adapter_number, object->frontend_number);
+  if (object->dvr_device)
+    dvr_dev = g_strdup (object->dvr_device);
+  else
+    dvr_dev = g_strdup_printf ("/dev/dvb/adapter%d/dvr%d",
+        object->adapter_number, object->frontend_number);
   GST_INFO_OBJECT (object, "Using dvr device: %s", dvr_dev);
 
   /* open DVR */
@@ -846,6 +920,14 @@ gst_dvbsrc_open_dvr (GstDvbSrc * object)
     return FALSE;
   }
   g_free (dvr_dev);
+
+  /* dvr-device may also name a DVR device tuned by someone else; only files
+   * and FIFOs end, and they have no demux buffer */
+  object->dvr_is_file = fstat (object->fd_dvr, &st) == 0
+      && !S_ISCHR (st.st_mode);
+  if (object->dvr_is_file)
+    return TRUE;
+
   GST_INFO_OBJECT (object, "Setting buffer size");
   if (ioctl (object->fd_dvr, DMX_SET_BUFFER_SIZE, 1024 * 1024) < 0) {
     GST_INFO_OBJECT (object, "DMX_SET_BUFFER_SIZE failed");
@@ -866,6 +948,10 @@ gst_dvbsrc_finalize (GObject * _object)
 
   /* freeing the mutex segfaults somehow */
   g_mutex_free (object->tune_mutex);
+  g_mutex_free (object->ring_lock);
+  g_cond_free (object->ring_cond);
+  g_queue_free (object->ring);
+  g_free (object->dvr_device);
 
   if (G_OBJECT_CLASS (parent_class)->finalize)
     G_OBJECT_CLASS (parent_class)->finalize (_object);
@@ -903,18 +989,94 @@ gst_dvbsrc_plugin_init (GstPlugin * plugin)
       GST_TYPE_DVBSRC);
 }
 
+static GstDvbSrcBufferPool *
+gst_dvbsrc_buffer_pool_new (guint size, guint max_free)
+{
+  GstDvbSrcBufferPool *pool = g_slice_new0 (GstDvbSrcBufferPool);
+
+  pool->refcount = 1;
+  pool->lock = g_mutex_new ();
+  pool->size = size;
+  pool->max_free = max_free;
+
+  return pool;
+}
+
+static void
+gst_dvbsrc_buffer_pool_unref (GstDvbSrcBufferPool * pool)
+{
+  if (!g_atomic_int_dec_and_test (&pool->refcount))
+    return;
+
+  g_slist_foreach (pool->free_blocks, (GFunc) g_free, NULL);
+  g_slist_free (pool->free_blocks);
+  g_mutex_free (pool->lock);
+  g_slice_free (GstDvbSrcBufferPool, pool);
+}
+
+/* free function of the pooled buffers, every block starts with a pointer
+ * to its pool */
+static void
+gst_dvbsrc_buffer_pool_release (gpointer data)
+{
+  guint8 *block = data;
+  GstDvbSrcBufferPool *pool = *((GstDvbSrcBufferPool **) block);
+
+  g_mutex_lock (pool->lock);
+  if (pool->n_free < pool->max_free) {
+    pool->free_blocks = g_slist_prepend (pool->free_blocks, block);
+    pool->n_free++;
+    block = NULL;
+  }
+  g_mutex_unlock (pool->lock);
+
+  g_free (block);
+  gst_dvbsrc_buffer_pool_unref (pool);
+}
+
 static GstBuffer *
-gst_dvbsrc_read_device (GstDvbSrc * object, int size)
+gst_dvbsrc_buffer_pool_acquire (GstDvbSrcBufferPool * pool)
+{
+  GstBuffer *buf;
+  guint8 *block = NULL;
+
+  g_mutex_lock (pool->lock);
+  if (pool->free_blocks) {
+    block = pool->free_blocks->data;
+    pool->free_blocks = g_slist_delete_link (pool->free_blocks,
+        pool->free_blocks);
+    pool->n_free--;
+  }
+  g_mutex_unlock (pool->lock);
+
+  if (block == NULL) {
+    block = g_malloc (POOL_HEADER_SIZE + pool->size);
+    *((GstDvbSrcBufferPool **) block) = pool;
+  }
+  /* every outstanding buffer keeps the pool alive */
+  g_atomic_int_inc (&pool->refcount);
+
+  buf = gst_buffer_new ();
+  GST_BUFFER_MALLOCDATA (buf) = block;
+  GST_BUFFER_FREE_FUNC (buf) = gst_dvbsrc_buffer_pool_release;
+  GST_BUFFER_DATA (buf) = block + POOL_HEADER_SIZE;
+  GST_BUFFER_SIZE (buf) = pool->size;
+
+  return buf;
+}
+
+static GstFlowReturn
+gst_dvbsrc_read_device (GstDvbSrc * object, int size, GstBuffer ** buffer)
 {
   gint count = 0;
   gint ret_val = 0;
-  GstBuffer *buf = gst_buffer_new_and_alloc (size);
+  GstBuffer *buf;
   GstClockTime timeout = object->timeout * GST_USECOND;
 
-  g_return_val_if_fail (GST_IS_BUFFER (buf), NULL);
-
   if (object->fd_dvr < 0)
-    return NULL;
+    return GST_FLOW_ERROR;
+
+  buf = gst_dvbsrc_buffer_pool_acquire (object->pool);
 
   while (count < size) {
     ret_val = gst_poll_wait (object->poll, timeout);
@@ -941,67 +1103,171 @@ gst_dvbsrc_read_device (GstDvbSrc * object, int size)
         gst_element_post_message (GST_ELEMENT_CAST (object),
             gst_message_new_element (GST_OBJECT (object),
                 gst_structure_empty_new ("dvb-read-failure")));
+      } else if (G_UNLIKELY (nread == 0)) {
+        /* only files and FIFOs end, a DVR device just had nothing yet */
+        if (!object->dvr_is_file)
+          continue;
+        if (count == 0)
+          goto eos;
+        break;
       } else
         count = count + nread;
     }
   }
 
   GST_BUFFER_SIZE (buf) = count;
-  return buf;
+  *buffer = buf;
+  return GST_FLOW_OK;
 
 stopped:
   GST_DEBUG_OBJECT (object, "stop called");
   gst_buffer_unref (buf);
-  return NULL;
+  return GST_FLOW_WRONG_STATE;
+
+eos:
+  GST_DEBUG_OBJECT (object, "end of stream");
+  gst_buffer_unref (buf);
+  return GST_FLOW_UNEXPECTED;
 
 select_error:
   GST_ELEMENT_ERROR (object, RESOURCE, READ, (NULL),
       ("select error %d: %s (%d)", ret_val, g_strerror (errno), errno));
   gst_buffer_unref (buf);
+  return GST_FLOW_ERROR;
+}
+
+/* call with the tune mutex */
+static void
+gst_dvbsrc_update_stats (GstDvbSrc * object)
+{
+  if (object->fd_frontend >= 0 && object->stats_interval != 0 &&
+      ++object->stats_counter == object->stats_interval) {
+    gst_dvbsrc_output_frontend_stats (object);
+    object->stats_counter = 0;
+  }
+}
+
+/* stamps a block read ahead with the running time it was captured at, so
+ * the time it waited in the ring doesn't end up in the timestamp */
+static void
+gst_dvbsrc_timestamp_buffer (GstDvbSrc * object, GstBuffer * buf)
+{
+  GstClock *clock;
+  GstClockTime base_time, now;
+
+  GST_OBJECT_LOCK (object);
+  if ((clock = GST_ELEMENT_CLOCK (object)))
+    gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (object)->base_time;
+  GST_OBJECT_UNLOCK (object);
+
+  if (clock == NULL)
+    return;
+
+  now = gst_clock_get_time (clock);
+  if (now >= base_time)
+    GST_BUFFER_TIMESTAMP (buf) = now - base_time;
+  gst_object_unref (clock);
+}
+
+static void
+gst_dvbsrc_flush_ring (GstDvbSrc * object)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (object->ring)))
+    gst_buffer_unref (buf);
+}
+
+static gpointer
+gst_dvbsrc_reader_thread (GstDvbSrc * object)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buf = NULL;
+
+  GST_DEBUG_OBJECT (object, "reader thread started");
+
+  while (ret == GST_FLOW_OK) {
+    /* device can not be tuned during read */
+    g_mutex_lock (object->tune_mutex);
+    ret = gst_dvbsrc_read_device (object, object->blocksize, &buf);
+    gst_dvbsrc_update_stats (object);
+    g_mutex_unlock (object->tune_mutex);
+
+    g_mutex_lock (object->ring_lock);
+    if (!object->reader_running) {
+      g_mutex_unlock (object->ring_lock);
+      if (ret == GST_FLOW_OK)
+        gst_buffer_unref (buf);
+      break;
+    }
+
+    if (ret == GST_FLOW_OK) {
+      gst_dvbsrc_timestamp_buffer (object, buf);
+      if (g_queue_get_length (object->ring) >= object->ring_size) {
+        /* downstream is too slow, keep draining the device anyway */
+        gst_buffer_unref (g_queue_pop_head (object->ring));
+        object->ring_dropped++;
+        GST_WARNING_OBJECT (object, "ring full, dropped %" G_GUINT64_FORMAT
+            " blocks so far", object->ring_dropped);
+      }
+      g_queue_push_tail (object->ring, buf);
+    } else {
+      object->ring_ret = ret;
+    }
+    g_cond_signal (object->ring_cond);
+    g_mutex_unlock (object->ring_lock);
+  }
+
+  GST_DEBUG_OBJECT (object, "reader thread stopped: %s",
+      gst_flow_get_name (ret));
+
   return NULL;
 }
 
 static GstFlowReturn
 gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
 {
-  gint buffer_size;
   GstFlowReturn retval = GST_FLOW_ERROR;
   GstDvbSrc *object;
 
   object = GST_DVBSRC (element);
   GST_LOG ("fd_dvr: %d", object->fd_dvr);
 
-  //g_object_get(G_OBJECT(object), "blocksize", &buffer_size, NULL);
-  buffer_size = DEFAULT_BUFFER_SIZE;
-
-  /* device can not be tuned during read */
-  g_mutex_lock (object->tune_mutex);
-
-
-  if (object->fd_dvr > -1) {
-    /* --- Read TS from DVR device --- */
-    GST_DEBUG_OBJECT (object, "Reading from DVR device");
-    *buf = gst_dvbsrc_read_device (object, buffer_size);
-    if (*buf != NULL) {
-      GstCaps *caps;
-
+  if (object->reader) {
+    /* --- Take TS read ahead by the reader thread --- */
+    g_mutex_lock (object->ring_lock);
+    while (g_queue_is_empty (object->ring) && !object->ring_flushing &&
+        object->ring_ret == GST_FLOW_OK)
+      g_cond_wait (object->ring_cond, object->ring_lock);
+
+    if (object->ring_flushing) {
+      retval = GST_FLOW_WRONG_STATE;
+    } else if (!g_queue_is_empty (object->ring)) {
+      *buf = g_queue_pop_head (object->ring);
       retval = GST_FLOW_OK;
-
-      caps = gst_pad_get_caps (GST_BASE_SRC_PAD (object));
-      gst_buffer_set_caps (*buf, caps);
-      gst_caps_unref (caps);
+    } else {
+      retval = object->ring_ret;
     }
-
-    if (object->stats_interval != 0 &&
-        ++object->stats_counter == object->stats_interval) {
-      gst_dvbsrc_output_frontend_stats (object);
-      object->stats_counter = 0;
+    g_mutex_unlock (object->ring_lock);
+  } else {
+    /* device can not be tuned during read */
+    g_mutex_lock (object->tune_mutex);
+
+    if (object->fd_dvr > -1) {
+      /* --- Read TS from DVR device --- */
+      GST_DEBUG_OBJECT (object, "Reading from DVR device");
+      retval = gst_dvbsrc_read_device (object, object->blocksize, buf);
+      gst_dvbsrc_update_stats (object);
     }
+
+    g_mutex_unlock (object->tune_mutex);
   }
 
-  g_mutex_unlock (object->tune_mutex);
-  return retval;
+  if (retval == GST_FLOW_OK)
+    gst_buffer_set_caps (*buf, object->caps);
 
+  return retval;
 }
 
 static GstStateChangeReturn
@@ -1016,9 +1282,12 @@ gst_dvbsrc_change_state (GstElement * element, GstStateChange transition)
   switch (transition) {
     case GST_STATE_CHANGE_NULL_TO_READY:
       /* open frontend then close it again, just so caps sent */
-      gst_dvbsrc_open_frontend (src);
-      if (src->fd_frontend) {
-        close (src->fd_frontend);
+      if (src->dvr_device == NULL) {
+        gst_dvbsrc_open_frontend (src);
+        if (src->fd_frontend) {
+          close (src->fd_frontend);
+        }
+        src->fd_frontend = -1;
       }
       break;
     default:
@@ -1033,18 +1302,21 @@ static gboolean
 gst_dvbsrc_start (GstBaseSrc * bsrc)
 {
   GstDvbSrc *src = GST_DVBSRC (bsrc);
+  guint blocksize;
 
-  gst_dvbsrc_open_frontend (src);
-  if (!gst_dvbsrc_tune (src)) {
-    GST_ERROR_OBJECT (src, "Not able to lock on to the dvb channel");
-    close (src->fd_frontend);
-    return FALSE;
-  }
-  if (!gst_dvbsrc_frontend_status (src)) {
-    /* unset filters also */
-    gst_dvbsrc_unset_pes_filters (src);
-    close (src->fd_frontend);
-    return FALSE;
+  if (src->dvr_device == NULL) {
+    gst_dvbsrc_open_frontend (src);
+    if (!gst_dvbsrc_tune (src)) {
+      GST_ERROR_OBJECT (src, "Not able to lock on to the dvb channel");
+      close (src->fd_frontend);
+      return FALSE;
+    }
+    if (!gst_dvbsrc_frontend_status (src)) {
+      /* unset filters also */
+      gst_dvbsrc_unset_pes_filters (src);
+      close (src->fd_frontend);
+      return FALSE;
+    }
   }
   if (!gst_dvbsrc_open_dvr (src)) {
     GST_ERROR_OBJECT (src, "Not able to open dvr_device");
@@ -1067,6 +1339,35 @@ gst_dvbsrc_start (GstBaseSrc * bsrc)
     gst_poll_fd_ctl_read (src->poll, &src->poll_fd_dvr, TRUE);
   }
 
+  /* only ever hand out whole packets */
+  blocksize = gst_base_src_get_blocksize (bsrc);
+  src->blocksize = MAX (blocksize - blocksize % TS_SIZE, TS_SIZE);
+  if (src->blocksize != blocksize)
+    GST_WARNING_OBJECT (src, "blocksize %u is not a multiple of %d, using %u",
+        blocksize, TS_SIZE, src->blocksize);
+
+  src->caps = gst_pad_get_caps (GST_BASE_SRC_PAD (src));
+  src->pool = gst_dvbsrc_buffer_pool_new (src->blocksize,
+      src->ring_size + POOL_EXTRA_BLOCKS);
+
+  if (src->ring_size > 0) {
+    GError *err = NULL;
+
+    src->reader_running = TRUE;
+    src->ring_flushing = FALSE;
+    src->ring_ret = GST_FLOW_OK;
+    src->ring_dropped = 0;
+    src->reader = g_thread_create ((GThreadFunc) gst_dvbsrc_reader_thread,
+        src, TRUE, &err);
+    if (src->reader == NULL) {
+      GST_ELEMENT_ERROR (src, RESOURCE, FAILED, (NULL),
+          ("could not create reader thread: %s", err->message));
+      g_error_free (err);
+      gst_dvbsrc_stop (bsrc);
+      return FALSE;
+    }
+  }
+
   return TRUE;
 }
 
@@ -1075,11 +1376,33 @@ gst_dvbsrc_stop (GstBaseSrc * bsrc)
 {
   GstDvbSrc *src = GST_DVBSRC (bsrc);
 
+  if (src->reader) {
+    g_mutex_lock (src->ring_lock);
+    src->reader_running = FALSE;
+    g_mutex_unlock (src->ring_lock);
+
+    /* wakes up the reader if it is waiting for data */
+    gst_poll_set_flushing (src->poll, TRUE);
+    g_thread_join (src->reader);
+    src->reader = NULL;
+
+    gst_dvbsrc_flush_ring (src);
+  }
+
   gst_dvbsrc_close_devices (src);
   if (src->poll) {
     gst_poll_free (src->poll);
     src->poll = NULL;
   }
+  if (src->caps) {
+    gst_caps_unref (src->caps);
+    src->caps = NULL;
+  }
+  /* buffers still used downstream keep the pool alive */
+  if (src->pool) {
+    gst_dvbsrc_buffer_pool_unref (src->pool);
+    src->pool = NULL;
+  }
 
   return TRUE;
 }
@@ -1089,7 +1412,17 @@ gst_dvbsrc_unlock (GstBaseSrc * bsrc)
 {
   GstDvbSrc *src = GST_DVBSRC (bsrc);
 
-  gst_poll_set_flushing (src->poll, TRUE);
+  if (src->reader) {
+    /* the reader keeps draining the device, only wake up create () and
+     * drop what is stale by now */
+    g_mutex_lock (src->ring_lock);
+    src->ring_flushing = TRUE;
+    gst_dvbsrc_flush_ring (src);
+    g_cond_signal (src->ring_cond);
+    g_mutex_unlock (src->ring_lock);
+  } else {
+    gst_poll_set_flushing (src->poll, TRUE);
+  }
   return TRUE;
 }
 
@@ -1098,7 +1431,13 @@ gst_dvbsrc_unlock_stop (GstBaseSrc * bsrc)
 {
   GstDvbSrc *src = GST_DVBSRC (bsrc);
 
-  gst_poll_set_flushing (src->poll, FALSE);
+  if (src->reader) {
+    g_mutex_lock (src->ring_lock);
+    src->ring_flushing = FALSE;
+    g_mutex_unlock (src->ring_lock);
+  } else {
+    gst_poll_set_flushing (src->poll, FALSE);
+  }
   return TRUE;
 }
 
@@ -35,6 +35,7 @@ G_BEGIN_DECLS
   typedef struct _GstDvbSrc GstDvbSrc;
   typedef struct _GstDvbSrcClass GstDvbSrcClass;
   typedef struct _GstDvbSrcParam GstDvbSrcParam;
+  typedef struct _GstDvbSrcBufferPool GstDvbSrcBufferPool;
 
   struct _GstDvbSrc
   {
@@ -75,6 +76,23 @@ G_BEGIN_DECLS
     GstDvbSrcPol pol;
     guint stats_interval;
     guint stats_counter;
+
+    gchar *dvr_device;          /* overrides the adapter's DVR device */
+    gboolean dvr_is_file;       /* dvr_device is a file or FIFO, which end */
+    guint blocksize;            /* multiple of TS_SIZE, fixed in start () */
+    GstCaps *caps;
+    GstDvbSrcBufferPool *pool;
+
+    /* optional reader thread filling a bounded ring of blocks */
+    guint ring_size;
+    GThread *reader;
+    GMutex *ring_lock;
+    GCond *ring_cond;
+    GQueue *ring;
+    gboolean reader_running;
+    gboolean ring_flushing;
+    GstFlowReturn ring_ret;
+    guint64 ring_dropped;
   };
 
   struct _GstDvbSrcClass
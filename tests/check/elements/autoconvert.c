@@ -153,6 +153,76 @@ GST_START_TEST (test_autoconvert_simple)
 
 GST_END_TEST;
 
+/* creates an autoconvert and negotiates type=1 caps through it */
+static void
+negotiate_once (void)
+{
+  GstPad *test_src_pad, *test_sink_pad;
+  GstElement *autoconvert = gst_check_setup_element ("autoconvert");
+  GstBuffer *buf;
+  GstCaps *caps;
+
+  set_autoconvert_factories (autoconvert);
+
+  test_src_pad = gst_check_setup_src_pad (autoconvert, &src_factory, NULL);
+  gst_pad_set_active (test_src_pad, TRUE);
+  test_sink_pad = gst_check_setup_sink_pad (autoconvert, &sink_factory, NULL);
+  gst_pad_set_active (test_sink_pad, TRUE);
+
+  gst_element_set_state (GST_ELEMENT_CAST (autoconvert), GST_STATE_PLAYING);
+
+  caps = gst_caps_from_string ("test/caps,type=(int)1");
+  buf = gst_buffer_new_and_alloc (4096);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  fail_unless (gst_pad_push (test_src_pad, buf) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  gst_check_drop_buffers ();
+
+  gst_element_set_state ((GstElement *) autoconvert, GST_STATE_NULL);
+
+  gst_pad_set_active (test_src_pad, FALSE);
+  gst_pad_set_active (test_sink_pad, FALSE);
+  gst_check_teardown_src_pad (autoconvert);
+  gst_check_teardown_sink_pad (autoconvert);
+  gst_check_teardown_element (autoconvert);
+}
+
+static void
+get_cache_counters (guint * hits, guint * misses)
+{
+  GstElement *autoconvert = gst_element_factory_make ("autoconvert", NULL);
+
+  g_object_get (autoconvert, "cache-hits", hits, "cache-misses", misses,
+      NULL);
+  gst_object_unref (autoconvert);
+}
+
+GST_START_TEST (test_autoconvert_cache)
+{
+  guint hits, misses, new_hits, new_misses;
+
+  get_cache_counters (&hits, &misses);
+
+  /* the cache is process-wide, so this is only cold if no other test ran
+   * in this process */
+  negotiate_once ();
+  get_cache_counters (&new_hits, &new_misses);
+  fail_unless_equals_int (new_hits + new_misses, hits + misses + 1);
+
+  /* a new instance with the same caps has to reuse the selected element */
+  hits = new_hits;
+  misses = new_misses;
+  negotiate_once ();
+  get_cache_counters (&new_hits, &new_misses);
+  fail_unless_equals_int (new_hits, hits + 1);
+  fail_unless_equals_int (new_misses, misses);
+}
+
+GST_END_TEST;
+
 static Suite *
 autoconvert_suite (void)
 {
@@ -162,6 +232,7 @@ autoconvert_suite (void)
   suite_add_tcase (s, tc_basic);
   tcase_add_checked_fixture (tc_basic, setup, teardown);
   tcase_add_test (tc_basic, test_autoconvert_simple);
+  tcase_add_test (tc_basic, test_autoconvert_cache);
 
   return s;
 }
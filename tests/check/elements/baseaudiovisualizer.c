@@ -78,10 +78,51 @@ gst_test_scope_base_init (gpointer g_class)
       &gst_test_scope_sink_template);
 }
 
+/* results of the analysis checks done in render() */
+static guint render_count = 0;
+static gboolean analysis_ok = TRUE;
+
+static gboolean
+gst_test_scope_render (GstBaseAudioVisualizer * scope, GstBuffer * audio,
+    GstBuffer * video)
+{
+  const gint16 *adata = (const gint16 *) GST_BUFFER_DATA (audio);
+  const gint16 *mono, *left, *right;
+  const GstFFTS16Complex *fl, *fr;
+  guint i, n = scope->req_spf;
+  gint v;
+
+  mono = gst_base_audio_visualizer_get_mono_samples (scope, audio);
+  /* a second call must hand out the cached data */
+  if (gst_base_audio_visualizer_get_mono_samples (scope, audio) != mono)
+    analysis_ok = FALSE;
+
+  gst_base_audio_visualizer_get_stereo_samples (scope, audio, &left, &right);
+  for (i = 0; i < n; i++) {
+    if (left[i] != adata[2 * i] || right[i] != adata[2 * i + 1])
+      analysis_ok = FALSE;
+    v = (adata[2 * i] + adata[2 * i + 1]) >> 1;
+    if (mono[i] != ((v * scope->window[i]) >> 15))
+      analysis_ok = FALSE;
+  }
+
+  if (gst_base_audio_visualizer_get_mono_spectrum (scope, audio) == NULL)
+    analysis_ok = FALSE;
+  gst_base_audio_visualizer_get_stereo_spectrum (scope, audio, &fl, &fr);
+  if (fl == NULL || fr == NULL)
+    analysis_ok = FALSE;
+
+  render_count++;
+  return TRUE;
+}
+
 static void
 gst_test_scope_class_init (GstTestScopeClass * g_class)
 {
-  /* do nothing */
+  GstBaseAudioVisualizerClass *scope_class =
+      (GstBaseAudioVisualizerClass *) g_class;
+
+  scope_class->render = gst_test_scope_render;
 }
 
 static void
@@ -159,6 +200,54 @@ GST_START_TEST (count_in_out)
 
 GST_END_TEST;
 
+GST_START_TEST (analysis_buffers)
+{
+  GstElement *elem;
+  GstPad *srcpad, *sinkpad;
+  GstBuffer *buffer;
+  gint16 *adata;
+  guint i;
+
+  /* setup up */
+  elem = gst_check_setup_element ("testscope");
+  srcpad = gst_check_setup_src_pad (elem, &srctemplate, NULL);
+  sinkpad = gst_check_setup_sink_pad (elem, &sinktemplate, NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  fail_unless (gst_element_set_state (elem,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  render_count = 0;
+  analysis_ok = TRUE;
+
+  /* push 1s of a sawtooth with different left and right channels */
+  buffer = gst_buffer_new_and_alloc (44100 * 2 * sizeof (gint16));
+  adata = (gint16 *) GST_BUFFER_DATA (buffer);
+  for (i = 0; i < 44100; i++) {
+    adata[2 * i] = (i * 64) & 0x7fff;
+    adata[2 * i + 1] = -((i * 32) & 0x7fff);
+  }
+  gst_buffer_set_caps (buffer, GST_PAD_CAPS (srcpad));
+  fail_unless (gst_pad_push (srcpad, buffer) == GST_FLOW_OK);
+
+  fail_unless_equals_int (render_count, 30);
+  fail_unless (analysis_ok);
+
+  /* clean up */
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_check_teardown_src_pad (elem);
+  gst_check_teardown_sink_pad (elem);
+  gst_check_teardown_element (elem);
+}
+
+GST_END_TEST;
+
 static void
 baseaudiovisualizer_init (void)
 {
@@ -175,6 +264,7 @@ baseaudiovisualizer_suite (void)
   tcase_add_checked_fixture (tc_chain, baseaudiovisualizer_init, NULL);
 
   tcase_add_test (tc_chain, count_in_out);
+  tcase_add_test (tc_chain, analysis_buffers);
 
   return s;
 }
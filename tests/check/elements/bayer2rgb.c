@@ -0,0 +1,270 @@
+/* GStreamer unit tests for bayer2rgb
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <math.h>
+#include <string.h>
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-bayer"));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_BGRx));
+
+/* diagonal stripes with the three colours following the same luminance, as
+ * they mostly do in natural images */
+static void
+scene (gint x, gint y, gint * r, gint * g, gint * b)
+{
+  gint l = (((x + 2 * y) / 7) & 1) ? 200 : 40;
+
+  *r = l;
+  *g = l * 3 / 4 + 30;
+  *b = l / 2 + 60;
+}
+
+/* a BGGR mosaic of the scene, with 16 bit samples of the given depth if
+ * depth > 8 */
+static GstBuffer *
+make_frame (gint width, gint height, gint depth)
+{
+  GstBuffer *buf;
+  gint x, y;
+
+  buf = gst_buffer_new_and_alloc (depth > 8 ? width * height * 2 :
+      GST_ROUND_UP_4 (width) * height);
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      gint r, g, b, v;
+
+      scene (x, y, &r, &g, &b);
+      if (y & 1)
+        v = (x & 1) ? r : g;
+      else
+        v = (x & 1) ? g : b;
+
+      /* the bits below the 8 most significant ones must not matter */
+      if (depth > 8)
+        ((guint16 *) GST_BUFFER_DATA (buf))[y * width + x] =
+            (v << (depth - 8)) | ((x * 7 + y) & ((1 << (depth - 8)) - 1));
+      else
+        GST_BUFFER_DATA (buf)[y * width + x] = v;
+    }
+  }
+
+  return buf;
+}
+
+static void
+set_enum (GstElement * element, const gchar * name, const gchar * nick)
+{
+  GParamSpec *pspec;
+  GEnumValue *value;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+  fail_unless (pspec != NULL);
+  value = g_enum_get_value_by_nick (G_PARAM_SPEC_ENUM (pspec)->enum_class,
+      nick);
+  fail_unless (value != NULL, "no value %s for %s", nick, name);
+  g_object_set (element, name, value->value, NULL);
+}
+
+/* converts @n_frames frames of the scene and returns the last output frame */
+static GstBuffer *
+convert (const gchar * method, guint n_threads, gint width, gint height,
+    gint depth, guint n_frames)
+{
+  GstElement *bayer2rgb;
+  GstCaps *caps;
+  GstBuffer *frame, *out;
+  guint i;
+
+  bayer2rgb = gst_check_setup_element ("bayer2rgb");
+  set_enum (bayer2rgb, "method", method);
+  g_object_set (bayer2rgb, "n-threads", n_threads, NULL);
+  mysrcpad = gst_check_setup_src_pad (bayer2rgb, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (bayer2rgb, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (bayer2rgb,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_simple ("video/x-raw-bayer",
+      "format", G_TYPE_STRING, "bggr",
+      "width", G_TYPE_INT, width, "height", G_TYPE_INT, height,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  if (depth > 8)
+    gst_caps_set_simple (caps, "bpp", G_TYPE_INT, 16, "depth", G_TYPE_INT,
+        depth, "endianness", G_TYPE_INT, G_BYTE_ORDER, NULL);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+
+  frame = make_frame (width, height, depth);
+  gst_buffer_set_caps (frame, caps);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < n_frames; i++) {
+    fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (frame)),
+        GST_FLOW_OK);
+    /* only keep the last output frame around */
+    if (i + 1 < n_frames)
+      gst_check_drop_buffers ();
+  }
+  gst_buffer_unref (frame);
+
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  out = gst_buffer_ref (GST_BUFFER (buffers->data));
+  fail_unless_equals_int (GST_BUFFER_SIZE (out), width * height * 4);
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (bayer2rgb, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (bayer2rgb);
+  gst_check_teardown_sink_pad (bayer2rgb);
+  gst_check_teardown_element (bayer2rgb);
+
+  return out;
+}
+
+/* peak signal to noise ratio of a BGRx frame against the scene, without
+ * the two pixels wide border */
+static gdouble
+psnr (GstBuffer * buf, gint width, gint height)
+{
+  gdouble se = 0;
+  gint x, y, n = 0;
+
+  for (y = 2; y < height - 2; y++) {
+    for (x = 2; x < width - 2; x++) {
+      const guint8 *p = GST_BUFFER_DATA (buf) + (y * width + x) * 4;
+      gint r, g, b;
+
+      scene (x, y, &r, &g, &b);
+      se += (p[0] - b) * (p[0] - b) + (p[1] - g) * (p[1] - g) +
+          (p[2] - r) * (p[2] - r);
+      n += 3;
+    }
+  }
+
+  return 10 * log10 (255.0 * 255.0 * n / MAX (se, 1));
+}
+
+static void
+assert_same_frame (GstBuffer * a, GstBuffer * b)
+{
+  fail_unless_equals_int (GST_BUFFER_SIZE (a), GST_BUFFER_SIZE (b));
+  fail_unless (memcmp (GST_BUFFER_DATA (a), GST_BUFFER_DATA (b),
+          GST_BUFFER_SIZE (a)) == 0);
+}
+
+static const gchar *methods[] = { "bilinear", "malvar" };
+
+/* the threads must not change the output, whatever the band boundaries */
+GST_START_TEST (test_threads)
+{
+  static const gint heights[] = { 240, 37, 5 };
+  guint m, h, n_threads;
+
+  for (m = 0; m < G_N_ELEMENTS (methods); m++) {
+    for (h = 0; h < G_N_ELEMENTS (heights); h++) {
+      GstBuffer *reference;
+
+      reference = convert (methods[m], 1, 320, heights[h], 8, 2);
+      for (n_threads = 2; n_threads <= 8; n_threads += 3) {
+        GstBuffer *threaded;
+
+        threaded = convert (methods[m], n_threads, 320, heights[h], 8, 2);
+        assert_same_frame (threaded, reference);
+        gst_buffer_unref (threaded);
+      }
+      gst_buffer_unref (reference);
+    }
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_malvar_quality)
+{
+  GstBuffer *bilinear, *malvar;
+  gdouble bilinear_psnr, malvar_psnr;
+
+  bilinear = convert ("bilinear", 1, 320, 240, 8, 1);
+  malvar = convert ("malvar", 1, 320, 240, 8, 1);
+
+  bilinear_psnr = psnr (bilinear, 320, 240);
+  malvar_psnr = psnr (malvar, 320, 240);
+  GST_INFO ("PSNR bilinear %.2f dB, malvar %.2f dB", bilinear_psnr,
+      malvar_psnr);
+  fail_unless (malvar_psnr > bilinear_psnr + 1.0,
+      "malvar %.2f dB, bilinear %.2f dB", malvar_psnr, bilinear_psnr);
+
+  gst_buffer_unref (bilinear);
+  gst_buffer_unref (malvar);
+}
+
+GST_END_TEST;
+
+/* deep input gives the same frame as its 8 most significant bits */
+GST_START_TEST (test_16bit_input)
+{
+  static const gint depths[] = { 10, 12, 16 };
+  guint m, d;
+
+  for (m = 0; m < G_N_ELEMENTS (methods); m++) {
+    GstBuffer *reference;
+
+    reference = convert (methods[m], 1, 320, 240, 8, 1);
+    for (d = 0; d < G_N_ELEMENTS (depths); d++) {
+      GstBuffer *deep;
+
+      deep = convert (methods[m], 2, 320, 240, depths[d], 1);
+      assert_same_frame (deep, reference);
+      gst_buffer_unref (deep);
+    }
+    gst_buffer_unref (reference);
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+bayer2rgb_suite (void)
+{
+  Suite *s = suite_create ("bayer2rgb");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_threads);
+  tcase_add_test (tc_chain, test_malvar_quality);
+  tcase_add_test (tc_chain, test_16bit_input);
+
+  return s;
+}
+
+GST_CHECK_MAIN (bayer2rgb);
@@ -0,0 +1,167 @@
+/* GStreamer unit tests for the cog elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <string.h>
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420") ";" GST_VIDEO_CAPS_BGRx));
+
+/* the output caps are fixed on the pad for each test */
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420") ";" GST_VIDEO_CAPS_BGRx));
+
+/* a frame different in every byte */
+static GstBuffer *
+make_frame (GstCaps * caps)
+{
+  GstVideoFormat format;
+  GstBuffer *buf;
+  GRand *rand;
+  gint width, height;
+  guint i;
+
+  fail_unless (gst_video_format_parse_caps (caps, &format, &width, &height));
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size (format, width,
+          height));
+  rand = g_rand_new_with_seed (width * height);
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i++)
+    GST_BUFFER_DATA (buf)[i] = g_rand_int (rand);
+  g_rand_free (rand);
+  gst_buffer_set_caps (buf, caps);
+
+  return buf;
+}
+
+/* pushes a frame of @incaps through @name set to @n_threads threads and
+ * returns the output frame, which has @outcaps */
+static GstBuffer *
+convert (const gchar * name, GstCaps * incaps, GstCaps * outcaps,
+    guint n_threads)
+{
+  GstElement *element;
+  GstBuffer *out;
+
+  element = gst_check_setup_element (name);
+  g_object_set (element, "n-threads", n_threads, NULL);
+  mysrcpad = gst_check_setup_src_pad (element, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (element, &sinktemplate, outcaps);
+  gst_pad_use_fixed_caps (mysinkpad);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (element,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  fail_unless (gst_pad_set_caps (mysrcpad, incaps));
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_frame (incaps)),
+      GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  out = gst_buffer_ref (GST_BUFFER (buffers->data));
+  fail_unless (gst_caps_is_equal (GST_BUFFER_CAPS (out), outcaps));
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (element, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (element);
+  gst_check_teardown_sink_pad (element);
+  gst_check_teardown_element (element);
+
+  return out;
+}
+
+static void
+assert_same_frame (GstBuffer * a, GstBuffer * b)
+{
+  fail_unless_equals_int (GST_BUFFER_SIZE (a), GST_BUFFER_SIZE (b));
+  fail_unless (memcmp (GST_BUFFER_DATA (a), GST_BUFFER_DATA (b),
+          GST_BUFFER_SIZE (a)) == 0);
+}
+
+/* the bands must not change the output, whatever their boundaries */
+static void
+check_threads (const gchar * name, GstVideoFormat in_format, gint in_width,
+    gint in_height, GstVideoFormat out_format, gint out_width, gint out_height)
+{
+  GstCaps *incaps, *outcaps;
+  GstBuffer *reference;
+  guint n_threads;
+
+  incaps = gst_video_format_new_caps (in_format, in_width, in_height, 25, 1,
+      1, 1);
+  outcaps = gst_video_format_new_caps (out_format, out_width, out_height, 25,
+      1, 1, 1);
+
+  reference = convert (name, incaps, outcaps, 1);
+  for (n_threads = 2; n_threads <= 8; n_threads += 3) {
+    GstBuffer *threaded;
+
+    threaded = convert (name, incaps, outcaps, n_threads);
+    assert_same_frame (threaded, reference);
+    gst_buffer_unref (threaded);
+  }
+  gst_buffer_unref (reference);
+
+  gst_caps_unref (incaps);
+  gst_caps_unref (outcaps);
+}
+
+GST_START_TEST (test_cogscale_threads)
+{
+  check_threads ("cogscale", GST_VIDEO_FORMAT_I420, 320, 240,
+      GST_VIDEO_FORMAT_I420, 212, 118);
+  check_threads ("cogscale", GST_VIDEO_FORMAT_I420, 212, 118,
+      GST_VIDEO_FORMAT_I420, 320, 241);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cogcolorspace_threads)
+{
+  check_threads ("cogcolorspace", GST_VIDEO_FORMAT_BGRx, 320, 242,
+      GST_VIDEO_FORMAT_I420, 320, 242);
+  check_threads ("cogcolorspace", GST_VIDEO_FORMAT_I420, 320, 242,
+      GST_VIDEO_FORMAT_BGRx, 320, 242);
+}
+
+GST_END_TEST;
+
+static Suite *
+cog_suite (void)
+{
+  Suite *s = suite_create ("cog");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_cogscale_threads);
+  tcase_add_test (tc_chain, test_cogcolorspace_threads);
+
+  return s;
+}
+
+GST_CHECK_MAIN (cog);
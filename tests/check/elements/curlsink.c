@@ -0,0 +1,342 @@
+/* GStreamer unit test for curlsink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <gst/check/gstcheck.h>
+
+#define BUFFER_SIZE 4096
+#define N_BUFFERS 64
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* a minimal HTTP/1.1 server on the loopback interface that accepts
+ * chunked uploads and keeps connections alive */
+typedef struct
+{
+  gint listen_fd;
+  guint16 port;
+  GThread *thread;
+  GMutex *lock;
+  gint n_connections;
+  gint n_requests;
+  guint64 n_bytes;
+  guint32 checksum;
+  gchar *last_file_name;
+} TestServer;
+
+static TestServer server;
+
+static gchar *
+server_read_line (gint fd)
+{
+  GString *line = g_string_new (NULL);
+  gchar c;
+
+  while (read (fd, &c, 1) == 1) {
+    if (c == '\n') {
+      if (line->len > 0 && line->str[line->len - 1] == '\r')
+        g_string_truncate (line, line->len - 1);
+      return g_string_free (line, FALSE);
+    }
+    g_string_append_c (line, c);
+  }
+
+  g_string_free (line, TRUE);
+  return NULL;
+}
+
+static gboolean
+server_read_body (gint fd, gsize len)
+{
+  guint8 data[1024];
+
+  while (len > 0) {
+    gssize n = read (fd, data, MIN (len, sizeof (data)));
+    gsize i;
+
+    if (n <= 0)
+      return FALSE;
+    g_mutex_lock (server.lock);
+    for (i = 0; i < n; i++)
+      server.checksum = server.checksum * 31 + data[i];
+    server.n_bytes += n;
+    g_mutex_unlock (server.lock);
+    len -= n;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+server_handle_request (gint fd)
+{
+  static const gchar continue_reply[] = "HTTP/1.1 100 Continue\r\n\r\n";
+  static const gchar ok_reply[] =
+      "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+  gboolean chunked = FALSE, expect = FALSE;
+  gsize content_length = 0;
+  gchar *line;
+
+  /* request line */
+  if ((line = server_read_line (fd)) == NULL)
+    return FALSE;
+  fail_unless (g_str_has_prefix (line, "POST "), "unexpected request %s",
+      line);
+  g_free (line);
+
+  /* headers */
+  while ((line = server_read_line (fd)) != NULL && *line != '\0') {
+    gchar *filename;
+
+    if (g_ascii_strncasecmp (line, "Transfer-Encoding: chunked", 26) == 0)
+      chunked = TRUE;
+    else if (g_ascii_strncasecmp (line, "Content-Length:", 15) == 0)
+      content_length = strtoul (line + 15, NULL, 10);
+    else if (g_ascii_strncasecmp (line, "Expect: 100-continue", 20) == 0)
+      expect = TRUE;
+    else if ((filename = strstr (line, "filename=\"")) != NULL) {
+      g_mutex_lock (server.lock);
+      g_free (server.last_file_name);
+      server.last_file_name = g_strndup (filename + 10,
+          strcspn (filename + 10, "\""));
+      g_mutex_unlock (server.lock);
+    }
+    g_free (line);
+  }
+  if (line == NULL)
+    return FALSE;
+  g_free (line);
+
+  if (expect)
+    fail_unless (write (fd, continue_reply, strlen (continue_reply)) > 0);
+
+  if (chunked) {
+    gsize len;
+
+    do {
+      if ((line = server_read_line (fd)) == NULL)
+        return FALSE;
+      len = strtoul (line, NULL, 16);
+      g_free (line);
+      if (!server_read_body (fd, len))
+        return FALSE;
+      /* CRLF after the chunk data */
+      g_free (server_read_line (fd));
+    } while (len > 0);
+  } else if (!server_read_body (fd, content_length)) {
+    return FALSE;
+  }
+
+  g_mutex_lock (server.lock);
+  server.n_requests++;
+  g_mutex_unlock (server.lock);
+
+  fail_unless (write (fd, ok_reply, strlen (ok_reply)) > 0);
+
+  return TRUE;
+}
+
+static gpointer
+server_thread_func (gpointer data)
+{
+  gint fd;
+
+  while ((fd = accept (server.listen_fd, NULL, NULL)) >= 0) {
+    g_mutex_lock (server.lock);
+    server.n_connections++;
+    g_mutex_unlock (server.lock);
+
+    while (server_handle_request (fd));
+    close (fd);
+  }
+
+  return NULL;
+}
+
+static void
+server_start (void)
+{
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof (addr);
+
+  memset (&server, 0, sizeof (server));
+  server.lock = g_mutex_new ();
+
+  server.listen_fd = socket (AF_INET, SOCK_STREAM, 0);
+  fail_unless (server.listen_fd >= 0);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  fail_unless (bind (server.listen_fd, (struct sockaddr *) &addr,
+          sizeof (addr)) == 0);
+  fail_unless (listen (server.listen_fd, 4) == 0);
+  fail_unless (getsockname (server.listen_fd, (struct sockaddr *) &addr,
+          &addr_len) == 0);
+  server.port = ntohs (addr.sin_port);
+
+  server.thread = g_thread_create (server_thread_func, NULL, TRUE, NULL);
+  fail_unless (server.thread != NULL);
+}
+
+static void
+server_stop (void)
+{
+  /* makes accept () return */
+  shutdown (server.listen_fd, SHUT_RDWR);
+  close (server.listen_fd);
+  g_thread_join (server.thread);
+  g_mutex_free (server.lock);
+  g_free (server.last_file_name);
+}
+
+static GstElement *
+setup_curlsink (void)
+{
+  GstElement *curlsink;
+  gchar *url;
+
+  GST_DEBUG ("setup_curlsink");
+  curlsink = gst_check_setup_element ("curlsink");
+  mysrcpad = gst_check_setup_src_pad (curlsink, &srctemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  url = g_strdup_printf ("http://127.0.0.1:%u/", server.port);
+  g_object_set (curlsink, "location", url, "file-name", "first.bin",
+      "content-type", "application/octet-stream", "sync", FALSE, NULL);
+  g_free (url);
+
+  return curlsink;
+}
+
+static void
+cleanup_curlsink (GstElement * curlsink)
+{
+  GST_DEBUG ("cleanup_curlsink");
+  gst_element_set_state (curlsink, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (curlsink);
+  gst_check_teardown_element (curlsink);
+}
+
+static guint32
+push_buffers (guint first, guint n, guint32 checksum)
+{
+  guint i, j;
+
+  for (i = first; i < first + n; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (BUFFER_SIZE);
+
+    for (j = 0; j < BUFFER_SIZE; j++) {
+      GST_BUFFER_DATA (buf)[j] = (i + j) & 0xff;
+      checksum = checksum * 31 + GST_BUFFER_DATA (buf)[j];
+    }
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_MSECOND;
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+
+  return checksum;
+}
+
+GST_START_TEST (test_upload)
+{
+  GstElement *curlsink;
+  guint32 checksum;
+
+  server_start ();
+  curlsink = setup_curlsink ();
+  /* smaller than the data, render has to wait for the transfer thread */
+  g_object_set (curlsink, "max-queue-bytes", 4 * BUFFER_SIZE, NULL);
+  fail_unless_equals_int (gst_element_set_state (curlsink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  checksum = push_buffers (0, N_BUFFERS, 0);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  g_mutex_lock (server.lock);
+  fail_unless_equals_int (server.n_requests, 1);
+  fail_unless_equals_uint64 (server.n_bytes, N_BUFFERS * BUFFER_SIZE);
+  fail_unless_equals_int (server.checksum, checksum);
+  fail_unless_equals_string (server.last_file_name, "first.bin");
+  g_mutex_unlock (server.lock);
+
+  cleanup_curlsink (curlsink);
+  server_stop ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_connection_reuse)
+{
+  GstElement *curlsink;
+  guint32 checksum;
+
+  server_start ();
+  curlsink = setup_curlsink ();
+  g_object_set (curlsink, "max-queue-time", 5 * GST_MSECOND, NULL);
+  fail_unless_equals_int (gst_element_set_state (curlsink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  checksum = push_buffers (0, N_BUFFERS / 2, 0);
+  /* waits for the first file to be sent before switching */
+  g_object_set (curlsink, "file-name", "second.bin", NULL);
+  checksum = push_buffers (N_BUFFERS / 2, N_BUFFERS / 2, checksum);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  g_mutex_lock (server.lock);
+  fail_unless_equals_int (server.n_requests, 2);
+  fail_unless_equals_int (server.n_connections, 1);
+  fail_unless_equals_uint64 (server.n_bytes, N_BUFFERS * BUFFER_SIZE);
+  fail_unless_equals_int (server.checksum, checksum);
+  fail_unless_equals_string (server.last_file_name, "second.bin");
+  g_mutex_unlock (server.lock);
+
+  cleanup_curlsink (curlsink);
+  server_stop ();
+}
+
+GST_END_TEST;
+
+static Suite *
+curlsink_suite (void)
+{
+  Suite *s = suite_create ("curlsink");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_upload);
+  tcase_add_test (tc_chain, test_connection_reuse);
+
+  return s;
+}
+
+GST_CHECK_MAIN (curlsink);
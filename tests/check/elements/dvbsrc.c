@@ -0,0 +1,152 @@
+/* GStreamer unit test for dvbsrc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <unistd.h>
+#include <glib/gstdio.h>
+
+#include <gst/check/gstcheck.h>
+
+#define TS_SIZE 188
+#define N_PACKETS 1000
+
+static guint8 *ts_data;
+static guint ts_offset;
+static guint n_buffers;
+
+static gchar *
+write_ts_file (void)
+{
+  GError *err = NULL;
+  gchar *filename;
+  gint fd, i;
+
+  ts_data = g_malloc (N_PACKETS * TS_SIZE);
+  for (i = 0; i < N_PACKETS * TS_SIZE; i++)
+    ts_data[i] = (i % TS_SIZE) == 0 ? 0x47 : (i / TS_SIZE + i) & 0xff;
+
+  fd = g_file_open_tmp ("dvbsrc-test-XXXXXX.ts", &filename, &err);
+  fail_unless (fd >= 0, "could not create temp file: %s",
+      err ? err->message : "");
+  fail_unless (write (fd, ts_data, N_PACKETS * TS_SIZE) ==
+      N_PACKETS * TS_SIZE);
+  close (fd);
+
+  return filename;
+}
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buf, GstPad * pad, gpointer data)
+{
+  guint size = GST_BUFFER_SIZE (buf);
+
+  fail_unless (size % TS_SIZE == 0, "size %u not a multiple of %d", size,
+      TS_SIZE);
+  fail_unless (ts_offset + size <= N_PACKETS * TS_SIZE);
+  fail_unless (memcmp (GST_BUFFER_DATA (buf), ts_data + ts_offset,
+          size) == 0, "wrong data at offset %u", ts_offset);
+  fail_unless (GST_BUFFER_CAPS (buf) != NULL);
+
+  ts_offset += size;
+  n_buffers++;
+}
+
+static void
+run_dvbsrc (guint blocksize, guint ring_size)
+{
+  GstElement *pipeline, *src, *sink;
+  GstMessage *msg;
+  gchar *filename;
+
+  filename = write_ts_file ();
+  ts_offset = 0;
+  n_buffers = 0;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("dvbsrc", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (src != NULL && sink != NULL);
+
+  g_object_set (src, "dvr-device", filename, "blocksize", blocksize,
+      "ring-size", ring_size, NULL);
+  g_object_set (sink, "signal-handoffs", TRUE, "sync", FALSE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb), NULL);
+
+  gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  fail_unless_equals_int (ts_offset, N_PACKETS * TS_SIZE);
+  GST_INFO ("got %u buffers", n_buffers);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_unlink (filename);
+  g_free (filename);
+  g_free (ts_data);
+  ts_data = NULL;
+}
+
+GST_START_TEST (test_read_file)
+{
+  run_dvbsrc (TS_SIZE * 7, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_blocksize_alignment)
+{
+  /* rounded down to 5 packets */
+  run_dvbsrc (1000, 0);
+  fail_unless_equals_int (n_buffers, N_PACKETS / 5);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_reader_thread)
+{
+  /* the ring can hold the whole file, nothing may be dropped */
+  run_dvbsrc (TS_SIZE * 5, N_PACKETS / 5);
+  fail_unless_equals_int (n_buffers, N_PACKETS / 5);
+}
+
+GST_END_TEST;
+
+static Suite *
+dvbsrc_suite (void)
+{
+  Suite *s = suite_create ("dvbsrc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_read_file);
+  tcase_add_test (tc_chain, test_blocksize_alignment);
+  tcase_add_test (tc_chain, test_reader_thread);
+
+  return s;
+}
+
+GST_CHECK_MAIN (dvbsrc);
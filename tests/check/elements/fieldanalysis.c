@@ -0,0 +1,308 @@
+/* GStreamer unit tests for fieldanalysis
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <string.h>
+
+#define N_FRAMES 12
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("{ I420, YUY2 }")));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("{ I420, YUY2 }")));
+
+typedef enum
+{
+  CONTENT_PROGRESSIVE,
+  CONTENT_INTERLACED,
+  CONTENT_TELECINE
+} Content;
+
+static guint8
+luma (gint x, gint shift)
+{
+  return ((x + shift) / 64) & 1 ? 235 : 16;
+}
+
+/* 64 samples wide vertical bars moving by 32 samples per frame; for
+ * interlaced content the bottom field is half a frame later than the top
+ * field */
+static GstBuffer *
+make_frame (GstVideoFormat format, gint width, gint height, gint top_shift,
+    gint bottom_shift)
+{
+  GstBuffer *buf;
+  guint8 *data;
+  gint x, y;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size (format, width,
+          height));
+  data = GST_BUFFER_DATA (buf);
+
+  if (format == GST_VIDEO_FORMAT_I420) {
+    memset (data, 128, GST_BUFFER_SIZE (buf));
+    for (y = 0; y < height; y++) {
+      guint8 *line = data + y * gst_video_format_get_row_stride (format, 0,
+          width);
+      gint shift = (y & 1) ? bottom_shift : top_shift;
+
+      for (x = 0; x < width; x++)
+        line[x] = luma (x, shift);
+    }
+  } else {
+    for (y = 0; y < height; y++) {
+      guint8 *line = data + y * gst_video_format_get_row_stride (format, 0,
+          width);
+      gint shift = (y & 1) ? bottom_shift : top_shift;
+
+      for (x = 0; x < width; x++) {
+        line[2 * x] = luma (x, shift);
+        line[2 * x + 1] = 128;
+      }
+    }
+  }
+
+  return buf;
+}
+
+static void
+set_enum (GstElement * element, const gchar * name, const gchar * nick)
+{
+  GParamSpec *pspec;
+  GEnumValue *value;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+  fail_unless (pspec != NULL);
+  value = g_enum_get_value_by_nick (G_PARAM_SPEC_ENUM (pspec)->enum_class,
+      nick);
+  fail_unless (value != NULL, "no value %s for %s", nick, name);
+  g_object_set (element, name, value->value, NULL);
+}
+
+/* pushes @n_frames frames of @content through fieldanalysis and returns a
+ * string describing the decisions made for each output frame */
+static gchar *
+analyse (GstVideoFormat format, gint width, gint height, Content content,
+    guint n_frames, const gchar * frame_metric, const gchar * comb_method,
+    guint n_threads, gboolean fast_pass)
+{
+  GstElement *fieldanalysis;
+  GstCaps *caps;
+  GString *decisions;
+  GList *input = NULL, *l;
+  guint i;
+
+  fieldanalysis = gst_check_setup_element ("fieldanalysis");
+  set_enum (fieldanalysis, "frame-metric", frame_metric);
+  set_enum (fieldanalysis, "comb-method", comb_method);
+  g_object_set (fieldanalysis, "n-threads", n_threads, "fast-pass", fast_pass,
+      NULL);
+  mysrcpad = gst_check_setup_src_pad (fieldanalysis, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (fieldanalysis, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (fieldanalysis,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_video_format_new_caps (format, width, height, 25, 1, 1, 1);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *buf;
+
+    switch (content) {
+      case CONTENT_PROGRESSIVE:
+        buf = make_frame (format, width, height, 32 * i, 32 * i);
+        break;
+      case CONTENT_INTERLACED:
+        buf = make_frame (format, width, height, 32 * i, 32 * i + 16);
+        break;
+      case CONTENT_TELECINE:
+      default:
+      {
+        /* 3:2 pulldown: film frames give 3, 2, 3, 2... fields */
+        guint top = i * 2, bottom = i * 2 + 1;
+
+        buf = make_frame (format, width, height, 32 * (top * 2 / 5),
+            32 * (bottom * 2 / 5));
+        break;
+      }
+    }
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+    gst_buffer_set_caps (buf, caps);
+    input = g_list_prepend (input, buf);
+  }
+  gst_caps_unref (caps);
+  input = g_list_reverse (input);
+
+  while (input) {
+    fail_unless_equals_int (gst_pad_push (mysrcpad, GST_BUFFER (input->data)),
+        GST_FLOW_OK);
+    input = g_list_delete_link (input, input);
+  }
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fail_unless (buffers != NULL);
+  decisions = g_string_new (NULL);
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = GST_BUFFER (l->data);
+    GstStructure *s = gst_caps_get_structure (GST_BUFFER_CAPS (buf), 0);
+    gboolean interlaced = FALSE;
+    const gchar *method;
+
+    gst_structure_get_boolean (s, "interlaced", &interlaced);
+    method = gst_structure_get_string (s, "interlacing-method");
+    g_string_append_printf (decisions, "%c%c%c%c %s %s\n",
+        GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_PROGRESSIVE) ? 'P' : '-',
+        GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_TFF) ? 'T' : '-',
+        GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_ONEFIELD) ? 'O' : '-',
+        GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_RFF) ? 'R' : '-',
+        interlaced ? "interlaced" : "progressive", GST_STR_NULL (method));
+  }
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (fieldanalysis, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (fieldanalysis);
+  gst_check_teardown_sink_pad (fieldanalysis);
+  gst_check_teardown_element (fieldanalysis);
+
+  return g_string_free (decisions, FALSE);
+}
+
+static guint
+count_lines_with (const gchar * decisions, const gchar * needle)
+{
+  gchar **lines, **line;
+  guint count = 0;
+
+  lines = g_strsplit (decisions, "\n", -1);
+  for (line = lines; *line; line++) {
+    if (strstr (*line, needle) != NULL)
+      count++;
+  }
+  g_strfreev (lines);
+
+  return count;
+}
+
+static void
+check_content (GstVideoFormat format, const gchar * frame_metric)
+{
+  gchar *decisions;
+
+  decisions = analyse (format, 320, 240, CONTENT_INTERLACED, N_FRAMES,
+      frame_metric, "5-tap", 1, FALSE);
+  GST_DEBUG ("interlaced:\n%s", decisions);
+  /* the first and last frames only have one neighbour to be compared to */
+  fail_unless (count_lines_with (decisions, " interlaced") >= N_FRAMES - 2,
+      "%s", decisions);
+  g_free (decisions);
+
+  decisions = analyse (format, 320, 240, CONTENT_PROGRESSIVE, N_FRAMES,
+      frame_metric, "5-tap", 1, FALSE);
+  GST_DEBUG ("progressive:\n%s", decisions);
+  fail_unless (count_lines_with (decisions, " progressive") >= N_FRAMES - 2,
+      "%s", decisions);
+  g_free (decisions);
+}
+
+GST_START_TEST (test_content_i420)
+{
+  check_content (GST_VIDEO_FORMAT_I420, "5-tap");
+  check_content (GST_VIDEO_FORMAT_I420, "windowed-comb");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_content_yuy2)
+{
+  check_content (GST_VIDEO_FORMAT_YUY2, "5-tap");
+  check_content (GST_VIDEO_FORMAT_YUY2, "windowed-comb");
+}
+
+GST_END_TEST;
+
+/* the threads and the fast pass must not change any decision */
+GST_START_TEST (test_threads_and_fast_pass)
+{
+  static const gchar *frame_metrics[] = { "5-tap", "windowed-comb" };
+  static const gchar *comb_methods[] = { "32-detect", "isCombed", "5-tap" };
+  static const Content contents[] = { CONTENT_PROGRESSIVE, CONTENT_INTERLACED,
+    CONTENT_TELECINE
+  };
+  static const GstVideoFormat formats[] = { GST_VIDEO_FORMAT_I420,
+    GST_VIDEO_FORMAT_YUY2
+  };
+  guint f, m, c, t;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (m = 0; m < G_N_ELEMENTS (frame_metrics); m++) {
+      for (c = 0; c < G_N_ELEMENTS (comb_methods); c++) {
+        for (t = 0; t < G_N_ELEMENTS (contents); t++) {
+          gchar *reference, *threaded, *fast;
+
+          reference = analyse (formats[f], 320, 240, contents[t], N_FRAMES,
+              frame_metrics[m], comb_methods[c], 1, FALSE);
+          threaded = analyse (formats[f], 320, 240, contents[t], N_FRAMES,
+              frame_metrics[m], comb_methods[c], 4, FALSE);
+          fast = analyse (formats[f], 320, 240, contents[t], N_FRAMES,
+              frame_metrics[m], comb_methods[c], 4, TRUE);
+
+          fail_unless_equals_string (threaded, reference);
+          fail_unless_equals_string (fast, reference);
+
+          g_free (reference);
+          g_free (threaded);
+          g_free (fast);
+        }
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+fieldanalysis_suite (void)
+{
+  Suite *s = suite_create ("fieldanalysis");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 120);
+
+  tcase_add_test (tc_chain, test_content_i420);
+  tcase_add_test (tc_chain, test_content_yuy2);
+  tcase_add_test (tc_chain, test_threads_and_fast_pass);
+
+  return s;
+}
+
+GST_CHECK_MAIN (fieldanalysis);
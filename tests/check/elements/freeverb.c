@@ -0,0 +1,288 @@
+/* GStreamer unit tests for freeverb
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 44100
+/* 0.1 seconds per buffer */
+#define BUFFER_FRAMES (RATE / 10)
+
+static GstPad *mysrcpad, *mysinkpad;
+
+#define FREEVERB_CAPS_TEMPLATE_STRING \
+    "audio/x-raw-float, " \
+    "rate = (int) [ 1, MAX ], " \
+    "channels = (int) [ 1, 2 ], " \
+    "endianness = (int) BYTE_ORDER, " \
+    "width = (int) 32; " \
+    "audio/x-raw-int, " \
+    "rate = (int) [ 1, MAX ], " \
+    "channels = (int) [ 1, 2 ], " \
+    "endianness = (int) BYTE_ORDER, " \
+    "width = (int) { 16, 32 }, " \
+    "depth = (int) { 16, 32 }, " \
+    "signed = (boolean) true"
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (FREEVERB_CAPS_TEMPLATE_STRING));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (FREEVERB_CAPS_TEMPLATE_STRING));
+
+typedef enum
+{
+  FORMAT_S16,
+  FORMAT_S32,
+  FORMAT_F32
+} Format;
+
+static const gchar *format_names[] = { "S16", "S32", "F32" };
+
+static GstElement *
+setup_freeverb (Format format, gint channels)
+{
+  GstElement *freeverb;
+  GstCaps *caps;
+
+  freeverb = gst_check_setup_element ("freeverb");
+  mysrcpad = gst_check_setup_src_pad (freeverb, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (freeverb, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (freeverb,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  if (format == FORMAT_F32) {
+    caps = gst_caps_new_simple ("audio/x-raw-float",
+        "width", G_TYPE_INT, 32, "endianness", G_TYPE_INT, G_BYTE_ORDER,
+        NULL);
+  } else {
+    gint width = (format == FORMAT_S16) ? 16 : 32;
+
+    caps = gst_caps_new_simple ("audio/x-raw-int",
+        "width", G_TYPE_INT, width, "depth", G_TYPE_INT, width,
+        "signed", G_TYPE_BOOLEAN, TRUE,
+        "endianness", G_TYPE_INT, G_BYTE_ORDER, NULL);
+  }
+  gst_caps_set_simple (caps, "rate", G_TYPE_INT, RATE,
+      "channels", G_TYPE_INT, channels, NULL);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return freeverb;
+}
+
+static void
+cleanup_freeverb (GstElement * freeverb)
+{
+  gst_check_drop_buffers ();
+  gst_element_set_state (freeverb, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (freeverb);
+  gst_check_teardown_sink_pad (freeverb);
+  gst_check_teardown_element (freeverb);
+}
+
+/* buffer @index of a noise burst of one second followed by silence, with
+ * 16 bit samples of half the full scale */
+static GstBuffer *
+make_buffer (Format format, gint channels, guint index)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  gint i, n = BUFFER_FRAMES * channels;
+  gboolean silent = (index >= 10);
+
+  buf = gst_buffer_new_and_alloc (n * 4 / (format == FORMAT_S16 ? 2 : 1));
+  rand = g_rand_new_with_seed (index);
+  for (i = 0; i < n; i++) {
+    gint v = silent ? 0 : g_rand_int_range (rand, -16384, 16384);
+
+    switch (format) {
+      case FORMAT_S16:
+        ((gint16 *) GST_BUFFER_DATA (buf))[i] = v;
+        break;
+      case FORMAT_S32:
+        ((gint32 *) GST_BUFFER_DATA (buf))[i] = v << 16;
+        break;
+      case FORMAT_F32:
+        ((gfloat *) GST_BUFFER_DATA (buf))[i] = v;
+        break;
+    }
+  }
+  g_rand_free (rand);
+
+  GST_BUFFER_TIMESTAMP (buf) = index * GST_SECOND / 10;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 10;
+  if (index == 0)
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+  if (silent)
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_GAP);
+  gst_buffer_set_caps (buf, GST_PAD_CAPS (mysrcpad));
+
+  return buf;
+}
+
+/* output sample @i of @buf in 16 bit units */
+static gdouble
+get_sample (GstBuffer * buf, Format format, gint i)
+{
+  switch (format) {
+    case FORMAT_S16:
+      return ((gint16 *) GST_BUFFER_DATA (buf))[i];
+    case FORMAT_S32:
+      return ((gint32 *) GST_BUFFER_DATA (buf))[i] / 65536.0;
+    case FORMAT_F32:
+    default:
+      return ((gfloat *) GST_BUFFER_DATA (buf))[i];
+  }
+}
+
+/* reverberates @n_buffers buffers, returning the output buffers */
+static GList *
+reverberate (Format format, gint channels, guint n_buffers)
+{
+  GstElement *freeverb;
+  GList *out;
+  guint i;
+
+  freeverb = setup_freeverb (format, channels);
+  for (i = 0; i < n_buffers; i++) {
+    fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer (format,
+                channels, i)), GST_FLOW_OK);
+  }
+  fail_unless_equals_int (g_list_length (buffers), n_buffers);
+
+  out = buffers;
+  buffers = NULL;
+  cleanup_freeverb (freeverb);
+
+  return out;
+}
+
+static void
+free_buffers (GList * list)
+{
+  g_list_foreach (list, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (list);
+}
+
+/* the integer formats are processed in fixed point and stay within a few
+ * 16 bit units of the float processing, and 32 bit processing rounds to
+ * 16 bit processing */
+static void
+check_formats_match (gint channels)
+{
+  GList *f32, *s16, *s32, *l, *l16, *l32;
+  gdouble max_diff = 0;
+  gint i;
+
+  f32 = reverberate (FORMAT_F32, channels, 20);
+  s16 = reverberate (FORMAT_S16, channels, 20);
+  s32 = reverberate (FORMAT_S32, channels, 20);
+
+  for (l = f32, l16 = s16, l32 = s32; l; l = l->next, l16 = l16->next,
+      l32 = l32->next) {
+    for (i = 0; i < BUFFER_FRAMES * 2; i++) {
+      gdouble f = get_sample (l->data, FORMAT_F32, i);
+      gint v16 = get_sample (l16->data, FORMAT_S16, i);
+      gint32 v32 = ((gint32 *) GST_BUFFER_DATA (l32->data))[i];
+
+      max_diff = MAX (max_diff, ABS (f - v16));
+      fail_unless_equals_int (((gint64) v32 + 32768) >> 16, v16);
+    }
+  }
+  GST_INFO ("%d channels: fixed point within %.2f of float", channels,
+      max_diff);
+  fail_unless (max_diff < 32, "fixed point differs by %.2f", max_diff);
+
+  free_buffers (f32);
+  free_buffers (s16);
+  free_buffers (s32);
+}
+
+GST_START_TEST (test_formats_match_mono)
+{
+  check_formats_match (1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_formats_match_stereo)
+{
+  check_formats_match (2);
+}
+
+GST_END_TEST;
+
+/* the tail of the reverb decays to exact silence in fixed point */
+GST_START_TEST (test_fixed_point_drains)
+{
+  Format format;
+
+  for (format = FORMAT_S16; format <= FORMAT_S32; format++) {
+    GList *out, *l;
+    gboolean drained = FALSE;
+
+    out = reverberate (format, 2, 100);
+    for (l = g_list_nth (out, 10); l; l = l->next) {
+      GstBuffer *buf = l->data;
+
+      if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP)) {
+        gint i;
+
+        for (i = 0; i < BUFFER_FRAMES * 2; i++)
+          fail_unless (get_sample (buf, format, i) == 0);
+        drained = TRUE;
+      } else {
+        fail_if (drained, "%s output not silent after drain",
+            format_names[format]);
+      }
+    }
+    fail_unless (drained, "%s output does not drain", format_names[format]);
+    free_buffers (out);
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+freeverb_suite (void)
+{
+  Suite *s = suite_create ("freeverb");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 60);
+
+  tcase_add_test (tc_chain, test_formats_match_mono);
+  tcase_add_test (tc_chain, test_formats_match_stereo);
+  tcase_add_test (tc_chain, test_fixed_point_drains);
+
+  return s;
+}
+
+GST_CHECK_MAIN (freeverb);
@@ -0,0 +1,273 @@
+/* GStreamer unit tests for interlace
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <string.h>
+
+#define N_FRAMES 24
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("{ I420, YUY2, NV12 }")
+        ",interlaced=FALSE"));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("{ I420, YUY2, NV12 }")
+        ",interlaced=TRUE"));
+
+/* the fields given to each frame by the patterns, as in the element */
+static const struct
+{
+  const gchar *nick;
+  gint n_fields[13];
+} patterns[] = {
+  {
+  "1:1", {1}}, {
+  "2:2", {2}}, {
+  "2:3", {2, 3}}, {
+  "2:3:3:2", {2, 3, 3, 2}}, {
+  "2-11:3", {2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3}}
+};
+
+/* frame @index, different in every byte and every frame */
+static GstBuffer *
+make_frame (GstVideoFormat format, gint width, gint height, guint index)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  guint i;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size (format, width,
+          height));
+  rand = g_rand_new_with_seed (index);
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i++)
+    GST_BUFFER_DATA (buf)[i] = g_rand_int (rand);
+  g_rand_free (rand);
+
+  return buf;
+}
+
+/* the lines of field @field_index from frame @first and the other lines from
+ * frame @second, made component by component */
+static gchar *
+expected_checksum (GstVideoFormat format, gint width, gint height,
+    guint first, guint second, gint field_index)
+{
+  GstBuffer *frames[2], *expected;
+  gint c, j, n_components;
+  gchar *checksum;
+
+  frames[field_index] = make_frame (format, width, height, first);
+  frames[field_index ^ 1] = make_frame (format, width, height, second);
+  expected = gst_buffer_copy (frames[0]);
+
+  /* the second component of NV12 covers the whole chroma plane */
+  if (format == GST_VIDEO_FORMAT_YUY2)
+    n_components = 1;
+  else if (format == GST_VIDEO_FORMAT_NV12)
+    n_components = 2;
+  else
+    n_components = 3;
+  for (c = 0; c < n_components; c++) {
+    gint offset, stride;
+
+    offset = gst_video_format_get_component_offset (format, c, width, height);
+    stride = gst_video_format_get_row_stride (format, c, width);
+    for (j = 1; j < gst_video_format_get_component_height (format, c, height);
+        j += 2) {
+      memcpy (GST_BUFFER_DATA (expected) + offset + j * stride,
+          GST_BUFFER_DATA (frames[1]) + offset + j * stride, stride);
+    }
+  }
+
+  checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
+      GST_BUFFER_DATA (expected), GST_BUFFER_SIZE (expected));
+
+  gst_buffer_unref (frames[0]);
+  gst_buffer_unref (frames[1]);
+  gst_buffer_unref (expected);
+
+  return checksum;
+}
+
+static void
+set_enum (GstElement * element, const gchar * name, const gchar * nick)
+{
+  GParamSpec *pspec;
+  GEnumValue *value;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+  fail_unless (pspec != NULL);
+  value = g_enum_get_value_by_nick (G_PARAM_SPEC_ENUM (pspec)->enum_class,
+      nick);
+  fail_unless (value != NULL, "no value %s for %s", nick, name);
+  g_object_set (element, name, value->value, NULL);
+}
+
+/* pushes N_FRAMES frames through interlace and checks that every output
+ * frame weaves the two fields expected from the pattern */
+static void
+check_pattern (GstVideoFormat format, gint width, gint height, guint pattern,
+    gboolean allow_rff)
+{
+  GstElement *interlace;
+  GstCaps *caps;
+  GList *l;
+  guint sources[N_FRAMES * 3];
+  guint i, phase = 0, n_sources = 0, pos = 0;
+
+  interlace = gst_check_setup_element ("interlace");
+  set_enum (interlace, "field-pattern", patterns[pattern].nick);
+  g_object_set (interlace, "top-field-first", TRUE, "allow-rff", allow_rff,
+      NULL);
+  mysrcpad = gst_check_setup_src_pad (interlace, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (interlace, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (interlace,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_video_format_new_caps_interlaced (format, width, height, 24, 1,
+      1, 1, FALSE);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+
+  for (i = 0; i < N_FRAMES; i++) {
+    GstBuffer *buf;
+    gint n_fields;
+
+    /* the field stream: each frame repeated for each of its fields */
+    if (patterns[pattern].n_fields[phase] == 0)
+      phase = 0;
+    n_fields = patterns[pattern].n_fields[phase++];
+    while (n_fields--)
+      sources[n_sources++] = i;
+
+    buf = make_frame (format, width, height, i);
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 24;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 24;
+    if (i == 0)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+    /* flags that must not leak into frames woven in place */
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_TFF);
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_RFF);
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_ONEFIELD);
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+    gst_buffer_set_caps (buf, caps);
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+  gst_caps_unref (caps);
+
+  fail_unless (buffers != NULL);
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = GST_BUFFER (l->data);
+    gint field_index = pos & 1;
+    guint n_fields = 2;
+    gchar *expected, *checksum;
+
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_RFF)) {
+      fail_unless (allow_rff);
+      n_fields = 3;
+    }
+    fail_unless (pos + n_fields <= n_sources);
+    if (n_fields == 3)
+      fail_unless_equals_int (sources[pos + 2], sources[pos]);
+    fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (buf,
+            GST_VIDEO_BUFFER_TFF), field_index == 0);
+    fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_ONEFIELD));
+    fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT));
+
+    expected = expected_checksum (format, width, height, sources[pos],
+        sources[pos + 1], field_index);
+    checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
+        GST_BUFFER_DATA (buf), gst_video_format_get_size (format, width,
+            height));
+    fail_unless_equals_string (checksum, expected);
+    g_free (checksum);
+    g_free (expected);
+
+    pos += n_fields;
+  }
+  /* all the complete frames were output */
+  fail_unless (n_sources - pos < 2, "%u of %u fields output", pos, n_sources);
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (interlace, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (interlace);
+  gst_check_teardown_sink_pad (interlace);
+  gst_check_teardown_element (interlace);
+}
+
+static void
+check_patterns (GstVideoFormat format, gint width, gint height)
+{
+  guint p;
+
+  for (p = 0; p < G_N_ELEMENTS (patterns); p++) {
+    check_pattern (format, width, height, p, FALSE);
+    check_pattern (format, width, height, p, TRUE);
+  }
+}
+
+/* 322 is not a multiple of 4, so the rows are padded */
+GST_START_TEST (test_patterns_i420)
+{
+  check_patterns (GST_VIDEO_FORMAT_I420, 322, 240);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_patterns_yuy2)
+{
+  check_patterns (GST_VIDEO_FORMAT_YUY2, 322, 240);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_patterns_nv12)
+{
+  check_patterns (GST_VIDEO_FORMAT_NV12, 322, 240);
+}
+
+GST_END_TEST;
+
+static Suite *
+interlace_suite (void)
+{
+  Suite *s = suite_create ("interlace");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 60);
+
+  tcase_add_test (tc_chain, test_patterns_i420);
+  tcase_add_test (tc_chain, test_patterns_yuy2);
+  tcase_add_test (tc_chain, test_patterns_nv12);
+
+  return s;
+}
+
+GST_CHECK_MAIN (interlace);
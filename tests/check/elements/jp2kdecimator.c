@@ -0,0 +1,321 @@
+/* GStreamer unit tests for jp2kdecimator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/base/gstbytewriter.h>
+
+#include <string.h>
+
+/* 8x8 tiles of 256x256, LRCP with 4 layers and 3 resolutions, i.e. 12
+ * packets per tile */
+#define N_TILES_X 8
+#define N_TILES_Y 8
+#define TILE_SIZE 256
+#define N_LAYERS 4
+#define N_DECOMPOSITIONS 2
+#define N_RESOLUTIONS (N_DECOMPOSITIONS + 1)
+#define N_PACKETS (N_LAYERS * N_RESOLUTIONS)
+#define PACKET_SIZE 2000
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("image/x-jpc"));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("image/x-jpc"));
+
+static void
+put_packet_length (GstByteWriter * writer, guint32 len)
+{
+  /* PACKET_SIZE needs two bytes */
+  gst_byte_writer_put_uint8 (writer, 0x80 | ((len >> 7) & 0x7f));
+  gst_byte_writer_put_uint8 (writer, len & 0x7f);
+}
+
+/* A codestream with opaque packet data whose packet lengths are signalled
+ * in PLT markers of the tiles or, if @plm, in a PLM marker of the main
+ * header */
+static GstBuffer *
+make_codestream (gboolean plm)
+{
+  GstByteWriter writer;
+  GstBuffer *buf;
+  GstCaps *caps;
+  gint t, i, j;
+
+  gst_byte_writer_init (&writer);
+
+  gst_byte_writer_put_uint16_be (&writer, 0xff4f);      /* SOC */
+
+  gst_byte_writer_put_uint16_be (&writer, 0xff51);      /* SIZ */
+  gst_byte_writer_put_uint16_be (&writer, 38 + 3);
+  gst_byte_writer_put_uint16_be (&writer, 0);
+  gst_byte_writer_put_uint32_be (&writer, N_TILES_X * TILE_SIZE);
+  gst_byte_writer_put_uint32_be (&writer, N_TILES_Y * TILE_SIZE);
+  gst_byte_writer_put_uint32_be (&writer, 0);
+  gst_byte_writer_put_uint32_be (&writer, 0);
+  gst_byte_writer_put_uint32_be (&writer, TILE_SIZE);
+  gst_byte_writer_put_uint32_be (&writer, TILE_SIZE);
+  gst_byte_writer_put_uint32_be (&writer, 0);
+  gst_byte_writer_put_uint32_be (&writer, 0);
+  gst_byte_writer_put_uint16_be (&writer, 1);
+  gst_byte_writer_put_uint8 (&writer, 7);
+  gst_byte_writer_put_uint8 (&writer, 1);
+  gst_byte_writer_put_uint8 (&writer, 1);
+
+  gst_byte_writer_put_uint16_be (&writer, 0xff52);      /* COD */
+  gst_byte_writer_put_uint16_be (&writer, 12);
+  gst_byte_writer_put_uint8 (&writer, 0);
+  gst_byte_writer_put_uint8 (&writer, 0);       /* LRCP */
+  gst_byte_writer_put_uint16_be (&writer, N_LAYERS);
+  gst_byte_writer_put_uint8 (&writer, 0);
+  gst_byte_writer_put_uint8 (&writer, N_DECOMPOSITIONS);
+  gst_byte_writer_put_uint8 (&writer, 4);
+  gst_byte_writer_put_uint8 (&writer, 4);
+  gst_byte_writer_put_uint8 (&writer, 0);
+  gst_byte_writer_put_uint8 (&writer, 0);
+
+  gst_byte_writer_put_uint16_be (&writer, 0xff5c);      /* QCD */
+  gst_byte_writer_put_uint16_be (&writer, 4);
+  gst_byte_writer_put_uint16_be (&writer, 0x4048);
+
+  if (plm) {
+    gst_byte_writer_put_uint16_be (&writer, 0xff57);
+    gst_byte_writer_put_uint16_be (&writer,
+        3 + N_TILES_X * N_TILES_Y * (1 + 2 * N_PACKETS));
+    gst_byte_writer_put_uint8 (&writer, 0);
+    for (t = 0; t < N_TILES_X * N_TILES_Y; t++) {
+      gst_byte_writer_put_uint8 (&writer, 2 * N_PACKETS);
+      for (i = 0; i < N_PACKETS; i++)
+        put_packet_length (&writer, PACKET_SIZE);
+    }
+  }
+
+  for (t = 0; t < N_TILES_X * N_TILES_Y; t++) {
+    gst_byte_writer_put_uint16_be (&writer, 0xff90);    /* SOT */
+    gst_byte_writer_put_uint16_be (&writer, 10);
+    gst_byte_writer_put_uint16_be (&writer, t);
+    gst_byte_writer_put_uint32_be (&writer, 12 + (plm ? 0 : 5 + 2 * N_PACKETS)
+        + 2 + N_PACKETS * PACKET_SIZE);
+    gst_byte_writer_put_uint8 (&writer, 0);
+    gst_byte_writer_put_uint8 (&writer, 1);
+
+    if (!plm) {
+      gst_byte_writer_put_uint16_be (&writer, 0xff58);  /* PLT */
+      gst_byte_writer_put_uint16_be (&writer, 3 + 2 * N_PACKETS);
+      gst_byte_writer_put_uint8 (&writer, 0);
+      for (i = 0; i < N_PACKETS; i++)
+        put_packet_length (&writer, PACKET_SIZE);
+    }
+
+    gst_byte_writer_put_uint16_be (&writer, 0xff93);    /* SOD */
+    for (i = 0; i < N_PACKETS; i++)
+      for (j = 0; j < PACKET_SIZE; j++)
+        gst_byte_writer_put_uint8 (&writer, (t + i * 7 + j) % 0x80);
+  }
+
+  gst_byte_writer_put_uint16_be (&writer, 0xffd9);      /* EOC */
+
+  buf = gst_byte_writer_reset_and_get_buffer (&writer);
+  caps = gst_caps_new_simple ("image/x-jpc", NULL);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+static GstElement *
+setup_jp2kdecimator (void)
+{
+  GstElement *decimator;
+
+  decimator = gst_check_setup_element ("jp2kdecimator");
+  mysrcpad = gst_check_setup_src_pad (decimator, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (decimator, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  return decimator;
+}
+
+static void
+cleanup_jp2kdecimator (GstElement * decimator)
+{
+  gst_element_set_state (decimator, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (decimator);
+  gst_check_teardown_sink_pad (decimator);
+  gst_check_teardown_element (decimator);
+}
+
+/* decimates @n_buffers copies of @input, returns the last output and
+ * stores the time spent in @elapsed */
+static GstBuffer *
+decimate (GstBuffer * input, guint n_threads, guint n_buffers,
+    GstClockTime * elapsed)
+{
+  GstElement *decimator;
+  GstBuffer *output;
+  GstClockTime start;
+  guint i;
+
+  decimator = setup_jp2kdecimator ();
+  g_object_set (decimator, "max-layers", 1, "n-threads", n_threads, NULL);
+  fail_unless_equals_int (gst_element_set_state (decimator,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_buffers; i++)
+    fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (input)),
+        GST_FLOW_OK);
+  if (elapsed)
+    *elapsed = gst_util_get_timestamp () - start;
+
+  fail_unless_equals_int (g_list_length (buffers), n_buffers);
+  output = gst_buffer_ref (GST_BUFFER (g_list_last (buffers)->data));
+  gst_check_drop_buffers ();
+
+  cleanup_jp2kdecimator (decimator);
+
+  return output;
+}
+
+static void
+check_decimated (GstBuffer * output)
+{
+  guint tile_size, expected;
+  const guint8 *data;
+
+  /* SOT, PLT with 1 byte lengths for the dropped packets, SOD, the packets
+   * of the first layer and one byte per dropped packet */
+  tile_size = 12 + 5 + 2 * N_RESOLUTIONS + (N_PACKETS - N_RESOLUTIONS) +
+      2 + N_RESOLUTIONS * PACKET_SIZE + (N_PACKETS - N_RESOLUTIONS);
+  /* SOC, SIZ, COD, QCD, tiles, EOC */
+  expected = 2 + 2 + 41 + 2 + 12 + 2 + 4 + N_TILES_X * N_TILES_Y * tile_size +
+      2;
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (output), expected);
+
+  data = GST_BUFFER_DATA (output);
+  fail_unless_equals_int (GST_READ_UINT16_BE (data), 0xff4f);
+  fail_unless_equals_int (GST_READ_UINT16_BE (data + expected - 2), 0xffd9);
+
+  /* first tile: SOT with the new tile-part length, then the PLT */
+  data += 2 + 2 + 41 + 2 + 12 + 2 + 4;
+  fail_unless_equals_int (GST_READ_UINT16_BE (data), 0xff90);
+  fail_unless_equals_int (GST_READ_UINT32_BE (data + 6), tile_size);
+  fail_unless_equals_int (GST_READ_UINT16_BE (data + 12), 0xff58);
+
+  /* the packets of the first layer are kept as they are */
+  data += 12 + 5 + 2 * N_RESOLUTIONS + (N_PACKETS - N_RESOLUTIONS);
+  fail_unless_equals_int (GST_READ_UINT16_BE (data), 0xff93);
+  fail_unless_equals_int (data[2], 0);
+  fail_unless_equals_int (data[2 + PACKET_SIZE], 7);
+  fail_unless_equals_int (data[2 + 2 * PACKET_SIZE], 14);
+  fail_unless_equals_int (data[2 + 3 * PACKET_SIZE], 0);
+}
+
+GST_START_TEST (test_decimate_plt)
+{
+  GstBuffer *input, *serial, *parallel;
+
+  input = make_codestream (FALSE);
+
+  serial = decimate (input, 1, 1, NULL);
+  check_decimated (serial);
+
+  parallel = decimate (input, 4, 1, NULL);
+  fail_unless_equals_int (GST_BUFFER_SIZE (parallel), GST_BUFFER_SIZE (serial));
+  fail_unless (memcmp (GST_BUFFER_DATA (parallel), GST_BUFFER_DATA (serial),
+          GST_BUFFER_SIZE (serial)) == 0);
+
+  gst_buffer_unref (serial);
+  gst_buffer_unref (parallel);
+  gst_buffer_unref (input);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_decimate_plm)
+{
+  GstBuffer *plt_input, *plm_input, *plt_output, *plm_output;
+
+  plt_input = make_codestream (FALSE);
+  plm_input = make_codestream (TRUE);
+
+  /* the PLM packet lengths end up in PLT markers of the tiles */
+  plt_output = decimate (plt_input, 1, 1, NULL);
+  plm_output = decimate (plm_input, 1, 1, NULL);
+  check_decimated (plm_output);
+  fail_unless_equals_int (GST_BUFFER_SIZE (plm_output),
+      GST_BUFFER_SIZE (plt_output));
+  fail_unless (memcmp (GST_BUFFER_DATA (plm_output),
+          GST_BUFFER_DATA (plt_output), GST_BUFFER_SIZE (plt_output)) == 0);
+
+  gst_buffer_unref (plt_output);
+  gst_buffer_unref (plm_output);
+  gst_buffer_unref (plt_input);
+  gst_buffer_unref (plm_input);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_decimate_benchmark)
+{
+  GstBuffer *input, *output;
+  GstClockTime serial, parallel;
+
+  input = make_codestream (FALSE);
+
+  output = decimate (input, 1, 50, &serial);
+  gst_buffer_unref (output);
+  output = decimate (input, 4, 50, &parallel);
+  gst_buffer_unref (output);
+
+  /* not asserted, the machine may well be busy with other things */
+  GST_INFO ("%d tiles, 50 frames: 1 thread %" GST_TIME_FORMAT
+      ", 4 threads %" GST_TIME_FORMAT, N_TILES_X * N_TILES_Y,
+      GST_TIME_ARGS (serial), GST_TIME_ARGS (parallel));
+
+  gst_buffer_unref (input);
+}
+
+GST_END_TEST;
+
+static Suite *
+jp2kdecimator_suite (void)
+{
+  Suite *s = suite_create ("jp2kdecimator");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_decimate_plt);
+  tcase_add_test (tc_chain, test_decimate_plm);
+  tcase_add_test (tc_chain, test_decimate_benchmark);
+
+  return s;
+}
+
+GST_CHECK_MAIN (jp2kdecimator);
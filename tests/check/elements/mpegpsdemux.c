@@ -0,0 +1,316 @@
+/* GStreamer unit tests for mpegpsdemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* 60s of MPEG-2 video at 25 fps with a GOP every 12 frames, in packs of at
+ * most 2048 bytes. The first half of the file has a much lower bitrate than
+ * the second half, so a purely linear offset estimation is way off */
+#define FPS 25
+#define N_FRAMES (60 * FPS)
+#define GOP_SIZE 12
+#define SMALL_FRAME 1000
+#define BIG_FRAME 20000
+#define PACK_SIZE 2048
+
+/* The first SCR is at 1s, PTS are 300ms after the SCR of the frame */
+#define SCR_BASE 90000
+#define SCR_PER_FRAME (90000 / FPS)
+#define PTS_DELAY 27000
+
+/* output timestamps are relative to the first SCR */
+#define FRAME_TS(n) ((n) * GST_SECOND / FPS + 300 * GST_MSECOND)
+
+static void
+write_pack_header (GByteArray * ps, guint64 scr)
+{
+  guint8 hdr[14];
+  guint32 mux_rate = 25000;
+
+  hdr[0] = 0x00;
+  hdr[1] = 0x00;
+  hdr[2] = 0x01;
+  hdr[3] = 0xba;
+  hdr[4] = 0x44 | ((scr >> 27) & 0x38) | ((scr >> 28) & 0x03);
+  hdr[5] = (scr >> 20) & 0xff;
+  hdr[6] = ((scr >> 12) & 0xf8) | 0x04 | ((scr >> 13) & 0x03);
+  hdr[7] = (scr >> 5) & 0xff;
+  hdr[8] = ((scr << 3) & 0xf8) | 0x04;
+  hdr[9] = 0x01;
+  hdr[10] = mux_rate >> 14;
+  hdr[11] = mux_rate >> 6;
+  hdr[12] = ((mux_rate & 0x3f) << 2) | 0x03;
+  hdr[13] = 0xf8;
+  g_byte_array_append (ps, hdr, sizeof (hdr));
+}
+
+/* Writes one pack with a video PES carrying as much of @payload as fits.
+ * Returns the number of payload bytes written */
+static guint
+write_pack (GByteArray * ps, guint64 scr, gboolean has_pts, guint64 pts,
+    const guint8 * payload, guint size)
+{
+  guint8 hdr[14];
+  guint hdr_size = has_pts ? 14 : 9;
+  guint n = MIN (size, PACK_SIZE - 14 - hdr_size);
+
+  write_pack_header (ps, scr);
+
+  hdr[0] = 0x00;
+  hdr[1] = 0x00;
+  hdr[2] = 0x01;
+  hdr[3] = 0xe0;
+  hdr[4] = (hdr_size - 6 + n) >> 8;
+  hdr[5] = (hdr_size - 6 + n) & 0xff;
+  hdr[6] = 0x80;
+  hdr[7] = has_pts ? 0x80 : 0x00;
+  hdr[8] = has_pts ? 5 : 0;
+  if (has_pts) {
+    hdr[9] = 0x21 | ((pts >> 29) & 0x0e);
+    hdr[10] = (pts >> 22) & 0xff;
+    hdr[11] = ((pts >> 14) & 0xfe) | 1;
+    hdr[12] = (pts >> 7) & 0xff;
+    hdr[13] = ((pts << 1) & 0xfe) | 1;
+  }
+  g_byte_array_append (ps, hdr, hdr_size);
+  g_byte_array_append (ps, payload, n);
+
+  return n;
+}
+
+static void
+write_frame (GByteArray * ps, guint n)
+{
+  static const guint8 seq_gop[] = {
+    0x00, 0x00, 0x01, 0xb3, 0x2d, 0x01, 0xe0, 0x33, 0xff, 0xff, 0xe0, 0x18,
+    0x00, 0x00, 0x01, 0xb8, 0x00, 0x08, 0x00, 0x40
+  };
+  gboolean keyframe = (n % GOP_SIZE) == 0;
+  guint64 scr = SCR_BASE + (guint64) n * SCR_PER_FRAME;
+  guint size, pos, written, packs, i;
+  guint8 *es;
+
+  size = n < N_FRAMES / 2 ? SMALL_FRAME : BIG_FRAME;
+  size += (n * 7919) % (size / 4);
+  if (keyframe)
+    size *= 2;
+
+  es = g_malloc (size);
+  memset (es, 0x55, size);
+  pos = 0;
+  if (keyframe) {
+    memcpy (es, seq_gop, sizeof (seq_gop));
+    pos = sizeof (seq_gop);
+  }
+  /* picture start code */
+  es[pos] = 0x00;
+  es[pos + 1] = 0x00;
+  es[pos + 2] = 0x01;
+  es[pos + 3] = 0x00;
+
+  /* spread the SCR of the packs over the frame duration. All PES carry the
+   * PTS so that the first buffer after a seek always has a timestamp, even
+   * when landing in the middle of a frame while prerolling */
+  packs = (size + PACK_SIZE - 29) / (PACK_SIZE - 28);
+  for (pos = 0, i = 0; pos < size; pos += written, i++)
+    written = write_pack (ps, scr + i * SCR_PER_FRAME / (packs + 1), TRUE,
+        scr + PTS_DELAY, es + pos, size - pos);
+
+  g_free (es);
+}
+
+static gchar *
+create_file (void)
+{
+  GByteArray *ps;
+  GError *err = NULL;
+  gchar *location;
+  guint n;
+  gint fd;
+
+  fd = g_file_open_tmp ("mpegpsdemux-XXXXXX.mpg", &location, &err);
+  fail_unless (fd >= 0, "could not create file: %s", err ? err->message : "");
+  close (fd);
+
+  ps = g_byte_array_new ();
+  for (n = 0; n < N_FRAMES; n++)
+    write_frame (ps, n);
+
+  fail_unless (g_file_set_contents (location, (gchar *) ps->data, ps->len,
+          NULL));
+  GST_INFO ("wrote %u bytes to %s", ps->len, location);
+  g_byte_array_free (ps, TRUE);
+
+  return location;
+}
+
+/* first buffer after a flush */
+static gboolean flushed;
+static GstClockTime first_ts;
+static gboolean first_is_keyframe;
+
+static gboolean
+event_probe (GstPad * pad, GstEvent * event, gpointer user_data)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+    flushed = TRUE;
+  return TRUE;
+}
+
+static gboolean
+buffer_probe (GstPad * pad, GstBuffer * buffer, gpointer user_data)
+{
+  if (flushed) {
+    flushed = FALSE;
+    first_ts = GST_BUFFER_TIMESTAMP (buffer);
+    first_is_keyframe = GST_BUFFER_SIZE (buffer) > 4 &&
+        GST_READ_UINT32_BE (GST_BUFFER_DATA (buffer)) == 0x000001b3;
+  }
+  return TRUE;
+}
+
+static GstElement *
+setup_pipeline (const gchar * location)
+{
+  GstElement *pipeline, *sink;
+  GstPad *pad;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! mpegpsdemux name=demux "
+      "demux.video_e0 ! fakesink name=sink sync=false", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_event_probe (pad, G_CALLBACK (event_probe), NULL);
+  gst_pad_add_buffer_probe (pad, G_CALLBACK (buffer_probe), NULL);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  return pipeline;
+}
+
+static GstClockTime
+do_seek (GstElement * pipeline, GstClockTime position, GstSeekFlags flags)
+{
+  first_ts = GST_CLOCK_TIME_NONE;
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | flags, position));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  GST_DEBUG ("seek to %" GST_TIME_FORMAT ", first buffer %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (position), GST_TIME_ARGS (first_ts));
+
+  fail_unless (GST_CLOCK_TIME_IS_VALID (first_ts));
+  return first_ts;
+}
+
+GST_START_TEST (test_seek_vbr)
+{
+  static const GstClockTime positions[] = {
+    10 * GST_SECOND, 20 * GST_SECOND, 40 * GST_SECOND, 55 * GST_SECOND,
+    41 * GST_SECOND
+  };
+  GstElement *pipeline;
+  GstClockTime ts;
+  gchar *location;
+  guint i;
+
+  location = create_file ();
+  pipeline = setup_pipeline (location);
+
+  /* the seek is done on the SCR, so we start with the frames multiplexed
+   * around the requested time, which are presented PTS_DELAY later */
+  for (i = 0; i < G_N_ELEMENTS (positions); i++) {
+    ts = do_seek (pipeline, positions[i], 0);
+    fail_unless (ts + 100 * GST_MSECOND >= positions[i] &&
+        ts <= positions[i] + 500 * GST_MSECOND,
+        "seek to %" GST_TIME_FORMAT " started at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (positions[i]), GST_TIME_ARGS (ts));
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_seek_keyframe)
+{
+  static const GstClockTime positions[] = {
+    10 * GST_SECOND + 300 * GST_MSECOND, 42 * GST_SECOND + 700 * GST_MSECOND
+  };
+  GstElement *pipeline;
+  GstClockTime ts;
+  gchar *location;
+  guint i;
+
+  location = create_file ();
+  pipeline = setup_pipeline (location);
+
+  /* we start right at the GOP before the requested position */
+  for (i = 0; i < G_N_ELEMENTS (positions); i++) {
+    ts = do_seek (pipeline, positions[i], GST_SEEK_FLAG_KEY_UNIT);
+    fail_unless (first_is_keyframe);
+    fail_unless (ts + GOP_SIZE * GST_SECOND / FPS >= positions[i] &&
+        ts <= positions[i] + 300 * GST_MSECOND,
+        "seek to %" GST_TIME_FORMAT " started at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (positions[i]), GST_TIME_ARGS (ts));
+    fail_unless_equals_uint64 ((ts - FRAME_TS (0)) %
+        (GOP_SIZE * GST_SECOND / FPS), 0);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static Suite *
+mpegpsdemux_suite (void)
+{
+  Suite *s = suite_create ("mpegpsdemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 60);
+
+  tcase_add_test (tc_chain, test_seek_vbr);
+  tcase_add_test (tc_chain, test_seek_keyframe);
+
+  return s;
+}
+
+GST_CHECK_MAIN (mpegpsdemux);
@@ -0,0 +1,252 @@
+/* GStreamer unit tests for mpegpsmux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/base/gstadapter.h>
+
+#include <string.h>
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/mpeg, systemstream = (boolean) true"));
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/mpeg, mpegversion = (int) 1"));
+
+static GstElement *
+setup_mpegpsmux (void)
+{
+  GstElement *mux;
+  GstPad *sinkpad;
+
+  mux = gst_check_setup_element ("mpegpsmux");
+
+  mysrcpad = gst_pad_new_from_static_template (&srctemplate, "src");
+  sinkpad = gst_element_get_request_pad (mux, "sink_%d");
+  fail_unless (sinkpad != NULL);
+  fail_unless (gst_pad_link (mysrcpad, sinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+
+  mysinkpad = gst_check_setup_sink_pad (mux, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  return mux;
+}
+
+static void
+cleanup_mpegpsmux (GstElement * mux)
+{
+  GstPad *sinkpad;
+
+  gst_element_set_state (mux, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+
+  sinkpad = gst_pad_get_peer (mysrcpad);
+  gst_pad_unlink (mysrcpad, sinkpad);
+  gst_element_release_request_pad (mux, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (mysrcpad);
+
+  gst_check_teardown_sink_pad (mux);
+  gst_check_teardown_element (mux);
+}
+
+/* muxes @n_buffers buffers of @size bytes and checks that their data comes
+ * out unchanged in PES packets */
+static void
+mux_buffers (gboolean aggregate_gops, guint n_buffers, guint size)
+{
+  GstElement *mux;
+  GstAdapter *adapter;
+  GstCaps *caps;
+  GList *input = NULL;
+  const guint8 *data;
+  guint i, avail, pos, payload = 0;
+
+  mux = setup_mpegpsmux ();
+  g_object_set (mux, "aggregate-gops", aggregate_gops, NULL);
+  fail_unless_equals_int (gst_element_set_state (mux, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_simple ("audio/mpeg", "mpegversion", G_TYPE_INT, 1,
+      NULL);
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (size);
+    guint j;
+
+    for (j = 0; j < size; j++)
+      GST_BUFFER_DATA (buf)[j] = (i + j) % 0xff;
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 10;
+    gst_buffer_set_caps (buf, caps);
+    input = g_list_prepend (input, buf);
+  }
+  gst_caps_unref (caps);
+  input = g_list_reverse (input);
+
+  while (input) {
+    fail_unless_equals_int (gst_pad_push (mysrcpad, GST_BUFFER (input->data)),
+        GST_FLOW_OK);
+    input = g_list_delete_link (input, input);
+  }
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  adapter = gst_adapter_new ();
+  while (buffers) {
+    gst_adapter_push (adapter, GST_BUFFER (buffers->data));
+    buffers = g_list_delete_link (buffers, buffers);
+  }
+
+  avail = gst_adapter_available (adapter);
+  data = gst_adapter_peek (adapter, avail);
+
+  /* walk the packs and check the payload of the PES packets */
+  fail_unless_equals_int (GST_READ_UINT32_BE (data), 0x000001ba);
+  pos = 0;
+  while (pos + 4 <= avail) {
+    guint32 code = GST_READ_UINT32_BE (data + pos);
+
+    if (code == 0x000001ba) {
+      pos += 14;
+    } else if (code == 0x000001b9) {
+      pos += 4;
+      break;
+    } else {
+      guint len = GST_READ_UINT16_BE (data + pos + 4);
+
+      fail_unless (pos + 6 + len <= avail);
+      if (code == 0x000001c0) {
+        guint hdr_len = 9 + data[pos + 8];
+
+        for (i = hdr_len; i < 6 + len; i++, payload++) {
+          if (data[pos + i] != (payload / size + payload % size) % 0xff)
+            fail ("payload byte %u differs", payload);
+        }
+      }
+      pos += 6 + len;
+    }
+  }
+  fail_unless_equals_int (pos, avail);
+  fail_unless_equals_int (payload, n_buffers * size);
+
+  g_object_unref (adapter);
+  cleanup_mpegpsmux (mux);
+}
+
+GST_START_TEST (test_payload)
+{
+  /* buffers that are split over several PES packets and PES packets
+   * collecting several buffers */
+  mux_buffers (FALSE, 10, 100000);
+  mux_buffers (FALSE, 100, 1000);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_payload_aggregate_gops)
+{
+  mux_buffers (TRUE, 10, 100000);
+}
+
+GST_END_TEST;
+
+static guint n_payload_buffers;
+
+/* only the first buffer of a packet carries caps and a timestamp, the
+ * payload buffers must not keep the ones of the elementary stream */
+static GstFlowReturn
+check_packet_metadata (GstPad * pad, GstBufferList * list)
+{
+  GstBufferListIterator *it;
+
+  it = gst_buffer_list_iterate (list);
+  while (gst_buffer_list_iterator_next_group (it)) {
+    GstBuffer *buf;
+    guint i = 0;
+
+    while ((buf = gst_buffer_list_iterator_next (it))) {
+      if (i++ == 0)
+        continue;
+      fail_unless (GST_BUFFER_CAPS (buf) == NULL);
+      fail_unless (!GST_BUFFER_TIMESTAMP_IS_VALID (buf));
+      fail_unless (!GST_BUFFER_DURATION_IS_VALID (buf));
+      n_payload_buffers++;
+    }
+  }
+  gst_buffer_list_iterator_free (it);
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_payload_metadata)
+{
+  GstElement *mux;
+  GstCaps *caps;
+  guint i;
+
+  mux = setup_mpegpsmux ();
+  gst_pad_set_chain_list_function (mysinkpad, check_packet_metadata);
+  fail_unless_equals_int (gst_element_set_state (mux, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  /* small buffers end up whole in the PES packets */
+  caps = gst_caps_new_simple ("audio/mpeg", "mpegversion", G_TYPE_INT, 1,
+      NULL);
+  n_payload_buffers = 0;
+  for (i = 0; i < 100; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (1000);
+
+    memset (GST_BUFFER_DATA (buf), i, 1000);
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 10;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 10;
+    gst_buffer_set_caps (buf, caps);
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+  gst_caps_unref (caps);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fail_unless (n_payload_buffers >= 100);
+
+  cleanup_mpegpsmux (mux);
+}
+
+GST_END_TEST;
+
+static Suite *
+mpegpsmux_suite (void)
+{
+  Suite *s = suite_create ("mpegpsmux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_payload);
+  tcase_add_test (tc_chain, test_payload_aggregate_gops);
+  tcase_add_test (tc_chain, test_payload_metadata);
+
+  return s;
+}
+
+GST_CHECK_MAIN (mpegpsmux);
@@ -0,0 +1,266 @@
+/* GStreamer unit tests for the openh264 elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <string.h>
+
+#define N_FRAMES 10
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv, "
+        "format = (fourcc) I420, "
+        "width = (int) [1, MAX], "
+        "height = (int) [1, MAX], " "framerate = (fraction) [0, MAX]"));
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv, "
+        "format = (fourcc) I420, "
+        "width = (int) [1, MAX], "
+        "height = (int) [1, MAX], " "framerate = (fraction) [0, MAX]"));
+
+static GstPad *sinkpad, *srcpad;
+
+/* openh264enc ! openh264dec in a bin */
+static GstElement *
+setup_openh264 (GstCaps * srccaps)
+{
+  GstElement *bin;
+  GstElement *enc, *dec;
+  GstBus *bus;
+  GstPad *ghostpad, *targetpad;
+
+  bin = gst_bin_new ("bin");
+
+  enc = gst_check_setup_element ("openh264enc");
+  fail_unless (enc != NULL);
+  dec = gst_check_setup_element ("openh264dec");
+  fail_unless (dec != NULL);
+
+  gst_bin_add_many (GST_BIN (bin), enc, dec, NULL);
+  fail_unless (gst_element_link_pads (enc, "src", dec, "sink"));
+
+  targetpad = gst_element_get_static_pad (enc, "sink");
+  fail_unless (targetpad != NULL);
+  ghostpad = gst_ghost_pad_new ("sink", targetpad);
+  fail_unless (ghostpad != NULL);
+  gst_element_add_pad (bin, ghostpad);
+  gst_object_unref (targetpad);
+
+  targetpad = gst_element_get_static_pad (dec, "src");
+  fail_unless (targetpad != NULL);
+  ghostpad = gst_ghost_pad_new ("src", targetpad);
+  fail_unless (ghostpad != NULL);
+  gst_element_add_pad (bin, ghostpad);
+  gst_object_unref (targetpad);
+
+  srcpad = gst_check_setup_src_pad (bin, &srctemplate, srccaps);
+  sinkpad = gst_check_setup_sink_pad (bin, &sinktemplate, NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (bin, bus);
+
+  fail_unless (gst_element_set_state (bin,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE,
+      "could not set to playing");
+
+  buffers = NULL;
+  return bin;
+}
+
+static void
+cleanup_openh264 (GstElement * bin)
+{
+  GstBus *bus;
+
+  gst_check_drop_buffers ();
+
+  bus = GST_ELEMENT_BUS (bin);
+  gst_bus_set_flushing (bus, TRUE);
+  gst_object_unref (bus);
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+
+  gst_check_teardown_src_pad (bin);
+  gst_check_teardown_sink_pad (bin);
+  gst_check_teardown_element (bin);
+}
+
+/* a smooth picture, moving by a pixel every frame, that survives the
+ * encoder's default bitrate well */
+static GstBuffer *
+make_frame (GstCaps * caps, gint width, gint height, gint index)
+{
+  GstBuffer *buffer;
+  gint c, x, y;
+
+  buffer = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, width, height));
+  memset (GST_BUFFER_DATA (buffer), 0, GST_BUFFER_SIZE (buffer));
+
+  for (c = 0; c < 3; c++) {
+    guint8 *data;
+    gint w, h, stride;
+
+    data = GST_BUFFER_DATA (buffer) +
+        gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, c,
+        width, height);
+    stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, c, width);
+    w = gst_video_format_get_component_width (GST_VIDEO_FORMAT_I420, c, width);
+    h = gst_video_format_get_component_height (GST_VIDEO_FORMAT_I420, c,
+        height);
+
+    for (y = 0; y < h; y++)
+      for (x = 0; x < w; x++)
+        data[y * stride + x] = (c == 0) ? 16 + ((x + y + index) % 224) / 2 :
+            128 + (c == 1 ? 1 : -1) * (((x + index) % w) * 32 / w);
+  }
+
+  GST_BUFFER_TIMESTAMP (buffer) = gst_util_uint64_scale (index, GST_SECOND,
+      25);
+  GST_BUFFER_DURATION (buffer) = gst_util_uint64_scale (1, GST_SECOND, 25);
+  gst_buffer_set_caps (buffer, caps);
+
+  return buffer;
+}
+
+/* mean absolute difference of the visible pixels of @a and @b */
+static gdouble
+frame_difference (GstBuffer * a, GstBuffer * b, gint width, gint height)
+{
+  guint64 sum = 0, n = 0;
+  gint c, x, y;
+
+  for (c = 0; c < 3; c++) {
+    const guint8 *da, *db;
+    gint offset, w, h, stride;
+
+    offset = gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, c,
+        width, height);
+    stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, c, width);
+    w = gst_video_format_get_component_width (GST_VIDEO_FORMAT_I420, c, width);
+    h = gst_video_format_get_component_height (GST_VIDEO_FORMAT_I420, c,
+        height);
+    da = GST_BUFFER_DATA (a) + offset;
+    db = GST_BUFFER_DATA (b) + offset;
+
+    for (y = 0; y < h; y++) {
+      for (x = 0; x < w; x++)
+        sum += ABS (da[y * stride + x] - db[y * stride + x]);
+      n += w;
+    }
+  }
+
+  return gst_guint64_to_gdouble (sum) / n;
+}
+
+static void
+check_round_trip (gint width, gint height)
+{
+  GstElement *bin;
+  GstBuffer *inbufs[N_FRAMES];
+  GstCaps *caps;
+  GList *l;
+  gint i;
+
+  caps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, width, height, 25,
+      1, 1, 1);
+  bin = setup_openh264 (caps);
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_new_segment (FALSE,
+              1.0, GST_FORMAT_TIME, 0, gst_util_uint64_scale (N_FRAMES,
+                  GST_SECOND, 25), 0)));
+
+  for (i = 0; i < N_FRAMES; i++) {
+    inbufs[i] = make_frame (caps, width, height, i);
+    fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_ref (inbufs[i])),
+        GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_eos ()));
+
+  /* baseline, so the frames come out in input order */
+  fail_unless_equals_int (g_list_length (buffers), N_FRAMES);
+
+  for (l = buffers, i = 0; l; l = l->next, i++) {
+    GstBuffer *buffer = l->data;
+    gdouble diff;
+
+    fail_unless_equals_int (GST_BUFFER_SIZE (buffer),
+        GST_BUFFER_SIZE (inbufs[i]));
+    fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buffer),
+        GST_BUFFER_TIMESTAMP (inbufs[i]));
+    fail_unless (gst_caps_can_intersect (GST_BUFFER_CAPS (buffer), caps));
+
+    diff = frame_difference (buffer, inbufs[i], width, height);
+    fail_unless (diff < 4.0, "%dx%d frame %d differs by %.2f on average",
+        width, height, i, diff);
+
+    gst_buffer_unref (inbufs[i]);
+  }
+
+  cleanup_openh264 (bin);
+  gst_caps_unref (caps);
+}
+
+GST_START_TEST (test_round_trip)
+{
+  check_round_trip (320, 240);
+}
+
+GST_END_TEST;
+
+/* the I420 rows are padded to 4 bytes and openh264's planes are padded
+ * differently, so every plane is copied row by row */
+GST_START_TEST (test_round_trip_padded)
+{
+  check_round_trip (322, 242);
+}
+
+GST_END_TEST;
+
+static Suite *
+openh264_suite (void)
+{
+  Suite *s = suite_create ("openh264");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  if (gst_default_registry_check_feature_version ("openh264enc",
+          GST_VERSION_MAJOR, GST_VERSION_MINOR, 0) &&
+      gst_default_registry_check_feature_version ("openh264dec",
+          GST_VERSION_MAJOR, GST_VERSION_MINOR, 0)) {
+    tcase_add_test (tc_chain, test_round_trip);
+    tcase_add_test (tc_chain, test_round_trip_padded);
+  } else {
+    GST_WARNING ("openh264 elements not available, skipping tests");
+  }
+
+  return s;
+}
+
+GST_CHECK_MAIN (openh264);
@@ -0,0 +1,477 @@
+/* GStreamer
+ *
+ * unit test for pcapparse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <string.h>
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("raw/x-pcap"));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* what arrived on one of the pads of pcapparse */
+typedef struct
+{
+  GstPad *pad;
+  GList *buffers;
+  guint n_lists;
+} Output;
+
+static GstFlowReturn
+output_chain (GstPad * pad, GstBuffer * buf)
+{
+  gst_buffer_unref (buf);
+  fail ("payloads are not pushed in buffer lists");
+
+  return GST_FLOW_ERROR;
+}
+
+static GstBufferListItem
+output_add_buffer (GstBuffer ** buf, guint group, guint idx, Output * output)
+{
+  output->buffers = g_list_append (output->buffers, gst_buffer_ref (*buf));
+
+  return GST_BUFFER_LIST_CONTINUE;
+}
+
+static GstFlowReturn
+output_chain_list (GstPad * pad, GstBufferList * list)
+{
+  Output *output = gst_pad_get_element_private (pad);
+  guint n_buffers = g_list_length (output->buffers);
+
+  output->n_lists++;
+  gst_buffer_list_foreach (list, (GstBufferListFunc) output_add_buffer,
+      output);
+  /* one group per payload */
+  fail_unless_equals_int (gst_buffer_list_n_groups (list),
+      g_list_length (output->buffers) - n_buffers);
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+static void
+output_link (Output * output, GstPad * srcpad)
+{
+  memset (output, 0, sizeof (Output));
+  output->pad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_element_private (output->pad, output);
+  gst_pad_set_chain_function (output->pad, output_chain);
+  gst_pad_set_chain_list_function (output->pad, output_chain_list);
+  fail_unless_equals_int (gst_pad_link (srcpad, output->pad),
+      GST_PAD_LINK_OK);
+  gst_pad_set_active (output->pad, TRUE);
+}
+
+static void
+output_free (Output * output)
+{
+  gst_pad_set_active (output->pad, FALSE);
+  gst_object_unref (output->pad);
+  g_list_foreach (output->buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (output->buffers);
+}
+
+static GstElement *
+setup_pcapparse (Output * src_output)
+{
+  GstElement *pcapparse;
+  GstPad *pad;
+
+  pcapparse = gst_check_setup_element ("pcapparse");
+  mysrcpad = gst_check_setup_src_pad (pcapparse, &srctemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  pad = gst_element_get_static_pad (pcapparse, "src");
+  output_link (src_output, pad);
+  gst_object_unref (pad);
+
+  return pcapparse;
+}
+
+static void
+cleanup_pcapparse (GstElement * pcapparse, Output * src_output)
+{
+  GstPad *pad;
+
+  gst_element_set_state (pcapparse, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  pad = gst_element_get_static_pad (pcapparse, "src");
+  gst_pad_unlink (pad, src_output->pad);
+  gst_object_unref (pad);
+  output_free (src_output);
+  gst_check_teardown_src_pad (pcapparse);
+  gst_check_teardown_element (pcapparse);
+}
+
+static void
+append_uint16 (GByteArray * data, guint16 val)
+{
+  guint8 tmp[2];
+
+  GST_WRITE_UINT16_LE (tmp, val);
+  g_byte_array_append (data, tmp, 2);
+}
+
+static void
+append_uint32 (GByteArray * data, guint32 val)
+{
+  guint8 tmp[4];
+
+  GST_WRITE_UINT32_LE (tmp, val);
+  g_byte_array_append (data, tmp, 4);
+}
+
+static void
+append_padding (GByteArray * data)
+{
+  static const guint8 zeroes[4] = { 0, };
+
+  g_byte_array_append (data, zeroes, GST_ROUND_UP_4 (data->len) - data->len);
+}
+
+/* an Ethernet frame with a UDP packet to 239.0.0.@dst:5004 carrying
+ * "payload @n" */
+static GByteArray *
+create_frame (guint8 dst, guint n)
+{
+  GByteArray *frame = g_byte_array_new ();
+  gchar *payload = g_strdup_printf ("payload %u", n);
+  guint len = strlen (payload);
+  guint8 hdr[14 + 20 + 8] = { 0, };
+
+  /* Ethernet */
+  GST_WRITE_UINT16_BE (hdr + 12, 0x0800);
+  /* IPv4 from 10.0.0.1 */
+  hdr[14] = 0x45;
+  GST_WRITE_UINT16_BE (hdr + 16, 20 + 8 + len);
+  hdr[14 + 8] = 64;
+  hdr[14 + 9] = 17;
+  hdr[14 + 12] = 10;
+  hdr[14 + 15] = 1;
+  hdr[14 + 16] = 239;
+  hdr[14 + 19] = dst;
+  /* UDP */
+  GST_WRITE_UINT16_BE (hdr + 34, 1234);
+  GST_WRITE_UINT16_BE (hdr + 36, 5004);
+  GST_WRITE_UINT16_BE (hdr + 38, 8 + len);
+
+  g_byte_array_append (frame, hdr, sizeof (hdr));
+  g_byte_array_append (frame, (guint8 *) payload, len);
+  g_free (payload);
+
+  return frame;
+}
+
+static void
+append_pcapng_shb (GByteArray * data)
+{
+  append_uint32 (data, 0x0a0d0d0a);
+  append_uint32 (data, 28);
+  append_uint32 (data, 0x1a2b3c4d);
+  append_uint16 (data, 1);
+  append_uint16 (data, 0);
+  /* unknown section length */
+  append_uint32 (data, 0xffffffff);
+  append_uint32 (data, 0xffffffff);
+  append_uint32 (data, 28);
+}
+
+/* an Ethernet interface, with an if_tsresol option if @tsresol >= 0 */
+static void
+append_pcapng_idb (GByteArray * data, gint tsresol)
+{
+  guint32 len = tsresol >= 0 ? 32 : 20;
+  guint8 resol = tsresol;
+
+  append_uint32 (data, 0x00000001);
+  append_uint32 (data, len);
+  append_uint16 (data, 1);
+  append_uint16 (data, 0);
+  append_uint32 (data, 65535);
+  if (tsresol >= 0) {
+    append_uint16 (data, 9);
+    append_uint16 (data, 1);
+    g_byte_array_append (data, &resol, 1);
+    append_padding (data);
+    append_uint16 (data, 0);
+    append_uint16 (data, 0);
+  }
+  append_uint32 (data, len);
+}
+
+static void
+append_pcapng_epb (GByteArray * data, guint32 iface, guint64 ts,
+    GByteArray * frame)
+{
+  guint32 len = 32 + GST_ROUND_UP_4 (frame->len);
+
+  append_uint32 (data, 0x00000006);
+  append_uint32 (data, len);
+  append_uint32 (data, iface);
+  append_uint32 (data, ts >> 32);
+  append_uint32 (data, ts & 0xffffffff);
+  append_uint32 (data, frame->len);
+  append_uint32 (data, frame->len);
+  g_byte_array_append (data, frame->data, frame->len);
+  append_padding (data);
+  append_uint32 (data, len);
+  g_byte_array_free (frame, TRUE);
+}
+
+static void
+append_pcapng_spb (GByteArray * data, GByteArray * frame)
+{
+  guint32 len = 16 + GST_ROUND_UP_4 (frame->len);
+
+  append_uint32 (data, 0x00000003);
+  append_uint32 (data, len);
+  append_uint32 (data, frame->len);
+  g_byte_array_append (data, frame->data, frame->len);
+  append_padding (data);
+  append_uint32 (data, len);
+  g_byte_array_free (frame, TRUE);
+}
+
+static GstBuffer *
+create_buffer (GByteArray * data)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_and_alloc (data->len);
+  memcpy (GST_BUFFER_DATA (buf), data->data, data->len);
+  g_byte_array_free (data, TRUE);
+
+  return buf;
+}
+
+/* a pcapng capture with a nanosecond and a microsecond interface, the
+ * packets go to 239.0.0.1, 239.0.0.2 and 239.0.0.1 again */
+static GstBuffer *
+create_pcapng (void)
+{
+  GByteArray *data = g_byte_array_new ();
+
+  append_pcapng_shb (data);
+  append_pcapng_idb (data, 9);
+  append_pcapng_idb (data, -1);
+  append_pcapng_epb (data, 0, G_GUINT64_CONSTANT (1000000123),
+      create_frame (1, 0));
+  append_pcapng_epb (data, 1, G_GUINT64_CONSTANT (2000001),
+      create_frame (2, 1));
+  append_pcapng_spb (data, create_frame (1, 2));
+
+  return create_buffer (data);
+}
+
+/* a classic capture with nanosecond timestamps */
+static GstBuffer *
+create_pcap_nsec (void)
+{
+  GByteArray *data = g_byte_array_new ();
+  guint i;
+
+  append_uint32 (data, 0xa1b23c4d);
+  append_uint16 (data, 2);
+  append_uint16 (data, 4);
+  append_uint32 (data, 0);
+  append_uint32 (data, 0);
+  append_uint32 (data, 65535);
+  append_uint32 (data, 1);
+
+  for (i = 0; i < 3; i++) {
+    GByteArray *frame = create_frame (1, i);
+
+    append_uint32 (data, 10 + i);
+    append_uint32 (data, 999999999 - i);
+    append_uint32 (data, frame->len);
+    append_uint32 (data, frame->len);
+    g_byte_array_append (data, frame->data, frame->len);
+    g_byte_array_free (frame, TRUE);
+  }
+
+  return create_buffer (data);
+}
+
+/* checks that @buf is payload @n with timestamp @ts and that it was not
+ * copied out of @input */
+static void
+check_payload (GstBuffer * buf, GstBuffer * input, guint n, GstClockTime ts)
+{
+  gchar *payload = g_strdup_printf ("payload %u", n);
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf), strlen (payload));
+  fail_unless (memcmp (GST_BUFFER_DATA (buf), payload,
+          GST_BUFFER_SIZE (buf)) == 0);
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buf), ts);
+  fail_unless (GST_BUFFER_DATA (buf) > GST_BUFFER_DATA (input) &&
+      GST_BUFFER_DATA (buf) + GST_BUFFER_SIZE (buf) <=
+      GST_BUFFER_DATA (input) + GST_BUFFER_SIZE (input));
+  g_free (payload);
+}
+
+GST_START_TEST (test_pcap_nsec)
+{
+  GstElement *pcapparse;
+  GstBuffer *input;
+  Output output;
+  GList *l;
+  guint i;
+
+  pcapparse = setup_pcapparse (&output);
+  fail_unless_equals_int (gst_element_set_state (pcapparse,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  input = create_pcap_nsec ();
+  fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (input)),
+      GST_FLOW_OK);
+
+  /* one list for the input buffer */
+  fail_unless_equals_int (output.n_lists, 1);
+  fail_unless_equals_int (g_list_length (output.buffers), 3);
+  for (l = output.buffers, i = 0; l; l = l->next, i++)
+    check_payload (l->data, input, i, (10 + i) * GST_SECOND + 999999999 - i);
+
+  gst_buffer_unref (input);
+  cleanup_pcapparse (pcapparse, &output);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pcapng)
+{
+  GstElement *pcapparse;
+  GstBuffer *input;
+  Output output;
+
+  pcapparse = setup_pcapparse (&output);
+  fail_unless_equals_int (gst_element_set_state (pcapparse,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  input = create_pcapng ();
+  fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (input)),
+      GST_FLOW_OK);
+
+  fail_unless_equals_int (output.n_lists, 1);
+  fail_unless_equals_int (g_list_length (output.buffers), 3);
+  /* if_tsresol 9 is nanoseconds, the default is microseconds and simple
+   * packet blocks have no timestamp */
+  check_payload (g_list_nth_data (output.buffers, 0), input, 0,
+      GST_SECOND + 123);
+  check_payload (g_list_nth_data (output.buffers, 1), input, 1,
+      2 * GST_SECOND + GST_USECOND);
+  check_payload (g_list_nth_data (output.buffers, 2), input, 2,
+      GST_CLOCK_TIME_NONE);
+
+  gst_buffer_unref (input);
+  cleanup_pcapparse (pcapparse, &output);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flows)
+{
+  GstElement *pcapparse;
+  GstBuffer *input;
+  GstPad *flow_pads[2];
+  Output output, flow_outputs[2];
+  gint i;
+
+  pcapparse = setup_pcapparse (&output);
+  g_object_set (pcapparse, "flows",
+      "udp:*:*:239.0.0.1:5004;udp:10.0.0.1:1234:239.0.0.2:*", NULL);
+  /* request them the other way around, the name decides the flow */
+  for (i = 1; i >= 0; i--) {
+    gchar *name = g_strdup_printf ("src_%d", i);
+
+    flow_pads[i] = gst_element_get_request_pad (pcapparse, name);
+    fail_unless (flow_pads[i] != NULL);
+    fail_unless_equals_string (GST_PAD_NAME (flow_pads[i]), name);
+    output_link (&flow_outputs[i], flow_pads[i]);
+    g_free (name);
+  }
+  /* there are only two flows */
+  fail_unless (gst_element_get_request_pad (pcapparse, "src_2") == NULL);
+
+  fail_unless_equals_int (gst_element_set_state (pcapparse,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  input = create_pcapng ();
+  fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (input)),
+      GST_FLOW_OK);
+
+  /* the properties don't filter anything, all payloads go to src */
+  fail_unless_equals_int (output.n_lists, 1);
+  fail_unless_equals_int (g_list_length (output.buffers), 3);
+
+  fail_unless_equals_int (flow_outputs[0].n_lists, 1);
+  fail_unless_equals_int (g_list_length (flow_outputs[0].buffers), 2);
+  check_payload (g_list_nth_data (flow_outputs[0].buffers, 0), input, 0,
+      GST_SECOND + 123);
+  check_payload (g_list_nth_data (flow_outputs[0].buffers, 1), input, 2,
+      GST_CLOCK_TIME_NONE);
+
+  fail_unless_equals_int (flow_outputs[1].n_lists, 1);
+  fail_unless_equals_int (g_list_length (flow_outputs[1].buffers), 1);
+  check_payload (flow_outputs[1].buffers->data, input, 1,
+      2 * GST_SECOND + GST_USECOND);
+
+  /* the pads share the payloads */
+  fail_unless (g_list_nth_data (output.buffers, 1) ==
+      flow_outputs[1].buffers->data);
+
+  gst_buffer_unref (input);
+
+  gst_element_set_state (pcapparse, GST_STATE_NULL);
+  for (i = 0; i < 2; i++) {
+    gst_pad_unlink (flow_pads[i], flow_outputs[i].pad);
+    gst_element_release_request_pad (pcapparse, flow_pads[i]);
+    gst_object_unref (flow_pads[i]);
+    output_free (&flow_outputs[i]);
+  }
+  cleanup_pcapparse (pcapparse, &output);
+}
+
+GST_END_TEST;
+
+static Suite *
+pcapparse_suite (void)
+{
+  Suite *s = suite_create ("pcapparse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_pcap_nsec);
+  tcase_add_test (tc_chain, test_pcapng);
+  tcase_add_test (tc_chain, test_flows);
+
+  return s;
+}
+
+GST_CHECK_MAIN (pcapparse);
@@ -0,0 +1,217 @@
+/* GStreamer unit tests for sdimux and sdidemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#define N_FRAMES 3
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate sdi_sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("application/x-raw-sdi"));
+
+static GstStaticPadTemplate uyvy_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv,format=(fourcc)UYVY"));
+
+static GstStaticPadTemplate v210_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv,format=(fourcc)v210"));
+
+static GstStaticPadTemplate v216_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv,format=(fourcc)v216"));
+
+/* fills a frame with samples that survive the trip through 10-bit SDI,
+ * i.e. stay out of the timing reference code range */
+static void
+fill_frame (guint8 * data, guint size, guint32 fourcc, guint frame)
+{
+  guint i;
+
+  switch (fourcc) {
+    case GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'):
+      for (i = 0; i < size; i++)
+        data[i] = 16 + (i * 7 + frame * 13) % 220;
+      break;
+    case GST_MAKE_FOURCC ('v', '2', '1', '0'):
+      for (i = 0; i < size / 4; i++)
+        GST_WRITE_UINT32_LE (data + i * 4,
+            (4 + (i * 3 + frame * 13) % 1000) |
+            ((4 + (i * 3 + 1 + frame * 13) % 1000) << 10) |
+            ((4 + (i * 3 + 2 + frame * 13) % 1000) << 20));
+      break;
+    case GST_MAKE_FOURCC ('v', '2', '1', '6'):
+      for (i = 0; i < size / 2; i++)
+        GST_WRITE_UINT16_LE (data + i * 2,
+            (4 + (i * 7 + frame * 13) % 1000) << 6);
+      break;
+    default:
+      g_assert_not_reached ();
+  }
+}
+
+static GList *
+run_element (const gchar * name, GstStaticPadTemplate * sinktemplate,
+    GList * input)
+{
+  GstElement *element;
+  GList *l, *output;
+
+  element = gst_check_setup_element (name);
+  mysrcpad = gst_check_setup_src_pad (element, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (element, sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless_equals_int (gst_element_set_state (element, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  for (l = input; l; l = l->next)
+    fail_unless_equals_int (gst_pad_push (mysrcpad,
+            gst_buffer_ref (GST_BUFFER (l->data))), GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  output = buffers;
+  buffers = NULL;
+
+  gst_element_set_state (element, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (element);
+  gst_check_teardown_sink_pad (element);
+  gst_check_teardown_element (element);
+
+  return output;
+}
+
+static void
+free_buffers (GList * list)
+{
+  g_list_foreach (list, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (list);
+}
+
+/* muxes N_FRAMES into SDI and demuxes them again; the demuxer only starts
+ * outputting at the first frame boundary it sees, so @skip frames are
+ * lost at the start */
+static void
+check_roundtrip (const gchar * caps_string, guint32 fourcc,
+    GstStaticPadTemplate * video_template, guint frame_size,
+    guint sdi_size, guint skip)
+{
+  GstCaps *caps;
+  GList *frames = NULL, *sdi, *output, *l;
+  guint i;
+
+  caps = gst_caps_from_string (caps_string);
+  for (i = 0; i < N_FRAMES; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (frame_size);
+
+    fill_frame (GST_BUFFER_DATA (buf), frame_size, fourcc, i);
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 25;
+    gst_buffer_set_caps (buf, caps);
+    frames = g_list_append (frames, buf);
+  }
+  gst_caps_unref (caps);
+
+  sdi = run_element ("sdimux", &sdi_sinktemplate, frames);
+  fail_unless_equals_int (g_list_length (sdi), N_FRAMES);
+  for (l = sdi; l; l = l->next)
+    fail_unless_equals_int (GST_BUFFER_SIZE (l->data), sdi_size);
+
+  output = run_element ("sdidemux", video_template, sdi);
+  fail_unless_equals_int (g_list_length (output), N_FRAMES - skip);
+
+  for (l = output, i = skip; l; l = l->next, i++) {
+    GstBuffer *in = g_list_nth_data (frames, i);
+    GstBuffer *out = l->data;
+
+    fail_unless (GST_BUFFER_SIZE (out) >= frame_size);
+    fail_unless (memcmp (GST_BUFFER_DATA (in), GST_BUFFER_DATA (out),
+            frame_size) == 0, "frame %u differs", i);
+  }
+
+  free_buffers (frames);
+  free_buffers (sdi);
+  free_buffers (output);
+}
+
+GST_START_TEST (test_ntsc_v210)
+{
+  check_roundtrip ("video/x-raw-yuv,format=(fourcc)v210,width=720,"
+      "height=480,framerate=30000/1001,interlaced=TRUE,"
+      "pixel-aspect-ratio=10/11,chroma-site=mpeg2,color-matrix=sdtv",
+      GST_MAKE_FOURCC ('v', '2', '1', '0'),
+      &v210_sinktemplate, 1920 * 480, 858 / 2 * 5 * 525, 1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_1080i_uyvy)
+{
+  check_roundtrip ("video/x-raw-yuv,format=(fourcc)UYVY,width=1920,"
+      "height=1080,framerate=25/1,interlaced=TRUE,pixel-aspect-ratio=1/1,"
+      "color-matrix=hdtv",
+      GST_MAKE_FOURCC ('U', 'Y', 'V', 'Y'), &uyvy_sinktemplate,
+      1920 * 2 * 1080, 2640 / 2 * 5 * 1125, 1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_720p_v216)
+{
+  /* the first frame is complete, the stream starts in vertical blanking */
+  check_roundtrip ("video/x-raw-yuv,format=(fourcc)v216,width=1280,"
+      "height=720,framerate=60000/1001,interlaced=FALSE,"
+      "pixel-aspect-ratio=1/1,color-matrix=hdtv",
+      GST_MAKE_FOURCC ('v', '2', '1', '6'),
+      &v216_sinktemplate, 1280 * 4 * 720, 1650 / 2 * 5 * 750, 0);
+}
+
+GST_END_TEST;
+
+static Suite *
+sdidemux_suite (void)
+{
+  Suite *s = suite_create ("sdidemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_ntsc_v210);
+  tcase_add_test (tc_chain, test_1080i_uyvy);
+  tcase_add_test (tc_chain, test_720p_v216);
+
+  return s;
+}
+
+GST_CHECK_MAIN (sdidemux);
@@ -0,0 +1,569 @@
+/* GStreamer unit tests for tsdemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PMT_PID 0x100
+#define VIDEO_PID 0x101
+
+/* 60s of H.264 at 25 fps with a keyframe every second. The first half of
+ * the file has a much lower bitrate than the second half, so a purely linear
+ * offset estimation is way off */
+#define FPS 25
+#define N_FRAMES (60 * FPS)
+#define GOP_SIZE FPS
+#define SMALL_FRAME 600
+#define BIG_FRAME 12000
+
+/* The first PCR is at 1s, PTS are 300ms after the PCR */
+#define PCR_BASE G_GUINT64_CONSTANT (27000000)
+#define PCR_PER_FRAME (27000000 / FPS)
+#define PTS_DELAY 27000
+
+/* output timestamps are relative to the first PCR */
+#define FRAME_TS(n) ((n) * GST_SECOND / FPS + 300 * GST_MSECOND)
+
+static guint32
+crc32_mpeg (const guint8 * data, guint size)
+{
+  guint32 crc = 0xffffffff;
+  guint i, j;
+
+  for (i = 0; i < size; i++) {
+    crc ^= (guint32) data[i] << 24;
+    for (j = 0; j < 8; j++)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+  }
+
+  return crc;
+}
+
+/* Writes one packet with as much of @payload as fits, stuffing the
+ * adaptation field if needed. Returns the number of payload bytes written */
+static guint
+write_packet (GByteArray * ts, guint16 pid, gboolean pusi, guint8 * cc,
+    const guint8 * payload, guint size, gboolean has_pcr, guint64 pcr,
+    gboolean random_access)
+{
+  guint8 pkt[188];
+  guint n, af_len, pos;
+
+  pkt[0] = 0x47;
+  pkt[1] = (pusi ? 0x40 : 0x00) | (pid >> 8);
+  pkt[2] = pid & 0xff;
+
+  if (!has_pcr && !random_access && size >= 184) {
+    pkt[3] = 0x10 | *cc;
+    n = 184;
+    pos = 4;
+  } else {
+    guint content = (has_pcr || random_access || size < 183) ?
+        1 + (has_pcr ? 6 : 0) : 0;
+
+    n = MIN (size, 183 - content);
+    af_len = 183 - n;
+    pkt[3] = 0x30 | *cc;
+    pkt[4] = af_len;
+    pos = 5;
+    if (content) {
+      pkt[pos++] = (random_access ? 0x40 : 0x00) | (has_pcr ? 0x10 : 0x00);
+      if (has_pcr) {
+        guint64 base = pcr / 300;
+        guint ext = pcr % 300;
+
+        pkt[pos++] = base >> 25;
+        pkt[pos++] = base >> 17;
+        pkt[pos++] = base >> 9;
+        pkt[pos++] = base >> 1;
+        pkt[pos++] = ((base & 1) << 7) | 0x7e | (ext >> 8);
+        pkt[pos++] = ext & 0xff;
+      }
+    }
+    memset (pkt + pos, 0xff, 5 + af_len - pos);
+    pos = 5 + af_len;
+  }
+  memcpy (pkt + pos, payload, n);
+  *cc = (*cc + 1) & 0xf;
+
+  g_byte_array_append (ts, pkt, 188);
+
+  return n;
+}
+
+static void
+write_section (GByteArray * ts, guint16 pid, guint8 * cc, guint8 * section,
+    guint size)
+{
+  guint8 payload[184];
+  guint32 crc;
+
+  crc = crc32_mpeg (section, size - 4);
+  GST_WRITE_UINT32_BE (section + size - 4, crc);
+
+  memset (payload, 0xff, sizeof (payload));
+  payload[0] = 0;               /* pointer field */
+  memcpy (payload + 1, section, size);
+  write_packet (ts, pid, TRUE, cc, payload, 184, FALSE, 0, FALSE);
+}
+
+static void
+write_psi (GByteArray * ts, guint8 * pat_cc, guint8 * pmt_cc)
+{
+  guint8 pat[] = { 0x00, 0xb0, 13, 0x00, 0x01, 0xc1, 0x00, 0x00,
+    0x00, 0x01, 0xe0 | (PMT_PID >> 8), PMT_PID & 0xff, 0, 0, 0, 0
+  };
+  guint8 pmt[] = { 0x02, 0xb0, 18, 0x00, 0x01, 0xc1, 0x00, 0x00,
+    0xe0 | (VIDEO_PID >> 8), VIDEO_PID & 0xff, 0xf0, 0x00,
+    0x1b, 0xe0 | (VIDEO_PID >> 8), VIDEO_PID & 0xff, 0xf0, 0x00,
+    0, 0, 0, 0
+  };
+
+  write_section (ts, 0, pat_cc, pat, sizeof (pat));
+  write_section (ts, PMT_PID, pmt_cc, pmt, sizeof (pmt));
+}
+
+static void
+write_frame (GByteArray * ts, guint n, guint64 pts_delay, guint8 * cc)
+{
+  static const guint8 aud[] = { 0x00, 0x00, 0x00, 0x01, 0x09, 0xf0 };
+  gboolean keyframe = (n % GOP_SIZE) == 0;
+  guint64 pcr = PCR_BASE + (guint64) n * PCR_PER_FRAME;
+  guint64 pts = pcr / 300 + pts_delay;
+  guint es_size, size, pos, written;
+  guint8 *pes;
+
+  es_size = n < N_FRAMES / 2 ? SMALL_FRAME : BIG_FRAME;
+  es_size += (n * 7919) % (es_size / 4);
+  if (keyframe)
+    es_size *= 2;
+
+  size = 14 + es_size;
+  pes = g_malloc (size);
+
+  /* PES header with PTS, unbounded length */
+  pes[0] = 0x00;
+  pes[1] = 0x00;
+  pes[2] = 0x01;
+  pes[3] = 0xe0;
+  pes[4] = 0x00;
+  pes[5] = 0x00;
+  pes[6] = 0x80;
+  pes[7] = 0x80;
+  pes[8] = 5;
+  pes[9] = 0x21 | ((pts >> 29) & 0x0e);
+  pes[10] = (pts >> 22) & 0xff;
+  pes[11] = ((pts >> 14) & 0xfe) | 1;
+  pes[12] = (pts >> 7) & 0xff;
+  pes[13] = ((pts << 1) & 0xfe) | 1;
+
+  /* AUD followed by an IDR or non-IDR slice */
+  memcpy (pes + 14, aud, sizeof (aud));
+  pes[20] = 0x00;
+  pes[21] = 0x00;
+  pes[22] = 0x01;
+  pes[23] = keyframe ? 0x65 : 0x41;
+  memset (pes + 24, 0x55, size - 24);
+
+  for (pos = 0; pos < size; pos += written)
+    written = write_packet (ts, VIDEO_PID, pos == 0, cc, pes + pos,
+        size - pos, pos == 0, pcr, pos == 0 && keyframe);
+
+  g_free (pes);
+}
+
+static gchar *
+create_file (void)
+{
+  GByteArray *ts;
+  GError *err = NULL;
+  gchar *location;
+  guint8 pat_cc = 0, pmt_cc = 0, video_cc = 0;
+  guint n;
+  gint fd;
+
+  fd = g_file_open_tmp ("tsdemux-XXXXXX.ts", &location, &err);
+  fail_unless (fd >= 0, "could not create file: %s", err ? err->message : "");
+  close (fd);
+
+  ts = g_byte_array_new ();
+  for (n = 0; n < N_FRAMES; n++) {
+    if (n % GOP_SIZE == 0)
+      write_psi (ts, &pat_cc, &pmt_cc);
+    write_frame (ts, n, PTS_DELAY, &video_cc);
+  }
+
+  fail_unless (g_file_set_contents (location, (gchar *) ts->data, ts->len,
+          NULL));
+  GST_INFO ("wrote %u bytes to %s", ts->len, location);
+  g_byte_array_free (ts, TRUE);
+
+  return location;
+}
+
+/* first buffer after a flush */
+static gboolean flushed;
+static GstClockTime first_ts;
+static gboolean first_is_idr;
+
+static gboolean
+event_probe (GstPad * pad, GstEvent * event, gpointer user_data)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+    flushed = TRUE;
+  return TRUE;
+}
+
+static gboolean
+buffer_probe (GstPad * pad, GstBuffer * buffer, gpointer user_data)
+{
+  if (flushed) {
+    flushed = FALSE;
+    first_ts = GST_BUFFER_TIMESTAMP (buffer);
+    first_is_idr = GST_BUFFER_SIZE (buffer) > 9 &&
+        (GST_BUFFER_DATA (buffer)[9] & 0x1f) == 5;
+  }
+  return TRUE;
+}
+
+static GstElement *
+setup_pipeline (const gchar * location, const gchar * index)
+{
+  GstElement *pipeline, *sink, *demux;
+  GstPad *pad;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! tsdemux name=demux ! "
+      "fakesink name=sink sync=false", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  demux = gst_bin_get_by_name (GST_BIN (pipeline), "demux");
+  g_object_set (demux, "index-location", index, NULL);
+  gst_object_unref (demux);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_event_probe (pad, G_CALLBACK (event_probe), NULL);
+  gst_pad_add_buffer_probe (pad, G_CALLBACK (buffer_probe), NULL);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+
+  return pipeline;
+}
+
+static GstClockTime
+do_seek (GstElement * pipeline, GstClockTime position)
+{
+  first_ts = GST_CLOCK_TIME_NONE;
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH, position));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  GST_DEBUG ("seek to %" GST_TIME_FORMAT ", first buffer %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (position), GST_TIME_ARGS (first_ts));
+
+  fail_unless (GST_CLOCK_TIME_IS_VALID (first_ts));
+  return first_ts;
+}
+
+GST_START_TEST (test_seek_vbr)
+{
+  static const GstClockTime positions[] = {
+    10 * GST_SECOND, 20 * GST_SECOND, 40 * GST_SECOND, 55 * GST_SECOND
+  };
+  GstElement *pipeline;
+  GstClockTime ts;
+  gchar *location;
+  guint i;
+
+  location = create_file ();
+  pipeline = setup_pipeline (location, NULL);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  /* we land shortly before the requested position despite the bitrate
+   * changing halfway through the file */
+  for (i = 0; i < G_N_ELEMENTS (positions); i++) {
+    ts = do_seek (pipeline, positions[i]);
+    fail_unless (ts + 2500 * GST_MSECOND >= positions[i]
+        && ts <= positions[i] + 100 * GST_MSECOND,
+        "seek to %" GST_TIME_FORMAT " started at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (positions[i]), GST_TIME_ARGS (ts));
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_seek_keyframe)
+{
+  static const GstClockTime positions[] = {
+    10 * GST_SECOND + 500 * GST_MSECOND, 42 * GST_SECOND + 500 * GST_MSECOND
+  };
+  GstElement *pipeline;
+  GstMessage *msg;
+  GstBus *bus;
+  GstClockTime ts;
+  gchar *location;
+  guint i;
+
+  location = create_file ();
+  pipeline = setup_pipeline (location, NULL);
+
+  /* demux the whole file once so that all keyframes are known */
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  /* we now start right at the previous keyframe */
+  for (i = 0; i < G_N_ELEMENTS (positions); i++) {
+    ts = do_seek (pipeline, positions[i]);
+    fail_unless (first_is_idr);
+    fail_unless (ts + GOP_SIZE * GST_SECOND / FPS + 50 * GST_MSECOND >=
+        positions[i] && ts <= positions[i],
+        "seek to %" GST_TIME_FORMAT " started at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (positions[i]), GST_TIME_ARGS (ts));
+    fail_unless_equals_uint64 ((ts - FRAME_TS (0)) % GST_SECOND, 0);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static GstClockTime
+preroll (GstElement * pipeline)
+{
+  GstFormat format = GST_FORMAT_TIME;
+  gint64 duration;
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_element_query_duration (pipeline, &format, &duration));
+
+  return duration;
+}
+
+static void
+check_index_run (const gchar * location, const gchar * index)
+{
+  GstElement *pipeline;
+  GstClockTime duration, ts;
+
+  pipeline = setup_pipeline (location, index);
+
+  duration = preroll (pipeline);
+  fail_unless (duration >= 58 * GST_SECOND && duration <= 61 * GST_SECOND,
+      "wrong duration %" GST_TIME_FORMAT, GST_TIME_ARGS (duration));
+
+  ts = do_seek (pipeline, 40 * GST_SECOND);
+  fail_unless (ts + 2500 * GST_MSECOND >= 40 * GST_SECOND
+      && ts <= 40 * GST_SECOND + 100 * GST_MSECOND);
+  ts = do_seek (pipeline, 10 * GST_SECOND);
+  fail_unless (ts + 2500 * GST_MSECOND >= 10 * GST_SECOND
+      && ts <= 10 * GST_SECOND + 100 * GST_MSECOND);
+
+  /* writes the index */
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_index)
+{
+  static const guint8 null_packet[4] = { 0x47, 0x1f, 0xff, 0x10 };
+  gchar *location, *index, *contents, *contents2;
+  guint8 stuffing[184];
+  gsize size, size2;
+  FILE *f;
+
+  location = create_file ();
+  index = g_strconcat (location, ".idx", NULL);
+
+  /* no index yet, scans the file and creates it */
+  check_index_run (location, index);
+  fail_unless (g_file_get_contents (index, &contents, &size, NULL));
+  fail_unless (size > 0);
+
+  /* uses the index, which can only grow */
+  check_index_run (location, index);
+  fail_unless (g_file_get_contents (index, &contents2, &size2, NULL));
+  fail_unless (size2 >= size);
+  g_free (contents2);
+
+  /* a corrupted index is ignored and rewritten */
+  fail_unless (g_file_set_contents (index, contents, size / 2, NULL));
+  check_index_run (location, index);
+  fail_unless (g_file_get_contents (index, &contents2, &size2, NULL));
+  fail_unless (size2 > size / 2);
+  g_free (contents2);
+
+  /* the index is stale once the file grew */
+  f = g_fopen (location, "ab");
+  fail_unless (f != NULL);
+  memset (stuffing, 0xff, sizeof (stuffing));
+  fail_unless_equals_int (fwrite (null_packet, 1, 4, f), 4);
+  fail_unless_equals_int (fwrite (stuffing, 1, 184, f), 184);
+  fclose (f);
+  check_index_run (location, index);
+  fail_unless (g_file_get_contents (index, &contents2, &size2, NULL));
+  /* file size is stored right after the magic and the version */
+  fail_unless (memcmp (contents + 8, contents2 + 8, 8) != 0);
+  g_free (contents2);
+
+  g_free (contents);
+  g_unlink (index);
+  g_free (index);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/mpegts"));
+
+static gboolean
+live_query (GstPad * pad, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+    gst_query_set_latency (query, TRUE, 0, GST_CLOCK_TIME_NONE);
+    return TRUE;
+  }
+  return gst_pad_query_default (pad, query);
+}
+
+GST_START_TEST (test_live_latency)
+{
+  GstElement *demux;
+  GstPad *srcpad;
+  GstBus *bus;
+  GstMessage *msg;
+  GstStructure *stats;
+  GstClockTime latency, measured;
+  guint8 pat_cc = 0, pmt_cc = 0, video_cc = 0;
+  guint n, samples;
+
+  demux = gst_check_setup_element ("tsdemux");
+  srcpad = gst_check_setup_src_pad (demux, &srctemplate, NULL);
+  gst_pad_set_query_function (srcpad, live_query);
+  gst_pad_set_active (srcpad, TRUE);
+  bus = gst_bus_new ();
+  gst_element_set_bus (demux, bus);
+  fail_unless_equals_int (gst_element_set_state (demux, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_new_segment (FALSE,
+              1.0, GST_FORMAT_TIME, 0, -1, 0)));
+
+  /* Every frame arrives in one buffer at the time of its PCR and has that
+   * time as PTS. It can only be pushed out when the next frame arrives, one
+   * frame duration later. Nothing is linked, we only look at the
+   * measurement */
+  for (n = 0; n < 4 * FPS; n++) {
+    GByteArray *ts = g_byte_array_new ();
+    GstBuffer *buf;
+
+    if (n % GOP_SIZE == 0)
+      write_psi (ts, &pat_cc, &pmt_cc);
+    write_frame (ts, n, 0, &video_cc);
+
+    buf = gst_buffer_new_and_alloc (ts->len);
+    memcpy (GST_BUFFER_DATA (buf), ts->data, ts->len);
+    GST_BUFFER_TIMESTAMP (buf) = n * GST_SECOND / FPS;
+    gst_pad_push (srcpad, buf);
+    g_byte_array_free (ts, TRUE);
+  }
+
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_LATENCY);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+
+  g_object_get (demux, "latency-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "latency", &latency));
+  fail_unless (gst_structure_get_uint64 (stats, "measured", &measured));
+  fail_unless (gst_structure_get_uint (stats, "samples", &samples));
+  gst_structure_free (stats);
+
+  GST_INFO ("latency %" GST_TIME_FORMAT ", measured %" GST_TIME_FORMAT
+      " over %u samples", GST_TIME_ARGS (latency), GST_TIME_ARGS (measured),
+      samples);
+
+  fail_unless (samples >= 4 * FPS - 2);
+  fail_unless (measured >= GST_SECOND / FPS / 2);
+  fail_unless (measured <= 2 * GST_SECOND / FPS);
+  /* with some margin, but well below the default */
+  fail_unless (latency > measured);
+  fail_unless (latency < 700 * GST_MSECOND);
+
+  gst_element_set_state (demux, GST_STATE_NULL);
+  gst_element_set_bus (demux, NULL);
+  gst_object_unref (bus);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (demux);
+  gst_check_teardown_element (demux);
+}
+
+GST_END_TEST;
+
+static Suite *
+tsdemux_suite (void)
+{
+  Suite *s = suite_create ("tsdemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 60);
+
+  tcase_add_test (tc_chain, test_seek_vbr);
+  tcase_add_test (tc_chain, test_seek_keyframe);
+  tcase_add_test (tc_chain, test_index);
+  tcase_add_test (tc_chain, test_live_latency);
+
+  return s;
+}
+
+GST_CHECK_MAIN (tsdemux);
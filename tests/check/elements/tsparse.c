@@ -0,0 +1,336 @@
+/* GStreamer unit tests for tsparse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Two programs with one stream each. The packets of the first program come
+ * in runs of RUN_LENGTH, separated by one packet of the second program */
+#define PMT1_PID 0x100
+#define PMT2_PID 0x200
+#define PID1 0x101
+#define PID2 0x201
+#define RUN_LENGTH 10
+#define N_RUNS 5000
+
+static guint32
+crc32_mpeg (const guint8 * data, guint size)
+{
+  guint32 crc = 0xffffffff;
+  guint i, j;
+
+  for (i = 0; i < size; i++) {
+    crc ^= (guint32) data[i] << 24;
+    for (j = 0; j < 8; j++)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+  }
+
+  return crc;
+}
+
+static void
+write_section (GByteArray * ts, guint16 pid, guint8 * section, guint size)
+{
+  guint8 pkt[188];
+
+  GST_WRITE_UINT32_BE (section + size - 4, crc32_mpeg (section, size - 4));
+
+  memset (pkt, 0xff, sizeof (pkt));
+  pkt[0] = 0x47;
+  pkt[1] = 0x40 | (pid >> 8);
+  pkt[2] = pid & 0xff;
+  pkt[3] = 0x10;
+  pkt[4] = 0;                   /* pointer field */
+  memcpy (pkt + 5, section, size);
+  g_byte_array_append (ts, pkt, 188);
+}
+
+static void
+write_pmt (GByteArray * ts, guint16 program, guint16 pmt_pid, guint16 pid)
+{
+  guint8 pmt[] = { 0x02, 0xb0, 18, 0x00, program, 0xc1, 0x00, 0x00,
+    0xe0 | (pid >> 8), pid & 0xff, 0xf0, 0x00,
+    0x1b, 0xe0 | (pid >> 8), pid & 0xff, 0xf0, 0x00,
+    0, 0, 0, 0
+  };
+
+  write_section (ts, pmt_pid, pmt, sizeof (pmt));
+}
+
+/* PES continuation packet carrying a sequence number */
+static void
+write_payload (GByteArray * ts, guint16 pid, guint8 * cc, guint32 seqnum)
+{
+  guint8 pkt[188];
+
+  memset (pkt, 0x55, sizeof (pkt));
+  pkt[0] = 0x47;
+  pkt[1] = pid >> 8;
+  pkt[2] = pid & 0xff;
+  pkt[3] = 0x10 | *cc;
+  GST_WRITE_UINT32_BE (pkt + 4, seqnum);
+  *cc = (*cc + 1) & 0xf;
+  g_byte_array_append (ts, pkt, 188);
+}
+
+static gchar *
+create_file (void)
+{
+  guint8 pat[] = { 0x00, 0xb0, 17, 0x00, 0x01, 0xc1, 0x00, 0x00,
+    0x00, 0x01, 0xe0 | (PMT1_PID >> 8), PMT1_PID & 0xff,
+    0x00, 0x02, 0xe0 | (PMT2_PID >> 8), PMT2_PID & 0xff,
+    0, 0, 0, 0
+  };
+  GByteArray *ts;
+  GError *err = NULL;
+  gchar *location;
+  guint8 cc1 = 0, cc2 = 0;
+  guint i, j;
+  gint fd;
+
+  fd = g_file_open_tmp ("tsparse-XXXXXX.ts", &location, &err);
+  fail_unless (fd >= 0, "could not create file: %s", err ? err->message : "");
+  close (fd);
+
+  ts = g_byte_array_new ();
+  write_section (ts, 0, pat, sizeof (pat));
+  write_pmt (ts, 1, PMT1_PID, PID1);
+  write_pmt (ts, 2, PMT2_PID, PID2);
+  for (i = 0; i < N_RUNS; i++) {
+    for (j = 0; j < RUN_LENGTH; j++)
+      write_payload (ts, PID1, &cc1, i * RUN_LENGTH + j);
+    write_payload (ts, PID2, &cc2, i);
+  }
+
+  fail_unless (g_file_set_contents (location, (gchar *) ts->data, ts->len,
+          NULL));
+  g_byte_array_free (ts, TRUE);
+
+  return location;
+}
+
+typedef struct
+{
+  guint n_buffers;
+  guint n_payloads;
+  gboolean got_pmt;
+} ProgramOutput;
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buf, GstPad * pad,
+    ProgramOutput * out)
+{
+  guint8 *data = GST_BUFFER_DATA (buf);
+  guint i;
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf) % 188, 0);
+  out->n_buffers++;
+
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i += 188) {
+    guint16 pid = GST_READ_UINT16_BE (data + i + 1) & 0x1fff;
+
+    fail_unless_equals_int (data[i], 0x47);
+    if (pid == PMT1_PID) {
+      out->got_pmt = TRUE;
+    } else if (pid == PID1) {
+      /* all the packets, in order */
+      fail_unless_equals_int (GST_READ_UINT32_BE (data + i + 4),
+          out->n_payloads);
+      out->n_payloads++;
+    } else {
+      fail_unless (pid == 0, "unexpected pid 0x%04x", pid);
+    }
+  }
+}
+
+static void
+run_pipeline (const gchar * location, guint packets_per_buffer,
+    ProgramOutput * out)
+{
+  GstElement *pipeline, *sink;
+  GstMessage *msg;
+  GstBus *bus;
+  gchar *desc;
+
+  /* packet aligned input so that runs can be pushed as sub-buffers */
+  desc = g_strdup_printf ("filesrc location=\"%s\" blocksize=%d ! "
+      "tsparse name=parse packets-per-buffer=%u parse.program_1 ! "
+      "fakesink name=sink sync=false signal-handoffs=true",
+      location, 188 * 64, packets_per_buffer);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  memset (out, 0, sizeof (ProgramOutput));
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb), out);
+  gst_object_unref (sink);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  fail_unless (out->got_pmt);
+  fail_unless_equals_int (out->n_payloads, N_RUNS * RUN_LENGTH);
+}
+
+GST_START_TEST (test_program_pad_aggregation)
+{
+  ProgramOutput out;
+  gchar *location;
+
+  location = create_file ();
+
+  /* one packet per buffer, as before */
+  run_pipeline (location, 1, &out);
+  fail_unless (out.n_buffers >= N_RUNS * RUN_LENGTH);
+
+  /* the PAT and PMT packets are gathered too */
+  run_pipeline (location, 7, &out);
+  fail_unless (out.n_buffers <= (N_RUNS * RUN_LENGTH + 6) / 7 + 1);
+
+  run_pipeline (location, 100, &out);
+  fail_unless (out.n_buffers <= (N_RUNS * RUN_LENGTH + 99) / 100 + 1);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/mpegts, systemstream = (boolean) true"));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/mpegts, systemstream = (boolean) true"));
+
+/* Input buffers which are sub-buffers of one parent are adjacent in memory,
+ * a run of packets must still not span two of them */
+GST_START_TEST (test_adjacent_input_buffers)
+{
+  guint8 pat[] = { 0x00, 0xb0, 13, 0x00, 0x01, 0xc1, 0x00, 0x00,
+    0x00, 0x01, 0xe0 | (PMT1_PID >> 8), PMT1_PID & 0xff,
+    0, 0, 0, 0
+  };
+  GstElement *parse;
+  GstPad *srcpad, *sinkpad, *program_pad;
+  GstBuffer *parent, *buf;
+  GByteArray *ts;
+  GList *l;
+  guint8 cc = 0;
+  guint i, n_payloads = 0, half;
+
+  parse = gst_check_setup_element ("tsparse");
+  /* gather everything until EOS */
+  g_object_set (parse, "packets-per-buffer", 1000, NULL);
+  srcpad = gst_check_setup_src_pad (parse, &srctemplate, NULL);
+  program_pad = gst_element_get_request_pad (parse, "program_1");
+  fail_unless (program_pad != NULL);
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, gst_check_chain_func);
+  fail_unless_equals_int (gst_pad_link (program_pad, sinkpad),
+      GST_PAD_LINK_OK);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (parse, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  ts = g_byte_array_new ();
+  write_section (ts, 0, pat, sizeof (pat));
+  write_pmt (ts, 1, PMT1_PID, PID1);
+  buf = gst_buffer_new_and_alloc (ts->len);
+  memcpy (GST_BUFFER_DATA (buf), ts->data, ts->len);
+  fail_unless_equals_int (gst_pad_push (srcpad, buf), GST_FLOW_OK);
+
+  g_byte_array_set_size (ts, 0);
+  for (i = 0; i < 4 * RUN_LENGTH; i++)
+    write_payload (ts, PID1, &cc, i);
+  parent = gst_buffer_new_and_alloc (ts->len);
+  memcpy (GST_BUFFER_DATA (parent), ts->data, ts->len);
+  g_byte_array_free (ts, TRUE);
+
+  /* the first half ends exactly where the second one starts */
+  half = 2 * RUN_LENGTH * 188;
+  buf = gst_buffer_create_sub (parent, 0, half);
+  fail_unless_equals_int (gst_pad_push (srcpad, buf), GST_FLOW_OK);
+  buf = gst_buffer_create_sub (parent, half, GST_BUFFER_SIZE (parent) - half);
+  fail_unless_equals_int (gst_pad_push (srcpad, buf), GST_FLOW_OK);
+  gst_buffer_unref (parent);
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_eos ()));
+
+  fail_unless (buffers != NULL);
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *out = l->data;
+    guint8 *data;
+
+    fail_unless (out != NULL);
+    fail_unless_equals_int (GST_BUFFER_SIZE (out) % 188, 0);
+    data = GST_BUFFER_DATA (out);
+    for (i = 0; i < GST_BUFFER_SIZE (out); i += 188) {
+      if ((GST_READ_UINT16_BE (data + i + 1) & 0x1fff) != PID1)
+        continue;
+      fail_unless_equals_int (GST_READ_UINT32_BE (data + i + 4), n_payloads);
+      n_payloads++;
+    }
+  }
+  fail_unless_equals_int (n_payloads, 4 * RUN_LENGTH);
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (parse, GST_STATE_NULL);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_pad_unlink (program_pad, sinkpad);
+  gst_element_release_request_pad (parse, program_pad);
+  gst_object_unref (program_pad);
+  gst_object_unref (sinkpad);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (parse);
+  gst_check_teardown_element (parse);
+}
+
+GST_END_TEST;
+
+static Suite *
+tsparse_suite (void)
+{
+  Suite *s = suite_create ("tsparse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_program_pad_aggregation);
+  tcase_add_test (tc_chain, test_adjacent_input_buffers);
+
+  return s;
+}
+
+GST_CHECK_MAIN (tsparse);
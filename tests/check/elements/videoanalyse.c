@@ -0,0 +1,361 @@
+/* GStreamer unit tests for videoanalyse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#include <math.h>
+#include <string.h>
+
+/* not a multiple of 4, so that the lines are padded */
+#define WIDTH 66
+#define HEIGHT 30
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420")));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420")));
+
+/* random luma, the padding and the chroma planes are set to values that
+ * would show up in the statistics if they were analysed */
+static GstBuffer *
+make_frame (gint width, gint height, guint32 seed)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  guint8 *data;
+  gint x, y, stride;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, width, height));
+  data = GST_BUFFER_DATA (buf);
+  memset (data, 255, GST_BUFFER_SIZE (buf));
+
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
+  rand = g_rand_new_with_seed (seed);
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++)
+      data[y * stride + x] = g_rand_int_range (rand, 16, 236);
+  }
+  g_rand_free (rand);
+
+  return buf;
+}
+
+/* the statistics as the element used to compute them, in two passes */
+static void
+reference_stats (GstBuffer * buf, gint width, gint x, gint y, gint w, gint h,
+    gint step, gdouble * brightness, gdouble * variance)
+{
+  guint8 *data;
+  guint64 sum, n;
+  gint avg, diff, stride, i, j;
+
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
+  data = GST_BUFFER_DATA (buf) + y * stride + x;
+
+  sum = n = 0;
+  for (i = 0; i < h; i += step) {
+    for (j = 0; j < w; j++)
+      sum += data[i * stride + j];
+    n += w;
+  }
+  avg = sum / n;
+  *brightness = sum / (255.0 * n);
+
+  sum = 0;
+  for (i = 0; i < h; i += step) {
+    for (j = 0; j < w; j++) {
+      diff = avg - data[i * stride + j];
+      sum += diff * diff;
+    }
+  }
+  *variance = sum / (255.0 * 255.0 * n);
+}
+
+static gdouble
+reference_difference (GstBuffer * a, GstBuffer * b, gint width, gint height)
+{
+  guint64 sum = 0;
+  gint stride, i, j;
+
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
+  for (i = 0; i < height; i++) {
+    for (j = 0; j < width; j++)
+      sum += ABS (GST_BUFFER_DATA (a)[i * stride + j] -
+          GST_BUFFER_DATA (b)[i * stride + j]);
+  }
+
+  return sum / (255.0 * width * height);
+}
+
+/* pushes copies of @frames through a videoanalyse configured with @props, a
+ * space separated list of property=value, and returns the structures of the
+ * messages it posted */
+static GPtrArray *
+analyse (const gchar * props, gint width, gint height, GstBuffer ** frames,
+    guint n_frames)
+{
+  GstElement *videoanalyse;
+  GstMessage *msg;
+  GPtrArray *stats;
+  GstCaps *caps;
+  GstBus *bus;
+  GList *input = NULL;
+  gchar **args, **arg;
+  guint i;
+
+  videoanalyse = gst_check_setup_element ("videoanalyse");
+  args = g_strsplit (props, " ", -1);
+  for (arg = args; *arg; arg++) {
+    gchar **kv = g_strsplit (*arg, "=", 2);
+
+    if (kv[0] && kv[1])
+      gst_util_set_object_arg (G_OBJECT (videoanalyse), kv[0], kv[1]);
+    g_strfreev (kv);
+  }
+  g_strfreev (args);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (videoanalyse, bus);
+
+  mysrcpad = gst_check_setup_src_pad (videoanalyse, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (videoanalyse, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (videoanalyse,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, width, height, 25,
+      1, 1, 1);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *buf = gst_buffer_copy (frames[i]);
+
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+    gst_buffer_set_caps (buf, caps);
+    input = g_list_prepend (input, buf);
+  }
+  gst_caps_unref (caps);
+  input = g_list_reverse (input);
+
+  while (input) {
+    fail_unless_equals_int (gst_pad_push (mysrcpad, GST_BUFFER (input->data)),
+        GST_FLOW_OK);
+    input = g_list_delete_link (input, input);
+  }
+
+  fail_unless_equals_int (g_list_length (buffers), n_frames);
+  gst_check_drop_buffers ();
+
+  stats = g_ptr_array_new ();
+  while ((msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT))) {
+    const GstStructure *s = gst_message_get_structure (msg);
+
+    fail_unless (gst_structure_has_name (s, "GstVideoAnalyse"));
+    g_ptr_array_add (stats, gst_structure_copy (s));
+    gst_message_unref (msg);
+  }
+
+  gst_element_set_bus (videoanalyse, NULL);
+  gst_object_unref (bus);
+  gst_element_set_state (videoanalyse, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (videoanalyse);
+  gst_check_teardown_sink_pad (videoanalyse);
+  gst_check_teardown_element (videoanalyse);
+
+  return stats;
+}
+
+static void
+free_stats (GPtrArray * stats)
+{
+  g_ptr_array_foreach (stats, (GFunc) gst_structure_free, NULL);
+  g_ptr_array_free (stats, TRUE);
+}
+
+static gdouble
+get_double (const GstStructure * s, const gchar * field)
+{
+  gdouble val;
+
+  fail_unless (gst_structure_get_double (s, field, &val), "no %s in %"
+      GST_PTR_FORMAT, field, s);
+
+  return val;
+}
+
+#define fail_unless_close(a, b) \
+  fail_unless (fabs ((a) - (b)) < 1e-9, "%.12f != %.12f", (a), (b))
+
+/* analyses a single frame with @props and compares the result to the
+ * reference statistics of the given region */
+static void
+check_region (const gchar * props, gint x, gint y, gint w, gint h, gint step)
+{
+  GstBuffer *frame;
+  GPtrArray *stats;
+  gdouble brightness, variance;
+
+  frame = make_frame (WIDTH, HEIGHT, 42);
+  reference_stats (frame, WIDTH, x, y, w, h, step, &brightness, &variance);
+
+  stats = analyse (props, WIDTH, HEIGHT, &frame, 1);
+  fail_unless_equals_int (stats->len, 1);
+  fail_unless_close (get_double (g_ptr_array_index (stats, 0), "brightness"),
+      brightness);
+  fail_unless_close (get_double (g_ptr_array_index (stats, 0),
+          "brightness-variance"), variance);
+  fail_if (gst_structure_has_field (g_ptr_array_index (stats, 0),
+          "difference"));
+
+  free_stats (stats);
+  gst_buffer_unref (frame);
+}
+
+GST_START_TEST (test_statistics)
+{
+  check_region ("", 0, 0, WIDTH, HEIGHT, 1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_region_of_interest)
+{
+  check_region ("roi-x=5 roi-y=3 roi-width=20 roi-height=10", 5, 3, 20, 10,
+      1);
+  /* 0 extends the region to the edges */
+  check_region ("roi-x=60 roi-y=25", 60, 25, WIDTH - 60, HEIGHT - 25, 1);
+  /* clipped to the frame */
+  check_region ("roi-x=50 roi-width=100 roi-height=100", 50, 0, WIDTH - 50,
+      HEIGHT, 1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_line_step)
+{
+  check_region ("line-step=2", 0, 0, WIDTH, HEIGHT, 2);
+  check_region ("line-step=7", 0, 0, WIDTH, HEIGHT, 7);
+  check_region ("line-step=4 roi-x=1 roi-y=3 roi-width=33", 1, 3, 33,
+      HEIGHT - 3, 4);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_interval)
+{
+  GstBuffer *frames[10];
+  GPtrArray *stats;
+  GstClockTime ts;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (frames); i++)
+    frames[i] = make_frame (WIDTH, HEIGHT, i);
+
+  stats = analyse ("interval=3", WIDTH, HEIGHT, frames, G_N_ELEMENTS (frames));
+
+  /* frames 0, 3, 6 and 9 */
+  fail_unless_equals_int (stats->len, 4);
+  for (i = 0; i < stats->len; i++) {
+    GstStructure *s = g_ptr_array_index (stats, i);
+    gdouble brightness, variance;
+
+    fail_unless (gst_structure_get_uint64 (s, "timestamp", &ts));
+    fail_unless_equals_uint64 (ts, i * 3 * GST_SECOND / 25);
+    reference_stats (frames[i * 3], WIDTH, 0, 0, WIDTH, HEIGHT, 1,
+        &brightness, &variance);
+    fail_unless_close (get_double (s, "brightness"), brightness);
+  }
+  free_stats (stats);
+
+  for (i = 0; i < G_N_ELEMENTS (frames); i++)
+    gst_buffer_unref (frames[i]);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_probe)
+{
+  GstBuffer *frames[3];
+  GPtrArray *stats;
+  gdouble brightness, variance;
+  guint i;
+
+  /* a frozen frame, then a change */
+  frames[0] = make_frame (WIDTH, HEIGHT, 1);
+  frames[1] = gst_buffer_ref (frames[0]);
+  frames[2] = make_frame (WIDTH, HEIGHT, 2);
+
+  stats = analyse ("probe=true", WIDTH, HEIGHT, frames, 3);
+  fail_unless_equals_int (stats->len, 3);
+
+  /* nothing to compare the first frame with */
+  fail_unless_close (get_double (g_ptr_array_index (stats, 0), "difference"),
+      -1.0);
+  fail_unless_close (get_double (g_ptr_array_index (stats, 1), "difference"),
+      0.0);
+  fail_unless_close (get_double (g_ptr_array_index (stats, 2), "difference"),
+      reference_difference (frames[1], frames[2], WIDTH, HEIGHT));
+
+  /* the brightness statistics come from the same pass */
+  for (i = 0; i < 3; i++) {
+    reference_stats (frames[i], WIDTH, 0, 0, WIDTH, HEIGHT, 1, &brightness,
+        &variance);
+    fail_unless_close (get_double (g_ptr_array_index (stats, i),
+            "brightness"), brightness);
+    fail_unless_close (get_double (g_ptr_array_index (stats, i),
+            "brightness-variance"), variance);
+  }
+  free_stats (stats);
+
+  for (i = 0; i < 3; i++)
+    gst_buffer_unref (frames[i]);
+}
+
+GST_END_TEST;
+
+static Suite *
+videoanalyse_suite (void)
+{
+  Suite *s = suite_create ("videoanalyse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_statistics);
+  tcase_add_test (tc_chain, test_region_of_interest);
+  tcase_add_test (tc_chain, test_line_step);
+  tcase_add_test (tc_chain, test_interval);
+  tcase_add_test (tc_chain, test_probe);
+
+  return s;
+}
+
+GST_CHECK_MAIN (videoanalyse);
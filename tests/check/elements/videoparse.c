@@ -0,0 +1,224 @@
+/* GStreamer
+ *
+ * unit test for videoparse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* I420 */
+#define WIDTH 640
+#define HEIGHT 480
+#define FRAME_SIZE (WIDTH * HEIGHT * 3 / 2)
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv"));
+
+static void
+fill_frames (guint8 * data, guint first_byte, guint size)
+{
+  guint i;
+
+  for (i = 0; i < size; i++)
+    data[i] = ((first_byte + i) / FRAME_SIZE) % 0xff;
+}
+
+static void
+check_frame (GstBuffer * buf, guint frame)
+{
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf), FRAME_SIZE);
+  fail_unless_equals_int (GST_BUFFER_DATA (buf)[0], frame % 0xff);
+  fail_unless_equals_int (GST_BUFFER_DATA (buf)[FRAME_SIZE - 1], frame % 0xff);
+  fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), frame);
+}
+
+GST_START_TEST (test_push_subbuffers)
+{
+  GstElement *videoparse;
+  GstBuffer *in1, *in2;
+  GList *l;
+  guint i;
+
+  videoparse = gst_check_setup_element ("videoparse");
+  g_object_set (videoparse, "width", WIDTH, "height", HEIGHT, NULL);
+  mysrcpad = gst_check_setup_src_pad (videoparse, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (videoparse, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (videoparse,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  /* 3.5 frames, then 2.5 frames */
+  in1 = gst_buffer_new_and_alloc (FRAME_SIZE * 7 / 2);
+  fill_frames (GST_BUFFER_DATA (in1), 0, GST_BUFFER_SIZE (in1));
+  in2 = gst_buffer_new_and_alloc (FRAME_SIZE * 5 / 2);
+  fill_frames (GST_BUFFER_DATA (in2), GST_BUFFER_SIZE (in1),
+      GST_BUFFER_SIZE (in2));
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (in1)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, gst_buffer_ref (in2)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 6);
+
+  for (l = buffers, i = 0; l; l = l->next, i++)
+    check_frame (GST_BUFFER (l->data), i);
+
+  /* the frames that are not split over two input buffers are not copied */
+  for (l = buffers, i = 0; i < 3; l = l->next, i++)
+    fail_unless (GST_BUFFER_DATA (l->data) ==
+        GST_BUFFER_DATA (in1) + i * FRAME_SIZE);
+  l = g_list_nth (buffers, 4);
+  fail_unless (GST_BUFFER_DATA (l->data) ==
+      GST_BUFFER_DATA (in2) + FRAME_SIZE / 2);
+
+  gst_buffer_unref (in1);
+  gst_buffer_unref (in2);
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (videoparse, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (videoparse);
+  gst_check_teardown_sink_pad (videoparse);
+  gst_check_teardown_element (videoparse);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  guint n_frames;
+  guint n_pulled;
+  GstPad *parse_sinkpad;
+} ReadState;
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buf, GstPad * pad,
+    ReadState * state)
+{
+  /* frames are read with pull_range */
+  fail_unless_equals_int (GST_PAD_ACTIVATE_MODE (state->parse_sinkpad),
+      GST_ACTIVATE_PULL);
+  check_frame (buf, state->n_frames);
+  state->n_frames++;
+}
+
+static gboolean
+pulled_cb (GstPad * pad, GstBuffer * buf, ReadState * state)
+{
+  state->n_pulled++;
+  return TRUE;
+}
+
+GST_START_TEST (test_pull_file)
+{
+  GstElement *pipeline, *element;
+  GstMessage *msg;
+  GstBus *bus;
+  GstPad *pad;
+  ReadState state = { 0, };
+  GError *err = NULL;
+  gchar *location, *desc;
+  guint8 *data;
+  guint n_frames = 100, size = n_frames * FRAME_SIZE;
+  gint fd;
+
+  fd = g_file_open_tmp ("videoparse-XXXXXX", &location, &err);
+  fail_unless (fd >= 0, "could not create file: %s", err ? err->message : "");
+  close (fd);
+
+  data = g_malloc (size);
+  fill_frames (data, 0, size);
+  fail_unless (g_file_set_contents (location, (gchar *) data, size, NULL));
+  g_free (data);
+
+  desc = g_strdup_printf ("filesrc name=src location=\"%s\" ! "
+      "videoparse name=parse width=%d height=%d ! "
+      "fakesink name=sink sync=false signal-handoffs=true",
+      location, WIDTH, HEIGHT);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "parse");
+  state.parse_sinkpad = gst_element_get_static_pad (element, "sink");
+  gst_object_unref (element);
+
+  /* buffer probes see the buffers returned by pull_range too */
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_add_buffer_probe (pad, G_CALLBACK (pulled_cb), &state);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (element, "handoff", G_CALLBACK (handoff_cb), &state);
+  gst_object_unref (element);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (state.parse_sinkpad);
+  gst_object_unref (pipeline);
+
+  fail_unless_equals_int (state.n_frames, n_frames);
+  /* several frames per pull_range */
+  fail_unless (state.n_pulled < n_frames, "%u pull_range calls for %u frames",
+      state.n_pulled, n_frames);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static Suite *
+videoparse_suite (void)
+{
+  Suite *s = suite_create ("videoparse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_push_subbuffers);
+  tcase_add_test (tc_chain, test_pull_file);
+
+  return s;
+}
+
+GST_CHECK_MAIN (videoparse);
@@ -19,6 +19,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -163,6 +164,74 @@ GST_START_TEST (test_decode_simple)
 
 GST_END_TEST;
 
+GST_START_TEST (test_decode_odd_size)
+{
+  GstElement *bin;
+  GstBuffer *buffer;
+  gint i, size;
+  GList *l;
+
+  /* odd dimensions, the rows of the I420 output are padded and the frames
+   * have to be copied row by row */
+  bin =
+      setup_vp8dec
+      ("video/x-raw-yuv,format=(fourcc)I420,width=(int)161,height=(int)121,framerate=(fraction)25/1");
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_new_segment (FALSE,
+              1.0, GST_FORMAT_TIME, 0, gst_util_uint64_scale (5, GST_SECOND,
+                  25), 0)));
+
+  size = gst_video_format_get_size (GST_VIDEO_FORMAT_I420, 161, 121);
+  buffer = gst_buffer_new_and_alloc (size);
+  memset (GST_BUFFER_DATA (buffer), 128, GST_BUFFER_SIZE (buffer));
+  gst_buffer_set_caps (buffer, GST_PAD_CAPS (srcpad));
+
+  for (i = 0; i < 5; i++) {
+    GST_BUFFER_TIMESTAMP (buffer) = gst_util_uint64_scale (i, GST_SECOND, 25);
+    GST_BUFFER_DURATION (buffer) = gst_util_uint64_scale (1, GST_SECOND, 25);
+    fail_unless (gst_pad_push (srcpad, gst_buffer_ref (buffer)) == GST_FLOW_OK);
+  }
+
+  gst_buffer_unref (buffer);
+
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_eos ()));
+
+  fail_unless_equals_int (g_list_length (buffers), 5);
+
+  for (l = buffers; l; l = l->next) {
+    guint8 *data;
+    gint c, x, y;
+
+    buffer = l->data;
+    fail_unless_equals_int (GST_BUFFER_SIZE (buffer), size);
+
+    /* a flat grey picture has to come out as one, including the last
+     * column and row of each plane */
+    for (c = 0; c < 3; c++) {
+      gint w, h, stride;
+
+      data = GST_BUFFER_DATA (buffer) +
+          gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, c,
+          161, 121);
+      stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, c, 161);
+      w = gst_video_format_get_component_width (GST_VIDEO_FORMAT_I420, c, 161);
+      h = gst_video_format_get_component_height (GST_VIDEO_FORMAT_I420, c,
+          121);
+
+      for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+          fail_unless (ABS (data[y * stride + x] - 128) <= 4,
+              "plane %d pixel %d,%d is %d", c, x, y, data[y * stride + x]);
+        }
+      }
+    }
+  }
+
+  cleanup_vp8dec (bin);
+}
+
+GST_END_TEST;
+
 static Suite *
 vp8dec_suite (void)
 {
@@ -172,6 +241,7 @@ vp8dec_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_decode_simple);
+  tcase_add_test (tc_chain, test_decode_odd_size);
 
   return s;
 }
@@ -0,0 +1,294 @@
+/* GStreamer unit tests for GstBaseVideoDecoder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+#include <gst/video/gstbasevideodecoder.h>
+
+#define WIDTH 16
+#define HEIGHT 16
+#define N_FRAMES 64
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-test-codec")
+    );
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_GRAY8)
+    );
+
+/* a decoder whose frames take a varying amount of time to decode; the
+ * output frame carries the input frame's number */
+typedef struct _GstTestVideoDec GstTestVideoDec;
+typedef struct _GstTestVideoDecClass GstTestVideoDecClass;
+
+struct _GstTestVideoDec
+{
+  GstBaseVideoDecoder parent;
+
+  GMutex *lock;
+  gboolean caps_set;
+};
+
+struct _GstTestVideoDecClass
+{
+  GstBaseVideoDecoderClass parent_class;
+};
+
+GType gst_test_video_dec_get_type (void);
+
+GST_BOILERPLATE (GstTestVideoDec, gst_test_video_dec, GstBaseVideoDecoder,
+    GST_TYPE_BASE_VIDEO_DECODER);
+
+static GstStaticPadTemplate dec_sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-test-codec")
+    );
+
+static GstStaticPadTemplate dec_src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_GRAY8)
+    );
+
+static gboolean
+gst_test_video_dec_start (GstBaseVideoDecoder * dec)
+{
+  GstTestVideoDec *self = (GstTestVideoDec *) dec;
+
+  dec->packetized = TRUE;
+  self->caps_set = FALSE;
+
+  return TRUE;
+}
+
+static gboolean
+gst_test_video_dec_set_format (GstBaseVideoDecoder * dec,
+    GstVideoState * state)
+{
+  state->format = GST_VIDEO_FORMAT_GRAY8;
+  state->width = WIDTH;
+  state->height = HEIGHT;
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_test_video_dec_handle_frame (GstBaseVideoDecoder * dec,
+    GstVideoFrame * frame)
+{
+  GstTestVideoDec *self = (GstTestVideoDec *) dec;
+  guint32 num;
+
+  g_mutex_lock (self->lock);
+  if (!self->caps_set) {
+    fail_unless (gst_base_video_decoder_set_src_caps (dec));
+    self->caps_set = TRUE;
+  }
+  g_mutex_unlock (self->lock);
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (frame->sink_buffer), 4);
+  num = GST_READ_UINT32_BE (GST_BUFFER_DATA (frame->sink_buffer));
+
+  /* "decoding" takes between 1 and 5 ms */
+  g_usleep (((num * 7) % 5 + 1) * 1000);
+
+  frame->src_buffer = gst_buffer_new_and_alloc (WIDTH * HEIGHT);
+  memset (GST_BUFFER_DATA (frame->src_buffer), 0, WIDTH * HEIGHT);
+  GST_WRITE_UINT32_BE (GST_BUFFER_DATA (frame->src_buffer), num);
+
+  /* every 8th frame is dropped */
+  if (num % 8 == 7)
+    return gst_base_video_decoder_drop_frame (dec, frame);
+
+  return gst_base_video_decoder_finish_frame (dec, frame);
+}
+
+static void
+gst_test_video_dec_finalize (GObject * object)
+{
+  GstTestVideoDec *self = (GstTestVideoDec *) object;
+
+  g_mutex_free (self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_test_video_dec_base_init (gpointer g_class)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (g_class);
+
+  gst_element_class_add_static_pad_template (element_class,
+      &dec_sink_template);
+  gst_element_class_add_static_pad_template (element_class,
+      &dec_src_template);
+  gst_element_class_set_details_simple (element_class, "Test video decoder",
+      "Codec/Decoder/Video", "Test decoder", "GStreamer");
+}
+
+static void
+gst_test_video_dec_class_init (GstTestVideoDecClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstBaseVideoDecoderClass *base_class = GST_BASE_VIDEO_DECODER_CLASS (klass);
+
+  gobject_class->finalize = gst_test_video_dec_finalize;
+
+  base_class->start = gst_test_video_dec_start;
+  base_class->set_format = gst_test_video_dec_set_format;
+  base_class->handle_frame = gst_test_video_dec_handle_frame;
+}
+
+static void
+gst_test_video_dec_init (GstTestVideoDec * self, GstTestVideoDecClass * klass)
+{
+  self->lock = g_mutex_new ();
+}
+
+static GstElement *
+setup_decoder (guint n_workers)
+{
+  GstElement *dec;
+  GstCaps *caps;
+
+  dec = g_object_new (gst_test_video_dec_get_type (), NULL);
+  fail_unless_equals_int (gst_base_video_decoder_set_n_workers
+      (GST_BASE_VIDEO_DECODER (dec), n_workers), GST_FLOW_OK);
+
+  mysrcpad = gst_check_setup_src_pad (dec, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (dec, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless_equals_int (gst_element_set_state (dec, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_from_string ("video/x-test-codec, width=(int)16, "
+      "height=(int)16, framerate=(fraction)25/1");
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return dec;
+}
+
+static void
+cleanup_decoder (GstElement * dec)
+{
+  fail_unless_equals_int (gst_element_set_state (dec, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (dec);
+  gst_check_teardown_sink_pad (dec);
+  gst_check_teardown_element (dec);
+
+  gst_check_drop_buffers ();
+}
+
+/* pushes N_FRAMES and checks that all but the dropped ones come out in
+ * order, returns the time it took */
+static GstClockTime
+run_decoder (guint n_workers)
+{
+  GstElement *dec;
+  GstClockTime start;
+  GList *l;
+  guint i, expected;
+
+  dec = setup_decoder (n_workers);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < N_FRAMES; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (4);
+
+    GST_WRITE_UINT32_BE (GST_BUFFER_DATA (buf), i);
+    GST_BUFFER_TIMESTAMP (buf) = gst_util_uint64_scale (i, GST_SECOND, 25);
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+    gst_buffer_set_caps (buf, GST_PAD_CAPS (mysrcpad));
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  start = gst_util_get_timestamp () - start;
+
+  fail_unless_equals_int (g_list_length (buffers), N_FRAMES - N_FRAMES / 8);
+
+  expected = 0;
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = l->data;
+
+    if (expected % 8 == 7)
+      expected++;
+
+    fail_unless_equals_int (GST_BUFFER_SIZE (buf), WIDTH * HEIGHT);
+    fail_unless_equals_int (GST_READ_UINT32_BE (GST_BUFFER_DATA (buf)),
+        expected);
+    fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buf),
+        gst_util_uint64_scale (expected, GST_SECOND, 25));
+    expected++;
+  }
+
+  cleanup_decoder (dec);
+
+  return start;
+}
+
+GST_START_TEST (test_decode_serial)
+{
+  run_decoder (0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_decode_parallel)
+{
+  GstClockTime serial, parallel;
+
+  serial = run_decoder (0);
+  parallel = run_decoder (4);
+
+  /* not asserted, the machine may well be busy with other things */
+  GST_INFO ("serial: %" GST_TIME_FORMAT ", 4 workers: %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (serial), GST_TIME_ARGS (parallel));
+}
+
+GST_END_TEST;
+
+static Suite *
+basevideodecoder_suite (void)
+{
+  Suite *s = suite_create ("basevideodecoder");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_decode_serial);
+  tcase_add_test (tc_chain, test_decode_parallel);
+
+  return s;
+}
+
+GST_CHECK_MAIN (basevideodecoder);
@@ -0,0 +1,341 @@
+/* GStreamer unit tests for GstSignalProcessor
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/signalprocessor/gstsignalprocessor.h>
+
+#define MAX_CHANNELS 8
+/* not a multiple of any of the block sizes */
+#define BUFFER_FRAMES 1001
+#define N_BUFFERS 4
+
+static GstPad *mysrcpad, *mysinkpad;
+
+#define PROCESSOR_CAPS_TEMPLATE_STRING \
+    "audio/x-raw-float, " \
+    "rate = (int) [ 1, MAX ], " \
+    "channels = (int) [ 1, MAX ], " \
+    "endianness = (int) BYTE_ORDER, " \
+    "width = (int) 32"
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (PROCESSOR_CAPS_TEMPLATE_STRING));
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (PROCESSOR_CAPS_TEMPLATE_STRING));
+
+/* a processor with one multi-channel input and output group; channel c of
+ * the output is channel c of the input scaled by c + 1 plus the previous
+ * input sample of that channel, so the result depends on the channel
+ * layout and on the blocks following each other seamlessly */
+typedef struct _GstTestProcessor GstTestProcessor;
+typedef struct _GstTestProcessorClass GstTestProcessorClass;
+
+struct _GstTestProcessor
+{
+  GstSignalProcessor parent;
+
+  gfloat last[MAX_CHANNELS];
+  guint max_frames;
+};
+
+struct _GstTestProcessorClass
+{
+  GstSignalProcessorClass parent_class;
+
+  guint channels;
+};
+
+static gboolean
+gst_test_processor_start (GstSignalProcessor * processor)
+{
+  GstTestProcessor *self = (GstTestProcessor *) processor;
+
+  memset (self->last, 0, sizeof (self->last));
+  self->max_frames = 0;
+
+  return TRUE;
+}
+
+static void
+gst_test_processor_process (GstSignalProcessor * processor, guint nframes)
+{
+  GstTestProcessor *self = (GstTestProcessor *) processor;
+  GstSignalProcessorGroup *in = &processor->group_in[0];
+  GstSignalProcessorGroup *out = &processor->group_out[0];
+  guint c, i;
+
+  fail_unless_equals_int (in->nframes, nframes);
+  fail_unless_equals_int (out->nframes, nframes);
+  self->max_frames = MAX (self->max_frames, nframes);
+
+  for (c = 0; c < in->channels; c++) {
+    for (i = 0; i < nframes; i++) {
+      gfloat v = in->buffer[c * nframes + i];
+
+      out->buffer[c * nframes + i] = v * (c + 1) + self->last[c];
+      self->last[c] = v;
+    }
+  }
+}
+
+static void
+gst_test_processor_class_init (GstTestProcessorClass * klass,
+    gpointer class_data)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstSignalProcessorClass *processor_class =
+      GST_SIGNAL_PROCESSOR_CLASS (klass);
+
+  klass->channels = GPOINTER_TO_UINT (class_data);
+
+  gst_signal_processor_class_add_pad_template (processor_class, "sink",
+      GST_PAD_SINK, 0, klass->channels);
+  gst_signal_processor_class_add_pad_template (processor_class, "src",
+      GST_PAD_SRC, 0, klass->channels);
+  gst_element_class_set_details_simple (element_class, "Test processor",
+      "Filter/Effect/Audio", "Test processor", "GStreamer");
+
+  processor_class->num_group_in = 1;
+  processor_class->num_group_out = 1;
+  processor_class->start = gst_test_processor_start;
+  processor_class->process = gst_test_processor_process;
+}
+
+/* one subclass per channel count, the pad templates are per class */
+static GType
+gst_test_processor_get_type (guint channels)
+{
+  GTypeInfo info = {
+    sizeof (GstTestProcessorClass), NULL, NULL,
+    (GClassInitFunc) gst_test_processor_class_init, NULL, NULL,
+    sizeof (GstTestProcessor), 0, NULL
+  };
+  gchar *name;
+  GType type;
+
+  name = g_strdup_printf ("GstTestProcessor%u", channels);
+  type = g_type_from_name (name);
+  if (!type) {
+    info.class_data = GUINT_TO_POINTER (channels);
+    type = g_type_register_static (GST_TYPE_SIGNAL_PROCESSOR, name, &info, 0);
+  }
+  g_free (name);
+
+  return type;
+}
+
+static GstCaps *
+make_caps (guint channels, gint rate)
+{
+  return gst_caps_new_simple ("audio/x-raw-float",
+      "endianness", G_TYPE_INT, G_BYTE_ORDER, "width", G_TYPE_INT, 32,
+      "channels", G_TYPE_INT, channels, "rate", G_TYPE_INT, rate, NULL);
+}
+
+static GstElement *
+setup_processor (guint channels, guint block_size)
+{
+  GstElement *processor;
+
+  processor = g_object_new (gst_test_processor_get_type (channels), NULL);
+  g_object_set (processor, "block-size", block_size, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (processor, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (processor, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless_equals_int (gst_element_set_state (processor,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+
+  return processor;
+}
+
+static void
+cleanup_processor (GstElement * processor)
+{
+  fail_unless_equals_int (gst_element_set_state (processor, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (processor);
+  gst_check_teardown_sink_pad (processor);
+  gst_check_teardown_element (processor);
+
+  gst_check_drop_buffers ();
+}
+
+/* interleaved buffer @index of a stream of small integers, so that the
+ * processing is exact in float */
+static GstBuffer *
+make_buffer (guint channels, GstCaps * caps, guint index)
+{
+  GstBuffer *buf;
+  gfloat *data;
+  guint i;
+
+  buf = gst_buffer_new_and_alloc (BUFFER_FRAMES * channels * sizeof (gfloat));
+  data = (gfloat *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < BUFFER_FRAMES * channels; i++)
+    data[i] = (gint) ((index * 7919 + i * 31) % 1024) - 512;
+  gst_buffer_set_caps (buf, caps);
+
+  return buf;
+}
+
+/* the processing done sample by sample on the interleaved data */
+static void
+check_output (GstBuffer * inbuf, GstBuffer * outbuf, guint channels,
+    gfloat * last)
+{
+  const gfloat *in = (const gfloat *) GST_BUFFER_DATA (inbuf);
+  const gfloat *out = (const gfloat *) GST_BUFFER_DATA (outbuf);
+  guint c, i;
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (outbuf), GST_BUFFER_SIZE (inbuf));
+
+  for (i = 0; i < BUFFER_FRAMES; i++) {
+    for (c = 0; c < channels; c++) {
+      gfloat v = in[i * channels + c];
+
+      fail_unless (out[i * channels + c] == v * (c + 1) + last[c],
+          "%u channels: frame %u, channel %u is %f, expected %f", channels,
+          i, c, out[i * channels + c], v * (c + 1) + last[c]);
+      last[c] = v;
+    }
+  }
+}
+
+/* pushes N_BUFFERS buffers of @rate, the processor state carries over */
+static void
+push_and_check (GstElement * processor, guint channels, gint rate,
+    guint block_size, gfloat * last)
+{
+  GstBuffer *inbufs[N_BUFFERS];
+  GstCaps *caps;
+  GList *l;
+  guint i;
+
+  caps = make_caps (channels, rate);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+
+  for (i = 0; i < N_BUFFERS; i++) {
+    inbufs[i] = make_buffer (channels, caps, i);
+    fail_unless_equals_int (gst_pad_push (mysrcpad,
+            gst_buffer_ref (inbufs[i])), GST_FLOW_OK);
+  }
+  gst_caps_unref (caps);
+
+  fail_unless_equals_int (g_list_length (buffers), N_BUFFERS);
+  for (l = buffers, i = 0; l; l = l->next, i++) {
+    check_output (inbufs[i], l->data, channels, last);
+    gst_buffer_unref (inbufs[i]);
+  }
+  gst_check_drop_buffers ();
+
+  fail_unless_equals_int (((GstTestProcessor *) processor)->max_frames,
+      block_size ? block_size : BUFFER_FRAMES);
+}
+
+static void
+check_processor (guint channels, guint block_size)
+{
+  GstElement *processor;
+  gfloat last[MAX_CHANNELS] = { 0, };
+
+  processor = setup_processor (channels, block_size);
+
+  push_and_check (processor, channels, 44100, block_size, last);
+
+  /* a new rate takes the processor through stop(), cleanup() and setup(),
+   * which frees the group buffers; start() resets the subclass state */
+  memset (last, 0, sizeof (last));
+  push_and_check (processor, channels, 48000, block_size, last);
+
+  /* and so does going through NULL */
+  fail_unless_equals_int (gst_element_set_state (processor, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless_equals_int (gst_element_set_state (processor,
+          GST_STATE_PLAYING), GST_STATE_CHANGE_SUCCESS);
+  memset (last, 0, sizeof (last));
+  push_and_check (processor, channels, 44100, block_size, last);
+
+  cleanup_processor (processor);
+}
+
+static void
+check_block_sizes (guint channels)
+{
+  check_processor (channels, 0);
+  check_processor (channels, 1);
+  check_processor (channels, 64);
+  check_processor (channels, 256);
+}
+
+GST_START_TEST (test_stereo)
+{
+  check_block_sizes (2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_5_1)
+{
+  check_block_sizes (6);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_7_1)
+{
+  check_block_sizes (8);
+}
+
+GST_END_TEST;
+
+/* the generic loop */
+GST_START_TEST (test_3_channels)
+{
+  check_block_sizes (3);
+}
+
+GST_END_TEST;
+
+static Suite *
+signalprocessor_suite (void)
+{
+  Suite *s = suite_create ("signalprocessor");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_stereo);
+  tcase_add_test (tc_chain, test_5_1);
+  tcase_add_test (tc_chain, test_7_1);
+  tcase_add_test (tc_chain, test_3_channels);
+
+  return s;
+}
+
+GST_CHECK_MAIN (signalprocessor);
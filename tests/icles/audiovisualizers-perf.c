@@ -0,0 +1,192 @@
+/* GStreamer audio visualizer rendering benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Renders --seconds seconds of stereo noise with spectrascope, synaescope
+ * and wavescope at 1920x1080 and 60 frames/s and prints the frames/s each
+ * of them renders. The audio is pushed straight into the element, so only
+ * the analysis, drawing and shading are timed. */
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define RATE 44100
+#define CHANNELS 2
+#define BUFFER_SAMPLES 1024
+
+static gint seconds = 10;
+
+static const gchar *elements[] = { "spectrascope", "synaescope", "wavescope" };
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstBuffer *
+make_noise (gint n_samples)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  gint16 *data;
+  gint i;
+
+  buf = gst_buffer_new_and_alloc (n_samples * CHANNELS * sizeof (gint16));
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  rand = g_rand_new_with_seed (n_samples);
+  for (i = 0; i < n_samples * CHANNELS; i++)
+    data[i] = g_rand_int_range (rand, -16384, 16384);
+  g_rand_free (rand);
+
+  return buf;
+}
+
+/* renders @noise with @name and returns the time it took, or
+ * GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (const gchar * name, GstBuffer * noise, GstCaps * audiocaps,
+    GstCaps * videocaps)
+{
+  GstElement *scope;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  guint offset, size;
+
+  scope = gst_element_factory_make (name, NULL);
+  if (scope == NULL) {
+    g_printerr ("%s not found\n", name);
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (scope, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  /* fixed caps make the element render @videocaps */
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  gst_pad_use_fixed_caps (sinkpad);
+  gst_pad_set_caps (sinkpad, videocaps);
+  pad = gst_element_get_static_pad (scope, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (scope, GST_STATE_PLAYING);
+  gst_pad_set_caps (srcpad, audiocaps);
+  gst_pad_push_event (srcpad, gst_event_new_new_segment (FALSE, 1.0,
+          GST_FORMAT_TIME, 0, -1, 0));
+  n_out = 0;
+
+  size = BUFFER_SAMPLES * CHANNELS * sizeof (gint16);
+  start = gst_util_get_timestamp ();
+  for (offset = 0; offset + size <= GST_BUFFER_SIZE (noise); offset += size) {
+    GstBuffer *buf = gst_buffer_create_sub (noise, offset, size);
+    guint64 sample = offset / (CHANNELS * sizeof (gint16));
+
+    GST_BUFFER_TIMESTAMP (buf) = gst_util_uint64_scale_int (sample,
+        GST_SECOND, RATE);
+    GST_BUFFER_DURATION (buf) = gst_util_uint64_scale_int (BUFFER_SAMPLES,
+        GST_SECOND, RATE);
+    gst_buffer_set_caps (buf, audiocaps);
+    if (gst_pad_push (srcpad, buf) != GST_FLOW_OK) {
+      g_printerr ("%s did not take the buffer at %u\n", name, offset);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out == 0) {
+    g_printerr ("%s rendered no frames\n", name);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  gst_element_set_state (scope, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (scope);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"seconds", '\0', 0, G_OPTION_ARG_INT, &seconds,
+        "Seconds of audio rendered per element", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstCaps *audiocaps, *videocaps;
+  GstBuffer *noise;
+  guint i;
+  gint ret = 0;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  audiocaps = gst_caps_new_simple ("audio/x-raw-int",
+      "width", G_TYPE_INT, 16, "depth", G_TYPE_INT, 16,
+      "signed", G_TYPE_BOOLEAN, TRUE,
+      "endianness", G_TYPE_INT, G_BYTE_ORDER,
+      "rate", G_TYPE_INT, RATE, "channels", G_TYPE_INT, CHANNELS, NULL);
+  videocaps = gst_video_format_new_caps (G_BYTE_ORDER == G_LITTLE_ENDIAN ?
+      GST_VIDEO_FORMAT_BGRx : GST_VIDEO_FORMAT_xRGB, 1920, 1080, 60, 1, 1, 1);
+  noise = make_noise (seconds * RATE);
+
+  for (i = 0; i < G_N_ELEMENTS (elements); i++) {
+    GstClockTime elapsed;
+
+    elapsed = run (elements[i], noise, audiocaps, videocaps);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed)) {
+      ret = 1;
+      break;
+    }
+    g_print ("%s, 1080p60: %d frames for %d s of audio in %" GST_TIME_FORMAT
+        ", %.1f frames/s\n", elements[i], n_out, seconds,
+        GST_TIME_ARGS (elapsed),
+        (gdouble) n_out * GST_SECOND / MAX (elapsed, 1));
+  }
+
+  gst_buffer_unref (noise);
+  gst_caps_unref (audiocaps);
+  gst_caps_unref (videocaps);
+
+  return ret;
+}
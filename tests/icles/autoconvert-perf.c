@@ -0,0 +1,129 @@
+/* GStreamer autoconvert negotiation benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Times how long a pipeline with an autoconvert between integer and float
+ * audio takes to negotiate and play a single buffer, first with the
+ * process-wide cache of selected elements empty (cold) and then --runs
+ * times with it filled (warm). A pipeline doing the same with an explicit
+ * audioconvert runs first, so that loading the plugins is not counted. */
+
+#include <gst/gst.h>
+
+#define SRC "audiotestsrc num-buffers=1 ! " \
+    "audio/x-raw-int, width=16, depth=16, channels=2, rate=44100 ! "
+#define SINK " ! audio/x-raw-float, width=32, channels=2, rate=44100 ! " \
+    "fakesink sync=false"
+
+static gint n_runs = 20;
+
+/* plays @desc until EOS and returns the time it took, or
+ * GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (const gchar * desc)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  GstClockTime start, elapsed;
+  GError *err = NULL;
+
+  pipeline = gst_parse_launch (desc, &err);
+  if (pipeline == NULL) {
+    g_printerr ("Could not create pipeline: %s\n", err->message);
+    g_error_free (err);
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  bus = gst_element_get_bus (pipeline);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &err, NULL);
+    g_printerr ("Error: %s\n", err->message);
+    g_error_free (err);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"runs", '\0', 0, G_OPTION_ARG_INT, &n_runs,
+        "Number of runs with a warm cache", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstElement *autoconvert;
+  GstClockTime cold, warm, total = 0;
+  guint hits, misses;
+  gint i;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (!GST_CLOCK_TIME_IS_VALID (run (SRC "audioconvert" SINK)))
+    return 1;
+
+  cold = run (SRC "autoconvert" SINK);
+  if (!GST_CLOCK_TIME_IS_VALID (cold))
+    return 1;
+
+  for (i = 0; i < n_runs; i++) {
+    warm = run (SRC "autoconvert" SINK);
+    if (!GST_CLOCK_TIME_IS_VALID (warm))
+      return 1;
+    total += warm;
+  }
+  warm = total / MAX (n_runs, 1);
+
+  autoconvert = gst_element_factory_make ("autoconvert", NULL);
+  g_object_get (autoconvert, "cache-hits", &hits, "cache-misses", &misses,
+      NULL);
+  gst_object_unref (autoconvert);
+
+  g_print ("cold cache: %" GST_TIME_FORMAT ", warm cache: %" GST_TIME_FORMAT
+      " on average over %d runs (%.1fx faster)\n", GST_TIME_ARGS (cold),
+      GST_TIME_ARGS (warm), n_runs,
+      gst_guint64_to_gdouble (cold) / gst_guint64_to_gdouble (MAX (warm, 1)));
+  g_print ("cache hits: %u, misses: %u\n", hits, misses);
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/* GStreamer bayer2rgb throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Demosaics 8 bit BGGR frames of 5 megapixels, as from a still camera
+ * sensor, with the bilinear and the malvar method on 1, 2 and 4 threads and
+ * prints the frames/s for each. The frames are pushed straight into the
+ * element, so only the conversion is timed. */
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+static gint width = 2592;
+static gint height = 1944;
+static gint n_frames = 20;
+
+static const gchar *methods[] = { "bilinear", "malvar" };
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_BGRx));
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+/* a BGGR mosaic of diagonal stripes */
+static GstBuffer *
+make_frame (void)
+{
+  GstBuffer *buf;
+  gint x, y;
+
+  buf = gst_buffer_new_and_alloc (GST_ROUND_UP_4 (width) * height);
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      gint l = (((x + 2 * y) / 7) & 1) ? 200 : 40;
+      gint v;
+
+      if (y & 1)
+        v = (x & 1) ? l : l * 3 / 4 + 30;
+      else
+        v = (x & 1) ? l * 3 / 4 + 30 : l / 2 + 60;
+      GST_BUFFER_DATA (buf)[y * GST_ROUND_UP_4 (width) + x] = v;
+    }
+  }
+
+  return buf;
+}
+
+static void
+set_enum (GstElement * element, const gchar * name, const gchar * nick)
+{
+  GParamSpec *pspec;
+  GEnumValue *value;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+  value = g_enum_get_value_by_nick (G_PARAM_SPEC_ENUM (pspec)->enum_class,
+      nick);
+  g_object_set (element, name, value->value, NULL);
+}
+
+/* converts @n_frames frames and returns the time it took, or
+ * GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (const gchar * method, gint n_threads)
+{
+  GstElement *bayer2rgb;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstCaps *caps;
+  GstBuffer *frame;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  bayer2rgb = gst_element_factory_make ("bayer2rgb", NULL);
+  if (bayer2rgb == NULL) {
+    g_printerr ("bayer2rgb not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+  set_enum (bayer2rgb, "method", method);
+  g_object_set (bayer2rgb, "n-threads", n_threads, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (bayer2rgb, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (bayer2rgb, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (bayer2rgb, GST_STATE_PLAYING);
+
+  caps = gst_caps_new_simple ("video/x-raw-bayer",
+      "format", G_TYPE_STRING, "bggr",
+      "width", G_TYPE_INT, width, "height", G_TYPE_INT, height,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  gst_pad_set_caps (srcpad, caps);
+  frame = make_frame ();
+  gst_buffer_set_caps (frame, caps);
+  gst_caps_unref (caps);
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    if (gst_pad_push (srcpad, gst_buffer_ref (frame)) != GST_FLOW_OK) {
+      g_printerr ("bayer2rgb did not take frame %d\n", i);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out != n_frames) {
+    g_printerr ("%d frames out for %d in\n", n_out, n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  gst_buffer_unref (frame);
+  gst_element_set_state (bayer2rgb, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (bayer2rgb);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"width", '\0', 0, G_OPTION_ARG_INT, &width, "Frame width", NULL},
+    {"height", '\0', 0, G_OPTION_ARG_INT, &height, "Frame height", NULL},
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames converted per run", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint m;
+  gint n_threads;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (m = 0; m < G_N_ELEMENTS (methods); m++) {
+    for (n_threads = 1; n_threads <= 4; n_threads *= 2) {
+      GstClockTime elapsed;
+
+      elapsed = run (methods[m], n_threads);
+      if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+        return 1;
+
+      g_print ("%dx%d %s, %d threads: %d frames in %" GST_TIME_FORMAT
+          ", %.1f frames/s\n", width, height, methods[m], n_threads,
+          n_frames, GST_TIME_ARGS (elapsed),
+          (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/* GStreamer cogscale throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Scales I420 1080p frames to 720p with cogscale set to 1 up to
+ * --max-threads threads and prints the frames/s for each thread count. The
+ * frames are pushed straight into the element, so only the scaling is
+ * timed. */
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+static gint n_frames = 100;
+static gint max_threads = 8;
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstBuffer *
+make_frame (GstCaps * caps)
+{
+  GstVideoFormat format;
+  GstBuffer *buf;
+  GRand *rand;
+  gint width, height;
+  guint i;
+
+  gst_video_format_parse_caps (caps, &format, &width, &height);
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size (format, width,
+          height));
+  rand = g_rand_new_with_seed (width * height);
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i++)
+    GST_BUFFER_DATA (buf)[i] = g_rand_int (rand);
+  g_rand_free (rand);
+  gst_buffer_set_caps (buf, caps);
+
+  return buf;
+}
+
+/* scales @n_frames frames from @incaps to @outcaps and returns the time it
+ * took, or GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (GstCaps * incaps, GstCaps * outcaps, gint n_threads)
+{
+  GstElement *scale;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstBuffer *frame;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  scale = gst_element_factory_make ("cogscale", NULL);
+  if (scale == NULL) {
+    g_printerr ("cogscale not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+  g_object_set (scale, "n-threads", n_threads, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (scale, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  /* fixed caps make cogscale output @outcaps */
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  gst_pad_use_fixed_caps (sinkpad);
+  gst_pad_set_caps (sinkpad, outcaps);
+  pad = gst_element_get_static_pad (scale, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (scale, GST_STATE_PLAYING);
+  gst_pad_set_caps (srcpad, incaps);
+
+  frame = make_frame (incaps);
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    if (gst_pad_push (srcpad, gst_buffer_ref (frame)) != GST_FLOW_OK) {
+      g_printerr ("cogscale did not take frame %d\n", i);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out != n_frames) {
+    g_printerr ("%d frames out for %d in\n", n_out, n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  gst_buffer_unref (frame);
+  gst_element_set_state (scale, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (scale);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames scaled per thread count", NULL},
+    {"max-threads", '\0', 0, G_OPTION_ARG_INT, &max_threads,
+        "Largest thread count to try", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstCaps *incaps, *outcaps;
+  gint n_threads;
+  gint ret = 0;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  incaps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, 1920, 1080, 25,
+      1, 1, 1);
+  outcaps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, 1280, 720, 25,
+      1, 1, 1);
+
+  for (n_threads = 1; n_threads <= max_threads; n_threads++) {
+    GstClockTime elapsed;
+
+    elapsed = run (incaps, outcaps, n_threads);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed)) {
+      ret = 1;
+      break;
+    }
+    g_print ("1080p to 720p, %d threads: %d frames in %" GST_TIME_FORMAT
+        ", %.1f frames/s\n", n_threads, n_frames, GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+  }
+
+  gst_caps_unref (incaps);
+  gst_caps_unref (outcaps);
+
+  return ret;
+}
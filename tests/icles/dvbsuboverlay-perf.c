@@ -0,0 +1,322 @@
+/* GStreamer dvbsuboverlay blending benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Overlays a single static DVB subtitle page, two lines of text sized
+ * region at the bottom of a 1920x1080 display, on --frames frames of
+ * interlaced I420 1080 line video and prints the frames/s, next to the
+ * frames/s of the same video without a subtitle page for comparison. The
+ * display set and the frames are generated up front and pushed straight
+ * into the element, so only the overlay is timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+#define REGION_X 240
+#define REGION_Y 860
+#define REGION_WIDTH 1440
+#define REGION_HEIGHT 160
+
+/* every run of the region is coded as 16 pixels of one colour */
+#define RUN_LENGTH 16
+
+static gint n_frames = 100;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420")));
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static guint8 *
+put_segment_header (guint8 * p, guint8 type, guint16 len)
+{
+  *p++ = 0x0f;                  /* sync byte */
+  *p++ = type;
+  GST_WRITE_UINT16_BE (p, 1);   /* page id */
+  GST_WRITE_UINT16_BE (p + 2, len);
+
+  return p + 4;
+}
+
+/* a display set with a display definition, a page with one 4 bit region and
+ * an object covering the region with runs of the white and transparent
+ * default CLUT entries, in a pattern that looks a bit like text */
+static GstBuffer *
+make_display_set (void)
+{
+  GstBuffer *buf;
+  guint8 *data, *p, *object;
+  gint x, y, line_len, top_field_len;
+
+  line_len = 1 + REGION_WIDTH / RUN_LENGTH * 2 + 1 + 1;
+  top_field_len = REGION_HEIGHT / 2 * line_len;
+
+  buf = gst_buffer_new_and_alloc (2 + 6 + 5 + 6 + 8 + 6 + 16 + 6 + 7 +
+      top_field_len + 6 + 1);
+  data = p = GST_BUFFER_DATA (buf);
+
+  *p++ = 0x20;                  /* data identifier */
+  *p++ = 0x00;                  /* subtitle stream id */
+
+  /* display definition: version 0, no window */
+  p = put_segment_header (p, 0x14, 5);
+  *p++ = 0x00;
+  GST_WRITE_UINT16_BE (p, WIDTH - 1);
+  GST_WRITE_UINT16_BE (p + 2, HEIGHT - 1);
+  p += 4;
+
+  /* page composition: the longest timeout, acquisition point, one region */
+  p = put_segment_header (p, 0x10, 8);
+  *p++ = 255;
+  *p++ = 1 << 2;
+  *p++ = 0;                     /* region id */
+  *p++ = 0;
+  GST_WRITE_UINT16_BE (p, REGION_X);
+  GST_WRITE_UINT16_BE (p + 2, REGION_Y);
+  p += 4;
+
+  /* region composition: filled, 4 bit, default CLUT, transparent background,
+   * one bitmap object at the origin */
+  p = put_segment_header (p, 0x11, 16);
+  *p++ = 0;                     /* region id */
+  *p++ = 1 << 3;
+  GST_WRITE_UINT16_BE (p, REGION_WIDTH);
+  GST_WRITE_UINT16_BE (p + 2, REGION_HEIGHT);
+  p += 4;
+  *p++ = (2 << 5) | (2 << 2);
+  *p++ = 0;                     /* CLUT id */
+  *p++ = 0;
+  *p++ = 0;
+  GST_WRITE_UINT16_BE (p, 0);   /* object id */
+  GST_WRITE_UINT16_BE (p + 2, 0);
+  GST_WRITE_UINT16_BE (p + 4, 0);
+  p += 6;
+
+  /* object data: pixels, the bottom field repeats the top field */
+  p = put_segment_header (p, 0x13, 7 + top_field_len);
+  GST_WRITE_UINT16_BE (p, 0);   /* object id */
+  p[2] = 0;
+  GST_WRITE_UINT16_BE (p + 3, top_field_len);
+  GST_WRITE_UINT16_BE (p + 5, 0);
+  p += 7;
+  object = p;
+  for (y = 0; y < REGION_HEIGHT / 2; y++) {
+    *p++ = 0x11;                /* 4 bit pixel code string */
+    for (x = 0; x < REGION_WIDTH / RUN_LENGTH; x++) {
+      gboolean ink = ((x * 7 + y / 4) % 5) < 2 && (y % 40) < 32;
+
+      /* 0000 1 1 10, then the run length - 9 and the colour */
+      *p++ = 0x0e;
+      *p++ = ((RUN_LENGTH - 9) << 4) | (ink ? 1 : 0);
+    }
+    *p++ = 0x00;                /* end of string */
+    *p++ = 0xf0;                /* end of line */
+  }
+  g_assert (p - object == top_field_len);
+
+  p = put_segment_header (p, 0x80, 0);
+
+  *p++ = 0xff;                  /* end of PES data */
+  g_assert ((guint) (p - data) == GST_BUFFER_SIZE (buf));
+
+  return buf;
+}
+
+static GstBuffer *
+make_frame (gint n)
+{
+  GstBuffer *buf;
+  guint8 *data;
+  gint x, y, stride;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT));
+  data = GST_BUFFER_DATA (buf);
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, WIDTH);
+
+  memset (data, 128, GST_BUFFER_SIZE (buf));
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++)
+      data[y * stride + x] = 16 + (x + y + n) % 220;
+  }
+
+  return buf;
+}
+
+/* overlays the display set if @with_page on @n_frames frames and returns the
+ * time it took, or GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (gboolean with_page)
+{
+  GstElement *overlay;
+  GstPad *videosrcpad, *textsrcpad, *sinkpad, *pad;
+  GstCaps *caps;
+  GstBuffer **frames;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  overlay = gst_element_factory_make ("dvbsuboverlay", NULL);
+  if (overlay == NULL) {
+    g_printerr ("dvbsuboverlay not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  videosrcpad = gst_pad_new ("videosrc", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (overlay, "video_sink");
+  gst_pad_link (videosrcpad, pad);
+  gst_object_unref (pad);
+
+  textsrcpad = gst_pad_new ("textsrc", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (overlay, "text_sink");
+  gst_pad_link (textsrcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (overlay, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (videosrcpad, TRUE);
+  gst_pad_set_active (textsrcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (overlay, GST_STATE_PLAYING);
+
+  gst_pad_push_event (videosrcpad, gst_event_new_new_segment (FALSE, 1.0,
+          GST_FORMAT_TIME, 0, -1, 0));
+  gst_pad_push_event (textsrcpad, gst_event_new_new_segment (FALSE, 1.0,
+          GST_FORMAT_TIME, 0, -1, 0));
+
+  if (with_page) {
+    GstBuffer *buf = make_display_set ();
+
+    caps = gst_caps_new_simple ("subpicture/x-dvb", NULL);
+    gst_pad_set_caps (textsrcpad, caps);
+    gst_buffer_set_caps (buf, caps);
+    gst_caps_unref (caps);
+    GST_BUFFER_TIMESTAMP (buf) = 0;
+    if (gst_pad_push (textsrcpad, buf) != GST_FLOW_OK) {
+      g_printerr ("dvbsuboverlay did not take the display set\n");
+      goto cleanup;
+    }
+  }
+
+  caps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT, 25,
+      1, 1, 1);
+  gst_caps_set_simple (caps, "interlaced", G_TYPE_BOOLEAN, TRUE, NULL);
+  gst_pad_set_caps (videosrcpad, caps);
+
+  /* the frames are handed over, so that the overlay can blend in place */
+  frames = g_new (GstBuffer *, n_frames);
+  for (i = 0; i < n_frames; i++) {
+    frames[i] = make_frame (i);
+    GST_BUFFER_TIMESTAMP (frames[i]) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (frames[i]) = GST_SECOND / 25;
+    gst_buffer_set_caps (frames[i], caps);
+  }
+  gst_caps_unref (caps);
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *frame = frames[i];
+
+    frames[i] = NULL;
+    if (gst_pad_push (videosrcpad, frame) != GST_FLOW_OK) {
+      g_printerr ("dvbsuboverlay did not take frame %d\n", i);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out != n_frames) {
+    g_printerr ("%d frames out for %d in\n", n_out, n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  for (i = 0; i < n_frames; i++) {
+    if (frames[i])
+      gst_buffer_unref (frames[i]);
+  }
+  g_free (frames);
+cleanup:
+  gst_element_set_state (overlay, GST_STATE_NULL);
+  gst_pad_set_active (videosrcpad, FALSE);
+  gst_pad_set_active (textsrcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (videosrcpad);
+  gst_object_unref (textsrcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (overlay);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of video frames overlaid per run", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint with_page;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (with_page = 0; with_page <= 1; with_page++) {
+    GstClockTime elapsed;
+
+    elapsed = run (with_page);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+    g_print ("1080i, %s: %d frames in %" GST_TIME_FORMAT ", %.1f frames/s\n",
+        with_page ? "static page" : "no page", n_frames,
+        GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+  }
+
+  return 0;
+}
@@ -0,0 +1,219 @@
+/* GStreamer fieldanalysis throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Analyses I420 1080 line frames with fieldanalysis on 1, 2 and 4 threads
+ * and prints the frames/s for each: interlaced content with the windowed
+ * comb frame metric, and progressive content with the 5-tap frame metric
+ * and the subsampled fast pass. The frames are generated up front and
+ * pushed straight into the element, so only the analysis is timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static gint n_frames = 50;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420")));
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+/* 64 samples wide vertical bars, shifted by @top_shift in the top field and
+ * @bottom_shift in the bottom field */
+static GstBuffer *
+make_frame (gint top_shift, gint bottom_shift)
+{
+  GstBuffer *buf;
+  guint8 *data;
+  gint x, y, stride;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT));
+  data = GST_BUFFER_DATA (buf);
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, WIDTH);
+
+  memset (data, 128, GST_BUFFER_SIZE (buf));
+  for (y = 0; y < HEIGHT; y++) {
+    gint shift = (y & 1) ? bottom_shift : top_shift;
+
+    for (x = 0; x < WIDTH; x++)
+      data[y * stride + x] = ((x + shift) / 64) & 1 ? 235 : 16;
+  }
+
+  return buf;
+}
+
+static void
+set_enum (GstElement * element, const gchar * name, const gchar * nick)
+{
+  GParamSpec *pspec;
+  GEnumValue *value;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+  value = g_enum_get_value_by_nick (G_PARAM_SPEC_ENUM (pspec)->enum_class,
+      nick);
+  g_object_set (element, name, value->value, NULL);
+}
+
+/* analyses @n_frames frames of moving bars, interlaced if @interlaced, and
+ * returns the time it took, or GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (gboolean interlaced, const gchar * frame_metric, gboolean fast_pass,
+    gint n_threads)
+{
+  GstElement *fieldanalysis;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstCaps *caps;
+  GstBuffer **frames;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  fieldanalysis = gst_element_factory_make ("fieldanalysis", NULL);
+  if (fieldanalysis == NULL) {
+    g_printerr ("fieldanalysis not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+  set_enum (fieldanalysis, "frame-metric", frame_metric);
+  g_object_set (fieldanalysis, "n-threads", n_threads, "fast-pass", fast_pass,
+      NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (fieldanalysis, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (fieldanalysis, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (fieldanalysis, GST_STATE_PLAYING);
+
+  caps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT, 25,
+      1, 1, 1);
+  gst_pad_set_caps (srcpad, caps);
+
+  /* the bottom field is half a frame later for interlaced content */
+  frames = g_new (GstBuffer *, n_frames);
+  for (i = 0; i < n_frames; i++) {
+    frames[i] = make_frame (32 * i, 32 * i + (interlaced ? 16 : 0));
+    GST_BUFFER_TIMESTAMP (frames[i]) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (frames[i]) = GST_SECOND / 25;
+    gst_buffer_set_caps (frames[i], caps);
+  }
+  gst_caps_unref (caps);
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *frame = frames[i];
+
+    frames[i] = NULL;
+    if (gst_pad_push (srcpad, frame) != GST_FLOW_OK) {
+      g_printerr ("fieldanalysis did not take frame %d\n", i);
+      goto done;
+    }
+  }
+  /* the last frames are only pushed on EOS */
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out == 0) {
+    g_printerr ("no frames out for %d in\n", n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  for (i = 0; i < n_frames; i++) {
+    if (frames[i])
+      gst_buffer_unref (frames[i]);
+  }
+  g_free (frames);
+  gst_element_set_state (fieldanalysis, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (fieldanalysis);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames analysed per run", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint n_threads;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (n_threads = 1; n_threads <= 4; n_threads *= 2) {
+    GstClockTime elapsed;
+
+    elapsed = run (TRUE, "windowed-comb", FALSE, n_threads);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+    g_print ("interlaced, windowed-comb, %d threads: %d frames in %"
+        GST_TIME_FORMAT ", %.1f frames/s\n", n_threads, n_frames,
+        GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+
+    elapsed = run (FALSE, "5-tap", TRUE, n_threads);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+    g_print ("progressive, 5-tap with fast pass, %d threads: %d frames in %"
+        GST_TIME_FORMAT ", %.1f frames/s\n", n_threads, n_frames,
+        GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+  }
+
+  return 0;
+}
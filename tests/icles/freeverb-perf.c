@@ -0,0 +1,209 @@
+/* GStreamer freeverb throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Runs --seconds seconds of 44.1 kHz noise through freeverb for each sample
+ * format and channel count it takes and prints the input samples/s. The
+ * buffers are pushed straight into the element, so only the reverb is
+ * timed. */
+
+#include <gst/gst.h>
+
+#define RATE 44100
+/* 0.1 seconds per buffer */
+#define BUFFER_FRAMES (RATE / 10)
+
+typedef enum
+{
+  FORMAT_S16,
+  FORMAT_S32,
+  FORMAT_F32
+} Format;
+
+static const gchar *format_names[] = { "S16", "S32", "F32" };
+
+static gint seconds = 60;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstCaps *
+make_caps (Format format, gint channels)
+{
+  GstCaps *caps;
+
+  if (format == FORMAT_F32) {
+    caps = gst_caps_new_simple ("audio/x-raw-float",
+        "width", G_TYPE_INT, 32, "endianness", G_TYPE_INT, G_BYTE_ORDER,
+        NULL);
+  } else {
+    gint width = (format == FORMAT_S16) ? 16 : 32;
+
+    caps = gst_caps_new_simple ("audio/x-raw-int",
+        "width", G_TYPE_INT, width, "depth", G_TYPE_INT, width,
+        "signed", G_TYPE_BOOLEAN, TRUE,
+        "endianness", G_TYPE_INT, G_BYTE_ORDER, NULL);
+  }
+  gst_caps_set_simple (caps, "rate", G_TYPE_INT, RATE,
+      "channels", G_TYPE_INT, channels, NULL);
+
+  return caps;
+}
+
+/* a buffer of noise with samples of half the full scale */
+static GstBuffer *
+make_buffer (Format format, gint channels, GstCaps * caps)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  gint i, n = BUFFER_FRAMES * channels;
+
+  buf = gst_buffer_new_and_alloc (n * 4 / (format == FORMAT_S16 ? 2 : 1));
+  rand = g_rand_new_with_seed (channels);
+  for (i = 0; i < n; i++) {
+    gint v = g_rand_int_range (rand, -16384, 16384);
+
+    switch (format) {
+      case FORMAT_S16:
+        ((gint16 *) GST_BUFFER_DATA (buf))[i] = v;
+        break;
+      case FORMAT_S32:
+        ((gint32 *) GST_BUFFER_DATA (buf))[i] = v << 16;
+        break;
+      case FORMAT_F32:
+        ((gfloat *) GST_BUFFER_DATA (buf))[i] = v / 32768.0;
+        break;
+    }
+  }
+  g_rand_free (rand);
+  gst_buffer_set_caps (buf, caps);
+
+  return buf;
+}
+
+/* returns the time freeverb took for @seconds seconds of input, or
+ * GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (Format format, gint channels)
+{
+  GstElement *freeverb;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstCaps *caps;
+  GstBuffer *buf;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  freeverb = gst_element_factory_make ("freeverb", NULL);
+  if (freeverb == NULL) {
+    g_printerr ("freeverb not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (freeverb, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (freeverb, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (freeverb, GST_STATE_PLAYING);
+
+  caps = make_caps (format, channels);
+  gst_pad_set_caps (srcpad, caps);
+  buf = make_buffer (format, channels, caps);
+  gst_caps_unref (caps);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < seconds * 10; i++) {
+    if (gst_pad_push (srcpad, gst_buffer_ref (buf)) != GST_FLOW_OK) {
+      g_printerr ("freeverb did not take buffer %d\n", i);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+done:
+  gst_buffer_unref (buf);
+  gst_element_set_state (freeverb, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (freeverb);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"seconds", '\0', 0, G_OPTION_ARG_INT, &seconds,
+        "Seconds of audio processed per format", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  Format format;
+  gint channels;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (format = FORMAT_S16; format <= FORMAT_F32; format++) {
+    for (channels = 1; channels <= 2; channels++) {
+      GstClockTime elapsed;
+
+      elapsed = run (format, channels);
+      if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+        return 1;
+
+      g_print ("%s, %d channels: %d s of audio in %" GST_TIME_FORMAT
+          ", %.0f samples/s (%.1fx realtime)\n", format_names[format],
+          channels, seconds, GST_TIME_ARGS (elapsed),
+          (gdouble) seconds * RATE * GST_SECOND / MAX (elapsed, 1),
+          (gdouble) seconds * GST_SECOND / MAX (elapsed, 1));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+/* GStreamer mpegpsmux throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Muxes an MPEG-2 video elementary stream of --buffers buffers of --size
+ * bytes with mpegpsmux, with and without GOP aggregation, and prints the
+ * bytes/s of program stream output. The buffers are generated up front and
+ * pushed straight into the muxer, so only the muxing is timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+
+static gint n_buffers = 100;
+static gint buffer_size = 256 * 1024;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static guint64 n_bytes;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_bytes += GST_BUFFER_SIZE (buffer);
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstBufferListItem
+count_bytes (GstBuffer ** buffer, guint group, guint idx, gpointer user_data)
+{
+  n_bytes += GST_BUFFER_SIZE (*buffer);
+
+  return GST_BUFFER_LIST_CONTINUE;
+}
+
+static GstFlowReturn
+sink_chain_list (GstPad * pad, GstBufferList * list)
+{
+  gst_buffer_list_foreach (list, count_bytes, NULL);
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+/* muxes the stream and returns the time it took, or GST_CLOCK_TIME_NONE on
+ * error */
+static GstClockTime
+run (gboolean aggregate_gops)
+{
+  GstElement *mux;
+  GstPad *srcpad, *sinkpad, *pad, *muxsrcpad;
+  GstCaps *caps;
+  GstBuffer **input;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  mux = gst_element_factory_make ("mpegpsmux", NULL);
+  if (mux == NULL) {
+    g_printerr ("mpegpsmux not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+  g_object_set (mux, "aggregate-gops", aggregate_gops, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_request_pad (mux, "sink_%d");
+  gst_pad_link (srcpad, pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  gst_pad_set_chain_list_function (sinkpad, sink_chain_list);
+  muxsrcpad = gst_element_get_static_pad (mux, "src");
+  gst_pad_link (muxsrcpad, sinkpad);
+  gst_object_unref (muxsrcpad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (mux, GST_STATE_PLAYING);
+
+  caps = gst_caps_new_simple ("video/mpeg", "mpegversion", G_TYPE_INT, 2,
+      "systemstream", G_TYPE_BOOLEAN, FALSE, NULL);
+  input = g_new (GstBuffer *, n_buffers);
+  for (i = 0; i < n_buffers; i++) {
+    input[i] = gst_buffer_new_and_alloc (buffer_size);
+    memset (GST_BUFFER_DATA (input[i]), i, buffer_size);
+    GST_BUFFER_TIMESTAMP (input[i]) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (input[i]) = GST_SECOND / 25;
+    /* a GOP every 12 frames */
+    if (i % 12)
+      GST_BUFFER_FLAG_SET (input[i], GST_BUFFER_FLAG_DELTA_UNIT);
+    gst_buffer_set_caps (input[i], caps);
+  }
+  gst_caps_unref (caps);
+  n_bytes = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buf = input[i];
+
+    input[i] = NULL;
+    if (gst_pad_push (srcpad, buf) != GST_FLOW_OK) {
+      g_printerr ("mpegpsmux did not take buffer %d\n", i);
+      goto done;
+    }
+  }
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+  elapsed = gst_util_get_timestamp () - start;
+
+done:
+  for (i = 0; i < n_buffers; i++) {
+    if (input[i])
+      gst_buffer_unref (input[i]);
+  }
+  g_free (input);
+  gst_element_set_state (mux, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_pad_unlink (srcpad, pad);
+  gst_element_release_request_pad (mux, pad);
+  gst_object_unref (pad);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (mux);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"buffers", '\0', 0, G_OPTION_ARG_INT, &n_buffers,
+        "Number of elementary stream buffers", NULL},
+    {"size", '\0', 0, G_OPTION_ARG_INT, &buffer_size,
+        "Size of the elementary stream buffers", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint aggregate_gops;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (aggregate_gops = 0; aggregate_gops <= 1; aggregate_gops++) {
+    GstClockTime elapsed;
+
+    elapsed = run (aggregate_gops);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+
+    g_print ("%s: muxed %" G_GUINT64_FORMAT " bytes in %" GST_TIME_FORMAT
+        ", %" G_GUINT64_FORMAT " bytes/s\n",
+        aggregate_gops ? "GOP aggregation" : "packet lists", n_bytes,
+        GST_TIME_ARGS (elapsed),
+        gst_util_uint64_scale (n_bytes, GST_SECOND, MAX (elapsed, 1)));
+  }
+
+  return 0;
+}
@@ -0,0 +1,236 @@
+/* GStreamer openh264 encoder and decoder benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Encodes --frames I420 1920x1080 frames with openh264enc on 1, 2, 4 and 8
+ * threads, with as many slices as threads, and decodes each of the streams
+ * again with openh264dec, printing the frames/s of both. The frames are
+ * generated up front and pushed straight into the elements, so only the
+ * encoding and decoding are timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static gint n_frames = 100;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static gint n_out;
+static GList *collected;
+
+/* keeps the encoded stream for the decoder runs */
+static GstFlowReturn
+collect_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  collected = g_list_prepend (collected, buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+/* a diagonal ramp moving by @n samples per frame */
+static GstBuffer *
+make_frame (gint n)
+{
+  GstBuffer *buf;
+  guint8 *data;
+  gint x, y, stride;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT));
+  data = GST_BUFFER_DATA (buf);
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, WIDTH);
+
+  memset (data, 128, GST_BUFFER_SIZE (buf));
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++)
+      data[y * stride + x] = 16 + (x + y + 4 * n) % 220;
+  }
+
+  return buf;
+}
+
+/* pushes @input, which is consumed, through @element and EOS and returns
+ * the time it took, or GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (GstElement * element, GList * input, GstCaps * caps,
+    GstPadChainFunction chain)
+{
+  GstPad *srcpad, *sinkpad, *pad;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  GList *l;
+  gint i;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, chain);
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (element, GST_STATE_PLAYING);
+  gst_pad_set_caps (srcpad, caps);
+  gst_pad_push_event (srcpad, gst_event_new_new_segment (FALSE, 1.0,
+          GST_FORMAT_TIME, 0, -1, 0));
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (l = input, i = 0; l; l = l->next, i++) {
+    GstBuffer *buf = GST_BUFFER_CAST (l->data);
+
+    l->data = NULL;
+    if (gst_pad_push (srcpad, buf) != GST_FLOW_OK) {
+      g_printerr ("%s did not take buffer %d\n", GST_ELEMENT_NAME (element),
+          i);
+      goto done;
+    }
+  }
+  /* the last frames are only pushed on EOS */
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out != n_frames) {
+    g_printerr ("%s: %d frames out for %d in\n", GST_ELEMENT_NAME (element),
+        n_out, n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  for (l = input; l; l = l->next) {
+    if (l->data)
+      gst_buffer_unref (GST_BUFFER_CAST (l->data));
+  }
+  g_list_free (input);
+  gst_element_set_state (element, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+
+  return elapsed;
+}
+
+static void
+print_fps (const gchar * what, guint n_threads, GstClockTime elapsed)
+{
+  g_print ("%s, %u threads: %d frames in %" GST_TIME_FORMAT
+      ", %.1f frames/s\n", what, n_threads, n_frames, GST_TIME_ARGS (elapsed),
+      (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames encoded and decoded per run", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstElement *enc, *dec;
+  GstCaps *rawcaps, *h264caps;
+  GList *input;
+  GstClockTime elapsed;
+  guint n_threads;
+  gint i;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  rawcaps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT,
+      25, 1, 1, 1);
+
+  for (n_threads = 1; n_threads <= 8; n_threads *= 2) {
+    enc = gst_element_factory_make ("openh264enc", NULL);
+    dec = gst_element_factory_make ("openh264dec", NULL);
+    if (enc == NULL || dec == NULL) {
+      g_printerr ("openh264enc or openh264dec not found\n");
+      return 1;
+    }
+    gst_util_set_object_arg (G_OBJECT (enc), "slice-mode", "auto");
+    g_object_set (enc, "multi-thread", n_threads, NULL);
+
+    input = NULL;
+    for (i = n_frames - 1; i >= 0; i--) {
+      GstBuffer *buf = make_frame (i);
+
+      GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 25;
+      GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+      gst_buffer_set_caps (buf, rawcaps);
+      input = g_list_prepend (input, buf);
+    }
+
+    elapsed = run (enc, input, rawcaps, collect_chain);
+    gst_object_unref (enc);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+    print_fps ("encode", n_threads, elapsed);
+
+    /* the decoder has no threads of its own, but decodes the slices of
+     * the stream encoded with @n_threads */
+    input = g_list_reverse (collected);
+    collected = NULL;
+    if (GST_BUFFER_CAPS (input->data))
+      h264caps = gst_caps_ref (GST_BUFFER_CAPS (input->data));
+    else
+      h264caps = gst_caps_new_simple ("video/x-h264",
+          "stream-format", G_TYPE_STRING, "byte-stream",
+          "alignment", G_TYPE_STRING, "au", NULL);
+    elapsed = run (dec, input, h264caps, sink_chain);
+    gst_caps_unref (h264caps);
+    gst_object_unref (dec);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed))
+      return 1;
+    print_fps ("decode", n_threads, elapsed);
+  }
+
+  gst_caps_unref (rawcaps);
+
+  return 0;
+}
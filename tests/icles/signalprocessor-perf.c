@@ -0,0 +1,309 @@
+/* GStreamer GstSignalProcessor de/interleaving benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Pushes --seconds seconds of 48 kHz float audio with 1, 2, 6 and 8
+ * channels through a signal processor that only copies its input group to
+ * its output group, with whole buffers and with fixed blocks, and prints
+ * the sample frames/s for each, next to the naive de/interleaving loops
+ * the base class used to run, for comparison. The audio is generated up
+ * front and pushed straight into the element, so only the de/interleaving
+ * and the scheduling of the blocks are timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/signalprocessor/gstsignalprocessor.h>
+
+#define RATE 48000
+#define BUFFER_FRAMES 4096
+
+static gint seconds = 60;
+
+static const guint channel_counts[] = { 1, 2, 6, 8 };
+static const guint block_sizes[] = { 0, 1024 };
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+/* a processor with one multi-channel input and output group that copies
+ * the de-interleaved input to the output */
+typedef struct _GstCopyProcessor GstCopyProcessor;
+typedef struct _GstCopyProcessorClass GstCopyProcessorClass;
+
+struct _GstCopyProcessor
+{
+  GstSignalProcessor parent;
+};
+
+struct _GstCopyProcessorClass
+{
+  GstSignalProcessorClass parent_class;
+};
+
+static void
+gst_copy_processor_process (GstSignalProcessor * processor, guint nframes)
+{
+  GstSignalProcessorGroup *in = &processor->group_in[0];
+  GstSignalProcessorGroup *out = &processor->group_out[0];
+
+  if (out->buffer != in->buffer)
+    memcpy (out->buffer, in->buffer, in->channels * nframes * sizeof (gfloat));
+}
+
+static void
+gst_copy_processor_class_init (GstCopyProcessorClass * klass,
+    gpointer class_data)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstSignalProcessorClass *processor_class =
+      GST_SIGNAL_PROCESSOR_CLASS (klass);
+  guint channels = GPOINTER_TO_UINT (class_data);
+
+  gst_signal_processor_class_add_pad_template (processor_class, "sink",
+      GST_PAD_SINK, 0, channels);
+  gst_signal_processor_class_add_pad_template (processor_class, "src",
+      GST_PAD_SRC, 0, channels);
+  gst_element_class_set_details_simple (element_class, "Copy processor",
+      "Filter/Effect/Audio", "Copy processor", "GStreamer");
+
+  processor_class->num_group_in = 1;
+  processor_class->num_group_out = 1;
+  processor_class->process = gst_copy_processor_process;
+}
+
+/* one subclass per channel count, the pad templates are per class */
+static GType
+gst_copy_processor_get_type (guint channels)
+{
+  GTypeInfo info = {
+    sizeof (GstCopyProcessorClass), NULL, NULL,
+    (GClassInitFunc) gst_copy_processor_class_init, NULL, NULL,
+    sizeof (GstCopyProcessor), 0, NULL
+  };
+  gchar *name;
+  GType type;
+
+  name = g_strdup_printf ("GstCopyProcessor%u", channels);
+  type = g_type_from_name (name);
+  if (!type) {
+    info.class_data = GUINT_TO_POINTER (channels);
+    type = g_type_register_static (GST_TYPE_SIGNAL_PROCESSOR, name, &info, 0);
+  }
+  g_free (name);
+
+  return type;
+}
+
+static GstBuffer *
+make_noise (guint channels, guint n_frames)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  gfloat *data;
+  guint i;
+
+  buf = gst_buffer_new_and_alloc (n_frames * channels * sizeof (gfloat));
+  data = (gfloat *) GST_BUFFER_DATA (buf);
+  rand = g_rand_new_with_seed (channels);
+  for (i = 0; i < n_frames * channels; i++)
+    data[i] = g_rand_double_range (rand, -1.0, 1.0);
+  g_rand_free (rand);
+
+  return buf;
+}
+
+/* de-interleaves and re-interleaves @noise buffer by buffer with the
+ * double loops the base class used to run, and returns the time it took;
+ * the checksum keeps the compiler from dropping the unused output */
+static GstClockTime
+run_reference (GstBuffer * noise, guint channels, gdouble * checksum)
+{
+  const gfloat *in = (const gfloat *) GST_BUFFER_DATA (noise);
+  gfloat *planar, *out;
+  guint n_frames, offset, c, i;
+  GstClockTime start, elapsed;
+
+  n_frames = GST_BUFFER_SIZE (noise) / (channels * sizeof (gfloat));
+  planar = g_new (gfloat, BUFFER_FRAMES * channels);
+  out = g_new (gfloat, BUFFER_FRAMES * channels);
+
+  start = gst_util_get_timestamp ();
+  for (offset = 0; offset + BUFFER_FRAMES <= n_frames;
+      offset += BUFFER_FRAMES) {
+    const gfloat *src = in + offset * channels;
+
+    for (i = 0; i < BUFFER_FRAMES; i++)
+      for (c = 0; c < channels; c++)
+        planar[c * BUFFER_FRAMES + i] = src[i * channels + c];
+    for (i = 0; i < BUFFER_FRAMES; i++)
+      for (c = 0; c < channels; c++)
+        out[i * channels + c] = planar[c * BUFFER_FRAMES + i];
+    *checksum += out[BUFFER_FRAMES * channels - 1];
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  g_free (planar);
+  g_free (out);
+
+  return elapsed;
+}
+
+/* pushes @noise through a copy processor in buffers of BUFFER_FRAMES and
+ * returns the time it took, or GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (GstBuffer * noise, guint channels, guint block_size)
+{
+  GstElement *processor;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstCaps *caps;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  guint offset, size;
+
+  processor = g_object_new (gst_copy_processor_get_type (channels), NULL);
+  g_object_set (processor, "block-size", block_size, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (processor, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (processor, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (processor, GST_STATE_PLAYING);
+
+  caps = gst_caps_new_simple ("audio/x-raw-float",
+      "endianness", G_TYPE_INT, G_BYTE_ORDER, "width", G_TYPE_INT, 32,
+      "channels", G_TYPE_INT, channels, "rate", G_TYPE_INT, RATE, NULL);
+  gst_pad_set_caps (srcpad, caps);
+  n_out = 0;
+
+  size = BUFFER_FRAMES * channels * sizeof (gfloat);
+  start = gst_util_get_timestamp ();
+  for (offset = 0; offset + size <= GST_BUFFER_SIZE (noise); offset += size) {
+    GstBuffer *buf = gst_buffer_create_sub (noise, offset, size);
+
+    gst_buffer_set_caps (buf, caps);
+    if (gst_pad_push (srcpad, buf) != GST_FLOW_OK) {
+      g_printerr ("processor did not take the buffer at %u\n", offset);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out == 0) {
+    g_printerr ("processor output no buffers\n");
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  gst_caps_unref (caps);
+  gst_element_set_state (processor, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (processor);
+
+  return elapsed;
+}
+
+static void
+print_rate (const gchar * what, guint channels, guint n_frames,
+    GstClockTime elapsed)
+{
+  g_print ("%u channels, %s: %u frames in %" GST_TIME_FORMAT
+      ", %.0f frames/s\n", channels, what, n_frames, GST_TIME_ARGS (elapsed),
+      (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"seconds", '\0', 0, G_OPTION_ARG_INT, &seconds,
+        "Seconds of audio processed per run", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstClockTime elapsed;
+  guint c, b, n_frames;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  /* whole buffers only */
+  n_frames = seconds * RATE / BUFFER_FRAMES * BUFFER_FRAMES;
+
+  for (c = 0; c < G_N_ELEMENTS (channel_counts); c++) {
+    guint channels = channel_counts[c];
+    GstBuffer *noise = make_noise (channels, n_frames);
+    gdouble checksum = 0.0;
+    gchar *what;
+
+    elapsed = run_reference (noise, channels, &checksum);
+    what = g_strdup_printf ("scalar reference (checksum %f)", checksum);
+    print_rate (what, channels, n_frames, elapsed);
+    g_free (what);
+
+    for (b = 0; b < G_N_ELEMENTS (block_sizes); b++) {
+      elapsed = run (noise, channels, block_sizes[b]);
+      if (!GST_CLOCK_TIME_IS_VALID (elapsed)) {
+        gst_buffer_unref (noise);
+        return 1;
+      }
+      if (block_sizes[b])
+        what = g_strdup_printf ("block-size %u", block_sizes[b]);
+      else
+        what = g_strdup ("whole buffers");
+      print_rate (what, channels, n_frames, elapsed);
+      g_free (what);
+    }
+
+    gst_buffer_unref (noise);
+  }
+
+  return 0;
+}
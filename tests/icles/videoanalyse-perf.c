@@ -0,0 +1,239 @@
+/* GStreamer videoanalyse throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Analyses I420 720x576 frames of random luma with videoanalyse in a few
+ * configurations and prints the frames/s for each, next to the scalar two
+ * pass statistics the element used to compute, for comparison. The frames
+ * are pushed straight into the element, so only the analysis is timed. */
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define WIDTH 720
+#define HEIGHT 576
+
+static gint n_frames = 100;
+
+static const gchar *configs[] = { "", "probe=true", "line-step=4",
+  "interval=5", "roi-x=180 roi-y=144 roi-width=360 roi-height=288"
+};
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420")));
+
+static gint n_out;
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  n_out++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstBuffer *
+make_frame (guint32 seed, GstCaps * caps)
+{
+  GstBuffer *buf;
+  GRand *rand;
+  guint8 *data;
+  gint x, y, stride;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size
+      (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT));
+  data = GST_BUFFER_DATA (buf);
+  memset (data, 128, GST_BUFFER_SIZE (buf));
+
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, WIDTH);
+  rand = g_rand_new_with_seed (seed);
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++)
+      data[y * stride + x] = g_rand_int_range (rand, 16, 236);
+  }
+  g_rand_free (rand);
+  gst_buffer_set_caps (buf, caps);
+
+  return buf;
+}
+
+/* the brightness and variance as the element used to compute them, in two
+ * passes over the luma plane */
+static void
+reference_stats (GstBuffer * buf, gdouble * brightness, gdouble * variance)
+{
+  guint8 *data = GST_BUFFER_DATA (buf);
+  guint64 sum;
+  gint avg, diff, stride, i, j;
+
+  stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, WIDTH);
+
+  sum = 0;
+  for (i = 0; i < HEIGHT; i++) {
+    for (j = 0; j < WIDTH; j++)
+      sum += data[i * stride + j];
+  }
+  avg = sum / (WIDTH * HEIGHT);
+  *brightness = sum / (255.0 * WIDTH * HEIGHT);
+
+  sum = 0;
+  for (i = 0; i < HEIGHT; i++) {
+    for (j = 0; j < WIDTH; j++) {
+      diff = avg - data[i * stride + j];
+      sum += diff * diff;
+    }
+  }
+  *variance = sum / (255.0 * 255.0 * WIDTH * HEIGHT);
+}
+
+/* pushes @frames through a videoanalyse configured with @props, a space
+ * separated list of property=value, and returns the time it took, or
+ * GST_CLOCK_TIME_NONE on error */
+static GstClockTime
+run (const gchar * props, GstBuffer ** frames, GstCaps * caps)
+{
+  GstElement *videoanalyse;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstClockTime start, elapsed = GST_CLOCK_TIME_NONE;
+  gchar **args, **arg;
+  gint i;
+
+  videoanalyse = gst_element_factory_make ("videoanalyse", NULL);
+  if (videoanalyse == NULL) {
+    g_printerr ("videoanalyse not found\n");
+    return GST_CLOCK_TIME_NONE;
+  }
+  args = g_strsplit (props, " ", -1);
+  for (arg = args; *arg; arg++) {
+    gchar **kv = g_strsplit (*arg, "=", 2);
+
+    if (kv[0] && kv[1])
+      gst_util_set_object_arg (G_OBJECT (videoanalyse), kv[0], kv[1]);
+    g_strfreev (kv);
+  }
+  g_strfreev (args);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (videoanalyse, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  pad = gst_element_get_static_pad (videoanalyse, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (videoanalyse, GST_STATE_PLAYING);
+  gst_pad_set_caps (srcpad, caps);
+  n_out = 0;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    if (gst_pad_push (srcpad, gst_buffer_ref (frames[i])) != GST_FLOW_OK) {
+      g_printerr ("videoanalyse did not take frame %d\n", i);
+      goto done;
+    }
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (n_out != n_frames) {
+    g_printerr ("%d frames out for %d in\n", n_out, n_frames);
+    elapsed = GST_CLOCK_TIME_NONE;
+  }
+
+done:
+  gst_element_set_state (videoanalyse, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (videoanalyse);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames analysed per configuration", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstBuffer **frames;
+  GstCaps *caps;
+  GstClockTime start, elapsed;
+  gdouble brightness, variance, sum = 0.0;
+  gint i, ret = 0;
+  guint c;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  caps = gst_video_format_new_caps (GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT, 25,
+      1, 1, 1);
+  frames = g_new (GstBuffer *, n_frames);
+  for (i = 0; i < n_frames; i++)
+    frames[i] = make_frame (i, caps);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    reference_stats (frames[i], &brightness, &variance);
+    sum += brightness + variance;
+  }
+  elapsed = gst_util_get_timestamp () - start;
+  /* the checksum keeps the compiler from dropping the unused statistics */
+  g_print ("scalar reference: %d frames in %" GST_TIME_FORMAT
+      ", %.1f frames/s (checksum %f)\n", n_frames, GST_TIME_ARGS (elapsed),
+      (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1), sum);
+
+  for (c = 0; c < G_N_ELEMENTS (configs); c++) {
+    elapsed = run (configs[c], frames, caps);
+    if (!GST_CLOCK_TIME_IS_VALID (elapsed)) {
+      ret = 1;
+      break;
+    }
+    g_print ("\"%s\": %d frames in %" GST_TIME_FORMAT ", %.1f frames/s\n",
+        configs[c], n_frames, GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+  }
+
+  for (i = 0; i < n_frames; i++)
+    gst_buffer_unref (frames[i]);
+  g_free (frames);
+  gst_caps_unref (caps);
+
+  return ret;
+}
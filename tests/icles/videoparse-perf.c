@@ -0,0 +1,180 @@
+/* GStreamer videoparse throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Measures how many frames per second videoparse gets through a large raw
+ * I420 file, once in pull mode (filesrc ! videoparse) and once in push mode
+ * (filesrc ! queue ! videoparse) for comparison.
+ *
+ * Without --location a temporary file of --frames frames is written first
+ * and removed afterwards.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+static gint width = 1920;
+static gint height = 1080;
+static gint n_frames = 300;
+static gchar *location = NULL;
+
+static gboolean
+write_file (const gchar * filename, gsize frame_size)
+{
+  FILE *f;
+  guint8 *data;
+  gint i;
+  gboolean ret = TRUE;
+
+  f = g_fopen (filename, "wb");
+  if (f == NULL)
+    return FALSE;
+
+  data = g_malloc (frame_size);
+  for (i = 0; i < n_frames && ret; i++) {
+    memset (data, i & 0xff, frame_size);
+    ret = (fwrite (data, 1, frame_size, f) == frame_size);
+  }
+  g_free (data);
+
+  if (fclose (f) != 0)
+    ret = FALSE;
+
+  return ret;
+}
+
+static gboolean
+run (const gchar * filename, gboolean push_mode, GstClockTime * elapsed)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  GstClockTime start;
+  GError *err = NULL;
+  gchar *desc;
+  gboolean ret;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" %s ! videoparse "
+      "width=%d height=%d ! fakesink sync=false", filename,
+      push_mode ? "! queue" : "", width, height);
+  pipeline = gst_parse_launch (desc, &err);
+  g_free (desc);
+  if (pipeline == NULL) {
+    g_printerr ("Could not create pipeline: %s\n", err->message);
+    g_error_free (err);
+    return FALSE;
+  }
+
+  bus = gst_element_get_bus (pipeline);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  *elapsed = gst_util_get_timestamp () - start;
+
+  ret = (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  if (!ret) {
+    gst_message_parse_error (msg, &err, NULL);
+    g_printerr ("Error: %s\n", err->message);
+    g_error_free (err);
+  }
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionEntry options[] = {
+    {"width", '\0', 0, G_OPTION_ARG_INT, &width, "Frame width", NULL},
+    {"height", '\0', 0, G_OPTION_ARG_INT, &height, "Frame height", NULL},
+    {"frames", '\0', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames in the generated file", NULL},
+    {"location", '\0', 0, G_OPTION_ARG_FILENAME, &location,
+        "Existing I420 file to parse instead of a generated one", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gchar *filename;
+  gsize frame_size;
+  GstClockTime elapsed;
+  struct stat st;
+  gint i, ret = 0;
+
+  if (!g_thread_supported ())
+    g_thread_init (NULL);
+
+  ctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  frame_size = gst_video_format_get_size (GST_VIDEO_FORMAT_I420, width,
+      height);
+
+  if (location) {
+    filename = g_strdup (location);
+  } else {
+    filename = g_build_filename (g_get_tmp_dir (), "videoparse-perf.yuv",
+        NULL);
+    g_print ("Writing %d frames of %dx%d to %s\n", n_frames, width, height,
+        filename);
+    if (!write_file (filename, frame_size)) {
+      g_printerr ("Could not write %s\n", filename);
+      g_free (filename);
+      return 1;
+    }
+  }
+
+  if (g_stat (filename, &st) != 0) {
+    g_printerr ("Could not stat %s\n", filename);
+    ret = 1;
+    goto done;
+  }
+  n_frames = st.st_size / frame_size;
+
+  for (i = 0; i < 2; i++) {
+    if (!run (filename, i == 1, &elapsed)) {
+      ret = 1;
+      break;
+    }
+    g_print ("%s mode: %d frames in %" GST_TIME_FORMAT ", %.1f frames/s\n",
+        i == 0 ? "pull" : "push", n_frames, GST_TIME_ARGS (elapsed),
+        (gdouble) n_frames * GST_SECOND / MAX (elapsed, 1));
+  }
+
+done:
+  if (!location)
+    g_unlink (filename);
+  g_free (filename);
+
+  return ret;
+}